@@ -0,0 +1,143 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_MPSC_QUEUE_H
+#define SRSRAN_MPSC_QUEUE_H
+
+#include "srsran/adt/detail/type_storage.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace srsran {
+
+/**
+ * Bounded lock-free queue with multiple producers and a single consumer, with the following features:
+ * - no allocations. Elements are stored in a fixed-size ring of N slots, each one with its own sequence number
+ * - push is wait-free when the queue is not contended, and never blocks. It fails if the queue is full
+ * - pop must only be called from a single thread at a time
+ * - size and empty can be called from any thread
+ * Based on the bounded MPMC queue design by D. Vyukov, with the consumer side simplified for a single reader.
+ * @tparam T type of the stored elements. It must be move-constructible
+ * @tparam N capacity of the queue. It must be a power of 2
+ */
+template <typename T, size_t N>
+class static_mpsc_queue
+{
+  static_assert(N > 1 and (N & (N - 1)) == 0, "The capacity of the queue must be a power of 2");
+
+  // avoid false sharing between producers and consumer indexes
+  static const size_t cache_line_size = 64;
+
+public:
+  static_mpsc_queue()
+  {
+    for (size_t i = 0; i < N; ++i) {
+      cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+  static_mpsc_queue(const static_mpsc_queue&) = delete;
+  static_mpsc_queue(static_mpsc_queue&&)      = delete;
+  static_mpsc_queue& operator=(const static_mpsc_queue&) = delete;
+  static_mpsc_queue& operator=(static_mpsc_queue&&) = delete;
+  ~static_mpsc_queue()
+  {
+    // destroy elements that were not popped
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    for (; cells[pos & (N - 1)].seq.load(std::memory_order_acquire) == pos + 1; ++pos) {
+      cells[pos & (N - 1)].storage.destroy();
+    }
+  }
+
+  /// Thread-safe. Returns false if the queue is full, in which case the element is not moved
+  template <typename... Args>
+  bool try_emplace(Args&&... args)
+  {
+    size_t  pos = enqueue_pos.load(std::memory_order_relaxed);
+    cell_t* c   = nullptr;
+    while (true) {
+      c             = &cells[pos & (N - 1)];
+      size_t   seq  = c->seq.load(std::memory_order_acquire);
+      intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+      if (diff == 0) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // slot still occupied by an element of the previous round
+        return false;
+      } else {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    c->storage.emplace(std::forward<Args>(args)...);
+    c->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+  bool try_push(T&& t) { return try_emplace(std::move(t)); }
+  bool try_push(const T& t) { return try_emplace(t); }
+
+  /// Must only be called from the consumer thread. Returns false if the queue is empty
+  bool try_pop(T& obj)
+  {
+    // Only the consumer writes dequeue_pos, so relaxed accesses are enough. It is atomic for size()
+    size_t  pos = dequeue_pos.load(std::memory_order_relaxed);
+    cell_t& c   = cells[pos & (N - 1)];
+    size_t  seq = c.seq.load(std::memory_order_acquire);
+    if (seq != pos + 1) {
+      // empty, or the producer that reserved this slot has not finished writing it yet
+      return false;
+    }
+    obj = std::move(c.storage.get());
+    c.storage.destroy();
+    c.seq.store(pos + N, std::memory_order_release);
+    dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// Number of slots reserved by the producers and not popped yet, including the ones whose element is still being
+  /// written. Approximate when called concurrently with push or pop
+  size_t size() const
+  {
+    size_t deq = dequeue_pos.load(std::memory_order_acquire);
+    size_t enq = enqueue_pos.load(std::memory_order_acquire);
+    // the two indexes are not read at once, so the difference is clamped to the valid range
+    return enq > deq ? std::min(enq - deq, N) : 0;
+  }
+  bool   empty() const { return size() == 0; }
+  size_t max_size() const { return N; }
+
+private:
+  struct cell_t {
+    std::atomic<size_t>     seq;
+    detail::type_storage<T> storage;
+  };
+
+  std::array<cell_t, N> cells;
+  alignas(cache_line_size) std::atomic<size_t> enqueue_pos{0};
+  alignas(cache_line_size) std::atomic<size_t> dequeue_pos{0};
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_MPSC_QUEUE_H
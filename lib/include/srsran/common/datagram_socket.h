@@ -0,0 +1,104 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#ifndef SRSRAN_DATAGRAM_SOCKET_H
+#define SRSRAN_DATAGRAM_SOCKET_H
+
+#include "srsran/adt/span.h"
+#include "srsran/common/byte_buffer.h"
+#include "srsran/config.h"
+#include "srsran/srslog/srslog.h"
+#include <memory>
+#include <netinet/in.h>
+#include <string>
+
+namespace srsran {
+
+/****************************
+ * User plane datagram sockets
+ ***************************/
+
+/// Backends of the sockets that carry the user plane datagrams, e.g. GTP-U over S1-U/N3
+enum class datagram_socket_type { udp, af_xdp };
+const char* to_string(datagram_socket_type type);
+bool        string_to_datagram_socket_type(const std::string& str, datagram_socket_type* type);
+
+struct datagram_socket_args_t {
+  datagram_socket_type type = datagram_socket_type::udp;
+  std::string          bind_addr;
+  int                  bind_port = 0;
+  // AF_XDP only
+  std::string xdp_if_name;            ///< Interface where the XDP program is attached, e.g. "eth0", "lo" or a veth
+  uint32_t    xdp_queue_id   = 0;     ///< Rx queue of the interface the user plane traffic is steered to
+  uint32_t    xdp_nof_frames = 4096;  ///< Frames of the UMEM, half of them for Rx and half for Tx
+  bool        xdp_drv_mode   = false; ///< Native XDP of the NIC driver, instead of the generic XDP of the kernel
+};
+
+/**
+ * Socket that sends and receives UDP datagrams, whichever path they take through the kernel. Receptions never block,
+ * and the socket is polled through its file descriptor, e.g. by registering it in the socket_manager.
+ * recv() must be called from a single thread, and send() from a single thread, which can be a different one.
+ */
+class datagram_socket
+{
+public:
+  datagram_socket()                       = default;
+  datagram_socket(const datagram_socket&) = delete;
+  datagram_socket& operator=(const datagram_socket&) = delete;
+  virtual ~datagram_socket()                         = default;
+
+  virtual datagram_socket_type get_type() const = 0;
+
+  /// File descriptor that becomes readable when there are datagrams to receive
+  virtual int get_fd() const = 0;
+
+  virtual const sockaddr_in& get_addr_in() const = 0;
+
+  /**
+   * Reads the datagrams received so far, up to the number of byte buffers passed, without blocking
+   * @param pdus allocated byte buffers, where the datagrams are written to
+   * @param from source address of each datagram
+   * @return number of datagrams read, possibly zero, or SRSRAN_ERROR
+   */
+  virtual int recv(span<unique_byte_buffer_t> pdus, span<sockaddr_in> from) = 0;
+
+  /// Sends a datagram from the bound address. Returns false if it could not be sent
+  virtual bool send(const byte_buffer_t& pdu, const sockaddr_in& dest) = 0;
+};
+
+/**
+ * Creates a socket of the requested type, bound to the address and port of the arguments. If the AF_XDP socket cannot
+ * be created, e.g. for lack of privileges or of kernel support, a UDP socket is created instead
+ * @return the socket, or nullptr if not even the UDP socket could be created
+ */
+std::unique_ptr<datagram_socket> make_datagram_socket(const datagram_socket_args_t& args,
+                                                      srslog::basic_logger&         logger);
+
+/// Creates a socket of a specific backend, without fallback. Returns nullptr if the socket could not be created
+std::unique_ptr<datagram_socket> make_udp_datagram_socket(const datagram_socket_args_t& args,
+                                                          srslog::basic_logger&         logger);
+std::unique_ptr<datagram_socket> make_af_xdp_datagram_socket(const datagram_socket_args_t& args,
+                                                             srslog::basic_logger&         logger);
+
+} // namespace srsran
+
+#endif // SRSRAN_DATAGRAM_SOCKET_H
@@ -62,6 +62,8 @@ struct rf_args_t {
   std::string device_args;
   std::string time_adv_nsamples;
   std::string continuous_tx;
+  bool        virtual_clock; // Pace on the radio time instead of the wall clock (zmq and file devices)
+  std::string resampler;     // Resampler from the fixed sampling rate: fft (integer ratios) or poly (any ratio)
 
   std::array<rf_args_band_t, SRSRAN_MAX_CARRIERS> ch_rx_bands;
   std::array<rf_args_band_t, SRSRAN_MAX_CARRIERS> ch_tx_bands;
@@ -82,6 +84,15 @@ class read_pdu_interface
 {
 public:
   virtual uint32_t read_pdu(uint32_t lcid, uint8_t* payload, uint32_t requested_bytes) = 0;
+
+  /* Scatter-gather variant of read_pdu(). The leading bytes of the PDU (e.g. the RLC header) are written to payload
+   * and the remaining bytes may be returned by reference in body, which must remain valid until the TB is encoded.
+   * Returns the total PDU size, including the referenced body. By default the whole PDU is copied to payload. */
+  virtual uint32_t read_pdu_sg(uint32_t lcid, uint8_t* payload, uint32_t requested_bytes, const_byte_span& body)
+  {
+    body = {};
+    return read_pdu(lcid, payload, requested_bytes);
+  }
 };
 
 
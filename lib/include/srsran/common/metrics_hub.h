@@ -28,6 +28,7 @@
 #ifndef SRSRAN_METRICS_HUB_H
 #define SRSRAN_METRICS_HUB_H
 
+#include "srsran/common/sim_clock.h"
 #include "srsran/common/threads.h"
 #include <chrono>
 #include <mutex>
@@ -55,10 +56,11 @@ template <typename metrics_t>
 class metrics_hub : public periodic_thread
 {
 public:
-  metrics_hub() : sleep_start(std::chrono::steady_clock::now()), periodic_thread("METRICS_HUB") {}
+  metrics_hub() : sleep_start(sim_clock::now()), periodic_thread("METRICS_HUB") {}
   bool init(metrics_interface<metrics_t>* m_, float report_period_secs_ = 1.0)
   {
-    m = m_;
+    m           = m_;
+    sleep_start = sim_clock::now();
     // Start with user-default priority
     start_periodic(report_period_secs_ * 1e6, -2);
     return true;
@@ -85,9 +87,9 @@ private:
   {
     std::unique_lock<std::mutex> lock(mutex);
 
-    // get current time and check how long we slept
-    auto period_usec =
-        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sleep_start);
+    // get current time and check how long we slept, which is the time processed by the radio when it runs on a
+    // virtual clock
+    auto period_usec = std::chrono::duration_cast<std::chrono::microseconds>(sim_clock::now() - sleep_start);
 
     if (m) {
       metrics_t metric = {};
@@ -97,11 +99,11 @@ private:
       }
     }
     // store start of sleep period
-    sleep_start = std::chrono::steady_clock::now();
+    sleep_start = sim_clock::now();
   }
   metrics_interface<metrics_t>*             m = nullptr;
   std::vector<metrics_listener<metrics_t>*> listeners;
-  std::chrono::steady_clock::time_point     sleep_start;
+  sim_clock::time_point                     sleep_start;
   std::mutex                                mutex;
 };
 
@@ -23,6 +23,7 @@
 #define SRSRAN_RX_SOCKET_HANDLER_H
 
 #include "srsran/common/buffer_pool.h"
+#include "srsran/common/datagram_socket.h"
 #include "srsran/common/multiqueue.h"
 #include "srsran/common/threads.h"
 
@@ -180,6 +181,13 @@ using sctp_recv_callback_t =
 /// Function signature for SDU byte buffers received from any sockaddr_in-based socket
 using recvfrom_callback_t = srsran::move_callback<void(srsran::unique_byte_buffer_t, const sockaddr_in&)>;
 
+/// Maximum number of datagrams read at once by the handlers created with make_sdu_batch_handler
+const static uint32_t MAX_SDU_BATCH_SIZE = 32;
+
+/// Function signature for batches of SDU byte buffers received from any sockaddr_in-based socket, with their sources
+using recvfrom_batch_callback_t =
+    srsran::move_callback<void(srsran::span<srsran::unique_byte_buffer_t>, srsran::span<const sockaddr_in>)>;
+
 /**
  * Helper function that creates a callback that is called when a SCTP socket has data, and does the following tasks:
  * 1. receive SDU byte buffer from SCTP socket and associated metadata - sockaddr_in, sctp_sndrcvinfo, flags
@@ -200,6 +208,16 @@ make_sctp_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& q
 socket_manager_itf::recv_callback_t
 make_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& queue, recvfrom_callback_t rx_callback);
 
+/**
+ * Similar to make_sdu_handler, but for a datagram_socket of any backend, to be registered with socket.get_fd(). All
+ * the datagrams already received by the socket, up to MAX_SDU_BATCH_SIZE, are read at once (e.g. with a single
+ * recvmmsg(...) call for UDP sockets) and dispatched to the queue as a single task
+ */
+socket_manager_itf::recv_callback_t make_sdu_batch_handler(srslog::basic_logger&      logger,
+                                                           srsran::task_queue_handle& queue,
+                                                           datagram_socket&           socket,
+                                                           recvfrom_batch_callback_t  rx_callback);
+
 inline socket_manager& get_rx_io_manager()
 {
   static socket_manager io;
@@ -0,0 +1,88 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        rcu.h
+ * Description: Lightweight read-copy-update (RCU) scheme, to look up objects
+ *              from real-time threads without locks while another thread
+ *              adds and removes them.
+ *              Readers enter a read-side critical section, which costs an
+ *              atomic increment of a per-thread-group counter. Before
+ *              destroying an object that it has unpublished, the writer waits
+ *              for a grace period, i.e. for all critical sections that may
+ *              still be using the object to end.
+ *****************************************************************************/
+
+#ifndef SRSRAN_RCU_H
+#define SRSRAN_RCU_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace srsran {
+
+/// Read-side critical section. Critical sections can be nested, and must be short, as writers wait for them to end
+class rcu_read_guard
+{
+public:
+  rcu_read_guard();
+  rcu_read_guard(const rcu_read_guard&) = delete;
+  rcu_read_guard(rcu_read_guard&&)      = delete;
+  rcu_read_guard& operator=(const rcu_read_guard&) = delete;
+  rcu_read_guard& operator=(rcu_read_guard&&) = delete;
+  ~rcu_read_guard();
+};
+
+/// Waits until all read-side critical sections started before the call have ended. Objects unpublished before the
+/// call can then be destroyed. Must not be called from within a read-side critical section
+void rcu_synchronize();
+
+/// Table of object pointers directly indexed by a small integer key (e.g. RNTI or LCID). Lookups are lock-free and may
+/// be done from any thread within a read-side critical section, or from the writer thread. Only one thread may modify
+/// the table, and it must call rcu_synchronize() between removing an entry and destroying the object.
+template <typename T>
+class rcu_table
+{
+public:
+  explicit rcu_table(size_t size_) : table(new std::atomic<T*>[size_]), table_size(size_)
+  {
+    for (size_t i = 0; i < table_size; ++i) {
+      table[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  size_t size() const { return table_size; }
+
+  /// Returns nullptr for an invalid or empty index
+  T* get(size_t idx) const { return idx < table_size ? table[idx].load() : nullptr; }
+
+  /// Publishes an object, or removes it if nullptr. The object must be fully constructed before the call
+  void set(size_t idx, T* ptr) { table[idx].store(ptr); }
+
+private:
+  std::unique_ptr<std::atomic<T*>[]> table;
+  size_t                             table_size;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_RCU_H
@@ -39,19 +39,31 @@
 #include <string.h>
 
 typedef struct {
-  uint32_t* lfsr;
-  uint32_t* fsm;
+  uint32_t lfsr[16];
+  uint32_t fsm[3];
 } S3G_STATE;
 
+/* Maximum number of states that the multi-buffer functions clock in lockstep */
+#define S3G_MAX_LANES 4
+
 /* Initialization.
  * Input k[4]: Four 32-bit words making up 128-bit key.
  * Input IV[4]: Four 32-bit words making 128-bit initialization variable.
- * Output: All the LFSRs and FSM are initialized for key generation.
+ * Output: All the LFSRs and FSM are initialized for key generation. The
+ * FSM and LFSR are also clocked once with the output discarded, so that
+ * the next keystream word is z_1.
  * See Section 4.1.
  */
 
 void s3g_initialize(S3G_STATE* state, uint32_t k[4], uint32_t iv[4]);
 
+/* Multi-buffer initialization.
+ * Initializes nof_lanes (at most S3G_MAX_LANES) independent states, with the
+ * keys k[i] and IVs iv[i], clocking them in lockstep.
+ */
+
+void s3g_initialize_lanes(S3G_STATE* state[], uint32_t nof_lanes, const uint32_t k[][4], const uint32_t iv[][4]);
+
 /*********************************************************************
     Name: s3g_deinitialize
 
@@ -67,11 +79,19 @@ void s3g_deinitialize(S3G_STATE* state);
  * input z: space for the generated keystream, assumes
  * memory is allocated already.
  * output: generated keystream which is filled in z
+ * Successive calls continue the keystream.
  * See section 4.2.
  */
 
 void s3g_generate_keystream(S3G_STATE* state, uint32_t n, uint32_t* ks);
 
+/* Multi-buffer generation of Keystream.
+ * Generates n words of keystream for each of the nof_lanes (at most
+ * S3G_MAX_LANES) states, writing the keystream of state[i] in ks[i].
+ */
+
+void s3g_generate_keystream_lanes(S3G_STATE* state[], uint32_t nof_lanes, uint32_t n, uint32_t* ks[]);
+
 /* f8.
  * Input key: 128 bit Confidentiality Key.
  * Input count:32-bit Count, Frame dependent input.
@@ -101,4 +121,15 @@ void s3g_generate_keystream(S3G_STATE* state, uint32_t n, uint32_t* ks);
 
 uint8_t* s3g_f9(const uint8_t* key, uint32_t count, uint32_t fresh, uint32_t dir, uint8_t* data, uint64_t length);
 
+/* f9 evaluation.
+ * Input z[5]: the keystream words z_1 to z_5 generated with the f9 IV.
+ * Input data: length number of bits, input bit stream.
+ * Input length: 64 bit Length, i.e., the number of bits to be MAC'd.
+ * Output mac: 32 bit MAC.
+ * Computes the UIA2 universal hash of Section 4.3, given the keystream.
+ * Unlike s3g_f9, it does not use static memory.
+ */
+
+void s3g_f9_eval(const uint32_t z[5], const uint8_t* data, uint64_t length, uint8_t mac[4]);
+
 #endif // SRSRAN_S3G_H
\ No newline at end of file
@@ -29,6 +29,7 @@
 #include "srsran/common/common.h"
 #include "srsran/srslog/srslog.h"
 
+#include <memory>
 #include <vector>
 
 #define AKA_RAND_LEN 16
@@ -253,6 +254,39 @@ uint8_t security_generate_res_star(const uint8_t* ck,
                                    const uint8_t* res,
                                    const size_t   res_len,
                                    uint8_t*       res_star);
+/******************************************************************************
+ * Precomputed AES-128 keys
+ *****************************************************************************/
+
+/// 128-EEA2/128-EIA2 key, with the AES key schedule and the CMAC subkeys derived once when the key is set, rather
+/// than for every PDU. The AES rounds run on AES-NI or on the ARMv8 crypto extension when the CPU supports them.
+class security_aes128_key
+{
+public:
+  security_aes128_key();
+  ~security_aes128_key();
+  security_aes128_key(const security_aes128_key&) = delete;
+  security_aes128_key& operator=(const security_aes128_key&) = delete;
+
+  /// Sets the 16-byte key. With use_hw=false, the software AES is used even if the CPU has AES instructions
+  void set_key(const uint8_t* key, bool use_hw = true);
+  bool is_set() const { return pimpl != nullptr; }
+  bool is_hw_accelerated() const;
+
+  struct impl;
+
+private:
+  std::unique_ptr<impl> pimpl;
+
+  friend uint8_t
+  security_128_eia2(const security_aes128_key&, uint32_t, uint32_t, uint8_t, const uint8_t*, uint32_t, uint8_t*);
+  friend uint8_t
+  security_128_eea2(const security_aes128_key&, uint32_t, uint8_t, uint8_t, const uint8_t*, uint32_t, uint8_t*);
+};
+
+/// Name of the AES implementation selected for this CPU: "AES-NI", "ARMv8-CE" or "software"
+const char* security_aes_backend();
+
 /******************************************************************************
  * Integrity Protection
  *****************************************************************************/
@@ -272,6 +306,14 @@ uint8_t security_128_eia2(const uint8_t* key,
                           uint32_t       msg_len,
                           uint8_t*       mac);
 
+uint8_t security_128_eia2(const security_aes128_key& key,
+                          uint32_t                   count,
+                          uint32_t                   bearer,
+                          uint8_t                    direction,
+                          const uint8_t*             msg,
+                          uint32_t                   msg_len,
+                          uint8_t*                   mac);
+
 uint8_t security_128_eia3(const uint8_t* key,
                           uint32_t       count,
                           uint32_t       bearer,
@@ -301,6 +343,15 @@ uint8_t security_128_eea2(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out);
 
+/// In-place operation (msg == msg_out) is supported
+uint8_t security_128_eea2(const security_aes128_key& key,
+                          uint32_t                   count,
+                          uint8_t                    bearer,
+                          uint8_t                    direction,
+                          const uint8_t*             msg,
+                          uint32_t                   msg_len,
+                          uint8_t*                   msg_out);
+
 uint8_t security_128_eea3(uint8_t* key,
                           uint32_t count,
                           uint8_t  bearer,
@@ -309,6 +360,29 @@ uint8_t security_128_eea3(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out);
 
+/******************************************************************************
+ * Batch Encryption / Integrity Protection
+ *****************************************************************************/
+
+/// PDU of a batch of 128-EEA1/EEA3 or 128-EIA1/EIA3 operations. The PDUs of a batch may belong to different bearers
+/// and use different keys
+struct security_batch_pdu_t {
+  const uint8_t* key;       ///< 16-byte key
+  uint32_t       count;     ///< COUNT
+  uint8_t        bearer;    ///< BEARER (5 bits)
+  uint8_t        direction; ///< DIRECTION (1 bit)
+  const uint8_t* msg;       ///< Input PDU
+  uint32_t       msg_len;   ///< Length of the input PDU in bytes
+  uint8_t*       out;       ///< Ciphered PDU of msg_len bytes (may be msg) or 4-byte MAC
+};
+
+/// The keystream generators of up to S3G_MAX_LANES/ZUC_MAX_LANES PDUs of the batch are clocked in lockstep, so that
+/// their table lookups overlap, and the keystream is applied a word at a time
+uint8_t security_128_eea1_batch(const security_batch_pdu_t* pdus, uint32_t nof_pdus);
+uint8_t security_128_eea3_batch(const security_batch_pdu_t* pdus, uint32_t nof_pdus);
+uint8_t security_128_eia1_batch(const security_batch_pdu_t* pdus, uint32_t nof_pdus);
+uint8_t security_128_eia3_batch(const security_batch_pdu_t* pdus, uint32_t nof_pdus);
+
 /******************************************************************************
  * Authentication
  *****************************************************************************/
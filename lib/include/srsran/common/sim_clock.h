@@ -0,0 +1,63 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        sim_clock.h
+ * Description: Time source of the upper layers. It follows the steady clock,
+ *              unless the radio runs on a virtual clock, i.e. the RF device
+ *              delivers samples as soon as the peer has sent them instead of
+ *              pacing them on the wall clock. It then follows the time of the
+ *              last received samples, so that the time measured by the upper
+ *              layers matches the time the PHY has processed, whatever the
+ *              speed of the simulation.
+ *****************************************************************************/
+
+#ifndef SRSRAN_SIM_CLOCK_H
+#define SRSRAN_SIM_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace srsran {
+
+/// Clock meeting the std::chrono Clock requirements
+class sim_clock
+{
+public:
+  using duration                  = std::chrono::microseconds;
+  using rep                       = duration::rep;
+  using period                    = duration::period;
+  using time_point                = std::chrono::time_point<sim_clock>;
+  static constexpr bool is_steady = true;
+
+  static time_point now();
+
+  /// Switches to the virtual time, which starts at zero. Called by the radio before streaming
+  static void enable_virtual_time();
+  static bool is_virtual_time();
+
+  /// Advances the virtual time to the given time since the start of the stream. The clock never goes back
+  static void advance_to(duration t);
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_SIM_CLOCK_H
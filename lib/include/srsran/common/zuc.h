@@ -25,35 +25,24 @@
 typedef unsigned char u8;
 typedef unsigned int  u32;
 
-/* the state registers of LFSR */
+/* the state registers of LFSR, as a ring buffer (see zuc.cc) */
 typedef struct {
-  u32 LFSR_S0;
-  u32 LFSR_S1;
-  u32 LFSR_S2;
-  u32 LFSR_S3;
-  u32 LFSR_S4;
-  u32 LFSR_S5;
-  u32 LFSR_S6;
-  u32 LFSR_S7;
-  u32 LFSR_S8;
-  u32 LFSR_S9;
-  u32 LFSR_S10;
-  u32 LFSR_S11;
-  u32 LFSR_S12;
-  u32 LFSR_S13;
-  u32 LFSR_S14;
-  u32 LFSR_S15;
+  u32 LFSR_S[16];
   /* the registers of F */
   u32 F_R1;
   u32 F_R2;
-  /* the outputs of BitReorganization */
-  u32 BRC_X0;
-  u32 BRC_X1;
-  u32 BRC_X2;
-  u32 BRC_X3;
 } zuc_state_t;
 
+/* maximum number of states that the multi-buffer functions clock in lockstep */
+#define ZUC_MAX_LANES 4
+
+/* initializes the state and discards the first output of F, so that the next keystream word is the first one */
 void zuc_initialize(zuc_state_t* state, const u8* k, u8* iv);
+/* generates key_stream_len words of keystream. Successive calls continue the keystream */
 void zuc_generate_keystream(zuc_state_t* state, int key_stream_len, u32* p_keystream);
 
+/* multi-buffer variants, which run nof_lanes (at most ZUC_MAX_LANES) independent states in lockstep */
+void zuc_initialize_lanes(zuc_state_t* state[], u32 nof_lanes, const u8* const k[], const u8* const iv[]);
+void zuc_generate_keystream_lanes(zuc_state_t* state[], u32 nof_lanes, int key_stream_len, u32* p_keystream[]);
+
 #endif // SRSRAN_ZUC_H
@@ -34,6 +34,9 @@ struct gtpu_args_t {
   std::string embms_m1u_if_addr;
   bool        embms_enable                 = false;
   uint32_t    indirect_tunnel_timeout_msec = 0;
+  std::string socket_type                  = "udp"; ///< Backend of the S1-U socket, "udp" or "af_xdp"
+  std::string xdp_if_name;                          ///< Interface of the AF_XDP socket
+  uint32_t    xdp_queue_id = 0;                     ///< Rx queue of the AF_XDP socket
 };
 
 // GTPU interface for PDCP
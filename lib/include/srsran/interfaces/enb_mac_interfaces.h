@@ -35,6 +35,7 @@ struct mac_args_t {
   uint32_t                      nof_prealloc_ues; ///< Number of UE resources to pre-allocate at eNB startup
   uint32_t                      max_nof_kos;
   int                           rlf_min_ul_snr_estim;
+  bool                          dl_zero_copy; ///< Pass DL MAC PDUs to the PHY as fragment lists referencing RLC buffers
 };
 
 /* Interface PHY -> MAC */
@@ -47,9 +48,10 @@ public:
    * DL grant structure per UE
    */
   struct dl_sched_grant_t {
-    srsran_dci_dl_t         dci                          = {};
-    uint8_t*                data[SRSRAN_MAX_TB]          = {};
-    srsran_softbuffer_tx_t* softbuffer_tx[SRSRAN_MAX_TB] = {};
+    srsran_dci_dl_t            dci                          = {};
+    uint8_t*                   data[SRSRAN_MAX_TB]          = {};
+    const srsran_sch_tb_iov_t* data_iov[SRSRAN_MAX_TB]      = {}; ///< If set, used instead of data (scatter-gather)
+    srsran_softbuffer_tx_t*    softbuffer_tx[SRSRAN_MAX_TB] = {};
   };
 
   /**
@@ -44,6 +44,7 @@ struct rlc_metrics_t {
 
 struct pdcp_metrics_t {
   std::vector<srsran::pdcp_metrics_t> ues;
+  srsran::pdcp_tx_batch_metrics_t     tx_batch;
 };
 
 struct stack_metrics_t {
@@ -35,6 +35,14 @@ public:
    * Segmentation happens in this function. RLC PDU is stored in payload. */
   virtual int read_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes) = 0;
 
+  /* Same as read_pdu(), but the RLC PDU body may be returned by reference in body instead of being copied into
+   * payload. The referenced memory remains valid until it is released with release_pdu_sg(). */
+  virtual int
+  read_pdu_sg(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes, srsran::const_byte_span& body) = 0;
+
+  /* MAC releases a body returned by read_pdu_sg() once the TB that references it has been encoded. */
+  virtual void release_pdu_sg(uint16_t rnti, uint32_t lcid, srsran::const_byte_span body) = 0;
+
   /* MAC calls RLC to push an RLC PDU. This function is called from an independent MAC thread.
    * PDU gets placed into the buffer and higher layer thread gets notified. */
   virtual void write_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes) = 0;
@@ -126,6 +126,23 @@ enum class pdcp_discard_timer_t {
   infinity = -1
 };
 
+// Robust Header Compression (ROHC) configuration of a DRB, from the headerCompression IE of PDCP-Config.
+// The uncompressed profile (0x0000) is always used for the packets the configured profiles do not cover
+struct pdcp_rohc_config_t {
+  bool     enabled     = false;
+  bool     ul_only     = false; // Only the uplink is compressed (NR ul-OnlyROHC, which needs profile 0x0006)
+  uint16_t max_cid     = 15;
+  bool     profile_rtp = false; // 0x0001, RTP/UDP/IP
+  bool     profile_udp = false; // 0x0002, UDP/IP
+
+  bool operator==(const pdcp_rohc_config_t& other) const
+  {
+    return enabled == other.enabled and ul_only == other.ul_only and max_cid == other.max_cid and
+           profile_rtp == other.profile_rtp and profile_udp == other.profile_udp;
+  }
+  bool operator!=(const pdcp_rohc_config_t& other) const { return not(*this == other); }
+};
+
 class pdcp_config_t
 {
 public:
@@ -164,15 +181,14 @@ public:
 
   bool status_report_required = false;
 
-  // TODO: Support the following configurations
-  // bool do_rohc;
+  pdcp_rohc_config_t rohc = {};
 
   bool operator==(const pdcp_config_t& other) const
   {
     return bearer_id == other.bearer_id and rb_type == other.rb_type and tx_direction == other.tx_direction and
            rx_direction == other.rx_direction and sn_len == other.sn_len and hdr_len_bytes == other.hdr_len_bytes and
            t_reordering == other.t_reordering and discard_timer == other.discard_timer and rat == other.rat and
-           status_report_required == other.status_report_required;
+           status_report_required == other.status_report_required and rohc == other.rohc;
   }
   bool operator!=(const pdcp_config_t& other) const { return not(*this == other); }
 
@@ -193,6 +209,15 @@ struct pdcp_lte_state_t {
   uint32_t reordering_pdcp_rx_count;
 };
 
+// Configuration of the TX batch stage, which integrity protects and ciphers the PDCP Data PDUs of all bearers in
+// batches before passing them to RLC
+struct pdcp_tx_batch_args_t {
+  bool     enable         = false;
+  uint32_t max_batch_size = 256;  // Number of pending PDUs that triggers a flush
+  uint32_t max_delay_us   = 1000; // Maximum time a PDU waits in the stage before a flush is forced
+  uint32_t nof_workers    = 0;    // Number of crypto worker threads (0 to process the batches in the caller thread)
+};
+
 // Custom type for interface between PDCP and RLC to convey SDU delivery status
 // Arbitrarily chosen limit, optimal value depends on the RLC (pollPDU) and PDCP config, channel BLER,
 // traffic characterisitcs, etc. The chosen value has been tested with 100 PRB bi-dir TCP
@@ -56,6 +56,9 @@ struct phy_args_t {
   int force_N_id_2 = -1; // Cell identity within the identity group (PSS) to filter.
   int force_N_id_1 = -1; // Cell identity group (SSS) to filter.
 
+  float    cell_search_wideband_srate = 0.0f; // Capture sampling rate to search several EARFCNs at once (0 to disable)
+  uint32_t cell_search_nof_threads    = 4;    // Number of threads of the wideband cell search
+
   float dl_freq = -1.0f;
   float ul_freq = -1.0f;
 
@@ -102,6 +105,7 @@ struct phy_args_t {
   bool        pdsch_8bit_decoder           = false;
   uint32_t    intra_freq_meas_len_ms       = 20;
   uint32_t    intra_freq_meas_period_ms    = 200;
+  uint32_t    intra_freq_meas_nof_threads  = 2;
   float       force_ul_amplitude           = 0.0f;
   bool        detect_cp                    = false;
 
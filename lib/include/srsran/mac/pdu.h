@@ -22,6 +22,7 @@
 #ifndef SRSRAN_PDU_H
 #define SRSRAN_PDU_H
 
+#include "srsran/adt/bounded_vector.h"
 #include "srsran/common/interfaces_common.h"
 #include "srsran/srslog/srslog.h"
 #include <sstream>
@@ -29,6 +30,10 @@
 #include <stdio.h>
 #include <vector>
 
+extern "C" {
+#include "srsran/phy/phch/sch.h"
+}
+
 /* MAC PDU Packing/Unpacking functions. Section 6 of 36.321 */
 class subh;
 
@@ -391,6 +396,13 @@ class sch_pdu : public pdu<sch_subh>
 public:
   sch_pdu(uint32_t max_subh, srslog::basic_logger& logger) : pdu(max_subh, logger) {}
 
+  /* Scatter-gather TX. SDU bodies may be added by reference instead of being copied into the buffer, and
+   * write_packet() describes the complete PDU as a list of fragments in tb_iov, ready for the PHY encoder */
+  void init_tx_iov(byte_buffer_t* buffer, uint32_t pdu_len_bytes, srsran_sch_tb_iov_t* tb_iov_);
+  bool is_iov() const { return tb_iov != nullptr; }
+  bool has_space_sdu_ref() const { return tb_iov != nullptr and not sdu_refs.full(); }
+  void add_sdu_ref(const_byte_span body);
+
   void     parse_packet(uint8_t* ptr);
   uint8_t* write_packet();
   uint8_t* write_packet(srslog::basic_logger& log);
@@ -404,6 +416,24 @@ public:
   bool            update_space_ce(uint32_t nbytes, bool var_len = false);
   bool            update_space_sdu(uint32_t nbytes);
   void            to_string(fmt::memory_buffer& buffer);
+
+protected:
+  void init_(byte_buffer_t* buffer_tx_, uint32_t pdu_len_bytes, bool is_ulsch) override;
+
+private:
+  // SDU body referenced at the given position of the TX buffer
+  struct sdu_ref_t {
+    const uint8_t*  insert_at;
+    const_byte_span body;
+  };
+  // Each reference splits the buffer in two, so N references need 2 * N + 1 fragments
+  static const uint32_t max_sdu_refs = (SRSRAN_SCH_MAX_IOV - 1) / 2;
+
+  bool write_iov(srslog::basic_logger& log);
+
+  srsran_sch_tb_iov_t*                            tb_iov        = nullptr;
+  uint32_t                                        sdu_ref_bytes = 0;
+  srsran::bounded_vector<sdu_ref_t, max_sdu_refs> sdu_refs;
 };
 
 class rar_subh : public subh<rar_subh>
@@ -75,16 +75,25 @@ public:
   void set_signal_power_dBfs(float power_dBfs);
   void run(cf_t* in[SRSRAN_MAX_CHANNELS], cf_t* out[SRSRAN_MAX_CHANNELS], uint32_t len, const srsran_timestamp_t& t);
 
+  uint32_t get_nof_channels() const { return nof_channels; }
+
 private:
+  friend class channel_batch;
+
+  // Emulates the channel of a single antenna. Different antennas can be run concurrently
+  void run_channel(uint32_t i, cf_t* in, cf_t* out, uint32_t len, const srsran_timestamp_t& t);
+
+  // Updates the state common to all antennas, once all of them have been run
+  void run_end(uint32_t len, const srsran_timestamp_t& t);
+
   srslog::basic_logger&    logger;
   float                    hst_init_phase              = 0.0f;
   srsran_channel_fading_t* fading[SRSRAN_MAX_CHANNELS] = {};
   srsran_channel_delay_t*  delay[SRSRAN_MAX_CHANNELS]  = {};
-  srsran_channel_awgn_t*   awgn                        = nullptr;
-  srsran_channel_hst_t*    hst                         = nullptr;
+  srsran_channel_awgn_t*   awgn[SRSRAN_MAX_CHANNELS]   = {};
+  srsran_channel_hst_t*    hst[SRSRAN_MAX_CHANNELS]    = {};
   srsran_channel_rlf_t*    rlf                         = nullptr;
-  cf_t*                    buffer_in                   = nullptr;
-  cf_t*                    buffer_out                  = nullptr;
+  cf_t*                    buffer[SRSRAN_MAX_CHANNELS] = {};
   uint32_t                 nof_channels                = 0;
   uint32_t                 current_srate               = 0;
   args_t                   args                        = {};
@@ -0,0 +1,89 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#ifndef SRSRAN_CHANNEL_BATCH_H
+#define SRSRAN_CHANNEL_BATCH_H
+
+#include "channel.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace srsran {
+
+/**
+ * Runs the channel emulators of several links in a single call. The antennas of all the links are emulated
+ * independently of each other, so they are spread over a pool of worker threads, and the calling thread takes its share
+ * too. With no workers, the result is the same as running the channel of each link in order.
+ */
+class channel_batch
+{
+public:
+  struct link_t {
+    channel* ch                       = nullptr;
+    cf_t*    in[SRSRAN_MAX_CHANNELS]  = {};
+    cf_t*    out[SRSRAN_MAX_CHANNELS] = {};
+  };
+
+  /// Creates nof_workers threads, besides the one calling run()
+  explicit channel_batch(uint32_t nof_workers = 0);
+  ~channel_batch();
+  channel_batch(const channel_batch&) = delete;
+  channel_batch& operator=(const channel_batch&) = delete;
+
+  /// Runs len samples of all the links, starting at time t. A link must not be added more than once
+  void run(const std::vector<link_t>& links, uint32_t len, const srsran_timestamp_t& t);
+
+  uint32_t get_nof_workers() const { return workers.size(); }
+
+private:
+  struct item_t {
+    channel* ch  = nullptr;
+    uint32_t idx = 0;
+    cf_t*    in  = nullptr;
+    cf_t*    out = nullptr;
+  };
+
+  void worker_loop();
+  void run_items();
+
+  std::vector<std::thread> workers;
+
+  // Antennas of the current run, taken by the workers in order
+  std::vector<item_t>   items;
+  uint32_t              nof_samples = 0;
+  srsran_timestamp_t    timestamp   = {};
+  std::atomic<uint32_t> next_item{0};
+
+  std::mutex              mutex;
+  std::condition_variable cvar_start;
+  std::condition_variable cvar_done;
+  uint64_t                run_count = 0;
+  uint32_t                nof_busy  = 0;
+  bool                    running   = true;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_CHANNEL_BATCH_H
@@ -52,15 +52,15 @@ typedef struct {
   float coeff_alpha[SRSRAN_CHANNEL_FADING_MAXTAPS][SRSRAN_CHANNEL_FADING_NTERMS]; // Angle of arrival
   float coeff_a[SRSRAN_CHANNEL_FADING_MAXTAPS][SRSRAN_CHANNEL_FADING_NTERMS];     // Random phase
   float coeff_b[SRSRAN_CHANNEL_FADING_MAXTAPS][SRSRAN_CHANNEL_FADING_NTERMS];     // Random phase
-  cf_t* h_tap[SRSRAN_CHANNEL_FADING_MAXTAPS]; // Static tap signal in frequency domain
+  float coeff_w[SRSRAN_CHANNEL_FADING_MAXTAPS][SRSRAN_CHANNEL_FADING_NTERMS];     // Doppler angular frequency
+  cf_t* h_tap[SRSRAN_CHANNEL_FADING_MAXTAPS]; // Static tap signal in frequency domain, FFT shifted
 
   // Utils
-  srsran_dft_plan_t fft;             // DFT to frequency domain
-  srsran_dft_plan_t ifft;            // DFT to time domain
-  cf_t*             temp;            // Temporal buffer, length fft_size
-  cf_t*             h_freq;          // Channel frequency response, length fft_size
-  cf_t*             y_freq;          // Intermediate frequency domain buffer
-  float             sin_table[1024]; // Table of sinus values
+  srsran_dft_plan_t fft;    // DFT to frequency domain
+  srsran_dft_plan_t ifft;   // DFT to time domain
+  cf_t*             temp;   // Temporal buffer, length fft_size
+  cf_t*             h_freq; // Channel frequency response, length fft_size
+  cf_t*             y_freq; // Intermediate frequency domain buffer
 
   // State variables
   cf_t* state; // To save impulse response of the filter
@@ -119,6 +119,10 @@ SRSRAN_API int srsran_enb_dl_put_pdcch_ul(srsran_enb_dl_t* q, srsran_dci_cfg_t*
 SRSRAN_API int
 srsran_enb_dl_put_pdsch(srsran_enb_dl_t* q, srsran_pdsch_cfg_t* pdsch, uint8_t* data[SRSRAN_MAX_CODEWORDS]);
 
+SRSRAN_API int srsran_enb_dl_put_pdsch_iov(srsran_enb_dl_t*           q,
+                                           srsran_pdsch_cfg_t*        pdsch,
+                                           const srsran_sch_tb_iov_t* tb_iov[SRSRAN_MAX_CODEWORDS]);
+
 SRSRAN_API int srsran_enb_dl_put_pmch(srsran_enb_dl_t* q, srsran_pmch_cfg_t* pmch_cfg, uint8_t* data);
 
 SRSRAN_API void srsran_enb_dl_gen_signal(srsran_enb_dl_t* q);
@@ -47,6 +47,17 @@
 
 typedef enum SRSRAN_API { SEARCH_UE, SEARCH_COMMON } srsran_pdcch_search_mode_t;
 
+#define SRSRAN_PDCCH_MAX_RANKED 32
+#define SRSRAN_PDCCH_MAX_DECODED 64
+
+/* Message decoded in a location, shared by the formats and RNTIs searched with the same payload size */
+typedef struct SRSRAN_API {
+  srsran_dci_location_t location;
+  uint32_t              nof_bits;
+  uint16_t              crc_rem;
+  uint8_t               payload[SRSRAN_DCI_MAX_BITS];
+} srsran_pdcch_decoded_t;
+
 /* PDCCH object */
 typedef struct SRSRAN_API {
   srsran_cell_t cell;
@@ -73,6 +84,14 @@ typedef struct SRSRAN_API {
   srsran_viterbi_t     decoder;
   srsran_crc_t         crc;
 
+  /* messages decoded from the current LLRs, cleared by srsran_pdcch_extract_llr */
+  srsran_pdcch_decoded_t decoded[SRSRAN_PDCCH_MAX_DECODED];
+  uint32_t               nof_decoded;
+
+  /* decoder statistics */
+  uint64_t nof_decodes;    // Viterbi decodes
+  uint64_t nof_cache_hits; // messages taken from the decoded ones
+
 } srsran_pdcch_t;
 
 SRSRAN_API int srsran_pdcch_init_ue(srsran_pdcch_t* q, uint32_t max_prb, uint32_t nof_rx_antennas);
@@ -104,6 +123,30 @@ SRSRAN_API int srsran_pdcch_extract_llr(srsran_pdcch_t*        q,
 SRSRAN_API int
 srsran_pdcch_decode_msg(srsran_pdcch_t* q, srsran_dl_sf_cfg_t* sf, srsran_dci_cfg_t* dci_cfg, srsran_dci_msg_t* msg);
 
+/**
+ * @brief Computes the absolute mean of the LLRs of a DCI location, used as its energy
+ * @param q PDCCH object with the LLRs extracted by srsran_pdcch_extract_llr
+ * @param sf Subframe configuration
+ * @param location DCI location
+ * @return The mean of the absolute LLRs, 0 if the location is not valid for the subframe CFI
+ */
+SRSRAN_API float
+srsran_pdcch_location_llr_mean(srsran_pdcch_t* q, srsran_dl_sf_cfg_t* sf, srsran_dci_location_t* location);
+
+/**
+ * @brief Sorts the DCI locations by decreasing LLR energy and drops the ones below the threshold under which
+ * srsran_pdcch_decode_msg does not decode. Candidates are then tried from the most likely to carry a DCI
+ * @param q PDCCH object with the LLRs extracted by srsran_pdcch_extract_llr
+ * @param sf Subframe configuration
+ * @param locations DCI locations, sorted in place
+ * @param nof_locations Number of DCI locations
+ * @return The number of locations left to decode
+ */
+SRSRAN_API uint32_t srsran_pdcch_rank_locations(srsran_pdcch_t*        q,
+                                                srsran_dl_sf_cfg_t*    sf,
+                                                srsran_dci_location_t* locations,
+                                                uint32_t               nof_locations);
+
 /**
  * @brief Computes decoded DCI correlation. It encodes the given DCI message and compares it with the received LLRs
  * @param q PDCCH object
@@ -103,6 +103,13 @@ SRSRAN_API int srsran_pdsch_encode(srsran_pdsch_t*     q,
                                    uint8_t*            data[SRSRAN_MAX_CODEWORDS],
                                    cf_t*               sf_symbols[SRSRAN_MAX_PORTS]);
 
+/* Same as srsran_pdsch_encode() with each TB given as a fragment list. A NULL list means retransmission */
+SRSRAN_API int srsran_pdsch_encode_iov(srsran_pdsch_t*            q,
+                                       srsran_dl_sf_cfg_t*        sf,
+                                       srsran_pdsch_cfg_t*        cfg,
+                                       const srsran_sch_tb_iov_t* tb_iov[SRSRAN_MAX_CODEWORDS],
+                                       cf_t*                      sf_symbols[SRSRAN_MAX_PORTS]);
+
 SRSRAN_API int srsran_pdsch_decode(srsran_pdsch_t*        q,
                                    srsran_dl_sf_cfg_t*    sf,
                                    srsran_pdsch_cfg_t*    cfg,
@@ -48,6 +48,20 @@
 #define SRSRAN_TX_NULL 100
 #endif
 
+#define SRSRAN_SCH_MAX_IOV 64
+
+/* Transport block described as a list of byte fragments (scatter-gather). The encoder gathers the fragments
+ * directly into the code block buffers, so the TB does not need to be contiguous in memory. */
+typedef struct SRSRAN_API {
+  const uint8_t* ptr;
+  uint32_t       len; // in bytes
+} srsran_sch_iov_t;
+
+typedef struct SRSRAN_API {
+  srsran_sch_iov_t iov[SRSRAN_SCH_MAX_IOV];
+  uint32_t         nof_iov;
+} srsran_sch_tb_iov_t;
+
 /* DL-SCH AND UL-SCH common functions */
 typedef struct SRSRAN_API {
 
@@ -90,6 +104,13 @@ SRSRAN_API int srsran_dlsch_encode2(srsran_sch_t*       q,
                                     int                 codeword_idx,
                                     uint32_t            nof_layers);
 
+SRSRAN_API int srsran_dlsch_encode2_iov(srsran_sch_t*              q,
+                                        srsran_pdsch_cfg_t*        cfg,
+                                        const srsran_sch_tb_iov_t* tb_iov,
+                                        uint8_t*                   e_bits,
+                                        int                        codeword_idx,
+                                        uint32_t                   nof_layers);
+
 SRSRAN_API int srsran_dlsch_decode(srsran_sch_t* q, srsran_pdsch_cfg_t* cfg, int16_t* e_bits, uint8_t* data);
 
 SRSRAN_API int srsran_dlsch_decode2(srsran_sch_t*       q,
@@ -114,6 +135,14 @@ SRSRAN_API int srsran_ulsch_decode(srsran_sch_t*       q,
                                    uint8_t*            data,
                                    srsran_uci_value_t* uci_data);
 
+SRSRAN_API void srsran_sch_tb_iov_reset(srsran_sch_tb_iov_t* tb_iov);
+
+SRSRAN_API int srsran_sch_tb_iov_push(srsran_sch_tb_iov_t* tb_iov, const uint8_t* ptr, uint32_t len);
+
+SRSRAN_API uint32_t srsran_sch_tb_iov_len(const srsran_sch_tb_iov_t* tb_iov);
+
+SRSRAN_API uint32_t srsran_sch_tb_iov_gather(const srsran_sch_tb_iov_t* tb_iov, uint8_t* dst, uint32_t max_len);
+
 SRSRAN_API float srsran_sch_beta_cqi(uint32_t I_cqi);
 
 SRSRAN_API float srsran_sch_beta_ack(uint32_t I_harq);
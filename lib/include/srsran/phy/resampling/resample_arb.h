@@ -38,6 +38,10 @@
 
 #include "srsran/config.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #define SRSRAN_RESAMPLE_ARB_N_35 35
 #define SRSRAN_RESAMPLE_ARB_N 32 // Polyphase filter rows
 #define SRSRAN_RESAMPLE_ARB_M 8  // Polyphase filter columns
@@ -55,4 +59,100 @@ SRSRAN_API void srsran_resample_arb_init(srsran_resample_arb_t* q, float rate, b
 
 SRSRAN_API int srsran_resample_arb_compute(srsran_resample_arb_t* q, cf_t* input, cf_t* output, int n_in);
 
+/******************************************************************************
+ * Block based polyphase resampler
+ *
+ * Resamples blocks of samples with a bank of nof_phases branches of a windowed
+ * sinc prototype filter, keeping the filter state between blocks. Rational
+ * ratios interp/decim use one branch per output phase, so that the output rate
+ * is exact. Other ratios use SRSRAN_RESAMPLE_POLY_ARB_PHASES branches and the
+ * nearest branch to the fractional position of each output sample.
+ *****************************************************************************/
+
+#define SRSRAN_RESAMPLE_POLY_MAX_PHASES 256 // Maximum interpolation factor of a rational ratio
+#define SRSRAN_RESAMPLE_POLY_ARB_PHASES 256 // Branches for arbitrary ratios, power of 2
+#define SRSRAN_RESAMPLE_POLY_NOF_TAPS 32    // Default number of taps per branch
+#define SRSRAN_RESAMPLE_POLY_BLOCK 4096     // Input samples filtered per block
+
+typedef struct SRSRAN_API {
+  double   rate;        // Output to input sample rate ratio
+  uint32_t nof_phases;  // Number of filter branches
+  uint32_t nof_taps;    // Taps per branch at the input rate, multiple of 8
+  float*   filter;      // Branch coefficients in reverse order, each one repeated for the real and imaginary parts
+  uint64_t one;         // Input sample period in accumulator units
+  uint64_t step_int;    // Input samples advanced per output sample, integer part
+  uint64_t step_frac;   // Input samples advanced per output sample, fractional part in accumulator units
+  uint32_t phase_shift; // Right shift of the accumulator that gives the branch
+  uint64_t acc;         // Fractional position of the next output sample
+  uint32_t idx;         // Buffer index of the newest input sample used by the next output sample
+  cf_t*    buffer;      // Last nof_taps - 1 input samples followed by the current block
+  cf_t*    pending;     // Output samples computed beyond the ones requested by srsran_resample_poly_pull
+  uint32_t nof_pending;
+  uint32_t max_pending;
+} srsran_resample_poly_t;
+
+/**
+ * Initialises the resampler for the rational ratio interp/decim. Does nothing if it is already initialised with the
+ * same parameters.
+ * @param q Object pointer
+ * @param interp Interpolation factor, up to SRSRAN_RESAMPLE_POLY_MAX_PHASES after reducing the ratio
+ * @param decim Decimation factor
+ * @param nof_taps Taps per branch at the lowest of the input and output rates, rounded up to a multiple of 8
+ * @return SRSRAN_SUCCESS if no error, otherwise an SRSRAN error code
+ */
+SRSRAN_API int srsran_resample_poly_init(srsran_resample_poly_t* q, uint32_t interp, uint32_t decim, uint32_t nof_taps);
+
+/**
+ * Initialises the resampler for an arbitrary output to input rate ratio. Ratios of integers up to
+ * SRSRAN_RESAMPLE_POLY_MAX_PHASES (e.g. 23.04/30.72 = 3/4) are resampled exactly as rational ratios.
+ * @return SRSRAN_SUCCESS if no error, otherwise an SRSRAN error code
+ */
+SRSRAN_API int srsran_resample_poly_init_arb(srsran_resample_poly_t* q, double rate, uint32_t nof_taps);
+
+/**
+ * Clears the filter state and the pending output samples
+ */
+SRSRAN_API void srsran_resample_poly_reset(srsran_resample_poly_t* q);
+
+/**
+ * Group delay of the filter, in input samples
+ */
+SRSRAN_API double srsran_resample_poly_get_delay(const srsran_resample_poly_t* q);
+
+/**
+ * Resamples a block of samples. All input samples are consumed, and the samples pending from srsran_resample_poly_pull
+ * are output first.
+ * @note Setting the input to NULL is equivalent of feeding zeroes
+ * @param q Object pointer
+ * @param input Input samples
+ * @param output Output buffer, with room for at least ceil(nof_input * rate) + 1 samples plus the pending ones
+ * @param nof_input Number of input samples
+ * @return the number of output samples
+ */
+SRSRAN_API uint32_t srsran_resample_poly_run(srsran_resample_poly_t* q,
+                                             const cf_t*             input,
+                                             cf_t*                   output,
+                                             uint32_t                nof_input);
+
+/**
+ * Number of input samples that srsran_resample_poly_pull needs to produce the next nof_output samples
+ */
+SRSRAN_API uint32_t srsran_resample_poly_nof_input(const srsran_resample_poly_t* q, uint32_t nof_output);
+
+/**
+ * Produces exactly nof_output samples, from srsran_resample_poly_nof_input(q, nof_output) input samples. The samples
+ * computed in excess are returned by the next call.
+ * @return the number of input samples consumed
+ */
+SRSRAN_API uint32_t srsran_resample_poly_pull(srsran_resample_poly_t* q,
+                                              const cf_t*             input,
+                                              cf_t*                   output,
+                                              uint32_t                nof_output);
+
+SRSRAN_API void srsran_resample_poly_free(srsran_resample_poly_t* q);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // SRSRAN_RESAMPLE_ARB_
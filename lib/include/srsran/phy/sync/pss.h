@@ -115,6 +115,10 @@ SRSRAN_API int srsran_pss_resize(srsran_pss_t* q, uint32_t frame_size, uint32_t
 
 SRSRAN_API int srsran_pss_init(srsran_pss_t* q, uint32_t frame_size);
 
+/// Generates the PSS in the frequency domain and the conjugated PSS in the time domain, for a symbol of fft_size
+SRSRAN_API int
+srsran_pss_init_N_id_2(cf_t* pss_signal_freq, cf_t* pss_signal_time, uint32_t N_id_2, uint32_t fft_size, int cfo_i);
+
 SRSRAN_API void srsran_pss_free(srsran_pss_t* q);
 
 SRSRAN_API void srsran_pss_reset(srsran_pss_t* q);
@@ -0,0 +1,110 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         pss_corr.h
+ *
+ *  Description:  Correlation of a received signal with several PSS sequences
+ *                at once, using the overlap-save method.
+ *
+ *                Each block of input is transformed to the frequency domain
+ *                once, and multiplied with the spectrum of every sequence, so
+ *                that the three LTE (or NR) PSS roots cost one FFT and three
+ *                IFFTs per block instead of two FFTs each.
+ *
+ *                The magnitude of the correlation can be accumulated modulo
+ *                a period (e.g. the 5 ms of the PSS), which averages the
+ *                noise of the repetitions before the peak is searched. The
+ *                peak to average ratio of each sequence is then a robust
+ *                indication of whether the sequence is present.
+ *
+ *  Reference:
+ *****************************************************************************/
+
+#ifndef SRSRAN_PSS_CORR_H
+#define SRSRAN_PSS_CORR_H
+
+#include "srsran/config.h"
+#include "srsran/phy/dft/dft.h"
+#include <stdint.h>
+
+#define SRSRAN_PSS_CORR_MAX_SEQ 3
+
+typedef struct SRSRAN_API {
+  uint32_t          max_seq_len;
+  uint32_t          seq_len;
+  uint32_t          fft_size;
+  uint32_t          nof_seq;
+  uint32_t          period;
+  uint32_t          max_period;
+  cf_t*             seq_fft[SRSRAN_PSS_CORR_MAX_SEQ]; ///< Conjugated spectrum of the sequences
+  float             seq_energy[SRSRAN_PSS_CORR_MAX_SEQ];
+  float*            acc[SRSRAN_PSS_CORR_MAX_SEQ]; ///< Correlation power, accumulated modulo the period
+  cf_t*             in_time;
+  cf_t*             in_freq;
+  cf_t*             out_freq;
+  cf_t*             out_time;
+  float*            out_pwr;
+  srsran_dft_plan_t fft;
+  srsran_dft_plan_t ifft;
+} srsran_pss_corr_t;
+
+typedef struct SRSRAN_API {
+  uint32_t idx;   ///< Start of the sequence in the input, or modulo the period if it is set
+  float    value; ///< Correlation power at the peak, accumulated if the period is set
+  float    corr;  ///< Normalised correlation at the peak, from 0 to 1. Not computed if the period is set
+  float    par;   ///< Ratio between the peak and the average correlation power
+} srsran_pss_corr_peak_t;
+
+/**
+ * Allocates a correlator for sequences of up to max_seq_len samples, accumulating the correlation over periods of up
+ * to max_period samples (0 to disable the accumulation)
+ */
+SRSRAN_API int srsran_pss_corr_init(srsran_pss_corr_t* q, uint32_t max_seq_len, uint32_t max_period);
+
+/**
+ * Initialises a correlator with the three LTE PSS in the time domain, without cyclic prefix, for a symbol of
+ * fft_size samples
+ */
+SRSRAN_API int srsran_pss_corr_init_lte(srsran_pss_corr_t* q, uint32_t fft_size, uint32_t max_period);
+
+/// Sets the three LTE PSS for a symbol of fft_size samples, up to the size the correlator was initialised with
+SRSRAN_API int srsran_pss_corr_set_lte(srsran_pss_corr_t* q, uint32_t fft_size);
+
+/**
+ * Sets the time domain sequence of index idx. All the sequences must have the same length, which is set by the first
+ * one. Sequences of any RAT can be loaded, e.g. the NR PSS of an SSB after the OFDM modulation
+ */
+SRSRAN_API int srsran_pss_corr_set_seq(srsran_pss_corr_t* q, uint32_t idx, const cf_t* seq, uint32_t seq_len);
+
+/// Sets the period in samples over which the correlation is accumulated (0 to disable), up to max_period
+SRSRAN_API int srsran_pss_corr_set_period(srsran_pss_corr_t* q, uint32_t period);
+
+/**
+ * Correlates the input with all the sequences, and writes the peak of each one in peaks. The input must contain at
+ * least one sequence length. Returns the number of sequences
+ */
+SRSRAN_API int
+srsran_pss_corr_run(srsran_pss_corr_t* q, const cf_t* input, uint32_t nof_samples, srsran_pss_corr_peak_t* peaks);
+
+SRSRAN_API void srsran_pss_corr_free(srsran_pss_corr_t* q);
+
+#endif // SRSRAN_PSS_CORR_H
@@ -116,6 +116,23 @@ SRSRAN_API uint32_t srsran_sss_subframe(uint32_t m0, uint32_t m1);
 
 SRSRAN_API int srsran_sss_N_id_1(srsran_sss_t* q, uint32_t m0, uint32_t m1, float corr);
 
+/**
+ * Detects the SSS of an FDD cell from the position of its PSS, e.g. the peak of a srsran_pss_corr_t accumulated every
+ * 5 ms. The PSS starts at pss_idx modulo period, after its cyclic prefix. The SSS of every repetition within the input
+ * is correlated with the N_id_2 set in the object, and the strongest one over the threshold is kept. Writes its
+ * subframe index and correlation, and the number of repetitions that detected the same N_id_1. Returns the N_id_1, or
+ * SRSRAN_ERROR if no SSS is over the threshold
+ */
+SRSRAN_API int srsran_sss_find_periodic(srsran_sss_t* q,
+                                        const cf_t*   input,
+                                        uint32_t      nof_samples,
+                                        uint32_t      pss_idx,
+                                        uint32_t      period,
+                                        srsran_cp_t   cp,
+                                        uint32_t*     sf_idx,
+                                        float*        corr,
+                                        uint32_t*     nof_detected);
+
 SRSRAN_API int srsran_sss_frame(srsran_sss_t* q, cf_t* input, uint32_t* subframe_idx, uint32_t* N_id_1);
 
 SRSRAN_API void srsran_sss_set_threshold(srsran_sss_t* q, float threshold);
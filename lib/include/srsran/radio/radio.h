@@ -25,12 +25,14 @@
 #include "rf_timestamp.h"
 #include "srsran/common/interfaces_common.h"
 #include "srsran/interfaces/radio_interfaces.h"
+#include "srsran/phy/resampling/resample_arb.h"
 #include "srsran/phy/resampling/resampler.h"
 #include "srsran/phy/rf/rf.h"
 #include "srsran/radio/radio_base.h"
 #include "srsran/srslog/srslog.h"
 #include "srsran/srsran.h"
 
+#include <chrono>
 #include <list>
 #include <string>
 
@@ -111,6 +113,8 @@ private:
   std::array<srsran_resampler_fft_t, SRSRAN_MAX_CHANNELS> interpolators = {};
   std::array<srsran_resampler_fft_t, SRSRAN_MAX_CHANNELS> decimators    = {};
   std::atomic<bool> decimator_busy = {false}; ///< Indicates the decimator is changing the rate
+  std::array<srsran_resample_poly_t, SRSRAN_MAX_CHANNELS> tx_resamplers = {}; ///< Polyphase resamplers, any ratio
+  std::array<srsran_resample_poly_t, SRSRAN_MAX_CHANNELS> rx_resamplers = {};
 
   rf_timestamp_t    end_of_burst_time = {};
   std::atomic<bool> is_start_of_burst{false};
@@ -121,6 +125,8 @@ private:
   bool              is_initialized     = false;
   bool              radio_is_streaming = false;
   bool              continuous_tx      = false;
+  bool              virtual_clock      = false;
+  bool              poly_resampler     = false;
   double            freq_offset        = 0.0;
   double            cur_tx_srate       = 0.0;
   double            cur_rx_srate       = 0.0;
@@ -130,6 +136,8 @@ private:
   uint32_t          nof_channels_x_dev = 0;
   uint32_t          nof_carriers       = 0;
 
+  std::chrono::steady_clock::time_point stream_start; ///< Wall-clock time of the first reception
+
   std::vector<double> cur_tx_freqs = {};
   std::vector<double> cur_rx_freqs = {};
 
@@ -24,12 +24,15 @@
 
 #include "srsran/common/buffer_pool.h"
 #include "srsran/common/common.h"
+#include "srsran/common/rcu.h"
 #include "srsran/common/task_scheduler.h"
 #include "srsran/interfaces/ue_pdcp_interfaces.h"
 #include "srsran/interfaces/ue_rlc_interfaces.h"
 #include "srsran/interfaces/ue_rrc_interfaces.h"
 #include "srsran/rlc/rlc_common.h"
 #include "srsran/rlc/rlc_metrics.h"
+#include <list>
+#include <mutex>
 
 namespace srsran {
 
@@ -70,6 +73,9 @@ public:
   uint32_t get_buffer_state(const uint32_t lcid);
   uint32_t get_total_mch_buffer_state(uint32_t lcid);
   uint32_t read_pdu(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes);
+  uint32_t read_pdu_sg(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes, const_byte_span& body);
+  bool     release_pdu_sg(uint32_t lcid, const_byte_span body);
+  bool     has_lent_pdus();
   uint32_t read_pdu_mch(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes);
   int      get_increment_sequence_num();
   void     write_pdu(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes);
@@ -107,8 +113,21 @@ private:
 
   typedef std::map<uint16_t, std::unique_ptr<rlc_common> >  rlc_map_t;
 
-  rlc_map_t        rlc_array, rlc_array_mrb;
-  pthread_rwlock_t rwlock;
+  // The maps own the entities and are only accessed from the Stack thread. The MAC interface, called from the PHY
+  // workers, looks them up in the LCID-indexed tables, whose entries are removed before a grace period
+  rlc_map_t                     rlc_array, rlc_array_mrb;
+  srsran::rcu_table<rlc_common> rlc_table, rlc_table_mrb;
+
+  // Deleted entities, which may have lent PDUs to TBs waiting to be encoded. They are parked before being removed from
+  // the table, so that a release always reaches the entity that lent the PDU, even if the LCID was added again. The
+  // owner is set after the grace period of the table, and the entity is destroyed once it has no lent PDUs left
+  struct parked_bearer_t {
+    uint32_t                    lcid;
+    rlc_common*                 rb;
+    std::unique_ptr<rlc_common> owner;
+  };
+  std::mutex                 parked_mutex;
+  std::list<parked_bearer_t> parked_bearers;
 
   uint32_t default_lcid = 0;
 
@@ -117,8 +136,12 @@ private:
   // Timer needed for metrics calculation
   std::chrono::high_resolution_clock::time_point metrics_tp;
 
-  bool valid_lcid(uint32_t lcid);
-  bool valid_lcid_mrb(uint32_t lcid);
+  bool        valid_lcid(uint32_t lcid);
+  bool        valid_lcid_mrb(uint32_t lcid);
+  rlc_common* get_bearer(uint32_t lcid);
+  rlc_common* get_bearer_mrb(uint32_t lcid);
+  void        park_bearer(uint32_t lcid, rlc_common* rb);
+  void        destroy_bearer(std::unique_ptr<rlc_common> rb);
 
   void update_bsr(uint32_t lcid);
   void update_bsr_mch(uint32_t lcid);
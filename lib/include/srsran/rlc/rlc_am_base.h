@@ -27,7 +27,7 @@
 #include "srsran/common/timers.h"
 #include "srsran/interfaces/ue_rrc_interfaces.h"
 #include "srsran/rlc/rlc_common.h"
-#include "srsran/upper/byte_buffer_queue.h"
+#include "srsran/upper/byte_buffer_spsc_queue.h"
 #include <map>
 #include <mutex>
 #include <pthread.h>
@@ -97,6 +97,9 @@ public:
   void     get_buffer_state(uint32_t& n_bytes_newtx, uint32_t& n_bytes_prio) final;
 
   uint32_t read_pdu(uint8_t* payload, uint32_t nof_bytes) final;
+  uint32_t read_pdu_sg(uint8_t* payload, uint32_t nof_bytes, const_byte_span& body) final;
+  bool     release_pdu_sg(const_byte_span body) final;
+  bool     has_lent_pdus() final;
 
   void write_pdu(uint8_t* payload, uint32_t nof_bytes) final;
 
@@ -150,18 +153,26 @@ public:
 
     int              write_sdu(unique_byte_buffer_t sdu);
     bool             sdu_queue_is_full();
+    uint32_t         get_sdu_queue_hol_delay_us();
     virtual void     discard_sdu(uint32_t pdcp_sn);
     virtual uint32_t read_pdu(uint8_t* payload, uint32_t nof_bytes) = 0;
-
-    bool                  tx_enabled = false;
+    virtual uint32_t read_pdu_sg(uint8_t* payload, uint32_t nof_bytes, const_byte_span& body)
+    {
+      body = {};
+      return read_pdu(payload, nof_bytes);
+    }
+    virtual bool release_pdu_sg(const_byte_span body) { return false; }
+    virtual bool has_lent_pdus() { return false; }
+
+    std::atomic<bool>     tx_enabled = {false};
     byte_buffer_pool*     pool       = nullptr;
     srslog::basic_logger& logger;
     std::string           rb_name;
 
     bsr_callback_t bsr_callback;
 
-    // Tx SDU buffers
-    byte_buffer_queue tx_sdu_queue;
+    // Tx SDU buffers. PDCP writes without the mutex, which serializes the reads and discards
+    byte_buffer_spsc_queue tx_sdu_queue;
 
     // Mutexes
     std::mutex mutex;
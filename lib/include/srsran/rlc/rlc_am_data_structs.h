@@ -28,6 +28,7 @@
 #include "srsran/common/buffer_pool.h"
 #include <array>
 #include <list>
+#include <memory>
 #include <vector>
 
 namespace srsran {
@@ -205,6 +206,230 @@ public:
   const_iterator end() const { return list.end(); }
 };
 
+/// Pool of the RLC AM PDU segments received by a bearer. The segments are allocated in chunks when the pool runs out,
+/// and returned to it once their PDU/SDU is reassembled or discarded, so that reassembly does not allocate memory once
+/// the pool has grown to the number of segments in flight.
+template <typename PduType>
+class rlc_am_rx_segment_pool
+{
+public:
+  const static size_t default_chunk_size = 64;
+
+  struct free_list_tag {};
+  struct segment : public intrusive_forward_list_element<free_list_tag> {
+    PduType                          pdu;
+    segment*                         next        = nullptr; ///< Next segment of the same SN, in SO order
+    rlc_am_rx_segment_pool<PduType>* parent_pool = nullptr;
+
+    void release() { parent_pool->deallocate(this); }
+  };
+
+  explicit rlc_am_rx_segment_pool(size_t chunk_size_ = default_chunk_size) : chunk_size(chunk_size_) { grow(); }
+  rlc_am_rx_segment_pool(const rlc_am_rx_segment_pool&) = delete;
+  rlc_am_rx_segment_pool(rlc_am_rx_segment_pool&&)      = delete;
+  rlc_am_rx_segment_pool& operator=(const rlc_am_rx_segment_pool&) = delete;
+  rlc_am_rx_segment_pool& operator=(rlc_am_rx_segment_pool&&) = delete;
+
+  segment* allocate()
+  {
+    if (free_list.empty()) {
+      grow();
+    }
+    nof_used++;
+    return free_list.pop_front();
+  }
+  void deallocate(segment* s)
+  {
+    s->pdu.buf.reset();
+    s->next = nullptr;
+    free_list.push_front(s);
+    nof_used--;
+  }
+
+  size_t capacity() const { return chunks.size() * chunk_size; }
+  size_t size() const { return nof_used; }
+
+private:
+  void grow()
+  {
+    chunks.emplace_back(new segment[chunk_size]);
+    for (size_t i = 0; i < chunk_size; ++i) {
+      chunks.back()[i].parent_pool = this;
+      free_list.push_front(&chunks.back()[i]);
+    }
+  }
+
+  size_t                                         chunk_size;
+  size_t                                         nof_used = 0;
+  std::vector<std::unique_ptr<segment[]> >       chunks;
+  intrusive_forward_list<segment, free_list_tag> free_list;
+};
+
+/// Segments received for the PDU (LTE) or SDU (NR) with a given SN, sorted by SO, and the byte range they cover.
+/// The coverage is updated on insertion, so that checking for gaps and for completeness does not walk the segments.
+/// Segments are taken from the pool of the bearer and returned to it when removed from the list.
+template <typename PduType>
+class rlc_am_rx_segment_list
+{
+public:
+  using segment = typename rlc_am_rx_segment_pool<PduType>::segment;
+
+  template <typename U>
+  class iterator_impl
+  {
+    using node_t = typename std::conditional<std::is_const<U>::value, const segment, segment>::type;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = U;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = U*;
+    using reference         = U&;
+
+    explicit iterator_impl(node_t* node_ = nullptr) : node(node_) {}
+    iterator_impl<U>& operator++()
+    {
+      node = node->next;
+      return *this;
+    }
+    iterator_impl<U> operator++(int)
+    {
+      iterator_impl<U> ret = *this;
+      node                 = node->next;
+      return ret;
+    }
+    pointer   operator->() { return &node->pdu; }
+    reference operator*() { return node->pdu; }
+
+    bool operator==(const iterator_impl<U>& other) const { return node == other.node; }
+    bool operator!=(const iterator_impl<U>& other) const { return node != other.node; }
+
+  private:
+    node_t* node;
+  };
+  using iterator       = iterator_impl<PduType>;
+  using const_iterator = iterator_impl<const PduType>;
+
+  rlc_am_rx_segment_list()                              = default;
+  rlc_am_rx_segment_list(const rlc_am_rx_segment_list&) = delete;
+  rlc_am_rx_segment_list(rlc_am_rx_segment_list&& other) noexcept { steal(other); }
+  rlc_am_rx_segment_list& operator=(const rlc_am_rx_segment_list&) = delete;
+  rlc_am_rx_segment_list& operator=(rlc_am_rx_segment_list&& other) noexcept
+  {
+    if (this != &other) {
+      clear();
+      steal(other);
+    }
+    return *this;
+  }
+  ~rlc_am_rx_segment_list() { clear(); }
+
+  /// Inserts a segment in SO order. A segment with the same SO as a stored one replaces it if it is longer, and is
+  /// returned to the pool otherwise
+  void insert(segment* s)
+  {
+    segment** pos = &head;
+    while (*pos != nullptr and so(*pos) < so(s)) {
+      pos = &(*pos)->next;
+    }
+    if (*pos != nullptr and so(*pos) == so(s)) {
+      if (length(s) > length(*pos)) {
+        std::swap((*pos)->pdu, s->pdu);
+      }
+      s->release();
+    } else {
+      s->next = *pos;
+      *pos    = s;
+      if (s->next == nullptr) {
+        tail = s;
+      }
+      count++;
+    }
+    s = *pos;
+
+    // Extend the coverage with the segment and the following ones it makes contiguous
+    highest_end = std::max(highest_end, end(s));
+    for (; s != nullptr and so(s) <= contiguous_end; s = s->next) {
+      contiguous_end = std::max(contiguous_end, end(s));
+    }
+  }
+
+  /// Removes the segments whose bytes are all contained in the segments with lower SO. The coverage is unchanged
+  void remove_overlapped()
+  {
+    uint32_t  covered_end = 0;
+    segment*  prev        = nullptr;
+    segment** pos         = &head;
+    while (*pos != nullptr) {
+      segment* s = *pos;
+      if (end(s) <= covered_end) {
+        *pos = s->next;
+        s->release();
+        count--;
+      } else {
+        covered_end = end(s);
+        prev        = s;
+        pos         = &s->next;
+      }
+    }
+    tail = prev;
+  }
+
+  void clear()
+  {
+    while (head != nullptr) {
+      segment* s = head;
+      head       = s->next;
+      s->release();
+    }
+    tail           = nullptr;
+    count          = 0;
+    contiguous_end = 0;
+    highest_end    = 0;
+  }
+
+  /// Number of bytes received from the start without gaps
+  uint32_t contiguous_bytes() const { return contiguous_end; }
+  /// Offset following the last byte received
+  uint32_t end_offset() const { return highest_end; }
+  /// Whether bytes are missing before the last byte received
+  bool has_gap() const { return contiguous_end < highest_end; }
+
+  bool           empty() const { return head == nullptr; }
+  size_t         size() const { return count; }
+  PduType&       front() { return head->pdu; }
+  PduType&       back() { return tail->pdu; }
+  iterator       begin() { return iterator(head); }
+  iterator       end() { return iterator(nullptr); }
+  const_iterator begin() const { return const_iterator(head); }
+  const_iterator end() const { return const_iterator(nullptr); }
+
+private:
+  static uint32_t so(const segment* s) { return s->pdu.header.so; }
+  static uint32_t length(const segment* s) { return s->pdu.buf->N_bytes; }
+  static uint32_t end(const segment* s) { return so(s) + length(s); }
+
+  void steal(rlc_am_rx_segment_list& other)
+  {
+    head                 = other.head;
+    tail                 = other.tail;
+    count                = other.count;
+    contiguous_end       = other.contiguous_end;
+    highest_end          = other.highest_end;
+    other.head           = nullptr;
+    other.tail           = nullptr;
+    other.count          = 0;
+    other.contiguous_end = 0;
+    other.highest_end    = 0;
+  }
+
+  segment* head           = nullptr;
+  segment* tail           = nullptr;
+  uint32_t count          = 0;
+  uint32_t contiguous_end = 0;
+  uint32_t highest_end    = 0;
+};
+
 template <class T>
 struct rlc_ringbuffer_base {
   virtual ~rlc_ringbuffer_base()           = default;
@@ -372,7 +597,7 @@ class pdu_retx_queue_base
 {
 public:
   virtual ~pdu_retx_queue_base()           = default;
-  virtual T&     push()                    = 0;
+  virtual T&     push(uint32_t sn)         = 0;
   virtual void   pop()                     = 0;
   virtual T&     front()                   = 0;
   virtual void   clear()                   = 0;
@@ -387,21 +612,32 @@ public:
   virtual bool has_sn(uint32_t sn, uint32_t so) const = 0;
 };
 
+/// Fixed-size retransmission queue. The number of queued entries of each SN is counted, so that checking whether a SN
+/// is queued does not walk the queue. The SNs in the queue must fit in a window of WINDOW_SIZE SNs.
 template <class T, std::size_t WINDOW_SIZE>
 class pdu_retx_queue : public pdu_retx_queue_base<T>
 {
 public:
   ~pdu_retx_queue() = default;
 
-  T& push() override
+  T& push(uint32_t sn) override
   {
     assert(not full());
     T& p = buffer[wpos];
+    p.sn = sn;
+    sn_count[sn % WINDOW_SIZE]++;
     wpos = (wpos + 1) % WINDOW_SIZE;
     return p;
   }
 
-  void pop() override { rpos = (rpos + 1) % WINDOW_SIZE; }
+  void pop() override
+  {
+    if (empty()) {
+      return;
+    }
+    sn_count[buffer[rpos].sn % WINDOW_SIZE]--;
+    rpos = (rpos + 1) % WINDOW_SIZE;
+  }
 
   T& front() override
   {
@@ -423,22 +659,20 @@ public:
 
   void clear() override
   {
+    while (not empty()) {
+      pop();
+    }
     wpos = 0;
     rpos = 0;
   }
 
-  bool has_sn(uint32_t sn) const override
-  {
-    for (size_t i = rpos; i != wpos; i = (i + 1) % WINDOW_SIZE) {
-      if (buffer[i].sn == sn) {
-        return true;
-      }
-    }
-    return false;
-  }
+  bool has_sn(uint32_t sn) const override { return sn_count[sn % WINDOW_SIZE] > 0; }
 
   bool has_sn(uint32_t sn, uint32_t so) const override
   {
+    if (not has_sn(sn)) {
+      return false;
+    }
     for (size_t i = rpos; i != wpos; i = (i + 1) % WINDOW_SIZE) {
       if (buffer[i].sn == sn) {
         if (buffer[i].overlaps(so)) {
@@ -454,92 +688,176 @@ public:
   bool   full() const override { return size() == WINDOW_SIZE - 1; }
 
 private:
-  std::array<T, WINDOW_SIZE> buffer;
-  size_t                     wpos = 0;
-  size_t                     rpos = 0;
+  std::array<T, WINDOW_SIZE>        buffer;
+  std::array<uint16_t, WINDOW_SIZE> sn_count = {};
+  size_t                            wpos     = 0;
+  size_t                            rpos     = 0;
 };
 
+/// Retransmission queue of unbounded size. The entries are kept in a ring buffer that only grows when full, so that no
+/// memory is allocated once it has reached the maximum number of queued retransmissions. As in pdu_retx_queue, the
+/// entries of each SN are counted. Entries removed from the middle of the queue are invalidated and skipped.
 template <class T>
 class pdu_retx_queue_list
 {
-  std::list<T> queue;
+  const static uint32_t invalid_sn = T::invalid_rlc_sn;
 
 public:
+  class const_iterator
+  {
+  public:
+    const_iterator(const pdu_retx_queue_list<T>* parent_, size_t idx_) : parent(parent_), idx(idx_) { skip_invalid(); }
+    const_iterator& operator++()
+    {
+      idx++;
+      skip_invalid();
+      return *this;
+    }
+    const T& operator*() const { return parent->at(idx); }
+    const T* operator->() const { return &parent->at(idx); }
+    bool     operator==(const const_iterator& other) const { return idx == other.idx; }
+    bool     operator!=(const const_iterator& other) const { return idx != other.idx; }
+
+  private:
+    void skip_invalid()
+    {
+      while (idx < parent->nof_entries and parent->at(idx).sn == invalid_sn) {
+        idx++;
+      }
+    }
+
+    const pdu_retx_queue_list<T>* parent;
+    size_t                        idx;
+  };
+
+  explicit pdu_retx_queue_list(size_t capacity = 128) : buffer(capacity) {}
   ~pdu_retx_queue_list() = default;
-  T& push()
+
+  /// Sets the size of the window the queued SNs must fit in. Clears the queue
+  void set_window_size(uint32_t window_size)
   {
-    queue.emplace_back();
-    return queue.back();
+    clear();
+    sn_count.assign(window_size, 0);
+  }
+
+  T& push(uint32_t sn)
+  {
+    srsran_assert(not sn_count.empty(), "The window size of the retx queue was not set");
+    if (nof_entries == buffer.size()) {
+      grow();
+    }
+    T& p = at(nof_entries);
+    p    = T{};
+    p.sn = sn;
+    sn_count[sn % sn_count.size()]++;
+    nof_entries++;
+    nof_valid++;
+    return p;
   }
 
   void pop()
   {
-    if (not queue.empty()) {
-      queue.pop_front();
+    if (empty()) {
+      return;
     }
+    invalidate(at(0));
+    trim_front();
   }
 
   T& front()
   {
-    assert(not queue.empty());
-    return queue.front();
+    assert(not empty());
+    return at(0);
   }
 
-  const std::list<T>& get_inner_queue() const { return queue; }
-
-  void   clear() { queue.clear(); }
-  size_t size() const { return queue.size(); }
-  bool   empty() const { return queue.empty(); }
-
-  bool has_sn(uint32_t sn) const
+  void clear()
   {
-    if (queue.empty()) {
-      return false;
-    }
-    for (auto elem : queue) {
-      if (elem.sn == sn) {
-        return true;
+    for (size_t i = 0; i < nof_entries; ++i) {
+      if (at(i).sn != invalid_sn) {
+        invalidate(at(i));
       }
     }
-    return false;
-  };
+    rpos        = 0;
+    nof_entries = 0;
+  }
+  size_t size() const { return nof_valid; }
+  bool   empty() const { return nof_valid == 0; }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, nof_entries); }
+
+  bool has_sn(uint32_t sn) const { return not sn_count.empty() and sn_count[sn % sn_count.size()] > 0; }
 
   bool has_sn(uint32_t sn, uint32_t so) const
   {
-    if (queue.empty()) {
+    if (not has_sn(sn)) {
       return false;
     }
-    for (auto elem : queue) {
-      if (elem.sn == sn) {
-        if (elem.overlaps(so)) {
-          return true;
-        }
+    for (const T& elem : *this) {
+      if (elem.sn == sn and elem.overlaps(so)) {
+        return true;
       }
     }
     return false;
-  };
+  }
 
   /**
-   * @brief remove_sn removes SN from queue and returns after first match
+   * @brief remove_sn removes all entries of a SN from the queue
    * @param sn sequence number to be removed from queue
-   * @return true if one element was removed, false if no element to remove was found
+   * @return true if at least one element was removed, false if no element to remove was found
    */
   bool remove_sn(uint32_t sn)
   {
-    if (queue.empty()) {
+    if (not has_sn(sn)) {
       return false;
     }
-    auto iter = queue.begin();
-    while (iter != queue.end()) {
-      if (iter->sn == sn) {
-        iter = queue.erase(iter);
-        return true;
-      } else {
-        ++iter;
+    for (size_t i = 0; i < nof_entries; ++i) {
+      if (at(i).sn == sn) {
+        invalidate(at(i));
       }
     }
-    return false;
+    trim_front();
+    return true;
   }
+
+private:
+  T&       at(size_t idx) { return buffer[(rpos + idx) % buffer.size()]; }
+  const T& at(size_t idx) const { return buffer[(rpos + idx) % buffer.size()]; }
+
+  void invalidate(T& elem)
+  {
+    sn_count[elem.sn % sn_count.size()]--;
+    elem.sn = invalid_sn;
+    nof_valid--;
+  }
+
+  // Drops the invalidated entries at the front, so that the front is always a valid entry
+  void trim_front()
+  {
+    while (nof_entries > 0 and at(0).sn == invalid_sn) {
+      rpos = (rpos + 1) % buffer.size();
+      nof_entries--;
+    }
+    if (nof_entries == 0) {
+      rpos = 0;
+    }
+  }
+
+  void grow()
+  {
+    std::vector<T> new_buffer(buffer.size() * 2);
+    for (size_t i = 0; i < nof_entries; ++i) {
+      new_buffer[i] = at(i);
+    }
+    buffer = std::move(new_buffer);
+    rpos   = 0;
+  }
+
+  std::vector<T>        buffer;
+  std::vector<uint16_t> sn_count;
+  size_t                rpos        = 0;
+  size_t                nof_entries = 0; ///< Entries between the front and the back, including invalidated ones
+  size_t                nof_valid   = 0;
 };
 
 } // namespace srsran
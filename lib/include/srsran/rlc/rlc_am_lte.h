@@ -39,6 +39,7 @@
 #include <deque>
 #include <list>
 #include <map>
+#include <unordered_map>
 
 namespace srsran {
 
@@ -68,6 +69,9 @@ public:
   void stop();
 
   uint32_t read_pdu(uint8_t* payload, uint32_t nof_bytes);
+  uint32_t read_pdu_sg(uint8_t* payload, uint32_t nof_bytes, const_byte_span& body) final;
+  bool     release_pdu_sg(const_byte_span body) final;
+  bool     has_lent_pdus() final;
 
   bool     has_data();
   uint32_t get_buffer_state();
@@ -86,10 +90,14 @@ private:
   void stop_nolock();
 
   int  build_status_pdu(uint8_t* payload, uint32_t nof_bytes);
-  int  build_retx_pdu(uint8_t* payload, uint32_t nof_bytes);
-  int  build_segment(uint8_t* payload, uint32_t nof_bytes, rlc_amd_retx_lte_t retx);
-  int  build_data_pdu(uint8_t* payload, uint32_t nof_bytes);
+  uint32_t read_pdu_nolock(uint8_t* payload, uint32_t nof_bytes, const_byte_span* body);
+  int      build_retx_pdu(uint8_t* payload, uint32_t nof_bytes, const_byte_span* body);
+  int      build_segment(uint8_t* payload, uint32_t nof_bytes, rlc_amd_retx_lte_t retx);
+  int      build_data_pdu(uint8_t* payload, uint32_t nof_bytes, const_byte_span* body);
   void update_notification_ack_info(uint32_t rlc_sn);
+  void lend_pdu(uint32_t sn, const_byte_span* body);
+  void remove_tx_window_pdu(uint32_t sn);
+  void clear_tx_window();
 
   int  required_buffer_size(const rlc_amd_retx_lte_t& retx);
   void retransmit_pdu(uint32_t sn);
@@ -149,6 +157,15 @@ private:
   pdu_retx_queue<rlc_amd_retx_lte_t, RLC_AM_WINDOW_SIZE>                     retx_queue;
   pdcp_sn_vector_t                                                           notify_info_vec;
 
+  // Tx window PDUs referenced by MAC through read_pdu_sg(), with the number of TBs referencing them. A PDU removed
+  // from the Tx window (ACK, reestablishment, stop) while still referenced is kept here until the last release
+  struct lent_pdu_t {
+    uint32_t             sn    = 0;
+    uint32_t             count = 0;
+    unique_byte_buffer_t orphan;
+  };
+  std::unordered_map<const uint8_t*, lent_pdu_t> lent_pdus;
+
   // Mutexes
   std::mutex mutex;
 
@@ -189,7 +206,7 @@ private:
   bool inside_rx_window(const int16_t sn);
   void debug_state();
   void print_rx_segments();
-  bool add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_amd_rx_pdu* segment);
+  bool add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_am_rx_segment_pool<rlc_amd_rx_pdu>::segment* segment);
   void reset_status();
 
   rlc_am*           parent = nullptr;
@@ -221,12 +238,17 @@ private:
   std::mutex mutex;
 
   // Rx windows
-  rlc_ringbuffer_t<rlc_amd_rx_pdu, RLC_AM_WINDOW_SIZE> rx_window;
-  std::map<uint32_t, rlc_amd_rx_pdu_segments_t>        rx_segments;
+  rlc_ringbuffer_t<rlc_amd_rx_pdu, RLC_AM_WINDOW_SIZE>            rx_window;
+  rlc_am_rx_segment_pool<rlc_amd_rx_pdu>                          segment_pool{16};
+  rlc_ringbuffer_t<rlc_amd_rx_pdu_segments_t, RLC_AM_WINDOW_SIZE> rx_segments;
 
   bool              poll_received = false;
   std::atomic<bool> do_status     = {false}; // light-weight access from Tx entity
 
+  // Length of the full status PDU, only computed again after the RX window or the state variables change
+  int  status_pdu_len       = 0;
+  bool status_pdu_len_valid = false;
+
   /****************************************************************************
    * Timers
    * Ref: 3GPP TS 36.322 v10.0.0 Section 7
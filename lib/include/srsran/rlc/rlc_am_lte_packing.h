@@ -44,7 +44,11 @@ struct rlc_amd_rx_pdu {
 };
 
 struct rlc_amd_rx_pdu_segments_t {
-  std::list<rlc_amd_rx_pdu> segments;
+  uint32_t                               rlc_sn = 0;
+  rlc_am_rx_segment_list<rlc_amd_rx_pdu> segments;
+
+  rlc_amd_rx_pdu_segments_t() = default;
+  explicit rlc_amd_rx_pdu_segments_t(uint32_t rlc_sn_) : rlc_sn(rlc_sn_) {}
 };
 
 /****************************************************************************
@@ -252,7 +252,8 @@ public:
   bool inside_rx_window(uint32_t sn) const;
   bool valid_ack_sn(uint32_t sn) const;
   void write_to_upper_layers(uint32_t lcid, unique_byte_buffer_t sdu);
-  void insert_received_segment(rlc_amd_rx_pdu_nr segment, rlc_amd_rx_sdu_nr_t::segment_list_t& segment_list) const;
+  void insert_received_segment(rlc_am_rx_segment_pool<rlc_amd_rx_pdu_nr>::segment* segment,
+                               rlc_amd_rx_sdu_nr_t::segment_list_t&                segment_list) const;
   /**
    * @brief update_segment_inventory This function updates the flags has_gap and fully_received of an SDU
    * according to the current inventory of received SDU segments
@@ -279,7 +280,13 @@ private:
   uint32_t mod_nr = cardinality(rlc_am_nr_sn_size_t());
   uint32_t rx_mod_base_nr(uint32_t sn) const;
 
-  // RX Window
+  // Full status PDU, only rebuilt after the RX window or the state variables change
+  rlc_am_nr_status_pdu_t status_cache{rlc_am_nr_sn_size_t::nulltype};
+  bool                   status_cache_valid = false;
+  void                   update_status_cache();
+
+  // RX Window. The segments of the SDUs in the window are taken from the pool
+  rlc_am_rx_segment_pool<rlc_amd_rx_pdu_nr>                  segment_pool;
   std::unique_ptr<rlc_ringbuffer_base<rlc_amd_rx_sdu_nr_t> > rx_window;
 
   // Mutexes
@@ -24,6 +24,7 @@
 
 #include "srsran/common/string_helpers.h"
 #include "srsran/rlc/rlc_am_base.h"
+#include "srsran/rlc/rlc_am_data_structs.h"
 #include <set>
 
 namespace srsran {
@@ -63,16 +64,12 @@ struct rlc_amd_rx_pdu_nr {
   explicit rlc_amd_rx_pdu_nr(uint32_t rlc_sn_) : rlc_sn(rlc_sn_) {}
 };
 
-struct rlc_amd_rx_pdu_nr_cmp {
-  bool operator()(const rlc_amd_rx_pdu_nr& a, const rlc_amd_rx_pdu_nr& b) const { return a.header.so < b.header.so; }
-};
-
 struct rlc_amd_rx_sdu_nr_t {
   uint32_t             rlc_sn         = 0;
   bool                 fully_received = false;
   bool                 has_gap        = false;
   unique_byte_buffer_t buf;
-  using segment_list_t = std::set<rlc_amd_rx_pdu_nr, rlc_amd_rx_pdu_nr_cmp>;
+  using segment_list_t = rlc_am_rx_segment_list<rlc_amd_rx_pdu_nr>;
   segment_list_t segments;
 
   rlc_amd_rx_sdu_nr_t() = default;
@@ -120,6 +117,8 @@ public:
   const uint32_t& packed_size = packed_size_;
 
   rlc_am_nr_status_pdu_t(rlc_am_nr_sn_size_t sn_size);
+  rlc_am_nr_status_pdu_t(const rlc_am_nr_status_pdu_t& other);
+  rlc_am_nr_status_pdu_t& operator=(const rlc_am_nr_status_pdu_t& other);
   void reset();
   bool is_continuous_sequence(const rlc_status_nack_t& left, const rlc_status_nack_t& right) const;
   void push_nack(const rlc_status_nack_t& nack);
@@ -298,6 +298,18 @@ public:
   virtual uint32_t read_pdu(uint8_t* payload, uint32_t nof_bytes)                = 0;
   virtual void     write_pdu(uint8_t* payload, uint32_t nof_bytes)               = 0;
 
+  // Scatter-gather read, see read_pdu_interface::read_pdu_sg(). Entities that cannot reference their PDUs copy them.
+  virtual uint32_t read_pdu_sg(uint8_t* payload, uint32_t nof_bytes, const_byte_span& body)
+  {
+    body = {};
+    return read_pdu(payload, nof_bytes);
+  }
+  // Releases a body returned by read_pdu_sg() once the TB that references it was encoded. Returns false if the body
+  // was not lent by this entity
+  virtual bool release_pdu_sg(const_byte_span body) { return false; }
+  // Whether bodies returned by read_pdu_sg() are still referenced, so the entity must outlive them
+  virtual bool has_lent_pdus() { return false; }
+
   virtual void set_bsr_callback(bsr_callback_t callback) = 0;
 
   void* operator new(size_t sz) { return allocate_rlc_bearer(sz); }
@@ -45,6 +45,7 @@ typedef struct {
 
   // misc metrics
   uint32_t rx_buffered_bytes; //< sum of payload of PDUs buffered in rx_window
+  uint32_t tx_hol_delay_us;   //< Time the oldest SDU in the Tx SDU queue has been waiting
 } rlc_bearer_metrics_t;
 
 typedef struct {
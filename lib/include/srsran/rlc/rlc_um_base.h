@@ -27,7 +27,7 @@
 #include "srsran/common/common.h"
 #include "srsran/common/task_scheduler.h"
 #include "srsran/rlc/rlc_common.h"
-#include "srsran/upper/byte_buffer_queue.h"
+#include "srsran/upper/byte_buffer_spsc_queue.h"
 #include <map>
 #include <mutex>
 #include <pthread.h>
@@ -94,6 +94,7 @@ protected:
     void             write_sdu(unique_byte_buffer_t sdu);
     void             discard_sdu(uint32_t discard_sn);
     bool             sdu_queue_is_full();
+    uint32_t         get_sdu_queue_hol_delay_us();
     int              try_write_sdu(unique_byte_buffer_t sdu);
     void             reset_metrics();
     bool             has_data();
@@ -110,9 +111,9 @@ protected:
 
     rlc_config_t cfg = {};
 
-    // TX SDU buffers
-    byte_buffer_queue    tx_sdu_queue;
-    unique_byte_buffer_t tx_sdu;
+    // TX SDU buffers. PDCP writes without the mutex, which serializes the reads and discards
+    byte_buffer_spsc_queue tx_sdu_queue;
+    unique_byte_buffer_t   tx_sdu;
 
     // Mutexes
     std::mutex mutex;
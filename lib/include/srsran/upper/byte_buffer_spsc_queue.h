@@ -0,0 +1,290 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * @file byte_buffer_spsc_queue.h
+ *
+ * @brief Lock-free queue of unique pointers to byte buffers with a single producer
+ *        (e.g. PDCP writing SDUs) and a single consumer (e.g. RLC building PDUs
+ *        for MAC). The number of queued SDUs and bytes, and the head-of-line
+ *        delay, can be read from any thread without locks.
+ */
+
+#ifndef SRSRAN_BYTE_BUFFER_SPSC_QUEUE_H
+#define SRSRAN_BYTE_BUFFER_SPSC_QUEUE_H
+
+#include "srsran/adt/expected.h"
+#include "srsran/common/byte_buffer.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace srsran {
+
+/**
+ * Bounded SDU queue for one producer and one consumer thread, with the following features:
+ * - writes and reads do not take locks, except for the blocking write()/read() when the queue is full/empty
+ * - the producer publishes the number of pushed SDUs and bytes, and the consumer the number of removed ones, each with a
+ *   single atomic store. The queue size and bytes are their difference, which is always a state the queue actually
+ *   went through, so that buffer status reports can be computed from other threads
+ * - the enqueue time of each SDU is stored with it, to provide the head-of-line delay
+ * - SDUs can be discarded from the consumer side. Their slots are skipped by the reads
+ * The methods documented as consumer side (reads, discards) must not be called concurrently with each other, i.e.
+ * from the consumer thread or under the lock that serializes the consumers. resize() must not be called concurrently
+ * with any other method.
+ */
+class byte_buffer_spsc_queue
+{
+  using sdu_clock = std::chrono::steady_clock;
+
+  // avoid false sharing between producer and consumer indexes
+  static const size_t cache_line_size = 64;
+
+public:
+  explicit byte_buffer_spsc_queue(uint32_t capacity_ = 128) { resize(capacity_); }
+  byte_buffer_spsc_queue(const byte_buffer_spsc_queue&) = delete;
+  byte_buffer_spsc_queue& operator=(const byte_buffer_spsc_queue&) = delete;
+
+  /// Producer side. Blocks while the queue is full
+  void write(unique_byte_buffer_t msg)
+  {
+    while (not try_push(msg)) {
+      std::unique_lock<std::mutex> lock(wait_mutex);
+      producer_waiting.store(true);
+      if (write_idx.load() - read_idx.load() >= capacity) {
+        wait_cvar.wait(lock);
+      }
+      producer_waiting.store(false);
+    }
+  }
+
+  /// Producer side. Returns the SDU back if the queue is full
+  srsran::error_type<unique_byte_buffer_t> try_write(unique_byte_buffer_t&& msg)
+  {
+    if (not try_push(msg)) {
+      return std::move(msg);
+    }
+    return {};
+  }
+
+  /// Consumer side. Blocks while the queue is empty
+  unique_byte_buffer_t read()
+  {
+    unique_byte_buffer_t msg;
+    while (not try_read(&msg)) {
+      std::unique_lock<std::mutex> lock(wait_mutex);
+      consumer_waiting.store(true);
+      if (read_idx.load() == write_idx.load()) {
+        wait_cvar.wait(lock);
+      }
+      consumer_waiting.store(false);
+    }
+    return msg;
+  }
+
+  /// Consumer side. Returns false if the queue is empty. Discarded SDUs are skipped
+  bool try_read(unique_byte_buffer_t* msg)
+  {
+    uint64_t r = read_idx.load(std::memory_order_relaxed);
+    uint64_t w = write_idx.load(std::memory_order_acquire);
+    for (; r != w; ++r) {
+      slot_t& s = slots[r & mask];
+      if (s.sdu != nullptr) {
+        *msg = std::move(s.sdu);
+        nof_popped.store(nof_popped.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        popped_bytes.store(popped_bytes.load(std::memory_order_relaxed) + (*msg)->N_bytes, std::memory_order_release);
+        read_idx.store(r + 1);
+        notify_producer();
+        return true;
+      }
+    }
+    read_idx.store(r);
+    return false;
+  }
+
+  /**
+   * Consumer side. Discards the first queued SDU for which pred(sdu) returns true
+   * @return true if an SDU was discarded
+   */
+  template <typename F>
+  bool discard_first(const F& pred)
+  {
+    uint64_t r = read_idx.load(std::memory_order_relaxed);
+    uint64_t w = write_idx.load(std::memory_order_acquire);
+    for (uint64_t i = r; i != w; ++i) {
+      slot_t& s = slots[i & mask];
+      if (s.sdu != nullptr and pred(s.sdu)) {
+        nof_popped.store(nof_popped.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        popped_bytes.store(popped_bytes.load(std::memory_order_relaxed) + s.sdu->N_bytes, std::memory_order_release);
+        s.sdu.reset();
+        // the head must not be a discarded SDU, for the head-of-line delay
+        while (r != w and slots[r & mask].sdu == nullptr) {
+          ++r;
+        }
+        read_idx.store(r);
+        notify_producer();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Changes the capacity. Queued SDUs are kept, as long as they fit
+  void resize(uint32_t capacity_)
+  {
+    size_t nof_slots = 1;
+    while (nof_slots < capacity_) {
+      nof_slots <<= 1u;
+    }
+    std::unique_ptr<slot_t[]> new_slots(new slot_t[nof_slots]);
+    uint64_t                  r = read_idx.load(), w = write_idx.load(), n = 0;
+    for (; r != w and n < capacity_; ++r) {
+      slot_t& s = slots[r & mask];
+      if (s.sdu != nullptr) {
+        new_slots[n].sdu = std::move(s.sdu);
+        new_slots[n].enqueue_time.store(s.enqueue_time.load());
+        n++;
+      }
+    }
+    // SDUs that no longer fit are dropped
+    for (; r != w; ++r) {
+      if (slots[r & mask].sdu != nullptr) {
+        nof_popped.store(nof_popped.load() + 1);
+        popped_bytes.store(popped_bytes.load() + slots[r & mask].sdu->N_bytes);
+      }
+    }
+    slots    = std::move(new_slots);
+    mask     = nof_slots - 1;
+    capacity = capacity_;
+    read_idx.store(0);
+    write_idx.store(n);
+  }
+
+  /// Number of queued SDUs. Thread-safe
+  uint32_t size() const { return snapshot(nof_pushed, nof_popped); }
+  uint32_t get_n_sdus() const { return size(); }
+
+  /// Number of queued bytes. Thread-safe
+  uint32_t size_bytes() const { return snapshot(pushed_bytes, popped_bytes); }
+
+  bool is_empty() const { return size() == 0; }
+
+  /// Whether a write would fail or block. Slots of discarded SDUs are only reused once the consumer passes them
+  bool is_full() const
+  {
+    return write_idx.load(std::memory_order_acquire) - read_idx.load(std::memory_order_acquire) >= capacity;
+  }
+
+  /// Time the SDU at the head of the queue has been waiting, or zero if empty. Thread-safe
+  std::chrono::microseconds get_hol_delay() const
+  {
+    uint64_t r = read_idx.load(std::memory_order_acquire);
+    if (r == write_idx.load(std::memory_order_acquire)) {
+      return std::chrono::microseconds{0};
+    }
+    // If the consumer pops the head meanwhile, the slot may already hold a newer SDU, with a shorter delay
+    int64_t             ts = slots[r & mask].enqueue_time.load(std::memory_order_relaxed);
+    sdu_clock::duration d  = sdu_clock::now().time_since_epoch() - sdu_clock::duration(ts);
+    return std::max(std::chrono::duration_cast<std::chrono::microseconds>(d), std::chrono::microseconds{0});
+  }
+
+private:
+  struct slot_t {
+    unique_byte_buffer_t sdu;
+    std::atomic<int64_t> enqueue_time{0}; ///< in sdu_clock ticks
+  };
+
+  // Difference of a producer and a consumer counter at the time the consumer counter was read. The producer counter is
+  // read again until it has not changed meanwhile, so that the result is always a size the queue actually had
+  static uint64_t snapshot(const std::atomic<uint64_t>& pushed, const std::atomic<uint64_t>& popped)
+  {
+    uint64_t p = pushed.load(std::memory_order_acquire);
+    while (true) {
+      uint64_t c    = popped.load(std::memory_order_acquire);
+      uint64_t last = p;
+      p             = pushed.load(std::memory_order_acquire);
+      if (p == last) {
+        return p - c;
+      }
+    }
+  }
+
+  bool try_push(unique_byte_buffer_t& msg)
+  {
+    uint64_t w = write_idx.load(std::memory_order_relaxed);
+    if (w - read_idx.load(std::memory_order_acquire) >= capacity) {
+      return false;
+    }
+    uint32_t len = msg->N_bytes;
+    slot_t&  s   = slots[w & mask];
+    s.sdu        = std::move(msg);
+    s.enqueue_time.store(sdu_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    // the counts are published before the index, so that the SDU is never visible to the consumer before being counted
+    nof_pushed.store(nof_pushed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    pushed_bytes.store(pushed_bytes.load(std::memory_order_relaxed) + len, std::memory_order_release);
+    write_idx.store(w + 1);
+    notify_consumer();
+    return true;
+  }
+
+  // The waiting flags and the indexes are sequentially consistent, so that either the waiting side sees the update of
+  // the index, or the updating side sees the flag and wakes it up
+  void notify_producer()
+  {
+    if (producer_waiting.load()) {
+      std::lock_guard<std::mutex> lock(wait_mutex);
+      wait_cvar.notify_all();
+    }
+  }
+  void notify_consumer()
+  {
+    if (consumer_waiting.load()) {
+      std::lock_guard<std::mutex> lock(wait_mutex);
+      wait_cvar.notify_all();
+    }
+  }
+
+  std::unique_ptr<slot_t[]> slots;
+  size_t                    mask     = 0;
+  uint32_t                  capacity = 0;
+
+  // Producer side
+  alignas(cache_line_size) std::atomic<uint64_t> write_idx{0};
+  std::atomic<uint64_t> nof_pushed{0};
+  std::atomic<uint64_t> pushed_bytes{0};
+
+  // Consumer side
+  alignas(cache_line_size) std::atomic<uint64_t> read_idx{0};
+  std::atomic<uint64_t> nof_popped{0};
+  std::atomic<uint64_t> popped_bytes{0};
+
+  // Only used by the blocking write() and read()
+  alignas(cache_line_size) std::atomic<bool> producer_waiting{false};
+  std::atomic<bool>       consumer_waiting{false};
+  std::mutex              wait_mutex;
+  std::condition_variable wait_cvar;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_BYTE_BUFFER_SPSC_QUEUE_H
@@ -83,6 +83,42 @@ struct gtpu_header_t {
   std::vector<uint8_t> ext_buffer;
 };
 
+/// Header of the G-PDUs sent through a tunnel, which is built once when the tunnel is created. Per packet, the header
+/// is copied in front of the PDU and only the length and, if present, the PDCP PDU Number extension header are written
+class gtpu_tx_header_template
+{
+public:
+  /// Size of the header with the PDCP PDU Number extension header
+  static const uint32_t max_header_len = GTPU_EXTENDED_HEADER_LEN + 4;
+
+  void init(uint32_t teid_out);
+
+  /// Adds the G-PDU header to the PDU, with the PDCP PDU Number extension header if pdcp_sn >= 0. Returns false if
+  /// there is no headroom for it
+  bool write(srsran::byte_buffer_t* pdu, int pdcp_sn = -1) const
+  {
+    uint32_t hdr_len = pdcp_sn >= 0 ? max_header_len : GTPU_BASE_HEADER_LEN;
+    if (pdu->get_headroom() < hdr_len) {
+      return false;
+    }
+    uint16_t length = pdu->N_bytes + hdr_len - GTPU_BASE_HEADER_LEN;
+    pdu->msg -= hdr_len;
+    pdu->N_bytes += hdr_len;
+    memcpy(pdu->msg, hdr, hdr_len);
+    pdu->msg[2] = (length >> 8u) & 0xffu;
+    pdu->msg[3] = length & 0xffu;
+    if (pdcp_sn >= 0) {
+      pdu->msg[0] |= GTPU_FLAGS_EXTENDED_HDR;
+      pdu->msg[GTPU_EXTENDED_HEADER_LEN + 1] = (pdcp_sn >> 8u) & 0xffu;
+      pdu->msg[GTPU_EXTENDED_HEADER_LEN + 2] = pdcp_sn & 0xffu;
+    }
+    return true;
+  }
+
+private:
+  uint8_t hdr[max_header_len] = {};
+};
+
 bool gtpu_read_header(srsran::byte_buffer_t* pdu, gtpu_header_t* header, srslog::basic_logger& logger);
 bool gtpu_write_header(gtpu_header_t* header, srsran::byte_buffer_t* pdu, srslog::basic_logger& logger);
 void gtpu_ntoa(fmt::memory_buffer& buffer, uint32_t addr);
@@ -40,6 +40,7 @@ public:
 
   // Stack interface
   bool is_lcid_enabled(uint32_t lcid);
+  void set_tx_batch(pdcp_tx_batch* tx_batch_);
 
   // RRC interface
   void reestablish() override;
@@ -84,6 +85,7 @@ private:
   srsue::gw_interface_pdcp*  gw     = nullptr;
   srsran::task_sched_handle  task_sched;
   srslog::basic_logger&      logger;
+  pdcp_tx_batch*             tx_batch = nullptr;
 
   using pdcp_map_t = std::map<uint16_t, std::unique_ptr<pdcp_entity_base> >;
   pdcp_map_t pdcp_array, pdcp_array_mrb;
@@ -33,6 +33,8 @@
 #include "srsran/interfaces/pdcp_interface_types.h"
 #include "srsran/upper/byte_buffer_queue.h"
 #include "srsran/upper/pdcp_metrics.h"
+#include "srsran/upper/pdcp_rohc.h"
+#include "srsran/upper/pdcp_tx_batch.h"
 
 namespace srsran {
 
@@ -74,9 +76,17 @@ public:
   bool is_srb() { return cfg.rb_type == PDCP_RB_IS_SRB; }
   bool is_drb() { return cfg.rb_type == PDCP_RB_IS_DRB; }
 
+  // TX batch stage, shared with other entities. If not set, the PDUs are protected and passed to RLC in write_sdu()
+  void set_tx_batch(pdcp_tx_batch* tx_batch_)
+  {
+    flush_tx_batch();
+    tx_batch = tx_batch_;
+  }
+
   // RRC interface
   void enable_integrity(srsran_direction_t direction = DIRECTION_TXRX)
   {
+    flush_tx_batch();
     // if either DL or UL is already enabled, both are enabled
     if (integrity_direction == DIRECTION_TX && direction == DIRECTION_RX) {
       integrity_direction = DIRECTION_TXRX;
@@ -90,6 +100,7 @@ public:
 
   void enable_encryption(srsran_direction_t direction = DIRECTION_TXRX)
   {
+    flush_tx_batch();
     // if either DL or UL is already enabled, both are enabled
     if (encryption_direction == DIRECTION_TX && direction == DIRECTION_RX) {
       encryption_direction = DIRECTION_TXRX;
@@ -145,6 +156,8 @@ public:
   const char* get_rb_name() const { return rb_name.c_str(); }
 
 protected:
+  friend class pdcp_tx_batch;
+
   srslog::basic_logger&     logger;
   srsran::task_sched_handle task_sched;
 
@@ -168,6 +181,26 @@ protected:
   std::string   rb_name;
 
   srsran::as_security_config_t sec_cfg = {};
+  // 128-EEA2/128-EIA2 keys of the bearer, precomputed in config_security()
+  srsran::security_aes128_key aes_k_enc;
+  srsran::security_aes128_key aes_k_int;
+
+  // TX batch stage. The pending PDUs are flushed before changes to the security context they refer to
+  pdcp_tx_batch*      tx_batch = nullptr;
+  void                flush_tx_batch();
+  pdcp_tx_batch_pdu_t make_tx_batch_pdu(unique_byte_buffer_t pdu,
+                                        uint32_t             count,
+                                        bool                 do_integrity,
+                                        bool                 do_append_mac,
+                                        bool                 do_encryption);
+  // Passes a protected PDU to RLC
+  virtual void write_tx_pdu(unique_byte_buffer_t pdu) = 0;
+
+  // Header compression of the DRBs. Each direction is only set up if ROHC is configured for it
+  std::unique_ptr<rohc_compressor>   rohc_comp;
+  std::unique_ptr<rohc_decompressor> rohc_decomp;
+  void                               configure_rohc();
+  void                               reset_rohc();
 
   // Security functions
   void integrity_generate(uint8_t* msg, uint32_t msg_len, uint32_t count, uint8_t* mac);
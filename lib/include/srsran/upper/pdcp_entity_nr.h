@@ -102,6 +102,8 @@ private:
   std::map<uint32_t, unique_byte_buffer_t> reorder_queue;
   timer_handler::unique_timer              reordering_timer;
 
+  void write_tx_pdu(unique_byte_buffer_t pdu) final;
+
   // Pass to Upper Layers Helper function
   void deliver_all_consecutive_counts();
   void pass_to_upper_layers(unique_byte_buffer_t pdu);
@@ -161,7 +163,7 @@ inline void pdcp_entity_nr::pass_to_upper_layers(unique_byte_buffer_t sdu)
 {
   if (is_srb()) {
     rrc->write_pdu(lcid, std::move(sdu));
-  } else {
+  } else if (rohc_decomp == nullptr or rohc_decomp->decompress(sdu.get())) {
     gw->write_pdu(lcid, std::move(sdu));
   }
 }
@@ -45,6 +45,26 @@ typedef struct {
   pdcp_bearer_metrics_t bearer[SRSRAN_N_RADIO_BEARERS];
 } pdcp_metrics_t;
 
+typedef struct {
+  uint64_t nof_batches;
+  uint64_t nof_pdus;
+  uint32_t max_batch_size;
+  uint32_t nof_forced_flushes; //< Batches flushed before the TTI boundary, due to the size or delay limits
+  double   avg_delay_us;       //< Average time the PDUs waited in the batch stage, including the processing
+  uint32_t max_delay_us;
+} pdcp_tx_batch_metrics_t;
+
+typedef struct {
+  uint64_t nof_packets;
+  uint64_t nof_ir;           //< IR packets, carrying the static and dynamic fields
+  uint64_t nof_ir_dyn;       //< IR-DYN packets, carrying the dynamic fields
+  uint64_t nof_uncompressed; //< Normal packets of the uncompressed profile
+  uint64_t nof_dropped;      //< Packets that could not be (de)compressed
+  uint64_t nof_repairs;      //< Contexts repaired after a CRC failure, assuming an SN wraparound (decompressor only)
+  uint64_t orig_hdr_bytes;   //< Bytes of the uncompressed headers
+  uint64_t rohc_hdr_bytes;   //< Bytes of the ROHC headers that replaced them
+} pdcp_rohc_metrics_t;
+
 } // namespace srsran
 
 #endif // SRSRAN_RLC_METRICS_H
@@ -0,0 +1,132 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_PDCP_ROHC_H
+#define SRSRAN_PDCP_ROHC_H
+
+#include "srsran/adt/pool/obj_pool.h"
+#include "srsran/common/byte_buffer.h"
+#include "srsran/interfaces/pdcp_interface_types.h"
+#include "srsran/srslog/srslog.h"
+#include "srsran/upper/pdcp_metrics.h"
+#include <array>
+
+namespace srsran {
+
+/****************************************************************************
+ * Robust Header Compression (ROHC) of the PDCP DRBs
+ * Ref: RFC 3095 (framework, profiles 0x0001 and 0x0002)
+ *
+ * Both sides operate in Unidirectional mode, so no feedback is exchanged:
+ * - a new context is established with IR packets, and a change of the fields
+ *   that are not sent in the compressed packets with IR-DYN packets. Both are
+ *   repeated rohc_nof_context_updates times (optimistic approach), and an IR
+ *   refreshes the context every rohc_ir_refresh packets
+ * - SN and TS are W-LSB encoded against the last
+ *   rohc_nof_context_updates packets, so that the decompressor can decode them
+ *   after losing fewer packets than the interpretation interval
+ * - after a CRC failure, the decompressor only accepts packets with a 7 or
+ *   8-bit CRC until the context is repaired
+ * - IPv4 only, without options or fragments, and small CIDs (up to 15). Other
+ *   packets, including TCP, are sent with the uncompressed profile. The
+ *   ROHC-TCP profile 0x0006 (RFC 6846) is not implemented yet
+ * Profiles 0x0001 and 0x0002 use the RFC 3095 IR, IR-DYN, UO-0, UO-1 and UOR-2
+ * (without extensions) packets.
+ ***************************************************************************/
+
+const uint32_t rohc_max_small_cid       = 15;
+const uint32_t rohc_nof_context_updates = 3;
+const uint32_t rohc_ir_refresh          = 512;
+
+struct rohc_hdr_t;
+
+/// Compressor of the packets sent on a bearer. The contexts of the flows are taken from a pool of the compressor, and
+/// the least recently used one is replaced when all CIDs are taken
+class rohc_compressor
+{
+public:
+  rohc_compressor(const pdcp_rohc_config_t& cfg_, srslog::basic_logger& logger_);
+  ~rohc_compressor();
+  rohc_compressor(const rohc_compressor&) = delete;
+  rohc_compressor& operator=(const rohc_compressor&) = delete;
+
+  /// Replaces the IP headers of the SDU with the ROHC header. Returns false if the buffer has no room for it
+  bool compress(byte_buffer_t* sdu);
+
+  /// Drops all contexts, e.g. at PDCP reestablishment
+  void reset();
+
+  pdcp_rohc_metrics_t get_metrics() const { return metrics; }
+
+  struct context_t;
+
+private:
+  context_t* get_context(const rohc_hdr_t& hdr);
+
+  pdcp_rohc_config_t    cfg;
+  srslog::basic_logger& logger;
+
+  // The pool must outlive the contexts taken from it
+  growing_batch_obj_pool<context_t>                              pool;
+  std::array<unique_pool_ptr<context_t>, rohc_max_small_cid + 1> contexts;
+  uint32_t                                                       max_cid  = 0;
+  uint64_t                                                       nof_pkts = 0;
+
+  pdcp_rohc_metrics_t metrics = {};
+};
+
+/// Decompressor of the packets received on a bearer. The contexts are taken from a pool of the decompressor when the
+/// IR packet of a new CID is received
+class rohc_decompressor
+{
+public:
+  rohc_decompressor(const pdcp_rohc_config_t& cfg_, srslog::basic_logger& logger_);
+  ~rohc_decompressor();
+  rohc_decompressor(const rohc_decompressor&) = delete;
+  rohc_decompressor& operator=(const rohc_decompressor&) = delete;
+
+  /// Replaces the ROHC header of the PDU with the IP headers. Returns false if the packet has to be dropped
+  bool decompress(byte_buffer_t* pdu);
+
+  /// Drops all contexts, e.g. at PDCP reestablishment
+  void reset();
+
+  pdcp_rohc_metrics_t get_metrics() const { return metrics; }
+
+  struct context_t;
+
+private:
+  bool handle_ir(byte_buffer_t* pdu, uint32_t cid, uint32_t offset, bool is_ir_dyn);
+  bool handle_compressed(byte_buffer_t* pdu, context_t& ctx, uint32_t offset);
+
+  pdcp_rohc_config_t    cfg;
+  srslog::basic_logger& logger;
+
+  growing_batch_obj_pool<context_t>                              pool;
+  std::array<unique_pool_ptr<context_t>, rohc_max_small_cid + 1> contexts;
+  uint32_t                                                       max_cid = 0;
+
+  pdcp_rohc_metrics_t metrics = {};
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_PDCP_ROHC_H
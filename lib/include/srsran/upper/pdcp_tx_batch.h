@@ -0,0 +1,120 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_PDCP_TX_BATCH_H
+#define SRSRAN_PDCP_TX_BATCH_H
+
+#include "srsran/common/buffer_pool.h"
+#include "srsran/common/security.h"
+#include "srsran/common/thread_pool.h"
+#include "srsran/interfaces/pdcp_interface_types.h"
+#include "srsran/srslog/srslog.h"
+#include "srsran/upper/pdcp_metrics.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace srsran {
+
+class pdcp_entity_base;
+
+/// PDCP Data PDU waiting in the TX batch stage for integrity protection and ciphering. The key pointers refer to the
+/// security context of the entity, which flushes the stage before changing it
+struct pdcp_tx_batch_pdu_t {
+  pdcp_entity_base*    entity = nullptr;
+  unique_byte_buffer_t pdu; ///< PDCP header and SDU
+  uint32_t             count     = 0;
+  uint8_t              bearer    = 0; ///< BEARER input of the EEA/EIA algorithms, i.e. bearer ID - 1
+  uint8_t              direction = 0;
+  uint32_t             hdr_len   = 0;
+
+  /// The MAC-I is appended, even if zero because the PDU is not integrity protected (LTE SRBs)
+  bool                        append_mac  = false;
+  INTEGRITY_ALGORITHM_ID_ENUM integ_algo  = INTEGRITY_ALGORITHM_ID_EIA0;
+  CIPHERING_ALGORITHM_ID_ENUM cipher_algo = CIPHERING_ALGORITHM_ID_EEA0;
+  const uint8_t*              k_int       = nullptr;
+  const uint8_t*              k_enc       = nullptr;
+  const security_aes128_key*  aes_k_int   = nullptr;
+  const security_aes128_key*  aes_k_enc   = nullptr;
+
+  std::chrono::steady_clock::time_point enqueue_time;
+};
+
+/**
+ * TX pipeline stage shared by the PDCP entities of all bearers (and UEs). The entities assign the COUNT, write the
+ * header and push the PDUs, which are integrity protected and ciphered together when the stage is flushed, using the
+ * batch EEA/EIA functions, and then passed back to their entities to be forwarded to RLC in the order they were
+ * pushed. The owner flushes the stage at every TTI, and a flush is forced when the number of pending PDUs or the wait
+ * of the oldest one reaches the configured limits. With worker threads, the batch is split in chunks processed in
+ * parallel, and the flush waits for all of them before forwarding the PDUs.
+ * All methods must be called from the thread that owns the PDCP entities.
+ */
+class pdcp_tx_batch
+{
+public:
+  explicit pdcp_tx_batch(const pdcp_tx_batch_args_t& args_);
+  ~pdcp_tx_batch();
+  pdcp_tx_batch(const pdcp_tx_batch&) = delete;
+  pdcp_tx_batch& operator=(const pdcp_tx_batch&) = delete;
+
+  void push(pdcp_tx_batch_pdu_t pdu);
+
+  /// Protects and forwards all pending PDUs
+  void flush() { flush_impl(false); }
+
+  /// Drops the pending PDUs of an entity that is being removed
+  void remove_entity(const pdcp_entity_base* entity);
+
+  uint32_t nof_pending_pdus() const { return pending.size(); }
+
+  /// Metrics since the last call
+  pdcp_tx_batch_metrics_t get_metrics();
+
+private:
+  /// Batch descriptors of a chunk, reused across flushes to avoid allocations
+  struct chunk_scratch_t {
+    std::vector<security_batch_pdu_t> eia1, eia3, eea1, eea3;
+    std::vector<uint8_t>              macs;
+  };
+
+  void flush_impl(bool forced);
+  void process_chunk(pdcp_tx_batch_pdu_t* pdus, uint32_t nof_pdus, chunk_scratch_t& scratch);
+
+  pdcp_tx_batch_args_t  args;
+  srslog::basic_logger& logger;
+
+  std::vector<pdcp_tx_batch_pdu_t> pending, processing;
+  std::vector<chunk_scratch_t>     scratch;
+
+  // Crypto workers
+  std::unique_ptr<task_thread_pool> workers;
+  std::mutex                        chunks_mutex;
+  std::condition_variable           chunks_cvar;
+  uint32_t                          nof_pending_chunks = 0;
+
+  pdcp_tx_batch_metrics_t metrics      = {};
+  uint64_t                sum_delay_us = 0;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_PDCP_TX_BATCH_H
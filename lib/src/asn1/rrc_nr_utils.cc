@@ -393,6 +393,21 @@ srsran::pdcp_config_t make_drb_pdcp_config_t(const uint8_t bearer_id, bool is_ue
                     discard_timer,
                     false,
                     srsran_rat_t::nr);
+
+  // Header compression. Profiles 0x0003/0x0004 (ESP, IP), 0x0006 (TCP/IP) and the v2 profiles are not supported, the
+  // packets they would cover are sent with the uncompressed profile. ROHC is left disabled if none of the configured
+  // profiles is supported, which is always the case of ul-OnlyROHC (profile 0x0006 only)
+  if (pdcp_cfg.drb_present) {
+    const pdcp_cfg_s::drb_s_::hdr_compress_c_& hdr_compress = pdcp_cfg.drb.hdr_compress;
+    if (hdr_compress.type().value == pdcp_cfg_s::drb_s_::hdr_compress_c_::types_opts::rohc) {
+      cfg.rohc.profile_rtp = hdr_compress.rohc().profiles.profile0x0001;
+      cfg.rohc.profile_udp = hdr_compress.rohc().profiles.profile0x0002;
+      cfg.rohc.enabled     = cfg.rohc.profile_rtp or cfg.rohc.profile_udp;
+      if (cfg.rohc.enabled) {
+        cfg.rohc.max_cid = hdr_compress.rohc().max_cid_present ? hdr_compress.rohc().max_cid : 15;
+      }
+    }
+  }
   return cfg;
 }
 
@@ -342,6 +342,19 @@ srsran::pdcp_config_t make_drb_pdcp_config_t(const uint8_t bearer_id, bool is_ue
                     discard_timer,
                     status_report_required,
                     srsran_rat_t::lte);
+
+  // Header compression. Profiles 0x0003/0x0004 (ESP, IP), 0x0006 (TCP/IP) and the v2 profiles are not supported, the
+  // packets they would cover are sent with the uncompressed profile. ROHC is left disabled if none of the configured
+  // profiles is supported
+  if (pdcp_cfg.hdr_compress.type().value == pdcp_cfg_s::hdr_compress_c_::types_opts::rohc) {
+    const pdcp_cfg_s::hdr_compress_c_::rohc_s_& rohc = pdcp_cfg.hdr_compress.rohc();
+    cfg.rohc.profile_rtp                             = rohc.profiles.profile0x0001;
+    cfg.rohc.profile_udp                             = rohc.profiles.profile0x0002;
+    cfg.rohc.enabled                                 = cfg.rohc.profile_rtp or cfg.rohc.profile_udp;
+    if (cfg.rohc.enabled) {
+      cfg.rohc.max_cid = rohc.max_cid_present ? rohc.max_cid : 15;
+    }
+  }
   return cfg;
 }
 
@@ -0,0 +1,161 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/datagram_socket.h"
+#include "srsran/common/network_utils.h"
+#include <array>
+#include <sys/socket.h>
+
+namespace srsran {
+
+const char* to_string(datagram_socket_type type)
+{
+  switch (type) {
+    case datagram_socket_type::udp:
+      return "udp";
+    case datagram_socket_type::af_xdp:
+      return "af_xdp";
+  }
+  return "invalid";
+}
+
+bool string_to_datagram_socket_type(const std::string& str, datagram_socket_type* type)
+{
+  if (str == "udp") {
+    *type = datagram_socket_type::udp;
+  } else if (str == "af_xdp") {
+    *type = datagram_socket_type::af_xdp;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+namespace {
+
+/// Kernel UDP socket, which reads several datagrams per system call
+class udp_datagram_socket final : public datagram_socket
+{
+public:
+  explicit udp_datagram_socket(srslog::basic_logger& logger_) : logger(logger_) {}
+
+  bool open(const datagram_socket_args_t& args)
+  {
+    if (not socket.open_socket(net_utils::addr_family::ipv4,
+                               net_utils::socket_type::datagram,
+                               net_utils::protocol_type::UDP)) {
+      return false;
+    }
+    int enable = 1;
+#if defined(SO_REUSEADDR)
+    if (setsockopt(socket.fd(), SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(int)) < 0) {
+      logger.error("setsockopt(SO_REUSEADDR) failed");
+    }
+#endif
+#if defined(SO_REUSEPORT)
+    if (setsockopt(socket.fd(), SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(int)) < 0) {
+      logger.error("setsockopt(SO_REUSEPORT) failed");
+    }
+#endif
+    return socket.bind_addr(args.bind_addr.c_str(), args.bind_port);
+  }
+
+  datagram_socket_type get_type() const override { return datagram_socket_type::udp; }
+  int                  get_fd() const override { return socket.fd(); }
+  const sockaddr_in&   get_addr_in() const override { return socket.get_addr_in(); }
+
+  int recv(span<unique_byte_buffer_t> pdus, span<sockaddr_in> from) override
+  {
+    std::array<mmsghdr, MAX_SDU_BATCH_SIZE> msgs;
+    std::array<iovec, MAX_SDU_BATCH_SIZE>   iovs;
+    uint32_t                                nof_bufs = std::min(pdus.size(), (size_t)MAX_SDU_BATCH_SIZE);
+    for (uint32_t i = 0; i < nof_bufs; ++i) {
+      iovs[i].iov_base             = pdus[i]->msg;
+      iovs[i].iov_len              = pdus[i]->get_tailroom();
+      msgs[i]                      = {};
+      msgs[i].msg_hdr.msg_name    = &from[i];
+      msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+      msgs[i].msg_hdr.msg_iov     = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen  = 1;
+    }
+
+    int n_recv = recvmmsg(socket.fd(), msgs.data(), nof_bufs, MSG_DONTWAIT, nullptr);
+    if (n_recv == -1) {
+      if (errno == EAGAIN or errno == EWOULDBLOCK) {
+        logger.debug("Socket timeout reached");
+        return 0;
+      }
+      logger.error("Error reading from socket: %s", strerror(errno));
+      return SRSRAN_ERROR;
+    }
+    for (int i = 0; i < n_recv; ++i) {
+      pdus[i]->N_bytes = msgs[i].msg_len;
+    }
+    return n_recv;
+  }
+
+  bool send(const byte_buffer_t& pdu, const sockaddr_in& dest) override
+  {
+    if (sendto(socket.fd(), pdu.msg, pdu.N_bytes, MSG_EOR, (const sockaddr*)&dest, sizeof(sockaddr_in)) < 0) {
+      logger.error("Error sending datagram to %s: %s", net_utils::get_ip(dest).c_str(), strerror(errno));
+      return false;
+    }
+    return true;
+  }
+
+private:
+  srslog::basic_logger& logger;
+  unique_socket         socket;
+};
+
+} // namespace
+
+std::unique_ptr<datagram_socket> make_udp_datagram_socket(const datagram_socket_args_t& args,
+                                                          srslog::basic_logger&         logger)
+{
+  std::unique_ptr<udp_datagram_socket> socket(new udp_datagram_socket(logger));
+  if (not socket->open(args)) {
+    logger.error("Failed to open UDP socket on %s:%d", args.bind_addr.c_str(), args.bind_port);
+    return nullptr;
+  }
+  return std::move(socket);
+}
+
+std::unique_ptr<datagram_socket> make_datagram_socket(const datagram_socket_args_t& args,
+                                                      srslog::basic_logger&         logger)
+{
+  if (args.type == datagram_socket_type::af_xdp) {
+    std::unique_ptr<datagram_socket> socket = make_af_xdp_datagram_socket(args, logger);
+    if (socket != nullptr) {
+      logger.info("Opened AF_XDP socket on %s:%d, interface %s, queue %d",
+                  args.bind_addr.c_str(),
+                  args.bind_port,
+                  args.xdp_if_name.c_str(),
+                  args.xdp_queue_id);
+      return socket;
+    }
+    logger.warning("Failed to open AF_XDP socket on interface %s. Falling back to UDP socket",
+                   args.xdp_if_name.c_str());
+  }
+  return make_udp_datagram_socket(args, logger);
+}
+
+} // namespace srsran
@@ -0,0 +1,649 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * AF_XDP backend of the user plane datagram sockets. An XDP program attached to the interface redirects the IPv4/UDP
+ * packets addressed to the bound address and port, and received through the configured Rx queue, to an AF_XDP socket.
+ * Their frames are written by the kernel (or by the NIC, with zero-copy drivers) to a UMEM shared with the application,
+ * bypassing the IP/UDP stack. Transmitted datagrams are written to UMEM frames with their Ethernet/IPv4/UDP headers.
+ *
+ * The XDP program and the sockets are set up with the kernel UAPI only, without libbpf/libxdp. The kernel UDP socket
+ * remains bound, to receive the datagrams that the program lets through (e.g. IPv4 packets with options or received
+ * through other queues), and to send the datagrams whose next hop MAC address is not known yet. The MAC addresses are
+ * learned from the source of the received frames, i.e. the peers are assumed to be reached through the same next hop
+ * they are received from.
+ *
+ * Traffic received through other queues than the configured one is not redirected. With multi-queue NICs, the user
+ * plane traffic has to be steered to that queue, e.g. with "ethtool -N <if> flow-type udp4 dst-port 2152 action 0", or
+ * the NIC configured with a single queue with "ethtool -L <if> combined 1".
+ */
+
+#include "srsran/common/datagram_socket.h"
+
+#ifdef HAVE_AF_XDP
+
+#include "srsran/common/network_utils.h"
+#include <array>
+#include <linux/bpf.h>
+#include <linux/if_ether.h>
+#include <linux/if_link.h>
+#include <linux/if_xdp.h>
+#include <mutex>
+#include <net/if.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+namespace srsran {
+
+namespace {
+
+const uint32_t xdp_frame_size  = 2048;
+const uint32_t eth_ip_udp_len  = ETH_HLEN + sizeof(iphdr) + sizeof(udphdr);
+const uint32_t max_neighbours  = 16;
+const uint32_t min_nof_frames  = 64;
+const int32_t  xdp_action_pass = XDP_PASS;
+
+long sys_bpf(int cmd, bpf_attr* attr)
+{
+  return syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+bpf_insn make_insn(uint8_t code, uint8_t dst, uint8_t src, int16_t off, int32_t imm)
+{
+  bpf_insn insn = {};
+  insn.code     = code;
+  insn.dst_reg  = dst;
+  insn.src_reg  = src;
+  insn.off      = off;
+  insn.imm      = imm;
+  return insn;
+}
+
+/// XDP program that redirects the IPv4/UDP packets without options nor fragmentation, to the bound address and port,
+/// to the AF_XDP socket of the Rx queue in the XSKMAP. Other packets, and those of queues without socket, are passed to
+/// the kernel stack
+std::vector<bpf_insn> make_xdp_program(int xsk_map_fd, const sockaddr_in& addr)
+{
+  std::vector<bpf_insn> prog;
+  std::vector<size_t>   jumps_to_pass;
+
+  // Loads a field of the frame to r5, and jumps to "pass" if (r5 & mask) != value
+  auto check_field = [&prog, &jumps_to_pass](uint8_t size, int16_t offset, int32_t value, int32_t mask) {
+    prog.push_back(make_insn(BPF_LDX | BPF_MEM | size, BPF_REG_5, BPF_REG_2, offset, 0));
+    if (mask != -1) {
+      prog.push_back(make_insn(BPF_ALU | BPF_AND | BPF_K, BPF_REG_5, 0, 0, mask));
+    }
+    jumps_to_pass.push_back(prog.size());
+    prog.push_back(make_insn(BPF_JMP32 | BPF_JNE | BPF_K, BPF_REG_5, 0, 0, value));
+  };
+  const int16_t ip_offset  = ETH_HLEN;
+  const int16_t udp_offset = ETH_HLEN + sizeof(iphdr);
+
+  // r6 = ctx, r2 = data, r3 = data_end
+  prog.push_back(make_insn(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0));
+  prog.push_back(make_insn(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_6, offsetof(xdp_md, data), 0));
+  prog.push_back(make_insn(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_3, BPF_REG_6, offsetof(xdp_md, data_end), 0));
+  // if (data + eth_ip_udp_len > data_end) goto pass
+  prog.push_back(make_insn(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4, BPF_REG_2, 0, 0));
+  prog.push_back(make_insn(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4, 0, 0, eth_ip_udp_len));
+  jumps_to_pass.push_back(prog.size());
+  prog.push_back(make_insn(BPF_JMP | BPF_JGT | BPF_X, BPF_REG_4, BPF_REG_3, 0, 0));
+
+  // The fields are compared in network byte order
+  check_field(BPF_H, offsetof(ethhdr, h_proto), htons(ETH_P_IP), -1);
+  check_field(BPF_B, ip_offset, 0x45, -1);
+  check_field(BPF_B, ip_offset + offsetof(iphdr, protocol), IPPROTO_UDP, -1);
+  check_field(BPF_H, ip_offset + offsetof(iphdr, frag_off), 0, htons(IP_MF | IP_OFFMASK));
+  if (addr.sin_addr.s_addr != INADDR_ANY) {
+    check_field(BPF_W, ip_offset + offsetof(iphdr, daddr), addr.sin_addr.s_addr, -1);
+  }
+  check_field(BPF_H, udp_offset + offsetof(udphdr, dest), addr.sin_port, -1);
+
+  // return bpf_redirect_map(&xsk_map, ctx->rx_queue_index, XDP_PASS)
+  prog.push_back(make_insn(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_6, offsetof(xdp_md, rx_queue_index), 0));
+  prog.push_back(make_insn(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, xsk_map_fd));
+  prog.push_back(make_insn(0, 0, 0, 0, 0));
+  prog.push_back(make_insn(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_3, 0, 0, xdp_action_pass));
+  prog.push_back(make_insn(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map));
+  prog.push_back(make_insn(BPF_JMP | BPF_EXIT, 0, 0, 0, 0));
+
+  // pass: return XDP_PASS
+  for (size_t idx : jumps_to_pass) {
+    prog[idx].off = prog.size() - idx - 1;
+  }
+  prog.push_back(make_insn(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, xdp_action_pass));
+  prog.push_back(make_insn(BPF_JMP | BPF_EXIT, 0, 0, 0, 0));
+  return prog;
+}
+
+uint16_t ipv4_checksum(const iphdr& hdr)
+{
+  const uint16_t* words = reinterpret_cast<const uint16_t*>(&hdr);
+  uint32_t        sum   = 0;
+  for (uint32_t i = 0; i < sizeof(iphdr) / 2; ++i) {
+    sum += words[i];
+  }
+  while (sum >> 16U) {
+    sum = (sum & 0xffffU) + (sum >> 16U);
+  }
+  return ~sum;
+}
+
+/// Single producer/consumer ring shared with the kernel. The side of the application caches the index it owns
+template <typename T>
+struct xdp_ring {
+  uint32_t* producer = nullptr;
+  uint32_t* consumer = nullptr;
+  uint32_t* flags    = nullptr;
+  T*        descs    = nullptr;
+  uint32_t  mask     = 0;
+  void*     map      = MAP_FAILED;
+  size_t    map_len  = 0;
+
+  bool init(int fd, const xdp_ring_offset& off, uint32_t size, off_t pgoff)
+  {
+    map_len = off.desc + size * sizeof(T);
+    map     = mmap(nullptr, map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, pgoff);
+    if (map == MAP_FAILED) {
+      return false;
+    }
+    producer = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(map) + off.producer);
+    consumer = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(map) + off.consumer);
+    flags    = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(map) + off.flags);
+    descs    = reinterpret_cast<T*>(static_cast<uint8_t*>(map) + off.desc);
+    mask     = size - 1;
+    return true;
+  }
+  ~xdp_ring()
+  {
+    if (map != MAP_FAILED) {
+      munmap(map, map_len);
+    }
+  }
+
+  uint32_t load_producer() const { return __atomic_load_n(producer, __ATOMIC_ACQUIRE); }
+  uint32_t load_consumer() const { return __atomic_load_n(consumer, __ATOMIC_ACQUIRE); }
+  void     store_producer(uint32_t idx) { __atomic_store_n(producer, idx, __ATOMIC_RELEASE); }
+  void     store_consumer(uint32_t idx) { __atomic_store_n(consumer, idx, __ATOMIC_RELEASE); }
+  bool     needs_wakeup() const { return (__atomic_load_n(flags, __ATOMIC_RELAXED) & XDP_RING_NEED_WAKEUP) != 0; }
+  T&       operator[](uint32_t idx) { return descs[idx & mask]; }
+};
+
+class af_xdp_datagram_socket final : public datagram_socket
+{
+  using mac_addr_t = std::array<uint8_t, ETH_ALEN>;
+
+public:
+  explicit af_xdp_datagram_socket(srslog::basic_logger& logger_) : logger(logger_) {}
+  ~af_xdp_datagram_socket() override
+  {
+    for (int fd : {epoll_fd, link_fd, prog_fd, xsk_fd, xsk_map_fd}) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+    if (umem != MAP_FAILED) {
+      munmap(umem, umem_len);
+    }
+  }
+
+  bool open(const datagram_socket_args_t& args);
+
+  datagram_socket_type get_type() const override { return datagram_socket_type::af_xdp; }
+  int                  get_fd() const override { return epoll_fd; }
+  const sockaddr_in&   get_addr_in() const override { return udp_socket->get_addr_in(); }
+
+  int  recv(span<unique_byte_buffer_t> pdus, span<sockaddr_in> from) override;
+  bool send(const byte_buffer_t& pdu, const sockaddr_in& dest) override;
+
+private:
+  bool setup_umem(uint32_t nof_frames);
+  bool setup_xdp_program(const datagram_socket_args_t& args, int ifindex);
+  bool read_if_addresses(const datagram_socket_args_t& args);
+  bool parse_frame(const uint8_t* frame, uint32_t len, byte_buffer_t* pdu, sockaddr_in* from);
+  bool find_neighbour(in_addr_t addr, mac_addr_t* mac);
+  bool alloc_tx_frame(uint64_t* addr);
+  void kick_tx();
+
+  srslog::basic_logger&            logger;
+  std::unique_ptr<datagram_socket> udp_socket;
+
+  int    xsk_fd     = -1;
+  int    xsk_map_fd = -1;
+  int    prog_fd    = -1;
+  int    link_fd    = -1;
+  int    epoll_fd   = -1;
+  void*  umem       = MAP_FAILED;
+  size_t umem_len   = 0;
+
+  xdp_ring<uint64_t> fill_ring, comp_ring;
+  xdp_ring<xdp_desc> rx_ring, tx_ring;
+
+  // Rx thread
+  uint32_t   rx_cons = 0, fill_prod = 0;
+  in_addr_t  last_learned_addr = INADDR_ANY;
+  mac_addr_t last_learned_mac  = {};
+
+  // Tx thread
+  uint32_t              tx_prod = 0, comp_cons = 0;
+  std::vector<uint64_t> free_tx_frames;
+  mac_addr_t            src_mac  = {};
+  in_addr_t             src_addr = INADDR_ANY;
+  uint16_t              ip_id    = 0;
+
+  // Next hop MAC addresses of the peers, learned by the Rx thread and used by the Tx thread
+  struct neighbour_t {
+    in_addr_t  addr;
+    mac_addr_t mac;
+  };
+  std::mutex                              neighbour_mutex;
+  std::array<neighbour_t, max_neighbours> neighbours;
+  uint32_t                                nof_neighbours = 0;
+};
+
+bool af_xdp_datagram_socket::open(const datagram_socket_args_t& args)
+{
+  int ifindex = if_nametoindex(args.xdp_if_name.c_str());
+  if (ifindex == 0) {
+    logger.error("AF_XDP: unknown interface \"%s\"", args.xdp_if_name.c_str());
+    return false;
+  }
+  if (args.xdp_nof_frames < min_nof_frames or (args.xdp_nof_frames & (args.xdp_nof_frames - 1)) != 0) {
+    logger.error("AF_XDP: the number of frames must be a power of two, not lower than %d", min_nof_frames);
+    return false;
+  }
+  udp_socket = make_udp_datagram_socket(args, logger);
+  if (udp_socket == nullptr or not read_if_addresses(args)) {
+    return false;
+  }
+
+  xsk_fd = socket(AF_XDP, SOCK_RAW, 0);
+  if (xsk_fd < 0) {
+    logger.error("AF_XDP: failed to open socket: %s", strerror(errno));
+    return false;
+  }
+  if (not setup_umem(args.xdp_nof_frames)) {
+    return false;
+  }
+
+  sockaddr_xdp sxdp  = {};
+  sxdp.sxdp_family   = AF_XDP;
+  sxdp.sxdp_flags    = XDP_USE_NEED_WAKEUP | (args.xdp_drv_mode ? 0 : XDP_COPY);
+  sxdp.sxdp_ifindex  = ifindex;
+  sxdp.sxdp_queue_id = args.xdp_queue_id;
+  if (bind(xsk_fd, (const sockaddr*)&sxdp, sizeof(sxdp)) != 0) {
+    logger.error("AF_XDP: failed to bind to %s queue %d: %s",
+                 args.xdp_if_name.c_str(),
+                 args.xdp_queue_id,
+                 strerror(errno));
+    return false;
+  }
+  if (not setup_xdp_program(args, ifindex)) {
+    return false;
+  }
+
+  // Both the AF_XDP and the UDP socket are polled
+  epoll_fd = epoll_create1(0);
+  if (epoll_fd < 0) {
+    logger.error("AF_XDP: failed to create epoll: %s", strerror(errno));
+    return false;
+  }
+  for (int fd : {xsk_fd, udp_socket->get_fd()}) {
+    epoll_event ev = {};
+    ev.events      = EPOLLIN;
+    ev.data.fd     = fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+      logger.error("AF_XDP: failed to add socket to epoll: %s", strerror(errno));
+      return false;
+    }
+  }
+  return true;
+}
+
+bool af_xdp_datagram_socket::read_if_addresses(const datagram_socket_args_t& args)
+{
+  ifreq ifr = {};
+  strncpy(ifr.ifr_name, args.xdp_if_name.c_str(), IFNAMSIZ - 1);
+  if (ioctl(udp_socket->get_fd(), SIOCGIFHWADDR, &ifr) != 0) {
+    logger.error("AF_XDP: failed to read the MAC address of %s: %s", args.xdp_if_name.c_str(), strerror(errno));
+    return false;
+  }
+  memcpy(src_mac.data(), ifr.ifr_hwaddr.sa_data, ETH_ALEN);
+
+  src_addr = udp_socket->get_addr_in().sin_addr.s_addr;
+  if (src_addr == INADDR_ANY) {
+    if (ioctl(udp_socket->get_fd(), SIOCGIFADDR, &ifr) != 0) {
+      logger.error("AF_XDP: failed to read the IPv4 address of %s: %s", args.xdp_if_name.c_str(), strerror(errno));
+      return false;
+    }
+    src_addr = reinterpret_cast<const sockaddr_in*>(&ifr.ifr_addr)->sin_addr.s_addr;
+  }
+  return true;
+}
+
+bool af_xdp_datagram_socket::setup_umem(uint32_t nof_frames)
+{
+  // Half of the frames are given to the kernel for Rx, the other half are used for Tx
+  uint32_t nof_rx_frames = nof_frames / 2;
+  uint32_t nof_tx_frames = nof_frames - nof_rx_frames;
+
+  umem_len = (size_t)nof_frames * xdp_frame_size;
+  umem     = mmap(nullptr, umem_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+  if (umem == MAP_FAILED) {
+    logger.error("AF_XDP: failed to allocate the UMEM: %s", strerror(errno));
+    return false;
+  }
+  xdp_umem_reg reg = {};
+  reg.addr         = reinterpret_cast<uint64_t>(umem);
+  reg.len          = umem_len;
+  reg.chunk_size   = xdp_frame_size;
+  reg.headroom     = 0;
+  if (setsockopt(xsk_fd, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) != 0) {
+    logger.error("AF_XDP: failed to register the UMEM: %s", strerror(errno));
+    return false;
+  }
+  if (setsockopt(xsk_fd, SOL_XDP, XDP_UMEM_FILL_RING, &nof_rx_frames, sizeof(uint32_t)) != 0 or
+      setsockopt(xsk_fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &nof_tx_frames, sizeof(uint32_t)) != 0 or
+      setsockopt(xsk_fd, SOL_XDP, XDP_RX_RING, &nof_rx_frames, sizeof(uint32_t)) != 0 or
+      setsockopt(xsk_fd, SOL_XDP, XDP_TX_RING, &nof_tx_frames, sizeof(uint32_t)) != 0) {
+    logger.error("AF_XDP: failed to set the size of the rings: %s", strerror(errno));
+    return false;
+  }
+
+  xdp_mmap_offsets off    = {};
+  socklen_t        optlen = sizeof(off);
+  if (getsockopt(xsk_fd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen) != 0 or
+      not fill_ring.init(xsk_fd, off.fr, nof_rx_frames, XDP_UMEM_PGOFF_FILL_RING) or
+      not comp_ring.init(xsk_fd, off.cr, nof_tx_frames, XDP_UMEM_PGOFF_COMPLETION_RING) or
+      not rx_ring.init(xsk_fd, off.rx, nof_rx_frames, XDP_PGOFF_RX_RING) or
+      not tx_ring.init(xsk_fd, off.tx, nof_tx_frames, XDP_PGOFF_TX_RING)) {
+    logger.error("AF_XDP: failed to map the rings: %s", strerror(errno));
+    return false;
+  }
+
+  for (uint32_t i = 0; i < nof_rx_frames; ++i) {
+    fill_ring[fill_prod++] = (uint64_t)i * xdp_frame_size;
+  }
+  fill_ring.store_producer(fill_prod);
+  free_tx_frames.reserve(nof_tx_frames);
+  for (uint32_t i = nof_rx_frames; i < nof_frames; ++i) {
+    free_tx_frames.push_back((uint64_t)i * xdp_frame_size);
+  }
+  return true;
+}
+
+bool af_xdp_datagram_socket::setup_xdp_program(const datagram_socket_args_t& args, int ifindex)
+{
+  bpf_attr attr    = {};
+  attr.map_type    = BPF_MAP_TYPE_XSKMAP;
+  attr.key_size    = sizeof(uint32_t);
+  attr.value_size  = sizeof(uint32_t);
+  attr.max_entries = args.xdp_queue_id + 1;
+  xsk_map_fd       = sys_bpf(BPF_MAP_CREATE, &attr);
+  if (xsk_map_fd < 0) {
+    logger.error("AF_XDP: failed to create the XSKMAP: %s", strerror(errno));
+    return false;
+  }
+
+  std::vector<bpf_insn> prog    = make_xdp_program(xsk_map_fd, udp_socket->get_addr_in());
+  const char*           license = "GPL";
+  std::vector<char>     verifier_log(16384);
+  attr           = {};
+  attr.prog_type = BPF_PROG_TYPE_XDP;
+  attr.insns     = reinterpret_cast<uint64_t>(prog.data());
+  attr.insn_cnt  = prog.size();
+  attr.license   = reinterpret_cast<uint64_t>(license);
+  prog_fd        = sys_bpf(BPF_PROG_LOAD, &attr);
+  if (prog_fd < 0) {
+    // Load again to get the log of the verifier
+    attr.log_buf   = reinterpret_cast<uint64_t>(verifier_log.data());
+    attr.log_size  = verifier_log.size();
+    attr.log_level = 1;
+    sys_bpf(BPF_PROG_LOAD, &attr);
+    logger.error("AF_XDP: failed to load the XDP program: %s\n%s", strerror(errno), verifier_log.data());
+    return false;
+  }
+
+  // The program is detached when the link is closed
+  attr                            = {};
+  attr.link_create.prog_fd        = prog_fd;
+  attr.link_create.target_ifindex = ifindex;
+  attr.link_create.attach_type    = BPF_XDP;
+  attr.link_create.flags          = args.xdp_drv_mode ? XDP_FLAGS_DRV_MODE : XDP_FLAGS_SKB_MODE;
+  link_fd                         = sys_bpf(BPF_LINK_CREATE, &attr);
+  if (link_fd < 0) {
+    logger.error("AF_XDP: failed to attach the XDP program to %s: %s", args.xdp_if_name.c_str(), strerror(errno));
+    return false;
+  }
+
+  uint32_t key = args.xdp_queue_id;
+  attr         = {};
+  attr.map_fd  = xsk_map_fd;
+  attr.key     = reinterpret_cast<uint64_t>(&key);
+  attr.value   = reinterpret_cast<uint64_t>(&xsk_fd);
+  attr.flags   = BPF_ANY;
+  if (sys_bpf(BPF_MAP_UPDATE_ELEM, &attr) != 0) {
+    logger.error("AF_XDP: failed to insert the socket in the XSKMAP: %s", strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool af_xdp_datagram_socket::parse_frame(const uint8_t* frame, uint32_t len, byte_buffer_t* pdu, sockaddr_in* from)
+{
+  // The XDP program only redirects IPv4/UDP frames without IP options
+  const iphdr*  ip  = reinterpret_cast<const iphdr*>(frame + ETH_HLEN);
+  const udphdr* udp = reinterpret_cast<const udphdr*>(frame + ETH_HLEN + sizeof(iphdr));
+  if (len < eth_ip_udp_len or ntohs(udp->len) < sizeof(udphdr) or ETH_HLEN + sizeof(iphdr) + ntohs(udp->len) > len) {
+    return false;
+  }
+  uint32_t payload_len = ntohs(udp->len) - sizeof(udphdr);
+  if (payload_len > pdu->get_tailroom()) {
+    return false;
+  }
+  memcpy(pdu->msg, frame + eth_ip_udp_len, payload_len);
+  pdu->N_bytes          = payload_len;
+  *from                 = {};
+  from->sin_family      = AF_INET;
+  from->sin_addr.s_addr = ip->saddr;
+  from->sin_port        = udp->source;
+
+  // Learn the MAC address of the next hop towards the source
+  const uint8_t* mac = frame + ETH_ALEN;
+  if (ip->saddr != last_learned_addr or memcmp(mac, last_learned_mac.data(), ETH_ALEN) != 0) {
+    last_learned_addr = ip->saddr;
+    memcpy(last_learned_mac.data(), mac, ETH_ALEN);
+    std::lock_guard<std::mutex> lock(neighbour_mutex);
+    uint32_t                    idx = 0;
+    while (idx < nof_neighbours and neighbours[idx].addr != ip->saddr) {
+      idx++;
+    }
+    if (idx == max_neighbours) {
+      // Replace the oldest one
+      std::move(neighbours.begin() + 1, neighbours.end(), neighbours.begin());
+      idx--;
+    }
+    nof_neighbours       = std::max(nof_neighbours, idx + 1);
+    neighbours[idx].addr = ip->saddr;
+    memcpy(neighbours[idx].mac.data(), mac, ETH_ALEN);
+  }
+  return true;
+}
+
+int af_xdp_datagram_socket::recv(span<unique_byte_buffer_t> pdus, span<sockaddr_in> from)
+{
+  uint32_t nof_frames = std::min(rx_ring.load_producer() - rx_cons, (uint32_t)pdus.size());
+  uint32_t n          = 0;
+  for (uint32_t i = 0; i < nof_frames; ++i) {
+    const xdp_desc& desc = rx_ring[rx_cons + i];
+    if (parse_frame(static_cast<const uint8_t*>(umem) + desc.addr, desc.len, pdus[n].get(), &from[n])) {
+      n++;
+    } else {
+      logger.warning("AF_XDP: dropped invalid or too large frame of %d bytes", desc.len);
+    }
+    // The frame is given back to the kernel right away, since the datagram was copied to the byte buffer
+    fill_ring[fill_prod + i] = desc.addr & ~(uint64_t)(xdp_frame_size - 1);
+  }
+  rx_cons += nof_frames;
+  fill_prod += nof_frames;
+  fill_ring.store_producer(fill_prod);
+  rx_ring.store_consumer(rx_cons);
+  if (fill_ring.needs_wakeup()) {
+    recvfrom(xsk_fd, nullptr, 0, MSG_DONTWAIT, nullptr, nullptr);
+  }
+
+  // Datagrams that the XDP program let through to the kernel stack
+  if (nof_frames < pdus.size()) {
+    int ret = udp_socket->recv(pdus.subspan(n, pdus.size() - n), from.subspan(n, from.size() - n));
+    if (ret > 0) {
+      n += ret;
+    }
+  }
+  return n;
+}
+
+bool af_xdp_datagram_socket::find_neighbour(in_addr_t addr, mac_addr_t* mac)
+{
+  std::lock_guard<std::mutex> lock(neighbour_mutex);
+  for (uint32_t i = 0; i < nof_neighbours; ++i) {
+    if (neighbours[i].addr == addr) {
+      *mac = neighbours[i].mac;
+      return true;
+    }
+  }
+  return false;
+}
+
+void af_xdp_datagram_socket::kick_tx()
+{
+  if (tx_ring.needs_wakeup()) {
+    sendto(xsk_fd, nullptr, 0, MSG_DONTWAIT, nullptr, 0);
+  }
+}
+
+bool af_xdp_datagram_socket::alloc_tx_frame(uint64_t* addr)
+{
+  for (uint32_t attempt = 0; attempt < 2 and free_tx_frames.empty(); ++attempt) {
+    if (attempt > 0) {
+      kick_tx();
+    }
+    // Recover the frames already sent
+    uint32_t comp_prod = comp_ring.load_producer();
+    for (; comp_cons != comp_prod; ++comp_cons) {
+      free_tx_frames.push_back(comp_ring[comp_cons]);
+    }
+    comp_ring.store_consumer(comp_cons);
+  }
+  if (free_tx_frames.empty()) {
+    return false;
+  }
+  *addr = free_tx_frames.back();
+  free_tx_frames.pop_back();
+  return true;
+}
+
+bool af_xdp_datagram_socket::send(const byte_buffer_t& pdu, const sockaddr_in& dest)
+{
+  // Until a frame is received from the destination, the datagrams are sent through the kernel stack
+  mac_addr_t dst_mac;
+  uint64_t   addr;
+  if (eth_ip_udp_len + pdu.N_bytes > xdp_frame_size or not find_neighbour(dest.sin_addr.s_addr, &dst_mac) or
+      not alloc_tx_frame(&addr)) {
+    return udp_socket->send(pdu, dest);
+  }
+
+  uint8_t* frame = static_cast<uint8_t*>(umem) + addr;
+  ethhdr*  eth   = reinterpret_cast<ethhdr*>(frame);
+  memcpy(eth->h_dest, dst_mac.data(), ETH_ALEN);
+  memcpy(eth->h_source, src_mac.data(), ETH_ALEN);
+  eth->h_proto = htons(ETH_P_IP);
+
+  iphdr ip    = {};
+  ip.version  = 4;
+  ip.ihl      = sizeof(iphdr) / 4;
+  ip.tot_len  = htons(sizeof(iphdr) + sizeof(udphdr) + pdu.N_bytes);
+  ip.id       = htons(ip_id++);
+  ip.frag_off = htons(IP_DF);
+  ip.ttl      = IPDEFTTL;
+  ip.protocol = IPPROTO_UDP;
+  ip.saddr    = src_addr;
+  ip.daddr    = dest.sin_addr.s_addr;
+  ip.check    = ipv4_checksum(ip);
+  memcpy(frame + ETH_HLEN, &ip, sizeof(ip));
+
+  // The UDP checksum is optional over IPv4
+  udphdr udp = {};
+  udp.source = udp_socket->get_addr_in().sin_port;
+  udp.dest   = dest.sin_port;
+  udp.len    = htons(sizeof(udphdr) + pdu.N_bytes);
+  memcpy(frame + ETH_HLEN + sizeof(iphdr), &udp, sizeof(udp));
+  memcpy(frame + eth_ip_udp_len, pdu.msg, pdu.N_bytes);
+
+  xdp_desc& desc = tx_ring[tx_prod++];
+  desc.addr      = addr;
+  desc.len       = eth_ip_udp_len + pdu.N_bytes;
+  desc.options   = 0;
+  tx_ring.store_producer(tx_prod);
+  kick_tx();
+  return true;
+}
+
+} // namespace
+
+std::unique_ptr<datagram_socket> make_af_xdp_datagram_socket(const datagram_socket_args_t& args,
+                                                             srslog::basic_logger&         logger)
+{
+  std::unique_ptr<af_xdp_datagram_socket> socket(new af_xdp_datagram_socket(logger));
+  if (not socket->open(args)) {
+    return nullptr;
+  }
+  return std::move(socket);
+}
+
+} // namespace srsran
+
+#else // HAVE_AF_XDP
+
+namespace srsran {
+
+std::unique_ptr<datagram_socket> make_af_xdp_datagram_socket(const datagram_socket_args_t& args,
+                                                             srslog::basic_logger&         logger)
+{
+  logger.error("AF_XDP sockets are not supported by this build");
+  return nullptr;
+}
+
+} // namespace srsran
+
+#endif // HAVE_AF_XDP
@@ -20,6 +20,7 @@
  */
 
 #include "srsran/common/network_utils.h"
+#include "srsran/adt/bounded_vector.h"
 
 #include <netinet/sctp.h>
 #include <sys/socket.h>
@@ -701,4 +702,77 @@ make_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& queue,
   return socket_manager_itf::recv_callback_t(recvfrom_pdu_task(logger, queue, std::move(rx_callback)));
 }
 
+/**
+ * Description: Functor for the case the received data is in the form of unique_byte_buffer, and all the datagrams
+ * already received by a datagram_socket are read at once. The byte buffers that are not filled are kept for the next
+ * call
+ */
+class datagram_batch_pdu_task
+{
+public:
+  using callback_t = recvfrom_batch_callback_t;
+  explicit datagram_batch_pdu_task(srslog::basic_logger&      logger,
+                                   srsran::task_queue_handle& queue_,
+                                   datagram_socket&           socket_,
+                                   callback_t                 func_) :
+    logger(logger), queue(queue_), socket(socket_), func(std::move(func_))
+  {}
+
+  bool operator()(int fd)
+  {
+    uint32_t nof_bufs = 0;
+    for (; nof_bufs < MAX_SDU_BATCH_SIZE; ++nof_bufs) {
+      if (pdus[nof_bufs] == nullptr) {
+        pdus[nof_bufs] = srsran::make_byte_buffer();
+        if (pdus[nof_bufs] == nullptr) {
+          break;
+        }
+      }
+    }
+    if (nof_bufs == 0) {
+      logger.error("Unable to allocate byte buffer");
+      return true;
+    }
+
+    int n_recv = socket.recv(srsran::span<srsran::unique_byte_buffer_t>(pdus.data(), nof_bufs), from);
+    if (n_recv <= 0) {
+      return true;
+    }
+
+    // Move the filled byte buffers to the batch, and keep the rest for the next call
+    std::unique_ptr<batch_t> batch(new batch_t{});
+    for (int i = 0; i < n_recv; ++i) {
+      batch->pdus.push_back(std::move(pdus[i]));
+      batch->from.push_back(from[i]);
+    }
+    std::move(pdus.begin() + n_recv, pdus.end(), pdus.begin());
+
+    // Defer handling of received packets to provided queue
+    queue.push(std::bind([this](std::unique_ptr<batch_t>& b) { func(b->pdus, b->from); }, std::move(batch)));
+
+    return true;
+  }
+
+private:
+  struct batch_t {
+    srsran::bounded_vector<srsran::unique_byte_buffer_t, MAX_SDU_BATCH_SIZE> pdus;
+    srsran::bounded_vector<sockaddr_in, MAX_SDU_BATCH_SIZE>                  from;
+  };
+
+  srslog::basic_logger&                                        logger;
+  srsran::task_queue_handle&                                   queue;
+  datagram_socket&                                             socket;
+  callback_t                                                   func;
+  std::array<srsran::unique_byte_buffer_t, MAX_SDU_BATCH_SIZE> pdus;
+  std::array<sockaddr_in, MAX_SDU_BATCH_SIZE>                  from;
+};
+
+socket_manager_itf::recv_callback_t make_sdu_batch_handler(srslog::basic_logger&      logger,
+                                                           srsran::task_queue_handle& queue,
+                                                           datagram_socket&           socket,
+                                                           recvfrom_batch_callback_t  rx_callback)
+{
+  return socket_manager_itf::recv_callback_t(datagram_batch_pdu_task(logger, queue, socket, std::move(rx_callback)));
+}
+
 } // namespace srsran
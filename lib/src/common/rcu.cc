@@ -0,0 +1,95 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/rcu.h"
+#include "srsran/support/srsran_assert.h"
+#include <mutex>
+#include <thread>
+
+namespace srsran {
+
+namespace {
+
+// The readers of each thread count in one of the shards, to avoid bouncing a single cache line between the cores
+const uint32_t nof_shards = 16;
+
+// Readers count in the counter of the current epoch. A grace period flips the epoch and waits for the counters of the
+// previous one to drain, which new readers no longer increment
+struct alignas(64) rcu_shard_t {
+  std::atomic<int32_t> nof_readers[2];
+};
+
+rcu_shard_t           shards[nof_shards] = {};
+std::atomic<uint32_t> epoch{0};
+std::atomic<uint32_t> next_shard{0};
+std::mutex            writer_mutex;
+
+struct rcu_thread_state_t {
+  uint32_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % nof_shards;
+  uint32_t depth = 0;
+  uint32_t idx   = 0;
+};
+
+thread_local rcu_thread_state_t thread_state;
+
+void wait_for_readers(uint32_t idx)
+{
+  for (rcu_shard_t& s : shards) {
+    while (s.nof_readers[idx].load() != 0) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+} // namespace
+
+rcu_read_guard::rcu_read_guard()
+{
+  rcu_thread_state_t& t = thread_state;
+  if (t.depth++ == 0) {
+    // Sequentially consistent, so that the lookups after the increment see the entries removed before the writer
+    // checked this counter
+    t.idx = epoch.load();
+    shards[t.shard].nof_readers[t.idx].fetch_add(1);
+  }
+}
+
+rcu_read_guard::~rcu_read_guard()
+{
+  rcu_thread_state_t& t = thread_state;
+  if (--t.depth == 0) {
+    shards[t.shard].nof_readers[t.idx].fetch_sub(1);
+  }
+}
+
+void rcu_synchronize()
+{
+  srsran_assert(thread_state.depth == 0, "rcu_synchronize() called within a read-side critical section");
+
+  std::lock_guard<std::mutex> lock(writer_mutex);
+  uint32_t                    cur = epoch.load();
+  // Readers that loaded the epoch before the previous flip may still count in the other counter
+  wait_for_readers(cur ^ 1u);
+  epoch.store(cur ^ 1u);
+  wait_for_readers(cur);
+}
+
+} // namespace srsran
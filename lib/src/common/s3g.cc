@@ -20,6 +20,7 @@
  */
 
 #include "srsran/common/s3g.h"
+#include <algorithm>
 
 /* S-box SQ */
 static const uint8_t SQ[256] = {
@@ -51,114 +52,6 @@ static const uint8_t S[256] = {
     180, 198, 232, 221, 116, 31,  75,  189, 139, 138, 112, 62,  181, 102, 72,  3,   246, 14,  97,  53,  87,  185,
     134, 193, 29,  158, 225, 248, 152, 17,  105, 217, 142, 148, 155, 30,  135, 233, 206, 85,  40,  223, 140, 161,
     137, 13,  191, 230, 66,  104, 65,  153, 45,  15,  176, 84,  187, 22};
-/*********************************************************************
-    Name: s3g_mul_x
-
-    Description: Multiplication with reduction.
-
-    Document Reference: Specification of the 3GPP Confidentiality and
-                            Integrity Algorithms UEA2 & UIA2 D2 v1.1
-                            Section 3.1.1
-*********************************************************************/
-uint8_t s3g_mul_x(uint8_t v, uint8_t c);
-
-/*********************************************************************
-    Name: s3g_mul_x_pow
-
-    Description: Recursive multiplication with reduction.
-
-    Document Reference: Specification of the 3GPP Confidentiality and
-                            Integrity Algorithms UEA2 & UIA2 D2 v1.1
-                            Section 3.1.2
-*********************************************************************/
-uint8_t s3g_mul_x_pow(uint8_t v, uint8_t i, uint8_t c);
-
-/*********************************************************************
-    Name: s3g_mul_alpha
-
-    Description: Multiplication with alpha.
-
-    Document Reference: Specification of the 3GPP Confidentiality and
-                            Integrity Algorithms UEA2 & UIA2 D2 v1.1
-                            Section 3.4.2
-*********************************************************************/
-uint32_t s3g_mul_alpha(uint8_t c);
-
-/*********************************************************************
-    Name: s3g_div_alpha
-
-    Description: Division by alpha.
-
-    Document Reference: Specification of the 3GPP Confidentiality and
-                            Integrity Algorithms UEA2 & UIA2 D2 v1.1
-                            Section 3.4.3
-*********************************************************************/
-uint32_t s3g_div_alpha(uint8_t c);
-
-/*********************************************************************
-    Name: s3g_s1
-
-    Description: S-Box S1.
-
-    Document Reference: Specification of the 3GPP Confidentiality and
-                            Integrity Algorithms UEA2 & UIA2 D2 v1.1
-                            Section 3.3.1
-*********************************************************************/
-uint32_t s3g_s1(uint32_t w);
-
-/*********************************************************************
-    Name: s3g_s2
-
-    Description: S-Box S2.
-
-    Document Reference: Specification of the 3GPP Confidentiality and
-                            Integrity Algorithms UEA2 & UIA2 D2 v1.1
-                            Section 3.3.2
-*********************************************************************/
-uint32_t s3g_s2(uint32_t w);
-
-/*********************************************************************
-    Name: s3g_clock_lfsr
-
-    Description: Clocking LFSR.
-
-    Document Reference: Specification of the 3GPP Confidentiality and
-                            Integrity Algorithms UEA2 & UIA2 D2 v1.1
-                            Section 3.4.4 and Section 3.4.5
-*********************************************************************/
-void s3g_clock_lfsr(S3G_STATE* state, uint32_t f);
-
-/*********************************************************************
-    Name: s3g_clock_fsm
-
-    Description: Clocking FSM.
-
-    Document Reference: Specification of the 3GPP Confidentiality and
-                            Integrity Algorithms UEA2 & UIA2 D2 v1.1
-                            Section 3.4.6
-*********************************************************************/
-uint32_t s3g_clock_fsm(S3G_STATE* state);
-
-/*********************************************************************
-    Name: s3g_deinitialize
-
-    Description: Deinitialization.
-
-    Document Reference: Specification of the 3GPP Confidentiality and
-                            Integrity Algorithms UEA2 & UIA2 D2 v1.1
-*********************************************************************/
-void s3g_deinitialize(S3G_STATE* state);
-
-/*********************************************************************
-    Name: s3g_generate_keystream
-
-    Description: Generation of Keystream.
-
-    Document Reference: Specification of the 3GPP Confidentiality and
-                            Integrity Algorithms UEA2 & UIA2 D2 v1.1
-                            Section 4.2
-*********************************************************************/
-void s3g_generate_keystream(S3G_STATE* state, uint32_t n, uint32_t* ks);
 
 /*********************************************************************
     Name: s3g_mul_x
@@ -225,31 +118,78 @@ uint32_t s3g_div_alpha(uint8_t c)
 }
 
 /*********************************************************************
-    Name: s3g_s1
+    Name: s3g_tables_t
 
-    Description: S-Box S1.
+    Description: Lookup tables of MULalpha and DIValpha, and of the
+                 S-Boxes S1 and S2 merged with their column mixing, one
+                 table per input byte. With them, each clock of the LFSR
+                 and of the FSM is a handful of word operations. They
+                 are computed once, on first use.
 
     Document Reference: Specification of the 3GPP Confidentiality and
                             Integrity Algorithms UEA2 & UIA2 D2 v1.1
-                            Section 3.3.1
+                            Sections 3.3 and 3.4
 *********************************************************************/
-uint32_t s3g_s1(uint32_t w)
+static uint32_t s3g_make_word(uint8_t b0, uint8_t b1, uint8_t b2, uint8_t b3)
+{
+  return (((uint32_t)b0) << 24) | (((uint32_t)b1) << 16) | (((uint32_t)b2) << 8) | ((uint32_t)b3);
+}
+
+struct s3g_tables_t {
+  uint32_t mul_alpha[256];
+  uint32_t div_alpha[256];
+  uint32_t s1[4][256];
+  uint32_t s2[4][256];
+
+  s3g_tables_t()
+  {
+    for (uint32_t i = 0; i < 256; i++) {
+      mul_alpha[i] = s3g_mul_alpha(i);
+      div_alpha[i] = s3g_div_alpha(i);
+
+      uint8_t a = S[i], ma = s3g_mul_x(a, 0x1b);
+      s1[0][i]  = s3g_make_word(ma, ma ^ a, a, a);
+      s1[1][i]  = s3g_make_word(a, ma, ma ^ a, a);
+      s1[2][i]  = s3g_make_word(a, a, ma, ma ^ a);
+      s1[3][i]  = s3g_make_word(ma ^ a, a, a, ma);
+
+      uint8_t q = SQ[i], mq = s3g_mul_x(q, 0x69);
+      s2[0][i]  = s3g_make_word(mq, mq ^ q, q, q);
+      s2[1][i]  = s3g_make_word(q, mq, mq ^ q, q);
+      s2[2][i]  = s3g_make_word(q, q, mq, mq ^ q);
+      s2[3][i]  = s3g_make_word(mq ^ q, q, q, mq);
+    }
+  }
+};
+
+static const s3g_tables_t& s3g_tables()
 {
-  uint8_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
-  uint8_t srw0 = S[(uint8_t)((w >> 24) & 0xff)];
-  uint8_t srw1 = S[(uint8_t)((w >> 16) & 0xff)];
-  uint8_t srw2 = S[(uint8_t)((w >> 8) & 0xff)];
-  uint8_t srw3 = S[(uint8_t)((w)&0xff)];
+  static const s3g_tables_t tables;
+  return tables;
+}
 
-  r0 = ((s3g_mul_x(srw0, 0x1b)) ^ (srw1) ^ (srw2) ^ ((s3g_mul_x(srw3, 0x1b)) ^ srw3));
+static inline uint32_t s3g_s1_lookup(const s3g_tables_t& t, uint32_t w)
+{
+  return t.s1[0][w >> 24] ^ t.s1[1][(w >> 16) & 0xff] ^ t.s1[2][(w >> 8) & 0xff] ^ t.s1[3][w & 0xff];
+}
 
-  r1 = (((s3g_mul_x(srw0, 0x1b)) ^ srw0) ^ (s3g_mul_x(srw1, 0x1b)) ^ (srw2) ^ (srw3));
+static inline uint32_t s3g_s2_lookup(const s3g_tables_t& t, uint32_t w)
+{
+  return t.s2[0][w >> 24] ^ t.s2[1][(w >> 16) & 0xff] ^ t.s2[2][(w >> 8) & 0xff] ^ t.s2[3][w & 0xff];
+}
 
-  r2 = ((srw0) ^ ((s3g_mul_x(srw1, 0x1b)) ^ srw1) ^ (s3g_mul_x(srw2, 0x1b)) ^ (srw3));
+/*********************************************************************
+    Name: s3g_s1
 
-  r3 = ((srw0) ^ (srw1) ^ ((s3g_mul_x(srw2, 0x1b)) ^ srw2) ^ (s3g_mul_x(srw3, 0x1b)));
+    Description: S-Box S1.
 
-  return ((((uint32_t)r0) << 24) | (((uint32_t)r1) << 16) | (((uint32_t)r2) << 8) | (((uint32_t)r3)));
+    Document Reference: Specification of the 3GPP Confidentiality and
+                            Integrity Algorithms UEA2 & UIA2 D2 v1.1
+                            Section 3.3.1
+*********************************************************************/
+uint32_t s3g_s1(uint32_t w)
+{
+  return s3g_s1_lookup(s3g_tables(), w);
 }
 
 /*********************************************************************
@@ -263,107 +203,155 @@ uint32_t s3g_s1(uint32_t w)
 *********************************************************************/
 uint32_t s3g_s2(uint32_t w)
 {
-  uint8_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
-  uint8_t sqw0 = SQ[(uint8_t)((w >> 24) & 0xff)];
-  uint8_t sqw1 = SQ[(uint8_t)((w >> 16) & 0xff)];
-  uint8_t sqw2 = SQ[(uint8_t)((w >> 8) & 0xff)];
-  uint8_t sqw3 = SQ[(uint8_t)((w)&0xff)];
-
-  r0 = ((s3g_mul_x(sqw0, 0x69)) ^ (sqw1) ^ (sqw2) ^ ((s3g_mul_x(sqw3, 0x69)) ^ sqw3));
-
-  r1 = (((s3g_mul_x(sqw0, 0x69)) ^ sqw0) ^ (s3g_mul_x(sqw1, 0x69)) ^ (sqw2) ^ (sqw3));
-
-  r2 = ((sqw0) ^ ((s3g_mul_x(sqw1, 0x69)) ^ sqw1) ^ (s3g_mul_x(sqw2, 0x69)) ^ (sqw3));
-
-  r3 = ((sqw0) ^ (sqw1) ^ ((s3g_mul_x(sqw2, 0x69)) ^ sqw2) ^ (s3g_mul_x(sqw3, 0x69)));
-
-  return ((((uint32_t)r0) << 24) | (((uint32_t)r1) << 16) | (((uint32_t)r2) << 8) | (((uint32_t)r3)));
+  return s3g_s2_lookup(s3g_tables(), w);
 }
 
 /*********************************************************************
-    Name: s3g_clock_lfsr
+    Name: s3g_clock
 
-    Description: Clocking LFSR.
+    Description: Clocks the FSM and then the LFSR, in initialisation or
+                 in keystream mode. The LFSR is kept as a ring buffer,
+                 with s_k stored in lfsr[(j + k) % 16] at clock j, so
+                 that clocking it only overwrites s_0 with s_16.
+                 Returns F ^ s_0, i.e. the keystream word in keystream
+                 mode.
 
     Document Reference: Specification of the 3GPP Confidentiality and
                             Integrity Algorithms UEA2 & UIA2 D2 v1.1
-                            Section 3.4.4 and Section 3.4.5
+                            Sections 3.4.4 to 3.4.6
 *********************************************************************/
-void s3g_clock_lfsr(S3G_STATE* state, uint32_t f)
+template <bool init_mode>
+static inline uint32_t s3g_clock(const s3g_tables_t& t, S3G_STATE* state, uint32_t j)
+{
+  uint32_t* s  = state->lfsr;
+  uint32_t  r1 = state->fsm[0];
+  uint32_t  r2 = state->fsm[1];
+  uint32_t  r3 = state->fsm[2];
+
+  uint32_t f    = (s[(j + 15) & 15] + r1) ^ r2;
+  state->fsm[0] = r2 + (r3 ^ s[(j + 5) & 15]);
+  state->fsm[1] = s3g_s1_lookup(t, r1);
+  state->fsm[2] = s3g_s2_lookup(t, r2);
+
+  uint32_t s0  = s[j & 15];
+  uint32_t s11 = s[(j + 11) & 15];
+  uint32_t v   = (s0 << 8) ^ t.mul_alpha[s0 >> 24] ^ s[(j + 2) & 15] ^ (s11 >> 8) ^ t.div_alpha[s11 & 0xff];
+  s[j & 15]    = init_mode ? (v ^ f) : v;
+
+  return f ^ s0;
+}
+
+/* Brings the LFSR ring buffer back to s_k in lfsr[k], after nof_clocks clocks */
+static inline void s3g_align_lfsr(S3G_STATE* state, uint32_t nof_clocks)
+{
+  std::rotate(state->lfsr, state->lfsr + (nof_clocks & 15), state->lfsr + 16);
+}
+
+template <uint32_t nof_lanes>
+static void s3g_initialize_lanes_impl(S3G_STATE* const state[], const uint32_t k[][4], const uint32_t iv[][4])
 {
-  uint32_t v = (((state->lfsr[0] << 8) & 0xffffff00) ^ (s3g_mul_alpha((uint8_t)((state->lfsr[0] >> 24) & 0xff))) ^
-                (state->lfsr[2]) ^ ((state->lfsr[11] >> 8) & 0x00ffffff) ^
-                (s3g_div_alpha((uint8_t)((state->lfsr[11]) & 0xff))) ^ (f));
-  uint8_t  i;
+  const s3g_tables_t& t = s3g_tables();
+
+  for (uint32_t l = 0; l < nof_lanes; l++) {
+    uint32_t* lfsr = state[l]->lfsr;
+    lfsr[15]       = k[l][3] ^ iv[l][0];
+    lfsr[14]       = k[l][2];
+    lfsr[13]       = k[l][1];
+    lfsr[12]       = k[l][0] ^ iv[l][1];
+    lfsr[11]       = k[l][3] ^ 0xffffffff;
+    lfsr[10]       = k[l][2] ^ 0xffffffff ^ iv[l][2];
+    lfsr[9]        = k[l][1] ^ 0xffffffff ^ iv[l][3];
+    lfsr[8]        = k[l][0] ^ 0xffffffff;
+    lfsr[7]        = k[l][3];
+    lfsr[6]        = k[l][2];
+    lfsr[5]        = k[l][1];
+    lfsr[4]        = k[l][0];
+    lfsr[3]        = k[l][3] ^ 0xffffffff;
+    lfsr[2]        = k[l][2] ^ 0xffffffff;
+    lfsr[1]        = k[l][1] ^ 0xffffffff;
+    lfsr[0]        = k[l][0] ^ 0xffffffff;
+
+    state[l]->fsm[0] = 0x0;
+    state[l]->fsm[1] = 0x0;
+    state[l]->fsm[2] = 0x0;
+  }
+
+  for (uint32_t j = 0; j < 32; j++) {
+    for (uint32_t l = 0; l < nof_lanes; l++) {
+      s3g_clock<true>(t, state[l], j);
+    }
+  }
+
+  // Clock FSM and LFSR in keystream mode once, discarding the output (Section 4.2)
+  for (uint32_t l = 0; l < nof_lanes; l++) {
+    s3g_clock<false>(t, state[l], 32);
+    s3g_align_lfsr(state[l], 33);
+  }
+}
+
+template <uint32_t nof_lanes>
+static void s3g_generate_keystream_lanes_impl(S3G_STATE* const state[], uint32_t n, uint32_t* const ks[])
+{
+  const s3g_tables_t& t = s3g_tables();
 
-  for (i = 0; i < 15; i++) {
-    state->lfsr[i] = state->lfsr[i + 1];
+  // Work on local copies, which the keystream stores cannot alias
+  S3G_STATE local[nof_lanes];
+  for (uint32_t l = 0; l < nof_lanes; l++) {
+    local[l] = *state[l];
+  }
+  for (uint32_t j = 0; j < n; j++) {
+    for (uint32_t l = 0; l < nof_lanes; l++) {
+      // Note that ks[l][j] corresponds to z_{j+1} in section 4.2
+      ks[l][j] = s3g_clock<false>(t, &local[l], j);
+    }
+  }
+  for (uint32_t l = 0; l < nof_lanes; l++) {
+    s3g_align_lfsr(&local[l], n);
+    *state[l] = local[l];
   }
-  state->lfsr[15] = v;
 }
 
 /*********************************************************************
-    Name: s3g_clock_fsm
+    Name: s3g_initialize
 
-    Description: Clocking FSM.
+    Description: Initialization.
 
     Document Reference: Specification of the 3GPP Confidentiality and
                             Integrity Algorithms UEA2 & UIA2 D2 v1.1
-                            Section 3.4.6
+                            Section 4.1
 *********************************************************************/
-uint32_t s3g_clock_fsm(S3G_STATE* state)
+void s3g_initialize(S3G_STATE* state, uint32_t k[4], uint32_t iv[4])
 {
-  uint32_t f = ((state->lfsr[15] + state->fsm[0]) & 0xffffffff) ^ state->fsm[1];
-  uint32_t r = (state->fsm[1] + (state->fsm[2] ^ state->lfsr[5])) & 0xffffffff;
-
-  state->fsm[2] = s3g_s2(state->fsm[1]);
-  state->fsm[1] = s3g_s1(state->fsm[0]);
-  state->fsm[0] = r;
-
-  return f;
+  S3G_STATE* states[] = {state};
+  s3g_initialize_lanes_impl<1>(states, (const uint32_t(*)[4])k, (const uint32_t(*)[4])iv);
 }
 
 /*********************************************************************
-    Name: s3g_initialize
+    Name: s3g_initialize_lanes
 
-    Description: Initialization.
+    Description: Multi-buffer initialization.
 
     Document Reference: Specification of the 3GPP Confidentiality and
                             Integrity Algorithms UEA2 & UIA2 D2 v1.1
                             Section 4.1
 *********************************************************************/
-void s3g_initialize(S3G_STATE* state, uint32_t k[4], uint32_t iv[4])
+void s3g_initialize_lanes(S3G_STATE* state[], uint32_t nof_lanes, const uint32_t k[][4], const uint32_t iv[][4])
 {
-  uint8_t  i = 0;
-  uint32_t f = 0x0;
-
-  state->lfsr = (uint32_t*)calloc(16, sizeof(uint32_t));
-  state->fsm  = (uint32_t*)calloc(3, sizeof(uint32_t));
-
-  state->lfsr[15] = k[3] ^ iv[0];
-  state->lfsr[14] = k[2];
-  state->lfsr[13] = k[1];
-  state->lfsr[12] = k[0] ^ iv[1];
-
-  state->lfsr[11] = k[3] ^ 0xffffffff;
-  state->lfsr[10] = k[2] ^ 0xffffffff ^ iv[2];
-  state->lfsr[9]  = k[1] ^ 0xffffffff ^ iv[3];
-  state->lfsr[8]  = k[0] ^ 0xffffffff;
-  state->lfsr[7]  = k[3];
-  state->lfsr[6]  = k[2];
-  state->lfsr[5]  = k[1];
-  state->lfsr[4]  = k[0];
-  state->lfsr[3]  = k[3] ^ 0xffffffff;
-  state->lfsr[2]  = k[2] ^ 0xffffffff;
-  state->lfsr[1]  = k[1] ^ 0xffffffff;
-  state->lfsr[0]  = k[0] ^ 0xffffffff;
-
-  state->fsm[0] = 0x0;
-  state->fsm[1] = 0x0;
-  state->fsm[2] = 0x0;
-  for (i = 0; i < 32; i++) {
-    f = s3g_clock_fsm(state);
-    s3g_clock_lfsr(state, f);
+  switch (nof_lanes) {
+    case 1:
+      s3g_initialize_lanes_impl<1>(state, k, iv);
+      break;
+    case 2:
+      s3g_initialize_lanes_impl<2>(state, k, iv);
+      break;
+    case 3:
+      s3g_initialize_lanes_impl<3>(state, k, iv);
+      break;
+    case 4:
+      s3g_initialize_lanes_impl<4>(state, k, iv);
+      break;
+    default:
+      break;
   }
 }
 
@@ -377,8 +365,7 @@ void s3g_initialize(S3G_STATE* state, uint32_t k[4], uint32_t iv[4])
 *********************************************************************/
 void s3g_deinitialize(S3G_STATE* state)
 {
-  free(state->lfsr);
-  free(state->fsm);
+  memset(state, 0, sizeof(S3G_STATE));
 }
 
 /*********************************************************************
@@ -392,19 +379,37 @@ void s3g_deinitialize(S3G_STATE* state)
 *********************************************************************/
 void s3g_generate_keystream(S3G_STATE* state, uint32_t n, uint32_t* ks)
 {
-  uint32_t t = 0;
-  uint32_t f = 0x0;
-
-  // Clock FSM once. Discard the output.
-  s3g_clock_fsm(state);
-  //  Clock LFSR in keystream mode once.
-  s3g_clock_lfsr(state, 0x0);
-
-  for (t = 0; t < n; t++) {
-    f = s3g_clock_fsm(state);
-    // Note that ks[t] corresponds to z_{t+1} in section 4.2
-    ks[t] = f ^ state->lfsr[0];
-    s3g_clock_lfsr(state, 0x0);
+  S3G_STATE* states[] = {state};
+  uint32_t*  out[]    = {ks};
+  s3g_generate_keystream_lanes_impl<1>(states, n, out);
+}
+
+/*********************************************************************
+    Name: s3g_generate_keystream_lanes
+
+    Description: Multi-buffer generation of Keystream.
+
+    Document Reference: Specification of the 3GPP Confidentiality and
+                            Integrity Algorithms UEA2 & UIA2 D2 v1.1
+                            Section 4.2
+*********************************************************************/
+void s3g_generate_keystream_lanes(S3G_STATE* state[], uint32_t nof_lanes, uint32_t n, uint32_t* ks[])
+{
+  switch (nof_lanes) {
+    case 1:
+      s3g_generate_keystream_lanes_impl<1>(state, n, ks);
+      break;
+    case 2:
+      s3g_generate_keystream_lanes_impl<2>(state, n, ks);
+      break;
+    case 3:
+      s3g_generate_keystream_lanes_impl<3>(state, n, ks);
+      break;
+    case 4:
+      s3g_generate_keystream_lanes_impl<4>(state, n, ks);
+      break;
+    default:
+      break;
   }
 }
 
@@ -412,8 +417,6 @@ void s3g_generate_keystream(S3G_STATE* state, uint32_t n, uint32_t* ks)
  * Input V: a 64-bit input.
  * Input c: a 64-bit input.
  * Output : a 64-bit output.
- * A 64-bit memory is allocated which is to be freed by the calling
- * function.
  * See section 4.3.2 for details.
  */
 uint64_t s3g_MUL64x(uint64_t V, uint64_t c)
@@ -429,7 +432,6 @@ uint64_t s3g_MUL64x(uint64_t V, uint64_t c)
  * Input i: a positive integer.
  * Input c: a 64-bit input.
  * Output : a 64-bit output.
- * A 64-bit memory is allocated which is to be freed by the calling function.
  * See section 4.3.3 for details.
  */
 uint64_t s3g_MUL64xPOW(uint64_t V, uint8_t i, uint64_t c)
@@ -445,9 +447,8 @@ uint64_t s3g_MUL64xPOW(uint64_t V, uint8_t i, uint64_t c)
  * Input P: a 64-bit input.
  * Input c: a 64-bit input.
  * Output : a 64-bit output.
- * A 64-bit memory is allocated which is to be freed by the calling
- * function.
- * See section 4.3.4 for details.
+ * See section 4.3.4 for details. V * x^i is obtained from V * x^(i-1),
+ * rather than computed from scratch for every bit of P.
  */
 uint64_t s3g_MUL64(uint64_t V, uint64_t P, uint64_t c)
 {
@@ -456,11 +457,36 @@ uint64_t s3g_MUL64(uint64_t V, uint64_t P, uint64_t c)
 
   for (i = 0; i < 64; i++) {
     if ((P >> i) & 0x1)
-      result ^= s3g_MUL64xPOW(V, i, c);
+      result ^= V;
+    V = s3g_MUL64x(V, c);
+  }
+  return result;
+}
+
+/* Reduction of h * x^64, for the 4-bit polynomials h, with c = 0x1b */
+static const uint64_t s3g_mul64_reduce4[16] =
+    {0x00, 0x1b, 0x36, 0x2d, 0x6c, 0x77, 0x5a, 0x41, 0xd8, 0xc3, 0xee, 0xf5, 0xb4, 0xaf, 0x82, 0x99};
+
+/* MUL64 with c = 0x1b, 4 bits of V at a time.
+ * Input V: a 64-bit input.
+ * Input P_mul: P multiplied by the 16 polynomials of degree lower than 4.
+ * Output : V * P.
+ */
+static inline uint64_t s3g_mul64_table(uint64_t V, const uint64_t P_mul[16])
+{
+  uint64_t result = 0;
+  for (int i = 60; i >= 0; i -= 4) {
+    result = (result << 4) ^ s3g_mul64_reduce4[result >> 60] ^ P_mul[(V >> i) & 0xf];
   }
   return result;
 }
 
+static inline uint64_t s3g_load_be64(const uint8_t* p)
+{
+  return (uint64_t)p[0] << 56 | (uint64_t)p[1] << 48 | (uint64_t)p[2] << 40 | (uint64_t)p[3] << 32 |
+         (uint64_t)p[4] << 24 | (uint64_t)p[5] << 16 | (uint64_t)p[6] << 8 | (uint64_t)p[7];
+}
+
 /* mask8bit.
  * Input n: an integer in 1-7.
  * Output : an 8 bit mask.
@@ -471,6 +497,69 @@ uint8_t mask8bit(int n)
   return 0xFF ^ ((1 << (8 - n)) - 1);
 }
 
+/* f9 evaluation.
+ * See s3g.h and section 4.3.
+ */
+void s3g_f9_eval(const uint32_t z[5], const uint8_t* data, uint64_t length, uint8_t mac[4])
+{
+  uint32_t i = 0, D;
+  uint64_t EVAL;
+  uint64_t P = (uint64_t)z[0] << 32 | (uint64_t)z[1];
+  uint64_t Q = (uint64_t)z[2] << 32 | (uint64_t)z[3];
+  uint64_t c = 0x1b;
+  uint64_t P_mul[16];
+  uint64_t M_D_2;
+  int      rem_bits = 0;
+
+  P_mul[0] = 0;
+  P_mul[1] = P;
+  for (i = 2; i < 16; i++) {
+    P_mul[i] = (i % 2 == 0) ? s3g_MUL64x(P_mul[i / 2], c) : P_mul[i - 1] ^ P;
+  }
+
+  /* Calculation */
+  if ((length % 64) == 0)
+    D = (length >> 6) + 1;
+  else
+    D = (length >> 6) + 2;
+  EVAL = 0;
+
+  /* for 0 <= i <= D-3 */
+  for (i = 0; i + 2 < D; i++) {
+    EVAL = s3g_mul64_table(EVAL ^ s3g_load_be64(&data[8 * i]), P_mul);
+  }
+
+  /* for D-2, absent for an empty message */
+  if (length > 0) {
+    rem_bits = length % 64;
+    if (rem_bits == 0)
+      rem_bits = 64;
+
+    M_D_2 = 0;
+    i     = 0;
+    while (rem_bits > 7) {
+      M_D_2 |= (uint64_t)data[8 * (D - 2) + i] << (8 * (7 - i));
+      rem_bits -= 8;
+      i++;
+    }
+    if (rem_bits > 0)
+      M_D_2 |= (uint64_t)(data[8 * (D - 2) + i] & mask8bit(rem_bits)) << (8 * (7 - i));
+
+    EVAL = s3g_mul64_table(EVAL ^ M_D_2, P_mul);
+  }
+
+  /* for D-1 */
+  EVAL ^= length;
+
+  /* Multiply by Q */
+  EVAL = s3g_MUL64(EVAL, Q, c);
+
+  /* XOR with z_5: this is a modification to the reference C code,
+     which forgot to XOR z[5] */
+  for (i = 0; i < 4; i++)
+    mac[i] = ((EVAL >> (56 - (i * 8))) ^ (z[4] >> (24 - (i * 8)))) & 0xff;
+}
+
 /* f9.
  * Input key: 128 bit Integrity Key.
  * Input count:32-bit Count, Frame dependent input.
@@ -484,18 +573,10 @@ uint8_t mask8bit(int n)
 uint8_t* s3g_f9(const uint8_t* key, uint32_t count, uint32_t fresh, uint32_t dir, uint8_t* data, uint64_t length)
 {
   uint32_t       K[4], IV[4], z[5];
-  uint32_t       i        = 0, D;
+  uint32_t       i        = 0;
   static uint8_t MAC_I[4] = {0, 0, 0, 0}; /* static memory for the result */
-  uint64_t       EVAL;
-  uint64_t       V;
-  uint64_t       P;
-  uint64_t       Q;
-  uint64_t       c;
-  S3G_STATE      state, *state_ptr;
+  S3G_STATE      state;
 
-  uint64_t M_D_2;
-  int      rem_bits = 0;
-  state_ptr         = &state;
   /* Load the Integrity Key for SNOW3G initialization as in section 4.4. */
   for (i = 0; i < 4; i++)
     K[3 - i] = (key[4 * i] << 24) ^ (key[4 * i + 1] << 16) ^ (key[4 * i + 2] << 8) ^ (key[4 * i + 3]);
@@ -507,62 +588,12 @@ uint8_t* s3g_f9(const uint8_t* key, uint32_t count, uint32_t fresh, uint32_t dir
   IV[1] = count ^ (dir << 31);
   IV[0] = fresh ^ (dir << 15);
 
-  z[0] = z[1] = z[2] = z[3] = z[4] = 0;
-
   /* Run SNOW 3G to produce 5 keystream words z_1, z_2, z_3, z_4 and z_5. */
-  s3g_initialize(state_ptr, K, IV);
-  s3g_generate_keystream(state_ptr, 5, z);
-  s3g_deinitialize(state_ptr);
-  P = (uint64_t)z[0] << 32 | (uint64_t)z[1];
-  Q = (uint64_t)z[2] << 32 | (uint64_t)z[3];
-
-  /* Calculation */
-  if ((length % 64) == 0)
-    D = (length >> 6) + 1;
-  else
-    D = (length >> 6) + 2;
-  EVAL = 0;
-  c    = 0x1b;
+  s3g_initialize(&state, K, IV);
+  s3g_generate_keystream(&state, 5, z);
+  s3g_deinitialize(&state);
 
-  /* for 0 <= i <= D-3 */
-  for (i = 0; i < D - 2; i++) {
-    V    = EVAL ^ ((uint64_t)data[8 * i] << 56 | (uint64_t)data[8 * i + 1] << 48 | (uint64_t)data[8 * i + 2] << 40 |
-                (uint64_t)data[8 * i + 3] << 32 | (uint64_t)data[8 * i + 4] << 24 | (uint64_t)data[8 * i + 5] << 16 |
-                (uint64_t)data[8 * i + 6] << 8 | (uint64_t)data[8 * i + 7]);
-    EVAL = s3g_MUL64(V, P, c);
-  }
-
-  /* for D-2 */
-  rem_bits = length % 64;
-  if (rem_bits == 0)
-    rem_bits = 64;
-
-  M_D_2 = 0;
-  i     = 0;
-  while (rem_bits > 7) {
-    M_D_2 |= (uint64_t)data[8 * (D - 2) + i] << (8 * (7 - i));
-    rem_bits -= 8;
-    i++;
-  }
-  if (rem_bits > 0)
-    M_D_2 |= (uint64_t)(data[8 * (D - 2) + i] & mask8bit(rem_bits)) << (8 * (7 - i));
-
-  V    = EVAL ^ M_D_2;
-  EVAL = s3g_MUL64(V, P, c);
-
-  /* for D-1 */
-  EVAL ^= length;
-
-  /* Multiply by Q */
-  EVAL = s3g_MUL64(EVAL, Q, c);
-
-  /* XOR with z_5: this is a modification to the reference C code,
-     which forgot to XOR z[5] */
-  for (i = 0; i < 4; i++)
-    /*
-    MAC_I[i] = (mac32 >> (8*(3-i))) & 0xff;
-    */
-    MAC_I[i] = ((EVAL >> (56 - (i * 8))) ^ (z[4] >> (24 - (i * 8)))) & 0xff;
+  s3g_f9_eval(z, data, length, MAC_I);
 
   return MAC_I;
-}
\ No newline at end of file
+}
@@ -816,7 +816,8 @@ uint8_t security_128_eia1(const uint8_t* key,
                           uint32_t       msg_len,
                           uint8_t*       mac)
 {
-  return liblte_security_128_eia1(key, count, bearer, direction, msg, msg_len, mac);
+  security_batch_pdu_t pdu = {key, count, (uint8_t)bearer, direction, msg, msg_len, mac};
+  return security_128_eia1_batch(&pdu, 1);
 }
 
 uint8_t security_128_eia2(const uint8_t* key,
@@ -838,7 +839,8 @@ uint8_t security_128_eia3(const uint8_t* key,
                           uint32_t       msg_len,
                           uint8_t*       mac)
 {
-  return liblte_security_128_eia3(key, count, bearer, direction, msg, msg_len * 8, mac);
+  security_batch_pdu_t pdu = {key, count, (uint8_t)bearer, direction, msg, msg_len, mac};
+  return security_128_eia3_batch(&pdu, 1);
 }
 
 uint8_t security_md5(const uint8_t* input, size_t len, uint8_t* output)
@@ -860,7 +862,8 @@ uint8_t security_128_eea1(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out)
 {
-  return liblte_security_encryption_eea1(key, count, bearer, direction, msg, msg_len * 8, msg_out);
+  security_batch_pdu_t pdu = {key, count, bearer, direction, msg, msg_len, msg_out};
+  return security_128_eea1_batch(&pdu, 1);
 }
 
 uint8_t security_128_eea2(uint8_t* key,
@@ -882,7 +885,8 @@ uint8_t security_128_eea3(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out)
 {
-  return liblte_security_encryption_eea3(key, count, bearer, direction, msg, msg_len * 8, msg_out);
+  security_batch_pdu_t pdu = {key, count, bearer, direction, msg, msg_len, msg_out};
+  return security_128_eea3_batch(&pdu, 1);
 }
 
 /******************************************************************************
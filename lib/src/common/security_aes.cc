@@ -0,0 +1,451 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/security.h"
+#include "srsran/common/ssl.h"
+#include "srsran/config.h"
+#include <algorithm>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <wmmintrin.h>
+#define HAVE_AES_NI
+#elif defined(IS_ARM) && defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO)
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#define HAVE_ARMV8_CE
+#endif
+
+namespace srsran {
+
+/******************************************************************************
+ * AES-128 key schedule (FIPS-197, Section 5.2)
+ *****************************************************************************/
+
+static const uint8_t aes_sbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76, 0xca, 0x82, 0xc9,
+    0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0, 0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f,
+    0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15, 0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07,
+    0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75, 0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3,
+    0x29, 0xe3, 0x2f, 0x84, 0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58,
+    0xcf, 0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8, 0x51, 0xa3,
+    0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2, 0xcd, 0x0c, 0x13, 0xec, 0x5f,
+    0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73, 0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88,
+    0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb, 0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac,
+    0x62, 0x91, 0x95, 0xe4, 0x79, 0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a,
+    0xae, 0x08, 0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a, 0x70,
+    0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e, 0xe1, 0xf8, 0x98, 0x11,
+    0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf, 0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42,
+    0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16};
+
+static void aes128_expand_key(const uint8_t* key, uint8_t rk[11][16])
+{
+  static const uint8_t rcon[10] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36};
+
+  memcpy(rk[0], key, 16);
+  for (uint32_t r = 1; r < 11; ++r) {
+    const uint8_t* prev = rk[r - 1];
+    uint8_t*       cur  = rk[r];
+    // RotWord + SubWord + Rcon on the last word of the previous round key
+    cur[0] = prev[0] ^ aes_sbox[prev[13]] ^ rcon[r - 1];
+    cur[1] = prev[1] ^ aes_sbox[prev[14]];
+    cur[2] = prev[2] ^ aes_sbox[prev[15]];
+    cur[3] = prev[3] ^ aes_sbox[prev[12]];
+    for (uint32_t i = 4; i < 16; ++i) {
+      cur[i] = prev[i] ^ cur[i - 4];
+    }
+  }
+}
+
+/******************************************************************************
+ * AES backends
+ *
+ * Each backend provides the AES-CTR keystream XOR of 128-EEA2 and the CBC-MAC chain of the 128-EIA2 CMAC
+ *****************************************************************************/
+
+struct security_aes128_key::impl {
+  using ctr_func_t   = void (*)(const impl&, const uint8_t nonce[8], const uint8_t*, uint32_t, uint8_t*);
+  using chain_func_t = void (*)(const impl&, uint8_t t[16], const uint8_t* blocks, uint32_t nof_blocks);
+
+  alignas(16) uint8_t rk[11][16];
+  aes_context  sw_ctx;
+  uint8_t      k1[16];
+  uint8_t      k2[16];
+  ctr_func_t   ctr   = nullptr;
+  chain_func_t chain = nullptr;
+  bool         is_hw = false;
+
+  impl() { aes_init(&sw_ctx); }
+  ~impl() { aes_free(&sw_ctx); }
+};
+
+/// Writes the counter block of 128-EEA2: 64-bit nonce followed by the 64-bit big-endian block counter
+static inline void aes_ctr_block(const uint8_t nonce[8], uint64_t ctr, uint8_t block[16])
+{
+  memcpy(block, nonce, 8);
+  for (uint32_t i = 0; i < 8; ++i) {
+    block[15 - i] = (ctr >> (8 * i)) & 0xff;
+  }
+}
+
+static void sw_ctr(const security_aes128_key::impl& k,
+                   const uint8_t                    nonce[8],
+                   const uint8_t*                   in,
+                   uint32_t                         len,
+                   uint8_t*                         out)
+{
+  aes_context* ctx = const_cast<aes_context*>(&k.sw_ctx);
+  uint8_t      ctr_blk[16], stream_blk[16];
+  for (uint64_t ctr = 0; len > 0; ++ctr) {
+    uint32_t n = std::min(len, 16u);
+    aes_ctr_block(nonce, ctr, ctr_blk);
+    aes_crypt_ecb(ctx, AES_ENCRYPT, ctr_blk, stream_blk);
+    for (uint32_t i = 0; i < n; ++i) {
+      out[i] = in[i] ^ stream_blk[i];
+    }
+    in += n;
+    out += n;
+    len -= n;
+  }
+}
+
+static void sw_chain(const security_aes128_key::impl& k, uint8_t t[16], const uint8_t* blocks, uint32_t nof_blocks)
+{
+  aes_context* ctx = const_cast<aes_context*>(&k.sw_ctx);
+  uint8_t      tmp[16];
+  for (uint32_t b = 0; b < nof_blocks; ++b, blocks += 16) {
+    for (uint32_t i = 0; i < 16; ++i) {
+      tmp[i] = t[i] ^ blocks[i];
+    }
+    aes_crypt_ecb(ctx, AES_ENCRYPT, tmp, t);
+  }
+}
+
+#ifdef HAVE_AES_NI
+
+static bool aes_hw_supported()
+{
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  return __get_cpuid(1, &eax, &ebx, &ecx, &edx) and (ecx & bit_AES) and (edx & bit_SSE2);
+}
+
+static const char* aes_hw_name = "AES-NI";
+
+#define AES_NI_TARGET __attribute__((target("aes,sse2")))
+
+AES_NI_TARGET static inline __m128i aesni_encrypt(const __m128i rk[11], __m128i x)
+{
+  x = _mm_xor_si128(x, rk[0]);
+  for (uint32_t r = 1; r < 10; ++r) {
+    x = _mm_aesenc_si128(x, rk[r]);
+  }
+  return _mm_aesenclast_si128(x, rk[10]);
+}
+
+AES_NI_TARGET static void
+aesni_ctr(const security_aes128_key::impl& k, const uint8_t nonce[8], const uint8_t* in, uint32_t len, uint8_t* out)
+{
+  __m128i rk[11];
+  for (uint32_t r = 0; r < 11; ++r) {
+    rk[r] = _mm_load_si128((const __m128i*)k.rk[r]);
+  }
+  int64_t nonce_le;
+  memcpy(&nonce_le, nonce, 8);
+
+  // 4 independent blocks per iteration, to hide the latency of the AES rounds
+  uint64_t ctr = 0;
+  for (; len >= 64; len -= 64, in += 64, out += 64, ctr += 4) {
+    __m128i b0 = _mm_set_epi64x(__builtin_bswap64(ctr), nonce_le);
+    __m128i b1 = _mm_set_epi64x(__builtin_bswap64(ctr + 1), nonce_le);
+    __m128i b2 = _mm_set_epi64x(__builtin_bswap64(ctr + 2), nonce_le);
+    __m128i b3 = _mm_set_epi64x(__builtin_bswap64(ctr + 3), nonce_le);
+    b0         = _mm_xor_si128(b0, rk[0]);
+    b1         = _mm_xor_si128(b1, rk[0]);
+    b2         = _mm_xor_si128(b2, rk[0]);
+    b3         = _mm_xor_si128(b3, rk[0]);
+    for (uint32_t r = 1; r < 10; ++r) {
+      b0 = _mm_aesenc_si128(b0, rk[r]);
+      b1 = _mm_aesenc_si128(b1, rk[r]);
+      b2 = _mm_aesenc_si128(b2, rk[r]);
+      b3 = _mm_aesenc_si128(b3, rk[r]);
+    }
+    b0 = _mm_aesenclast_si128(b0, rk[10]);
+    b1 = _mm_aesenclast_si128(b1, rk[10]);
+    b2 = _mm_aesenclast_si128(b2, rk[10]);
+    b3 = _mm_aesenclast_si128(b3, rk[10]);
+    _mm_storeu_si128((__m128i*)out, _mm_xor_si128(b0, _mm_loadu_si128((const __m128i*)in)));
+    _mm_storeu_si128((__m128i*)(out + 16), _mm_xor_si128(b1, _mm_loadu_si128((const __m128i*)(in + 16))));
+    _mm_storeu_si128((__m128i*)(out + 32), _mm_xor_si128(b2, _mm_loadu_si128((const __m128i*)(in + 32))));
+    _mm_storeu_si128((__m128i*)(out + 48), _mm_xor_si128(b3, _mm_loadu_si128((const __m128i*)(in + 48))));
+  }
+  for (; len > 0; ++ctr) {
+    __m128i ks = aesni_encrypt(rk, _mm_set_epi64x(__builtin_bswap64(ctr), nonce_le));
+    if (len >= 16) {
+      _mm_storeu_si128((__m128i*)out, _mm_xor_si128(ks, _mm_loadu_si128((const __m128i*)in)));
+      len -= 16;
+      in += 16;
+      out += 16;
+    } else {
+      alignas(16) uint8_t stream_blk[16];
+      _mm_store_si128((__m128i*)stream_blk, ks);
+      for (uint32_t i = 0; i < len; ++i) {
+        out[i] = in[i] ^ stream_blk[i];
+      }
+      len = 0;
+    }
+  }
+}
+
+AES_NI_TARGET static void
+aesni_chain(const security_aes128_key::impl& k, uint8_t t[16], const uint8_t* blocks, uint32_t nof_blocks)
+{
+  __m128i rk[11];
+  for (uint32_t r = 0; r < 11; ++r) {
+    rk[r] = _mm_load_si128((const __m128i*)k.rk[r]);
+  }
+  __m128i x = _mm_loadu_si128((const __m128i*)t);
+  for (uint32_t b = 0; b < nof_blocks; ++b, blocks += 16) {
+    x = aesni_encrypt(rk, _mm_xor_si128(x, _mm_loadu_si128((const __m128i*)blocks)));
+  }
+  _mm_storeu_si128((__m128i*)t, x);
+}
+
+static const security_aes128_key::impl::ctr_func_t   aes_hw_ctr   = aesni_ctr;
+static const security_aes128_key::impl::chain_func_t aes_hw_chain = aesni_chain;
+
+#elif defined(HAVE_ARMV8_CE)
+
+static bool aes_hw_supported()
+{
+  return getauxval(AT_HWCAP) & HWCAP_AES;
+}
+
+static const char* aes_hw_name = "ARMv8-CE";
+
+static inline uint8x16_t armv8_encrypt(const uint8x16_t rk[11], uint8x16_t x)
+{
+  for (uint32_t r = 0; r < 9; ++r) {
+    x = vaesmcq_u8(vaeseq_u8(x, rk[r]));
+  }
+  return veorq_u8(vaeseq_u8(x, rk[9]), rk[10]);
+}
+
+static void
+armv8_ctr(const security_aes128_key::impl& k, const uint8_t nonce[8], const uint8_t* in, uint32_t len, uint8_t* out)
+{
+  uint8x16_t rk[11];
+  for (uint32_t r = 0; r < 11; ++r) {
+    rk[r] = vld1q_u8(k.rk[r]);
+  }
+  uint8_t ctr_blk[16];
+  for (uint64_t ctr = 0; len > 0; ++ctr) {
+    aes_ctr_block(nonce, ctr, ctr_blk);
+    uint8x16_t ks = armv8_encrypt(rk, vld1q_u8(ctr_blk));
+    if (len >= 16) {
+      vst1q_u8(out, veorq_u8(ks, vld1q_u8(in)));
+      len -= 16;
+      in += 16;
+      out += 16;
+    } else {
+      uint8_t stream_blk[16];
+      vst1q_u8(stream_blk, ks);
+      for (uint32_t i = 0; i < len; ++i) {
+        out[i] = in[i] ^ stream_blk[i];
+      }
+      len = 0;
+    }
+  }
+}
+
+static void armv8_chain(const security_aes128_key::impl& k, uint8_t t[16], const uint8_t* blocks, uint32_t nof_blocks)
+{
+  uint8x16_t rk[11];
+  for (uint32_t r = 0; r < 11; ++r) {
+    rk[r] = vld1q_u8(k.rk[r]);
+  }
+  uint8x16_t x = vld1q_u8(t);
+  for (uint32_t b = 0; b < nof_blocks; ++b, blocks += 16) {
+    x = armv8_encrypt(rk, veorq_u8(x, vld1q_u8(blocks)));
+  }
+  vst1q_u8(t, x);
+}
+
+static const security_aes128_key::impl::ctr_func_t   aes_hw_ctr   = armv8_ctr;
+static const security_aes128_key::impl::chain_func_t aes_hw_chain = armv8_chain;
+
+#else
+
+static bool aes_hw_supported()
+{
+  return false;
+}
+
+static const char*                                   aes_hw_name  = "software";
+static const security_aes128_key::impl::ctr_func_t   aes_hw_ctr   = sw_ctr;
+static const security_aes128_key::impl::chain_func_t aes_hw_chain = sw_chain;
+
+#endif
+
+static bool aes_use_hw()
+{
+  static const bool supported = aes_hw_supported();
+  return supported;
+}
+
+const char* security_aes_backend()
+{
+  return aes_use_hw() ? aes_hw_name : "software";
+}
+
+/******************************************************************************
+ * Precomputed AES-128 keys
+ *****************************************************************************/
+
+security_aes128_key::security_aes128_key() = default;
+
+security_aes128_key::~security_aes128_key() = default;
+
+/// CMAC subkey generation (RFC 4493, Section 2.3)
+static void cmac_subkey_shift(const uint8_t in[16], uint8_t out[16])
+{
+  for (uint32_t i = 0; i < 15; ++i) {
+    out[i] = (in[i] << 1) | (in[i + 1] >> 7);
+  }
+  out[15] = (in[15] << 1) ^ ((in[0] & 0x80) ? 0x87 : 0);
+}
+
+void security_aes128_key::set_key(const uint8_t* key, bool use_hw)
+{
+  if (pimpl == nullptr) {
+    pimpl.reset(new impl);
+  }
+  aes128_expand_key(key, pimpl->rk);
+  aes_setkey_enc(&pimpl->sw_ctx, key, 128);
+  pimpl->is_hw = use_hw and aes_use_hw();
+  pimpl->ctr   = pimpl->is_hw ? aes_hw_ctr : sw_ctr;
+  pimpl->chain = pimpl->is_hw ? aes_hw_chain : sw_chain;
+
+  uint8_t l[16] = {};
+  pimpl->chain(*pimpl, l, l, 1);
+  cmac_subkey_shift(l, pimpl->k1);
+  cmac_subkey_shift(pimpl->k1, pimpl->k2);
+}
+
+bool security_aes128_key::is_hw_accelerated() const
+{
+  return pimpl != nullptr and pimpl->is_hw;
+}
+
+/*********************************************************************
+    Name: security_128_eia2
+
+    Description: 128-bit integrity algorithm EIA2, with a precomputed key.
+
+    Document Reference: 33.401 v10.0.0 Annex B.2.3
+                        RFC4493
+*********************************************************************/
+uint8_t security_128_eia2(const security_aes128_key& key,
+                          uint32_t                   count,
+                          uint32_t                   bearer,
+                          uint8_t                    direction,
+                          const uint8_t*             msg,
+                          uint32_t                   msg_len,
+                          uint8_t*                   mac)
+{
+  if (not key.is_set() or (msg == nullptr and msg_len > 0) or mac == nullptr) {
+    return SRSRAN_ERROR;
+  }
+  const security_aes128_key::impl& k = *key.pimpl;
+
+  // The MAC input is M = COUNT | BEARER | DIRECTION | 0...0 (64 bits) | MESSAGE. Its full blocks are taken from the
+  // message without copying it
+  uint8_t block[16] = {};
+  block[0]          = (count >> 24) & 0xff;
+  block[1]          = (count >> 16) & 0xff;
+  block[2]          = (count >> 8) & 0xff;
+  block[3]          = count & 0xff;
+  block[4]          = ((bearer & 0x1f) << 3) | ((direction & 0x01) << 2);
+  uint32_t total_len  = msg_len + 8;
+  uint32_t nof_blocks = (total_len + 15) / 16;
+
+  uint8_t t[16] = {};
+  if (nof_blocks > 1) {
+    memcpy(&block[8], msg, 8);
+    k.chain(k, t, block, 1);
+    k.chain(k, t, msg + 8, nof_blocks - 2);
+  }
+
+  // Last block, with K1 if it is complete or padded and with K2 otherwise
+  uint32_t last_offset = (nof_blocks - 1) * 16;
+  uint32_t last_len    = total_len - last_offset;
+  if (nof_blocks > 1) {
+    memset(block, 0, sizeof(block));
+    memcpy(block, msg + last_offset - 8, last_len);
+  } else if (msg_len > 0) {
+    memcpy(&block[8], msg, msg_len);
+  }
+  const uint8_t* subkey = k.k1;
+  if (last_len < 16) {
+    block[last_len] = 0x80;
+    subkey          = k.k2;
+  }
+  for (uint32_t i = 0; i < 16; ++i) {
+    block[i] ^= subkey[i];
+  }
+  k.chain(k, t, block, 1);
+
+  memcpy(mac, t, 4);
+  return SRSRAN_SUCCESS;
+}
+
+/*********************************************************************
+    Name: security_128_eea2
+
+    Description: 128-bit encryption algorithm EEA2, with a precomputed key.
+
+    Document Reference: 33.401 v13.1.0 Annex B.1.3
+*********************************************************************/
+uint8_t security_128_eea2(const security_aes128_key& key,
+                          uint32_t                   count,
+                          uint8_t                    bearer,
+                          uint8_t                    direction,
+                          const uint8_t*             msg,
+                          uint32_t                   msg_len,
+                          uint8_t*                   msg_out)
+{
+  if (not key.is_set() or msg == nullptr or msg_out == nullptr) {
+    return SRSRAN_ERROR;
+  }
+  const security_aes128_key::impl& k = *key.pimpl;
+
+  uint8_t nonce[8] = {};
+  nonce[0]         = (count >> 24) & 0xff;
+  nonce[1]         = (count >> 16) & 0xff;
+  nonce[2]         = (count >> 8) & 0xff;
+  nonce[3]         = count & 0xff;
+  nonce[4]         = ((bearer & 0x1f) << 3) | ((direction & 0x01) << 2);
+  k.ctr(k, nonce, msg, msg_len, msg_out);
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsran
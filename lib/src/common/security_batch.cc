@@ -0,0 +1,334 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/s3g.h"
+#include "srsran/common/security.h"
+#include "srsran/common/zuc.h"
+#include "srsran/config.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <string.h>
+
+namespace srsran {
+
+namespace {
+
+static_assert(S3G_MAX_LANES == ZUC_MAX_LANES, "SNOW 3G and ZUC batches use the same number of lanes");
+
+/// Maximum number of PDUs whose keystream is generated in lockstep
+const uint32_t max_lanes = S3G_MAX_LANES;
+
+/// Keystream words generated per lane between two passes over the PDUs
+const uint32_t ks_chunk_words = 64;
+
+uint32_t load_be32(const uint8_t* p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/// Loads the word of a byte-aligned message that starts at byte offset, with the bytes past msg_len set to zero
+uint32_t load_be32_padded(const uint8_t* msg, uint32_t msg_len, uint32_t offset)
+{
+  if (offset + 4 <= msg_len) {
+    return load_be32(msg + offset);
+  }
+  uint32_t word = 0;
+  for (uint32_t i = 0; i < 4; i++) {
+    word = (word << 8) | (offset + i < msg_len ? msg[offset + i] : 0);
+  }
+  return word;
+}
+
+/// XORs nof_words keystream words into the message, starting at byte offset
+void xor_keystream(const security_batch_pdu_t& pdu, const uint32_t* ks, uint32_t offset, uint32_t nof_words)
+{
+  uint32_t end = std::min(pdu.msg_len, offset + nof_words * 4);
+  uint32_t i   = offset;
+  for (; i + 4 <= end; i += 4, ks++) {
+    uint32_t word;
+    memcpy(&word, pdu.msg + i, sizeof(word));
+    word ^= htonl(*ks);
+    memcpy(pdu.out + i, &word, sizeof(word));
+  }
+  for (uint32_t shift = 24; i < end; i++, shift -= 8) {
+    pdu.out[i] = pdu.msg[i] ^ ((*ks >> shift) & 0xff);
+  }
+}
+
+/// Contribution of a 32-bit message word to the 128-EIA3 tag, given the keystream words z_i and z_(i+1) it spans
+uint32_t eia3_word(uint32_t msg_word, uint64_t ks_window)
+{
+  uint32_t t = 0;
+  for (uint32_t b = 0; b < 32; b++) {
+    uint32_t mask = 0u - ((msg_word >> (31 - b)) & 1u);
+    t ^= (uint32_t)(ks_window >> (32 - b)) & mask;
+  }
+  return t;
+}
+
+/// SNOW 3G keystream generator, with the IV of 128-EEA1 (33.401 Annex B.1.2) or of 128-EIA1 (33.401 Annex B.2.2)
+template <bool integrity>
+struct snow3g_engine {
+  using state_t = S3G_STATE;
+
+  static uint32_t nof_words(const security_batch_pdu_t& pdu) { return integrity ? 5 : (pdu.msg_len + 3) / 4; }
+
+  static void initialize(state_t* state[], const security_batch_pdu_t* const pdus[], uint32_t nof_lanes)
+  {
+    uint32_t k[max_lanes][4];
+    uint32_t iv[max_lanes][4];
+    for (uint32_t l = 0; l < nof_lanes; l++) {
+      const security_batch_pdu_t& pdu = *pdus[l];
+      for (uint32_t i = 0; i < 4; i++) {
+        k[l][3 - i] = load_be32(pdu.key + 4 * i);
+      }
+      if (integrity) {
+        uint32_t fresh = (uint32_t)pdu.bearer << 27;
+        iv[l][3]       = pdu.count;
+        iv[l][2]       = fresh;
+        iv[l][1]       = pdu.count ^ ((uint32_t)pdu.direction << 31);
+        iv[l][0]       = fresh ^ ((uint32_t)pdu.direction << 15);
+      } else {
+        iv[l][3] = pdu.count;
+        iv[l][2] = ((pdu.bearer & 0x1f) << 27) | ((pdu.direction & 0x01) << 26);
+        iv[l][1] = iv[l][3];
+        iv[l][0] = iv[l][2];
+      }
+    }
+    s3g_initialize_lanes(state, nof_lanes, k, iv);
+  }
+
+  static void generate(state_t* state[], uint32_t nof_lanes, uint32_t n, uint32_t* ks[])
+  {
+    s3g_generate_keystream_lanes(state, nof_lanes, n, ks);
+  }
+};
+
+/// ZUC keystream generator, with the IV of 128-EEA3 (33.401 Annex B.1.4) or of 128-EIA3 (33.401 Annex B.2.4)
+template <bool integrity>
+struct zuc_engine {
+  using state_t = zuc_state_t;
+
+  static uint32_t nof_words(const security_batch_pdu_t& pdu)
+  {
+    return integrity ? (pdu.msg_len * 8 + 64 + 31) / 32 : (pdu.msg_len + 3) / 4;
+  }
+
+  static void initialize(state_t* state[], const security_batch_pdu_t* const pdus[], uint32_t nof_lanes)
+  {
+    uint8_t   iv[max_lanes][16];
+    const u8* keys[max_lanes];
+    const u8* ivs[max_lanes];
+    for (uint32_t l = 0; l < nof_lanes; l++) {
+      const security_batch_pdu_t& pdu = *pdus[l];
+      uint8_t*                    v   = iv[l];
+      v[0]                            = (pdu.count >> 24) & 0xff;
+      v[1]                            = (pdu.count >> 16) & 0xff;
+      v[2]                            = (pdu.count >> 8) & 0xff;
+      v[3]                            = pdu.count & 0xff;
+      v[5] = v[6] = v[7] = 0;
+      if (integrity) {
+        v[4]  = (pdu.bearer << 3) & 0xf8;
+        v[8]  = v[0] ^ ((pdu.direction & 1) << 7);
+        v[14] = (pdu.direction & 1) << 7;
+      } else {
+        v[4]  = ((pdu.bearer & 0x1f) << 3) | ((pdu.direction & 0x01) << 2);
+        v[8]  = v[0];
+        v[14] = 0;
+      }
+      v[9]    = v[1];
+      v[10]   = v[2];
+      v[11]   = v[3];
+      v[12]   = v[4];
+      v[13]   = 0;
+      v[15]   = 0;
+      keys[l] = pdu.key;
+      ivs[l]  = v;
+    }
+    zuc_initialize_lanes(state, nof_lanes, keys, ivs);
+  }
+
+  static void generate(state_t* state[], uint32_t nof_lanes, uint32_t n, uint32_t* ks[])
+  {
+    zuc_generate_keystream_lanes(state, nof_lanes, n, ks);
+  }
+};
+
+/**
+ * Runs the keystream generators of the PDUs in groups of max_lanes, in lockstep, and hands each chunk of keystream
+ * to consume(lane, pdu, ks, word_offset, nof_words). The keystream of a lane stops at Engine::nof_words(pdu), after
+ * which the remaining lanes of the group continue alone.
+ */
+template <typename Engine, typename Consumer>
+void keystream_batch(const security_batch_pdu_t* pdus, uint32_t nof_pdus, const Consumer& consume)
+{
+  typename Engine::state_t state[max_lanes];
+  uint32_t                 ks_buffer[max_lanes][ks_chunk_words];
+
+  for (uint32_t first = 0; first < nof_pdus; first += max_lanes) {
+    uint32_t                    nof_lanes = std::min(max_lanes, nof_pdus - first);
+    const security_batch_pdu_t* lane_pdus[max_lanes];
+    typename Engine::state_t*   lane_state[max_lanes];
+    uint32_t*                   lane_ks[max_lanes];
+    uint32_t                    lane_idx[max_lanes];
+    for (uint32_t l = 0; l < nof_lanes; l++) {
+      lane_pdus[l]  = &pdus[first + l];
+      lane_state[l] = &state[l];
+      lane_ks[l]    = ks_buffer[l];
+      lane_idx[l]   = l;
+    }
+    Engine::initialize(lane_state, lane_pdus, nof_lanes);
+
+    uint32_t offset = 0;
+    while (true) {
+      // Drop the lanes whose keystream is complete
+      uint32_t nof_active = 0;
+      uint32_t n          = ks_chunk_words;
+      for (uint32_t l = 0; l < nof_lanes; l++) {
+        uint32_t total = Engine::nof_words(*lane_pdus[l]);
+        if (total > offset) {
+          lane_pdus[nof_active]  = lane_pdus[l];
+          lane_state[nof_active] = lane_state[l];
+          lane_ks[nof_active]    = lane_ks[l];
+          lane_idx[nof_active]   = lane_idx[l];
+          n                      = std::min(n, total - offset);
+          nof_active++;
+        }
+      }
+      nof_lanes = nof_active;
+      if (nof_lanes == 0) {
+        break;
+      }
+
+      Engine::generate(lane_state, nof_lanes, n, lane_ks);
+      for (uint32_t l = 0; l < nof_lanes; l++) {
+        consume(lane_idx[l], *lane_pdus[l], lane_ks[l], offset, n);
+      }
+      offset += n;
+    }
+  }
+}
+
+bool valid_batch(const security_batch_pdu_t* pdus, uint32_t nof_pdus, bool integrity)
+{
+  for (uint32_t i = 0; i < nof_pdus; i++) {
+    const security_batch_pdu_t& pdu = pdus[i];
+    if (pdu.key == nullptr or (pdu.msg == nullptr and pdu.msg_len > 0) or
+        (pdu.out == nullptr and (integrity or pdu.msg_len > 0))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename Engine>
+uint8_t cipher_batch(const security_batch_pdu_t* pdus, uint32_t nof_pdus)
+{
+  if (not valid_batch(pdus, nof_pdus, false)) {
+    return SRSRAN_ERROR;
+  }
+  keystream_batch<Engine>(
+      pdus,
+      nof_pdus,
+      [](uint32_t lane, const security_batch_pdu_t& pdu, const uint32_t* ks, uint32_t word_offset, uint32_t n) {
+        xor_keystream(pdu, ks, word_offset * 4, n);
+      });
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace
+
+uint8_t security_128_eea1_batch(const security_batch_pdu_t* pdus, uint32_t nof_pdus)
+{
+  return cipher_batch<snow3g_engine<false> >(pdus, nof_pdus);
+}
+
+uint8_t security_128_eea3_batch(const security_batch_pdu_t* pdus, uint32_t nof_pdus)
+{
+  return cipher_batch<zuc_engine<false> >(pdus, nof_pdus);
+}
+
+uint8_t security_128_eia1_batch(const security_batch_pdu_t* pdus, uint32_t nof_pdus)
+{
+  if (not valid_batch(pdus, nof_pdus, true)) {
+    return SRSRAN_ERROR;
+  }
+  // The 5 keystream words z_1..z_5 come in a single chunk
+  keystream_batch<snow3g_engine<true> >(
+      pdus,
+      nof_pdus,
+      [](uint32_t lane, const security_batch_pdu_t& pdu, const uint32_t* ks, uint32_t word_offset, uint32_t n) {
+        s3g_f9_eval(ks, pdu.msg, (uint64_t)pdu.msg_len * 8, pdu.out);
+      });
+  return SRSRAN_SUCCESS;
+}
+
+uint8_t security_128_eia3_batch(const security_batch_pdu_t* pdus, uint32_t nof_pdus)
+{
+  if (not valid_batch(pdus, nof_pdus, true)) {
+    return SRSRAN_ERROR;
+  }
+
+  // Running tag of each lane, and the last keystream word of its previous chunk
+  struct eia3_lane {
+    uint32_t t;
+    uint32_t prev_ks;
+  } lanes[max_lanes];
+
+  // 33.401 Annex B.2.4 and EEA3/EIA3 specification, Section 3.4: the message word i, with the keystream window
+  // z_i|z_(i+1), is folded in once z_(i+1) has been generated
+  keystream_batch<zuc_engine<true> >(
+      pdus,
+      nof_pdus,
+      [&lanes](uint32_t lane, const security_batch_pdu_t& pdu, const uint32_t* ks, uint32_t word_offset, uint32_t n) {
+        eia3_lane& st           = lanes[lane];
+        uint32_t   nof_bits     = pdu.msg_len * 8;
+        uint32_t   nof_ks_words = (nof_bits + 64 + 31) / 32;
+        if (word_offset == 0) {
+          st.t = 0;
+        }
+        for (uint32_t j = 0; j < n; j++) {
+          uint32_t word_idx = word_offset + j;
+          if (word_idx > 0) {
+            uint32_t i      = word_idx - 1;
+            uint64_t window = ((uint64_t)st.prev_ks << 32) | ks[j];
+            if (i * 32 < nof_bits) {
+              st.t ^= eia3_word(load_be32_padded(pdu.msg, pdu.msg_len, i * 4), window);
+            }
+            if (i == nof_bits / 32) {
+              // z at bit position LENGTH
+              st.t ^= (uint32_t)(window >> (32 - nof_bits % 32));
+            }
+            if (word_idx == nof_ks_words - 1) {
+              uint32_t mac = st.t ^ ks[j];
+              pdu.out[0]   = (mac >> 24) & 0xff;
+              pdu.out[1]   = (mac >> 16) & 0xff;
+              pdu.out[2]   = (mac >> 8) & 0xff;
+              pdu.out[3]   = mac & 0xff;
+            }
+          }
+          st.prev_ks = ks[j];
+        }
+      });
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsran
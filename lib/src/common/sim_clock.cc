@@ -0,0 +1,60 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/sim_clock.h"
+#include <atomic>
+
+namespace srsran {
+
+namespace {
+
+std::atomic<bool>    virtual_time{false};
+std::atomic<int64_t> virtual_now_us{0};
+
+} // namespace
+
+sim_clock::time_point sim_clock::now()
+{
+  if (virtual_time.load(std::memory_order_relaxed)) {
+    return time_point(duration(virtual_now_us.load(std::memory_order_relaxed)));
+  }
+  return time_point(std::chrono::duration_cast<duration>(std::chrono::steady_clock::now().time_since_epoch()));
+}
+
+void sim_clock::enable_virtual_time()
+{
+  virtual_now_us.store(0);
+  virtual_time.store(true);
+}
+
+bool sim_clock::is_virtual_time()
+{
+  return virtual_time.load(std::memory_order_relaxed);
+}
+
+void sim_clock::advance_to(duration t)
+{
+  int64_t prev = virtual_now_us.load(std::memory_order_relaxed);
+  while (t.count() > prev && not virtual_now_us.compare_exchange_weak(prev, t.count(), std::memory_order_relaxed)) {
+  }
+}
+
+} // namespace srsran
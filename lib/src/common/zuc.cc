@@ -30,6 +30,8 @@
 ---------------------------------------------------------*/
 
 #include "srsran/common/zuc.h"
+#include <algorithm>
+#include <stdint.h>
 
 #define MAKEU32(a, b, c, d) (((u32)(a) << 24) | ((u32)(b) << 16) | ((u32)(c) << 8) | ((u32)(d)))
 #define MulByPow2(x, k) ((((x) << k) | ((x) >> (31 - k))) & 0x7FFFFFFF)
@@ -87,94 +89,6 @@ static const u32 EK_d[16] = {0x44D7,
                              0x789A,
                              0x47AC};
 
-/* ——————————————————————- */
-/* c = a + b mod (2^31 – 1) */
-u32 AddM(u32 a, u32 b)
-{
-  u32 c = a + b;
-  return (c & 0x7FFFFFFF) + (c >> 31);
-}
-
-/* LFSR with initialization mode */
-void LFSRWithInitialisationMode(zuc_state_t* state, u32 u)
-{
-  u32 f, v;
-  f = state->LFSR_S0;
-  v = MulByPow2(state->LFSR_S0, 8);
-  f = AddM(f, v);
-  v = MulByPow2(state->LFSR_S4, 20);
-  f = AddM(f, v);
-  v = MulByPow2(state->LFSR_S10, 21);
-  f = AddM(f, v);
-  v = MulByPow2(state->LFSR_S13, 17);
-  f = AddM(f, v);
-  v = MulByPow2(state->LFSR_S15, 15);
-  f = AddM(f, v);
-  f = AddM(f, u);
-
-  /* update the state */
-  state->LFSR_S0  = state->LFSR_S1;
-  state->LFSR_S1  = state->LFSR_S2;
-  state->LFSR_S2  = state->LFSR_S3;
-  state->LFSR_S3  = state->LFSR_S4;
-  state->LFSR_S4  = state->LFSR_S5;
-  state->LFSR_S5  = state->LFSR_S6;
-  state->LFSR_S6  = state->LFSR_S7;
-  state->LFSR_S7  = state->LFSR_S8;
-  state->LFSR_S8  = state->LFSR_S9;
-  state->LFSR_S9  = state->LFSR_S10;
-  state->LFSR_S10 = state->LFSR_S11;
-  state->LFSR_S11 = state->LFSR_S12;
-  state->LFSR_S12 = state->LFSR_S13;
-  state->LFSR_S13 = state->LFSR_S14;
-  state->LFSR_S14 = state->LFSR_S15;
-  state->LFSR_S15 = f;
-}
-
-/* LFSR with work mode */
-void LFSRWithWorkMode(zuc_state_t* state)
-{
-  u32 f, v;
-  f = state->LFSR_S0;
-  v = MulByPow2(state->LFSR_S0, 8);
-  f = AddM(f, v);
-  v = MulByPow2(state->LFSR_S4, 20);
-  f = AddM(f, v);
-  v = MulByPow2(state->LFSR_S10, 21);
-  f = AddM(f, v);
-  v = MulByPow2(state->LFSR_S13, 17);
-  f = AddM(f, v);
-  v = MulByPow2(state->LFSR_S15, 15);
-  f = AddM(f, v);
-
-  /* update the state */
-  state->LFSR_S0  = state->LFSR_S1;
-  state->LFSR_S1  = state->LFSR_S2;
-  state->LFSR_S2  = state->LFSR_S3;
-  state->LFSR_S3  = state->LFSR_S4;
-  state->LFSR_S4  = state->LFSR_S5;
-  state->LFSR_S5  = state->LFSR_S6;
-  state->LFSR_S6  = state->LFSR_S7;
-  state->LFSR_S7  = state->LFSR_S8;
-  state->LFSR_S8  = state->LFSR_S9;
-  state->LFSR_S9  = state->LFSR_S10;
-  state->LFSR_S10 = state->LFSR_S11;
-  state->LFSR_S11 = state->LFSR_S12;
-  state->LFSR_S12 = state->LFSR_S13;
-  state->LFSR_S13 = state->LFSR_S14;
-  state->LFSR_S14 = state->LFSR_S15;
-  state->LFSR_S15 = f;
-}
-
-/* BitReorganization */
-void BitReorganization(zuc_state_t* state)
-{
-  state->BRC_X0 = ((state->LFSR_S15 & 0x7FFF8000) << 1) | (state->LFSR_S14 & 0xFFFF);
-  state->BRC_X1 = ((state->LFSR_S11 & 0xFFFF) << 16) | (state->LFSR_S9 >> 15);
-  state->BRC_X2 = ((state->LFSR_S7 & 0xFFFF) << 16) | (state->LFSR_S5 >> 15);
-  state->BRC_X3 = ((state->LFSR_S2 & 0xFFFF) << 16) | (state->LFSR_S0 >> 15);
-}
-
 /* L1 */
 u32 L1(u32 X)
 {
@@ -187,68 +101,153 @@ u32 L2(u32 X)
   return (X ^ ROT(X, 8) ^ ROT(X, 14) ^ ROT(X, 22) ^ ROT(X, 30));
 }
 
-/* F */
-u32 F(zuc_state_t* state)
+/*
+ * The LFSR is kept as a ring buffer: at clock j, s_k is stored in LFSR_S[(j + k) % 16], so that clocking it only
+ * overwrites s_0 with s_16 instead of shifting the 16 registers.
+ */
+#define ZUC_S(k) (s[(j + (k)) & 15])
+
+/* BitReorganization, F and LFSR clocking. Returns W ^ X3, i.e. the keystream word in work mode */
+template <bool init_mode>
+static inline u32 zuc_clock(zuc_state_t* state, u32 j)
 {
-  u32 W, W1, W2, u, v;
-  W  = (state->BRC_X0 ^ state->F_R1) + state->F_R2;
-  W1 = state->F_R1 + state->BRC_X1;
-  W2 = state->F_R2 ^ state->BRC_X2;
-  u  = L1((W1 << 16) | (W2 >> 16));
-  v  = L2((W2 << 16) | (W1 >> 16));
+  u32* s = state->LFSR_S;
+
+  /* BitReorganization */
+  u32 X0 = ((ZUC_S(15) & 0x7FFF8000) << 1) | (ZUC_S(14) & 0xFFFF);
+  u32 X1 = ((ZUC_S(11) & 0xFFFF) << 16) | (ZUC_S(9) >> 15);
+  u32 X2 = ((ZUC_S(7) & 0xFFFF) << 16) | (ZUC_S(5) >> 15);
+  u32 X3 = ((ZUC_S(2) & 0xFFFF) << 16) | (ZUC_S(0) >> 15);
+
+  /* F */
+  u32 W  = (X0 ^ state->F_R1) + state->F_R2;
+  u32 W1 = state->F_R1 + X1;
+  u32 W2 = state->F_R2 ^ X2;
+  u32 u  = L1((W1 << 16) | (W2 >> 16));
+  u32 v  = L2((W2 << 16) | (W1 >> 16));
 
   state->F_R1 = MAKEU32(S0[u >> 24], S1[(u >> 16) & 0xFF], S0[(u >> 8) & 0xFF], S1[u & 0xFF]);
   state->F_R2 = MAKEU32(S0[v >> 24], S1[(v >> 16) & 0xFF], S0[(v >> 8) & 0xFF], S1[v & 0xFF]);
-  return W;
+
+  /* LFSR, with the additions mod (2^31 - 1) accumulated in 64 bits and reduced once */
+  uint64_t f = (uint64_t)ZUC_S(0) + MulByPow2(ZUC_S(0), 8) + MulByPow2(ZUC_S(4), 20) + MulByPow2(ZUC_S(10), 21) +
+               MulByPow2(ZUC_S(13), 17) + MulByPow2(ZUC_S(15), 15);
+  if (init_mode) {
+    f += W >> 1;
+  }
+  f        = (f & 0x7FFFFFFF) + (f >> 31);
+  f        = (f & 0x7FFFFFFF) + (f >> 31);
+  ZUC_S(0) = (u32)f;
+
+  return W ^ X3;
 }
 
-/* initialize */
+#undef ZUC_S
 
-void zuc_initialize(zuc_state_t* state, const u8* k, u8* iv)
+/* brings the LFSR ring buffer back to s_k in LFSR_S[k], after nof_clocks clocks */
+static inline void zuc_align_lfsr(zuc_state_t* state, u32 nof_clocks)
 {
-  u32 w, nCount;
+  std::rotate(state->LFSR_S, state->LFSR_S + (nof_clocks & 15), state->LFSR_S + 16);
+}
 
+template <u32 nof_lanes>
+static void zuc_initialize_lanes_impl(zuc_state_t* const state[], const u8* const k[], const u8* const iv[])
+{
   /* expand key */
-  state->LFSR_S0  = MAKEU31(k[0], EK_d[0], iv[0]);
-  state->LFSR_S1  = MAKEU31(k[1], EK_d[1], iv[1]);
-  state->LFSR_S2  = MAKEU31(k[2], EK_d[2], iv[2]);
-  state->LFSR_S3  = MAKEU31(k[3], EK_d[3], iv[3]);
-  state->LFSR_S4  = MAKEU31(k[4], EK_d[4], iv[4]);
-  state->LFSR_S5  = MAKEU31(k[5], EK_d[5], iv[5]);
-  state->LFSR_S6  = MAKEU31(k[6], EK_d[6], iv[6]);
-  state->LFSR_S7  = MAKEU31(k[7], EK_d[7], iv[7]);
-  state->LFSR_S8  = MAKEU31(k[8], EK_d[8], iv[8]);
-  state->LFSR_S9  = MAKEU31(k[9], EK_d[9], iv[9]);
-  state->LFSR_S10 = MAKEU31(k[10], EK_d[10], iv[10]);
-  state->LFSR_S11 = MAKEU31(k[11], EK_d[11], iv[11]);
-  state->LFSR_S12 = MAKEU31(k[12], EK_d[12], iv[12]);
-  state->LFSR_S13 = MAKEU31(k[13], EK_d[13], iv[13]);
-  state->LFSR_S14 = MAKEU31(k[14], EK_d[14], iv[14]);
-  state->LFSR_S15 = MAKEU31(k[15], EK_d[15], iv[15]);
-
-  /* set F_R1 and F_R2 to zero */
-  state->F_R1 = 0;
-  state->F_R2 = 0;
-  nCount      = 32;
-  while (nCount > 0) {
-    BitReorganization(state);
-    w = F(state);
-    LFSRWithInitialisationMode(state, w >> 1);
-    nCount--;
+  for (u32 l = 0; l < nof_lanes; l++) {
+    for (u32 i = 0; i < 16; i++) {
+      state[l]->LFSR_S[i] = MAKEU31(k[l][i], EK_d[i], iv[l][i]);
+    }
+    /* set F_R1 and F_R2 to zero */
+    state[l]->F_R1 = 0;
+    state[l]->F_R2 = 0;
   }
+
+  for (u32 j = 0; j < 32; j++) {
+    for (u32 l = 0; l < nof_lanes; l++) {
+      zuc_clock<true>(state[l], j);
+    }
+  }
+
+  /* discard the first output of F */
+  for (u32 l = 0; l < nof_lanes; l++) {
+    zuc_clock<false>(state[l], 32);
+    zuc_align_lfsr(state[l], 33);
+  }
+}
+
+template <u32 nof_lanes>
+static void zuc_generate_keystream_lanes_impl(zuc_state_t* const state[], int key_stream_len, u32* const p_keystream[])
+{
+  /* work on local copies, which the keystream stores cannot alias */
+  zuc_state_t local[nof_lanes];
+  for (u32 l = 0; l < nof_lanes; l++) {
+    local[l] = *state[l];
+  }
+  for (int j = 0; j < key_stream_len; j++) {
+    for (u32 l = 0; l < nof_lanes; l++) {
+      p_keystream[l][j] = zuc_clock<false>(&local[l], j);
+    }
+  }
+  for (u32 l = 0; l < nof_lanes; l++) {
+    zuc_align_lfsr(&local[l], key_stream_len);
+    *state[l] = local[l];
+  }
+}
+
+/* initialize */
+
+void zuc_initialize(zuc_state_t* state, const u8* k, u8* iv)
+{
+  zuc_state_t* states[] = {state};
+  const u8*    keys[]   = {k};
+  const u8*    ivs[]    = {iv};
+  zuc_initialize_lanes_impl<1>(states, keys, ivs);
 }
 
 void zuc_generate_keystream(zuc_state_t* state, int key_stream_len, u32* p_keystream)
 {
-  int i;
-  {
-    BitReorganization(state);
-    F(state); /* discard the output of F */
-    LFSRWithWorkMode(state);
+  zuc_state_t* states[] = {state};
+  u32*         out[]    = {p_keystream};
+  zuc_generate_keystream_lanes_impl<1>(states, key_stream_len, out);
+}
+
+void zuc_initialize_lanes(zuc_state_t* state[], u32 nof_lanes, const u8* const k[], const u8* const iv[])
+{
+  switch (nof_lanes) {
+    case 1:
+      zuc_initialize_lanes_impl<1>(state, k, iv);
+      break;
+    case 2:
+      zuc_initialize_lanes_impl<2>(state, k, iv);
+      break;
+    case 3:
+      zuc_initialize_lanes_impl<3>(state, k, iv);
+      break;
+    case 4:
+      zuc_initialize_lanes_impl<4>(state, k, iv);
+      break;
+    default:
+      break;
   }
-  for (i = 0; i < key_stream_len; i++) {
-    BitReorganization(state);
-    p_keystream[i] = F(state) ^ state->BRC_X3;
-    LFSRWithWorkMode(state);
+}
+
+void zuc_generate_keystream_lanes(zuc_state_t* state[], u32 nof_lanes, int key_stream_len, u32* p_keystream[])
+{
+  switch (nof_lanes) {
+    case 1:
+      zuc_generate_keystream_lanes_impl<1>(state, key_stream_len, p_keystream);
+      break;
+    case 2:
+      zuc_generate_keystream_lanes_impl<2>(state, key_stream_len, p_keystream);
+      break;
+    case 3:
+      zuc_generate_keystream_lanes_impl<3>(state, key_stream_len, p_keystream);
+      break;
+    case 4:
+      zuc_generate_keystream_lanes_impl<4>(state, key_stream_len, p_keystream);
+      break;
+    default:
+      break;
   }
 }
@@ -112,6 +112,18 @@ bool gtpu_write_header(gtpu_header_t* header, srsran::byte_buffer_t* pdu, srslog
   return true;
 }
 
+void gtpu_tx_header_template::init(uint32_t teid_out)
+{
+  // The E flag is only set when the PDCP PDU Number is present
+  hdr[0] = GTPU_FLAGS_VERSION_V1 | GTPU_FLAGS_GTP_PROTOCOL;
+  hdr[1] = GTPU_MSG_DATA_PDU;
+  uint32_to_uint8(teid_out, &hdr[4]);
+  // Sequence Number and N-PDU Number are not present, so they are zero
+  hdr[GTPU_EXTENDED_HEADER_LEN - 1] = GTPU_EXT_HEADER_PDCP_PDU_NUMBER;
+  hdr[GTPU_EXTENDED_HEADER_LEN]     = HEADER_PDCP_PDU_NUMBER_SIZE / 4;
+  hdr[GTPU_EXTENDED_HEADER_LEN + 3] = GTPU_EXT_NO_MORE_EXTENSION_HEADERS;
+}
+
 bool gtpu_read_ext_header(srsran::byte_buffer_t* pdu,
                           uint8_t**              ptr,
                           gtpu_header_t*         header,
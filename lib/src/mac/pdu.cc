@@ -239,6 +239,49 @@ void sch_pdu::parse_packet(uint8_t* ptr)
   }
 }
 
+void sch_pdu::init_(byte_buffer_t* buffer_tx_, uint32_t pdu_len_bytes, bool is_ulsch)
+{
+  tb_iov        = nullptr;
+  sdu_ref_bytes = 0;
+  sdu_refs.clear();
+  pdu::init_(buffer_tx_, pdu_len_bytes, is_ulsch);
+}
+
+void sch_pdu::init_tx_iov(byte_buffer_t* buffer, uint32_t pdu_len_bytes, srsran_sch_tb_iov_t* tb_iov_)
+{
+  init_tx(buffer, pdu_len_bytes, false);
+  tb_iov = tb_iov_;
+}
+
+void sch_pdu::add_sdu_ref(const_byte_span body)
+{
+  if (body.empty()) {
+    return;
+  }
+  sdu_refs.push_back({get_current_sdu_ptr(), body});
+  sdu_ref_bytes += body.size();
+}
+
+/* Fills the fragment list with the bytes written in the buffer, interleaved with the referenced SDU bodies */
+bool sch_pdu::write_iov(srslog::basic_logger& log)
+{
+  srsran_sch_tb_iov_reset(tb_iov);
+  const uint8_t* ptr = buffer_tx->msg;
+  for (const sdu_ref_t& ref : sdu_refs) {
+    if (srsran_sch_tb_iov_push(tb_iov, ptr, ref.insert_at - ptr) != SRSRAN_SUCCESS ||
+        srsran_sch_tb_iov_push(tb_iov, ref.body.data(), ref.body.size()) != SRSRAN_SUCCESS) {
+      log.error("Exceeded maximum number of MAC PDU fragments (%d)", SRSRAN_SCH_MAX_IOV);
+      return false;
+    }
+    ptr = ref.insert_at;
+  }
+  if (srsran_sch_tb_iov_push(tb_iov, ptr, &buffer_tx->msg[buffer_tx->N_bytes] - ptr) != SRSRAN_SUCCESS) {
+    log.error("Exceeded maximum number of MAC PDU fragments (%d)", SRSRAN_SCH_MAX_IOV);
+    return false;
+  }
+  return true;
+}
+
 uint8_t* sch_pdu::write_packet()
 {
   return write_packet(srslog::fetch_basic_logger("MAC"));
@@ -361,11 +404,11 @@ uint8_t* sch_pdu::write_packet(srslog::basic_logger& log)
             onetwo_padding,
             num_padding);
 
-  if (buffer_tx->N_bytes != pdu_len) {
+  if (buffer_tx->N_bytes + sdu_ref_bytes != pdu_len) {
     srsran::console("------------------------------\n");
     srsran::console("Wrote PDU: pdu_len=%d, expected_pdu_len=%d, header_and_ce=%d (%d+%d), nof_subh=%d, last_sdu=%d, "
                     "onepad=%d, multi=%d\n",
-                    buffer_tx->N_bytes,
+                    buffer_tx->N_bytes + sdu_ref_bytes,
                     pdu_len,
                     header_sz + ce_payload_sz,
                     header_sz,
@@ -379,7 +422,7 @@ uint8_t* sch_pdu::write_packet(srslog::basic_logger& log)
     log.error(
         "Wrote PDU: pdu_len=%d, expected_pdu_len=%d, header_and_ce=%d (%d+%d), nof_subh=%d, last_sdu=%d, onepad=%d, "
         "multi=%d",
-        buffer_tx->N_bytes,
+        buffer_tx->N_bytes + sdu_ref_bytes,
         pdu_len,
         header_sz + ce_payload_sz,
         header_sz,
@@ -400,6 +443,10 @@ uint8_t* sch_pdu::write_packet(srslog::basic_logger& log)
     return nullptr;
   }
 
+  if (tb_iov != nullptr && not write_iov(log)) {
+    return nullptr;
+  }
+
   return buffer_tx->msg;
 }
 
@@ -796,11 +843,14 @@ bool sch_subh::set_next_mch_sched_info(uint8_t lcid_, uint16_t mtch_stop)
 int sch_subh::set_sdu(uint32_t lcid_, uint32_t requested_bytes_, read_pdu_interface* sdu_itf_)
 {
   if (((sch_pdu*)parent)->has_space_sdu(requested_bytes_)) {
-    lcid    = lcid_;
-    payload = ((sch_pdu*)parent)->get_current_sdu_ptr();
+    sch_pdu* pdu = (sch_pdu*)parent;
+    lcid         = lcid_;
+    payload      = pdu->get_current_sdu_ptr();
 
-    // Copy data and get final number of bytes written to the MAC PDU
-    int sdu_sz = sdu_itf_->read_pdu(lcid, payload, requested_bytes_);
+    // Copy data (or get a reference to the SDU body) and get final number of bytes added to the MAC PDU
+    const_byte_span body;
+    int             sdu_sz = pdu->has_space_sdu_ref() ? sdu_itf_->read_pdu_sg(lcid, payload, requested_bytes_, body)
+                                                      : sdu_itf_->read_pdu(lcid, payload, requested_bytes_);
 
     if (sdu_sz < 0) {
       return SRSRAN_ERROR;
@@ -816,8 +866,9 @@ int sch_subh::set_sdu(uint32_t lcid_, uint32_t requested_bytes_, read_pdu_interf
       }
     }
 
-    ((sch_pdu*)parent)->update_space_sdu(nof_bytes);
-    ((sch_pdu*)parent)->add_sdu(nof_bytes);
+    pdu->update_space_sdu(nof_bytes);
+    pdu->add_sdu(nof_bytes - body.size());
+    pdu->add_sdu_ref(body);
 
     return nof_bytes;
   } else {
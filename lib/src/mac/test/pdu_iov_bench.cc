@@ -0,0 +1,254 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Benchmark of the DL transport block assembly and DL-SCH encoding, comparing the contiguous MAC PDU (RLC SDU bodies
+ * copied into the MAC buffer) against the scatter-gather MAC PDU (RLC SDU bodies referenced and gathered by the PHY).
+ */
+
+#include "srsran/common/interfaces_common.h"
+#include "srsran/mac/pdu.h"
+#include "srsran/srsran.h"
+#include <chrono>
+#include <getopt.h>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+
+using namespace srsran;
+
+static uint32_t nof_repetitions = 1000;
+static uint32_t mcs_idx         = 26;
+static uint32_t nof_prb         = 100;
+static uint32_t sdu_len         = 1500;
+
+// RLC stub with one large SDU per LCID, returned either copied or by reference after a 2-byte header
+class rlc_bench_dummy : public srsran::read_pdu_interface
+{
+public:
+  rlc_bench_dummy()
+  {
+    sdu.resize(sdu_len);
+    for (uint32_t i = 0; i < sdu_len; i++) {
+      sdu[i] = (uint8_t)i;
+    }
+  }
+
+  uint32_t read_pdu(uint32_t lcid, uint8_t* payload, uint32_t requested_bytes) override
+  {
+    const_byte_span body;
+    uint32_t        hdr_len = read_hdr(lcid, payload, requested_bytes, body);
+    memcpy(payload + hdr_len, body.data(), body.size());
+    return hdr_len + body.size();
+  }
+
+  uint32_t read_pdu_sg(uint32_t lcid, uint8_t* payload, uint32_t requested_bytes, const_byte_span& body) override
+  {
+    return read_hdr(lcid, payload, requested_bytes, body) + body.size();
+  }
+
+private:
+  uint32_t read_hdr(uint32_t lcid, uint8_t* payload, uint32_t requested_bytes, const_byte_span& body)
+  {
+    if (requested_bytes <= 2) {
+      body = {};
+      return 0;
+    }
+    payload[0] = 0x80 | lcid;
+    payload[1] = 0x00;
+    body       = const_byte_span{sdu.data(), std::min(sdu_len, requested_bytes - 2)};
+    return 2;
+  }
+
+  std::vector<uint8_t> sdu;
+};
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [nmps]\n", prog);
+  printf("\t-n number of repetitions [Default %d]\n", nof_repetitions);
+  printf("\t-m MCS index [Default %d]\n", mcs_idx);
+  printf("\t-p number of PRB [Default %d]\n", nof_prb);
+  printf("\t-s RLC SDU size in bytes [Default %d]\n", sdu_len);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nmps")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'm':
+        mcs_idx = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'p':
+        nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        sdu_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static uint64_t read_cycles()
+{
+#ifdef BENCH_HAVE_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+struct bench_result_t {
+  double   elapsed_us = 0.0;
+  uint64_t cycles     = 0;
+};
+
+// Assembles a MAC PDU filled with RLC SDUs for as many LCIDs as fit and encodes it
+static int assemble_and_encode(bool                  use_iov,
+                               sch_pdu&              pdu,
+                               byte_buffer_t&        buffer,
+                               srsran_sch_tb_iov_t&  tb_iov,
+                               rlc_bench_dummy&      rlc,
+                               srsran_sch_t&         sch,
+                               srsran_pdsch_cfg_t&   cfg,
+                               uint8_t*              e_bits,
+                               srslog::basic_logger& logger)
+{
+  uint32_t tbs_bytes = cfg.grant.tb[0].tbs / 8;
+  buffer.clear();
+  if (use_iov) {
+    pdu.init_tx_iov(&buffer, tbs_bytes, &tb_iov);
+  } else {
+    pdu.init_tx(&buffer, tbs_bytes, false);
+  }
+  for (uint32_t lcid = 1; lcid < 11 && pdu.rem_size() > 8; lcid++) {
+    if (not pdu.new_subh()) {
+      break;
+    }
+    if (pdu.get()->set_sdu(lcid, pdu.rem_size() - 3, &rlc) < 0) {
+      pdu.del_subh();
+      break;
+    }
+  }
+  uint8_t* data = pdu.write_packet(logger);
+  if (data == nullptr) {
+    return SRSRAN_ERROR;
+  }
+  if (use_iov) {
+    return srsran_dlsch_encode2_iov(&sch, &cfg, &tb_iov, e_bits, 0, 1);
+  }
+  return srsran_dlsch_encode2(&sch, &cfg, data, e_bits, 0, 1);
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  auto& logger = srslog::fetch_basic_logger("MAC", false);
+  logger.set_level(srslog::basic_levels::none);
+  srslog::init();
+
+  srsran_pdsch_cfg_t cfg   = {};
+  cfg.grant.nof_tb         = 1;
+  cfg.grant.tb[0].enabled  = true;
+  cfg.grant.tb[0].mcs_idx  = mcs_idx;
+  cfg.grant.tb[0].tbs      = srsran_ra_tbs_from_idx(srsran_ra_tbs_idx_from_mcs(mcs_idx, false, false), nof_prb);
+  cfg.grant.tb[0].mod      = srsran_ra_dl_mod_from_mcs(mcs_idx, false);
+  cfg.grant.tb[0].rv       = 0;
+  cfg.grant.nof_re         = nof_prb * SRSRAN_NRE * (2 * SRSRAN_CP_NORM_NSYMB - 3) - nof_prb * 8;
+  cfg.grant.tb[0].nof_bits = cfg.grant.nof_re * srsran_mod_bits_x_symbol(cfg.grant.tb[0].mod);
+
+  srsran_softbuffer_tx_t softbuffer = {};
+  if (srsran_softbuffer_tx_init(&softbuffer, nof_prb) < SRSRAN_SUCCESS) {
+    ERROR("Error initiating softbuffer");
+    return SRSRAN_ERROR;
+  }
+  cfg.softbuffers.tx[0] = &softbuffer;
+
+  srsran_sch_t sch = {};
+  if (srsran_sch_init(&sch) < SRSRAN_SUCCESS) {
+    ERROR("Error initiating SCH");
+    return SRSRAN_ERROR;
+  }
+
+  uint8_t* e_bits[2] = {srsran_vec_u8_malloc(cfg.grant.tb[0].nof_bits),
+                        srsran_vec_u8_malloc(cfg.grant.tb[0].nof_bits)};
+  if (e_bits[0] == nullptr || e_bits[1] == nullptr) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+
+  rlc_bench_dummy     rlc;
+  sch_pdu             pdu(20, logger);
+  byte_buffer_t       buffer;
+  srsran_sch_tb_iov_t tb_iov = {};
+
+  // Both paths must produce the same coded bits
+  for (uint32_t i = 0; i < 2; i++) {
+    if (assemble_and_encode(i == 1, pdu, buffer, tb_iov, rlc, sch, cfg, e_bits[i], logger) < SRSRAN_SUCCESS) {
+      ERROR("Error encoding TB");
+      return SRSRAN_ERROR;
+    }
+  }
+  if (memcmp(e_bits[0], e_bits[1], cfg.grant.tb[0].nof_bits) != 0) {
+    ERROR("Scatter-gather and contiguous encoded bits differ");
+    return SRSRAN_ERROR;
+  }
+
+  bench_result_t result[2] = {};
+  for (uint32_t i = 0; i < 2; i++) {
+    auto     t0 = std::chrono::steady_clock::now();
+    uint64_t c0 = read_cycles();
+    for (uint32_t n = 0; n < nof_repetitions; n++) {
+      assemble_and_encode(i == 1, pdu, buffer, tb_iov, rlc, sch, cfg, e_bits[i], logger);
+    }
+    result[i].cycles     = read_cycles() - c0;
+    result[i].elapsed_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  }
+
+  uint32_t tbs_bytes = cfg.grant.tb[0].tbs / 8;
+  printf("TBS=%d bytes; SDU=%d bytes; repetitions=%d\n", tbs_bytes, sdu_len, nof_repetitions);
+  for (uint32_t i = 0; i < 2; i++) {
+    double mbps = (double)cfg.grant.tb[0].tbs * nof_repetitions / result[i].elapsed_us;
+    printf("%-10s %8.2f us/TB; %9.2f Mbps", i == 0 ? "copy:" : "iov:", result[i].elapsed_us / nof_repetitions, mbps);
+    if (result[i].cycles > 0) {
+      printf("; %.3f bytes/cycle", (double)tbs_bytes * nof_repetitions / (double)result[i].cycles);
+    }
+    printf("\n");
+  }
+
+  srsran_sch_free(&sch);
+  srsran_softbuffer_tx_free(&softbuffer);
+  free(e_bits[0]);
+  free(e_bits[1]);
+
+  return SRSRAN_SUCCESS;
+}
@@ -860,6 +860,88 @@ int mac_sch_pdu_pack_test11()
   return SRSRAN_SUCCESS;
 }
 
+// Helper class that writes a 1 B header to the MAC PDU and provides the PDU body by reference
+class rlc_sg_dummy : public srsran::read_pdu_interface
+{
+public:
+  uint32_t read_pdu(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes) final
+  {
+    const_byte_span body;
+    uint32_t        len = read_pdu_sg(lcid, payload, nof_bytes, body);
+    memcpy(payload + len - body.size(), body.data(), body.size());
+    return len;
+  }
+
+  uint32_t read_pdu_sg(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes, const_byte_span& body) final
+  {
+    if (nof_bytes < 2) {
+      body = {};
+      return 0;
+    }
+    std::vector<uint8_t>& sdu = sdus[lcid];
+    sdu.resize(std::min(body_len, nof_bytes - 1));
+    for (uint32_t i = 0; i < sdu.size(); i++) {
+      sdu[i] = (uint8_t)(lcid + i);
+    }
+    payload[0] = 0xa0 | lcid;
+    body       = const_byte_span{sdu.data(), sdu.size()};
+    return 1 + sdu.size();
+  }
+
+  uint32_t body_len = 0;
+
+private:
+  std::map<uint32_t, std::vector<uint8_t> > sdus;
+};
+
+// Test that a MAC PDU built with referenced SDU bodies is described by a fragment list with the same content as the
+// contiguous MAC PDU
+int mac_sch_pdu_pack_iov_test()
+{
+  auto& mac_logger = srslog::fetch_basic_logger("MAC");
+
+  const uint32_t pdu_size = 500;
+  const uint32_t lcids[]  = {1, 3, 4};
+  for (uint32_t body_len : {8u, 100u, 150u}) {
+    rlc_sg_dummy rlc;
+    rlc.body_len = body_len;
+
+    // Contiguous MAC PDU
+    srsran::sch_pdu pdu(10, mac_logger);
+    byte_buffer_t   buffer;
+    pdu.init_tx(&buffer, pdu_size, false);
+    for (uint32_t lcid : lcids) {
+      TESTASSERT(pdu.new_subh());
+      TESTASSERT(pdu.get()->set_sdu(lcid, body_len + 1, &rlc) == (int)body_len + 1);
+    }
+    TESTASSERT(pdu.write_packet(mac_logger) == buffer.msg);
+    TESTASSERT(buffer.N_bytes == pdu_size);
+
+    // Same MAC PDU with the SDU bodies referenced
+    srsran::sch_pdu     pdu_iov(10, mac_logger);
+    byte_buffer_t       buffer_iov;
+    srsran_sch_tb_iov_t tb_iov = {};
+    pdu_iov.init_tx_iov(&buffer_iov, pdu_size, &tb_iov);
+    TESTASSERT(pdu_iov.is_iov());
+    for (uint32_t lcid : lcids) {
+      TESTASSERT(pdu_iov.new_subh());
+      TESTASSERT(pdu_iov.get()->set_sdu(lcid, body_len + 1, &rlc) == (int)body_len + 1);
+    }
+    TESTASSERT(pdu_iov.write_packet(mac_logger) == buffer_iov.msg);
+
+    // Only MAC/RLC headers and padding are in the buffer
+    TESTASSERT(buffer_iov.N_bytes == pdu_size - 3 * body_len);
+    TESTASSERT(tb_iov.nof_iov == 7);
+    TESTASSERT(srsran_sch_tb_iov_len(&tb_iov) == pdu_size);
+
+    uint8_t gathered[pdu_size];
+    TESTASSERT(srsran_sch_tb_iov_gather(&tb_iov, gathered, pdu_size) == pdu_size);
+    TESTASSERT(memcmp(gathered, buffer.msg, pdu_size) == 0);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 // Test for checking error cases
 int mac_sch_pdu_pack_error_test()
 {
@@ -1189,6 +1271,7 @@ int main(int argc, char** argv)
   TESTASSERT(mac_sch_pdu_pack_test9() == SRSRAN_SUCCESS);
   TESTASSERT(mac_sch_pdu_pack_test10() == SRSRAN_SUCCESS);
   TESTASSERT(mac_sch_pdu_pack_test11() == SRSRAN_SUCCESS);
+  TESTASSERT(mac_sch_pdu_pack_iov_test() == SRSRAN_SUCCESS);
 
   TESTASSERT(mac_sch_pdu_pack_error_test() == SRSRAN_SUCCESS);
 
@@ -92,6 +92,15 @@ bool pdcp::is_lcid_enabled(uint32_t lcid)
   return valid_lcids_cached.count(lcid) > 0;
 }
 
+// The TX batch stage is shared by all bearers, and possibly other PDCP instances
+void pdcp::set_tx_batch(pdcp_tx_batch* tx_batch_)
+{
+  tx_batch = tx_batch_;
+  for (auto& lcid_it : pdcp_array) {
+    lcid_it.second->set_tx_batch(tx_batch);
+  }
+}
+
 void pdcp::write_sdu(uint32_t lcid, unique_byte_buffer_t sdu, int sn)
 {
   if (valid_lcid(lcid)) {
@@ -127,6 +136,7 @@ int pdcp::add_bearer(uint32_t lcid, const pdcp_config_t& cfg)
     logger.error("Can not configure PDCP entity");
     return SRSRAN_ERROR;
   }
+  entity->set_tx_batch(tx_batch);
 
   if (not pdcp_array.insert(std::make_pair(lcid, std::move(entity))).second) {
     logger.error("Error inserting PDCP entity in to array.");
@@ -30,10 +30,16 @@ pdcp_entity_base::pdcp_entity_base(task_sched_handle task_sched_, srslog::basic_
   logger(logger), task_sched(task_sched_)
 {}
 
-pdcp_entity_base::~pdcp_entity_base() {}
+pdcp_entity_base::~pdcp_entity_base()
+{
+  if (tx_batch != nullptr) {
+    tx_batch->remove_entity(this);
+  }
+}
 
 void pdcp_entity_base::config_security(const as_security_config_t& sec_cfg_)
 {
+  flush_tx_batch();
   sec_cfg = sec_cfg_;
 
   logger.info("Configuring security with %s and %s",
@@ -44,6 +50,95 @@ void pdcp_entity_base::config_security(const as_security_config_t& sec_cfg_)
   logger.debug(sec_cfg.k_up_enc.data(), 32, "K_up_enc");
   logger.debug(sec_cfg.k_rrc_int.data(), 32, "K_rrc_int");
   logger.debug(sec_cfg.k_up_int.data(), 32, "K_up_int");
+
+  // If control plane use RRC keys. If data use user plane keys
+  if (sec_cfg.cipher_algo == CIPHERING_ALGORITHM_ID_128_EEA2) {
+    aes_k_enc.set_key(is_srb() ? &sec_cfg.k_rrc_enc[16] : &sec_cfg.k_up_enc[16]);
+  }
+  if (sec_cfg.integ_algo == INTEGRITY_ALGORITHM_ID_128_EIA2) {
+    aes_k_int.set_key(is_srb() ? &sec_cfg.k_rrc_int[16] : &sec_cfg.k_up_int[16]);
+  }
+}
+
+/****************************************************************************
+ * Header compression
+ ***************************************************************************/
+void pdcp_entity_base::configure_rohc()
+{
+  rohc_comp.reset();
+  rohc_decomp.reset();
+  if (not is_drb() or not cfg.rohc.enabled) {
+    return;
+  }
+  // With ul-OnlyROHC, the downlink is not compressed
+  if (not cfg.rohc.ul_only or cfg.tx_direction == SECURITY_DIRECTION_UPLINK) {
+    rohc_comp = std::unique_ptr<rohc_compressor>(new rohc_compressor(cfg.rohc, logger));
+  }
+  if (not cfg.rohc.ul_only or cfg.rx_direction == SECURITY_DIRECTION_UPLINK) {
+    rohc_decomp = std::unique_ptr<rohc_decompressor>(new rohc_decompressor(cfg.rohc, logger));
+  }
+  logger.info("%s: ROHC enabled. max_cid=%d, profiles:%s%s, compression=%s, decompression=%s",
+              rb_name.c_str(),
+              cfg.rohc.max_cid,
+              cfg.rohc.profile_rtp ? " 0x0001" : "",
+              cfg.rohc.profile_udp ? " 0x0002" : "",
+              rohc_comp != nullptr ? "on" : "off",
+              rohc_decomp != nullptr ? "on" : "off");
+}
+
+// The contexts are established again with IR packets after a reestablishment, 36.323 5.2 and 38.323 5.1.2
+void pdcp_entity_base::reset_rohc()
+{
+  if (rohc_comp != nullptr) {
+    rohc_comp->reset();
+  }
+  if (rohc_decomp != nullptr) {
+    rohc_decomp->reset();
+  }
+}
+
+/****************************************************************************
+ * TX batch stage
+ ***************************************************************************/
+void pdcp_entity_base::flush_tx_batch()
+{
+  if (tx_batch != nullptr) {
+    tx_batch->flush();
+  }
+}
+
+pdcp_tx_batch_pdu_t pdcp_entity_base::make_tx_batch_pdu(unique_byte_buffer_t pdu,
+                                                        uint32_t             count,
+                                                        bool                 do_integrity,
+                                                        bool                 do_append_mac,
+                                                        bool                 do_encryption)
+{
+  pdcp_tx_batch_pdu_t p;
+  p.entity    = this;
+  p.count     = count;
+  p.bearer    = cfg.bearer_id - 1;
+  p.direction = cfg.tx_direction;
+  p.hdr_len   = cfg.hdr_len_bytes;
+  // Same check as in append_mac()
+  p.append_mac = do_append_mac;
+  if (do_append_mac and pdu->N_bytes + 4 > pdu->get_tailroom()) {
+    logger.error("Not enough space to add MAC-I");
+    p.append_mac = false;
+  }
+  p.pdu = std::move(pdu);
+
+  // If control plane use RRC keys. If data use user plane keys
+  if (do_integrity) {
+    p.integ_algo = sec_cfg.integ_algo;
+    p.k_int      = is_srb() ? &sec_cfg.k_rrc_int[16] : &sec_cfg.k_up_int[16];
+    p.aes_k_int  = &aes_k_int;
+  }
+  if (do_encryption) {
+    p.cipher_algo = sec_cfg.cipher_algo;
+    p.k_enc       = is_srb() ? &sec_cfg.k_rrc_enc[16] : &sec_cfg.k_up_enc[16];
+    p.aes_k_enc   = &aes_k_enc;
+  }
+  return p;
 }
 
 /****************************************************************************
@@ -67,7 +162,7 @@ void pdcp_entity_base::integrity_generate(uint8_t* msg, uint32_t msg_len, uint32
       security_128_eia1(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA2:
-      security_128_eia2(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
+      security_128_eia2(aes_k_int, count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA3:
       security_128_eia3(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
@@ -105,7 +200,7 @@ bool pdcp_entity_base::integrity_verify(uint8_t* msg, uint32_t msg_len, uint32_t
       security_128_eia1(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA2:
-      security_128_eia2(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
+      security_128_eia2(aes_k_int, count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA3:
       security_128_eia3(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
@@ -162,8 +257,8 @@ void pdcp_entity_base::cipher_encrypt(uint8_t* msg, uint32_t msg_len, uint32_t c
       memcpy(ct, ct_tmp, msg_len);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA2:
-      security_128_eea2(&(k_enc[16]), count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct_tmp);
-      memcpy(ct, ct_tmp, msg_len);
+      // The precomputed key supports in-place ciphering
+      security_128_eea2(aes_k_enc, count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA3:
       security_128_eea3(&(k_enc[16]), count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct_tmp);
@@ -202,8 +297,7 @@ void pdcp_entity_base::cipher_decrypt(uint8_t* ct, uint32_t ct_len, uint32_t cou
       memcpy(msg, msg_tmp, ct_len);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA2:
-      security_128_eea2(&k_enc[16], count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg_tmp);
-      memcpy(msg, msg_tmp, ct_len);
+      security_128_eea2(aes_k_enc, count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA3:
       security_128_eea3(&k_enc[16], count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg_tmp);
@@ -103,6 +103,7 @@ bool pdcp_entity_lte::configure(const pdcp_config_t& cnfg_)
     undelivered_sdus = std::unique_ptr<undelivered_sdus_queue>(new undelivered_sdus_queue(task_sched, maximum_pdcp_sn));
     rx_counts_info.reserve(reordering_window);
   }
+  configure_rohc();
 
   // Check supported config
   if (!check_valid_config()) {
@@ -115,6 +116,7 @@ bool pdcp_entity_lte::configure(const pdcp_config_t& cnfg_)
 // Reestablishment procedure: 36.323 5.2
 void pdcp_entity_lte::reestablish()
 {
+  flush_tx_batch();
   logger.info("Re-establish %s with bearer ID: %d", rb_name.c_str(), cfg.bearer_id);
   // For SRBs
   if (is_srb()) {
@@ -131,11 +133,15 @@ void pdcp_entity_lte::reestablish()
   } else {
     // Sending the status report will be triggered by the RRC if required
   }
+  if (is_drb()) {
+    reset_rohc();
+  }
 }
 
 // Used to stop/pause the entity (called on RRC conn release)
 void pdcp_entity_lte::reset()
 {
+  flush_tx_batch();
   if (active) {
     logger.debug("Reset %s", rb_name.c_str());
   }
@@ -182,6 +188,15 @@ void pdcp_entity_lte::write_sdu(unique_byte_buffer_t sdu, int upper_sn)
       return;
     }
   }
+
+  // Header compression, after storing the SDU, as the contexts are reset before retransmitting it at reestablishment
+  if (rohc_comp != nullptr and not rohc_comp->compress(sdu.get())) {
+    logger.warning("Could not compress SDU. Discarding SN=%d", used_sn);
+    if (undelivered_sdus != nullptr) {
+      undelivered_sdus->clear_sdu(used_sn);
+    }
+    return;
+  }
   // check for pending security config in transmit direction
   if (enable_security_tx_sn != -1 && enable_security_tx_sn == static_cast<int32_t>(tx_count)) {
     enable_integrity(DIRECTION_TX);
@@ -191,10 +206,29 @@ void pdcp_entity_lte::write_sdu(unique_byte_buffer_t sdu, int upper_sn)
 
   write_data_header(sdu, tx_count);
 
+  // Set SDU metadata for RLC AM
+  sdu->md.pdcp_sn = used_sn;
+
+  // Increment NEXT_PDCP_TX_SN and TX_HFN (only update variables if SN was not provided by upper layers)
+  if (upper_sn == -1) {
+    st.next_pdcp_tx_sn++;
+    if (st.next_pdcp_tx_sn > maximum_pdcp_sn) {
+      st.tx_hfn++;
+      st.next_pdcp_tx_sn = 0;
+    }
+  }
+
   // Append MAC (SRBs only)
-  uint8_t mac[4]       = {};
-  bool    do_integrity = integrity_direction == DIRECTION_TX || integrity_direction == DIRECTION_TXRX;
-  if (do_integrity && is_srb()) {
+  bool do_integrity  = (integrity_direction == DIRECTION_TX || integrity_direction == DIRECTION_TXRX) && is_srb();
+  bool do_encryption = encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX;
+  if (tx_batch != nullptr) {
+    // Integrity protection, ciphering and the delivery to RLC are done when the batch stage is flushed
+    tx_batch->push(make_tx_batch_pdu(std::move(sdu), tx_count, do_integrity, is_srb(), do_encryption));
+    return;
+  }
+
+  uint8_t mac[4] = {};
+  if (do_integrity) {
     integrity_generate(sdu->msg, sdu->N_bytes, tx_count, mac);
   }
 
@@ -202,39 +236,32 @@ void pdcp_entity_lte::write_sdu(unique_byte_buffer_t sdu, int upper_sn)
     append_mac(sdu, mac);
   }
 
-  if (encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX) {
+  if (do_encryption) {
     cipher_encrypt(
         &sdu->msg[cfg.hdr_len_bytes], sdu->N_bytes - cfg.hdr_len_bytes, tx_count, &sdu->msg[cfg.hdr_len_bytes]);
   }
 
-  logger.info(sdu->msg,
-              sdu->N_bytes,
+  write_tx_pdu(std::move(sdu));
+}
+
+void pdcp_entity_lte::write_tx_pdu(unique_byte_buffer_t pdu)
+{
+  logger.info(pdu->msg,
+              pdu->N_bytes,
               "TX %s PDU, SN=%d, integrity=%s, encryption=%s",
               rb_name.c_str(),
-              used_sn,
+              pdu->md.pdcp_sn,
               srsran_direction_text[integrity_direction],
               srsran_direction_text[encryption_direction]);
 
-  // Set SDU metadata for RLC AM
-  sdu->md.pdcp_sn = used_sn;
-
-  // Increment NEXT_PDCP_TX_SN and TX_HFN (only update variables if SN was not provided by upper layers)
-  if (upper_sn == -1) {
-    st.next_pdcp_tx_sn++;
-    if (st.next_pdcp_tx_sn > maximum_pdcp_sn) {
-      st.tx_hfn++;
-      st.next_pdcp_tx_sn = 0;
-    }
-  }
-
   // Pass PDU to lower layers
   metrics.num_tx_pdus++;
-  metrics.num_tx_pdu_bytes += sdu->N_bytes;
+  metrics.num_tx_pdu_bytes += pdu->N_bytes;
   // Count TX'd bytes as if they were ACK'd if RLC is UM
   if (rlc->rb_is_um(lcid)) {
     metrics.num_tx_acked_bytes = metrics.num_tx_pdu_bytes;
   }
-  rlc->write_sdu(lcid, std::move(sdu));
+  rlc->write_sdu(lcid, std::move(pdu));
 }
 
 // RLC interface
@@ -389,6 +416,12 @@ void pdcp_entity_lte::handle_um_drb_pdu(srsran::unique_byte_buffer_t pdu)
     st.rx_hfn++;
   }
 
+  // Header decompression
+  if (rohc_decomp != nullptr and not rohc_decomp->decompress(pdu.get())) {
+    logger.info("Could not decompress SDU SN=%d, discarding", sn);
+    return;
+  }
+
   // Pass to upper layers
   gw->write_pdu(lcid, std::move(pdu));
 }
@@ -453,6 +486,12 @@ void pdcp_entity_lte::handle_am_drb_pdu(srsran::unique_byte_buffer_t pdu)
   // Store Rx SN/COUNT
   update_rx_counts_queue(count);
 
+  // Header decompression
+  if (rohc_decomp != nullptr and not rohc_decomp->decompress(pdu.get())) {
+    logger.info("Could not decompress SDU SN=%d, discarding", sn);
+    return;
+  }
+
   // Pass to upper layers
   gw->write_pdu(lcid, std::move(pdu));
 }
@@ -533,6 +572,9 @@ void pdcp_entity_lte::send_status_report()
     return;
   }
 
+  // The status report must not overtake the Data PDUs pending in the batch stage
+  flush_tx_batch();
+
   if (not cfg.status_report_required) {
     logger.info("Not sending PDCP Status Report as status report required is not set");
     return;
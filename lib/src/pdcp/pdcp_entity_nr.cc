@@ -69,6 +69,8 @@ bool pdcp_entity_nr::configure(const pdcp_config_t& cnfg_)
                    rb_name);
   }
 
+  configure_rohc();
+
   active = true;
   logger.info("%s PDCP-NR entity configured. SN_LEN=%d, Discard timer %d, Re-ordering timer %d, RLC=%s, RAT=%s",
               rb_name,
@@ -88,13 +90,16 @@ bool pdcp_entity_nr::configure(const pdcp_config_t& cnfg_)
 // Reestablishment procedure: 38.323 5.2
 void pdcp_entity_nr::reestablish()
 {
+  flush_tx_batch();
   logger.info("Re-establish %s with bearer ID: %d", rb_name.c_str(), cfg.bearer_id);
+  reset_rohc();
   // TODO
 }
 
 // Used to stop/pause the entity (called on RRC conn release)
 void pdcp_entity_nr::reset()
 {
+  flush_tx_batch();
   active = false;
   logger.debug("Reset %s", rb_name.c_str());
 }
@@ -125,6 +130,12 @@ void pdcp_entity_nr::write_sdu(unique_byte_buffer_t sdu, int sn)
     tx_overflow = true;
   }
 
+  // Perform header compression. Done before starting the discard timer, as the SDU is dropped if it fails
+  if (rohc_comp != nullptr and not rohc_comp->compress(sdu.get())) {
+    logger.warning("Could not compress %s SDU. Dropping packet", rb_name.c_str());
+    return;
+  }
+
   // Start discard timer
   if (cfg.discard_timer != pdcp_discard_timer_t::infinity) {
     timer_handler::unique_timer discard_timer = task_sched.get_unique_timer();
@@ -135,20 +146,29 @@ void pdcp_entity_nr::write_sdu(unique_byte_buffer_t sdu, int sn)
     logger.debug("Discard Timer set for SN %u. Timeout: %ums", tx_next, static_cast<uint32_t>(cfg.discard_timer));
   }
 
-  // Perform header compression TODO
-
   // Write PDCP header info
   write_data_header(sdu, tx_next);
 
+  // Set meta-data for RLC AM
+  sdu->md.pdcp_sn = tx_next;
+
   // TS 38.323, section 5.9: Integrity protection
   // The data unit that is integrity protected is the PDU header
   // and the data part of the PDU before ciphering.
+  bool do_integrity =
+      is_srb() || (is_drb() && (integrity_direction == DIRECTION_TX || integrity_direction == DIRECTION_TXRX));
+  bool do_encryption = encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX;
+  if (tx_batch != nullptr) {
+    // Integrity protection, ciphering and the delivery to RLC are done when the batch stage is flushed
+    tx_batch->push(make_tx_batch_pdu(std::move(sdu), tx_next, do_integrity, do_integrity, do_encryption));
+    tx_next++;
+    return;
+  }
+
   uint8_t mac[4] = {};
-  if (is_srb() || (is_drb() && (integrity_direction == DIRECTION_TX || integrity_direction == DIRECTION_TXRX))) {
+  if (do_integrity) {
     integrity_generate(sdu->msg, sdu->N_bytes, tx_next, mac);
-  }
-  // Append MAC-I
-  if (is_srb() || (is_drb() && (integrity_direction == DIRECTION_TX || integrity_direction == DIRECTION_TXRX))) {
+    // Append MAC-I
     append_mac(sdu, mac);
   }
 
@@ -156,30 +176,32 @@ void pdcp_entity_nr::write_sdu(unique_byte_buffer_t sdu, int sn)
   // The data unit that is ciphered is the MAC-I and the
   // data part of the PDCP Data PDU except the
   // SDAP header and the SDAP Control PDU if included in the PDCP SDU.
-  if (encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX) {
+  if (do_encryption) {
     cipher_encrypt(
         &sdu->msg[cfg.hdr_len_bytes], sdu->N_bytes - cfg.hdr_len_bytes, tx_next, &sdu->msg[cfg.hdr_len_bytes]);
   }
 
-  // Set meta-data for RLC AM
-  sdu->md.pdcp_sn = tx_next;
+  write_tx_pdu(std::move(sdu));
 
-  logger.info(sdu->msg,
-              sdu->N_bytes,
+  // Increment TX_NEXT
+  tx_next++;
+}
+
+void pdcp_entity_nr::write_tx_pdu(unique_byte_buffer_t pdu)
+{
+  logger.info(pdu->msg,
+              pdu->N_bytes,
               "TX %s PDU (%dB), HFN=%d, SN=%d, integrity=%s, encryption=%s",
               rb_name.c_str(),
-              sdu->N_bytes,
-              HFN(tx_next),
-              SN(tx_next),
+              pdu->N_bytes,
+              HFN(pdu->md.pdcp_sn),
+              SN(pdu->md.pdcp_sn),
               srsran_direction_text[integrity_direction],
               srsran_direction_text[encryption_direction]);
 
   // Check if PDCP is associated with more than on RLC entity TODO
   // Write to lower layers
-  rlc->write_sdu(lcid, std::move(sdu));
-
-  // Increment TX_NEXT
-  tx_next++;
+  rlc->write_sdu(lcid, std::move(pdu));
 }
 
 // RLC interface
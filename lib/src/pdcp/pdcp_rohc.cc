@@ -0,0 +1,1029 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/upper/pdcp_rohc.h"
+#include <algorithm>
+
+namespace srsran {
+
+/****************************************************************************
+ * Constants and helpers
+ ***************************************************************************/
+
+static const uint16_t rohc_profile_uncompressed = 0x0000;
+static const uint16_t rohc_profile_rtp          = 0x0001;
+static const uint16_t rohc_profile_udp          = 0x0002;
+
+// Packet types, RFC 3095 section 5.2
+static const uint8_t rohc_add_cid_type = 0xe0;
+static const uint8_t rohc_ir_type      = 0xfc; // D bit set if the dynamic chain is present
+static const uint8_t rohc_ir_dyn_type  = 0xf8;
+static const uint8_t rohc_segment_type = 0xff;
+
+static const uint32_t ipv4_hdr_len = 20;
+static const uint32_t udp_hdr_len  = 8;
+static const uint32_t rtp_hdr_len  = 12;
+static const uint8_t  ip_proto_udp = 17;
+
+// Bound of the ROHC header, above the longest IR packet of the RTP profile
+static const uint32_t max_rohc_hdr_len = 128;
+static const uint32_t max_ip_hdr_len   = ipv4_hdr_len + udp_hdr_len + rtp_hdr_len;
+
+// Table-driven CRCs of RFC 3095, section 5.9, computed LSB first
+class rohc_crc
+{
+public:
+  rohc_crc(uint8_t poly, uint8_t init_) : init(init_)
+  {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint8_t crc = i;
+      for (uint32_t b = 0; b < 8; ++b) {
+        crc = (crc & 1u) ? (crc >> 1u) ^ poly : (crc >> 1u);
+      }
+      table[i] = crc;
+    }
+  }
+  uint8_t compute(const uint8_t* data, uint32_t len, uint8_t crc) const
+  {
+    for (uint32_t i = 0; i < len; ++i) {
+      crc = table[data[i] ^ crc];
+    }
+    return crc;
+  }
+  uint8_t compute(const uint8_t* data, uint32_t len) const { return compute(data, len, init); }
+
+private:
+  uint8_t                  init;
+  std::array<uint8_t, 256> table;
+};
+
+static const rohc_crc crc3(0x06, 0x07); // 1 + x + x^3
+static const rohc_crc crc7(0x79, 0x7f); // 1 + x + x^2 + x^3 + x^6 + x^7
+static const rohc_crc crc8(0xe0, 0xff); // 1 + x + x^2 + x^8
+
+// W-LSB interpretation interval [ref - p, ref + 2^k - 1 - p], RFC 3095 section 4.5.1
+static bool lsb_fits(uint32_t v, uint32_t ref, uint32_t k, int32_t p, uint32_t mask)
+{
+  return ((v - (ref - p)) & mask) < (1u << k);
+}
+
+static uint32_t lsb_decode(uint32_t ref, uint32_t lsb, uint32_t k, int32_t p, uint32_t mask)
+{
+  uint32_t low = (ref - p) & mask;
+  return (low + ((lsb - low) & ((1u << k) - 1u))) & mask;
+}
+
+// Offsets of the interpretation intervals of the RTP SN and the scaled TS, RFC 3095 section 5.7
+static int32_t sn_lsb_p(uint32_t k)
+{
+  return k <= 4 ? -1 : (1 << (k - 5)) - 1;
+}
+static int32_t ts_lsb_p(uint32_t k)
+{
+  return (1 << (k - 2)) - 1;
+}
+
+static uint16_t get_u16(const uint8_t* p)
+{
+  return (uint16_t)((p[0] << 8u) | p[1]);
+}
+static uint32_t get_u32(const uint8_t* p)
+{
+  return ((uint32_t)p[0] << 24u) | ((uint32_t)p[1] << 16u) | ((uint32_t)p[2] << 8u) | p[3];
+}
+static void put_u16(uint8_t* p, uint16_t v)
+{
+  p[0] = v >> 8u;
+  p[1] = v & 0xffu;
+}
+static void put_u32(uint8_t* p, uint32_t v)
+{
+  p[0] = v >> 24u;
+  p[1] = (v >> 16u) & 0xffu;
+  p[2] = (v >> 8u) & 0xffu;
+  p[3] = v & 0xffu;
+}
+
+// Checksum of an IPv4 header without options, skipping the checksum field
+static uint16_t ipv4_checksum(const uint8_t* hdr)
+{
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < ipv4_hdr_len; i += 2) {
+    sum += i != 10 ? get_u16(&hdr[i]) : 0;
+  }
+  while (sum >> 16u) {
+    sum = (sum & 0xffffu) + (sum >> 16u);
+  }
+  return ~sum & 0xffffu;
+}
+
+/****************************************************************************
+ * Uncompressed headers
+ ***************************************************************************/
+
+struct rohc_hdr_t {
+  uint16_t profile = rohc_profile_uncompressed;
+  uint32_t len     = 0; // Length of the headers replaced by the ROHC header
+
+  // IPv4
+  uint8_t  tos         = 0;
+  uint16_t ip_id       = 0;
+  bool     df          = false;
+  uint8_t  ttl         = 0;
+  uint8_t  protocol    = 0;
+  uint8_t  src_addr[4] = {};
+  uint8_t  dst_addr[4] = {};
+
+  // UDP
+  uint16_t src_port = 0;
+  uint16_t dst_port = 0;
+  uint16_t checksum = 0;
+
+  // RTP
+  bool     marker = false;
+  uint8_t  pt     = 0;
+  uint16_t rtp_sn = 0;
+  uint32_t ts     = 0;
+  uint32_t ssrc   = 0;
+
+  uint32_t get_len() const
+  {
+    switch (profile) {
+      case rohc_profile_rtp:
+        return ipv4_hdr_len + udp_hdr_len + rtp_hdr_len;
+      case rohc_profile_udp:
+        return ipv4_hdr_len + udp_hdr_len;
+      default:
+        return 0;
+    }
+  }
+};
+
+// Classifies the packet in one of the configured profiles. The packets the profiles do not cover, or whose headers
+// could not be rebuilt bit-exact from the context, use the uncompressed profile. This includes TCP, as the ROHC-TCP
+// profile (0x0006, RFC 6846) is not supported
+static void parse_headers(const uint8_t* pkt, uint32_t len, const pdcp_rohc_config_t& cfg, rohc_hdr_t& hdr)
+{
+  hdr.profile = rohc_profile_uncompressed;
+  hdr.len     = 0;
+
+  if (len < ipv4_hdr_len or pkt[0] != 0x45 or get_u16(&pkt[2]) != len or (get_u16(&pkt[6]) & 0xbfffu) != 0 or
+      ipv4_checksum(pkt) != get_u16(&pkt[10])) {
+    return;
+  }
+  hdr.tos      = pkt[1];
+  hdr.ip_id    = get_u16(&pkt[4]);
+  hdr.df       = (pkt[6] & 0x40u) != 0;
+  hdr.ttl      = pkt[8];
+  hdr.protocol = pkt[9];
+  memcpy(hdr.src_addr, &pkt[12], 4);
+  memcpy(hdr.dst_addr, &pkt[16], 4);
+
+  const uint8_t* l4 = &pkt[ipv4_hdr_len];
+  if (hdr.protocol == ip_proto_udp and (cfg.profile_udp or cfg.profile_rtp)) {
+    if (len < ipv4_hdr_len + udp_hdr_len or get_u16(&l4[4]) != len - ipv4_hdr_len) {
+      return;
+    }
+    hdr.src_port = get_u16(&l4[0]);
+    hdr.dst_port = get_u16(&l4[2]);
+    hdr.checksum = get_u16(&l4[6]);
+
+    // RTP cannot be told from other UDP payloads. Take version 2 headers without padding, extension nor CSRCs, on
+    // even ports and with a payload type that is not RTCP
+    const uint8_t* rtp = &l4[udp_hdr_len];
+    if (cfg.profile_rtp and len >= ipv4_hdr_len + udp_hdr_len + rtp_hdr_len and rtp[0] == 0x80 and
+        ((rtp[1] & 0x7fu) < 72 or (rtp[1] & 0x7fu) > 76) and hdr.dst_port % 2 == 0) {
+      hdr.marker  = (rtp[1] & 0x80u) != 0;
+      hdr.pt      = rtp[1] & 0x7fu;
+      hdr.rtp_sn  = get_u16(&rtp[2]);
+      hdr.ts      = get_u32(&rtp[4]);
+      hdr.ssrc    = get_u32(&rtp[8]);
+      hdr.profile = rohc_profile_rtp;
+    } else if (cfg.profile_udp) {
+      hdr.profile = rohc_profile_udp;
+    }
+  }
+  hdr.len = hdr.get_len();
+}
+
+// Writes the headers of a packet with the given payload length, computing the length fields and the IPv4 checksum
+static void write_headers(const rohc_hdr_t& hdr, uint32_t payload_len, uint8_t* out)
+{
+  uint32_t total_len = hdr.len + payload_len;
+  out[0]             = 0x45;
+  out[1]             = hdr.tos;
+  put_u16(&out[2], total_len);
+  put_u16(&out[4], hdr.ip_id);
+  put_u16(&out[6], hdr.df ? 0x4000 : 0);
+  out[8] = hdr.ttl;
+  out[9] = hdr.protocol;
+  memcpy(&out[12], hdr.src_addr, 4);
+  memcpy(&out[16], hdr.dst_addr, 4);
+  put_u16(&out[10], ipv4_checksum(out));
+
+  uint8_t* l4 = &out[ipv4_hdr_len];
+  put_u16(&l4[0], hdr.src_port);
+  put_u16(&l4[2], hdr.dst_port);
+  put_u16(&l4[4], total_len - ipv4_hdr_len);
+  put_u16(&l4[6], hdr.checksum);
+  if (hdr.profile == rohc_profile_rtp) {
+    uint8_t* rtp = &l4[udp_hdr_len];
+    rtp[0]       = 0x80;
+    rtp[1]       = (hdr.marker ? 0x80u : 0u) | hdr.pt;
+    put_u16(&rtp[2], hdr.rtp_sn);
+    put_u32(&rtp[4], hdr.ts);
+    put_u32(&rtp[8], hdr.ssrc);
+  }
+}
+
+/****************************************************************************
+ * Static and dynamic chains, RFC 3095 section 5.7.7
+ ***************************************************************************/
+
+// Fields of the context that are not part of the uncompressed headers
+struct rohc_ctx_fields_t {
+  uint16_t sn        = 0; // RTP SN, or the SN generated by the compressor (UDP)
+  bool     rnd       = false;
+  uint32_t ts_stride = 0;
+};
+
+// Appends bytes to a ROHC header, whose size is bounded by max_rohc_hdr_len
+class rohc_writer
+{
+public:
+  explicit rohc_writer(uint8_t* buf_) : buf(buf_) {}
+  void     u8(uint8_t v) { buf[len++] = v; }
+  void     u16(uint16_t v) { put_u16(&buf[(len += 2) - 2], v); }
+  void     u32(uint32_t v) { put_u32(&buf[(len += 4) - 4], v); }
+  void     bytes(const uint8_t* p, uint32_t n) { memcpy(&buf[(len += n) - n], p, n); }
+  uint8_t* data() { return buf; }
+  uint32_t size() const { return len; }
+
+  // Self-describing variable length values, RFC 3095 section 4.5.6
+  void sdvl(uint32_t v)
+  {
+    if (v < (1u << 7u)) {
+      u8(v);
+    } else if (v < (1u << 14u)) {
+      u16(0x8000u | v);
+    } else if (v < (1u << 21u)) {
+      u8(0xc0u | (v >> 16u));
+      u16(v & 0xffffu);
+    } else {
+      u32(0xe0000000u | (v & 0x1fffffffu));
+    }
+  }
+
+private:
+  uint8_t* buf;
+  uint32_t len = 0;
+};
+
+// Reads the bytes of a ROHC header, failing instead of reading past the end of the packet
+class rohc_reader
+{
+public:
+  rohc_reader(const uint8_t* buf_, uint32_t len_, uint32_t pos_) : buf(buf_), len(len_), pos(pos_) {}
+  bool check(uint32_t n)
+  {
+    ok = ok and pos + n <= len;
+    return ok;
+  }
+  uint8_t  u8() { return check(1) ? buf[pos++] : 0; }
+  uint16_t u16() { return check(2) ? get_u16(&buf[(pos += 2) - 2]) : 0; }
+  uint32_t u32() { return check(4) ? get_u32(&buf[(pos += 4) - 4]) : 0; }
+  void     bytes(uint8_t* p, uint32_t n)
+  {
+    if (check(n)) {
+      memcpy(p, &buf[pos], n);
+      pos += n;
+    }
+  }
+  uint32_t sdvl()
+  {
+    uint8_t b = u8();
+    if ((b & 0x80u) == 0) {
+      return b;
+    }
+    if ((b & 0xc0u) == 0x80u) {
+      return ((b & 0x3fu) << 8u) | u8();
+    }
+    if ((b & 0xe0u) == 0xc0u) {
+      return ((b & 0x1fu) << 16u) | u16();
+    }
+    return ((b & 0x0fu) << 24u) | (u8() << 16u) | u16();
+  }
+  bool     is_ok() const { return ok; }
+  uint32_t position() const { return pos; }
+
+private:
+  const uint8_t* buf;
+  uint32_t       len;
+  uint32_t       pos;
+  bool           ok = true;
+};
+
+static void write_static_chain(rohc_writer& w, const rohc_hdr_t& hdr)
+{
+  w.u8(0x40);
+  w.u8(hdr.protocol);
+  w.bytes(hdr.src_addr, 4);
+  w.bytes(hdr.dst_addr, 4);
+  w.u16(hdr.src_port);
+  w.u16(hdr.dst_port);
+  if (hdr.profile == rohc_profile_rtp) {
+    w.u32(hdr.ssrc);
+  }
+}
+
+static void read_static_chain(rohc_reader& r, rohc_hdr_t& hdr)
+{
+  if (r.u8() != 0x40) {
+    // Only IPv4 is compressed
+    r.check(UINT32_MAX);
+  }
+  hdr.protocol = r.u8();
+  r.bytes(hdr.src_addr, 4);
+  r.bytes(hdr.dst_addr, 4);
+  hdr.src_port = r.u16();
+  hdr.dst_port = r.u16();
+  if (hdr.profile == rohc_profile_rtp) {
+    hdr.ssrc = r.u32();
+  }
+}
+
+static void write_dynamic_chain(rohc_writer& w, const rohc_hdr_t& hdr, const rohc_ctx_fields_t& f)
+{
+  // IPv4: TOS, TTL, IP-ID, DF/RND/NBO flags and an empty extension header list
+  w.u8(hdr.tos);
+  w.u8(hdr.ttl);
+  w.u16(hdr.ip_id);
+  w.u8((hdr.df ? 0x80u : 0u) | (f.rnd ? 0x40u : 0u) | 0x20u);
+  w.u8(0);
+
+  w.u16(hdr.checksum);
+  if (hdr.profile == rohc_profile_udp) {
+    w.u16(f.sn);
+    return;
+  }
+  // RTP: V=2 and RX, M and PT, SN, TS and an empty CSRC list. With RX, U-mode and the TS_STRIDE, if known
+  bool rx = f.ts_stride != 0;
+  w.u8(0x80u | (rx ? 0x10u : 0u));
+  w.u8((hdr.marker ? 0x80u : 0u) | hdr.pt);
+  w.u16(hdr.rtp_sn);
+  w.u32(hdr.ts);
+  w.u8(0);
+  if (rx) {
+    w.u8((1u << 2u) | 1u);
+    w.sdvl(f.ts_stride);
+  }
+}
+
+static void read_dynamic_chain(rohc_reader& r, rohc_hdr_t& hdr, rohc_ctx_fields_t& f)
+{
+  hdr.tos       = r.u8();
+  hdr.ttl       = r.u8();
+  hdr.ip_id     = r.u16();
+  uint8_t flags = r.u8();
+  hdr.df        = (flags & 0x80u) != 0;
+  f.rnd         = (flags & 0x40u) != 0;
+  if (r.u8() != 0) {
+    // Extension headers are not compressed
+    r.check(UINT32_MAX);
+  }
+
+  hdr.checksum = r.u16();
+  if (hdr.profile == rohc_profile_udp) {
+    f.sn = r.u16();
+    return;
+  }
+  uint8_t rtp_flags = r.u8();
+  uint8_t m_pt      = r.u8();
+  hdr.marker        = (m_pt & 0x80u) != 0;
+  hdr.pt            = m_pt & 0x7fu;
+  hdr.rtp_sn        = r.u16();
+  hdr.ts            = r.u32();
+  f.sn              = hdr.rtp_sn;
+  f.ts_stride       = 0;
+  if ((rtp_flags & 0xefu) != 0x80u or r.u8() != 0) {
+    // Padding, CSRCs and header extensions are not compressed
+    r.check(UINT32_MAX);
+    return;
+  }
+  if ((rtp_flags & 0x10u) != 0) {
+    uint8_t rx_flags = r.u8();
+    if ((rx_flags & 0x02u) != 0) {
+      // TIME_STRIDE is not used
+      r.sdvl();
+    }
+    if ((rx_flags & 0x01u) != 0) {
+      f.ts_stride = r.sdvl();
+    }
+  }
+}
+
+/****************************************************************************
+ * Compressor
+ ***************************************************************************/
+
+struct rohc_compressor::context_t {
+  // Values of the packets sent last, that the decompressor may be using as reference for the W-LSB encoding
+  struct ref_t {
+    uint32_t gen       = 0;
+    uint16_t sn        = 0;
+    uint32_t ts_scaled = 0;
+  };
+
+  uint32_t          cid = 0;
+  rohc_hdr_t        hdr; // Headers of the last packet
+  rohc_ctx_fields_t f;
+  uint64_t          last_used     = 0;
+  uint32_t          nof_ir        = 0;
+  uint32_t          pkts_since_ir = 0;
+
+  // Incremented when a field that is only sent in IR and IR-DYN packets changes
+  uint32_t gen = 0;
+
+  uint16_t ip_id_offset   = 0; // IP-ID - SN, if the IP-ID is not random
+  uint32_t nof_ipid_jumps = 0;
+  uint32_t nof_ipid_seq   = 0;
+  uint32_t ts_offset      = 0;
+  uint32_t ts_scaled      = 0;
+
+  std::array<ref_t, rohc_nof_context_updates> refs;
+  uint32_t                                    nof_refs = 0;
+
+  void push_ref(const ref_t& ref)
+  {
+    refs[nof_refs % rohc_nof_context_updates] = ref;
+    nof_refs++;
+  }
+  // Compressed packets need the decompressor to have the current values of the IR/IR-DYN fields, whichever
+  // of the last packets it received
+  bool refs_are_current() const
+  {
+    return nof_refs >= rohc_nof_context_updates and
+           std::all_of(refs.begin(), refs.end(), [this](const ref_t& r) { return r.gen == gen; });
+  }
+  template <typename F>
+  bool all_refs(const F& pred) const
+  {
+    return std::all_of(refs.begin(), refs.end(), pred);
+  }
+};
+
+rohc_compressor::rohc_compressor(const pdcp_rohc_config_t& cfg_, srslog::basic_logger& logger_) :
+  cfg(cfg_), logger(logger_), pool(4)
+{
+  max_cid = std::min((uint32_t)cfg.max_cid, rohc_max_small_cid);
+  if (cfg.max_cid > rohc_max_small_cid) {
+    logger.warning("ROHC large CIDs are not supported. Using %d contexts instead of %d", max_cid + 1, cfg.max_cid + 1);
+  }
+}
+
+rohc_compressor::~rohc_compressor()
+{
+  reset();
+}
+
+void rohc_compressor::reset()
+{
+  for (unique_pool_ptr<context_t>& ctx : contexts) {
+    ctx.reset();
+  }
+}
+
+rohc_compressor::context_t* rohc_compressor::get_context(const rohc_hdr_t& hdr)
+{
+  auto same_flow = [&hdr](const context_t& ctx) {
+    if (ctx.hdr.profile != hdr.profile) {
+      return false;
+    }
+    if (hdr.profile == rohc_profile_uncompressed) {
+      return true;
+    }
+    return ctx.hdr.protocol == hdr.protocol and memcmp(ctx.hdr.src_addr, hdr.src_addr, 4) == 0 and
+           memcmp(ctx.hdr.dst_addr, hdr.dst_addr, 4) == 0 and ctx.hdr.src_port == hdr.src_port and
+           ctx.hdr.dst_port == hdr.dst_port and (hdr.profile != rohc_profile_rtp or ctx.hdr.ssrc == hdr.ssrc);
+  };
+
+  int free_cid = -1;
+  int lru_cid  = -1;
+  for (uint32_t cid = 0; cid <= max_cid; ++cid) {
+    if (contexts[cid] == nullptr) {
+      free_cid = free_cid < 0 ? cid : free_cid;
+      continue;
+    }
+    if (same_flow(*contexts[cid])) {
+      return contexts[cid].get();
+    }
+    if (lru_cid < 0 or contexts[cid]->last_used < contexts[lru_cid]->last_used) {
+      lru_cid = cid;
+    }
+  }
+
+  uint32_t cid = free_cid >= 0 ? free_cid : lru_cid;
+  if (free_cid < 0) {
+    logger.debug("ROHC CID=%d: replacing the least recently used context", cid);
+  }
+  contexts[cid] = pool.make();
+  *contexts[cid] = {};
+  contexts[cid]->cid         = cid;
+  contexts[cid]->hdr.profile = hdr.profile;
+  return contexts[cid].get();
+}
+
+bool rohc_compressor::compress(byte_buffer_t* sdu)
+{
+  rohc_hdr_t hdr;
+  parse_headers(sdu->msg, sdu->N_bytes, cfg, hdr);
+  if (sdu->get_headroom() + hdr.len < max_rohc_hdr_len) {
+    logger.warning("Not enough headroom for the ROHC header");
+    metrics.nof_dropped++;
+    return false;
+  }
+
+  context_t& ctx    = *get_context(hdr);
+  bool       is_new = ctx.nof_ir == 0;
+  ctx.last_used     = ++nof_pkts;
+
+  uint8_t     buf[max_rohc_hdr_len];
+  rohc_writer w(buf);
+  if (ctx.cid != 0) {
+    w.u8(rohc_add_cid_type | ctx.cid);
+  }
+
+  // Uncompressed profile, RFC 3095 section 5.10. The IR and normal packets carry the whole packet after the ROHC
+  // header. A normal packet cannot start with an octet that could be taken as a ROHC packet type
+  if (hdr.profile == rohc_profile_uncompressed) {
+    bool send_ir = ctx.nof_ir < rohc_nof_context_updates or ctx.pkts_since_ir >= rohc_ir_refresh or
+                   sdu->N_bytes == 0 or (sdu->msg[0] & 0xe0u) == 0xe0u;
+    if (send_ir) {
+      w.u8(rohc_ir_type);
+      w.u8(rohc_profile_uncompressed);
+      w.u8(0);
+      w.data()[w.size() - 1] = crc8.compute(w.data(), w.size());
+      ctx.nof_ir++;
+      ctx.pkts_since_ir = 0;
+      metrics.nof_ir++;
+    } else {
+      ctx.pkts_since_ir++;
+      metrics.nof_uncompressed++;
+    }
+    memcpy(sdu->msg - w.size(), w.data(), w.size());
+    sdu->msg -= w.size();
+    sdu->N_bytes += w.size();
+    metrics.nof_packets++;
+    metrics.rohc_hdr_bytes += w.size();
+    return true;
+  }
+
+  rohc_ctx_fields_t f = ctx.f;
+  f.sn                = hdr.profile == rohc_profile_rtp ? hdr.rtp_sn : (uint16_t)(ctx.f.sn + 1);
+  uint16_t ip_id_offset = hdr.ip_id - f.sn;
+  bool     changed      = false;
+
+  if (not is_new) {
+    changed = hdr.tos != ctx.hdr.tos or hdr.ttl != ctx.hdr.ttl or hdr.df != ctx.hdr.df;
+    // The UDP checksum is sent in the compressed packets only if it is used
+    changed = changed or (hdr.checksum != 0) != (ctx.hdr.checksum != 0);
+    if (hdr.profile == rohc_profile_rtp) {
+      changed = changed or hdr.pt != ctx.hdr.pt;
+    }
+
+    // A sequential IP-ID is inferred from the SN. It is sent in the compressed packets once it is found to be random
+    if (ip_id_offset != ctx.ip_id_offset) {
+      ctx.nof_ipid_seq = 0;
+      if (not f.rnd) {
+        changed = true;
+        f.rnd   = ++ctx.nof_ipid_jumps >= 2;
+      }
+    } else {
+      ctx.nof_ipid_jumps = 0;
+      if (f.rnd and ++ctx.nof_ipid_seq >= rohc_nof_context_updates) {
+        changed = true;
+        f.rnd   = false;
+      }
+    }
+  }
+
+  // RTP TS, scaled by the TS_STRIDE, RFC 3095 section 4.5.3. A TS that is not a multiple of the stride, with the
+  // same offset, sets a new stride
+  uint32_t ts_offset = ctx.ts_offset;
+  uint32_t ts_scaled = 0;
+  if (hdr.profile == rohc_profile_rtp) {
+    if (f.ts_stride == 0 or (hdr.ts - ts_offset) % f.ts_stride != 0) {
+      uint16_t sn_delta = f.sn - ctx.f.sn;
+      uint32_t ts_delta = hdr.ts - ctx.hdr.ts;
+      uint32_t stride   = (not is_new and sn_delta == 1 and ts_delta < (1u << 16u)) ? ts_delta : 0;
+      changed           = changed or stride != f.ts_stride;
+      f.ts_stride       = stride;
+      ts_offset         = stride != 0 ? hdr.ts % stride : 0;
+    }
+    ts_scaled = f.ts_stride != 0 ? (hdr.ts - ts_offset) / f.ts_stride : 0;
+  }
+
+  if (changed) {
+    ctx.gen++;
+  }
+
+  context_t::ref_t ref;
+  ref.gen       = ctx.gen;
+  ref.sn        = f.sn;
+  ref.ts_scaled = ts_scaled;
+
+  enum { ir, ir_dyn, compressed } type = compressed;
+  if (is_new or ctx.nof_ir < rohc_nof_context_updates or ctx.pkts_since_ir >= rohc_ir_refresh) {
+    type = ir;
+  } else if (changed or not ctx.refs_are_current()) {
+    type = ir_dyn;
+  }
+
+  // The CRCs of the compressed packets cover the original headers
+  const uint8_t* orig = sdu->msg;
+  if (type == compressed) {
+    auto sn_fits = [&ctx, &f](uint32_t k) {
+      return ctx.all_refs([&f, k](const context_t::ref_t& r) { return lsb_fits(f.sn, r.sn, k, sn_lsb_p(k), 0xffff); });
+    };
+    auto ts_fits = [&ctx, ts_scaled](uint32_t k) {
+      return ctx.all_refs(
+          [ts_scaled, k](const context_t::ref_t& r) { return lsb_fits(ts_scaled, r.ts_scaled, k, ts_lsb_p(k), ~0u); });
+    };
+
+    if (hdr.profile == rohc_profile_rtp) {
+      // UO-0 infers the TS from the SN, if both increase together
+      bool ts_linear = ctx.all_refs([&f, ts_scaled](const context_t::ref_t& r) {
+        return ts_scaled - r.ts_scaled == (uint16_t)(f.sn - r.sn);
+      });
+      if (f.ts_stride == 0) {
+        type = ir_dyn;
+      } else if (not hdr.marker and ts_linear and sn_fits(4)) {
+        w.u8(((f.sn & 0x0fu) << 3u) | crc3.compute(orig, hdr.len));
+      } else if (sn_fits(4) and ts_fits(6)) {
+        w.u8(0x80u | (ts_scaled & 0x3fu));
+        w.u8((hdr.marker ? 0x80u : 0u) | ((f.sn & 0x0fu) << 3u) | crc3.compute(orig, hdr.len));
+      } else if (sn_fits(6) and ts_fits(6)) {
+        w.u8(0xc0u | ((ts_scaled >> 1u) & 0x1fu));
+        w.u8(((ts_scaled & 1u) << 7u) | (hdr.marker ? 0x40u : 0u) | (f.sn & 0x3fu));
+        w.u8(crc7.compute(orig, hdr.len));
+      } else {
+        type = ir_dyn;
+      }
+    } else {
+      if (sn_fits(4)) {
+        w.u8(((f.sn & 0x0fu) << 3u) | crc3.compute(orig, hdr.len));
+      } else if (sn_fits(5)) {
+        w.u8(0xc0u | (f.sn & 0x1fu));
+        w.u8(crc7.compute(orig, hdr.len));
+      } else {
+        type = ir_dyn;
+      }
+    }
+    if (type == compressed) {
+      if (f.rnd) {
+        w.u16(hdr.ip_id);
+      }
+      if (hdr.checksum != 0) {
+        w.u16(hdr.checksum);
+      }
+    }
+  }
+
+  if (type != compressed) {
+    // Drop the Add-CID octet of a compressed packet that did not fit
+    w = rohc_writer(buf);
+    if (ctx.cid != 0) {
+      w.u8(rohc_add_cid_type | ctx.cid);
+    }
+    w.u8(type == ir ? rohc_ir_type | 0x01u : rohc_ir_dyn_type);
+    w.u8(hdr.profile);
+    uint32_t crc_pos = w.size();
+    w.u8(0);
+    if (type == ir) {
+      write_static_chain(w, hdr);
+    }
+    write_dynamic_chain(w, hdr, f);
+    w.data()[crc_pos] = crc8.compute(w.data(), w.size());
+    if (type == ir) {
+      ctx.nof_ir++;
+      ctx.pkts_since_ir = 0;
+      metrics.nof_ir++;
+    } else {
+      metrics.nof_ir_dyn++;
+    }
+  }
+  if (type != ir) {
+    ctx.pkts_since_ir++;
+  }
+
+  ctx.hdr          = hdr;
+  ctx.f            = f;
+  ctx.ip_id_offset = ip_id_offset;
+  ctx.ts_offset    = ts_offset;
+  ctx.ts_scaled    = ts_scaled;
+  ctx.push_ref(ref);
+
+  // Replace the headers
+  sdu->msg += hdr.len;
+  sdu->N_bytes -= hdr.len;
+  sdu->msg -= w.size();
+  sdu->N_bytes += w.size();
+  memcpy(sdu->msg, w.data(), w.size());
+
+  metrics.nof_packets++;
+  metrics.orig_hdr_bytes += hdr.len;
+  metrics.rohc_hdr_bytes += w.size();
+  return true;
+}
+
+/****************************************************************************
+ * Decompressor
+ ***************************************************************************/
+
+struct rohc_decompressor::context_t {
+  rohc_hdr_t        hdr; // Headers of the last packet
+  rohc_ctx_fields_t f;
+  uint16_t          ip_id_offset = 0;
+  uint32_t          ts_offset    = 0;
+  uint32_t          ts_scaled    = 0;
+
+  // Set after a CRC failure. The packets with a 3-bit CRC are not trusted until a packet with a 7 or 8-bit CRC is
+  // decompressed, as in the Static Context state of RFC 3095 section 5.3.2.2.3
+  bool damaged = false;
+
+  void set_ts(uint32_t ts)
+  {
+    ts_offset = f.ts_stride != 0 ? ts % f.ts_stride : 0;
+    ts_scaled = f.ts_stride != 0 ? ts / f.ts_stride : 0;
+  }
+};
+
+rohc_decompressor::rohc_decompressor(const pdcp_rohc_config_t& cfg_, srslog::basic_logger& logger_) :
+  cfg(cfg_), logger(logger_), pool(4)
+{
+  max_cid = std::min((uint32_t)cfg.max_cid, rohc_max_small_cid);
+}
+
+rohc_decompressor::~rohc_decompressor()
+{
+  reset();
+}
+
+void rohc_decompressor::reset()
+{
+  for (unique_pool_ptr<context_t>& ctx : contexts) {
+    ctx.reset();
+  }
+}
+
+// Replaces the first rohc_len bytes of the PDU with the headers
+static bool replace_header(byte_buffer_t* pdu, uint32_t rohc_len, const rohc_hdr_t& hdr)
+{
+  if (pdu->get_headroom() + rohc_len < hdr.len) {
+    return false;
+  }
+  uint32_t payload_len = pdu->N_bytes - rohc_len;
+  pdu->msg += rohc_len;
+  pdu->msg -= hdr.len;
+  pdu->N_bytes = payload_len + hdr.len;
+  if (hdr.profile != rohc_profile_uncompressed) {
+    write_headers(hdr, payload_len, pdu->msg);
+  }
+  return true;
+}
+
+bool rohc_decompressor::decompress(byte_buffer_t* pdu)
+{
+  metrics.nof_packets++;
+
+  uint32_t offset = 0;
+  uint32_t cid    = 0;
+  if (pdu->N_bytes > 0 and (pdu->msg[0] & 0xf0u) == rohc_add_cid_type) {
+    cid    = pdu->msg[0] & 0x0fu;
+    offset = 1;
+  }
+  if (pdu->N_bytes <= offset or cid > max_cid) {
+    logger.warning("Dropping ROHC packet with invalid length (%d B) or CID=%d", pdu->N_bytes, cid);
+    metrics.nof_dropped++;
+    return false;
+  }
+
+  uint8_t type = pdu->msg[offset];
+  bool    ok   = false;
+  if ((type & 0xfeu) == rohc_ir_type) {
+    ok = handle_ir(pdu, cid, offset, false);
+  } else if (type == rohc_ir_dyn_type) {
+    ok = handle_ir(pdu, cid, offset, true);
+  } else if ((type & 0xf8u) == 0xf0u or type == rohc_segment_type) {
+    logger.warning("Dropping ROHC feedback or segment, not used in U-mode");
+  } else if (contexts[cid] == nullptr) {
+    logger.info("Dropping ROHC packet of CID=%d without context", cid);
+  } else {
+    ok = handle_compressed(pdu, *contexts[cid], offset);
+  }
+  if (not ok) {
+    metrics.nof_dropped++;
+  }
+  return ok;
+}
+
+bool rohc_decompressor::handle_ir(byte_buffer_t* pdu, uint32_t cid, uint32_t offset, bool is_ir_dyn)
+{
+  rohc_reader r(pdu->msg, pdu->N_bytes, offset + 1);
+  uint16_t    profile = r.u8();
+  uint8_t     crc     = r.u8();
+  bool        enabled = profile == rohc_profile_uncompressed or (profile == rohc_profile_rtp and cfg.profile_rtp) or
+                 (profile == rohc_profile_udp and cfg.profile_udp);
+  if (not r.is_ok() or not enabled) {
+    logger.warning("Dropping ROHC IR packet of CID=%d with unsupported profile 0x%04x", cid, profile);
+    return false;
+  }
+  if (is_ir_dyn and (contexts[cid] == nullptr or contexts[cid]->hdr.profile != profile)) {
+    logger.info("Dropping ROHC IR-DYN packet of CID=%d without static context", cid);
+    return false;
+  }
+
+  context_t ctx = is_ir_dyn ? *contexts[cid] : context_t{};
+  ctx.hdr.profile = profile;
+  if (profile != rohc_profile_uncompressed) {
+    if (not is_ir_dyn) {
+      read_static_chain(r, ctx.hdr);
+    }
+    if ((pdu->msg[offset] & 0x01u) != 0 or is_ir_dyn) {
+      read_dynamic_chain(r, ctx.hdr, ctx.f);
+    } else {
+      // IR packets without dynamic chain are not sent in U-mode
+      r.check(UINT32_MAX);
+    }
+  }
+  if (not r.is_ok()) {
+    logger.warning("Dropping malformed ROHC IR packet of CID=%d", cid);
+    return false;
+  }
+
+  // The CRC covers the ROHC header, with the CRC field set to zero
+  uint32_t crc_pos  = offset + 2;
+  uint8_t  zero     = 0;
+  uint8_t  comp_crc = crc8.compute(pdu->msg, crc_pos);
+  comp_crc          = crc8.compute(&zero, 1, comp_crc);
+  comp_crc          = crc8.compute(&pdu->msg[crc_pos + 1], r.position() - crc_pos - 1, comp_crc);
+  if (comp_crc != crc) {
+    logger.warning("Dropping ROHC IR packet of CID=%d with invalid CRC", cid);
+    return false;
+  }
+
+  ctx.hdr.len      = ctx.hdr.get_len();
+  ctx.ip_id_offset = ctx.hdr.ip_id - ctx.f.sn;
+  ctx.set_ts(ctx.hdr.ts);
+  if (not replace_header(pdu, r.position(), ctx.hdr)) {
+    logger.warning("Not enough headroom for the decompressed headers");
+    return false;
+  }
+
+  if (contexts[cid] == nullptr) {
+    contexts[cid] = pool.make();
+  }
+  *contexts[cid] = ctx;
+  if (is_ir_dyn) {
+    metrics.nof_ir_dyn++;
+  } else {
+    metrics.nof_ir++;
+  }
+  metrics.orig_hdr_bytes += ctx.hdr.len;
+  metrics.rohc_hdr_bytes += r.position();
+  return true;
+}
+
+bool rohc_decompressor::handle_compressed(byte_buffer_t* pdu, context_t& ctx, uint32_t offset)
+{
+  if (ctx.hdr.profile == rohc_profile_uncompressed) {
+    // Normal packet
+    pdu->msg += offset;
+    pdu->N_bytes -= offset;
+    metrics.nof_uncompressed++;
+    metrics.rohc_hdr_bytes += offset;
+    return true;
+  }
+
+  rohc_reader r(pdu->msg, pdu->N_bytes, offset);
+  rohc_hdr_t  hdr       = ctx.hdr;
+  uint16_t    sn        = ctx.f.sn;
+  uint32_t    ts_scaled = ctx.ts_scaled;
+  uint8_t     crc       = 0;
+  uint8_t     b0        = r.u8();
+
+  // UO-0, UO-1 (RTP only) and UOR-2 without extension
+  uint32_t sn_lsb = 0, sn_k = 0, ts_lsb = 0, ts_k = 0, crc_len = 0;
+  if ((b0 & 0x80u) == 0) {
+    sn_lsb  = (b0 >> 3u) & 0x0fu;
+    sn_k    = 4;
+    crc     = b0 & 0x07u;
+    crc_len = 3;
+  } else if ((b0 & 0xc0u) == 0x80u and hdr.profile == rohc_profile_rtp) {
+    uint8_t b1 = r.u8();
+    ts_lsb     = b0 & 0x3fu;
+    ts_k       = 6;
+    hdr.marker = (b1 & 0x80u) != 0;
+    sn_lsb     = (b1 >> 3u) & 0x0fu;
+    sn_k       = 4;
+    crc        = b1 & 0x07u;
+    crc_len    = 3;
+  } else if ((b0 & 0xe0u) == 0xc0u and hdr.profile == rohc_profile_rtp) {
+    uint8_t b1 = r.u8();
+    ts_lsb     = ((b0 & 0x1fu) << 1u) | (b1 >> 7u);
+    ts_k       = 6;
+    hdr.marker = (b1 & 0x40u) != 0;
+    sn_lsb     = b1 & 0x3fu;
+    sn_k       = 6;
+    crc        = r.u8();
+    crc_len    = 7;
+  } else if ((b0 & 0xe0u) == 0xc0u) {
+    sn_lsb  = b0 & 0x1fu;
+    sn_k    = 5;
+    crc     = r.u8();
+    crc_len = 7;
+  } else {
+    logger.warning("Dropping ROHC packet with unsupported type 0x%02x", b0);
+    return false;
+  }
+  if (crc_len == 3 and ctx.damaged) {
+    logger.info("Dropping ROHC packet with 3-bit CRC, the context is damaged");
+    return false;
+  }
+  if (crc_len == 7 and (crc & 0x80u) != 0) {
+    logger.warning("Dropping ROHC UOR-2 packet with extension");
+    return false;
+  }
+  if (crc_len == 3 and ts_k == 0) {
+    hdr.marker = false;
+  }
+  uint16_t ip_id = ctx.f.rnd ? r.u16() : 0;
+  if (ctx.hdr.checksum != 0) {
+    hdr.checksum = r.u16();
+  }
+  if (not r.is_ok()) {
+    logger.warning("Dropping truncated ROHC packet");
+    return false;
+  }
+
+  // Rebuilds the headers for an SN and checks them against the CRC
+  uint32_t payload_len = pdu->N_bytes - r.position();
+  uint8_t  orig[max_ip_hdr_len];
+  auto     try_sn = [&](uint16_t cand_sn) {
+    sn        = cand_sn;
+    ts_scaled = ts_k > 0 ? lsb_decode(ctx.ts_scaled, ts_lsb, ts_k, ts_lsb_p(ts_k), ~0u)
+                             : ctx.ts_scaled + (uint16_t)(sn - ctx.f.sn);
+    hdr.ip_id = ctx.f.rnd ? ip_id : (uint16_t)(sn + ctx.ip_id_offset);
+    if (hdr.profile == rohc_profile_rtp) {
+      hdr.rtp_sn = sn;
+      hdr.ts     = ts_scaled * ctx.f.ts_stride + ctx.ts_offset;
+    }
+    write_headers(hdr, payload_len, orig);
+    uint8_t c = crc_len == 3 ? crc3.compute(orig, hdr.len) : crc7.compute(orig, hdr.len);
+    return c == crc;
+  };
+
+  uint16_t decoded_sn = lsb_decode(ctx.f.sn, sn_lsb, sn_k, sn_lsb_p(sn_k), 0xffff);
+  if (not try_sn(decoded_sn)) {
+    // Local repair, RFC 3095 section 5.3.2.2.4: more than 2^k packets may have been lost
+    if (not try_sn(decoded_sn + (1u << sn_k))) {
+      logger.info("Dropping ROHC packet of SN=%d with CRC failure", decoded_sn);
+      ctx.damaged = true;
+      return false;
+    }
+    metrics.nof_repairs++;
+  }
+
+  if (not replace_header(pdu, r.position(), hdr)) {
+    logger.warning("Not enough headroom for the decompressed headers");
+    return false;
+  }
+  ctx.hdr          = hdr;
+  ctx.f.sn         = sn;
+  ctx.ts_scaled    = ts_scaled;
+  ctx.ip_id_offset = hdr.ip_id - sn;
+  ctx.damaged      = false;
+  metrics.orig_hdr_bytes += hdr.len;
+  metrics.rohc_hdr_bytes += r.position();
+  return true;
+}
+
+} // namespace srsran
@@ -0,0 +1,214 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/upper/pdcp_tx_batch.h"
+#include "srsran/upper/pdcp_entity_base.h"
+#include <algorithm>
+
+namespace srsran {
+
+// Smaller chunks are not worth the handoff to a worker thread
+static const uint32_t min_pdus_per_chunk = 16;
+
+pdcp_tx_batch::pdcp_tx_batch(const pdcp_tx_batch_args_t& args_) :
+  args(args_), logger(srslog::fetch_basic_logger("PDCP", false))
+{
+  args.max_batch_size = std::max(args.max_batch_size, 1u);
+  pending.reserve(args.max_batch_size);
+  processing.reserve(args.max_batch_size);
+  scratch.resize(args.nof_workers + 1);
+  if (args.nof_workers > 0) {
+    workers.reset(new task_thread_pool(args.nof_workers));
+  }
+  logger.info("PDCP TX batch stage: max_batch_size=%d, max_delay=%dus, nof_workers=%d",
+              args.max_batch_size,
+              args.max_delay_us,
+              args.nof_workers);
+}
+
+pdcp_tx_batch::~pdcp_tx_batch()
+{
+  if (workers != nullptr) {
+    workers->stop();
+  }
+}
+
+void pdcp_tx_batch::push(pdcp_tx_batch_pdu_t pdu)
+{
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  pdu.enqueue_time                          = now;
+  pending.push_back(std::move(pdu));
+
+  if (pending.size() >= args.max_batch_size or
+      now - pending.front().enqueue_time >= std::chrono::microseconds(args.max_delay_us)) {
+    flush_impl(true);
+  }
+}
+
+void pdcp_tx_batch::remove_entity(const pdcp_entity_base* entity)
+{
+  pending.erase(std::remove_if(pending.begin(),
+                               pending.end(),
+                               [entity](const pdcp_tx_batch_pdu_t& p) { return p.entity == entity; }),
+                pending.end());
+  // The entity may be removed while the batch being flushed is forwarded
+  for (pdcp_tx_batch_pdu_t& p : processing) {
+    if (p.entity == entity) {
+      p.entity = nullptr;
+    }
+  }
+}
+
+void pdcp_tx_batch::flush_impl(bool forced)
+{
+  // A flush triggered while the previous batch is forwarded leaves the new PDUs for the next one, to keep the order
+  if (pending.empty() or not processing.empty()) {
+    return;
+  }
+  std::swap(pending, processing);
+  uint32_t nof_pdus = processing.size();
+
+  // Split the batch in chunks, the first of which is processed by the calling thread
+  uint32_t nof_chunks = std::min((uint32_t)scratch.size(), (nof_pdus + min_pdus_per_chunk - 1) / min_pdus_per_chunk);
+  nof_chunks          = std::max(nof_chunks, 1u);
+  uint32_t chunk_size = (nof_pdus + nof_chunks - 1) / nof_chunks;
+  nof_chunks          = (nof_pdus + chunk_size - 1) / chunk_size;
+  if (nof_chunks > 1) {
+    {
+      std::lock_guard<std::mutex> lock(chunks_mutex);
+      nof_pending_chunks = nof_chunks - 1;
+    }
+    for (uint32_t i = 1; i < nof_chunks; ++i) {
+      uint32_t offset = i * chunk_size;
+      uint32_t len    = std::min(chunk_size, nof_pdus - offset);
+      workers->push_task([this, i, offset, len]() {
+        process_chunk(&processing[offset], len, scratch[i]);
+        std::lock_guard<std::mutex> lock(chunks_mutex);
+        if (--nof_pending_chunks == 0) {
+          chunks_cvar.notify_one();
+        }
+      });
+    }
+  }
+  process_chunk(processing.data(), std::min(chunk_size, nof_pdus), scratch[0]);
+  if (nof_chunks > 1) {
+    std::unique_lock<std::mutex> lock(chunks_mutex);
+    chunks_cvar.wait(lock, [this]() { return nof_pending_chunks == 0; });
+  }
+
+  // Forward the PDUs to RLC in the order they were pushed
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  for (pdcp_tx_batch_pdu_t& p : processing) {
+    uint32_t delay_us = std::chrono::duration_cast<std::chrono::microseconds>(now - p.enqueue_time).count();
+    sum_delay_us += delay_us;
+    metrics.max_delay_us = std::max(metrics.max_delay_us, delay_us);
+    if (p.entity != nullptr) {
+      p.entity->write_tx_pdu(std::move(p.pdu));
+    }
+  }
+  logger.debug("Flushed PDCP TX batch of %d PDUs in %d chunks%s", nof_pdus, nof_chunks, forced ? " (forced)" : "");
+
+  metrics.nof_batches++;
+  metrics.nof_pdus += nof_pdus;
+  metrics.max_batch_size = std::max(metrics.max_batch_size, nof_pdus);
+  metrics.nof_forced_flushes += forced ? 1 : 0;
+  processing.clear();
+}
+
+void pdcp_tx_batch::process_chunk(pdcp_tx_batch_pdu_t* pdus, uint32_t nof_pdus, chunk_scratch_t& s)
+{
+  s.eia1.clear();
+  s.eia3.clear();
+  s.eea1.clear();
+  s.eea3.clear();
+  s.macs.assign(4 * nof_pdus, 0);
+
+  // Integrity protection of the header and data part. EIA2 has no batch version, as the AES key is precomputed
+  for (uint32_t i = 0; i < nof_pdus; ++i) {
+    pdcp_tx_batch_pdu_t& p   = pdus[i];
+    uint8_t*             mac = &s.macs[4 * i];
+    switch (p.integ_algo) {
+      case INTEGRITY_ALGORITHM_ID_128_EIA1:
+        s.eia1.push_back({p.k_int, p.count, p.bearer, p.direction, p.pdu->msg, p.pdu->N_bytes, mac});
+        break;
+      case INTEGRITY_ALGORITHM_ID_128_EIA2:
+        security_128_eia2(*p.aes_k_int, p.count, p.bearer, p.direction, p.pdu->msg, p.pdu->N_bytes, mac);
+        break;
+      case INTEGRITY_ALGORITHM_ID_128_EIA3:
+        s.eia3.push_back({p.k_int, p.count, p.bearer, p.direction, p.pdu->msg, p.pdu->N_bytes, mac});
+        break;
+      default:
+        break;
+    }
+  }
+  if (not s.eia1.empty()) {
+    security_128_eia1_batch(s.eia1.data(), s.eia1.size());
+  }
+  if (not s.eia3.empty()) {
+    security_128_eia3_batch(s.eia3.data(), s.eia3.size());
+  }
+
+  // The MAC-I is appended before ciphering, as it is ciphered too
+  for (uint32_t i = 0; i < nof_pdus; ++i) {
+    pdcp_tx_batch_pdu_t& p = pdus[i];
+    if (p.append_mac) {
+      memcpy(&p.pdu->msg[p.pdu->N_bytes], &s.macs[4 * i], 4);
+      p.pdu->N_bytes += 4;
+    }
+  }
+
+  // In-place ciphering of the data part and MAC-I
+  for (uint32_t i = 0; i < nof_pdus; ++i) {
+    pdcp_tx_batch_pdu_t& p    = pdus[i];
+    uint8_t*             data = &p.pdu->msg[p.hdr_len];
+    uint32_t             len  = p.pdu->N_bytes - p.hdr_len;
+    switch (p.cipher_algo) {
+      case CIPHERING_ALGORITHM_ID_128_EEA1:
+        s.eea1.push_back({p.k_enc, p.count, p.bearer, p.direction, data, len, data});
+        break;
+      case CIPHERING_ALGORITHM_ID_128_EEA2:
+        security_128_eea2(*p.aes_k_enc, p.count, p.bearer, p.direction, data, len, data);
+        break;
+      case CIPHERING_ALGORITHM_ID_128_EEA3:
+        s.eea3.push_back({p.k_enc, p.count, p.bearer, p.direction, data, len, data});
+        break;
+      default:
+        break;
+    }
+  }
+  if (not s.eea1.empty()) {
+    security_128_eea1_batch(s.eea1.data(), s.eea1.size());
+  }
+  if (not s.eea3.empty()) {
+    security_128_eea3_batch(s.eea3.data(), s.eea3.size());
+  }
+}
+
+pdcp_tx_batch_metrics_t pdcp_tx_batch::get_metrics()
+{
+  pdcp_tx_batch_metrics_t ret = metrics;
+  ret.avg_delay_us            = metrics.nof_pdus > 0 ? sum_delay_us / (double)metrics.nof_pdus : 0;
+  metrics                     = {};
+  sum_delay_us                = 0;
+  return ret;
+}
+
+} // namespace srsran
@@ -0,0 +1,115 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#include "srsran/phy/channel/channel_batch.h"
+
+using namespace srsran;
+
+channel_batch::channel_batch(uint32_t nof_workers)
+{
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    workers.emplace_back(&channel_batch::worker_loop, this);
+  }
+}
+
+channel_batch::~channel_batch()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    running = false;
+  }
+  cvar_start.notify_all();
+  for (std::thread& t : workers) {
+    t.join();
+  }
+}
+
+void channel_batch::run(const std::vector<link_t>& links, uint32_t len, const srsran_timestamp_t& t)
+{
+  items.clear();
+  for (const link_t& link : links) {
+    if (link.ch == nullptr) {
+      continue;
+    }
+    for (uint32_t i = 0; i < link.ch->get_nof_channels(); i++) {
+      // Skip antennas without buffers, as channel::run() does
+      if (link.in[i] != nullptr && link.out[i] != nullptr) {
+        items.push_back({link.ch, i, link.in[i], link.out[i]});
+      }
+    }
+  }
+
+  nof_samples = len;
+  timestamp   = t;
+  next_item   = 0;
+
+  if (not workers.empty()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      nof_busy = workers.size();
+      run_count++;
+    }
+    cvar_start.notify_all();
+  }
+
+  run_items();
+
+  if (not workers.empty()) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cvar_done.wait(lock, [this]() { return nof_busy == 0; });
+  }
+
+  for (const link_t& link : links) {
+    if (link.ch != nullptr) {
+      link.ch->run_end(len, t);
+    }
+  }
+}
+
+void channel_batch::run_items()
+{
+  for (uint32_t i = next_item++; i < items.size(); i = next_item++) {
+    const item_t& item = items[i];
+    item.ch->run_channel(item.idx, item.in, item.out, nof_samples, timestamp);
+  }
+}
+
+void channel_batch::worker_loop()
+{
+  uint64_t                     last_run = 0;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    cvar_start.wait(lock, [this, &last_run]() { return not running or run_count != last_run; });
+    if (not running) {
+      return;
+    }
+    last_run = run_count;
+
+    lock.unlock();
+    run_items();
+    lock.lock();
+
+    if (--nof_busy == 0) {
+      cvar_done.notify_one();
+    }
+  }
+}
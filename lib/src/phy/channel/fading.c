@@ -21,6 +21,7 @@
 
 #include "srsran/phy/channel/fading.h"
 #include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/simd.h"
 #include "srsran/phy/utils/vector.h"
 #include <math.h>
 #include <stdio.h>
@@ -77,80 +78,100 @@ static inline int parse_model(srsran_channel_fading_t* q, const char* str)
   return ret;
 }
 
-#ifdef LV_HAVE_SSE
-#include <immintrin.h>
-static inline __m128 _sine(const float* table, __m128 arg)
+/*
+ * The sum-of-sinusoids terms are evaluated with a polynomial instead of the libm functions, so that all the terms of
+ * all the taps are computed in SIMD registers. The argument is wrapped to [-pi, pi] and folded to [-pi/2, pi/2], where
+ * the degree 11 Taylor polynomial of the sine has an error below 1e-7
+ */
+#define FADING_SIN_C3 (-1.0f / 6.0f)
+#define FADING_SIN_C5 (1.0f / 120.0f)
+#define FADING_SIN_C7 (-1.0f / 5040.0f)
+#define FADING_SIN_C9 (1.0f / 362880.0f)
+#define FADING_SIN_C11 (-1.0f / 39916800.0f)
+
+static inline float fading_sinf(float x)
 {
-  __m128 ret;
-  int    idx[4];
-  float  sine[4];
-
-  __m128 turns =
-      _mm_round_ps(_mm_mul_ps(arg, _mm_set1_ps(1.0f / (2.0f * (float)M_PI))), (_MM_FROUND_TO_ZERO + _MM_FROUND_NO_EXC));
-  __m128  argmod   = _mm_sub_ps(arg, _mm_mul_ps(turns, _mm_set1_ps(2.0f * (float)M_PI)));
-  __m128  indexps  = _mm_mul_ps(argmod, _mm_set1_ps(1024.0f / (2.0f * (float)M_PI)));
-  __m128i indexi32 = _mm_abs_epi32(_mm_cvtps_epi32(indexps));
-  _mm_store_si128((__m128i*)idx, indexi32);
-
-  for (int i = 0; i < 4; i++) {
-    sine[i] = table[idx[i]];
+  x -= 2.0f * (float)M_PI * rintf(x * (float)(0.5 * M_1_PI));
+  if (x > (float)M_PI_2) {
+    x = (float)M_PI - x;
+  } else if (x < -(float)M_PI_2) {
+    x = -(float)M_PI - x;
   }
 
-  ret = _mm_load_ps(sine);
-  return ret;
+  float x2 = x * x;
+  float p  = FADING_SIN_C11;
+  p        = p * x2 + FADING_SIN_C9;
+  p        = p * x2 + FADING_SIN_C7;
+  p        = p * x2 + FADING_SIN_C5;
+  p        = p * x2 + FADING_SIN_C3;
+  p        = p * x2 + 1.0f;
+  return p * x;
 }
 
-static inline __m128 _cosine(float* table, __m128 arg)
+#if SRSRAN_SIMD_F_SIZE
+static inline simd_f_t fading_simd_sin(simd_f_t x)
 {
-  arg = _mm_add_ps(arg, _mm_set1_ps((float)M_PI_2));
-  return _sine(table, arg);
+  // Adding and subtracting 1.5 * 2^23 rounds to the nearest integer, for arguments below 2^22 turns
+  const simd_f_t magic = srsran_simd_f_set1(12582912.0f);
+  simd_f_t       turns = srsran_simd_f_mul(x, srsran_simd_f_set1((float)(0.5 * M_1_PI)));
+  turns                = srsran_simd_f_sub(srsran_simd_f_add(turns, magic), magic);
+  x                    = srsran_simd_f_sub(x, srsran_simd_f_mul(turns, srsran_simd_f_set1(2.0f * (float)M_PI)));
+
+  simd_f_t pi_2 = srsran_simd_f_set1((float)M_PI_2);
+  x = srsran_simd_f_select(x, srsran_simd_f_sub(srsran_simd_f_set1((float)M_PI), x), srsran_simd_f_max(x, pi_2));
+  x = srsran_simd_f_select(
+      x, srsran_simd_f_sub(srsran_simd_f_set1(-(float)M_PI), x), srsran_simd_f_min(x, srsran_simd_f_neg(pi_2)));
+
+  simd_f_t x2 = srsran_simd_f_mul(x, x);
+  simd_f_t p  = srsran_simd_f_set1(FADING_SIN_C11);
+  p           = srsran_simd_f_add(srsran_simd_f_mul(p, x2), srsran_simd_f_set1(FADING_SIN_C9));
+  p           = srsran_simd_f_add(srsran_simd_f_mul(p, x2), srsran_simd_f_set1(FADING_SIN_C7));
+  p           = srsran_simd_f_add(srsran_simd_f_mul(p, x2), srsran_simd_f_set1(FADING_SIN_C5));
+  p           = srsran_simd_f_add(srsran_simd_f_mul(p, x2), srsran_simd_f_set1(FADING_SIN_C3));
+  p           = srsran_simd_f_add(srsran_simd_f_mul(p, x2), srsran_simd_f_set1(1.0f));
+  return srsran_simd_f_mul(p, x);
 }
-#endif /*LV_HAVE_SSE*/
+#endif /* SRSRAN_SIMD_F_SIZE */
 
-static inline cf_t
-get_doppler_dispersion(srsran_channel_fading_t* q, float t, float F_d, float* alpha, float* a, float* b)
+// Computes the doppler dispersion of all the taps at time t
+static inline void get_doppler_dispersion(srsran_channel_fading_t* q, float t, cf_t* dispersion)
 {
-#ifdef LV_HAVE_SSE
-  const float recN   = 1.0f / sqrtf(SRSRAN_CHANNEL_FADING_NTERMS);
-  cf_t        ret    = 0;
-  __m128      _reacc = _mm_setzero_ps();
-  __m128      _imacc = _mm_setzero_ps();
-  __m128      _arg   = _mm_set1_ps((float)M_PI * F_d);
-  __m128      _t     = _mm_set1_ps(t);
-  __m128      _arg_  = (_mm_mul_ps(_arg, _t));
-
-  for (int i = 0; i < SRSRAN_CHANNEL_FADING_NTERMS; i += 4) {
-    __m128 _alpha = _mm_loadu_ps(&alpha[i]);
-    __m128 _a     = _mm_loadu_ps(&a[i]);
-    __m128 _b     = _mm_loadu_ps(&b[i]);
-    __m128 _arg1  = _mm_mul_ps(_arg_, _cosine(q->sin_table, _alpha));
-    __m128 _re    = _cosine(q->sin_table, _mm_add_ps(_arg1, _a));
-    __m128 _im    = _sine(q->sin_table, _mm_add_ps(_arg1, _b));
-    _reacc        = _mm_add_ps(_reacc, _re);
-    _imacc        = _mm_add_ps(_imacc, _im);
+  const uint32_t nof_terms = nof_taps[q->model] * SRSRAN_CHANNEL_FADING_NTERMS;
+  const float*   w         = &q->coeff_w[0][0];
+  const float*   a         = &q->coeff_a[0][0];
+  const float*   b         = &q->coeff_b[0][0];
+  float          re[SRSRAN_CHANNEL_FADING_MAXTAPS * SRSRAN_CHANNEL_FADING_NTERMS];
+  float          im[SRSRAN_CHANNEL_FADING_MAXTAPS * SRSRAN_CHANNEL_FADING_NTERMS];
+
+  uint32_t i = 0;
+#if SRSRAN_SIMD_F_SIZE
+  simd_f_t _t    = srsran_simd_f_set1(t);
+  simd_f_t _pi_2 = srsran_simd_f_set1((float)M_PI_2);
+  for (; i + SRSRAN_SIMD_F_SIZE <= nof_terms; i += SRSRAN_SIMD_F_SIZE) {
+    simd_f_t _arg = srsran_simd_f_mul(srsran_simd_f_loadu(&w[i]), _t);
+    simd_f_t _re  = srsran_simd_f_add(_arg, srsran_simd_f_add(srsran_simd_f_loadu(&a[i]), _pi_2));
+    simd_f_t _im  = srsran_simd_f_add(_arg, srsran_simd_f_loadu(&b[i]));
+    srsran_simd_f_storeu(&re[i], fading_simd_sin(_re));
+    srsran_simd_f_storeu(&im[i], fading_simd_sin(_im));
+  }
+#endif /* SRSRAN_SIMD_F_SIZE */
+  for (; i < nof_terms; i++) {
+    float arg = w[i] * t;
+    re[i]     = fading_sinf(arg + a[i] + (float)M_PI_2);
+    im[i]     = fading_sinf(arg + b[i]);
   }
 
-  __m128 _tmp = _mm_hadd_ps(_reacc, _imacc);
-  _tmp        = _mm_hadd_ps(_tmp, _tmp);
-  float r[4];
-  _mm_store_ps(r, _tmp);
-  __real__ ret = r[0];
-  __imag__ ret = r[1];
-
-  return ret * recN;
-
-#else
   const float recN = 1.0f / sqrtf(SRSRAN_CHANNEL_FADING_NTERMS);
-  cf_t        r    = 0;
-
-  for (uint32_t i = 0; i < SRSRAN_CHANNEL_FADING_NTERMS; i++) {
-    float arg = (float)M_PI * F_d * cosf(alpha[i]) * t;
-    __real__ r += cosf(arg + a[i]);
-    __imag__ r += sinf(arg + b[i]);
+  for (uint32_t tap = 0; tap < nof_taps[q->model]; tap++) {
+    float sum_re = 0.0f;
+    float sum_im = 0.0f;
+    for (uint32_t j = 0; j < SRSRAN_CHANNEL_FADING_NTERMS; j++) {
+      sum_re += re[tap * SRSRAN_CHANNEL_FADING_NTERMS + j];
+      sum_im += im[tap * SRSRAN_CHANNEL_FADING_NTERMS + j];
+    }
+    __real__ dispersion[tap] = recN * sum_re;
+    __imag__ dispersion[tap] = recN * sum_im;
   }
-
-  return recN * r;
-#endif /*LV_HAVE_SSE*/
 }
 
 static inline void generate_tap(float delay_ns, float power_db, float srate, cf_t* buf, uint32_t N, uint32_t path_delay)
@@ -162,30 +183,41 @@ static inline void generate_tap(float delay_ns, float power_db, float srate, cf_
   srsran_vec_gen_sine(a0, -O, buf, N);
 }
 
-static inline void generate_taps(srsran_channel_fading_t* q, float time)
+// Computes the frequency response from the taps at the given time, and applies it to q->y_freq in the same pass
+static inline void generate_taps_and_apply(srsran_channel_fading_t* q, float time)
 {
-  // Generate taps
-  for (int i = 0; i < nof_taps[q->model]; i++) {
-    // Compute phase for the doppler dispersion
-    cf_t a = get_doppler_dispersion(q, time, q->doppler, q->coeff_alpha[i], q->coeff_a[i], q->coeff_b[i]);
-
-    if (i) {
-      // Copy tap frequency response
-      srsran_vec_sc_prod_ccc(q->h_tap[i], a, q->temp, q->N);
-
-      // Add to frequency response, shifts FFT at same time
-      srsran_vec_sum_ccc(q->h_freq, &q->temp[q->N / 2], q->h_freq, q->N / 2);
-      srsran_vec_sum_ccc(&q->h_freq[q->N / 2], q->temp, &q->h_freq[q->N / 2], q->N / 2);
-    } else {
-      // Copy tap frequency response
-      srsran_vec_sc_prod_ccc(&q->h_tap[i][q->N / 2], a, q->h_freq, q->N / 2);
-      srsran_vec_sc_prod_ccc(&q->h_tap[i][0], a, &q->h_freq[q->N / 2], q->N / 2);
+  const uint32_t ntaps = nof_taps[q->model];
+  cf_t           a[SRSRAN_CHANNEL_FADING_MAXTAPS];
+
+  get_doppler_dispersion(q, time, a);
+
+  uint32_t k = 0;
+#if SRSRAN_SIMD_CF_SIZE
+  simd_cf_t _a[SRSRAN_CHANNEL_FADING_MAXTAPS];
+  for (uint32_t i = 0; i < ntaps; i++) {
+    _a[i] = srsran_simd_cf_set1(a[i]);
+  }
+  for (; k + SRSRAN_SIMD_CF_SIZE <= q->N; k += SRSRAN_SIMD_CF_SIZE) {
+    simd_cf_t h = srsran_simd_cf_prod(srsran_simd_cfi_load(&q->h_tap[0][k]), _a[0]);
+    for (uint32_t i = 1; i < ntaps; i++) {
+      h = srsran_simd_cf_add(h, srsran_simd_cf_prod(srsran_simd_cfi_load(&q->h_tap[i][k]), _a[i]));
+    }
+    srsran_simd_cfi_store(&q->h_freq[k], h);
+    srsran_simd_cfi_store(&q->y_freq[k], srsran_simd_cf_prod(srsran_simd_cfi_load(&q->y_freq[k]), h));
+  }
+#endif /* SRSRAN_SIMD_CF_SIZE */
+  for (; k < q->N; k++) {
+    cf_t h = q->h_tap[0][k] * a[0];
+    for (uint32_t i = 1; i < ntaps; i++) {
+      h += q->h_tap[i][k] * a[i];
     }
+    q->h_freq[k] = h;
+    q->y_freq[k] *= h;
   }
-  // at this stage, q->h_freq should contain the frequency response
 }
 
-static inline void filter_segment(srsran_channel_fading_t* q, const cf_t* input, cf_t* output, uint32_t nsamples)
+static inline void
+filter_segment(srsran_channel_fading_t* q, const cf_t* input, cf_t* output, uint32_t nsamples, float time)
 {
   // Fill Input vector
   srsran_vec_cf_copy(q->temp, input, nsamples);
@@ -195,20 +227,19 @@ static inline void filter_segment(srsran_channel_fading_t* q, const cf_t* input,
   srsran_dft_run_c_zerocopy(&q->fft, q->temp, q->y_freq);
 
   // Apply channel
-  srsran_vec_prod_ccc(q->y_freq, q->h_freq, q->y_freq, q->N);
+  generate_taps_and_apply(q, time);
 
   // Do iFFT
   srsran_dft_run_c_zerocopy(&q->ifft, q->y_freq, q->temp);
 
-  // Add state
-  srsran_vec_sum_ccc(q->temp, q->state, q->temp, q->state_len);
-
-  // Copy the first nsamples into the output
-  srsran_vec_cf_copy(output, q->temp, nsamples);
+  // Add state into the first nsamples, which go to the output. The state is zero beyond state_len
+  srsran_vec_sum_ccc(q->temp, q->state, output, nsamples);
 
-  // Copy the rest of the samples into the state
+  // Add the rest of the state to the rest of the samples, which become the new state. The state is shifted in place,
+  // which is safe since the sum reads ahead of where it writes
   q->state_len = q->N - nsamples;
-  srsran_vec_cf_copy(q->state, &q->temp[nsamples], q->state_len);
+  srsran_vec_sum_ccc(&q->temp[nsamples], &q->state[nsamples], q->state, q->state_len);
+  srsran_vec_cf_zero(&q->state[q->state_len], nsamples);
 }
 
 int srsran_channel_fading_init(srsran_channel_fading_t* q, double srate, const char* model, uint32_t seed)
@@ -242,6 +273,7 @@ int srsran_channel_fading_init(srsran_channel_fading_t* q, double srate, const c
         q->coeff_a[i][j]     = srsran_random_uniform_real_dist(random, 0, 2.0f * (float)M_PI);
         q->coeff_b[i][j]     = srsran_random_uniform_real_dist(random, 0, 2.0f * (float)M_PI);
         q->coeff_alpha[i][j] = ((float)M_PI * ((float)i - (float)0.5f)) / (2.0f * nof_taps[q->model]);
+        q->coeff_w[i][j]     = (float)M_PI * q->doppler * cosf(q->coeff_alpha[i][j]);
       }
 
       // Allocate tap frequency response
@@ -250,11 +282,13 @@ int srsran_channel_fading_init(srsran_channel_fading_t* q, double srate, const c
       // Generate tap frequency response
       generate_tap(
           excess_tap_delay_ns[q->model][i], relative_power_db[q->model][i], q->srate, q->h_tap[i], q->N, q->path_delay);
-    }
 
-    // Generate sine Table
-    for (uint32_t i = 0; i < 1024; i++) {
-      q->sin_table[i] = sinf((float)i * 2.0f * (float)M_PI / 1024);
+      // Shift it, so that the weighted taps add up to the shifted frequency response
+      for (uint32_t k = 0; k < q->N / 2; k++) {
+        cf_t tmp                  = q->h_tap[i][k];
+        q->h_tap[i][k]            = q->h_tap[i][k + q->N / 2];
+        q->h_tap[i][k + q->N / 2] = tmp;
+      }
     }
 
     // Free random
@@ -345,14 +379,11 @@ double srsran_channel_fading_execute(srsran_channel_fading_t* q,
 
   if (q) {
     while (counter < nsamples) {
-      // Generate taps
-      generate_taps(q, (float)init_time);
-
       // Do not process more than N/2 samples
       uint32_t n = SRSRAN_MIN(q->N / 2, nsamples - counter);
 
-      // Execute
-      filter_segment(q, &in[counter], &out[counter], n);
+      // Execute, the taps are generated for the segment start time
+      filter_segment(q, &in[counter], &out[counter], n, (float)init_time);
 
       // Increment time
       init_time += n / q->srate;
@@ -36,13 +36,16 @@
 static bool enable_gui = false;
 #endif /* ENABLE_GUI */
 
-static srsran_channel_fading_t channel_fading;
+#define MAX_NOF_LINKS 64
+
+static srsran_channel_fading_t channel_fading[MAX_NOF_LINKS];
 
 static char     default_model[] = "epa5";
 static uint32_t duration_ms     = 1000;
 static char*    model           = default_model;
 static uint32_t srate           = (uint32_t)30.72e6;
 static uint32_t random_seed     = 0x12345678; // Default seed, deterministic channel
+static uint32_t nof_links       = 1;
 
 #define INPUT_TYPE 0 /* 0: Dirac Delta; Otherwise: Random*/
 
@@ -53,6 +56,7 @@ static void usage(char* prog)
   printf("\t-t Simulation time in ms: [Default %d]\n", duration_ms);
   printf("\t-s Sampling rate in Hz: [Default %d]\n", srate);
   printf("\t-r Random generator seed: [Default %d]\n", random_seed);
+  printf("\t-n Number of links emulated in the same thread: [Default %d]\n", nof_links);
 #ifdef ENABLE_GUI
   printf("\t-g Enable GUI: [Default %s]\n", enable_gui ? "enabled" : "disabled");
 #endif /* ENABLE_GUI */
@@ -61,7 +65,7 @@ static void usage(char* prog)
 static int parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "mtsrg")) != -1) {
+  while ((opt = getopt(argc, argv, "mtsrng")) != -1) {
     switch (opt) {
       case 'm':
         model = argv[optind];
@@ -75,6 +79,9 @@ static int parse_args(int argc, char** argv)
       case 'r':
         random_seed = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
+      case 'n':
+        nof_links = SRSRAN_MIN((uint32_t)strtol(argv[optind], NULL, 10), MAX_NOF_LINKS);
+        break;
       case 'g':
 #ifdef ENABLE_GUI
         enable_gui = (enable_gui) ? false : true;
@@ -158,10 +165,12 @@ int main(int argc, char** argv)
   }
 #endif /* ENABLE_GUI */
 
-  // Initialise channel
-  if (srsran_channel_fading_init(&channel_fading, srate, model, 0x12345678)) {
-    fprintf(stderr, "Error: initialising fading channel. model=%s, srate=%d\n", model, srate);
-    goto clean_exit;
+  // Initialise channels
+  for (uint32_t l = 0; l < nof_links; l++) {
+    if (srsran_channel_fading_init(&channel_fading[l], srate, model, random_seed + l)) {
+      fprintf(stderr, "Error: initialising fading channel. model=%s, srate=%d\n", model, srate);
+      goto clean_exit;
+    }
   }
 
   // Allocate buffers
@@ -187,14 +196,17 @@ int main(int argc, char** argv)
     goto clean_exit;
   }
 
-  printf("-- Starting Fading channel simulator. srate=%.2fMHz; model=%s; duration=%dms\n",
+  printf("-- Starting Fading channel simulator. srate=%.2fMHz; model=%s; duration=%dms; links=%d\n",
          (double)srate / 1e6,
          model,
-         duration_ms);
+         duration_ms,
+         nof_links);
 
   for (int i = 0; i < duration_ms; i++) {
     gettimeofday(&t[1], NULL);
-    srsran_channel_fading_execute(&channel_fading, input_buffer, output_buffer, srate / 1000, (double)i / 1000.0);
+    for (uint32_t l = 0; l < nof_links; l++) {
+      srsran_channel_fading_execute(&channel_fading[l], input_buffer, output_buffer, srate / 1000, (double)i / 1000.0);
+    }
     gettimeofday(&t[2], NULL);
     get_time_interval(t);
     time_usec += (uint64_t)(t->tv_sec * 1e6 + t->tv_usec);
@@ -208,26 +220,26 @@ int main(int argc, char** argv)
       }
       plot_real_setNewData(&plot_fft, fft_mag, srate / 1000);
 
-      for (int j = 0; j < channel_fading.N; j++) {
-        fft_mag[j] = srsran_convert_amplitude_to_dB(cabsf(channel_fading.h_freq[j]));
+      for (int j = 0; j < channel_fading[0].N; j++) {
+        fft_mag[j] = srsran_convert_amplitude_to_dB(cabsf(channel_fading[0].h_freq[j]));
       }
-      plot_real_setNewData(&plot_h, fft_mag, channel_fading.N);
+      plot_real_setNewData(&plot_h, fft_mag, channel_fading[0].N);
 
       for (int j = 0; j < srate / 1000; j++) {
         imp[j] = cabsf(output_buffer[j]);
       }
-      plot_real_setNewData(&plot_imp, imp, channel_fading.N);
+      plot_real_setNewData(&plot_imp, imp, channel_fading[0].N);
 
       usleep(1000);
     }
 #endif /* ENABLE_GUI */
   }
 
-  // Print results and exit
+  // Print results and exit, the real-time factor is the emulated time over the processing time of all the links
   double msps = 0;
   if (time_usec) {
-    msps = duration_ms * (srate / 1000.0) / (double)time_usec;
-    printf("Ok ... %.1f MSps\n", msps);
+    msps = nof_links * duration_ms * (srate / 1000.0) / (double)time_usec;
+    printf("Ok ... %.1f MSps; real-time factor %.2f\n", msps, duration_ms * 1000.0 / (double)time_usec);
     ret = SRSRAN_SUCCESS;
   } else {
     printf("Error in Msps calculation: undefined division\n");
@@ -257,6 +269,8 @@ clean_exit:
   if (output_buffer) {
     free(output_buffer);
   }
-  srsran_channel_fading_free(&channel_fading);
+  for (uint32_t l = 0; l < nof_links; l++) {
+    srsran_channel_fading_free(&channel_fading[l]);
+  }
   return ret;
 }
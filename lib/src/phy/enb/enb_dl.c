@@ -438,6 +438,13 @@ int srsran_enb_dl_put_pdsch(srsran_enb_dl_t* q, srsran_pdsch_cfg_t* pdsch, uint8
   return srsran_pdsch_encode(&q->pdsch, &q->dl_sf, pdsch, data, q->sf_symbols);
 }
 
+int srsran_enb_dl_put_pdsch_iov(srsran_enb_dl_t*           q,
+                                srsran_pdsch_cfg_t*        pdsch,
+                                const srsran_sch_tb_iov_t* tb_iov[SRSRAN_MAX_CODEWORDS])
+{
+  return srsran_pdsch_encode_iov(&q->pdsch, &q->dl_sf, pdsch, tb_iov, q->sf_symbols);
+}
+
 int srsran_enb_dl_put_pmch(srsran_enb_dl_t* q, srsran_pmch_cfg_t* pmch_cfg, uint8_t* data)
 {
   return srsran_pmch_encode(&q->pmch, &q->dl_sf, pmch_cfg, data, q->sf_symbols);
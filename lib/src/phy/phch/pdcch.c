@@ -41,6 +41,9 @@
 #define PDCCH_FORMAT_NOF_REGS(i) ((1 << i) * 9)
 #define PDCCH_FORMAT_NOF_BITS(i) ((1 << i) * 72)
 
+// Locations with a lower absolute mean of the LLRs carry no DCI and are not decoded
+#define PDCCH_LLR_MEAN_THRESHOLD 0.3f
+
 #define NOF_CCE(cfi) ((cfi > 0 && cfi < 4) ? q->nof_cce[cfi - 1] : 0)
 #define NOF_REGS(cfi) ((cfi > 0 && cfi < 4) ? q->nof_regs[cfi - 1] : 0)
 
@@ -369,51 +372,144 @@ int srsran_pdcch_dci_decode(srsran_pdcch_t* q, float* e, uint8_t* data, uint32_t
   }
 }
 
+static bool pdcch_location_fits(srsran_pdcch_t* q, srsran_dl_sf_cfg_t* sf, srsran_dci_location_t* location)
+{
+  return location->ncce * 72 + PDCCH_FORMAT_NOF_BITS(location->L) <= NOF_CCE(sf->cfi) * 72;
+}
+
+float srsran_pdcch_location_llr_mean(srsran_pdcch_t* q, srsran_dl_sf_cfg_t* sf, srsran_dci_location_t* location)
+{
+  if (q == NULL || location == NULL || !srsran_dci_location_isvalid(location) ||
+      !pdcch_location_fits(q, sf, location)) {
+    return 0.0f;
+  }
+
+  uint32_t e_bits = PDCCH_FORMAT_NOF_BITS(location->L);
+
+  // Compute absolute mean of the LLRs
+  double mean = 0;
+  for (int i = 0; i < e_bits; i++) {
+    mean += fabsf(q->llr[location->ncce * 72 + i]);
+  }
+  return (float)(mean / e_bits);
+}
+
+uint32_t srsran_pdcch_rank_locations(srsran_pdcch_t*        q,
+                                     srsran_dl_sf_cfg_t*    sf,
+                                     srsran_dci_location_t* locations,
+                                     uint32_t               nof_locations)
+{
+  if (q == NULL || locations == NULL) {
+    return 0;
+  }
+
+  // Keep the candidates above the decoding threshold, with an insertion sort by decreasing mean. The sort is stable,
+  // so candidates with the same energy keep the search space order
+  float    mean[SRSRAN_PDCCH_MAX_RANKED];
+  uint32_t nof_ranked = 0;
+  for (uint32_t i = 0; i < nof_locations; i++) {
+    srsran_dci_location_t loc = locations[i];
+    float                 m   = srsran_pdcch_location_llr_mean(q, sf, &loc);
+    if (m <= PDCCH_LLR_MEAN_THRESHOLD) {
+      INFO("Skipping location: nCCE=%d, L=%d, mean=%f", loc.ncce, loc.L, m);
+      continue;
+    }
+    if (nof_ranked == SRSRAN_PDCCH_MAX_RANKED) {
+      ERROR("Can't rank more than %d locations", SRSRAN_PDCCH_MAX_RANKED);
+      break;
+    }
+    uint32_t j = nof_ranked;
+    while (j > 0 && mean[j - 1] < m) {
+      mean[j]      = mean[j - 1];
+      locations[j] = locations[j - 1];
+      j--;
+    }
+    mean[j]      = m;
+    locations[j] = loc;
+    nof_ranked++;
+  }
+  return nof_ranked;
+}
+
+static srsran_pdcch_decoded_t* pdcch_find_decoded(srsran_pdcch_t* q, srsran_dci_location_t* location, uint32_t nof_bits)
+{
+  for (uint32_t i = 0; i < q->nof_decoded; i++) {
+    srsran_pdcch_decoded_t* d = &q->decoded[i];
+    if (d->location.ncce == location->ncce && d->location.L == location->L && d->nof_bits == nof_bits) {
+      return d;
+    }
+  }
+  return NULL;
+}
+
 /** Tries to decode a DCI message from the LLRs stored in the srsran_pdcch_t structure by the function
  * srsran_pdcch_extract_llr(). This function can be called multiple times.
  * The location to search for is obtained from msg.
  * The decoded message is stored in msg and the CRC remainder in msg->rnti
- *
+ * Since the CRC remainder does not depend on the RNTI searched, the messages decoded in a location are saved until
+ * the next LLR extraction and reused by all the formats and RNTIs with the same payload size
  */
 int srsran_pdcch_decode_msg(srsran_pdcch_t* q, srsran_dl_sf_cfg_t* sf, srsran_dci_cfg_t* dci_cfg, srsran_dci_msg_t* msg)
 {
   int ret = SRSRAN_ERROR_INVALID_INPUTS;
   if (q != NULL && msg != NULL && srsran_dci_location_isvalid(&msg->location)) {
-    if (msg->location.ncce * 72 + PDCCH_FORMAT_NOF_BITS(msg->location.L) > NOF_CCE(sf->cfi) * 72) {
+    if (!pdcch_location_fits(q, sf, &msg->location)) {
       ERROR("Invalid location: nCCE: %d, L: %d, NofCCE: %d", msg->location.ncce, msg->location.L, NOF_CCE(sf->cfi));
     } else {
       ret = SRSRAN_SUCCESS;
 
-      uint32_t nof_bits = srsran_dci_format_sizeof(&q->cell, sf, dci_cfg, msg->format);
-      uint32_t e_bits   = PDCCH_FORMAT_NOF_BITS(msg->location.L);
-
-      // Compute absolute mean of the LLRs
-      double mean = 0;
-      for (int i = 0; i < e_bits; i++) {
-        mean += fabsf(q->llr[msg->location.ncce * 72 + i]);
-      }
-      mean /= e_bits;
-
-      if (mean > 0.3f) {
-        ret = srsran_pdcch_dci_decode(q, &q->llr[msg->location.ncce * 72], msg->payload, e_bits, nof_bits, &msg->rnti);
-        if (ret == SRSRAN_SUCCESS) {
-          msg->nof_bits = nof_bits;
-          // Check format differentiation
-          if (msg->format == SRSRAN_DCI_FORMAT0 || msg->format == SRSRAN_DCI_FORMAT1A) {
-            msg->format = (msg->payload[dci_cfg->cif_enabled ? 3 : 0] == 0) ? SRSRAN_DCI_FORMAT0 : SRSRAN_DCI_FORMAT1A;
+      uint32_t                nof_bits = srsran_dci_format_sizeof(&q->cell, sf, dci_cfg, msg->format);
+      uint32_t                e_bits   = PDCCH_FORMAT_NOF_BITS(msg->location.L);
+      srsran_pdcch_decoded_t* decoded  = pdcch_find_decoded(q, &msg->location, nof_bits);
+      bool                    is_valid = false;
+
+      if (decoded != NULL) {
+        memcpy(msg->payload, decoded->payload, nof_bits);
+        msg->rnti = decoded->crc_rem;
+        is_valid  = true;
+        q->nof_cache_hits++;
+        INFO("Reusing DCI:   nCCE=%d, L=%d, msg_len=%d", msg->location.ncce, msg->location.L, nof_bits);
+      } else {
+        float mean = srsran_pdcch_location_llr_mean(q, sf, &msg->location);
+
+        if (mean > PDCCH_LLR_MEAN_THRESHOLD) {
+          ret = srsran_pdcch_dci_decode(
+              q, &q->llr[msg->location.ncce * 72], msg->payload, e_bits, nof_bits, &msg->rnti);
+          if (ret == SRSRAN_SUCCESS) {
+            is_valid = true;
+            q->nof_decodes++;
+            if (q->nof_decoded < SRSRAN_PDCCH_MAX_DECODED) {
+              decoded           = &q->decoded[q->nof_decoded++];
+              decoded->location = msg->location;
+              decoded->nof_bits = nof_bits;
+              decoded->crc_rem  = msg->rnti;
+              memcpy(decoded->payload, msg->payload, nof_bits);
+            }
+          } else {
+            ERROR("Error calling pdcch_dci_decode");
           }
+          INFO("Decoded DCI: nCCE=%d, L=%d, format=%s, msg_len=%d, mean=%f, crc_rem=0x%x",
+               msg->location.ncce,
+               msg->location.L,
+               srsran_dci_format_string(msg->format),
+               nof_bits,
+               mean,
+               msg->rnti);
         } else {
-          ERROR("Error calling pdcch_dci_decode");
+          INFO("Skipping DCI:  nCCE=%d, L=%d, msg_len=%d, mean=%f",
+               msg->location.ncce,
+               msg->location.L,
+               nof_bits,
+               mean);
+        }
+      }
+
+      if (is_valid) {
+        msg->nof_bits = nof_bits;
+        // Check format differentiation
+        if (msg->format == SRSRAN_DCI_FORMAT0 || msg->format == SRSRAN_DCI_FORMAT1A) {
+          msg->format = (msg->payload[dci_cfg->cif_enabled ? 3 : 0] == 0) ? SRSRAN_DCI_FORMAT0 : SRSRAN_DCI_FORMAT1A;
         }
-        INFO("Decoded DCI: nCCE=%d, L=%d, format=%s, msg_len=%d, mean=%f, crc_rem=0x%x",
-             msg->location.ncce,
-             msg->location.L,
-             srsran_dci_format_string(msg->format),
-             nof_bits,
-             mean,
-             msg->rnti);
-      } else {
-        INFO("Skipping DCI:  nCCE=%d, L=%d, msg_len=%d, mean=%f", msg->location.ncce, msg->location.L, nof_bits, mean);
       }
     }
   } else if (msg != NULL) {
@@ -462,6 +558,7 @@ int srsran_pdcch_extract_llr(srsran_pdcch_t*        q,
     nof_symbols     = e_bits / 2;
     ret             = SRSRAN_ERROR;
     srsran_vec_f_zero(q->llr, q->max_bits);
+    q->nof_decoded = 0;
 
     DEBUG("Extracting LLRs: E: %d, SF: %d, CFI: %d", e_bits, sf->tti % 10, sf->cfi);
 
@@ -957,13 +957,14 @@ int srsran_pdsch_decode(srsran_pdsch_t*        q,
   }
 }
 
-static int srsran_pdsch_codeword_encode(srsran_pdsch_t*         q,
-                                        srsran_dl_sf_cfg_t*     sf,
-                                        srsran_pdsch_cfg_t*     cfg,
-                                        srsran_softbuffer_tx_t* softbuffer,
-                                        uint8_t*                data,
-                                        uint32_t                tb_idx,
-                                        uint32_t                nof_layers)
+static int srsran_pdsch_codeword_encode(srsran_pdsch_t*            q,
+                                        srsran_dl_sf_cfg_t*        sf,
+                                        srsran_pdsch_cfg_t*        cfg,
+                                        srsran_softbuffer_tx_t*    softbuffer,
+                                        uint8_t*                   data,
+                                        const srsran_sch_tb_iov_t* tb_iov,
+                                        uint32_t                   tb_idx,
+                                        uint32_t                   nof_layers)
 {
   srsran_ra_tb_t* mcs = &cfg->grant.tb[tb_idx];
   uint32_t        rv  = cfg->grant.tb[tb_idx].rv;
@@ -989,7 +990,9 @@ static int srsran_pdsch_codeword_encode(srsran_pdsch_t*         q,
     }
 
     /* Channel coding */
-    if (srsran_dlsch_encode2(&q->dl_sch, cfg, data, q->e[codeword_idx], tb_idx, nof_layers)) {
+    int n = tb_iov ? srsran_dlsch_encode2_iov(&q->dl_sch, cfg, tb_iov, q->e[codeword_idx], tb_idx, nof_layers)
+                   : srsran_dlsch_encode2(&q->dl_sch, cfg, data, q->e[codeword_idx], tb_idx, nof_layers);
+    if (n) {
       ERROR("Error encoding (TB%d -> CW%d)", tb_idx, codeword_idx);
       return SRSRAN_ERROR;
     }
@@ -1014,11 +1017,12 @@ static int srsran_pdsch_codeword_encode(srsran_pdsch_t*         q,
   return SRSRAN_SUCCESS;
 }
 
-int srsran_pdsch_encode(srsran_pdsch_t*     q,
-                        srsran_dl_sf_cfg_t* sf,
-                        srsran_pdsch_cfg_t* cfg,
-                        uint8_t*            data[SRSRAN_MAX_CODEWORDS],
-                        cf_t*               sf_symbols[SRSRAN_MAX_PORTS])
+static int pdsch_encode(srsran_pdsch_t*            q,
+                        srsran_dl_sf_cfg_t*        sf,
+                        srsran_pdsch_cfg_t*        cfg,
+                        uint8_t*                   data[SRSRAN_MAX_CODEWORDS],
+                        const srsran_sch_tb_iov_t* tb_iov[SRSRAN_MAX_CODEWORDS],
+                        cf_t*                      sf_symbols[SRSRAN_MAX_PORTS])
 {
   int i;
   /* Set pointers for layermapping & precoding */
@@ -1059,8 +1063,14 @@ int srsran_pdsch_encode(srsran_pdsch_t*     q,
     /* Implementation of 3GPP 36.212 Table 5.3.3.1.5-1 and Table 5.3.3.1.5-2 */
     for (uint32_t tb_idx = 0; tb_idx < SRSRAN_MAX_TB; tb_idx++) {
       if (cfg->grant.tb[tb_idx].enabled) {
-        ret |= srsran_pdsch_codeword_encode(
-            q, sf, cfg, cfg->softbuffers.tx[tb_idx], data[tb_idx], tb_idx, cfg->grant.nof_layers);
+        ret |= srsran_pdsch_codeword_encode(q,
+                                            sf,
+                                            cfg,
+                                            cfg->softbuffers.tx[tb_idx],
+                                            data ? data[tb_idx] : NULL,
+                                            tb_iov ? tb_iov[tb_idx] : NULL,
+                                            tb_idx,
+                                            cfg->grant.nof_layers);
       }
     }
 
@@ -1140,6 +1150,24 @@ int srsran_pdsch_encode(srsran_pdsch_t*     q,
   return ret;
 }
 
+int srsran_pdsch_encode(srsran_pdsch_t*     q,
+                        srsran_dl_sf_cfg_t* sf,
+                        srsran_pdsch_cfg_t* cfg,
+                        uint8_t*            data[SRSRAN_MAX_CODEWORDS],
+                        cf_t*               sf_symbols[SRSRAN_MAX_PORTS])
+{
+  return pdsch_encode(q, sf, cfg, data, NULL, sf_symbols);
+}
+
+int srsran_pdsch_encode_iov(srsran_pdsch_t*            q,
+                            srsran_dl_sf_cfg_t*        sf,
+                            srsran_pdsch_cfg_t*        cfg,
+                            const srsran_sch_tb_iov_t* tb_iov[SRSRAN_MAX_CODEWORDS],
+                            cf_t*                      sf_symbols[SRSRAN_MAX_PORTS])
+{
+  return pdsch_encode(q, sf, cfg, NULL, tb_iov, sf_symbols);
+}
+
 int srsran_pdsch_select_pmi(srsran_pdsch_t*        q,
                             srsran_chest_dl_res_t* channel,
                             uint32_t               nof_layers,
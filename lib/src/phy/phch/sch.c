@@ -237,15 +237,91 @@ float srsran_sch_last_noi(srsran_sch_t* q)
 /* Encode a transport block according to 36.212 5.3.2
  *
  */
-static int encode_tb_off(srsran_sch_t*           q,
-                         srsran_softbuffer_tx_t* softbuffer,
-                         srsran_cbsegm_t*        cb_segm,
-                         uint32_t                Qm,
-                         uint32_t                rv,
-                         uint32_t                nof_e_bits,
-                         uint8_t*                data,
-                         uint8_t*                e_bits,
-                         uint32_t                w_offset)
+void srsran_sch_tb_iov_reset(srsran_sch_tb_iov_t* tb_iov)
+{
+  tb_iov->nof_iov = 0;
+}
+
+int srsran_sch_tb_iov_push(srsran_sch_tb_iov_t* tb_iov, const uint8_t* ptr, uint32_t len)
+{
+  if (len == 0) {
+    return SRSRAN_SUCCESS;
+  }
+  if (tb_iov->nof_iov >= SRSRAN_SCH_MAX_IOV || ptr == NULL) {
+    return SRSRAN_ERROR;
+  }
+  // Merge with the previous fragment when contiguous
+  if (tb_iov->nof_iov > 0) {
+    srsran_sch_iov_t* last = &tb_iov->iov[tb_iov->nof_iov - 1];
+    if (last->ptr + last->len == ptr) {
+      last->len += len;
+      return SRSRAN_SUCCESS;
+    }
+  }
+  tb_iov->iov[tb_iov->nof_iov].ptr = ptr;
+  tb_iov->iov[tb_iov->nof_iov].len = len;
+  tb_iov->nof_iov++;
+  return SRSRAN_SUCCESS;
+}
+
+uint32_t srsran_sch_tb_iov_len(const srsran_sch_tb_iov_t* tb_iov)
+{
+  uint32_t len = 0;
+  for (uint32_t i = 0; i < tb_iov->nof_iov; i++) {
+    len += tb_iov->iov[i].len;
+  }
+  return len;
+}
+
+uint32_t srsran_sch_tb_iov_gather(const srsran_sch_tb_iov_t* tb_iov, uint8_t* dst, uint32_t max_len)
+{
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < tb_iov->nof_iov && n < max_len; i++) {
+    uint32_t len = SRSRAN_MIN(tb_iov->iov[i].len, max_len - n);
+    memcpy(&dst[n], tb_iov->iov[i].ptr, len);
+    n += len;
+  }
+  return n;
+}
+
+/* Sequential reader over a TB fragment list. Code blocks are read in order, so the position is kept between calls
+ * instead of seeking from the first fragment every time.
+ */
+typedef struct {
+  const srsran_sch_tb_iov_t* tb_iov;
+  uint32_t                   idx;
+  uint32_t                   offset;
+} sch_iov_reader_t;
+
+static void sch_iov_read(sch_iov_reader_t* r, uint8_t* dst, uint32_t len)
+{
+  while (len > 0 && r->idx < r->tb_iov->nof_iov) {
+    const srsran_sch_iov_t* iov = &r->tb_iov->iov[r->idx];
+    uint32_t                n   = SRSRAN_MIN(len, iov->len - r->offset);
+    memcpy(dst, &iov->ptr[r->offset], n);
+    dst += n;
+    len -= n;
+    r->offset += n;
+    if (r->offset == iov->len) {
+      r->idx++;
+      r->offset = 0;
+    }
+  }
+  // Fragment list shorter than the TB: fill remaining bytes with zeros
+  if (len > 0) {
+    memset(dst, 0, len);
+  }
+}
+
+static int encode_tb_off(srsran_sch_t*              q,
+                         srsran_softbuffer_tx_t*    softbuffer,
+                         srsran_cbsegm_t*           cb_segm,
+                         uint32_t                   Qm,
+                         uint32_t                   rv,
+                         uint32_t                   nof_e_bits,
+                         const srsran_sch_tb_iov_t* tb_iov,
+                         uint8_t*                   e_bits,
+                         uint32_t                   w_offset)
 {
   uint32_t i;
   uint32_t cb_len = 0, rp = 0, wp = 0, rlen = 0, n_e = 0;
@@ -277,6 +353,8 @@ static int encode_tb_off(srsran_sch_t*           q,
     /* Reset TB CRC */
     srsran_crc_set_init(&q->crc_tb, 0);
 
+    sch_iov_reader_t reader = {tb_iov, 0, 0};
+
     wp = 0;
     rp = 0;
     for (i = 0; i < cb_segm->C; i++) {
@@ -302,18 +380,18 @@ static int encode_tb_off(srsran_sch_t*           q,
 
       INFO("CB#%d: cb_len: %d, rlen: %d, wp: %d, rp: %d, E: %d", i, cb_len, rlen, wp, rp, n_e);
 
-      if (data) {
+      if (tb_iov) {
         bool last_cb = false;
 
-        /* Copy data to another buffer, making space for the Codeblock CRC */
+        /* Gather data into another buffer, making space for the Codeblock CRC */
         if (i < cb_segm->C - 1) {
           // Copy data
-          memcpy(q->cb_in, &data[rp / 8], rlen * sizeof(uint8_t) / 8);
+          sch_iov_read(&reader, q->cb_in, rlen * sizeof(uint8_t) / 8);
         } else {
           INFO("Last CB, appending parity: %d from %d and 24 to %d", rlen - 24, rp, rlen - 24);
 
           /* Append Transport Block parity bits to the last CB */
-          memcpy(q->cb_in, &data[rp / 8], (rlen - 24) * sizeof(uint8_t) / 8);
+          sch_iov_read(&reader, q->cb_in, (rlen - 24) * sizeof(uint8_t) / 8);
           last_cb = true;
         }
 
@@ -356,16 +434,28 @@ static int encode_tb_off(srsran_sch_t*           q,
   return ret;
 }
 
-static int encode_tb(srsran_sch_t*           q,
-                     srsran_softbuffer_tx_t* soft_buffer,
-                     srsran_cbsegm_t*        cb_segm,
-                     uint32_t                Qm,
-                     uint32_t                rv,
-                     uint32_t                nof_e_bits,
-                     uint8_t*                data,
-                     uint8_t*                e_bits)
+/* Wraps a contiguous TB in a single-fragment list. Returns NULL if there is no data to encode (retransmission) */
+static const srsran_sch_tb_iov_t* sch_tb_iov_contiguous(srsran_sch_tb_iov_t* tb_iov, uint8_t* data, uint32_t tbs)
 {
-  return encode_tb_off(q, soft_buffer, cb_segm, Qm, rv, nof_e_bits, data, e_bits, 0);
+  if (data == NULL) {
+    return NULL;
+  }
+  tb_iov->iov[0].ptr = data;
+  tb_iov->iov[0].len = tbs / 8;
+  tb_iov->nof_iov    = 1;
+  return tb_iov;
+}
+
+static int encode_tb(srsran_sch_t*              q,
+                     srsran_softbuffer_tx_t*    soft_buffer,
+                     srsran_cbsegm_t*           cb_segm,
+                     uint32_t                   Qm,
+                     uint32_t                   rv,
+                     uint32_t                   nof_e_bits,
+                     const srsran_sch_tb_iov_t* tb_iov,
+                     uint8_t*                   e_bits)
+{
+  return encode_tb_off(q, soft_buffer, cb_segm, Qm, rv, nof_e_bits, tb_iov, e_bits, 0);
 }
 
 bool decode_tb_cb(srsran_sch_t*           q,
@@ -629,6 +719,22 @@ int srsran_dlsch_encode2(srsran_sch_t*       q,
                          uint8_t*            e_bits,
                          int                 tb_idx,
                          uint32_t            nof_layers)
+{
+  srsran_sch_tb_iov_t tb_iov;
+  return srsran_dlsch_encode2_iov(
+      q, cfg, sch_tb_iov_contiguous(&tb_iov, data, cfg->grant.tb[tb_idx].tbs), e_bits, tb_idx, nof_layers);
+}
+
+/**
+ * Same as srsran_dlsch_encode2() but the transport block is given as a list of fragments, which are gathered directly
+ * into the code blocks. A NULL fragment list only rate-matches from the softbuffer (retransmission).
+ */
+int srsran_dlsch_encode2_iov(srsran_sch_t*              q,
+                             srsran_pdsch_cfg_t*        cfg,
+                             const srsran_sch_tb_iov_t* tb_iov,
+                             uint8_t*                   e_bits,
+                             int                        tb_idx,
+                             uint32_t                   nof_layers)
 {
   uint32_t Nl = 1;
 
@@ -651,7 +757,7 @@ int srsran_dlsch_encode2(srsran_sch_t*       q,
                    Qm * Nl,
                    cfg->grant.tb[tb_idx].rv,
                    cfg->grant.tb[tb_idx].nof_bits,
-                   data,
+                   tb_iov,
                    e_bits);
 }
 
@@ -1285,9 +1391,17 @@ int srsran_ulsch_encode(srsran_sch_t*       q,
 
   // Encode UL-SCH
   if (cb_segm.tbs > 0) {
-    uint32_t G = nb_q / Qm - Q_prime_ri - Q_prime_cqi;
-    ret        = encode_tb_off(
-        q, cfg->softbuffers.tx, &cb_segm, Qm, cfg->grant.tb.rv, G * Qm, data, &g_bits[e_offset / 8], e_offset % 8);
+    uint32_t            G = nb_q / Qm - Q_prime_ri - Q_prime_cqi;
+    srsran_sch_tb_iov_t tb_iov;
+    ret = encode_tb_off(q,
+                        cfg->softbuffers.tx,
+                        &cb_segm,
+                        Qm,
+                        cfg->grant.tb.rv,
+                        G * Qm,
+                        sch_tb_iov_contiguous(&tb_iov, data, cb_segm.tbs),
+                        &g_bits[e_offset / 8],
+                        e_offset % 8);
     if (ret) {
       return ret;
     }
@@ -347,6 +347,212 @@ static int test_case1()
   return SRSRAN_SUCCESS;
 }
 
+// Formats searched by a TM1 UE in each search space
+static const srsran_dci_format_t ue_ss_formats[]     = {SRSRAN_DCI_FORMAT1A, SRSRAN_DCI_FORMAT1};
+static const srsran_dci_format_t common_ss_formats[] = {SRSRAN_DCI_FORMAT1A, SRSRAN_DCI_FORMAT1C};
+
+typedef struct {
+  uint64_t nof_decodes;
+  uint32_t nof_missed;
+  uint32_t nof_false;
+} blind_search_stats_t;
+
+static bool locations_overlap(const srsran_dci_location_t* a, const srsran_dci_location_t* b)
+{
+  return a->ncce < b->ncce + (1U << b->L) && b->ncce < a->ncce + (1U << a->L);
+}
+
+// Blind search of a RNTI as the UE does: the first format matched in a location is taken and the locations
+// overlapping a found DCI are skipped. If ranked is set, the locations are ranked by LLR energy before the search
+static uint32_t blind_search(srsran_dl_sf_cfg_t*          dl_sf,
+                             srsran_dci_cfg_t*            cfg,
+                             uint16_t                     search_rnti,
+                             const srsran_dci_location_t* ss_locations,
+                             uint32_t                     nof_locations,
+                             const srsran_dci_format_t*   ss_formats,
+                             uint32_t                     nof_formats,
+                             bool                         ranked,
+                             srsran_dci_msg_t*            found,
+                             uint32_t                     nof_found)
+{
+  srsran_dci_location_t locations[SRSRAN_MAX_CANDIDATES];
+  memcpy(locations, ss_locations, sizeof(srsran_dci_location_t) * nof_locations);
+  if (ranked) {
+    nof_locations = srsran_pdcch_rank_locations(&pdcch_rx, dl_sf, locations, nof_locations);
+  }
+
+  for (uint32_t l = 0; l < nof_locations && nof_found < SRSRAN_MAX_DCI_MSG; l++) {
+    bool allocated = false;
+    for (uint32_t i = 0; i < nof_found; i++) {
+      allocated |= locations_overlap(&found[i].location, &locations[l]);
+    }
+    if (allocated) {
+      continue;
+    }
+
+    for (uint32_t f = 0; f < nof_formats; f++) {
+      srsran_dci_msg_t dci_rx = {};
+      dci_rx.location         = locations[l];
+      dci_rx.format           = ss_formats[f];
+      if (srsran_pdcch_decode_msg(&pdcch_rx, dl_sf, cfg, &dci_rx) < SRSRAN_SUCCESS) {
+        return nof_found;
+      }
+
+      if (dci_rx.rnti == search_rnti && dci_rx.nof_bits > 0 && srsran_pdcch_msg_corr(&pdcch_rx, &dci_rx) > 0.5f) {
+        found[nof_found++] = dci_rx;
+        break;
+      }
+    }
+  }
+  return nof_found;
+}
+
+// A DCI can be decoded in a smaller candidate with the same first CCE, so the aggregation level is not compared
+static bool dci_found(const srsran_dci_msg_t* tx, const srsran_dci_msg_t* found, uint32_t nof_found)
+{
+  for (uint32_t i = 0; i < nof_found; i++) {
+    if (tx->location.ncce == found[i].location.ncce && tx->nof_bits == found[i].nof_bits &&
+        memcmp(tx->payload, found[i].payload, tx->nof_bits) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Counts the DCI of the SI-RNTI and C-RNTI found in a subframe, with the exhaustive or the ranked search
+static void test_case2_search(srsran_dl_sf_cfg_t*     dl_sf,
+                              const srsran_dci_msg_t* dci_tx,
+                              uint32_t                nof_tx,
+                              srsran_dci_location_t*  common_locations,
+                              uint32_t                nof_common,
+                              srsran_dci_location_t*  ue_locations,
+                              uint32_t                nof_ue,
+                              bool                    ranked,
+                              blind_search_stats_t*   stats)
+{
+  srsran_dci_cfg_t common_cfg = dci_cfg;
+  srsran_dci_cfg_set_common_ss(&common_cfg);
+
+  // A new subframe clears the decoded messages
+  srsran_pdcch_extract_llr(&pdcch_rx, dl_sf, &chest_dl_res, slot_symbols);
+  uint64_t decodes_start = pdcch_rx.nof_decodes + (ranked ? 0 : pdcch_rx.nof_cache_hits);
+
+  srsran_dci_msg_t si_found[SRSRAN_MAX_DCI_MSG]    = {};
+  srsran_dci_msg_t crnti_found[SRSRAN_MAX_DCI_MSG] = {};
+  uint32_t         nof_si_found                    = 0;
+  uint32_t         nof_crnti_found                 = 0;
+
+  // SI-RNTI in the common SS, then C-RNTI in the UE-specific SS and Format 1A in the common SS
+  nof_si_found    = blind_search(dl_sf, &common_cfg, SRSRAN_SIRNTI, common_locations, nof_common, common_ss_formats, 2,
+                              ranked, si_found, nof_si_found);
+  nof_crnti_found = blind_search(
+      dl_sf, &dci_cfg, rnti, ue_locations, nof_ue, ue_ss_formats, 2, ranked, crnti_found, nof_crnti_found);
+  nof_crnti_found = blind_search(dl_sf, &common_cfg, rnti, common_locations, nof_common, common_ss_formats, 1, ranked,
+                                 crnti_found, nof_crnti_found);
+
+  // Without the decoded messages, every decode would have run the Viterbi decoder
+  stats->nof_decodes += pdcch_rx.nof_decodes + (ranked ? 0 : pdcch_rx.nof_cache_hits) - decodes_start;
+
+  for (uint32_t i = 0; i < nof_tx; i++) {
+    if (dci_tx[i].rnti == SRSRAN_SIRNTI) {
+      stats->nof_missed += dci_found(&dci_tx[i], si_found, nof_si_found) ? 0 : 1;
+    } else {
+      stats->nof_missed += dci_found(&dci_tx[i], crnti_found, nof_crnti_found) ? 0 : 1;
+    }
+  }
+  for (uint32_t i = 0; i < nof_si_found; i++) {
+    stats->nof_false += dci_found(&si_found[i], dci_tx, nof_tx) ? 0 : 1;
+  }
+  for (uint32_t i = 0; i < nof_crnti_found; i++) {
+    stats->nof_false += dci_found(&crnti_found[i], dci_tx, nof_tx) ? 0 : 1;
+  }
+}
+
+// Blind search of a C-RNTI DCI in the UE-specific search space and a SI-RNTI DCI in the common search space. Compares
+// the exhaustive search of all candidates and formats with the search of the candidates ranked by energy
+static int test_case2()
+{
+  uint32_t             nof_re     = SRSRAN_NOF_RE(pdcch_tx.cell);
+  uint32_t             nof_tx     = 0;
+  blind_search_stats_t exhaustive = {};
+  blind_search_stats_t ranked     = {};
+
+  for (uint32_t sf_idx = 0; sf_idx < repetitions * SRSRAN_NOF_SF_X_FRAME; sf_idx++) {
+    srsran_dl_sf_cfg_t dl_sf_cfg = {};
+    dl_sf_cfg.cfi                = cfi;
+    dl_sf_cfg.tti                = sf_idx % 10240;
+
+    srsran_dci_location_t common_locations[SRSRAN_MAX_CANDIDATES_COM] = {};
+    srsran_dci_location_t ue_locations[SRSRAN_MAX_CANDIDATES_UE]      = {};
+    uint32_t nof_common = srsran_pdcch_common_locations(&pdcch_tx, common_locations, SRSRAN_MAX_CANDIDATES_COM, cfi);
+    uint32_t nof_ue = srsran_pdcch_ue_locations(&pdcch_tx, &dl_sf_cfg, ue_locations, SRSRAN_MAX_CANDIDATES_UE, rnti);
+    if (nof_ue == 0) {
+      continue;
+    }
+
+    // C-RNTI DCI in a random UE-specific candidate
+    srsran_dci_msg_t dci_tx[2] = {};
+    uint32_t         nof_sf_tx = 1;
+    dci_tx[0].location         = ue_locations[srsran_random_uniform_int_dist(random_gen, 0, (int)nof_ue - 1)];
+    dci_tx[0].format           = ue_ss_formats[srsran_random_uniform_int_dist(random_gen, 0, 1)];
+    dci_tx[0].rnti             = rnti;
+
+    // SI-RNTI DCI in a random common candidate, if there is one free
+    srsran_dci_location_t si_locations[SRSRAN_MAX_CANDIDATES_COM];
+    uint32_t              nof_si_locations = 0;
+    for (uint32_t i = 0; i < nof_common; i++) {
+      if (!locations_overlap(&common_locations[i], &dci_tx[0].location)) {
+        si_locations[nof_si_locations++] = common_locations[i];
+      }
+    }
+    if (nof_si_locations > 0) {
+      dci_tx[1].location = si_locations[srsran_random_uniform_int_dist(random_gen, 0, (int)nof_si_locations - 1)];
+      dci_tx[1].format   = SRSRAN_DCI_FORMAT1A;
+      dci_tx[1].rnti     = SRSRAN_SIRNTI;
+      nof_sf_tx++;
+    }
+
+    for (uint32_t p = 0; p < nof_ports; p++) {
+      srsran_vec_cf_zero(slot_symbols[p], nof_re);
+    }
+    for (uint32_t i = 0; i < nof_sf_tx; i++) {
+      dci_tx[i].nof_bits = srsran_dci_format_sizeof(&pdcch_tx.cell, &dl_sf_cfg, &dci_cfg, dci_tx[i].format);
+      srsran_random_bit_vector(random_gen, dci_tx[i].payload, dci_tx[i].nof_bits);
+      TESTASSERT(srsran_pdcch_encode(&pdcch_tx, &dl_sf_cfg, &dci_tx[i], slot_symbols) == SRSRAN_SUCCESS);
+    }
+    nof_tx += nof_sf_tx;
+
+    // Set noise level according to the aggregation level of the C-RNTI DCI
+    float n0_dB = -get_snr_dB(dci_tx[0].location.L);
+    TESTASSERT(srsran_channel_awgn_set_n0(&awgn, n0_dB) == SRSRAN_SUCCESS);
+    chest_dl_res.noise_estimate = srsran_convert_dB_to_power(n0_dB);
+    for (uint32_t p = 0; p < nof_ports; p++) {
+      srsran_channel_awgn_run_c(&awgn, slot_symbols[p], slot_symbols[p], nof_re);
+    }
+
+    test_case2_search(
+        &dl_sf_cfg, dci_tx, nof_sf_tx, common_locations, nof_common, ue_locations, nof_ue, false, &exhaustive);
+    test_case2_search(&dl_sf_cfg, dci_tx, nof_sf_tx, common_locations, nof_common, ue_locations, nof_ue, true, &ranked);
+  }
+
+  uint32_t nof_sf = repetitions * SRSRAN_NOF_SF_X_FRAME;
+  printf("test_case_2 - exhaustive: %.1f decodes/sf; missed_prob=%f; false=%d - ranked: %.1f decodes/sf; "
+         "missed_prob=%f; false=%d;\n",
+         (double)exhaustive.nof_decodes / nof_sf,
+         nof_tx ? (double)exhaustive.nof_missed / nof_tx : 0.0,
+         exhaustive.nof_false,
+         (double)ranked.nof_decodes / nof_sf,
+         nof_tx ? (double)ranked.nof_missed / nof_tx : 0.0,
+         ranked.nof_false);
+
+  // Ranking the candidates must not miss more DCI nor decode more often than trying all of them
+  TESTASSERT(ranked.nof_missed <= exhaustive.nof_missed);
+  TESTASSERT(ranked.nof_false <= exhaustive.nof_false);
+  TESTASSERT(ranked.nof_decodes <= exhaustive.nof_decodes);
+
+  return SRSRAN_SUCCESS;
+}
+
 int main(int argc, char** argv)
 {
   srsran_regs_t regs = {};
@@ -416,6 +622,11 @@ int main(int argc, char** argv)
     goto quit;
   }
 
+  if (test_case2() < SRSRAN_SUCCESS) {
+    ERROR("Test case 2 failed");
+    goto quit;
+  }
+
   ret = SRSRAN_SUCCESS;
 
 quit:
@@ -21,8 +21,10 @@
 
 #include "srsran/phy/resampling/resample_arb.h"
 #include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/simd.h"
 #include "srsran/phy/utils/vector.h"
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
 // clang-format off
@@ -175,3 +177,322 @@ int srsran_resample_arb_compute(srsran_resample_arb_t* q, cf_t* input, cf_t* out
   }
   return n_out;
 }
+
+/**
+ * Kaiser window shape parameter of the polyphase prototype filter, for about 80 dB of stop band attenuation
+ */
+#define RESAMPLE_POLY_KAISER_BETA 8.0
+
+// Zeroth order modified Bessel function of the first kind, for the Kaiser window
+static double resample_poly_bessel_i0(double x)
+{
+  double sum  = 1.0;
+  double term = 1.0;
+  for (uint32_t k = 1; k < 32; k++) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+// Computes the windowed sinc prototype and splits it into the branches, so that each output sample is the dot product
+// of the last nof_taps input samples with a branch
+static void resample_poly_design(srsran_resample_poly_t* q)
+{
+  uint32_t P = q->nof_phases;
+  uint32_t T = q->nof_taps;
+  uint32_t N = P * T;
+
+  // Cut-off at the lowest of the input and output Nyquist frequencies, normalised to the rate of the upsampled signal
+  double fc     = 0.5 * SRSRAN_MIN(1.0, q->rate) / P;
+  double center = (N - 1) / 2.0;
+  double i0     = resample_poly_bessel_i0(RESAMPLE_POLY_KAISER_BETA);
+  double sum    = 0.0;
+
+  double* h = malloc(sizeof(double) * N);
+  if (h == NULL) {
+    return;
+  }
+  for (uint32_t i = 0; i < N; i++) {
+    double t = i - center;
+    double r = t / center;
+    double w = resample_poly_bessel_i0(RESAMPLE_POLY_KAISER_BETA * sqrt(SRSRAN_MAX(0.0, 1.0 - r * r))) / i0;
+    h[i]     = (fabs(t) < 1e-9 ? 2.0 * fc : sin(2.0 * M_PI * fc * t) / (M_PI * t)) * w;
+    sum += h[i];
+  }
+
+  // Unity gain for every branch
+  double scale = P / sum;
+  for (uint32_t p = 0; p < P; p++) {
+    float* branch = &q->filter[2 * T * p];
+    for (uint32_t j = 0; j < T; j++) {
+      branch[2 * j]     = (float)(h[p + (T - 1 - j) * P] * scale);
+      branch[2 * j + 1] = branch[2 * j];
+    }
+  }
+  free(h);
+}
+
+static int resample_poly_init(srsran_resample_poly_t* q, double rate, uint32_t nof_phases, uint32_t nof_taps)
+{
+  // The filter spans the same time at the lowest of the input and output rates
+  nof_taps = (uint32_t)ceil(SRSRAN_MAX(nof_taps, 1) / SRSRAN_MIN(1.0, rate));
+  nof_taps = SRSRAN_CEIL(nof_taps, 8) * 8;
+
+  if (q->filter != NULL && q->rate == rate && q->nof_phases == nof_phases && q->nof_taps == nof_taps) {
+    srsran_resample_poly_reset(q);
+    return SRSRAN_SUCCESS;
+  }
+
+  srsran_resample_poly_free(q);
+
+  q->rate        = rate;
+  q->nof_phases  = nof_phases;
+  q->nof_taps    = nof_taps;
+  q->max_pending = (uint32_t)ceil(rate) + 1;
+
+  q->filter  = srsran_vec_f_malloc(2 * nof_taps * nof_phases);
+  q->buffer  = srsran_vec_cf_malloc(nof_taps - 1 + SRSRAN_RESAMPLE_POLY_BLOCK);
+  q->pending = srsran_vec_cf_malloc(q->max_pending);
+  if (q->filter == NULL || q->buffer == NULL || q->pending == NULL) {
+    ERROR("Error allocating memory");
+    srsran_resample_poly_free(q);
+    return SRSRAN_ERROR;
+  }
+
+  resample_poly_design(q);
+  srsran_resample_poly_reset(q);
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_resample_poly_init(srsran_resample_poly_t* q, uint32_t interp, uint32_t decim, uint32_t nof_taps)
+{
+  if (q == NULL || interp == 0 || decim == 0) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  // Reduce the ratio
+  uint32_t a = interp, b = decim;
+  while (b != 0) {
+    uint32_t t = a % b;
+    a          = b;
+    b          = t;
+  }
+  interp /= a;
+  decim /= a;
+  if (interp > SRSRAN_RESAMPLE_POLY_MAX_PHASES) {
+    ERROR("Interpolation factor %d exceeds %d", interp, SRSRAN_RESAMPLE_POLY_MAX_PHASES);
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  // One branch per output phase. The accumulator counts the phase, in units of 1/interp input samples
+  int ret = resample_poly_init(q, (double)interp / decim, interp, nof_taps);
+  if (ret == SRSRAN_SUCCESS) {
+    q->one         = interp;
+    q->step_int    = decim / interp;
+    q->step_frac   = decim % interp;
+    q->phase_shift = 0;
+  }
+  return ret;
+}
+
+int srsran_resample_poly_init_arb(srsran_resample_poly_t* q, double rate, uint32_t nof_taps)
+{
+  if (q == NULL || !isnormal(rate) || rate < 0) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  // Use the exact rational ratio if there is one
+  for (uint32_t interp = 1; interp <= SRSRAN_RESAMPLE_POLY_MAX_PHASES; interp++) {
+    double decim = round(interp / rate);
+    if (decim >= 1 && decim < UINT32_MAX && fabs(interp / decim - rate) <= 1e-9 * rate) {
+      return srsran_resample_poly_init(q, interp, (uint32_t)decim, nof_taps);
+    }
+  }
+
+  // Otherwise, the accumulator is a 32.32 fixed point position in input samples, and its upper fractional bits select
+  // the branch
+  int ret = resample_poly_init(q, rate, SRSRAN_RESAMPLE_POLY_ARB_PHASES, nof_taps);
+  if (ret == SRSRAN_SUCCESS) {
+    uint64_t step  = (uint64_t)llround(4294967296.0 / rate);
+    q->one         = 1ULL << 32U;
+    q->step_int    = step >> 32U;
+    q->step_frac   = step & 0xffffffffULL;
+    q->phase_shift = 32 - (uint32_t)log2(SRSRAN_RESAMPLE_POLY_ARB_PHASES);
+  }
+  return ret;
+}
+
+void srsran_resample_poly_reset(srsran_resample_poly_t* q)
+{
+  if (q == NULL || q->buffer == NULL) {
+    return;
+  }
+  srsran_vec_cf_zero(q->buffer, q->nof_taps - 1);
+  q->acc         = 0;
+  q->idx         = q->nof_taps - 1;
+  q->nof_pending = 0;
+}
+
+double srsran_resample_poly_get_delay(const srsran_resample_poly_t* q)
+{
+  return (q->nof_phases * q->nof_taps - 1) / (2.0 * q->nof_phases);
+}
+
+// Dot product of nof_taps complex samples with a branch, 8 taps at a time
+static inline cf_t resample_poly_dot_prod(const cf_t* x, const float* h, uint32_t nof_taps)
+{
+  const float* xp  = (const float*)x;
+  uint32_t     len = 2 * nof_taps;
+  uint32_t     i   = 0;
+  float        re  = 0.0f;
+  float        im  = 0.0f;
+
+#if SRSRAN_SIMD_F_SIZE
+  simd_f_t acc1 = srsran_simd_f_zero();
+  simd_f_t acc2 = srsran_simd_f_zero();
+  for (; i + 2 * SRSRAN_SIMD_F_SIZE <= len; i += 2 * SRSRAN_SIMD_F_SIZE) {
+    acc1 = srsran_simd_f_add(acc1, srsran_simd_f_mul(srsran_simd_f_loadu(&xp[i]), srsran_simd_f_load(&h[i])));
+    acc2 = srsran_simd_f_add(acc2,
+                             srsran_simd_f_mul(srsran_simd_f_loadu(&xp[i + SRSRAN_SIMD_F_SIZE]),
+                                               srsran_simd_f_load(&h[i + SRSRAN_SIMD_F_SIZE])));
+  }
+  for (; i + SRSRAN_SIMD_F_SIZE <= len; i += SRSRAN_SIMD_F_SIZE) {
+    acc1 = srsran_simd_f_add(acc1, srsran_simd_f_mul(srsran_simd_f_loadu(&xp[i]), srsran_simd_f_load(&h[i])));
+  }
+
+  // Even lanes hold the real parts and odd lanes the imaginary parts
+  float sum[SRSRAN_SIMD_F_SIZE];
+  srsran_simd_f_storeu(sum, srsran_simd_f_add(acc1, acc2));
+  for (uint32_t j = 0; j < SRSRAN_SIMD_F_SIZE; j += 2) {
+    re += sum[j];
+    im += sum[j + 1];
+  }
+#endif /* SRSRAN_SIMD_F_SIZE */
+
+  for (; i < len; i += 2) {
+    re += xp[i] * h[i];
+    im += xp[i + 1] * h[i + 1];
+  }
+  return re + im * _Complex_I;
+}
+
+// Filters a block of up to SRSRAN_RESAMPLE_POLY_BLOCK input samples. The output samples beyond max_output are kept as
+// pending
+static uint32_t resample_poly_block(srsran_resample_poly_t* q,
+                                    const cf_t*             input,
+                                    cf_t*                   output,
+                                    uint32_t                nof_input,
+                                    uint32_t                max_output)
+{
+  uint32_t T     = q->nof_taps;
+  uint32_t end   = T - 1 + nof_input;
+  uint32_t count = 0;
+
+  if (input != NULL) {
+    srsran_vec_cf_copy(&q->buffer[T - 1], input, nof_input);
+  } else {
+    srsran_vec_cf_zero(&q->buffer[T - 1], nof_input);
+  }
+
+  while (q->idx < end) {
+    cf_t y = resample_poly_dot_prod(&q->buffer[q->idx + 1 - T], &q->filter[2 * T * (q->acc >> q->phase_shift)], T);
+    if (count < max_output) {
+      if (output != NULL) {
+        output[count] = y;
+      }
+      count++;
+    } else if (q->nof_pending < q->max_pending) {
+      q->pending[q->nof_pending++] = y;
+    }
+
+    // Advance to the next output sample
+    q->idx += q->step_int;
+    q->acc += q->step_frac;
+    if (q->acc >= q->one) {
+      q->acc -= q->one;
+      q->idx++;
+    }
+  }
+
+  // Keep the last input samples for the next block
+  memmove(q->buffer, &q->buffer[nof_input], sizeof(cf_t) * (T - 1));
+  q->idx -= nof_input;
+
+  return count;
+}
+
+// Outputs the pending samples, up to max_output
+static uint32_t resample_poly_flush(srsran_resample_poly_t* q, cf_t* output, uint32_t max_output)
+{
+  uint32_t n = SRSRAN_MIN(q->nof_pending, max_output);
+  if (n == 0) {
+    return 0;
+  }
+  if (output != NULL) {
+    srsran_vec_cf_copy(output, q->pending, n);
+  }
+  q->nof_pending -= n;
+  memmove(q->pending, &q->pending[n], sizeof(cf_t) * q->nof_pending);
+  return n;
+}
+
+uint32_t srsran_resample_poly_run(srsran_resample_poly_t* q, const cf_t* input, cf_t* output, uint32_t nof_input)
+{
+  if (q == NULL || q->filter == NULL) {
+    return 0;
+  }
+
+  uint32_t nof_output = resample_poly_flush(q, output, UINT32_MAX);
+  for (uint32_t count = 0; count < nof_input; count += SRSRAN_RESAMPLE_POLY_BLOCK) {
+    uint32_t n = SRSRAN_MIN(SRSRAN_RESAMPLE_POLY_BLOCK, nof_input - count);
+    nof_output += resample_poly_block(
+        q, input ? &input[count] : NULL, output ? &output[nof_output] : NULL, n, UINT32_MAX - nof_output);
+  }
+  return nof_output;
+}
+
+uint32_t srsran_resample_poly_nof_input(const srsran_resample_poly_t* q, uint32_t nof_output)
+{
+  if (q == NULL || q->filter == NULL || nof_output <= q->nof_pending) {
+    return 0;
+  }
+
+  // Newest input sample used by the last requested output sample
+  uint64_t k    = nof_output - q->nof_pending - 1;
+  uint64_t last = q->idx + k * q->step_int + (q->acc + k * q->step_frac) / q->one;
+  return (uint32_t)(last + 2 - q->nof_taps);
+}
+
+uint32_t srsran_resample_poly_pull(srsran_resample_poly_t* q, const cf_t* input, cf_t* output, uint32_t nof_output)
+{
+  if (q == NULL || q->filter == NULL) {
+    return 0;
+  }
+
+  uint32_t nof_input = srsran_resample_poly_nof_input(q, nof_output);
+  uint32_t count     = resample_poly_flush(q, output, nof_output);
+  for (uint32_t i = 0; i < nof_input; i += SRSRAN_RESAMPLE_POLY_BLOCK) {
+    uint32_t n = SRSRAN_MIN(SRSRAN_RESAMPLE_POLY_BLOCK, nof_input - i);
+    count += resample_poly_block(
+        q, input ? &input[i] : NULL, output ? &output[count] : NULL, n, nof_output - count);
+  }
+  return nof_input;
+}
+
+void srsran_resample_poly_free(srsran_resample_poly_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+  if (q->filter) {
+    free(q->filter);
+  }
+  if (q->buffer) {
+    free(q->buffer);
+  }
+  if (q->pending) {
+    free(q->pending);
+  }
+  memset(q, 0, sizeof(srsran_resample_poly_t));
+}
@@ -30,30 +30,49 @@
 #include "srsran/srsran.h"
 
 #define ITERATIONS 10000
+
+// Returns the throughput in input MS/sec
+static float bench(srsran_resample_arb_t* r, srsran_resample_poly_t* p, cf_t* in, cf_t* out, int N, int iterations)
+{
+  clock_t start = clock(), diff;
+  for (int xx = 0; xx < iterations; xx++) {
+    if (r) {
+      srsran_resample_arb_compute(r, in, out, N);
+    } else {
+      srsran_resample_poly_run(p, in, out, N);
+    }
+  }
+  diff = clock() - start;
+  return (CLOCKS_PER_SEC / ((float)diff / iterations)) * (N / 1e6);
+}
+
 int main(int argc, char** argv)
 {
-  int   N    = 9000;
-  float rate = 24.0 / 25.0;
-  cf_t* in   = srsran_vec_cf_malloc(N);
-  cf_t* out  = srsran_vec_cf_malloc(N);
+  int    N       = 9000;
+  double rates[] = {24.0 / 25.0, 23.04 / 30.72, 30.72 / 23.04, 0.7071};
+  cf_t*  in      = srsran_vec_cf_malloc(N);
+  cf_t*  out     = srsran_vec_cf_malloc(2 * N);
 
   for (int i = 0; i < N; i++)
     in[i] = sin(i * 2 * M_PI / 100);
 
-  srsran_resample_arb_t r;
-  srsran_resample_arb_init(&r, rate, 0);
+  for (uint32_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+    srsran_resample_arb_t r;
+    srsran_resample_arb_init(&r, rates[i], 0);
+    float thru_arb = bench(&r, NULL, in, out, N, ITERATIONS);
 
-  clock_t start = clock(), diff;
-  for (int xx = 0; xx < ITERATIONS; xx++) {
-    srsran_resample_arb_compute(&r, in, out, N);
-  }
-  diff = clock() - start;
+    srsran_resample_poly_t p = {};
+    srsran_resample_poly_init_arb(&p, rates[i], SRSRAN_RESAMPLE_POLY_NOF_TAPS);
+    float thru_poly = bench(NULL, &p, in, out, N, ITERATIONS / 10);
 
-  diff       = diff / ITERATIONS;
-  int   msec = diff * 1000 / CLOCKS_PER_SEC;
-  float thru = (CLOCKS_PER_SEC / (float)diff) * (N / 1e6);
-  printf("Time taken %d seconds %d milliseconds\n", msec / 1000, msec % 1000);
-  printf("Rate = %f MS/sec\n", thru);
+    printf("Rate %f: per-sample %.1f MS/sec, polyphase block (%d branches, %d taps) %.1f MS/sec\n",
+           rates[i],
+           thru_arb,
+           p.nof_phases,
+           p.nof_taps,
+           thru_poly);
+    srsran_resample_poly_free(&p);
+  }
 
   free(in);
   free(out);
@@ -29,6 +29,106 @@
 #include "srsran/phy/resampling/resample_arb.h"
 #include "srsran/srsran.h"
 
+// Compares the polyphase resampler output of a complex tone with the delayed tone at the output rate
+static int test_poly_tone(double rate, float max_error)
+{
+  uint32_t N    = 4000;
+  double   freq = 0.1 * SRSRAN_MIN(1.0, rate); // cycles per input sample
+  cf_t*    in   = srsran_vec_cf_malloc(N);
+  cf_t*    out  = srsran_vec_cf_malloc((uint32_t)ceil(N * rate) + 2);
+  if (!in || !out) {
+    perror("malloc");
+    exit(-1);
+  }
+  for (uint32_t i = 0; i < N; i++) {
+    in[i] = cexpf(_Complex_I * 2 * M_PI * freq * i);
+  }
+
+  srsran_resample_poly_t q = {};
+  if (srsran_resample_poly_init_arb(&q, rate, SRSRAN_RESAMPLE_POLY_NOF_TAPS)) {
+    printf("Error initialising polyphase resampler for rate %f\n", rate);
+    exit(-1);
+  }
+  uint32_t n_out = srsran_resample_poly_run(&q, in, out, N);
+  double   delay = srsran_resample_poly_get_delay(&q);
+
+  int ret = 0;
+  if (abs((int)n_out - (int)round(N * rate)) > 1) {
+    printf("Polyphase rate %f produced %d samples from %d\n", rate, n_out, N);
+    ret = -1;
+  }
+
+  // Skip the filter transient at both ends
+  float error = 0;
+  for (uint32_t i = (uint32_t)(2 * q.nof_taps * rate); i < n_out - 2 * q.nof_taps * rate; i++) {
+    cf_t expected = cexpf(_Complex_I * 2 * M_PI * freq * (i / rate - delay));
+    error         = SRSRAN_MAX(error, cabsf(out[i] - expected));
+  }
+  printf("Polyphase rate %f (%d branches): max error %.2e\n", rate, q.nof_phases, error);
+  if (error > max_error) {
+    ret = -1;
+  }
+
+  srsran_resample_poly_free(&q);
+  free(in);
+  free(out);
+  return ret;
+}
+
+// Resampling in blocks of random sizes, or pulling a given number of output samples, must match a single block
+static int test_poly_blocks(double rate)
+{
+  uint32_t N     = 20000;
+  uint32_t N_out = (uint32_t)ceil(N * rate) + 2;
+  cf_t*    in    = srsran_vec_cf_malloc(N);
+  cf_t*    ref   = srsran_vec_cf_malloc(N_out);
+  cf_t*    out   = srsran_vec_cf_malloc(N_out);
+  if (!in || !ref || !out) {
+    perror("malloc");
+    exit(-1);
+  }
+  for (uint32_t i = 0; i < N; i++) {
+    in[i] = (float)rand() / RAND_MAX - 0.5f + _Complex_I * ((float)rand() / RAND_MAX - 0.5f);
+  }
+
+  srsran_resample_poly_t q = {};
+  srsran_resample_poly_init_arb(&q, rate, SRSRAN_RESAMPLE_POLY_NOF_TAPS);
+  uint32_t n_ref = srsran_resample_poly_run(&q, in, ref, N);
+
+  // Random input block sizes
+  srsran_resample_poly_reset(&q);
+  uint32_t n_in = 0, n_out = 0;
+  while (n_in < N) {
+    uint32_t n = SRSRAN_MIN(N - n_in, (uint32_t)rand() % 5000);
+    n_out += srsran_resample_poly_run(&q, &in[n_in], &out[n_out], n);
+    n_in += n;
+  }
+  int ret = (n_out == n_ref && memcmp(out, ref, sizeof(cf_t) * n_ref) == 0) ? 0 : -1;
+
+  // Random output block sizes
+  srsran_resample_poly_reset(&q);
+  n_in  = 0;
+  n_out = 0;
+  while (ret == 0) {
+    uint32_t n = (uint32_t)rand() % 3000;
+    if (n_in + srsran_resample_poly_nof_input(&q, n) > N) {
+      break;
+    }
+    n_in += srsran_resample_poly_pull(&q, &in[n_in], &out[n_out], n);
+    n_out += n;
+  }
+  if (ret == 0 && (n_out > n_ref || memcmp(out, ref, sizeof(cf_t) * n_out) != 0)) {
+    ret = -1;
+  }
+  printf("Polyphase rate %f blocks: %s\n", rate, ret ? "failed" : "ok");
+
+  srsran_resample_poly_free(&q);
+  free(in);
+  free(ref);
+  free(out);
+  return ret;
+}
+
 int main(int argc, char** argv)
 {
   int   N     = 100;  // Number of sinwave samples
@@ -76,6 +176,15 @@ int main(int argc, char** argv)
     free(out);
   }
 
+  // Rational ratios of the LTE rates, which are exact, and arbitrary ratios, which use the nearest branch
+  double rates[]      = {23.04 / 30.72, 30.72 / 23.04, 1.92 / 23.04, 11.52 / 1.92, 24.0 / 25.0, 0.7071, 1.3333};
+  float  max_errors[] = {1e-3, 1e-3, 1e-3, 1e-3, 1e-3, 1e-2, 1e-2};
+  for (uint32_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+    if (test_poly_tone(rates[i], max_errors[i]) || test_poly_blocks(rates[i])) {
+      exit(-1);
+    }
+  }
+
   printf("Ok\n");
   exit(0);
 }
@@ -23,6 +23,7 @@
 #include "rf_file_imp_trx.h"
 #include "rf_helper.h"
 #include <errno.h>
+#include <inttypes.h>
 #include <math.h>
 #include <srsran/phy/common/phy_common.h>
 #include <srsran/phy/common/timestamp.h>
@@ -31,6 +32,10 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+#define FILE_SIGMF_DATA_EXT ".sigmf-data"
+#define FILE_SIGMF_META_EXT ".sigmf-meta"
+#define FILE_SIGMF_META_MAX_LEN (8192)
+
 typedef struct {
   // Common attributes
   char*            devname;
@@ -50,7 +55,7 @@ typedef struct {
   // FILEs
   rf_file_tx_t transmitter[SRSRAN_MAX_CHANNELS];
   rf_file_rx_t receiver[SRSRAN_MAX_CHANNELS];
-  bool         close_files;
+  char         tx_sigmf_meta[SRSRAN_MAX_CHANNELS][RF_PARAM_LEN]; // written when closing, empty if not a SigMF recording
 
   // Various sample buffers
   cf_t* buffer_decimation[SRSRAN_MAX_CHANNELS];
@@ -122,6 +127,107 @@ int rf_file_handle_error(char* id, const char* text)
   return SRSRAN_ERROR;
 }
 
+static int parse_format(const char* str, rf_file_format_t* format)
+{
+  if (strcmp(str, "fc32") == 0 || strcmp(str, "cf32_le") == 0) {
+    *format = FILERF_TYPE_FC32;
+  } else if (strcmp(str, "sc16") == 0 || strcmp(str, "ci16_le") == 0) {
+    *format = FILERF_TYPE_SC16;
+  } else if (strcmp(str, "sc8") == 0 || strcmp(str, "ci8") == 0) {
+    *format = FILERF_TYPE_SC8;
+  } else {
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
+
+static const char* sigmf_datatype(rf_file_format_t format)
+{
+  switch (format) {
+    case FILERF_TYPE_SC16:
+      return "ci16_le";
+    case FILERF_TYPE_SC8:
+      return "ci8";
+    default:
+      return "cf32_le";
+  }
+}
+
+// Gives the metadata file of a SigMF recording, i.e. <name>.sigmf-meta for <name>.sigmf-data
+static bool sigmf_meta_path(const char* data_path, char meta_path[RF_PARAM_LEN])
+{
+  size_t len     = strlen(data_path);
+  size_t ext_len = strlen(FILE_SIGMF_DATA_EXT);
+  if (len <= ext_len || strcmp(&data_path[len - ext_len], FILE_SIGMF_DATA_EXT) != 0) {
+    return false;
+  }
+  snprintf(meta_path, RF_PARAM_LEN, "%.*s%s", (int)(len - ext_len), data_path, FILE_SIGMF_META_EXT);
+  return true;
+}
+
+// Reads the sample format and rate of a SigMF recording, which are global fields of its metadata
+static int sigmf_read(const char* meta_path, rf_file_format_t* format, uint32_t* srate)
+{
+  FILE* f = fopen(meta_path, "r");
+  if (f == NULL) {
+    fprintf(stderr, "[file] Error: opening %s: %s\n", meta_path, strerror(errno));
+    return SRSRAN_ERROR;
+  }
+  char meta[FILE_SIGMF_META_MAX_LEN] = {};
+  fread(meta, 1, sizeof(meta) - 1, f);
+  fclose(f);
+
+  char        datatype[32] = {};
+  const char* p            = strstr(meta, "\"core:datatype\"");
+  if (p == NULL || sscanf(p, "\"core:datatype\" : \"%31[^\"]\"", datatype) != 1 ||
+      parse_format(datatype, format) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "[file] Error: %s has no supported core:datatype (cf32_le, ci16_le or ci8)\n", meta_path);
+    return SRSRAN_ERROR;
+  }
+
+  double rate = 0.0;
+  p           = strstr(meta, "\"core:sample_rate\"");
+  if (p != NULL && sscanf(p, "\"core:sample_rate\" : %lf", &rate) == 1 && rate > 0.0) {
+    *srate = (uint32_t)round(rate);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static void sigmf_write(const char* meta_path, rf_file_format_t format, uint32_t srate, uint32_t freq_mhz)
+{
+  FILE* f = fopen(meta_path, "w");
+  if (f == NULL) {
+    fprintf(stderr, "[file] Error: opening %s: %s\n", meta_path, strerror(errno));
+    return;
+  }
+
+  fprintf(f, "{\n");
+  fprintf(f, "  \"global\": {\n");
+  fprintf(f, "    \"core:datatype\": \"%s\",\n", sigmf_datatype(format));
+  fprintf(f, "    \"core:sample_rate\": %" PRIu32 ",\n", srate);
+  fprintf(f, "    \"core:version\": \"1.0.0\",\n");
+  fprintf(f, "    \"core:recorder\": \"srsRAN file RF\"\n");
+  fprintf(f, "  },\n");
+  fprintf(f, "  \"captures\": [\n");
+  fprintf(f, "    {\n");
+  fprintf(f, "      \"core:sample_start\": 0");
+  if (freq_mhz != 0) {
+    fprintf(f, ",\n      \"core:frequency\": %" PRIu64, (uint64_t)freq_mhz * 1000000);
+  }
+  fprintf(f, "\n    }\n");
+  fprintf(f, "  ],\n");
+  fprintf(f, "  \"annotations\": []\n");
+  fprintf(f, "}\n");
+  fclose(f);
+}
+
+static int rf_file_open_opts(void**          h,
+                             rf_file_opts_t* rx_opts,
+                             rf_file_opts_t* tx_opts,
+                             uint32_t        nof_channels,
+                             uint32_t        base_srate);
+
 /*
  * Public methods
  */
@@ -175,78 +281,124 @@ int rf_file_open_multi(char* args, void** h, uint32_t nof_channels)
 {
   int ret = SRSRAN_ERROR;
 
-  FILE* rx_files[SRSRAN_MAX_CHANNELS] = {NULL};
-  FILE* tx_files[SRSRAN_MAX_CHANNELS] = {NULL};
+  rf_file_opts_t rx_opts[SRSRAN_MAX_CHANNELS]                = {};
+  rf_file_opts_t tx_opts[SRSRAN_MAX_CHANNELS]                = {};
+  char           rx_files[SRSRAN_MAX_CHANNELS][RF_PARAM_LEN] = {};
+  char           tx_files[SRSRAN_MAX_CHANNELS][RF_PARAM_LEN] = {};
+  char           tx_sigmf[SRSRAN_MAX_CHANNELS][RF_PARAM_LEN] = {};
 
   if (h && nof_channels <= SRSRAN_MAX_CHANNELS) {
-    uint32_t base_srate = FILE_BASERATE_DEFAULT_HZ;
+    uint32_t base_srate        = FILE_BASERATE_DEFAULT_HZ;
+    bool     has_base_srate    = false;
+    char     tmp[RF_PARAM_LEN] = {};
 
     // parse args
     if (args && strlen(args)) {
       // base_srate
-      parse_uint32(args, "base_srate", -1, &base_srate);
+      has_base_srate = (parse_uint32(args, "base_srate", -1, &base_srate) == SRSRAN_SUCCESS);
     } else {
       fprintf(stderr, "[file] Error: RF device args are required for file-based no-RF module\n");
       goto clean_exit;
     }
 
+    // rx_format, tx_format
+    rf_file_format_t rx_format = FILERF_TYPE_FC32;
+    rf_file_format_t tx_format = FILERF_TYPE_FC32;
+    if (parse_string(args, "rx_format", -1, tmp) == SRSRAN_SUCCESS && parse_format(tmp, &rx_format)) {
+      fprintf(stderr, "[file] Error: unsupported sample format %s\n", tmp);
+      goto clean_exit;
+    }
+    if (parse_string(args, "tx_format", -1, tmp) == SRSRAN_SUCCESS && parse_format(tmp, &tx_format)) {
+      fprintf(stderr, "[file] Error: unsupported sample format %s\n", tmp);
+      goto clean_exit;
+    }
+
+    // rx_loop
+    bool rx_loop = false;
+    if (parse_string(args, "rx_loop", -1, tmp) == SRSRAN_SUCCESS) {
+      rx_loop = (strncmp(tmp, "true", RF_PARAM_LEN) == 0 || strncmp(tmp, "yes", RF_PARAM_LEN) == 0);
+    }
+
+    // rx_start_time, in seconds from the beginning of the rx files
+    double rx_start_time = 0.0;
+    parse_double(args, "rx_start_time", -1, &rx_start_time);
+
     for (int i = 0; i < nof_channels; i++) {
       // rx_file
-      char rx_file[RF_PARAM_LEN] = {};
-      parse_string(args, "rx_file", i, rx_file);
-
-      // tx_file
-      char tx_file[RF_PARAM_LEN] = {};
-      parse_string(args, "tx_file", i, tx_file);
-
-      // initialize transmitter
-      if (strlen(tx_file) != 0) {
-        tx_files[i] = fopen(tx_file, "wb");
-        if (tx_files[i] == NULL) {
-          fprintf(stderr, "[file] Error: opening tx_file%d: %s; %s\n", i, tx_file, strerror(errno));
-          goto clean_exit;
+      parse_string(args, "rx_file", i, rx_files[i]);
+      if (strlen(rx_files[i]) != 0) {
+        rx_opts[i].path          = rx_files[i];
+        rx_opts[i].sample_format = rx_format;
+        rx_opts[i].loop          = rx_loop;
+
+        // SigMF recordings carry their sample format and rate
+        char rx_sigmf[RF_PARAM_LEN] = {};
+        if (sigmf_meta_path(rx_files[i], rx_sigmf)) {
+          uint32_t srate = base_srate;
+          if (sigmf_read(rx_sigmf, &rx_opts[i].sample_format, &srate) != SRSRAN_SUCCESS) {
+            goto clean_exit;
+          }
+          if (!has_base_srate) {
+            base_srate     = srate;
+            has_base_srate = true;
+          } else if (srate != base_srate) {
+            fprintf(stderr,
+                    "[file] Error: %s was recorded at %.2f MHz but the base rate is %.2f MHz\n",
+                    rx_files[i],
+                    srate / 1e6,
+                    base_srate / 1e6);
+            goto clean_exit;
+          }
         }
       }
 
-      // initialize receiver
-      if (strlen(rx_file) != 0) {
-        rx_files[i] = fopen(rx_file, "rb");
-        if (rx_files[i] == NULL) {
-          fprintf(stderr, "[file] Error: opening rx_file%d: %s; %s\n", i, rx_file, strerror(errno));
-          goto clean_exit;
-        }
+      // tx_file
+      parse_string(args, "tx_file", i, tx_files[i]);
+      if (strlen(tx_files[i]) != 0) {
+        tx_opts[i].path          = tx_files[i];
+        tx_opts[i].sample_format = tx_format;
+        sigmf_meta_path(tx_files[i], tx_sigmf[i]);
       }
     }
 
-    // defer further initialization to open_file method
-    ret = rf_file_open_file(h, rx_files, tx_files, nof_channels, base_srate);
-    if (ret != SRSRAN_SUCCESS) {
-      goto clean_exit;
+    for (int i = 0; i < nof_channels; i++) {
+      rx_opts[i].start_sample = (uint64_t)round(rx_start_time * base_srate);
     }
 
-    // add flag to close all files when closing device
-    rf_file_handler_t* handler = (rf_file_handler_t*)(*h);
-    handler->close_files       = true;
-    return ret;
+    // defer further initialization to open_opts method
+    ret = rf_file_open_opts(h, rx_opts, tx_opts, nof_channels, base_srate);
+    if (ret == SRSRAN_SUCCESS) {
+      rf_file_handler_t* handler = (rf_file_handler_t*)(*h);
+      memcpy(handler->tx_sigmf_meta, tx_sigmf, sizeof(tx_sigmf));
+    }
   }
 
 clean_exit:
-  for (int i = 0; i < nof_channels; i++) {
-    if (rx_files[i] != NULL) {
-      fclose(rx_files[i]);
-    }
-    if (tx_files[i] != NULL) {
-      fclose(tx_files[i]);
-    }
-  }
   return ret;
 }
 
 int rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_channels, uint32_t base_srate)
+{
+  rf_file_opts_t rx_opts[SRSRAN_MAX_CHANNELS] = {};
+  rf_file_opts_t tx_opts[SRSRAN_MAX_CHANNELS] = {};
+
+  for (uint32_t i = 0; i < nof_channels && i < SRSRAN_MAX_CHANNELS; i++) {
+    rx_opts[i].file = (rx_files != NULL) ? rx_files[i] : NULL;
+    tx_opts[i].file = (tx_files != NULL) ? tx_files[i] : NULL;
+  }
+
+  return rf_file_open_opts(h, rx_opts, tx_opts, nof_channels, base_srate);
+}
+
+static int rf_file_open_opts(void**          h,
+                             rf_file_opts_t* rx_opts,
+                             rf_file_opts_t* tx_opts,
+                             uint32_t        nof_channels,
+                             uint32_t        base_srate)
 {
   int ret = SRSRAN_ERROR;
 
-  if (h) {
+  if (h && nof_channels <= SRSRAN_MAX_CHANNELS) {
     *h = NULL;
 
     rf_file_handler_t* handler = (rf_file_handler_t*)malloc(sizeof(rf_file_handler_t));
@@ -264,11 +416,6 @@ int rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_c
     handler->nof_channels     = nof_channels;
     strcpy(handler->id, "file\0");
 
-    rf_file_opts_t rx_opts = {};
-    rf_file_opts_t tx_opts = {};
-    tx_opts.id             = handler->id;
-    rx_opts.id             = handler->id;
-
     if (pthread_mutex_init(&handler->tx_config_mutex, NULL)) {
       fprintf(stderr, "Mutex init: %s\n", strerror(errno));
     }
@@ -289,18 +436,13 @@ int rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_c
     // id
     // TODO: set some meaningful ID in handler->id
 
-    // rx_format, tx_format
-    // TODO: add other formats
-    rx_opts.sample_format = FILERF_TYPE_FC32;
-    tx_opts.sample_format = FILERF_TYPE_FC32;
-
     update_rates(handler, 1.92e6);
 
     // Create channels
     for (int i = 0; i < handler->nof_channels; i++) {
-      if (rx_files != NULL && rx_files[i] != NULL) {
-        rx_opts.file = rx_files[i];
-        if (rf_file_rx_open(&handler->receiver[i], rx_opts) != SRSRAN_SUCCESS) {
+      if (rx_opts[i].file != NULL || rx_opts[i].path != NULL) {
+        rx_opts[i].id = handler->id;
+        if (rf_file_rx_open(&handler->receiver[i], rx_opts[i]) != SRSRAN_SUCCESS) {
           fprintf(stderr, "[file] Error: opening receiver\n");
           goto clean_exit;
         }
@@ -308,9 +450,9 @@ int rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_c
         // no rx_files provided
         fprintf(stdout, "[file] %s rx channel %d not specified. Disabling receiver.\n", handler->id, i);
       }
-      if (tx_files != NULL && tx_files[i] != NULL) {
-        tx_opts.file = tx_files[i];
-        if (rf_file_tx_open(&handler->transmitter[i], tx_opts) != SRSRAN_SUCCESS) {
+      if (tx_opts[i].file != NULL || tx_opts[i].path != NULL) {
+        tx_opts[i].id = handler->id;
+        if (rf_file_tx_open(&handler->transmitter[i], tx_opts[i]) != SRSRAN_SUCCESS) {
           fprintf(stderr, "[file] Error: opening transmitter\n");
           goto clean_exit;
         }
@@ -346,6 +488,7 @@ int rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_c
   clean_exit:
     if (ret) {
       rf_file_close(handler);
+      *h = NULL;
     }
   }
   return ret;
@@ -363,6 +506,16 @@ int rf_file_close(void* h)
     rf_file_rx_close(&handler->receiver[i]);
   }
 
+  // describe the SigMF recordings, now that they are complete
+  for (int i = 0; i < handler->nof_channels; i++) {
+    if (strlen(handler->tx_sigmf_meta[i]) != 0) {
+      sigmf_write(handler->tx_sigmf_meta[i],
+                  handler->transmitter[i].sample_format,
+                  handler->base_srate,
+                  handler->tx_freq_mhz[i]);
+    }
+  }
+
   // release other resources
   for (uint32_t i = 0; i < handler->nof_channels; i++) {
     if (handler->buffer_decimation[i]) {
@@ -379,18 +532,6 @@ int rf_file_close(void* h)
   pthread_mutex_destroy(&handler->decim_mutex);
   pthread_mutex_destroy(&handler->rx_gain_mutex);
 
-  // now close the files if we opened them ourselves
-  if (handler->close_files) {
-    for (int i = 0; i < handler->nof_channels; i++) {
-      if (handler->receiver[i].file != NULL) {
-        fclose(handler->receiver[i].file);
-      }
-      if (handler->transmitter[i].file != NULL) {
-        fclose(handler->transmitter[i].file);
-      }
-    }
-  }
-
   // Free all
   free(handler);
 
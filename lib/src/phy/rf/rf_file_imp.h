@@ -64,14 +64,21 @@ SRSRAN_API void rf_file_register_error_handler(void* h, srsran_rf_error_handler_
 SRSRAN_API int rf_file_open(char* args, void** h);
 
 /**
- * @brief This function is not supported for file-based RF abstraction
+ * @brief Opens the files given in the device arguments
  *
- * Use @c rf_file_open_file() to open this device
+ * The RX files are memory-mapped and the TX files are written by a background thread. Arguments:
+ * - rx_file[N], tx_file[N]: file of each channel
+ * - base_srate: sample rate of the files
+ * - rx_format, tx_format: sample format, fc32 (default), sc16 or sc8
+ * - rx_loop: true or yes to restart the RX files when they end
+ * - rx_start_time: seconds of the RX files skipped before the first sample
+ * Files named *.sigmf-data are SigMF recordings: the format and rate of the RX ones are read from their .sigmf-meta
+ * file, which is written for the TX ones on closing.
  *
- * @param args not used
- * @param h not used
- * @param nof_channels not used
- * @return SRSRAN_ERROR_INVALID_COMMAND
+ * @param args device arguments
+ * @param h Resulting object handle
+ * @param nof_channels Number of channels per direction
+ * @return SRSRAN_SUCCESS on success, otherwise error code
  */
 SRSRAN_API int rf_file_open_multi(char* args, void** h, uint32_t nof_channels);
 
@@ -137,6 +144,8 @@ SRSRAN_API int rf_file_send_timed_multi(void*  h,
  * @param[in] nof_channels Number of channels per direction
  * @param[in] base_srate Sample rate of RX and TX files
  * @return SRSRAN_SUCCESS on success, otherwise error code
+ *
+ * The files are read and written with stdio, in fc32 format.
  */
 SRSRAN_API int
 rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_channels, uint32_t base_srate);
@@ -20,6 +20,7 @@
  */
 
 #include "rf_file_imp_trx.h"
+#include <inttypes.h>
 #include <srsran/phy/utils/vector.h>
 #include <stdlib.h>
 #include <string.h>
@@ -36,13 +37,29 @@ int rf_file_rx_open(rf_file_rx_t* q, rf_file_opts_t opts)
     strncpy(q->id, opts.id, FILE_ID_STRLEN - 1);
     q->id[FILE_ID_STRLEN - 1] = '\0';
 
-    // Assign file
-    q->file = opts.file;
-
     // Configure formats
     q->sample_format = opts.sample_format;
     q->frequency_mhz = opts.frequency_mhz;
 
+    // Assign file, or map it if it is given by path
+    q->file = opts.file;
+    if (q->file == NULL) {
+      uint32_t sample_sz = rf_file_sample_sz(q->sample_format);
+      if (rf_file_map_open(&q->map, opts.path, sample_sz, opts.loop) != SRSRAN_SUCCESS) {
+        goto clean_exit;
+      }
+      q->use_map = true;
+
+      if (rf_file_map_seek(&q->map, opts.start_sample * sample_sz) != SRSRAN_SUCCESS) {
+        fprintf(stderr,
+                "Error: start sample %" PRIu64 " is beyond the end of %s (%" PRIu64 " samples)\n",
+                opts.start_sample,
+                opts.path,
+                q->map.size / sample_sz);
+        goto clean_exit;
+      }
+    }
+
     q->temp_buffer = srsran_vec_malloc(FILE_MAX_BUFFER_SIZE);
     if (!q->temp_buffer) {
       fprintf(stderr, "Error: allocating rx buffer\n");
@@ -69,12 +86,45 @@ clean_exit:
   return ret;
 }
 
+static void rf_file_rx_convert(rf_file_rx_t* q, const void* src, cf_t* dst, uint32_t nsamples)
+{
+  switch (q->sample_format) {
+    case FILERF_TYPE_SC16:
+      srsran_vec_convert_if((const int16_t*)src, INT16_MAX, (float*)dst, 2 * nsamples);
+      break;
+    case FILERF_TYPE_SC8:
+      srsran_vec_convert_bf((const int8_t*)src, INT8_MAX, (float*)dst, 2 * nsamples);
+      break;
+    default:
+      srsran_vec_cf_copy(dst, (const cf_t*)src, nsamples);
+  }
+}
+
 int rf_file_rx_baseband(rf_file_rx_t* q, cf_t* buffer, uint32_t nsamples)
 {
-  uint32_t sample_sz = sizeof(cf_t);
+  uint32_t sample_sz = rf_file_sample_sz(q->sample_format);
+
+  // Convert straight from the mapped file, which may take several reads at the end of a looped file
+  if (q->use_map) {
+    uint32_t count = 0;
+    while (count < nsamples) {
+      const uint8_t* ptr = NULL;
+      uint32_t       n   = rf_file_map_read(&q->map, &ptr, (nsamples - count) * sample_sz) / sample_sz;
+      if (n == 0) {
+        break;
+      }
+      rf_file_rx_convert(q, ptr, &buffer[count], n);
+      count += n;
+    }
+    return (count > 0) ? (int)count : SRSRAN_ERROR_RX_EOF;
+  }
 
-  int ret = fread(buffer, sample_sz, nsamples, q->file);
+  void* dst = (q->sample_format == FILERF_TYPE_FC32) ? (void*)buffer : q->temp_buffer_convert;
+  int   ret = fread(dst, sample_sz, nsamples, q->file);
   if (ret > 0) {
+    if (dst != buffer) {
+      rf_file_rx_convert(q, dst, buffer, ret);
+    }
     return ret;
   } else {
     return SRSRAN_ERROR_RX_EOF;
@@ -103,5 +153,10 @@ void rf_file_rx_close(rf_file_rx_t* q)
     free(q->temp_buffer_convert);
   }
 
+  if (q->use_map) {
+    rf_file_map_close(&q->map);
+    q->use_map = false;
+  }
+
   // not touching q->file as we don't know if we need to close it ourselves
 }
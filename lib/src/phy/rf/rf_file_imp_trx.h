@@ -22,6 +22,7 @@
 #ifndef SRSRAN_RF_FILE_IMP_TRX_H
 #define SRSRAN_RF_FILE_IMP_TRX_H
 
+#include "rf_file_mmap.h"
 #include "srsran/config.h"
 #include <math.h>
 #include <pthread.h>
@@ -40,12 +41,26 @@
 #define FILE_MAX_GAIN_DB (30.0f)
 #define FILE_MIN_GAIN_DB (0.0f)
 
-typedef enum { FILERF_TYPE_FC32 = 0, FILERF_TYPE_SC16 } rf_file_format_t;
+typedef enum { FILERF_TYPE_FC32 = 0, FILERF_TYPE_SC16, FILERF_TYPE_SC8 } rf_file_format_t;
+
+static inline uint32_t rf_file_sample_sz(rf_file_format_t format)
+{
+  switch (format) {
+    case FILERF_TYPE_SC16:
+      return 2 * sizeof(int16_t);
+    case FILERF_TYPE_SC8:
+      return 2 * sizeof(int8_t);
+    default:
+      return sizeof(cf_t);
+  }
+}
 
 typedef struct {
   char             id[FILE_ID_STRLEN];
   rf_file_format_t sample_format;
   FILE*            file;
+  bool             use_writer; ///< the file was opened by path, and is written by the writer thread
+  rf_file_writer_t writer;
   uint64_t         nsamples;
   bool             running;
   pthread_mutex_t  mutex;
@@ -59,6 +74,8 @@ typedef struct {
   char             id[FILE_ID_STRLEN];
   rf_file_format_t sample_format;
   FILE*            file;
+  bool             use_map; ///< the file was opened by path, and is read from its mapping
+  rf_file_map_t    map;
   uint64_t         nsamples;
   bool             running;
   pthread_t        thread;
@@ -72,6 +89,9 @@ typedef struct {
   const char*      id;
   rf_file_format_t sample_format;
   FILE*            file;
+  const char*      path;         ///< opened by the transceiver if file is NULL
+  bool             loop;         ///< receiver with path: restart from the beginning at the end of the file
+  uint64_t         start_sample; ///< receiver with path: first sample read
   uint32_t         frequency_mhz;
 } rf_file_opts_t;
 
@@ -39,13 +39,19 @@ int rf_file_tx_open(rf_file_tx_t* q, rf_file_opts_t opts)
     strncpy(q->id, opts.id, FILE_ID_STRLEN - 1);
     q->id[FILE_ID_STRLEN - 1] = '\0';
 
-    // Assign file
-    q->file = opts.file;
-
     // Configure formats
     q->sample_format = opts.sample_format;
     q->frequency_mhz = opts.frequency_mhz;
 
+    // Assign file, or create it if it is given by path
+    q->file = opts.file;
+    if (q->file == NULL) {
+      if (rf_file_writer_open(&q->writer, opts.path) != SRSRAN_SUCCESS) {
+        goto clean_exit;
+      }
+      q->use_writer = true;
+    }
+
     q->temp_buffer_convert = srsran_vec_malloc(FILE_MAX_BUFFER_SIZE);
     if (!q->temp_buffer_convert) {
       fprintf(stderr, "Error: allocating tx buffer\n");
@@ -73,18 +79,63 @@ clean_exit:
   return ret;
 }
 
+static void rf_file_tx_convert(rf_file_tx_t* q, const cf_t* src, void* dst, uint32_t nsamples)
+{
+  switch (q->sample_format) {
+    case FILERF_TYPE_SC16:
+      srsran_vec_convert_fi((const float*)src, INT16_MAX, (int16_t*)dst, 2 * nsamples);
+      break;
+    case FILERF_TYPE_SC8:
+      srsran_vec_convert_fb((const float*)src, INT8_MAX, (int8_t*)dst, 2 * nsamples);
+      break;
+    default:
+      srsran_vec_cf_copy((cf_t*)dst, src, nsamples);
+  }
+}
+
+// Converts the samples straight into the chunks of the writer thread
+static int _rf_file_tx_baseband_writer(rf_file_tx_t* q, cf_t* buffer, uint32_t nsamples)
+{
+  uint32_t sample_sz = rf_file_sample_sz(q->sample_format);
+  uint32_t count     = 0;
+
+  while (count < nsamples) {
+    uint32_t nbytes = 0;
+    uint8_t* dst    = rf_file_writer_reserve(&q->writer, &nbytes);
+    if (dst == NULL) {
+      rf_file_error(q->id, "[file] Error: transmitter failed to write samples.\n");
+      return SRSRAN_ERROR;
+    }
+
+    uint32_t n = SRSRAN_MIN(nbytes / sample_sz, nsamples - count);
+    if (buffer == NULL || buffer == q->zeros) {
+      memset(dst, 0, n * sample_sz);
+    } else {
+      rf_file_tx_convert(q, &buffer[count], dst, n);
+    }
+    rf_file_writer_commit(&q->writer, n * sample_sz);
+    count += n;
+  }
+
+  q->nsamples += nsamples;
+  return nsamples;
+}
+
 static int _rf_file_tx_baseband(rf_file_tx_t* q, cf_t* buffer, uint32_t nsamples)
 {
   int n = SRSRAN_ERROR;
 
+  if (q->use_writer) {
+    return _rf_file_tx_baseband_writer(q, buffer, nsamples);
+  }
+
   // convert samples if necessary
   void*    buf       = (buffer) ? buffer : q->zeros;
-  uint32_t sample_sz = sizeof(cf_t);
+  uint32_t sample_sz = rf_file_sample_sz(q->sample_format);
 
-  if (q->sample_format == FILERF_TYPE_SC16) {
-    buf       = q->temp_buffer_convert;
-    sample_sz = 2 * sizeof(short);
-    srsran_vec_convert_fi((float*)buffer, INT16_MAX, (short*)q->temp_buffer_convert, 2 * nsamples);
+  if (q->sample_format != FILERF_TYPE_FC32) {
+    rf_file_tx_convert(q, buf, q->temp_buffer_convert, nsamples);
+    buf = q->temp_buffer_convert;
   }
 
   size_t ret = fwrite(buf, (size_t)sample_sz, (size_t)nsamples, q->file);
@@ -137,6 +188,7 @@ int rf_file_tx_baseband(rf_file_tx_t* q, cf_t* buffer, uint32_t nsamples)
     nsamples -= n;
     q->sample_offset += n;
     if (nsamples == 0) {
+      pthread_mutex_unlock(&q->mutex);
       return n;
     }
   }
@@ -186,6 +238,11 @@ void rf_file_tx_close(rf_file_tx_t* q)
 
   pthread_mutex_destroy(&q->mutex);
 
+  if (q->use_writer) {
+    rf_file_writer_close(&q->writer);
+    q->use_writer = false;
+  }
+
   if (q->zeros) {
     free(q->zeros);
   }
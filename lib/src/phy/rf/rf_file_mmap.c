@@ -0,0 +1,290 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rf_file_mmap.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <srsran/phy/utils/vector.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int rf_file_map_open(rf_file_map_t* q, const char* path, uint32_t sample_sz, bool loop)
+{
+  if (q == NULL || path == NULL || sample_sz == 0) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  memset(q, 0, sizeof(rf_file_map_t));
+  q->loop = loop;
+
+  q->fd = open(path, O_RDONLY);
+  if (q->fd < 0) {
+    fprintf(stderr, "[file] Error: opening %s: %s\n", path, strerror(errno));
+    return SRSRAN_ERROR;
+  }
+
+  struct stat st = {};
+  if (fstat(q->fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+    fprintf(stderr, "[file] Error: %s is not a regular file\n", path);
+    close(q->fd);
+    return SRSRAN_ERROR;
+  }
+  q->size = (uint64_t)st.st_size - (uint64_t)st.st_size % sample_sz;
+
+  if (q->size > 0) {
+    void* data = mmap(NULL, q->size, PROT_READ, MAP_SHARED, q->fd, 0);
+    if (data == MAP_FAILED) {
+      fprintf(stderr, "[file] Error: mapping %s: %s\n", path, strerror(errno));
+      close(q->fd);
+      return SRSRAN_ERROR;
+    }
+    q->data = (uint8_t*)data;
+    madvise(q->data, q->size, MADV_SEQUENTIAL);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int rf_file_map_seek(rf_file_map_t* q, uint64_t offset)
+{
+  if (q == NULL || offset > q->size) {
+    return SRSRAN_ERROR;
+  }
+
+  q->offset  = offset;
+  q->advised = offset;
+  return SRSRAN_SUCCESS;
+}
+
+// Requests the pages up to FILE_MAP_READAHEAD bytes ahead of the read position, once half of them have been read
+static void map_readahead(rf_file_map_t* q)
+{
+  if (q->advised >= q->size || q->advised - q->offset >= FILE_MAP_READAHEAD / 2) {
+    return;
+  }
+
+  uint64_t page_sz = (uint64_t)sysconf(_SC_PAGESIZE);
+  uint64_t start   = q->advised - q->advised % page_sz;
+  uint64_t end     = SRSRAN_MIN(q->offset + FILE_MAP_READAHEAD, q->size);
+  madvise(q->data + start, end - start, MADV_WILLNEED);
+  q->advised = end;
+}
+
+uint32_t rf_file_map_read(rf_file_map_t* q, const uint8_t** ptr, uint32_t nbytes)
+{
+  if (q == NULL || q->data == NULL) {
+    return 0;
+  }
+
+  if (q->offset == q->size) {
+    if (!q->loop) {
+      return 0;
+    }
+    q->offset  = 0;
+    q->advised = 0;
+  }
+
+  map_readahead(q);
+
+  uint32_t n = (uint32_t)SRSRAN_MIN((uint64_t)nbytes, q->size - q->offset);
+  *ptr       = q->data + q->offset;
+  q->offset += n;
+  return n;
+}
+
+void rf_file_map_close(rf_file_map_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  if (q->data != NULL) {
+    munmap(q->data, q->size);
+    q->data = NULL;
+  }
+  close(q->fd);
+}
+
+static int write_all(int fd, const uint8_t* buffer, uint32_t nbytes)
+{
+  while (nbytes > 0) {
+    ssize_t n = write(fd, buffer, nbytes);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return errno;
+    }
+    buffer += n;
+    nbytes -= (uint32_t)n;
+  }
+  return 0;
+}
+
+static void* writer_thread(void* arg)
+{
+  rf_file_writer_t* q = (rf_file_writer_t*)arg;
+
+  pthread_mutex_lock(&q->mutex);
+  while (true) {
+    while (q->nof_pending == 0 && q->running) {
+      pthread_cond_wait(&q->cvar, &q->mutex);
+    }
+    if (q->nof_pending == 0) {
+      break;
+    }
+
+    // The chunk belongs to this thread until it is released, so it is written without the lock
+    uint32_t idx = q->tail;
+    pthread_mutex_unlock(&q->mutex);
+    int err = write_all(q->fd, q->chunks[idx], q->chunk_len[idx]);
+    pthread_mutex_lock(&q->mutex);
+
+    if (err != 0 && q->error == 0) {
+      q->error = err;
+    }
+    q->tail = (idx + 1) % FILE_WRITER_NOF_CHUNKS;
+    q->nof_pending--;
+    pthread_cond_broadcast(&q->cvar);
+  }
+  pthread_mutex_unlock(&q->mutex);
+
+  return NULL;
+}
+
+int rf_file_writer_open(rf_file_writer_t* q, const char* path)
+{
+  if (q == NULL || path == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  memset(q, 0, sizeof(rf_file_writer_t));
+
+  q->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (q->fd < 0) {
+    fprintf(stderr, "[file] Error: opening %s: %s\n", path, strerror(errno));
+    return SRSRAN_ERROR;
+  }
+
+  for (uint32_t i = 0; i < FILE_WRITER_NOF_CHUNKS; i++) {
+    q->chunks[i] = srsran_vec_u8_malloc(FILE_WRITER_CHUNK_SIZE);
+    if (q->chunks[i] == NULL) {
+      goto clean_exit;
+    }
+  }
+
+  if (pthread_mutex_init(&q->mutex, NULL) || pthread_cond_init(&q->cvar, NULL)) {
+    fprintf(stderr, "Error: creating mutex\n");
+    goto clean_exit;
+  }
+
+  q->running = true;
+  if (pthread_create(&q->thread, NULL, writer_thread, q)) {
+    fprintf(stderr, "Error: creating writer thread\n");
+    q->running = false;
+    goto clean_exit;
+  }
+
+  return SRSRAN_SUCCESS;
+
+clean_exit:
+  for (uint32_t i = 0; i < FILE_WRITER_NOF_CHUNKS; i++) {
+    if (q->chunks[i] != NULL) {
+      free(q->chunks[i]);
+    }
+  }
+  close(q->fd);
+  return SRSRAN_ERROR;
+}
+
+// Hands the head chunk to the thread and waits until the next one is free
+static void writer_push(rf_file_writer_t* q)
+{
+  pthread_mutex_lock(&q->mutex);
+  q->chunk_len[q->head] = q->fill;
+  q->nof_pending++;
+  pthread_cond_broadcast(&q->cvar);
+
+  q->head = (q->head + 1) % FILE_WRITER_NOF_CHUNKS;
+  q->fill = 0;
+  while (q->nof_pending == FILE_WRITER_NOF_CHUNKS) {
+    pthread_cond_wait(&q->cvar, &q->mutex);
+  }
+  pthread_mutex_unlock(&q->mutex);
+}
+
+uint8_t* rf_file_writer_reserve(rf_file_writer_t* q, uint32_t* nbytes)
+{
+  pthread_mutex_lock(&q->mutex);
+  int error = q->error;
+  pthread_mutex_unlock(&q->mutex);
+  if (error != 0) {
+    return NULL;
+  }
+
+  *nbytes = FILE_WRITER_CHUNK_SIZE - q->fill;
+  return q->chunks[q->head] + q->fill;
+}
+
+void rf_file_writer_commit(rf_file_writer_t* q, uint32_t nbytes)
+{
+  q->fill += nbytes;
+  if (q->fill == FILE_WRITER_CHUNK_SIZE) {
+    writer_push(q);
+  }
+}
+
+int rf_file_writer_close(rf_file_writer_t* q)
+{
+  if (q == NULL || !q->running) {
+    return SRSRAN_ERROR;
+  }
+
+  pthread_mutex_lock(&q->mutex);
+  if (q->fill > 0) {
+    q->chunk_len[q->head] = q->fill;
+    q->nof_pending++;
+    q->fill = 0;
+  }
+  q->running = false;
+  pthread_cond_broadcast(&q->cvar);
+  pthread_mutex_unlock(&q->mutex);
+  pthread_join(q->thread, NULL);
+
+  pthread_mutex_destroy(&q->mutex);
+  pthread_cond_destroy(&q->cvar);
+  for (uint32_t i = 0; i < FILE_WRITER_NOF_CHUNKS; i++) {
+    free(q->chunks[i]);
+  }
+
+  if (close(q->fd) < 0 && q->error == 0) {
+    q->error = errno;
+  }
+  if (q->error != 0) {
+    fprintf(stderr, "[file] Error: writing samples: %s\n", strerror(q->error));
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
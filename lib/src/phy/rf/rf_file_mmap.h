@@ -0,0 +1,107 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        rf_file_mmap.h
+ *
+ * Description: Sample file I/O of the file RF device when it opens the files
+ *              itself. The receiver maps the whole file, so that playback can
+ *              start at any sample and loop over the file without system
+ *              calls, and asks the kernel to read ahead of the read position.
+ *              The transmitter fills chunks that a background thread writes
+ *              to the file, so that the caller only waits for the disk when
+ *              all chunks are pending.
+ *              Both work on bytes, the sample formats are handled by the
+ *              receiver and transmitter of the device.
+ *****************************************************************************/
+
+#ifndef SRSRAN_RF_FILE_MMAP_H
+#define SRSRAN_RF_FILE_MMAP_H
+
+#include <pthread.h>
+#include <srsran/config.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define FILE_MAP_READAHEAD (16 * 1024 * 1024) // bytes requested ahead of the read position
+#define FILE_WRITER_CHUNK_SIZE (1024 * 1024) // small enough to stay cached between the conversion and the write
+#define FILE_WRITER_NOF_CHUNKS (8)
+
+typedef struct {
+  int      fd;
+  uint8_t* data;    ///< mapped file, NULL if it is empty
+  uint64_t size;    ///< usable bytes, a multiple of the sample size
+  uint64_t offset;  ///< read position in bytes
+  uint64_t advised; ///< end of the range already requested with MADV_WILLNEED
+  bool     loop;    ///< restart from the beginning of the file at the end
+} rf_file_map_t;
+
+typedef struct {
+  int             fd;
+  uint8_t*        chunks[FILE_WRITER_NOF_CHUNKS];
+  uint32_t        chunk_len[FILE_WRITER_NOF_CHUNKS]; ///< bytes of the chunks handed to the thread
+  uint32_t        head;        ///< chunk being filled by the caller
+  uint32_t        fill;        ///< bytes in the head chunk
+  uint32_t        tail;        ///< next chunk the thread writes
+  uint32_t        nof_pending; ///< chunks handed to the thread and not written yet
+  bool            running;
+  int             error; ///< errno of the first failed write
+  pthread_t       thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t  cvar;
+} rf_file_writer_t;
+
+/**
+ * Maps a sample file for reading
+ * @param sample_sz trailing bytes that do not make a whole sample are ignored
+ * @return SRSRAN_SUCCESS or SRSRAN_ERROR, e.g. if the path is not a regular file
+ */
+SRSRAN_API int rf_file_map_open(rf_file_map_t* q, const char* path, uint32_t sample_sz, bool loop);
+
+/// Moves the read position. Returns SRSRAN_ERROR if it is beyond the end of the file
+SRSRAN_API int rf_file_map_seek(rf_file_map_t* q, uint64_t offset);
+
+/**
+ * Gives the address of the bytes at the read position, and advances it
+ * @return the number of bytes available at *ptr, up to nbytes. Fewer at the end of the file, which is followed by its
+ *         beginning if looping, and 0 once a file that does not loop has been read
+ */
+SRSRAN_API uint32_t rf_file_map_read(rf_file_map_t* q, const uint8_t** ptr, uint32_t nbytes);
+
+SRSRAN_API void rf_file_map_close(rf_file_map_t* q);
+
+/// Creates or truncates the file and starts the writing thread
+SRSRAN_API int rf_file_writer_open(rf_file_writer_t* q, const char* path);
+
+/**
+ * Gives where the next bytes can be written, waiting for a chunk if all of them are pending
+ * @param nbytes set to the number of contiguous bytes that can be written, a multiple of 8
+ * @return NULL if a previous write failed
+ */
+SRSRAN_API uint8_t* rf_file_writer_reserve(rf_file_writer_t* q, uint32_t* nbytes);
+
+/// Adds nbytes written at the address given by rf_file_writer_reserve() to the file
+SRSRAN_API void rf_file_writer_commit(rf_file_writer_t* q, uint32_t nbytes);
+
+/// Writes the pending bytes and closes the file. Returns SRSRAN_ERROR if any write failed
+SRSRAN_API int rf_file_writer_close(rf_file_writer_t* q);
+
+#endif // SRSRAN_RF_FILE_MMAP_H
@@ -28,10 +28,14 @@
 #include <srsran/phy/common/phy_common.h>
 #include <srsran/phy/utils/vector.h>
 #include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
 
 #define PRINT_SAMPLES 0
 #define COMPARE_BITS 0
 #define COMPARE_EPSILON (1e-6f)
+#define COMPARE_EPSILON_SC16 (1e-4f)
+#define COMPARE_EPSILON_SC8 (2e-2f)
 #define NOF_RX_ANT 4
 #define NUM_SF (500)
 #define SF_LEN (1920)
@@ -149,7 +153,7 @@ void enb_tx_function(const char* tx_args, bool timed_tx)
   srsran_rf_close(&enb_radio);
 }
 
-int run_test(const char* rx_args, const char* tx_args, bool timed_tx)
+int run_test(const char* rx_args, const char* tx_args, bool timed_tx, float epsilon)
 {
   int ret = SRSRAN_ERROR;
 
@@ -200,7 +204,7 @@ int run_test(const char* rx_args, const char* tx_args, bool timed_tx)
                          &ue_rx_buffer[c][sf_offet + i * SF_LEN],
                          SF_LEN);
       uint32_t max_ix = srsran_vec_max_abs_ci(&ue_rx_buffer[c][sf_offet + i * SF_LEN], SF_LEN);
-      if (cabsf(ue_rx_buffer[c][sf_offet + i * SF_LEN + max_ix]) > COMPARE_EPSILON) {
+      if (cabsf(ue_rx_buffer[c][sf_offet + i * SF_LEN + max_ix]) > epsilon) {
         fprintf(stderr, "data mismatch in subframe %d\n", i);
         goto exit;
       }
@@ -242,8 +246,148 @@ void remove_file(const char* filename)
   remove(filename);
 }
 
-int main()
+// Plays a ramp from a given time, past the end of the file
+int loop_test()
 {
+  const uint32_t file_len   = 4800;
+  const uint32_t start      = 1920; // rx_start_time=1ms at 1.92 MHz
+  cf_t*          ramp       = srsran_vec_cf_malloc(file_len);
+  cf_t*          rx_samples = srsran_vec_cf_malloc(2 * file_len);
+  int            ret        = SRSRAN_ERROR;
+
+  for (uint32_t i = 0; i < file_len; i++) {
+    ramp[i] = (float)i + _Complex_I * (float)(file_len - i);
+  }
+  FILE* f = fopen("rx_file_ramp", "w");
+  fwrite(ramp, sizeof(cf_t), file_len, f);
+  fclose(f);
+
+  // starting after the end of a file that is not looped fails
+  char rf_args[RF_PARAM_LEN] = "rx_file=rx_file_ramp,base_srate=1.92e6,rx_start_time=0.01";
+  if (srsran_rf_open_devname(&ue_radio, "file", rf_args, 1) == SRSRAN_SUCCESS) {
+    fprintf(stderr, "Opening with a start time after the end of the file should fail\n");
+    srsran_rf_close(&ue_radio);
+    goto exit;
+  }
+
+  strncpy(rf_args, "rx_file=rx_file_ramp,base_srate=1.92e6,rx_start_time=0.001,rx_loop=true", RF_PARAM_LEN - 1);
+  if (srsran_rf_open_devname(&ue_radio, "file", rf_args, 1)) {
+    fprintf(stderr, "Error opening rf\n");
+    goto exit;
+  }
+  for (uint32_t i = 0; i < 2 * file_len; i += SF_LEN / 2) {
+    srsran_rf_recv_with_time(&ue_radio, &rx_samples[i], SF_LEN / 2, true, NULL, NULL);
+  }
+  srsran_rf_close(&ue_radio);
+
+  for (uint32_t i = 0; i < 2 * file_len; i++) {
+    if (rx_samples[i] != ramp[(start + i) % file_len]) {
+      fprintf(stderr, "sample %d does not match the looped file\n", i);
+      goto exit;
+    }
+  }
+  ret = SRSRAN_SUCCESS;
+
+exit:
+  remove_file("rx_file_ramp");
+  free(ramp);
+  free(rx_samples);
+  return ret;
+}
+
+static double elapsed_s(struct timeval* t)
+{
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  return t[0].tv_sec + t[0].tv_usec * 1e-6;
+}
+
+// Writes and reads back NUM_SF subframes at 23.04 MHz, with the stdio path of rf_file_open_file() and with the mapped
+// files in each sample format
+void benchmark()
+{
+  const uint32_t nof_sf = NUM_SF;
+  const uint32_t sf_len = 23040;
+  const char*    fmts[] = {"stdio", "fc32", "sc16", "sc8"};
+  cf_t*          buffer = srsran_vec_cf_malloc(sf_len);
+  struct timeval t[3];
+
+  for (uint32_t i = 0; i < sf_len; i++) {
+    buffer[i] = ((float)rand() / (float)RAND_MAX) + _Complex_I * ((float)rand() / (float)RAND_MAX);
+  }
+
+  for (uint32_t k = 0; k < sizeof(fmts) / sizeof(fmts[0]); k++) {
+    char  rf_args[RF_PARAM_LEN] = {};
+    FILE* f                     = NULL;
+
+    snprintf(rf_args, RF_PARAM_LEN, "tx_file=bench_file,tx_format=%s,base_srate=23.04e6", fmts[k]);
+    if (k == 0) {
+      f = fopen("bench_file", "w");
+      srsran_rf_open_file(&enb_radio, NULL, &f, 1, 23040000);
+    } else if (srsran_rf_open_devname(&enb_radio, "file", rf_args, 1)) {
+      fprintf(stderr, "Error opening rf\n");
+      break;
+    }
+    srsran_rf_set_tx_srate(&enb_radio, 23.04e6);
+    gettimeofday(&t[1], NULL);
+    for (uint32_t i = 0; i < nof_sf; i++) {
+      srsran_rf_send(&enb_radio, buffer, sf_len, true);
+    }
+    srsran_rf_close(&enb_radio);
+    if (f != NULL) {
+      fclose(f);
+    }
+    double tx_s = elapsed_s(t);
+
+    snprintf(rf_args, RF_PARAM_LEN, "rx_file=bench_file,rx_format=%s,base_srate=23.04e6", fmts[k]);
+    if (k == 0) {
+      f = fopen("bench_file", "r");
+      srsran_rf_open_file(&ue_radio, &f, NULL, 1, 23040000);
+    } else if (srsran_rf_open_devname(&ue_radio, "file", rf_args, 1)) {
+      fprintf(stderr, "Error opening rf\n");
+      break;
+    }
+    srsran_rf_set_rx_srate(&ue_radio, 23.04e6);
+    gettimeofday(&t[1], NULL);
+    for (uint32_t i = 0; i < nof_sf; i++) {
+      srsran_rf_recv_with_time(&ue_radio, buffer, sf_len, true, NULL, NULL);
+    }
+    srsran_rf_close(&ue_radio);
+    if (k == 0) {
+      fclose(f);
+    }
+    double rx_s = elapsed_s(t);
+
+    printf("%-6s tx: %7.1f Msps, rx: %7.1f Msps\n",
+           fmts[k],
+           nof_sf * sf_len / tx_s / 1e6,
+           nof_sf * sf_len / rx_s / 1e6);
+  }
+
+  remove_file("bench_file");
+  free(buffer);
+}
+
+void usage(char* prog)
+{
+  printf("Usage: %s [b]\n", prog);
+  printf("\t-b Run the throughput benchmark\n");
+}
+
+int main(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "b")) != -1) {
+    switch (opt) {
+      case 'b':
+        benchmark();
+        return SRSRAN_SUCCESS;
+      default:
+        usage(argv[0]);
+        return SRSRAN_ERROR;
+    }
+  }
+
   // create files for testing
   create_file("rx_file0");
   create_file("rx_file1");
@@ -290,7 +434,8 @@ int main()
 
 #if NOF_RX_ANT == 1
   // single tx, single rx with continuous transmissions (no decimation, no timed tx)
-  if (run_test("rx_file=tx_file0,base_srate=1.92e6", "tx_file=tx_file0,base_srate=1.92e6", false) != SRSRAN_SUCCESS) {
+  if (run_test("rx_file=tx_file0,base_srate=1.92e6", "tx_file=tx_file0,base_srate=1.92e6", false, COMPARE_EPSILON) !=
+      SRSRAN_SUCCESS) {
     fprintf(stderr, "Single tx, single rx test failed (no decimation, no timed tx)!\n");
     return -1;
   }
@@ -299,7 +444,8 @@ int main()
   // up to 4 trx radios with continous tx (no decimation, no timed tx)
   if (run_test("rx_file=tx_file0,rx_file=tx_file1,rx_file=tx_file2,rx_file=tx_file3,base_srate=1.92e6",
                "tx_file=tx_file0,tx_file=tx_file1,tx_file=tx_file2,tx_file=tx_file3,base_srate=1.92e6",
-               false) != SRSRAN_SUCCESS) {
+               false,
+               COMPARE_EPSILON) != SRSRAN_SUCCESS) {
     fprintf(stderr, "Multi TRx radio test failed (no decimation, no timed tx)!\n");
     return -1;
   }
@@ -307,7 +453,8 @@ int main()
   // up to 4 trx radios with continous tx (with decimation, no timed tx)
   if (run_test("rx_file=tx_file0,rx_file=tx_file1,rx_file=tx_file2,rx_file=tx_file3",
                "tx_file=tx_file0,tx_file=tx_file1,tx_file=tx_file2,tx_file=tx_file3",
-               false) != SRSRAN_SUCCESS) {
+               false,
+               COMPARE_EPSILON) != SRSRAN_SUCCESS) {
     fprintf(stderr, "Multi TRx radio test failed (with decimation, no timed tx)!\n");
     return -1;
   }
@@ -315,11 +462,45 @@ int main()
   // up to 4 trx radios with continous tx (with decimation, timed tx)
   if (run_test("rx_file=tx_file0,rx_file=tx_file1,rx_file=tx_file2,rx_file=tx_file3",
                "tx_file=tx_file0,tx_file=tx_file1,tx_file=tx_file2,tx_file=tx_file3",
-               true) != SRSRAN_SUCCESS) {
+               true,
+               COMPARE_EPSILON) != SRSRAN_SUCCESS) {
     fprintf(stderr, "Two TRx radio test failed (with decimation, timed tx)!\n");
     return -1;
   }
 
+  // up to 4 trx radios with sc16 and sc8 files (with decimation, no timed tx)
+  if (run_test("rx_file=tx_file0,rx_file=tx_file1,rx_file=tx_file2,rx_file=tx_file3,rx_format=sc16",
+               "tx_file=tx_file0,tx_file=tx_file1,tx_file=tx_file2,tx_file=tx_file3,tx_format=sc16",
+               false,
+               COMPARE_EPSILON_SC16) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Multi TRx radio test failed (sc16)!\n");
+    return -1;
+  }
+  if (run_test("rx_file=tx_file0,rx_file=tx_file1,rx_file=tx_file2,rx_file=tx_file3,rx_format=sc8",
+               "tx_file=tx_file0,tx_file=tx_file1,tx_file=tx_file2,tx_file=tx_file3,tx_format=sc8",
+               false,
+               COMPARE_EPSILON_SC8) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Multi TRx radio test failed (sc8)!\n");
+    return -1;
+  }
+
+  // SigMF recordings, where the rx side takes the format and rate from the metadata written by the tx side
+  if (run_test("rx_file=tx_file0.sigmf-data,rx_file=tx_file1.sigmf-data,"
+               "rx_file=tx_file2.sigmf-data,rx_file=tx_file3.sigmf-data",
+               "tx_file=tx_file0.sigmf-data,tx_file=tx_file1.sigmf-data,"
+               "tx_file=tx_file2.sigmf-data,tx_file=tx_file3.sigmf-data,tx_format=sc16,base_srate=1.92e6",
+               false,
+               COMPARE_EPSILON_SC16) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Multi TRx radio test failed (SigMF)!\n");
+    return -1;
+  }
+
+  // looped playback from a start time
+  if (loop_test() != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Loop test failed!\n");
+    return -1;
+  }
+
   // clean workspace
   remove_file("rx_file0");
   remove_file("rx_file1");
@@ -329,6 +510,13 @@ int main()
   remove_file("tx_file1");
   remove_file("tx_file2");
   remove_file("tx_file3");
+  for (uint32_t i = 0; i < NOF_RX_ANT; i++) {
+    char filename[RF_PARAM_LEN];
+    snprintf(filename, RF_PARAM_LEN, "tx_file%d.sigmf-data", i);
+    remove_file(filename);
+    snprintf(filename, RF_PARAM_LEN, "tx_file%d.sigmf-meta", i);
+    remove_file(filename);
+  }
 
   fprintf(stdout, "Test passed!\n");
 
@@ -0,0 +1,277 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rf_zmq_hub.h"
+#include "srsran/phy/utils/vector.h"
+#include <zmq.h>
+
+using namespace srsran;
+
+rf_zmq_hub::rf_zmq_hub(srslog::basic_logger& logger_) : logger(logger_) {}
+
+rf_zmq_hub::~rf_zmq_hub()
+{
+  // The workers must be gone before the channels they run
+  batch.reset();
+
+  for (std::unique_ptr<ue_link_t>& ue : ues) {
+    free_link(*ue);
+  }
+
+  if (enb_open) {
+    rf_zmq_rx_close(&enb_rx);
+    rf_zmq_tx_close(&enb_tx);
+  }
+
+  if (dl_buffer) {
+    free(dl_buffer);
+  }
+  if (ul_sum) {
+    free(ul_sum);
+  }
+
+  if (zmq_ctx) {
+    zmq_ctx_destroy(zmq_ctx);
+  }
+}
+
+void rf_zmq_hub::free_link(ue_link_t& ue)
+{
+  if (ue.open) {
+    rf_zmq_tx_close(&ue.tx);
+    rf_zmq_rx_close(&ue.rx);
+  }
+
+  cf_t* buffers[] = {ue.dl_buffer, ue.ul_buffer, ue.ul_ch_out};
+  for (cf_t* b : buffers) {
+    if (b) {
+      free(b);
+    }
+  }
+}
+
+int rf_zmq_hub::init(const args_t& args_)
+{
+  args       = args_;
+  block_size = (args.block_size != 0) ? args.block_size : args.base_srate / 1000;
+
+  // The channel emulators process up to 5 subframes of the largest bandwidth
+  if (block_size == 0 || block_size > (uint32_t)SRSRAN_SF_LEN_PRB(SRSRAN_MAX_PRB) * 5) {
+    logger.error("Invalid block size %d", block_size);
+    return SRSRAN_ERROR;
+  }
+  if (args.ues.empty()) {
+    logger.error("No UE links");
+    return SRSRAN_ERROR;
+  }
+
+  zmq_ctx = zmq_ctx_new();
+  if (zmq_ctx == nullptr) {
+    logger.error("Error creating ZMQ context");
+    return SRSRAN_ERROR;
+  }
+
+  // The hub connects to the ports bound by the eNB and UEs transmitters, and binds the ones they receive from
+  rf_zmq_opts_t rx_opts  = {};
+  rx_opts.id             = "hub";
+  rx_opts.socket_type    = ZMQ_REQ;
+  rx_opts.sample_format  = args.sample_format;
+  rx_opts.trx_timeout_ms = args.trx_timeout_ms;
+  rf_zmq_opts_t tx_opts  = rx_opts;
+  tx_opts.socket_type    = ZMQ_REP;
+
+  enb_open = true;
+  if (rf_zmq_rx_open(&enb_rx, rx_opts, zmq_ctx, const_cast<char*>(args.enb_rx_port.c_str())) != SRSRAN_SUCCESS ||
+      rf_zmq_tx_open(&enb_tx, tx_opts, zmq_ctx, const_cast<char*>(args.enb_tx_port.c_str())) != SRSRAN_SUCCESS) {
+    logger.error("Error opening eNB ports %s and %s", args.enb_rx_port.c_str(), args.enb_tx_port.c_str());
+    return SRSRAN_ERROR;
+  }
+
+  dl_buffer = srsran_vec_cf_malloc(block_size);
+  ul_sum    = srsran_vec_cf_malloc(block_size);
+  if (dl_buffer == nullptr || ul_sum == nullptr) {
+    return SRSRAN_ERROR;
+  }
+
+  for (const ue_args_t& ue_args : args.ues) {
+    ues.emplace_back(new ue_link_t);
+    ue_link_t& ue = *ues.back();
+
+    ue.open = true;
+    if (rf_zmq_tx_open(&ue.tx, tx_opts, zmq_ctx, const_cast<char*>(ue_args.tx_port.c_str())) != SRSRAN_SUCCESS ||
+        rf_zmq_rx_open(&ue.rx, rx_opts, zmq_ctx, const_cast<char*>(ue_args.rx_port.c_str())) != SRSRAN_SUCCESS) {
+      logger.error("Error opening UE ports %s and %s", ue_args.tx_port.c_str(), ue_args.rx_port.c_str());
+      return SRSRAN_ERROR;
+    }
+
+    if (ue_args.dl_channel.enable) {
+      ue.dl_ch.reset(new channel(ue_args.dl_channel, 1, logger));
+      ue.dl_ch->set_srate(args.base_srate);
+    }
+    if (ue_args.ul_channel.enable) {
+      ue.ul_ch.reset(new channel(ue_args.ul_channel, 1, logger));
+      ue.ul_ch->set_srate(args.base_srate);
+    }
+    ue.dl_gain = srsran_convert_dB_to_amplitude(ue_args.dl_gain_dB);
+    ue.ul_gain = srsran_convert_dB_to_amplitude(ue_args.ul_gain_dB);
+
+    ue.dl_buffer = srsran_vec_cf_malloc(block_size);
+    ue.ul_buffer = srsran_vec_cf_malloc(block_size);
+    ue.ul_ch_out = srsran_vec_cf_malloc(block_size);
+    if (ue.dl_buffer == nullptr || ue.ul_buffer == nullptr || ue.ul_ch_out == nullptr) {
+      return SRSRAN_ERROR;
+    }
+  }
+
+  batch.reset(new channel_batch(args.nof_workers));
+
+  logger.info("Hub ready with %zd UEs, %d samples per block at %.2f MHz",
+              ues.size(),
+              block_size,
+              args.base_srate / 1e6);
+  return SRSRAN_SUCCESS;
+}
+
+uint32_t rf_zmq_hub::read_block(rf_zmq_rx_t* rx, cf_t* buffer, bool wait)
+{
+  uint32_t count = 0;
+  while (count < block_size && running) {
+    int n = rf_zmq_rx_baseband(rx, &buffer[count], block_size - count);
+    if (n > 0) {
+      count += n;
+    } else if (n != SRSRAN_ERROR_TIMEOUT || !wait) {
+      break;
+    }
+  }
+  return count;
+}
+
+int rf_zmq_hub::step()
+{
+  // Downlink block from the eNB, waiting for it as long as the hub runs
+  if (read_block(&enb_rx, dl_buffer, true) != block_size) {
+    return running ? SRSRAN_ERROR : SRSRAN_ERROR_TIMEOUT;
+  }
+
+  srsran_timestamp_t ts = {};
+  srsran_timestamp_init_uint64(&ts, nof_samples, args.base_srate);
+
+  // A UE joins when its first uplink samples arrive, which it sends before waiting for the downlink. Its streams start
+  // at this block
+  dl_links.clear();
+  for (std::unique_ptr<ue_link_t>& ue : ues) {
+    if (!ue->connected && rf_zmq_rx_has_data(&ue->rx)) {
+      logger.info("UE %zd joined at sample %" PRIu64, &ue - &ues[0], nof_samples.load());
+      ue->connected = true;
+    }
+    if (ue->connected && ue->dl_ch) {
+      channel_batch::link_t link = {};
+      link.ch                    = ue->dl_ch.get();
+      link.in[0]                 = dl_buffer;
+      link.out[0]                = ue->dl_buffer;
+      dl_links.push_back(link);
+    }
+  }
+
+  // Fan out the downlink through the channel of each UE
+  batch->run(dl_links, block_size, ts);
+  for (std::unique_ptr<ue_link_t>& ue : ues) {
+    if (!ue->connected) {
+      continue;
+    }
+
+    cf_t* dl = dl_buffer;
+    if (ue->dl_ch) {
+      dl = ue->dl_buffer;
+      if (ue->dl_gain != 1.0f) {
+        srsran_vec_sc_prod_cfc(dl, ue->dl_gain, dl, block_size);
+      }
+    } else if (ue->dl_gain != 1.0f) {
+      dl = ue->dl_buffer;
+      srsran_vec_sc_prod_cfc(dl_buffer, ue->dl_gain, dl, block_size);
+    }
+
+    if (rf_zmq_tx_baseband(&ue->tx, dl, block_size) < SRSRAN_SUCCESS) {
+      logger.error("Error sending downlink to UE %zd", &ue - &ues[0]);
+      return SRSRAN_ERROR;
+    }
+  }
+
+  // Uplink block of each UE. A UE that stops sending is dropped
+  ul_links.clear();
+  for (std::unique_ptr<ue_link_t>& ue : ues) {
+    if (!ue->connected) {
+      continue;
+    }
+
+    uint32_t n = read_block(&ue->rx, ue->ul_buffer, false);
+    if (n < block_size) {
+      logger.warning("UE %zd left at sample %" PRIu64, &ue - &ues[0], nof_samples + n);
+      ue->connected = false;
+      continue;
+    }
+
+    if (ue->ul_ch) {
+      channel_batch::link_t link = {};
+      link.ch                    = ue->ul_ch.get();
+      link.in[0]                 = ue->ul_buffer;
+      link.out[0]                = ue->ul_ch_out;
+      ul_links.push_back(link);
+    }
+  }
+  batch->run(ul_links, block_size, ts);
+
+  // Add up the uplinks, the first one initialises the sum
+  bool first = true;
+  for (std::unique_ptr<ue_link_t>& ue : ues) {
+    if (!ue->connected) {
+      continue;
+    }
+
+    cf_t* ul = ue->ul_ch ? ue->ul_ch_out : ue->ul_buffer;
+    if (ue->ul_gain != 1.0f) {
+      srsran_vec_sc_prod_cfc(ul, ue->ul_gain, first ? ul_sum : ul, block_size);
+    } else if (first) {
+      srsran_vec_cf_copy(ul_sum, ul, block_size);
+    }
+    if (!first) {
+      srsran_vec_sum_ccc(ul_sum, ul, ul_sum, block_size);
+    }
+    first = false;
+  }
+  if (first) {
+    srsran_vec_cf_zero(ul_sum, block_size);
+  }
+
+  if (rf_zmq_tx_baseband(&enb_tx, ul_sum, block_size) < SRSRAN_SUCCESS) {
+    logger.error("Error sending uplink to the eNB");
+    return SRSRAN_ERROR;
+  }
+
+  nof_samples += block_size;
+  return SRSRAN_SUCCESS;
+}
+
+void rf_zmq_hub::run()
+{
+  while (running && step() == SRSRAN_SUCCESS) {
+  }
+}
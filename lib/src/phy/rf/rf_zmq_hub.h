@@ -0,0 +1,133 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_RF_ZMQ_HUB_H
+#define SRSRAN_RF_ZMQ_HUB_H
+
+#include "rf_zmq_imp_trx.h"
+#include "srsran/phy/channel/channel_batch.h"
+#include "srsran/srslog/srslog.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace srsran {
+
+/**
+ * Connects one eNB to several UEs over the ZMQ RF transport, without a dedicated eNB per UE. The downlink of the eNB is
+ * fanned out to every UE and the uplinks of all UEs are added up, each link going through its own channel emulator and
+ * gain. The ports can be ZMQ endpoints or shared memory rings ("shm://<name>"), as in the ZMQ RF device.
+ *
+ * The samples are moved in blocks, and sample k of every stream is the same instant: the hub reads a downlink block
+ * from the eNB, sends it to all UEs, reads the uplink block of every UE and sends their sum to the eNB. So the UEs and
+ * the eNB stay timestamp aligned as if they were connected directly. Since the eNB only sends a downlink subframe once
+ * it is waiting for the uplink of the previous one, a block must not be longer than a subframe.
+ *
+ * A UE joins when its first uplink samples arrive, and it is dropped from the sum when it does not send a block within
+ * the Rx timeout, which must therefore be shorter than the one of the eNB. All channel emulators are created with the
+ * same random seeds, so the fading and noise of the links are correlated.
+ */
+class rf_zmq_hub
+{
+public:
+  struct ue_args_t {
+    std::string     tx_port;    ///< downlink towards the UE, bound by the hub
+    std::string     rx_port;    ///< uplink from the UE, the UE binds it
+    float           dl_gain_dB = 0.0f;
+    float           ul_gain_dB = 0.0f;
+    channel::args_t dl_channel = {};
+    channel::args_t ul_channel = {};
+  };
+
+  struct args_t {
+    std::string            enb_rx_port;                 ///< downlink from the eNB, the eNB binds it
+    std::string            enb_tx_port;                 ///< uplink towards the eNB, bound by the hub
+    rf_zmq_format_t        sample_format  = ZMQ_TYPE_FC32;
+    uint32_t               base_srate     = ZMQ_BASERATE_DEFAULT_HZ;
+    uint32_t               block_size     = 0; ///< samples per block, a subframe if 0
+    uint32_t               nof_workers    = 0; ///< channel emulation threads besides the calling one
+    uint32_t               trx_timeout_ms = ZMQ_TIMEOUT_MS;
+    std::vector<ue_args_t> ues;
+  };
+
+  explicit rf_zmq_hub(srslog::basic_logger& logger_);
+  ~rf_zmq_hub();
+  rf_zmq_hub(const rf_zmq_hub&) = delete;
+  rf_zmq_hub& operator=(const rf_zmq_hub&) = delete;
+
+  /// Opens all ports. Returns SRSRAN_SUCCESS or SRSRAN_ERROR
+  int init(const args_t& args_);
+
+  /**
+   * Moves one block in each direction. It waits for the eNB, and for every UE that has been connected before
+   * @return SRSRAN_SUCCESS, SRSRAN_ERROR_TIMEOUT if the eNB did not send anything, or SRSRAN_ERROR
+   */
+  int step();
+
+  /// Runs step() until stop() is called or an error occurs
+  void run();
+  void stop() { running = false; }
+
+  /// Samples moved in each direction so far
+  uint64_t get_nof_samples() const { return nof_samples; }
+
+  uint32_t get_block_size() const { return block_size; }
+
+private:
+  struct ue_link_t {
+    rf_zmq_tx_t  tx        = {};
+    rf_zmq_rx_t  rx        = {};
+    channel_ptr  dl_ch     = nullptr;
+    channel_ptr  ul_ch     = nullptr;
+    float        dl_gain   = 1.0f;
+    float        ul_gain   = 1.0f;
+    cf_t*        dl_buffer = nullptr; ///< downlink after the channel, unused if there is no channel nor gain
+    cf_t*        ul_buffer = nullptr; ///< uplink as received
+    cf_t*        ul_ch_out = nullptr; ///< uplink after the channel
+    bool         connected = false;   ///< the UE has sent samples
+    bool         open      = false;
+  };
+
+  uint32_t read_block(rf_zmq_rx_t* rx, cf_t* buffer, bool wait);
+  void     free_link(ue_link_t& ue);
+
+  srslog::basic_logger& logger;
+  args_t                args       = {};
+  uint32_t              block_size = 0;
+  void*                 zmq_ctx    = nullptr;
+
+  rf_zmq_rx_t enb_rx    = {};
+  rf_zmq_tx_t enb_tx    = {};
+  bool        enb_open  = false;
+  cf_t*       dl_buffer = nullptr;
+  cf_t*       ul_sum    = nullptr;
+
+  std::vector<std::unique_ptr<ue_link_t> > ues;
+  std::unique_ptr<channel_batch>           batch;
+  std::vector<channel_batch::link_t>       dl_links, ul_links;
+  std::atomic<bool>                        running{true};
+  std::atomic<uint64_t>                    nof_samples{0};
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_RF_ZMQ_HUB_H
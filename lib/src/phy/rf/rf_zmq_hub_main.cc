@@ -0,0 +1,230 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Connects one eNB to several UEs over the ZMQ RF transport. With the default ports, the eNB is started with
+ *   device_args=tx_port=tcp://*:2000,rx_port=tcp://localhost:2001,...
+ * and UE i with
+ *   device_args=tx_port=tcp://*:<2200+i>,rx_port=tcp://localhost:<2100+i>,...
+ * The ports can also be shared memory rings, e.g. -e shm://enb_dl -E shm://enb_ul -u shm://ue%u_dl -U shm://ue%u_ul
+ */
+
+#include "rf_zmq_hub.h"
+#include "srsran/phy/rf/rf.h"
+#include "srsran/phy/utils/debug.h"
+#include <atomic>
+#include <chrono>
+#include <getopt.h>
+#include <signal.h>
+#include <thread>
+
+using namespace srsran;
+
+static std::string enb_rx_port = "tcp://localhost:2000";
+static std::string enb_tx_port = "tcp://*:2001";
+static std::string ue_tx_fmt   = "tcp://*:%u";
+static std::string ue_rx_fmt   = "tcp://localhost:%u";
+static uint32_t    ue_tx_base  = 2100;
+static uint32_t    ue_rx_base  = 2200;
+static uint32_t    nof_ues     = 1;
+static uint32_t    base_srate  = ZMQ_BASERATE_DEFAULT_HZ;
+static uint32_t    block_size  = 0;
+static uint32_t    nof_workers = 0;
+static bool        use_sc16    = false;
+static float       dl_gain_dB  = 0.0f;
+static float       ul_gain_dB  = 0.0f;
+static std::string fading_model;
+static float       delay_us = 0.0f;
+static uint32_t    run_time = 0;
+
+static rf_zmq_hub* hub = nullptr;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [eEuUbBnslwfgGmdtv]\n", prog);
+  printf("\t-e eNB downlink port [Default %s]\n", enb_rx_port.c_str());
+  printf("\t-E eNB uplink port [Default %s]\n", enb_tx_port.c_str());
+  printf("\t-u UE downlink port, %%u is replaced by the port number [Default %s]\n", ue_tx_fmt.c_str());
+  printf("\t-b first UE downlink port number [Default %d]\n", ue_tx_base);
+  printf("\t-U UE uplink port, %%u is replaced by the port number [Default %s]\n", ue_rx_fmt.c_str());
+  printf("\t-B first UE uplink port number [Default %d]\n", ue_rx_base);
+  printf("\t-n number of UEs [Default %d]\n", nof_ues);
+  printf("\t-s base sampling rate in Hz [Default %d]\n", base_srate);
+  printf("\t-l samples per block, up to a subframe [Default a subframe]\n");
+  printf("\t-w channel emulation worker threads [Default %d]\n", nof_workers);
+  printf("\t-f use sc16 samples instead of fc32\n");
+  printf("\t-g downlink gain in dB [Default %.1f]\n", dl_gain_dB);
+  printf("\t-G uplink gain in dB [Default %.1f]\n", ul_gain_dB);
+  printf("\t-m fading model of every link, e.g. epa5 [Default none]\n");
+  printf("\t-d fixed delay of every link in us [Default none]\n");
+  printf("\t-t run time in seconds [Default until interrupted]\n");
+  printf("\t-v increase verbosity\n");
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "eEuUbBnslwfgGmdtv")) != -1) {
+    switch (opt) {
+      case 'e':
+        enb_rx_port = argv[optind];
+        break;
+      case 'E':
+        enb_tx_port = argv[optind];
+        break;
+      case 'u':
+        ue_tx_fmt = argv[optind];
+        break;
+      case 'U':
+        ue_rx_fmt = argv[optind];
+        break;
+      case 'b':
+        ue_tx_base = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'B':
+        ue_rx_base = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'n':
+        nof_ues = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        base_srate = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        block_size = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'w':
+        nof_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'f':
+        use_sc16 = true;
+        break;
+      case 'g':
+        dl_gain_dB = strtof(argv[optind], NULL);
+        break;
+      case 'G':
+        ul_gain_dB = strtof(argv[optind], NULL);
+        break;
+      case 'm':
+        fading_model = argv[optind];
+        break;
+      case 'd':
+        delay_us = strtof(argv[optind], NULL);
+        break;
+      case 't':
+        run_time = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static std::string make_port(const std::string& fmt, uint32_t number)
+{
+  char port[RF_PARAM_LEN] = {};
+  snprintf(port, sizeof(port), fmt.c_str(), number);
+  return port;
+}
+
+static void sig_int_handler(int signo)
+{
+  if (hub != nullptr) {
+    hub->stop();
+  }
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  srslog::init();
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("HUB", false);
+  logger.set_level(get_srsran_verbose_level() > 0 ? srslog::basic_levels::debug : srslog::basic_levels::info);
+
+  rf_zmq_hub::args_t args = {};
+  args.enb_rx_port        = enb_rx_port;
+  args.enb_tx_port        = enb_tx_port;
+  args.sample_format      = use_sc16 ? ZMQ_TYPE_SC16 : ZMQ_TYPE_FC32;
+  args.base_srate         = base_srate;
+  args.block_size         = block_size;
+  args.nof_workers        = nof_workers;
+
+  for (uint32_t i = 0; i < nof_ues; i++) {
+    rf_zmq_hub::ue_args_t ue = {};
+    ue.tx_port               = make_port(ue_tx_fmt, ue_tx_base + i);
+    ue.rx_port               = make_port(ue_rx_fmt, ue_rx_base + i);
+    ue.dl_gain_dB            = dl_gain_dB;
+    ue.ul_gain_dB            = ul_gain_dB;
+
+    channel::args_t ch = {};
+    if (not fading_model.empty()) {
+      ch.enable        = true;
+      ch.fading_enable = true;
+      ch.fading_model  = fading_model;
+    }
+    if (delay_us > 0) {
+      ch.enable       = true;
+      ch.delay_enable = true;
+      ch.delay_min_us = delay_us;
+      ch.delay_max_us = delay_us;
+    }
+    ue.dl_channel = ch;
+    ue.ul_channel = ch;
+    args.ues.push_back(ue);
+  }
+
+  rf_zmq_hub zmq_hub(logger);
+  if (zmq_hub.init(args) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Error initialising the hub\n");
+    return SRSRAN_ERROR;
+  }
+  hub = &zmq_hub;
+  signal(SIGINT, sig_int_handler);
+
+  // Throughput report, once per second
+  std::atomic<bool> done{false};
+  std::thread       stats([&zmq_hub, &done]() {
+    uint64_t last    = 0;
+    uint32_t elapsed = 0;
+    while (not done) {
+      std::this_thread::sleep_for(std::chrono::seconds(1));
+      uint64_t n = zmq_hub.get_nof_samples();
+      printf("%d s: %.2f Msps, %.1f%% of real time\n", ++elapsed, (n - last) / 1e6, 100.0 * (n - last) / base_srate);
+      last = n;
+      if (run_time > 0 && elapsed >= run_time) {
+        zmq_hub.stop();
+      }
+    }
+  });
+
+  zmq_hub.run();
+  done = true;
+  stats.join();
+
+  hub = nullptr;
+  printf("Moved %" PRIu64 " samples in each direction\n", zmq_hub.get_nof_samples());
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,270 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Runs the hub between an emulated eNB and several emulated UEs, connected through shared memory rings, and checks that
+ * every UE receives the downlink with its gain and that the eNB receives the sum of the uplinks, sample aligned. The
+ * last UE leaves halfway, after which its uplink must no longer be added.
+ */
+
+#include "rf_zmq_hub.h"
+#include "srsran/support/srsran_test.h"
+#include "srsran/phy/utils/vector.h"
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <zmq.h>
+
+using namespace srsran;
+
+namespace {
+
+const uint32_t nof_ues    = 4;
+const uint32_t nof_blocks = 200;
+const uint32_t base_srate = 1920000;
+const uint32_t block_size = base_srate / 1000;
+const float    epsilon    = 1e-4f;
+
+// The hub drops a UE after its timeout, which must be shorter than the one of the eNB
+const uint32_t hub_timeout_ms = 100;
+const uint32_t trx_timeout_ms = 1000;
+
+uint32_t ue_nof_blocks(uint32_t ue)
+{
+  return (ue == nof_ues - 1) ? nof_blocks / 2 : nof_blocks;
+}
+
+float dl_gain(uint32_t ue)
+{
+  return srsran_convert_dB_to_amplitude(-3.0f * ue);
+}
+
+float ul_gain(uint32_t ue)
+{
+  return srsran_convert_dB_to_amplitude(-6.0f * ue);
+}
+
+// Downlink samples of a block, different for every sample of the test
+void dl_block(uint32_t block, cf_t* x)
+{
+  for (uint32_t i = 0; i < block_size; i++) {
+    float v = ((block * block_size + i) % 1000) / 1000.0f;
+    x[i]    = {v, 0.5f - v};
+  }
+}
+
+// Uplink samples of a UE
+void ul_block(uint32_t ue, uint32_t block, cf_t* x)
+{
+  dl_block(block, x);
+  srsran_vec_sc_prod_cfc(x, 0.1f * (ue + 1), x, block_size);
+}
+
+std::string make_port(const char* name, uint32_t ue)
+{
+  return "shm://hub_test_" + std::string(name) + std::to_string(ue);
+}
+
+rf_zmq_opts_t make_opts(const char* id, uint32_t socket_type)
+{
+  rf_zmq_opts_t opts  = {};
+  opts.id             = id;
+  opts.socket_type    = socket_type;
+  opts.sample_format  = ZMQ_TYPE_FC32;
+  opts.trx_timeout_ms = trx_timeout_ms;
+  return opts;
+}
+
+int read_block(rf_zmq_rx_t* rx, cf_t* buffer)
+{
+  uint32_t count = 0;
+  while (count < block_size) {
+    int n = rf_zmq_rx_baseband(rx, &buffer[count], block_size - count);
+    if (n < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+    count += n;
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int compare(const char* what, uint32_t block, const cf_t* x, const cf_t* y)
+{
+  for (uint32_t i = 0; i < block_size; i++) {
+    cf_t d = x[i] - y[i];
+    if (std::hypot(__real__ d, __imag__ d) > epsilon) {
+      printf("%s block %d sample %d: %+.4f%+.4fi != %+.4f%+.4fi\n",
+             what,
+             block,
+             i,
+             __real__ x[i],
+             __imag__ x[i],
+             __real__ y[i],
+             __imag__ y[i]);
+      return SRSRAN_ERROR;
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+// Sends the uplink of each block before waiting for its downlink, as a UE transmits ahead of its reception
+int ue_emulator(void* zmq_ctx, uint32_t ue, std::atomic<uint32_t>* nof_ready)
+{
+  std::string tx_port = make_port("ul", ue);
+  std::string rx_port = make_port("dl", ue);
+  rf_zmq_tx_t tx      = {};
+  rf_zmq_rx_t rx      = {};
+  TESTASSERT(rf_zmq_tx_open(&tx, make_opts("ue", ZMQ_REP), zmq_ctx, &tx_port[0]) == SRSRAN_SUCCESS);
+  TESTASSERT(rf_zmq_rx_open(&rx, make_opts("ue", ZMQ_REQ), zmq_ctx, &rx_port[0]) == SRSRAN_SUCCESS);
+
+  std::vector<cf_t> buffer(block_size), expected(block_size);
+  int               ret = SRSRAN_SUCCESS;
+  for (uint32_t k = 0; k < ue_nof_blocks(ue) && ret == SRSRAN_SUCCESS; k++) {
+    ul_block(ue, k, buffer.data());
+    if (rf_zmq_tx_baseband(&tx, buffer.data(), block_size) != (int)block_size) {
+      ret = SRSRAN_ERROR;
+      break;
+    }
+    if (k == 0) {
+      (*nof_ready)++;
+    }
+
+    dl_block(k, expected.data());
+    srsran_vec_sc_prod_cfc(expected.data(), dl_gain(ue), expected.data(), block_size);
+    ret = read_block(&rx, buffer.data());
+    if (ret == SRSRAN_SUCCESS) {
+      ret = compare("Downlink", k, buffer.data(), expected.data());
+    }
+  }
+
+  rf_zmq_tx_close(&tx);
+  rf_zmq_rx_close(&rx);
+  return ret;
+}
+
+// Sends the downlink of each block and checks the uplink sum, once all UEs are connected
+int enb_emulator(void* zmq_ctx, std::atomic<uint32_t>* nof_ready)
+{
+  std::string tx_port = make_port("enb_dl", 0);
+  std::string rx_port = make_port("enb_ul", 0);
+  rf_zmq_tx_t tx      = {};
+  rf_zmq_rx_t rx      = {};
+  TESTASSERT(rf_zmq_tx_open(&tx, make_opts("enb", ZMQ_REP), zmq_ctx, &tx_port[0]) == SRSRAN_SUCCESS);
+  TESTASSERT(rf_zmq_rx_open(&rx, make_opts("enb", ZMQ_REQ), zmq_ctx, &rx_port[0]) == SRSRAN_SUCCESS);
+
+  while (*nof_ready < nof_ues) {
+    std::this_thread::yield();
+  }
+
+  std::vector<cf_t> buffer(block_size), expected(block_size), ul(block_size);
+  int               ret = SRSRAN_SUCCESS;
+  for (uint32_t k = 0; k < nof_blocks && ret == SRSRAN_SUCCESS; k++) {
+    dl_block(k, buffer.data());
+    if (rf_zmq_tx_baseband(&tx, buffer.data(), block_size) != (int)block_size) {
+      ret = SRSRAN_ERROR;
+      break;
+    }
+
+    srsran_vec_cf_zero(expected.data(), block_size);
+    for (uint32_t ue = 0; ue < nof_ues; ue++) {
+      if (k < ue_nof_blocks(ue)) {
+        ul_block(ue, k, ul.data());
+        srsran_vec_sc_prod_cfc(ul.data(), ul_gain(ue), ul.data(), block_size);
+        srsran_vec_sum_ccc(expected.data(), ul.data(), expected.data(), block_size);
+      }
+    }
+    ret = read_block(&rx, buffer.data());
+    if (ret == SRSRAN_SUCCESS) {
+      ret = compare("Uplink", k, buffer.data(), expected.data());
+    }
+  }
+
+  rf_zmq_tx_close(&tx);
+  rf_zmq_rx_close(&rx);
+  return ret;
+}
+
+int test_hub(uint32_t nof_workers)
+{
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("HUB", false);
+  logger.set_level(srslog::basic_levels::info);
+
+  rf_zmq_hub::args_t args = {};
+  args.enb_rx_port        = make_port("enb_dl", 0);
+  args.enb_tx_port        = make_port("enb_ul", 0);
+  args.base_srate         = base_srate;
+  args.nof_workers        = nof_workers;
+  args.trx_timeout_ms     = hub_timeout_ms;
+  for (uint32_t ue = 0; ue < nof_ues; ue++) {
+    rf_zmq_hub::ue_args_t ue_args = {};
+    ue_args.tx_port               = make_port("dl", ue);
+    ue_args.rx_port               = make_port("ul", ue);
+    ue_args.dl_gain_dB            = -3.0f * ue;
+    ue_args.ul_gain_dB            = -6.0f * ue;
+    // The first UE goes through channel emulators without any stage, which leave the signal as it is
+    ue_args.dl_channel.enable = (ue == 0);
+    ue_args.ul_channel.enable = (ue == 0);
+    args.ues.push_back(ue_args);
+  }
+
+  rf_zmq_hub hub(logger);
+  TESTASSERT(hub.init(args) == SRSRAN_SUCCESS);
+  TESTASSERT_EQ(block_size, hub.get_block_size());
+  std::thread hub_thread([&hub]() { hub.run(); });
+
+  void*                    zmq_ctx = zmq_ctx_new();
+  std::atomic<uint32_t>    nof_ready{0};
+  std::vector<int>         ue_ret(nof_ues, SRSRAN_ERROR);
+  std::vector<std::thread> ue_threads;
+  for (uint32_t ue = 0; ue < nof_ues; ue++) {
+    ue_threads.emplace_back([&ue_ret, zmq_ctx, ue, &nof_ready]() {
+      ue_ret[ue] = ue_emulator(zmq_ctx, ue, &nof_ready);
+    });
+  }
+  int enb_ret = enb_emulator(zmq_ctx, &nof_ready);
+
+  for (std::thread& t : ue_threads) {
+    t.join();
+  }
+  hub.stop();
+  hub_thread.join();
+  zmq_ctx_destroy(zmq_ctx);
+
+  TESTASSERT(enb_ret == SRSRAN_SUCCESS);
+  for (uint32_t ue = 0; ue < nof_ues; ue++) {
+    TESTASSERT(ue_ret[ue] == SRSRAN_SUCCESS);
+  }
+  TESTASSERT(hub.get_nof_samples() >= (uint64_t)nof_blocks * block_size);
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace
+
+int main()
+{
+  srslog::init();
+
+  TESTASSERT(test_hub(0) == SRSRAN_SUCCESS);
+  TESTASSERT(test_hub(2) == SRSRAN_SUCCESS);
+
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -47,6 +47,7 @@ typedef struct {
   uint32_t tx_freq_mhz[SRSRAN_MAX_CHANNELS];
   uint32_t rx_freq_mhz[SRSRAN_MAX_CHANNELS];
   bool     tx_off;
+  bool     virtual_clock; // receive as soon as the peer has sent the samples, instead of pacing on the wall clock
   char     id[RF_PARAM_LEN];
 
   // Server
@@ -288,6 +289,11 @@ int rf_zmq_open_multi(char* args, void** h, uint32_t nof_channels)
           goto clean_exit;
         }
       }
+
+      // virtual_clock
+      if (parse_string(args, "virtual_clock", -1, tmp) == SRSRAN_SUCCESS) {
+        handler->virtual_clock = (strncmp(tmp, "true", RF_PARAM_LEN) == 0 || strncmp(tmp, "yes", RF_PARAM_LEN) == 0);
+      }
     } else {
       fprintf(stderr,
               "[zmq] Error: No device 'args' option has been set. Please make sure to set this option to be able to "
@@ -710,8 +716,11 @@ int rf_zmq_recv_with_time_multi(void* h, void** data, uint32_t nsamples, bool bl
     rf_zmq_info(handler->id, " - next rx time: %d + %.3f\n", ts_rx.full_secs, ts_rx.frac_secs);
     rf_zmq_info(handler->id, " - next tx time: %d + %.3f\n", ts_tx.full_secs, ts_tx.frac_secs);
 
-    // Leave time for the Tx to transmit
-    usleep((1000000UL * nsamples_baserate) / handler->base_srate);
+    // Leave time for the Tx to transmit. With a virtual clock, the PHY has sent its Tx samples before receiving again,
+    // and the reception blocks until the peer has sent its own
+    if (!handler->virtual_clock) {
+      usleep((1000000UL * nsamples_baserate) / handler->base_srate);
+    }
 
     // check for tx gap if we're also transmitting on this radio
     for (int i = 0; i < handler->nof_channels; i++) {
@@ -733,7 +742,7 @@ int rf_zmq_recv_with_time_multi(void* h, void** data, uint32_t nsamples, bool bl
         // Completed condition
         if (count[i] < nsamples_baserate && rf_zmq_rx_is_running(&handler->receiver[i])) {
           // Keep receiving
-          int32_t n = rf_zmq_rx_baseband(&handler->receiver[i], &ptr[count[i]], nsamples_baserate);
+          int32_t n = rf_zmq_rx_baseband(&handler->receiver[i], &ptr[count[i]], nsamples_baserate - count[i]);
 #if ZMQ_MONITOR
           // handle socket events
           int event = rf_zmq_rx_get_monitor_event(handler->receiver[i].socket_monitor, NULL, NULL);
@@ -110,12 +110,6 @@ int rf_zmq_rx_open(rf_zmq_rx_t* q, rf_zmq_opts_t opts, void* zmq_ctx, char* sock
     strncpy(q->id, opts.id, ZMQ_ID_STRLEN - 1);
     q->id[ZMQ_ID_STRLEN - 1] = '\0';
 
-    // Create socket
-    q->sock = zmq_socket(zmq_ctx, opts.socket_type);
-    if (!q->sock) {
-      fprintf(stderr, "[zmq] Error: creating transmitter socket\n");
-      goto clean_exit;
-    }
     q->socket_type        = opts.socket_type;
     q->sample_format      = opts.sample_format;
     q->frequency_mhz      = opts.frequency_mhz;
@@ -124,6 +118,32 @@ int rf_zmq_rx_open(rf_zmq_rx_t* q, rf_zmq_opts_t opts, void* zmq_ctx, char* sock
     q->trx_timeout_ms     = opts.trx_timeout_ms;
     q->log_trx_timeout    = opts.log_trx_timeout;
 
+    // The shared memory transport is read in the caller context, straight into its buffers. The sample format is the
+    // one of the transmitter
+    if (rf_zmq_shm_is_port(sock_args)) {
+      rf_zmq_info(q->id, "Attaching shared memory receiver: %s\n", sock_args);
+      if (rf_zmq_shm_open(&q->shm, sock_args, false, false, opts.trx_timeout_ms)) {
+        goto clean_exit;
+      }
+      q->use_shm = true;
+
+      if (pthread_mutex_init(&q->mutex, NULL)) {
+        fprintf(stderr, "Error: creating mutex\n");
+        goto clean_exit;
+      }
+
+      q->running = true;
+      ret        = SRSRAN_SUCCESS;
+      goto clean_exit;
+    }
+
+    // Create socket
+    q->sock = zmq_socket(zmq_ctx, opts.socket_type);
+    if (!q->sock) {
+      fprintf(stderr, "[zmq] Error: creating transmitter socket\n");
+      goto clean_exit;
+    }
+
     if (opts.socket_type == ZMQ_SUB) {
       zmq_setsockopt(q->sock, ZMQ_SUBSCRIBE, "", 0);
     }
@@ -207,8 +227,43 @@ clean_exit:
   return ret;
 }
 
+static int rf_zmq_rx_baseband_shm(rf_zmq_rx_t* q, cf_t* buffer, uint32_t nsamples)
+{
+  // If the read needs to be delayed
+  uint32_t nof_zeros = 0;
+  if (q->sample_offset > 0) {
+    nof_zeros = SRSRAN_MIN((uint32_t)q->sample_offset, nsamples);
+    srsran_vec_cf_zero(buffer, nof_zeros);
+    q->sample_offset -= nof_zeros;
+  }
+
+  // If the read needs to be advanced
+  while (q->sample_offset < 0) {
+    int n = rf_zmq_shm_read(&q->shm, NULL, (uint32_t)-q->sample_offset);
+    if (n < SRSRAN_SUCCESS) {
+      return n;
+    }
+    q->sample_offset += n;
+  }
+
+  if (nof_zeros == nsamples) {
+    return nsamples;
+  }
+
+  int n = rf_zmq_shm_read(&q->shm, &buffer[nof_zeros], nsamples - nof_zeros);
+  if (n < SRSRAN_SUCCESS) {
+    return (nof_zeros > 0) ? (int)nof_zeros : n;
+  }
+
+  return nof_zeros + n;
+}
+
 int rf_zmq_rx_baseband(rf_zmq_rx_t* q, cf_t* buffer, uint32_t nsamples)
 {
+  if (q->use_shm) {
+    return rf_zmq_rx_baseband_shm(q, buffer, nsamples);
+  }
+
   void*    dst_buffer = buffer;
   uint32_t sample_sz  = sizeof(cf_t);
   if (q->sample_format != ZMQ_TYPE_FC32) {
@@ -247,7 +302,7 @@ int rf_zmq_rx_baseband(rf_zmq_rx_t* q, cf_t* buffer, uint32_t nsamples)
     srsran_vec_convert_if(dst_buffer, INT16_MAX, (float*)buffer, 2 * nsamples);
   }
 
-  return n;
+  return n / (int)sample_sz;
 }
 
 bool rf_zmq_rx_match_freq(rf_zmq_rx_t* q, uint32_t freq_hz)
@@ -289,6 +344,10 @@ void rf_zmq_rx_close(rf_zmq_rx_t* q)
     q->sock = NULL;
   }
 
+  if (q->use_shm) {
+    rf_zmq_shm_close(&q->shm);
+  }
+
 #if ZMQ_MONITOR
   if (q->socket_monitor) {
     zmq_close(q->socket_monitor);
@@ -310,3 +369,16 @@ bool rf_zmq_rx_is_running(rf_zmq_rx_t* q)
 
   return ret;
 }
+
+bool rf_zmq_rx_has_data(rf_zmq_rx_t* q)
+{
+  if (!q) {
+    return false;
+  }
+
+  if (q->use_shm) {
+    return rf_zmq_shm_has_data(&q->shm);
+  }
+
+  return srsran_ringbuffer_status(&q->ringbuffer) > 0;
+}
@@ -22,6 +22,7 @@
 #ifndef SRSRAN_RF_ZMQ_IMP_TRX_H
 #define SRSRAN_RF_ZMQ_IMP_TRX_H
 
+#include "rf_zmq_shm.h"
 #include <pthread.h>
 #include <srsran/phy/utils/ringbuffer.h>
 #include <stdbool.h>
@@ -52,6 +53,8 @@ typedef struct {
   void*           temp_buffer_convert;
   uint32_t        frequency_mhz;
   int32_t         sample_offset;
+  bool            use_shm; ///< shared memory transport instead of the socket
+  rf_zmq_shm_t    shm;
 } rf_zmq_tx_t;
 
 typedef struct {
@@ -75,6 +78,8 @@ typedef struct {
   uint32_t            trx_timeout_ms;
   bool                log_trx_timeout;
   int32_t             sample_offset;
+  bool                use_shm; ///< shared memory transport instead of the socket and the async thread
+  rf_zmq_shm_t        shm;
 } rf_zmq_rx_t;
 
 typedef struct {
@@ -88,6 +93,10 @@ typedef struct {
   int32_t         sample_offset; ///< offset in samples
 } rf_zmq_opts_t;
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /*
  * Common functions
  */
@@ -129,4 +138,11 @@ SRSRAN_API void rf_zmq_rx_close(rf_zmq_rx_t* q);
 
 SRSRAN_API bool rf_zmq_rx_is_running(rf_zmq_rx_t* q);
 
+/// Returns true if there are received samples that can be read without waiting
+SRSRAN_API bool rf_zmq_rx_has_data(rf_zmq_rx_t* q);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // SRSRAN_RF_ZMQ_IMP_TRX_H
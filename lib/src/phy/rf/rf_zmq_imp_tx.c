@@ -39,16 +39,35 @@ int rf_zmq_tx_open(rf_zmq_tx_t* q, rf_zmq_opts_t opts, void* zmq_ctx, char* sock
     strncpy(q->id, opts.id, ZMQ_ID_STRLEN - 1);
     q->id[ZMQ_ID_STRLEN - 1] = '\0';
 
+    q->socket_type   = opts.socket_type;
+    q->sample_format = opts.sample_format;
+    q->frequency_mhz = opts.frequency_mhz;
+    q->sample_offset = opts.sample_offset;
+
+    // The shared memory transport writes the samples straight into the ring, without socket nor buffers
+    if (rf_zmq_shm_is_port(sock_args)) {
+      rf_zmq_info(q->id, "Creating shared memory transmitter: %s\n", sock_args);
+      if (rf_zmq_shm_open(&q->shm, sock_args, true, opts.sample_format == ZMQ_TYPE_SC16, opts.trx_timeout_ms)) {
+        goto clean_exit;
+      }
+      q->use_shm = true;
+
+      if (pthread_mutex_init(&q->mutex, NULL)) {
+        fprintf(stderr, "Error: creating mutex\n");
+        goto clean_exit;
+      }
+
+      q->running = true;
+      ret        = SRSRAN_SUCCESS;
+      goto clean_exit;
+    }
+
     // Create socket
     q->sock = zmq_socket(zmq_ctx, opts.socket_type);
     if (!q->sock) {
       fprintf(stderr, "[zmq] Error: creating transmitter socket\n");
       goto clean_exit;
     }
-    q->socket_type   = opts.socket_type;
-    q->sample_format = opts.sample_format;
-    q->frequency_mhz = opts.frequency_mhz;
-    q->sample_offset = opts.sample_offset;
 
     rf_zmq_info(q->id, "Binding transmitter: %s\n", sock_args);
 
@@ -104,10 +123,37 @@ clean_exit:
   return ret;
 }
 
+static int _rf_zmq_tx_baseband_shm(rf_zmq_tx_t* q, cf_t* buffer, uint32_t nsamples)
+{
+  // Zeros are written as empty blocks
+  if (buffer == q->zeros) {
+    buffer = NULL;
+  }
+
+  uint32_t count = 0;
+  while (count < nsamples && q->running) {
+    int n = rf_zmq_shm_write(&q->shm, q->nsamples + count, buffer ? &buffer[count] : NULL, nsamples - count);
+    if (n == SRSRAN_ERROR_TIMEOUT) {
+      rf_zmq_info(q->id, " - timeout waiting for the receiver to read\n");
+    } else if (n < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    } else {
+      count += n;
+    }
+  }
+
+  q->nsamples += nsamples;
+  return nsamples;
+}
+
 static int _rf_zmq_tx_baseband(rf_zmq_tx_t* q, cf_t* buffer, uint32_t nsamples)
 {
   int n = SRSRAN_ERROR;
 
+  if (q->use_shm) {
+    return _rf_zmq_tx_baseband_shm(q, buffer, nsamples);
+  }
+
   while (n < 0 && q->running) {
     // Receive Transmit request is socket type is REPLY
     if (q->socket_type == ZMQ_REP) {
@@ -132,9 +178,9 @@ static int _rf_zmq_tx_baseband(rf_zmq_tx_t* q, cf_t* buffer, uint32_t nsamples)
     uint32_t sample_sz = sizeof(cf_t);
 
     if (q->sample_format == ZMQ_TYPE_SC16) {
-      buf       = q->temp_buffer_convert;
       sample_sz = 2 * sizeof(short);
-      srsran_vec_convert_fi((float*)buffer, INT16_MAX, (short*)q->temp_buffer_convert, 2 * nsamples);
+      srsran_vec_convert_fi((float*)buf, INT16_MAX, (short*)q->temp_buffer_convert, 2 * nsamples);
+      buf = q->temp_buffer_convert;
     }
 
     // Send base-band if request was received
@@ -145,10 +191,10 @@ static int _rf_zmq_tx_baseband(rf_zmq_tx_t* q, cf_t* buffer, uint32_t nsamples)
           n = SRSRAN_ERROR;
           goto clean_exit;
         }
-      } else if (n != NSAMPLES2NBYTES(nsamples)) {
+      } else if (n != sample_sz * nsamples) {
         rf_zmq_error(q->id,
                      "[zmq] Error: transmitter expected %d bytes and sent %d. %s.\n",
-                     NSAMPLES2NBYTES(nsamples),
+                     sample_sz * nsamples,
                      n,
                      strerror(zmq_errno()));
         n = SRSRAN_ERROR;
@@ -258,6 +304,10 @@ void rf_zmq_tx_close(rf_zmq_tx_t* q)
     zmq_close(q->sock);
     q->sock = NULL;
   }
+
+  if (q->use_shm) {
+    rf_zmq_shm_close(&q->shm);
+  }
 }
 
 bool rf_zmq_tx_is_running(rf_zmq_tx_t* q)
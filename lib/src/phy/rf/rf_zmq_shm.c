@@ -0,0 +1,370 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rf_zmq_shm.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <srsran/phy/utils/vector.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ZMQ_SHM_MAGIC (0x534d515aU) // "ZQMS"
+#define ZMQ_SHM_NAME_PREFIX "/srsran_zmq_"
+#define ZMQ_SHM_CACHE_LINE (64)
+#define ZMQ_SHM_BLOCK_STRIDE (ZMQ_SHM_CACHE_LINE + ZMQ_SHM_BLOCK_SIZE)
+#define ZMQ_SHM_NOF_SPINS (256) // polls yielding the CPU before sleeping between them
+#define ZMQ_SHM_SLEEP_US (20)
+
+/*
+ * Region layout: header, followed by ZMQ_SHM_NOF_BLOCKS blocks. Each block is a block descriptor padded to a cache line
+ * and ZMQ_SHM_BLOCK_SIZE bytes of payload. The producer only writes write_idx and the blocks it has not published yet,
+ * and the consumer only writes read_idx, so no locks are shared between the processes
+ */
+typedef struct {
+  _Atomic uint32_t magic; ///< written last by the producer, once the header is valid
+  uint32_t         nof_blocks;
+  uint32_t         block_size;
+  uint32_t         sc16;
+  _Atomic uint32_t closed; ///< set by the producer before unmapping the region
+
+  _Alignas(ZMQ_SHM_CACHE_LINE) _Atomic uint64_t write_idx;
+  _Alignas(ZMQ_SHM_CACHE_LINE) _Atomic uint64_t read_idx;
+} rf_zmq_shm_hdr_t;
+
+typedef struct {
+  uint64_t timestamp; ///< of the first sample, in samples at the base rate
+  uint32_t nsamples;
+  uint32_t zeros; ///< the block has no payload and all its samples are zero
+} rf_zmq_shm_block_t;
+
+#define ZMQ_SHM_HDR_SIZE (SRSRAN_CEIL(sizeof(rf_zmq_shm_hdr_t), ZMQ_SHM_CACHE_LINE) * ZMQ_SHM_CACHE_LINE)
+
+static inline rf_zmq_shm_hdr_t* shm_hdr(rf_zmq_shm_t* q)
+{
+  return (rf_zmq_shm_hdr_t*)q->region;
+}
+
+static inline rf_zmq_shm_block_t* shm_block(rf_zmq_shm_t* q, uint64_t idx)
+{
+  return (rf_zmq_shm_block_t*)((uint8_t*)q->region + ZMQ_SHM_HDR_SIZE +
+                               (idx % ZMQ_SHM_NOF_BLOCKS) * ZMQ_SHM_BLOCK_STRIDE);
+}
+
+static inline void* shm_payload(rf_zmq_shm_block_t* block)
+{
+  return (uint8_t*)block + ZMQ_SHM_CACHE_LINE;
+}
+
+static uint64_t shm_now_ms(void)
+{
+  struct timespec ts = {};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Waits a bit for the peer. Returns true once the timeout has expired since the first call with *nof_polls == 0
+static bool shm_backoff(rf_zmq_shm_t* q, uint32_t* nof_polls, uint64_t* start_ms)
+{
+  if (*nof_polls == 0) {
+    *start_ms = shm_now_ms();
+  }
+  (*nof_polls)++;
+
+  if (*nof_polls < ZMQ_SHM_NOF_SPINS) {
+    sched_yield();
+    return false;
+  }
+
+  usleep(ZMQ_SHM_SLEEP_US);
+  return q->timeout_ms != 0 && shm_now_ms() - *start_ms >= q->timeout_ms;
+}
+
+// Consumer side. Maps the region if the producer has created and initialised it
+static bool shm_attach(rf_zmq_shm_t* q)
+{
+  int fd = shm_open(q->name, O_RDWR, 0);
+  if (fd < 0) {
+    return false;
+  }
+
+  // The producer may not have set the size yet
+  struct stat st = {};
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size != q->region_sz) {
+    close(fd);
+    return false;
+  }
+
+  void* region = mmap(NULL, q->region_sz, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (region == MAP_FAILED) {
+    return false;
+  }
+  q->region = region;
+
+  rf_zmq_shm_hdr_t* hdr = shm_hdr(q);
+  if (atomic_load_explicit(&hdr->magic, memory_order_acquire) != ZMQ_SHM_MAGIC ||
+      hdr->nof_blocks != ZMQ_SHM_NOF_BLOCKS || hdr->block_size != ZMQ_SHM_BLOCK_SIZE) {
+    munmap(q->region, q->region_sz);
+    q->region = NULL;
+    return false;
+  }
+
+  q->sc16         = hdr->sc16 != 0;
+  q->synced       = false;
+  q->block_offset = 0;
+  return true;
+}
+
+static void shm_detach(rf_zmq_shm_t* q)
+{
+  if (q->region) {
+    munmap(q->region, q->region_sz);
+    q->region = NULL;
+  }
+}
+
+bool rf_zmq_shm_is_port(const char* port)
+{
+  return port != NULL && strncmp(port, ZMQ_SHM_PREFIX, strlen(ZMQ_SHM_PREFIX)) == 0;
+}
+
+int rf_zmq_shm_open(rf_zmq_shm_t* q, const char* port, bool producer, bool sc16, uint32_t timeout_ms)
+{
+  if (q == NULL || !rf_zmq_shm_is_port(port)) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  bzero(q, sizeof(rf_zmq_shm_t));
+
+  // The object name is the port without the scheme, with any other slash replaced
+  const char* suffix = port + strlen(ZMQ_SHM_PREFIX);
+  if (strlen(suffix) == 0 || strlen(ZMQ_SHM_NAME_PREFIX) + strlen(suffix) >= ZMQ_SHM_NAME_LEN) {
+    fprintf(stderr, "[zmq] Error: invalid shared memory port '%s'\n", port);
+    return SRSRAN_ERROR;
+  }
+  snprintf(q->name, ZMQ_SHM_NAME_LEN, ZMQ_SHM_NAME_PREFIX "%s", suffix);
+  for (char* c = q->name + 1; *c != '\0'; c++) {
+    if (*c == '/') {
+      *c = '_';
+    }
+  }
+
+  q->producer   = producer;
+  q->sc16       = sc16;
+  q->timeout_ms = timeout_ms;
+  q->region_sz  = ZMQ_SHM_HDR_SIZE + (size_t)ZMQ_SHM_NOF_BLOCKS * ZMQ_SHM_BLOCK_STRIDE;
+
+  // The consumer maps the region on its first read
+  if (!producer) {
+    return SRSRAN_SUCCESS;
+  }
+
+  // Replace the region left by a previous run, if any, since its indexes are stale
+  shm_unlink(q->name);
+  int fd = shm_open(q->name, O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    fprintf(stderr, "[zmq] Error: creating shared memory %s: %s\n", q->name, strerror(errno));
+    return SRSRAN_ERROR;
+  }
+
+  if (ftruncate(fd, (off_t)q->region_sz) != 0) {
+    fprintf(stderr, "[zmq] Error: setting the size of shared memory %s: %s\n", q->name, strerror(errno));
+    close(fd);
+    shm_unlink(q->name);
+    return SRSRAN_ERROR;
+  }
+
+  void* region = mmap(NULL, q->region_sz, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (region == MAP_FAILED) {
+    fprintf(stderr, "[zmq] Error: mapping shared memory %s: %s\n", q->name, strerror(errno));
+    shm_unlink(q->name);
+    return SRSRAN_ERROR;
+  }
+  q->region = region;
+
+  // The new region is zero filled, so the indexes start at 0
+  rf_zmq_shm_hdr_t* hdr = shm_hdr(q);
+  hdr->nof_blocks       = ZMQ_SHM_NOF_BLOCKS;
+  hdr->block_size       = ZMQ_SHM_BLOCK_SIZE;
+  hdr->sc16             = sc16 ? 1 : 0;
+  atomic_store_explicit(&hdr->magic, ZMQ_SHM_MAGIC, memory_order_release);
+
+  return SRSRAN_SUCCESS;
+}
+
+int rf_zmq_shm_write(rf_zmq_shm_t* q, uint64_t timestamp, const cf_t* buffer, uint32_t nsamples)
+{
+  if (q == NULL || !q->producer || q->region == NULL) {
+    return SRSRAN_ERROR;
+  }
+
+  rf_zmq_shm_hdr_t* hdr       = shm_hdr(q);
+  uint32_t          sample_sz = q->sc16 ? 2 * sizeof(int16_t) : sizeof(cf_t);
+  uint32_t          count     = 0;
+  uint32_t          nof_polls = 0;
+  uint64_t          start_ms  = 0;
+
+  while (count < nsamples) {
+    // Wait for a free block
+    uint64_t w = atomic_load_explicit(&hdr->write_idx, memory_order_relaxed);
+    if (w - atomic_load_explicit(&hdr->read_idx, memory_order_acquire) >= ZMQ_SHM_NOF_BLOCKS) {
+      if (shm_backoff(q, &nof_polls, &start_ms)) {
+        break;
+      }
+      continue;
+    }
+    nof_polls = 0;
+
+    // Zeros do not need any payload
+    rf_zmq_shm_block_t* block = shm_block(q, w);
+    uint32_t            n     = nsamples - count;
+    if (buffer != NULL) {
+      n = SRSRAN_MIN(n, ZMQ_SHM_BLOCK_SIZE / sample_sz);
+      if (q->sc16) {
+        srsran_vec_convert_fi((const float*)&buffer[count], INT16_MAX, (int16_t*)shm_payload(block), 2 * n);
+      } else {
+        srsran_vec_cf_copy((cf_t*)shm_payload(block), &buffer[count], n);
+      }
+    }
+    block->timestamp = timestamp + count;
+    block->nsamples  = n;
+    block->zeros     = (buffer == NULL);
+
+    atomic_store_explicit(&hdr->write_idx, w + 1, memory_order_release);
+    count += n;
+  }
+
+  return (count > 0 || nsamples == 0) ? (int)count : SRSRAN_ERROR_TIMEOUT;
+}
+
+int rf_zmq_shm_read(rf_zmq_shm_t* q, cf_t* buffer, uint32_t nsamples)
+{
+  if (q == NULL || q->producer) {
+    return SRSRAN_ERROR;
+  }
+
+  uint32_t count     = 0;
+  uint32_t nof_polls = 0;
+  uint64_t start_ms  = 0;
+
+  while (count < nsamples) {
+    if (q->region == NULL && !shm_attach(q)) {
+      if (shm_backoff(q, &nof_polls, &start_ms)) {
+        break;
+      }
+      continue;
+    }
+
+    // The closed flag is read before the index, so that no block published before closing is missed
+    rf_zmq_shm_hdr_t* hdr    = shm_hdr(q);
+    bool              closed = atomic_load_explicit(&hdr->closed, memory_order_acquire) != 0;
+    uint64_t          r      = atomic_load_explicit(&hdr->read_idx, memory_order_relaxed);
+    if (r == atomic_load_explicit(&hdr->write_idx, memory_order_acquire)) {
+      // Once empty, a closed or silent region is unmapped, in case the producer has been restarted with a new one
+      bool expired = shm_backoff(q, &nof_polls, &start_ms);
+      if (closed || expired) {
+        shm_detach(q);
+      }
+      if (expired) {
+        break;
+      }
+      continue;
+    }
+    nof_polls = 0;
+
+    rf_zmq_shm_block_t* block = shm_block(q, r);
+    if (!q->synced) {
+      q->next_ts = block->timestamp;
+      q->synced  = true;
+    }
+
+    // Fill the samples the producer skipped with zeros
+    uint64_t ts = block->timestamp + q->block_offset;
+    if (ts > q->next_ts) {
+      uint32_t n = (uint32_t)SRSRAN_MIN(ts - q->next_ts, nsamples - count);
+      if (buffer != NULL) {
+        srsran_vec_cf_zero(&buffer[count], n);
+      }
+      count += n;
+      q->next_ts += n;
+      continue;
+    }
+
+    // Drop the samples that overlap with the ones already read
+    uint32_t skip = (uint32_t)SRSRAN_MIN(q->next_ts - ts, block->nsamples - q->block_offset);
+    q->block_offset += skip;
+
+    uint32_t n = SRSRAN_MIN(block->nsamples - q->block_offset, nsamples - count);
+    if (buffer != NULL && n > 0) {
+      if (block->zeros) {
+        srsran_vec_cf_zero(&buffer[count], n);
+      } else if (q->sc16) {
+        const int16_t* src = (const int16_t*)shm_payload(block) + 2 * q->block_offset;
+        srsran_vec_convert_if(src, INT16_MAX, (float*)&buffer[count], 2 * n);
+      } else {
+        srsran_vec_cf_copy(&buffer[count], (const cf_t*)shm_payload(block) + q->block_offset, n);
+      }
+    }
+    count += n;
+    q->next_ts += n;
+    q->block_offset += n;
+
+    // Release the block once it has been fully read
+    if (q->block_offset == block->nsamples) {
+      q->block_offset = 0;
+      atomic_store_explicit(&hdr->read_idx, r + 1, memory_order_release);
+    }
+  }
+
+  return (count > 0 || nsamples == 0) ? (int)count : SRSRAN_ERROR_TIMEOUT;
+}
+
+bool rf_zmq_shm_has_data(rf_zmq_shm_t* q)
+{
+  if (q == NULL || q->producer || (q->region == NULL && !shm_attach(q))) {
+    return false;
+  }
+
+  rf_zmq_shm_hdr_t* hdr = shm_hdr(q);
+  return atomic_load_explicit(&hdr->read_idx, memory_order_relaxed) !=
+         atomic_load_explicit(&hdr->write_idx, memory_order_acquire);
+}
+
+void rf_zmq_shm_close(rf_zmq_shm_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  if (q->producer && q->region != NULL) {
+    atomic_store_explicit(&shm_hdr(q)->closed, 1, memory_order_release);
+    shm_detach(q);
+    shm_unlink(q->name);
+  }
+  shm_detach(q);
+}
@@ -0,0 +1,99 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        rf_zmq_shm.h
+ *
+ * Description: Shared memory transport of the ZMQ RF device, for eNB and UE
+ *              processes running on the same host. The transmitter creates a
+ *              POSIX shared memory region holding a single-producer
+ *              single-consumer ring of timestamped sample blocks, and the
+ *              receiver maps it. The samples are converted (sc16) or copied
+ *              (fc32) straight from the caller buffers into the ring and back,
+ *              without intermediate buffers, sockets or threads.
+ *              The transport is selected with a "shm://<name>" port, e.g.
+ *              tx_port=shm://dl0 on one side and rx_port=shm://dl0 on the other.
+ *****************************************************************************/
+
+#ifndef SRSRAN_RF_ZMQ_SHM_H
+#define SRSRAN_RF_ZMQ_SHM_H
+
+#include <srsran/config.h>
+#include <srsran/phy/common/phy_common.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ZMQ_SHM_PREFIX "shm://"
+#define ZMQ_SHM_NAME_LEN (64)
+#define ZMQ_SHM_NOF_BLOCKS (64)
+#define ZMQ_SHM_BLOCK_SIZE (65536) // payload bytes per block, i.e. 8192 fc32 or 16384 sc16 samples
+
+typedef struct {
+  char     name[ZMQ_SHM_NAME_LEN]; ///< POSIX shared memory object name
+  bool     producer;
+  bool     sc16;           ///< sample format in the ring, set by the producer
+  uint32_t timeout_ms;     ///< maximum time to wait for the peer on each read or write
+  void*    region;         ///< mapped region, NULL while the receiver is not attached
+  size_t   region_sz;
+  uint64_t next_ts;        ///< receiver: timestamp of the next sample to read
+  uint32_t block_offset;   ///< receiver: samples already read from the head block
+  bool     synced;         ///< receiver: next_ts has been taken from the first block
+} rf_zmq_shm_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Returns true if the port selects the shared memory transport
+SRSRAN_API bool rf_zmq_shm_is_port(const char* port);
+
+/**
+ * Opens the ring named by the port. The producer (transmitter) creates the region, replacing any stale one with the
+ * same name. The consumer (receiver) maps it on its first read, so both ends can be opened in any order
+ */
+SRSRAN_API int rf_zmq_shm_open(rf_zmq_shm_t* q, const char* port, bool producer, bool sc16, uint32_t timeout_ms);
+
+/**
+ * Producer side. Writes the samples in as many blocks as needed, waiting while the ring is full. A NULL buffer writes
+ * zeros, which take a single block without payload regardless of their number
+ * @param timestamp of the first sample, in samples at the base rate
+ * @return number of samples written, or SRSRAN_ERROR_TIMEOUT if the consumer did not free any block within the timeout
+ */
+SRSRAN_API int rf_zmq_shm_write(rf_zmq_shm_t* q, uint64_t timestamp, const cf_t* buffer, uint32_t nsamples);
+
+/**
+ * Consumer side. Reads up to nsamples, waiting until they are available. Gaps in the block timestamps are filled with
+ * zeros. A NULL buffer discards the samples
+ * @return number of samples read, or SRSRAN_ERROR_TIMEOUT if none was available within the timeout
+ */
+SRSRAN_API int rf_zmq_shm_read(rf_zmq_shm_t* q, cf_t* buffer, uint32_t nsamples);
+
+/// Consumer side. Returns true if there are samples to read, without waiting
+SRSRAN_API bool rf_zmq_shm_has_data(rf_zmq_shm_t* q);
+
+SRSRAN_API void rf_zmq_shm_close(rf_zmq_shm_t* q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRSRAN_RF_ZMQ_SHM_H
@@ -28,11 +28,14 @@
 #include <srsran/phy/common/phy_common.h>
 #include <srsran/phy/utils/vector.h>
 #include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
 #include <zmq.h>
 
 #define PRINT_SAMPLES 1
 #define COMPARE_BITS 0
 #define COMPARE_EPSILON (1e-6f)
+#define COMPARE_EPSILON_SC16 (1e-4f) // quantization of the sc16 transport
 #define NOF_RX_ANT 4
 #define NUM_SF (500)
 #define SF_LEN (1920)
@@ -45,6 +48,7 @@ static cf_t enb_rx_buffer[NOF_RX_ANT][RF_BUFFER_SIZE];
 
 static srsran_rf_t ue_radio, enb_radio;
 pthread_t          rx_thread;
+static bool        print_samples = PRINT_SAMPLES;
 
 void* ue_rx_thread_function(void* args)
 {
@@ -153,7 +157,7 @@ void enb_tx_function(const char* tx_args, bool timed_tx)
   srsran_rf_close(&enb_radio);
 }
 
-int run_test(const char* rx_args, const char* tx_args, bool timed_tx)
+int run_test(const char* rx_args, const char* tx_args, bool timed_tx, float epsilon)
 {
   int ret = SRSRAN_ERROR;
 
@@ -184,13 +188,13 @@ int run_test(const char* rx_args, const char* tx_args, bool timed_tx)
         sf_offet = (TX_OFFSET_MS - 1) * SF_LEN;
       }
 
-#if PRINT_SAMPLES
-      // print first 10 samples for each SF
-      printf("enb_tx_buffer sf%d:\n", i);
-      srsran_vec_fprint_c(stdout, &enb_tx_buffer[c][i * SF_LEN], 10);
-      printf("ue_rx_buffer sf%d:\n", i);
-      srsran_vec_fprint_c(stdout, &ue_rx_buffer[c][sf_offet + i * SF_LEN], 10);
-#endif
+      if (print_samples) {
+        // print first 10 samples for each SF
+        printf("enb_tx_buffer sf%d:\n", i);
+        srsran_vec_fprint_c(stdout, &enb_tx_buffer[c][i * SF_LEN], 10);
+        printf("ue_rx_buffer sf%d:\n", i);
+        srsran_vec_fprint_c(stdout, &ue_rx_buffer[c][sf_offet + i * SF_LEN], 10);
+      }
 
 #if COMPARE_BITS
       int d = memcmp(&ue_rx_buffer[sf_offet + i * SF_LEN], &enb_tx_buffer[i * SF_LEN], SF_LEN);
@@ -209,7 +213,7 @@ int run_test(const char* rx_args, const char* tx_args, bool timed_tx)
                          &ue_rx_buffer[c][sf_offet + i * SF_LEN],
                          SF_LEN);
       uint32_t max_ix = srsran_vec_max_abs_ci(&ue_rx_buffer[c][sf_offet + i * SF_LEN], SF_LEN);
-      if (cabsf(ue_rx_buffer[c][sf_offet + i * SF_LEN + max_ix]) > COMPARE_EPSILON) {
+      if (cabsf(ue_rx_buffer[c][sf_offet + i * SF_LEN + max_ix]) > epsilon) {
         fprintf(stderr, "data mismatch in subframe %d\n", i);
         goto exit;
       }
@@ -240,8 +244,92 @@ int param_test(const char* args_param, const int num_channels)
   return SRSRAN_SUCCESS;
 }
 
-int main()
+static double elapsed_s(clockid_t clock, const struct timespec* start)
+{
+  struct timespec now = {};
+  clock_gettime(clock, &now);
+  return (double)(now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+// Transfers NUM_SF subframes on every DL channel and reports the CPU time spent per transported sample. The receivers
+// are paced to real time, so the CPU time, rather than the wall time, gives the sample rate the transport can sustain
+int run_benchmark(const char* name, const char* rx_args, const char* tx_args, double base_srate, float epsilon)
+{
+  struct timespec wall_start = {}, cpu_start = {};
+  clock_gettime(CLOCK_MONOTONIC, &wall_start);
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_start);
+
+  if (run_test(rx_args, tx_args, false, epsilon) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "%s benchmark failed!\n", name);
+    return SRSRAN_ERROR;
+  }
+
+  double wall_s   = elapsed_s(CLOCK_MONOTONIC, &wall_start);
+  double cpu_s    = elapsed_s(CLOCK_PROCESS_CPUTIME_ID, &cpu_start);
+  double nsamples = (double)NUM_SF * SF_LEN * (base_srate / 1.92e6) * NOF_RX_ANT;
+
+  printf("%-10s %.1f Msps (%d channels) in %.2f s with %.2f s of CPU: %.2f ns/sample, %.1f Msps per core\n",
+         name,
+         nsamples / wall_s / 1e6,
+         NOF_RX_ANT,
+         wall_s,
+         cpu_s,
+         cpu_s * 1e9 / nsamples,
+         nsamples / cpu_s / 1e6);
+  return SRSRAN_SUCCESS;
+}
+
+// ZMQ over IPC against the shared memory transport, in both sample formats, at the 100 PRB base rate
+int benchmark()
+{
+  print_samples = false;
+
+  const char* ue_ipc  = "tx_port=ipc://bul0,tx_port=ipc://bul1,tx_port=ipc://bul2,tx_port=ipc://bul3,rx_port=ipc://"
+                        "bdl0,rx_port=ipc://bdl1,rx_port=ipc://bdl2,rx_port=ipc://bdl3,id=ue,base_srate=23.04e6";
+  const char* enb_ipc = "rx_port=ipc://bul0,rx_port=ipc://bul1,rx_port=ipc://bul2,rx_port=ipc://bul3,tx_port=ipc://"
+                        "bdl0,tx_port=ipc://bdl1,tx_port=ipc://bdl2,tx_port=ipc://bdl3,id=enb,base_srate=23.04e6";
+  const char* ue_shm  = "tx_port=shm://bul0,tx_port=shm://bul1,tx_port=shm://bul2,tx_port=shm://bul3,rx_port=shm://"
+                        "bdl0,rx_port=shm://bdl1,rx_port=shm://bdl2,rx_port=shm://bdl3,id=ue,base_srate=23.04e6";
+  const char* enb_shm = "rx_port=shm://bul0,rx_port=shm://bul1,rx_port=shm://bul2,rx_port=shm://bul3,tx_port=shm://"
+                        "bdl0,tx_port=shm://bdl1,tx_port=shm://bdl2,tx_port=shm://bdl3,id=enb,base_srate=23.04e6";
+
+  const char* names[]    = {"ipc fc32", "ipc sc16", "shm fc32", "shm sc16"};
+  const char* ue_args[]  = {ue_ipc, ue_ipc, ue_shm, ue_shm};
+  const char* enb_args[] = {enb_ipc, enb_ipc, enb_shm, enb_shm};
+  for (uint32_t i = 0; i < 4; i++) {
+    bool        sc16             = (i % 2 == 1);
+    const char* format_args      = sc16 ? ",tx_format=sc16,rx_format=sc16" : "";
+    char        rx[RF_PARAM_LEN] = {};
+    char        tx[RF_PARAM_LEN] = {};
+    snprintf(rx, RF_PARAM_LEN, "%s%s", ue_args[i], format_args);
+    snprintf(tx, RF_PARAM_LEN, "%s%s", enb_args[i], format_args);
+    if (run_benchmark(names[i], rx, tx, 23.04e6, sc16 ? COMPARE_EPSILON_SC16 : COMPARE_EPSILON) != SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+void usage(char* prog)
 {
+  printf("Usage: %s [-b]\n", prog);
+  printf("\t-b Run the transport throughput benchmark instead of the tests\n");
+}
+
+int main(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "b")) != -1) {
+    switch (opt) {
+      case 'b':
+        return benchmark();
+      default:
+        usage(argv[0]);
+        return SRSRAN_ERROR;
+    }
+  }
+
   //  // two Rx ports
   //  if (param_test("rx_port=ipc://dl0,rx_port1=ipc://dl1", 2)) {
   //    fprintf(stderr, "Param test failed!\n");
@@ -273,8 +361,10 @@ int main()
 
 #if NOF_RX_ANT == 1
   // single tx, single rx with continuous transmissions (no timed tx) using IPC transport
-  if (run_test("rx_port=ipc://link1,id=ue,base_srate=1.92e6", "tx_port=ipc://link1,id=enb,base_srate=1.92e6", false) !=
-      SRSRAN_SUCCESS) {
+  if (run_test("rx_port=ipc://link1,id=ue,base_srate=1.92e6",
+               "tx_port=ipc://link1,id=enb,base_srate=1.92e6",
+               false,
+               COMPARE_EPSILON) != SRSRAN_SUCCESS) {
     fprintf(stderr, "Single tx, single rx test failed!\n");
     return -1;
   }
@@ -287,7 +377,8 @@ int main()
                "rx_port=tcp://localhost:5554,rx_port=tcp://localhost:5556,rx_port=tcp://localhost:5558,rx_port=tcp://"
                "localhost:5560,tx_port=tcp://*:5555,tx_port=tcp://*:5557,tx_port=tcp://*:5559,tx_port=tcp://"
                "*:5561,id=enb,base_srate=1.92e6",
-               false) != SRSRAN_SUCCESS) {
+               false,
+               COMPARE_EPSILON) != SRSRAN_SUCCESS) {
     fprintf(stderr, "Multi TRx radio test failed!\n");
     return -1;
   }
@@ -298,7 +389,8 @@ int main()
                "rx_port=tcp://localhost:5554,rx_port=tcp://localhost:5556,rx_port=tcp://localhost:5558,rx_port=tcp://"
                "localhost:5560,tx_port=ipc://dl0,tx_port=ipc://dl1,tx_port=ipc://dl2,tx_port=ipc://"
                "dl3,id=enb,base_srate=1.92e6",
-               true) != SRSRAN_SUCCESS) {
+               true,
+               COMPARE_EPSILON) != SRSRAN_SUCCESS) {
     fprintf(stderr, "Multi TRx radio test with timed tx failed!\n");
     return -1;
   }
@@ -310,10 +402,33 @@ int main()
                "rx_port=tcp://localhost:5554,rx_port=tcp://localhost:5556,rx_port=tcp://localhost:5558,rx_port=tcp://"
                "localhost:5560,tx_port=ipc://dl0,tx_port=ipc://dl1,tx_port=ipc://dl2,tx_port=ipc://"
                "dl3,id=enb,base_srate=23.04e6",
-               true) != SRSRAN_SUCCESS) {
+               true,
+               COMPARE_EPSILON) != SRSRAN_SUCCESS) {
     fprintf(stderr, "Multi TRx radio test with timed tx and decimation failed!\n");
     return -1;
   }
 
+  // up to 4 trx radios with continous tx (timed tx) using shared memory for DL and UL, sc16 for the DL
+  if (run_test("tx_port=shm://ul0,tx_port=shm://ul1,tx_port=shm://ul2,tx_port=shm://ul3,rx_port=shm://"
+               "dl0,rx_port=shm://dl1,rx_port=shm://dl2,rx_port=shm://dl3,id=ue,base_srate=1.92e6",
+               "rx_port=shm://ul0,rx_port=shm://ul1,rx_port=shm://ul2,rx_port=shm://ul3,tx_port=shm://"
+               "dl0,tx_port=shm://dl1,tx_port=shm://dl2,tx_port=shm://dl3,id=enb,base_srate=1.92e6,tx_format=sc16",
+               true,
+               COMPARE_EPSILON_SC16) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Multi TRx radio test with timed tx over shared memory failed!\n");
+    return -1;
+  }
+
+  // up to 4 trx radios with continous tx (timed tx) using shared memory with decimation 23.04e6 <-> 1.92e6
+  if (run_test("tx_port=shm://ul0,tx_port=shm://ul1,tx_port=shm://ul2,tx_port=shm://ul3,rx_port=shm://"
+               "dl0,rx_port=shm://dl1,rx_port=shm://dl2,rx_port=shm://dl3,id=ue,base_srate=23.04e6",
+               "rx_port=shm://ul0,rx_port=shm://ul1,rx_port=shm://ul2,rx_port=shm://ul3,tx_port=shm://"
+               "dl0,tx_port=shm://dl1,tx_port=shm://dl2,tx_port=shm://dl3,id=enb,base_srate=23.04e6",
+               true,
+               COMPARE_EPSILON) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Multi TRx radio test with timed tx and decimation over shared memory failed!\n");
+    return -1;
+  }
+
   return SRSRAN_SUCCESS;
 }
@@ -191,6 +191,60 @@ int srsran_sss_m0m1_partial(srsran_sss_t* q,
   return ret;
 }
 
+/* Full correlation SSS estimation of every repetition of a PSS found at pss_idx modulo period (FDD).
+ * Returns the N_id_1 of the strongest SSS over the threshold
+ */
+int srsran_sss_find_periodic(srsran_sss_t* q,
+                             const cf_t*   input,
+                             uint32_t      nof_samples,
+                             uint32_t      pss_idx,
+                             uint32_t      period,
+                             srsran_cp_t   cp,
+                             uint32_t*     sf_idx,
+                             float*        corr,
+                             uint32_t*     nof_detected)
+{
+  if (q == NULL || input == NULL || period == 0) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  // The SSS is in the symbol before the PSS, and both have the CP of a symbol other than the first of the slot
+  uint32_t sss_offset              = SRSRAN_SYMBOL_SZ(q->fft_size, cp);
+  uint32_t count[SRSRAN_NOF_NID_1] = {};
+  float    max_corr                = 0.0f;
+  int      ret                     = SRSRAN_ERROR;
+
+  for (uint32_t idx = pss_idx % period; idx + q->fft_size <= nof_samples; idx += period) {
+    if (idx < sss_offset) {
+      continue;
+    }
+
+    uint32_t m0 = 0, m1 = 0;
+    float    m0_value = 0.0f, m1_value = 0.0f;
+    srsran_sss_m0m1_partial(q, &input[idx - sss_offset], 1, NULL, &m0, &m0_value, &m1, &m1_value);
+
+    int N_id_1 = srsran_sss_N_id_1(q, m0, m1, m0_value + m1_value);
+    if (N_id_1 >= 0 && N_id_1 < SRSRAN_NOF_NID_1) {
+      count[N_id_1]++;
+      if (m0_value + m1_value > max_corr) {
+        max_corr = m0_value + m1_value;
+        ret      = N_id_1;
+        if (sf_idx) {
+          *sf_idx = srsran_sss_subframe(m0, m1);
+        }
+      }
+    }
+  }
+
+  if (corr) {
+    *corr = max_corr;
+  }
+  if (nof_detected) {
+    *nof_detected = (ret >= 0) ? count[ret] : 0;
+  }
+  return ret;
+}
+
 void convert_tables(srsran_sss_fc_tables_t* fc_tables, srsran_sss_tables_t* in)
 {
   uint32_t i, j;
@@ -0,0 +1,266 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/sync/pss_corr.h"
+#include "srsran/phy/sync/pss.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+#include <stdlib.h>
+#include <strings.h>
+
+// With blocks of 4 sequence lengths, 3/4 of each IFFT output are valid correlation lags
+static uint32_t pss_corr_fft_size(uint32_t seq_len)
+{
+  uint32_t fft_size = 64;
+  while (fft_size < 4 * seq_len) {
+    fft_size <<= 1U;
+  }
+  return fft_size;
+}
+
+int srsran_pss_corr_init(srsran_pss_corr_t* q, uint32_t max_seq_len, uint32_t max_period)
+{
+  if (q == NULL || max_seq_len == 0) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+  bzero(q, sizeof(srsran_pss_corr_t));
+
+  q->fft_size    = pss_corr_fft_size(max_seq_len);
+  q->max_seq_len = max_seq_len;
+  q->max_period  = max_period;
+
+  for (uint32_t i = 0; i < SRSRAN_PSS_CORR_MAX_SEQ; i++) {
+    q->seq_fft[i] = srsran_vec_cf_malloc(q->fft_size);
+    if (q->seq_fft[i] == NULL) {
+      return SRSRAN_ERROR;
+    }
+    if (max_period > 0) {
+      q->acc[i] = srsran_vec_f_malloc(max_period);
+      if (q->acc[i] == NULL) {
+        return SRSRAN_ERROR;
+      }
+    }
+  }
+  q->in_time  = srsran_vec_cf_malloc(q->fft_size);
+  q->in_freq  = srsran_vec_cf_malloc(q->fft_size);
+  q->out_freq = srsran_vec_cf_malloc(q->fft_size);
+  q->out_time = srsran_vec_cf_malloc(q->fft_size);
+  q->out_pwr  = srsran_vec_f_malloc(q->fft_size);
+  if (!q->in_time || !q->in_freq || !q->out_freq || !q->out_time || !q->out_pwr) {
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_dft_plan(&q->fft, q->fft_size, SRSRAN_DFT_FORWARD, SRSRAN_DFT_COMPLEX)) {
+    ERROR("Error initiating PSS correlation FFT");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_dft_plan(&q->ifft, q->fft_size, SRSRAN_DFT_BACKWARD, SRSRAN_DFT_COMPLEX)) {
+    ERROR("Error initiating PSS correlation IFFT");
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_pss_corr_init_lte(srsran_pss_corr_t* q, uint32_t fft_size, uint32_t max_period)
+{
+  if (srsran_pss_corr_init(q, fft_size, max_period) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+  return srsran_pss_corr_set_lte(q, fft_size);
+}
+
+int srsran_pss_corr_set_lte(srsran_pss_corr_t* q, uint32_t fft_size)
+{
+  if (q == NULL || fft_size > q->max_seq_len) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  cf_t  pss_freq[SRSRAN_PSS_LEN];
+  cf_t* pss_time = srsran_vec_cf_malloc(fft_size);
+  if (pss_time == NULL) {
+    return SRSRAN_ERROR;
+  }
+  int ret = SRSRAN_SUCCESS;
+  for (uint32_t N_id_2 = 0; N_id_2 < SRSRAN_NOF_NID_2 && ret == SRSRAN_SUCCESS; N_id_2++) {
+    ret = srsran_pss_init_N_id_2(pss_freq, pss_time, N_id_2, fft_size, 0);
+    if (ret == SRSRAN_SUCCESS) {
+      // The PSS object keeps the conjugated sequence, for the convolution
+      srsran_vec_conj_cc(pss_time, pss_time, fft_size);
+      ret = srsran_pss_corr_set_seq(q, N_id_2, pss_time, fft_size);
+    }
+  }
+  free(pss_time);
+  return ret;
+}
+
+int srsran_pss_corr_set_seq(srsran_pss_corr_t* q, uint32_t idx, const cf_t* seq, uint32_t seq_len)
+{
+  if (q == NULL || seq == NULL || idx >= SRSRAN_PSS_CORR_MAX_SEQ || seq_len == 0 || seq_len > q->max_seq_len) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  // The first sequence sets the length of all of them, and the size of the blocks
+  if (idx == 0) {
+    uint32_t fft_size = pss_corr_fft_size(seq_len);
+    if (fft_size != q->fft_size) {
+      if (srsran_dft_replan(&q->fft, fft_size) || srsran_dft_replan(&q->ifft, fft_size)) {
+        ERROR("Error replanning PSS correlation DFT for %d samples", fft_size);
+        return SRSRAN_ERROR;
+      }
+      q->fft_size = fft_size;
+    }
+    q->seq_len = seq_len;
+    q->nof_seq = 1;
+  } else if (seq_len != q->seq_len) {
+    ERROR("The length of PSS sequence %d (%d) differs from the first one (%d)", idx, seq_len, q->seq_len);
+    return SRSRAN_ERROR;
+  }
+
+  srsran_vec_cf_copy(q->in_time, seq, seq_len);
+  srsran_vec_cf_zero(&q->in_time[seq_len], q->fft_size - seq_len);
+  srsran_dft_run_c(&q->fft, q->in_time, q->seq_fft[idx]);
+  srsran_vec_conj_cc(q->seq_fft[idx], q->seq_fft[idx], q->fft_size);
+  q->seq_energy[idx] = srsran_vec_avg_power_cf(seq, seq_len) * seq_len;
+
+  q->nof_seq = SRSRAN_MAX(q->nof_seq, idx + 1);
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_pss_corr_set_period(srsran_pss_corr_t* q, uint32_t period)
+{
+  if (q == NULL || period > q->max_period) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+  q->period = period;
+  return SRSRAN_SUCCESS;
+}
+
+// Adds the correlation power of the lags starting at t to the accumulator, wrapping around the period
+static void pss_corr_fold(srsran_pss_corr_t* q, float* acc, uint32_t t, uint32_t nof_lags)
+{
+  uint32_t pos = t % q->period;
+  for (uint32_t k = 0; k < nof_lags;) {
+    uint32_t n = SRSRAN_MIN(nof_lags - k, q->period - pos);
+    srsran_vec_sum_fff(&acc[pos], &q->out_pwr[k], &acc[pos], n);
+    k += n;
+    pos = 0;
+  }
+}
+
+int srsran_pss_corr_run(srsran_pss_corr_t* q, const cf_t* input, uint32_t nof_samples, srsran_pss_corr_peak_t* peaks)
+{
+  if (q == NULL || input == NULL || peaks == NULL || q->nof_seq == 0 || nof_samples < q->seq_len) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  // Overlap-save: each block of fft_size samples provides fft_size - seq_len + 1 lags
+  uint32_t nof_lags  = nof_samples - q->seq_len + 1;
+  uint32_t block_len = q->fft_size - q->seq_len + 1;
+  float    sum[SRSRAN_PSS_CORR_MAX_SEQ] = {};
+
+  for (uint32_t i = 0; i < q->nof_seq; i++) {
+    peaks[i].idx   = 0;
+    peaks[i].value = 0.0f;
+    if (q->period > 0) {
+      srsran_vec_f_zero(q->acc[i], q->period);
+    }
+  }
+
+  for (uint32_t t = 0; t < nof_lags; t += block_len) {
+    uint32_t n_in  = SRSRAN_MIN(q->fft_size, nof_samples - t);
+    uint32_t n_out = SRSRAN_MIN(block_len, nof_lags - t);
+    srsran_vec_cf_copy(q->in_time, &input[t], n_in);
+    srsran_vec_cf_zero(&q->in_time[n_in], q->fft_size - n_in);
+    srsran_dft_run_c(&q->fft, q->in_time, q->in_freq);
+
+    for (uint32_t i = 0; i < q->nof_seq; i++) {
+      srsran_vec_prod_ccc(q->in_freq, q->seq_fft[i], q->out_freq, q->fft_size);
+      srsran_dft_run_c(&q->ifft, q->out_freq, q->out_time);
+      srsran_vec_abs_square_cf(q->out_time, q->out_pwr, n_out);
+
+      if (q->period > 0) {
+        pss_corr_fold(q, q->acc[i], t, n_out);
+      } else {
+        uint32_t k = srsran_vec_max_fi(q->out_pwr, n_out);
+        if (q->out_pwr[k] > peaks[i].value) {
+          peaks[i].value = q->out_pwr[k];
+          peaks[i].idx   = t + k;
+        }
+        sum[i] += srsran_vec_acc_ff(q->out_pwr, n_out);
+      }
+    }
+  }
+
+  // Neither the FFT nor the IFFT are normalised
+  float    scale  = 1.0f / ((float)q->fft_size * (float)q->fft_size);
+  uint32_t nof_av = q->period > 0 ? SRSRAN_MIN(q->period, nof_lags) : nof_lags;
+  for (uint32_t i = 0; i < q->nof_seq; i++) {
+    peaks[i].corr = 0.0f;
+    if (q->period > 0) {
+      peaks[i].idx   = srsran_vec_max_fi(q->acc[i], nof_av);
+      peaks[i].value = q->acc[i][peaks[i].idx];
+      sum[i]         = srsran_vec_acc_ff(q->acc[i], nof_av);
+    } else {
+      float energy = srsran_vec_avg_power_cf(&input[peaks[i].idx], q->seq_len) * q->seq_len * q->seq_energy[i];
+      if (isnormal(energy)) {
+        peaks[i].corr = peaks[i].value * scale / energy;
+      }
+    }
+    peaks[i].value *= scale;
+    peaks[i].par = isnormal(sum[i]) ? peaks[i].value / (sum[i] * scale / nof_av) : 0.0f;
+  }
+
+  return (int)q->nof_seq;
+}
+
+void srsran_pss_corr_free(srsran_pss_corr_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+  for (uint32_t i = 0; i < SRSRAN_PSS_CORR_MAX_SEQ; i++) {
+    if (q->seq_fft[i]) {
+      free(q->seq_fft[i]);
+    }
+    if (q->acc[i]) {
+      free(q->acc[i]);
+    }
+  }
+  if (q->in_time) {
+    free(q->in_time);
+  }
+  if (q->in_freq) {
+    free(q->in_freq);
+  }
+  if (q->out_freq) {
+    free(q->out_freq);
+  }
+  if (q->out_time) {
+    free(q->out_time);
+  }
+  if (q->out_pwr) {
+    free(q->out_pwr);
+  }
+  srsran_dft_plan_free(&q->fft);
+  srsran_dft_plan_free(&q->ifft);
+  bzero(q, sizeof(srsran_pss_corr_t));
+}
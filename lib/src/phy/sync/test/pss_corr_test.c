@@ -0,0 +1,255 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srsran/common/test_common.h"
+#include "srsran/srsran.h"
+
+static uint32_t nof_prb   = 6;
+static uint32_t nof_sf    = 20;
+static float    snr_db    = -3.0f;
+static uint32_t N_id_2    = 1;
+static uint32_t offset    = 1234;
+static uint32_t nof_reps  = 0;
+static uint32_t fft_size  = 0;
+static uint32_t sf_len    = 0;
+static uint32_t period_5m = 0;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [pnsiob]\n", prog);
+  printf("\t-p nof_prb [Default %d]\n", nof_prb);
+  printf("\t-n number of subframes [Default %d]\n", nof_sf);
+  printf("\t-s SNR in dB [Default %.1f]\n", snr_db);
+  printf("\t-i N_id_2 [Default %d]\n", N_id_2);
+  printf("\t-o offset of the first PSS [Default %d]\n", offset);
+  printf("\t-b number of benchmark repetitions [Default %d]\n", nof_reps);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "pnsiob")) != -1) {
+    switch (opt) {
+      case 'p':
+        nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'n':
+        nof_sf = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        snr_db = strtof(argv[optind], NULL);
+        break;
+      case 'i':
+        N_id_2 = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'o':
+        offset = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'b':
+        nof_reps = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Puts the PSS of N_id_2 every 5 ms from the offset, with unit power, and adds noise
+static void generate_signal(cf_t* signal, uint32_t nof_samples, srsran_channel_awgn_t* awgn)
+{
+  cf_t  pss_freq[SRSRAN_PSS_LEN];
+  cf_t* pss_time = srsran_vec_cf_malloc(fft_size);
+  srsran_pss_init_N_id_2(pss_freq, pss_time, N_id_2, fft_size, 0);
+  srsran_vec_conj_cc(pss_time, pss_time, fft_size);
+  srsran_vec_sc_prod_cfc(pss_time, 1.0f / sqrtf(srsran_vec_avg_power_cf(pss_time, fft_size)), pss_time, fft_size);
+
+  srsran_vec_cf_zero(signal, nof_samples);
+  for (uint32_t t = offset; t + fft_size <= nof_samples; t += period_5m) {
+    srsran_vec_cf_copy(&signal[t], pss_time, fft_size);
+  }
+  srsran_channel_awgn_set_n0(awgn, -snr_db);
+  srsran_channel_awgn_run_c(awgn, signal, signal, nof_samples);
+  free(pss_time);
+}
+
+// The overlap-save correlation must match the direct one, lag by lag
+static int test_direct(srsran_pss_corr_t* q, const cf_t* signal, uint32_t nof_samples)
+{
+  srsran_pss_corr_peak_t peaks[SRSRAN_PSS_CORR_MAX_SEQ] = {};
+  TESTASSERT(srsran_pss_corr_set_period(q, 0) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_pss_corr_run(q, signal, nof_samples, peaks) == SRSRAN_NOF_NID_2);
+
+  cf_t  pss_freq[SRSRAN_PSS_LEN];
+  cf_t* pss_time = srsran_vec_cf_malloc(fft_size);
+  for (uint32_t i = 0; i < SRSRAN_NOF_NID_2; i++) {
+    srsran_pss_init_N_id_2(pss_freq, pss_time, i, fft_size, 0);
+    srsran_vec_conj_cc(pss_time, pss_time, fft_size);
+
+    float    max_pwr = 0.0f;
+    uint32_t max_idx = 0;
+    for (uint32_t t = 0; t + fft_size <= nof_samples; t++) {
+      cf_t  c   = srsran_vec_dot_prod_conj_ccc(&signal[t], pss_time, fft_size);
+      float pwr = __real__ c * __real__ c + __imag__ c * __imag__ c;
+      if (pwr > max_pwr) {
+        max_pwr = pwr;
+        max_idx = t;
+      }
+    }
+    INFO("N_id_2=%d: peak %d/%d, power %e/%e, corr=%.3f, par=%.1f",
+         i,
+         peaks[i].idx,
+         max_idx,
+         peaks[i].value,
+         max_pwr,
+         peaks[i].corr,
+         peaks[i].par);
+    TESTASSERT(peaks[i].idx == max_idx);
+    TESTASSERT(fabsf(peaks[i].value - max_pwr) < 1e-3f * max_pwr);
+  }
+  free(pss_time);
+
+  TESTASSERT(peaks[N_id_2].idx % period_5m == offset % period_5m);
+  return SRSRAN_SUCCESS;
+}
+
+// Accumulating over the PSS period, the transmitted root stands out of the noise and of the other roots, which only
+// see its cross-correlation. Without PSS, no root stands out
+static int test_period(srsran_pss_corr_t* q, const cf_t* signal, uint32_t nof_samples, srsran_channel_awgn_t* awgn)
+{
+  srsran_pss_corr_peak_t peaks[SRSRAN_PSS_CORR_MAX_SEQ] = {};
+  TESTASSERT(srsran_pss_corr_set_period(q, period_5m) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_pss_corr_run(q, signal, nof_samples, peaks) == SRSRAN_NOF_NID_2);
+
+  for (uint32_t i = 0; i < SRSRAN_NOF_NID_2; i++) {
+    printf("N_id_2=%d: peak=%d, par=%.1f\n", i, peaks[i].idx, peaks[i].par);
+    TESTASSERT(peaks[i].par <= peaks[N_id_2].par);
+  }
+  TESTASSERT(peaks[N_id_2].idx == offset % period_5m);
+  TESTASSERT(peaks[N_id_2].par > 10.0f);
+
+  cf_t* noise = srsran_vec_cf_malloc(nof_samples);
+  srsran_vec_cf_zero(noise, nof_samples);
+  srsran_channel_awgn_run_c(awgn, noise, noise, nof_samples);
+  TESTASSERT(srsran_pss_corr_run(q, noise, nof_samples, peaks) == SRSRAN_NOF_NID_2);
+  free(noise);
+  for (uint32_t i = 0; i < SRSRAN_NOF_NID_2; i++) {
+    INFO("Noise N_id_2=%d: par=%.1f", i, peaks[i].par);
+    TESTASSERT(peaks[i].par < 8.0f);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+// Time to search the three roots with the PSS object, one 5 ms window and root at a time, and with the correlator
+static void benchmark(srsran_pss_corr_t* q, const cf_t* signal, uint32_t nof_samples)
+{
+  srsran_pss_t pss = {};
+  if (srsran_pss_init_fft(&pss, period_5m, fft_size)) {
+    ERROR("Error initiating PSS");
+    return;
+  }
+
+  struct timeval t[3];
+  float          peak_value = 0.0f;
+  gettimeofday(&t[1], NULL);
+  for (uint32_t r = 0; r < nof_reps; r++) {
+    for (uint32_t i = 0; i < SRSRAN_NOF_NID_2; i++) {
+      srsran_pss_set_N_id_2(&pss, i);
+      srsran_pss_reset(&pss);
+      for (uint32_t w = 0; w + period_5m <= nof_samples; w += period_5m) {
+        srsran_pss_find_pss(&pss, &signal[w], &peak_value);
+      }
+    }
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  double pss_us = (t[0].tv_sec * 1e6 + t[0].tv_usec) / nof_reps;
+
+  srsran_pss_corr_peak_t peaks[SRSRAN_PSS_CORR_MAX_SEQ] = {};
+  srsran_pss_corr_set_period(q, period_5m);
+  gettimeofday(&t[1], NULL);
+  for (uint32_t r = 0; r < nof_reps; r++) {
+    srsran_pss_corr_run(q, signal, nof_samples, peaks);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  double corr_us = (t[0].tv_sec * 1e6 + t[0].tv_usec) / nof_reps;
+
+  printf("Search of %d ms with %d PRB: %.1f us with srsran_pss_t, %.1f us with srsran_pss_corr_t (FFT size %d)\n",
+         nof_sf,
+         nof_prb,
+         pss_us,
+         corr_us,
+         q->fft_size);
+  srsran_pss_free(&pss);
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  int symbol_sz = srsran_symbol_sz(nof_prb);
+  if (symbol_sz < 0 || nof_sf < 5) {
+    ERROR("Invalid nof_prb=%d or number of subframes %d", nof_prb, nof_sf);
+    return SRSRAN_ERROR;
+  }
+  fft_size              = (uint32_t)symbol_sz;
+  sf_len                = SRSRAN_SF_LEN(fft_size);
+  period_5m             = 5 * sf_len;
+  uint32_t nof_samples  = nof_sf * sf_len;
+  cf_t*    signal       = srsran_vec_cf_malloc(nof_samples);
+  srsran_channel_awgn_t awgn = {};
+  srsran_pss_corr_t     q    = {};
+  TESTASSERT(signal != NULL);
+  TESTASSERT(srsran_channel_awgn_init(&awgn, 1234) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_pss_corr_init_lte(&q, fft_size, period_5m) == SRSRAN_SUCCESS);
+
+  // Changing the sequences to a smaller symbol size and back replans the blocks
+  uint32_t block_fft_size = q.fft_size;
+  if (fft_size > 128) {
+    TESTASSERT(srsran_pss_corr_set_lte(&q, 128) == SRSRAN_SUCCESS);
+    TESTASSERT(q.fft_size < block_fft_size);
+    TESTASSERT(srsran_pss_corr_set_lte(&q, fft_size) == SRSRAN_SUCCESS);
+  }
+  TESTASSERT(q.fft_size == block_fft_size);
+  TESTASSERT(srsran_pss_corr_set_lte(&q, 2 * fft_size) == SRSRAN_ERROR_INVALID_INPUTS);
+
+  offset %= period_5m;
+  generate_signal(signal, nof_samples, &awgn);
+  TESTASSERT(test_direct(&q, signal, nof_samples) == SRSRAN_SUCCESS);
+  TESTASSERT(test_period(&q, signal, nof_samples, &awgn) == SRSRAN_SUCCESS);
+
+  if (nof_reps > 0) {
+    benchmark(&q, signal, nof_samples);
+  }
+
+  srsran_pss_corr_free(&q);
+  srsran_channel_awgn_free(&awgn);
+  free(signal);
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
@@ -423,6 +423,11 @@ static int dci_blind_search(srsran_ue_dl_t*     q,
 {
   uint32_t nof_dci = 0;
   if (rnti) {
+    // Try the candidates from the highest LLR energy, so that a DCI found early excludes the overlapping candidates.
+    // Candidates below the noise threshold are not decoded and the messages decoded in a location are reused by the
+    // other formats and RNTIs with the same size
+    search_space->nof_locations =
+        srsran_pdcch_rank_locations(&q->pdcch, sf, search_space->loc, search_space->nof_locations);
     for (int l = 0; l < search_space->nof_locations; l++) {
       if (nof_dci >= SRSRAN_MAX_DCI_MSG) {
         ERROR("Can't store more DCIs in buffer");
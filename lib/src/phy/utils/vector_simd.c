@@ -407,26 +407,26 @@ void srsran_vec_convert_if_simd(const int16_t* x, float* z, const float scale, c
   int         i    = 0;
   const float gain = 1.0f / scale;
 
-#ifdef LV_HAVE_SSE
-  __m128 s = _mm_set1_ps(gain);
-  if (SRSRAN_IS_ALIGNED(z)) {
-    for (; i < len - 3; i += 4) {
-      __m64* ptr = (__m64*)&x[i];
-      __m128 fl  = _mm_cvtpi16_ps(*ptr);
-      __m128 v   = _mm_mul_ps(fl, s);
+#if SRSRAN_SIMD_F_SIZE && SRSRAN_SIMD_S_SIZE
+  simd_f_t s = srsran_simd_f_set1(gain);
+  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(z)) {
+    for (; i < len - SRSRAN_SIMD_S_SIZE + 1; i += SRSRAN_SIMD_S_SIZE) {
+      simd_f_t a, b;
+      srsran_simd_convert_s_2f(srsran_simd_s_load(&x[i]), &a, &b);
 
-      _mm_store_ps(&z[i], v);
+      srsran_simd_f_store(&z[i], srsran_simd_f_mul(a, s));
+      srsran_simd_f_store(&z[i + SRSRAN_SIMD_F_SIZE], srsran_simd_f_mul(b, s));
     }
   } else {
-    for (; i < len - 3; i += 4) {
-      __m64* ptr = (__m64*)&x[i];
-      __m128 fl  = _mm_cvtpi16_ps(*ptr);
-      __m128 v   = _mm_mul_ps(fl, s);
+    for (; i < len - SRSRAN_SIMD_S_SIZE + 1; i += SRSRAN_SIMD_S_SIZE) {
+      simd_f_t a, b;
+      srsran_simd_convert_s_2f(srsran_simd_s_loadu(&x[i]), &a, &b);
 
-      _mm_storeu_ps(&z[i], v);
+      srsran_simd_f_storeu(&z[i], srsran_simd_f_mul(a, s));
+      srsran_simd_f_storeu(&z[i + SRSRAN_SIMD_F_SIZE], srsran_simd_f_mul(b, s));
     }
   }
-#endif /* LV_HAVE_SSE */
+#endif /* SRSRAN_SIMD_F_SIZE && SRSRAN_SIMD_S_SIZE */
 
   for (; i < len; i++) {
     z[i] = ((float)x[i]) * gain;
@@ -588,6 +588,51 @@ void srsran_vec_convert_fb_simd(const float* x, int8_t* z, const float scale, co
   }
 }
 
+void srsran_vec_convert_bf_simd(const int8_t* x, float* z, const float scale, const int len)
+{
+  int         i    = 0;
+  const float gain = 1.0f / scale;
+
+#ifdef LV_HAVE_AVX2
+  __m256 s = _mm256_set1_ps(gain);
+  for (; i < len - 32 + 1; i += 32) {
+    for (int j = 0; j < 32; j += 8) {
+      __m256i i32 = _mm256_cvtepi8_epi32(_mm_loadl_epi64((__m128i*)&x[i + j]));
+      _mm256_storeu_ps(&z[i + j], _mm256_mul_ps(_mm256_cvtepi32_ps(i32), s));
+    }
+  }
+#elif defined(LV_HAVE_SSE)
+  // Sign extension by unpacking every byte with itself and shifting it down
+  __m128 s = _mm_set1_ps(gain);
+  for (; i < len - 16 + 1; i += 16) {
+    __m128i i8  = _mm_loadu_si128((__m128i*)&x[i]);
+    __m128i lo  = _mm_srai_epi16(_mm_unpacklo_epi8(i8, i8), 8);
+    __m128i hi  = _mm_srai_epi16(_mm_unpackhi_epi8(i8, i8), 8);
+    __m128i a32 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16);
+    __m128i b32 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16);
+    __m128i c32 = _mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16);
+    __m128i d32 = _mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16);
+
+    _mm_storeu_ps(&z[i], _mm_mul_ps(_mm_cvtepi32_ps(a32), s));
+    _mm_storeu_ps(&z[i + 1 * 4], _mm_mul_ps(_mm_cvtepi32_ps(b32), s));
+    _mm_storeu_ps(&z[i + 2 * 4], _mm_mul_ps(_mm_cvtepi32_ps(c32), s));
+    _mm_storeu_ps(&z[i + 3 * 4], _mm_mul_ps(_mm_cvtepi32_ps(d32), s));
+  }
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef HAVE_NEON
+  for (; i < len - 8 + 1; i += 8) {
+    int16x8_t i16 = vmovl_s8(vld1_s8(&x[i]));
+    vst1q_f32(&z[i], vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(i16))), gain));
+    vst1q_f32(&z[i + 4], vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(i16))), gain));
+  }
+#endif /* HAVE_NEON */
+
+  for (; i < len; i++) {
+    z[i] = ((float)x[i]) * gain;
+  }
+}
+
 float srsran_vec_acc_ff_simd(const float* x, const int len)
 {
   int   i       = 0;
@@ -20,10 +20,12 @@
  */
 
 #include "srsran/radio/radio.h"
+#include "srsran/common/sim_clock.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/common/string_helpers.h"
 #include "srsran/config.h"
 #include "srsran/support/srsran_assert.h"
+#include <algorithm>
 #include <list>
 #include <string>
 #include <unistd.h>
@@ -47,6 +49,14 @@ radio::~radio()
   for (srsran_resampler_fft_t& q : decimators) {
     srsran_resampler_fft_free(&q);
   }
+
+  for (srsran_resample_poly_t& q : tx_resamplers) {
+    srsran_resample_poly_free(&q);
+  }
+
+  for (srsran_resample_poly_t& q : rx_resamplers) {
+    srsran_resample_poly_free(&q);
+  }
 }
 
 int radio::init(const rf_args_t& args, phy_interface_radio* phy_)
@@ -76,6 +86,14 @@ int radio::init(const rf_args_t& args, phy_interface_radio* phy_)
   nof_carriers = args.nof_carriers;
   fix_srate_hz = args.srate_hz;
 
+  // The FFT resampler needs an integer ratio between the fixed and the cell sampling rates, the polyphase one does not
+  if (args.resampler == "poly") {
+    poly_resampler = true;
+  } else if (not args.resampler.empty() && args.resampler != "fft") {
+    srsran::console("Error: Invalid resampler '%s' (fft or poly)\n", args.resampler.c_str());
+    return SRSRAN_ERROR;
+  }
+
   cur_tx_freqs.resize(nof_carriers);
   cur_rx_freqs.resize(nof_carriers);
 
@@ -103,6 +121,22 @@ int radio::init(const rf_args_t& args, phy_interface_radio* phy_)
   }
   nof_channels_x_dev = nof_channels / device_args_list.size();
 
+  // The virtual clock runs the RF device as fast as the samples are exchanged with the peer, and the upper layers on
+  // the time of the received samples
+  if (args.virtual_clock) {
+    if (args.device_name != "zmq" && args.device_name != "file") {
+      srsran::console("Error: The virtual clock is only supported by the zmq and file RF devices\n");
+      return SRSRAN_ERROR;
+    }
+    if (args.device_name == "zmq") {
+      for (std::string& dev_args : device_args_list) {
+        dev_args += ",virtual_clock=true";
+      }
+    }
+    virtual_clock = true;
+    sim_clock::enable_virtual_time();
+  }
+
   // Allocate RF devices
   rf_devices.resize(device_args_list.size());
   rf_info.resize(device_args_list.size());
@@ -238,6 +272,15 @@ void radio::stop()
       srsran_rf_stop_rx_stream(&rf_device);
     }
   }
+
+  if (radio_is_streaming && virtual_clock) {
+    std::chrono::duration<double> radio_time = sim_clock::now().time_since_epoch();
+    std::chrono::duration<double> wall_time  = std::chrono::steady_clock::now() - stream_start;
+    srsran::console("Virtual clock: %.1f s of radio time in %.1f s of wall time (x%.2f)\n",
+                    radio_time.count(),
+                    wall_time.count(),
+                    radio_time.count() / std::max(wall_time.count(), 1e-3));
+  }
   if (is_initialized) {
     for (srsran_rf_t& rf_device : rf_devices) {
       srsran_rf_close(&rf_device);
@@ -296,29 +339,38 @@ bool radio::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time
   // Extract decimation ratio. As the decimation may take some time to set a new ratio, deactivate the decimation and
   // keep receiving samples to avoid stalling the RX stream
   uint32_t ratio = 1; // No decimation by default
+  bool     poly  = false;
   if (decimator_busy) {
     lock.unlock();
+  } else if (poly_resampler) {
+    poly = rx_resamplers[0].filter != nullptr;
   } else if (decimators[0].ratio > 1) {
     ratio = decimators[0].ratio;
   }
 
-  // Calculate number of samples, considering the decimation ratio
-  uint32_t nof_samples = buffer.get_nof_samples() * ratio;
+  // Calculate number of samples, considering the decimation ratio or the state of the polyphase resampler
+  uint32_t nof_output  = buffer.get_nof_samples();
+  uint32_t nof_samples = poly ? srsran_resample_poly_nof_input(&rx_resamplers[0], nof_output) : nof_output * ratio;
 
   // Check decimation buffer protection
-  if (ratio > 1 && nof_samples > rx_buffer[0].size()) {
+  if ((ratio > 1 || poly) && nof_samples > rx_buffer[0].size()) {
     // This is a corner case that could happen during sample rate change transitions, as it does not have a negative
     // impact, log it as info.
     fmt::memory_buffer buff;
-    fmt::format_to(buff,
-                   "Rx number of samples ({}/{}) exceeds buffer size ({})",
-                   buffer.get_nof_samples(),
-                   buffer.get_nof_samples() * ratio,
-                   rx_buffer[0].size());
+    fmt::format_to(
+        buff, "Rx number of samples ({}/{}) exceeds buffer size ({})", nof_output, nof_samples, rx_buffer[0].size());
     logger.info("%s", to_c_str(buff));
 
     // Limit number of samples to receive
     nof_samples = rx_buffer[0].size();
+    if (poly) {
+      uint64_t nof_input = srsran_resample_poly_nof_input(&rx_resamplers[0], nof_output);
+      nof_output         = (uint32_t)(nof_output * nof_samples / nof_input);
+      while (srsran_resample_poly_nof_input(&rx_resamplers[0], nof_output) > rx_buffer[0].size()) {
+        nof_output--;
+      }
+      nof_samples = srsran_resample_poly_nof_input(&rx_resamplers[0], nof_output);
+    }
   }
 
   // Set new buffer size
@@ -327,7 +379,7 @@ bool radio::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time
   // If the interpolator have been set, interpolate
   for (uint32_t ch = 0; ch < nof_channels; ch++) {
     // Use rx buffer if decimator is required
-    buffer_rx.set(ch, ratio > 1 ? rx_buffer[ch].data() : buffer.get(ch));
+    buffer_rx.set(ch, ratio > 1 || poly ? rx_buffer[ch].data() : buffer.get(ch));
   }
 
   if (not radio_is_streaming) {
@@ -335,6 +387,7 @@ bool radio::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time
       srsran_rf_start_rx_stream(&rf_device, false);
     }
     radio_is_streaming = true;
+    stream_start       = std::chrono::steady_clock::now();
 
     // Flush buffers to compensate settling time
     if (rf_devices.size() > 1) {
@@ -348,6 +401,11 @@ bool radio::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time
     ret &= rx_dev(device_idx, buffer_rx, rxd_time.get_ptr(device_idx));
   }
 
+  if (virtual_clock && ret) {
+    const srsran_timestamp_t& ts = rxd_time.get(0);
+    sim_clock::advance_to(sim_clock::duration(ts.full_secs * 1000000 + (int64_t)(ts.frac_secs * 1e6)));
+  }
+
   // Perform decimation
   if (ratio > 1) {
     for (uint32_t ch = 0; ch < nof_channels; ch++) {
@@ -357,6 +415,13 @@ bool radio::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time
     }
   }
 
+  // Resample to the cell rate. The state of the resampler of every channel must advance, even if it is not used
+  if (poly) {
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      srsran_resample_poly_pull(&rx_resamplers[ch], buffer_rx.get(ch), buffer.get(ch), nof_output);
+    }
+  }
+
   return ret;
 }
 
@@ -422,10 +487,17 @@ bool radio::tx(rf_buffer_interface& buffer, const rf_timestamp_interface& tx_tim
   bool                         ret = true;
   std::unique_lock<std::mutex> lock(tx_mutex);
   uint32_t                     ratio = interpolators[0].ratio;
+  bool                         poly  = poly_resampler && tx_resamplers[0].filter != nullptr;
 
   // Get number of samples at the low rate
   uint32_t nof_samples = buffer.get_nof_samples();
 
+  // Same check for the polyphase resampler, which outputs at most one sample more than the ratio
+  if (poly && (size_t)ceil(nof_samples * tx_resamplers[0].rate) + 1 > tx_buffer[0].size()) {
+    logger.info("Tx number of samples (%d) exceeds buffer size (%zd)", nof_samples, tx_buffer[0].size());
+    nof_samples = (uint32_t)((tx_buffer[0].size() - 2) / tx_resamplers[0].rate);
+  }
+
   // Check that number of the interpolated samples does not exceed the buffer size
   if (ratio > 1 && (size_t)nof_samples * (size_t)ratio > tx_buffer[0].size()) {
     // This is a corner case that could happen during sample rate change transitions, as it does not have a negative
@@ -454,6 +526,13 @@ bool radio::tx(rf_buffer_interface& buffer, const rf_timestamp_interface& tx_tim
 
     // Set buffer size after applying the interpolation
     buffer.set_nof_samples(nof_samples * ratio);
+  } else if (poly) {
+    uint32_t nof_output = 0;
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      nof_output = srsran_resample_poly_run(&tx_resamplers[ch], buffer.get(ch), tx_buffer[ch].data(), nof_samples);
+      buffer.set(ch, tx_buffer[ch].data());
+    }
+    buffer.set_nof_samples(nof_output);
   }
 
   for (uint32_t device_idx = 0; device_idx < (uint32_t)rf_devices.size(); device_idx++) {
@@ -746,17 +825,29 @@ void radio::set_rx_srate(const double& srate)
       }
     }
 
-    // Assert ratio is integer
-    srsran_assert(((uint32_t)cur_rx_srate % (uint32_t)srate) == 0,
-                  "The sampling rate ratio is not integer (%.2f MHz / %.2f MHz = %.3f)",
-                  cur_rx_srate / 1e6,
-                  srate / 1e6,
-                  cur_rx_srate / srate);
-
-    // Update decimators
-    uint32_t ratio = (uint32_t)ceil(cur_rx_srate / srate);
-    for (uint32_t ch = 0; ch < nof_channels; ch++) {
-      srsran_resampler_fft_init(&decimators[ch], SRSRAN_RESAMPLER_MODE_DECIMATE, ratio);
+    if (poly_resampler) {
+      // Update polyphase resamplers, which are bypassed if the rates are equal
+      double rate = srate / cur_rx_srate;
+      for (uint32_t ch = 0; ch < nof_channels; ch++) {
+        if (srate == cur_rx_srate) {
+          srsran_resample_poly_free(&rx_resamplers[ch]);
+        } else if (srsran_resample_poly_init_arb(&rx_resamplers[ch], rate, SRSRAN_RESAMPLE_POLY_NOF_TAPS)) {
+          logger.error("Error initialising Rx resampler (%.2f MHz / %.2f MHz)", srate / 1e6, cur_rx_srate / 1e6);
+        }
+      }
+    } else {
+      // Assert ratio is integer
+      srsran_assert(((uint32_t)cur_rx_srate % (uint32_t)srate) == 0,
+                    "The sampling rate ratio is not integer (%.2f MHz / %.2f MHz = %.3f)",
+                    cur_rx_srate / 1e6,
+                    srate / 1e6,
+                    cur_rx_srate / srate);
+
+      // Update decimators
+      uint32_t ratio = (uint32_t)ceil(cur_rx_srate / srate);
+      for (uint32_t ch = 0; ch < nof_channels; ch++) {
+        srsran_resampler_fft_init(&decimators[ch], SRSRAN_RESAMPLER_MODE_DECIMATE, ratio);
+      }
     }
 
     decimator_busy = false;
@@ -1002,17 +1093,29 @@ void radio::set_tx_srate(const double& srate)
       }
     }
 
-    // Assert ratio is integer
-    srsran_assert(((uint32_t)cur_tx_srate % (uint32_t)srate) == 0,
-                  "The sampling rate ratio is not integer (%.2f MHz / %.2f MHz = %.3f)",
-                  cur_rx_srate / 1e6,
-                  srate / 1e6,
-                  cur_rx_srate / srate);
-
-    // Update interpolators
-    uint32_t ratio = (uint32_t)ceil(cur_tx_srate / srate);
-    for (uint32_t ch = 0; ch < nof_channels; ch++) {
-      srsran_resampler_fft_init(&interpolators[ch], SRSRAN_RESAMPLER_MODE_INTERPOLATE, ratio);
+    if (poly_resampler) {
+      // Update polyphase resamplers, which are bypassed if the rates are equal
+      double rate = cur_tx_srate / srate;
+      for (uint32_t ch = 0; ch < nof_channels; ch++) {
+        if (srate == cur_tx_srate) {
+          srsran_resample_poly_free(&tx_resamplers[ch]);
+        } else if (srsran_resample_poly_init_arb(&tx_resamplers[ch], rate, SRSRAN_RESAMPLE_POLY_NOF_TAPS)) {
+          logger.error("Error initialising Tx resampler (%.2f MHz / %.2f MHz)", cur_tx_srate / 1e6, srate / 1e6);
+        }
+      }
+    } else {
+      // Assert ratio is integer
+      srsran_assert(((uint32_t)cur_tx_srate % (uint32_t)srate) == 0,
+                    "The sampling rate ratio is not integer (%.2f MHz / %.2f MHz = %.3f)",
+                    cur_rx_srate / 1e6,
+                    srate / 1e6,
+                    cur_rx_srate / srate);
+
+      // Update interpolators
+      uint32_t ratio = (uint32_t)ceil(cur_tx_srate / srate);
+      for (uint32_t ch = 0; ch < nof_channels; ch++) {
+        srsran_resampler_fft_init(&interpolators[ch], SRSRAN_RESAMPLER_MODE_INTERPOLATE, ratio);
+      }
     }
   } else {
     for (srsran_rf_t& rf_device : rf_devices) {
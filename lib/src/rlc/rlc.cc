@@ -20,7 +20,6 @@
  */
 
 #include "srsran/rlc/rlc.h"
-#include "srsran/common/rwlock_guard.h"
 #include "srsran/rlc/rlc_am_base.h"
 #include "srsran/rlc/rlc_tm.h"
 #include "srsran/rlc/rlc_um_lte.h"
@@ -28,20 +27,25 @@
 
 namespace srsran {
 
-rlc::rlc(const char* logname) : logger(srslog::fetch_basic_logger(logname)), pool(byte_buffer_pool::get_instance())
-{
-  pthread_rwlock_init(&rwlock, NULL);
-}
+rlc::rlc(const char* logname) :
+  logger(srslog::fetch_basic_logger(logname)),
+  pool(byte_buffer_pool::get_instance()),
+  rlc_table(SRSRAN_N_RADIO_BEARERS),
+  rlc_table_mrb(SRSRAN_N_MCH_LCIDS)
+{}
 
 rlc::~rlc()
 {
   // destroy all remaining entities
-  {
-    srsran::rwlock_write_guard lock(rwlock);
-    rlc_array.clear();
-    rlc_array_mrb.clear();
+  for (auto& it : rlc_array) {
+    rlc_table.set(it.first, nullptr);
   }
-  pthread_rwlock_destroy(&rwlock);
+  for (auto& it : rlc_array_mrb) {
+    rlc_table_mrb.set(it.first, nullptr);
+  }
+  rcu_synchronize();
+  rlc_array.clear();
+  rlc_array_mrb.clear();
 }
 
 void rlc::init(srsue::pdcp_interface_rlc* pdcp_,
@@ -158,12 +162,17 @@ void rlc::reestablish(uint32_t lcid)
 // All LCIDs are removed, except SRB0
 void rlc::reset()
 {
-  {
-    rwlock_write_guard lock(rwlock);
-    rlc_array.clear();
-    // the multicast bearer (MRB) is not removed here because eMBMS services continue to be streamed in idle mode (3GPP
-    // TS 23.246 version 14.1.0 Release 14 section 8)
+  for (auto& it : rlc_array) {
+    park_bearer(it.first, it.second.get());
+    rlc_table.set(it.first, nullptr);
   }
+  rcu_synchronize();
+  for (auto& it : rlc_array) {
+    destroy_bearer(std::move(it.second));
+  }
+  rlc_array.clear();
+  // the multicast bearer (MRB) is not removed here because eMBMS services continue to be streamed in idle mode (3GPP
+  // TS 23.246 version 14.1.0 Release 14 section 8)
 
   // Add SRB0 again
   add_bearer(default_lcid, rlc_config_t());
@@ -244,23 +253,24 @@ bool rlc::sdu_queue_is_full(uint32_t lcid)
 }
 
 /*******************************************************************************
-  MAC interface (mostly called from PHY workers, lock needs to be hold)
+  MAC interface (mostly called from PHY workers, within a read-side critical section)
 *******************************************************************************/
 bool rlc::has_data_locked(const uint32_t lcid)
 {
-  rwlock_read_guard lock(rwlock);
+  rcu_read_guard rcu;
   return has_data(lcid);
 }
 
 void rlc::get_buffer_state(uint32_t lcid, uint32_t& tx_queue, uint32_t& prio_tx_queue)
 {
-  rwlock_read_guard lock(rwlock);
-  if (valid_lcid(lcid)) {
-    if (rlc_array.at(lcid)->is_suspended()) {
+  rcu_read_guard rcu;
+  rlc_common*    rb = get_bearer(lcid);
+  if (rb != nullptr) {
+    if (rb->is_suspended()) {
       tx_queue      = 0;
       prio_tx_queue = 0;
     } else {
-      rlc_array.at(lcid)->get_buffer_state(tx_queue, prio_tx_queue);
+      rb->get_buffer_state(tx_queue, prio_tx_queue);
     }
   }
 }
@@ -276,9 +286,10 @@ uint32_t rlc::get_total_mch_buffer_state(uint32_t lcid)
 {
   uint32_t ret = 0;
 
-  rwlock_read_guard lock(rwlock);
-  if (valid_lcid_mrb(lcid)) {
-    ret = rlc_array_mrb.at(lcid)->get_buffer_state();
+  rcu_read_guard rcu;
+  rlc_common*    rb = get_bearer_mrb(lcid);
+  if (rb != nullptr) {
+    ret = rb->get_buffer_state();
   }
 
   return ret;
@@ -288,9 +299,10 @@ uint32_t rlc::read_pdu(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes)
 {
   uint32_t ret = 0;
 
-  rwlock_read_guard lock(rwlock);
-  if (valid_lcid(lcid)) {
-    ret = rlc_array.at(lcid)->read_pdu(payload, nof_bytes);
+  rcu_read_guard rcu;
+  rlc_common*    rb = get_bearer(lcid);
+  if (rb != nullptr) {
+    ret = rb->read_pdu(payload, nof_bytes);
     update_bsr(lcid);
   } else {
     logger.warning("LCID %d doesn't exist.", lcid);
@@ -301,13 +313,72 @@ uint32_t rlc::read_pdu(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes)
   return ret;
 }
 
+uint32_t rlc::read_pdu_sg(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes, const_byte_span& body)
+{
+  uint32_t ret = 0;
+  body         = {};
+
+  rcu_read_guard rcu;
+  rlc_common*    rb = get_bearer(lcid);
+  if (rb != nullptr) {
+    ret = rb->read_pdu_sg(payload, nof_bytes, body);
+    update_bsr(lcid);
+  } else {
+    logger.warning("LCID %d doesn't exist.", lcid);
+  }
+
+  srsran_expect(ret <= nof_bytes, "Created too big RLC PDU (%d > %d)", ret, nof_bytes);
+
+  return ret;
+}
+
+// Returns false if the body was not lent by any entity of the LCID
+bool rlc::release_pdu_sg(uint32_t lcid, const_byte_span body)
+{
+  {
+    rcu_read_guard rcu;
+    rlc_common*    rb = get_bearer(lcid);
+    if (rb != nullptr and rb->release_pdu_sg(body)) {
+      return true;
+    }
+  }
+
+  // The PDU was lent by a deleted entity of the LCID
+  std::lock_guard<std::mutex> lock(parked_mutex);
+  for (auto it = parked_bearers.begin(); it != parked_bearers.end(); ++it) {
+    if (it->lcid == lcid and it->rb->release_pdu_sg(body)) {
+      if (it->owner != nullptr and not it->rb->has_lent_pdus()) {
+        parked_bearers.erase(it);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+bool rlc::has_lent_pdus()
+{
+  {
+    rcu_read_guard rcu;
+    for (uint32_t lcid = 0; lcid < SRSRAN_N_RADIO_BEARERS; ++lcid) {
+      rlc_common* rb = rlc_table.get(lcid);
+      if (rb != nullptr and rb->has_lent_pdus()) {
+        return true;
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lock(parked_mutex);
+  return not parked_bearers.empty();
+}
+
 uint32_t rlc::read_pdu_mch(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes)
 {
   uint32_t ret = 0;
 
-  rwlock_read_guard lock(rwlock);
-  if (valid_lcid_mrb(lcid)) {
-    ret = rlc_array_mrb.at(lcid)->read_pdu(payload, nof_bytes);
+  rcu_read_guard rcu;
+  rlc_common*    rb = get_bearer_mrb(lcid);
+  if (rb != nullptr) {
+    ret = rb->read_pdu(payload, nof_bytes);
     update_bsr_mch(lcid);
   } else {
     logger.warning("LCID %d doesn't exist.", lcid);
@@ -366,14 +437,14 @@ void rlc::write_pdu_mch(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes)
 }
 
 /*******************************************************************************
-  RRC interface (write-lock ONLY needs to be hold for all calls modifying the RLC array)
+  RRC interface (called from Stack thread, which is the only one modifying the RLC arrays)
 *******************************************************************************/
 bool rlc::is_suspended(const uint32_t lcid)
 {
-  bool ret = false;
-
-  if (valid_lcid(lcid)) {
-    ret = rlc_array.at(lcid)->is_suspended();
+  bool        ret = false;
+  rlc_common* rb  = get_bearer(lcid);
+  if (rb != nullptr) {
+    ret = rb->is_suspended();
   }
 
   return ret;
@@ -381,20 +452,19 @@ bool rlc::is_suspended(const uint32_t lcid)
 
 bool rlc::has_data(uint32_t lcid)
 {
-  bool has_data = false;
-
-  if (valid_lcid(lcid)) {
-    has_data = rlc_array.at(lcid)->has_data();
+  bool        has_data = false;
+  rlc_common* rb       = get_bearer(lcid);
+  if (rb != nullptr) {
+    has_data = rb->has_data();
   }
 
   return has_data;
 }
 
-// Methods modifying the RLC array need to acquire the write-lock
+// Methods modifying the RLC array publish the new entities, and wait for a grace period before destroying the removed
+// ones, which the PHY workers may still be using
 int rlc::add_bearer(uint32_t lcid, const rlc_config_t& cnfg)
 {
-  rwlock_write_guard lock(rwlock);
-
   if (valid_lcid(lcid)) {
     logger.warning("LCID %d already exists", lcid);
     return SRSRAN_ERROR;
@@ -453,10 +523,12 @@ int rlc::add_bearer(uint32_t lcid, const rlc_config_t& cnfg)
 
   rlc_entity->set_bsr_callback(bsr_callback);
 
+  rlc_common* rb = rlc_entity.get();
   if (not rlc_array.emplace(lcid, std::move(rlc_entity)).second) {
     logger.error("Error inserting RLC entity in to array.");
     return SRSRAN_ERROR;
   }
+  rlc_table.set(lcid, rb);
 
   logger.info("Added %s radio bearer with LCID %d in %s", to_string(cnfg.rat), lcid, to_string(cnfg.rlc_mode));
 
@@ -465,7 +537,6 @@ int rlc::add_bearer(uint32_t lcid, const rlc_config_t& cnfg)
 
 int rlc::add_bearer_mrb(uint32_t lcid)
 {
-  rwlock_write_guard lock(rwlock);
   if (not valid_lcid_mrb(lcid)) {
     std::unique_ptr<rlc_common> rlc_entity =
         std::unique_ptr<rlc_common>(new rlc_um_lte(logger, lcid, pdcp, rrc, timers));
@@ -476,10 +547,12 @@ int rlc::add_bearer_mrb(uint32_t lcid)
     }
     rlc_entity->set_bsr_callback(bsr_callback);
     if (rlc_array_mrb.count(lcid) == 0) {
+      rlc_common* rb = rlc_entity.get();
       if (not rlc_array_mrb.emplace(lcid, std::move(rlc_entity)).second) {
         logger.error("Error inserting RLC entity in to array.");
         return SRSRAN_ERROR;
       }
+      rlc_table_mrb.set(lcid, rb);
     }
     logger.info("Added bearer MRB%d with mode RLC_UM", lcid);
   } else {
@@ -491,11 +564,13 @@ int rlc::add_bearer_mrb(uint32_t lcid)
 
 void rlc::del_bearer(uint32_t lcid)
 {
-  rwlock_write_guard lock(rwlock);
-
   if (valid_lcid(lcid)) {
     rlc_map_t::iterator it = rlc_array.find(lcid);
+    park_bearer(lcid, it->second.get());
+    rlc_table.set(lcid, nullptr);
+    rcu_synchronize();
     it->second->stop();
+    destroy_bearer(std::move(it->second));
     rlc_array.erase(it);
     logger.info("Deleted RLC bearer with LCID %d", lcid);
   } else {
@@ -505,9 +580,9 @@ void rlc::del_bearer(uint32_t lcid)
 
 void rlc::del_bearer_mrb(uint32_t lcid)
 {
-  rwlock_write_guard lock(rwlock);
-
   if (valid_lcid_mrb(lcid)) {
+    rlc_table_mrb.set(lcid, nullptr);
+    rcu_synchronize();
     rlc_map_t::iterator it = rlc_array_mrb.find(lcid);
     it->second->stop();
     rlc_array_mrb.erase(it);
@@ -519,8 +594,6 @@ void rlc::del_bearer_mrb(uint32_t lcid)
 
 void rlc::change_lcid(uint32_t old_lcid, uint32_t new_lcid)
 {
-  rwlock_write_guard lock(rwlock);
-
   // make sure old LCID exists and new LCID is still free
   if (valid_lcid(old_lcid) && not valid_lcid(new_lcid)) {
     // insert old rlc entity into new LCID
@@ -530,7 +603,9 @@ void rlc::change_lcid(uint32_t old_lcid, uint32_t new_lcid)
       logger.error("Error inserting RLC entity into array.");
       return;
     }
-    // erase from old position
+    // erase from old position. The entity itself is not destroyed, so no need to wait for the PHY workers
+    rlc_table.set(new_lcid, rlc_array.at(new_lcid).get());
+    rlc_table.set(old_lcid, nullptr);
     rlc_array.erase(it);
 
     if (valid_lcid(new_lcid) && not valid_lcid(old_lcid)) {
@@ -580,34 +655,60 @@ bool rlc::has_bearer(uint32_t lcid)
 }
 
 /*******************************************************************************
-  Helpers (Lock must be hold when calling those)
+  Helpers (called from Stack thread, or within a read-side critical section)
 *******************************************************************************/
 bool rlc::valid_lcid(uint32_t lcid)
+{
+  return get_bearer(lcid) != nullptr;
+}
+
+bool rlc::valid_lcid_mrb(uint32_t lcid)
+{
+  return get_bearer_mrb(lcid) != nullptr;
+}
+
+// The entity is looked up once, as it may be removed concurrently from the table, but not destroyed before the end of
+// the read-side critical section
+rlc_common* rlc::get_bearer(uint32_t lcid)
 {
   if (lcid >= SRSRAN_N_RADIO_BEARERS) {
     logger.error("Radio bearer id must be in [0:%d] - %d", SRSRAN_N_RADIO_BEARERS, lcid);
-    return false;
+    return nullptr;
   }
-
-  if (rlc_array.find(lcid) == rlc_array.end()) {
-    return false;
-  }
-
-  return true;
+  return rlc_table.get(lcid);
 }
 
-bool rlc::valid_lcid_mrb(uint32_t lcid)
+rlc_common* rlc::get_bearer_mrb(uint32_t lcid)
 {
   if (lcid >= SRSRAN_N_MCH_LCIDS) {
     logger.error("Radio bearer id must be in [0:%d] - %d", SRSRAN_N_RADIO_BEARERS, lcid);
-    return false;
+    return nullptr;
   }
+  return rlc_table_mrb.get(lcid);
+}
 
-  if (rlc_array_mrb.find(lcid) == rlc_array_mrb.end()) {
-    return false;
-  }
+// MAC may hold references to the PDUs of an entity until the TBs are encoded. The entity is parked before being
+// removed from its table, so that the releases that miss it in the table find it in the parked list
+void rlc::park_bearer(uint32_t lcid, rlc_common* rb)
+{
+  std::lock_guard<std::mutex> lock(parked_mutex);
+  parked_bearers.push_back({lcid, rb, nullptr});
+}
 
-  return true;
+// Called after the grace period of the table. The entity is destroyed now, or by the release of its last lent PDU
+void rlc::destroy_bearer(std::unique_ptr<rlc_common> rb)
+{
+  std::lock_guard<std::mutex> lock(parked_mutex);
+  for (auto it = parked_bearers.begin(); it != parked_bearers.end(); ++it) {
+    if (it->rb == rb.get()) {
+      if (rb->has_lent_pdus()) {
+        it->owner = std::move(rb);
+      } else {
+        parked_bearers.erase(it);
+      }
+      return;
+    }
+  }
 }
 
 void rlc::update_bsr(uint32_t lcid)
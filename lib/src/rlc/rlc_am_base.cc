@@ -184,6 +184,26 @@ uint32_t rlc_am::read_pdu(uint8_t* payload, uint32_t nof_bytes)
   return read_bytes;
 }
 
+uint32_t rlc_am::read_pdu_sg(uint8_t* payload, uint32_t nof_bytes, const_byte_span& body)
+{
+  uint32_t read_bytes = tx_base->read_pdu_sg(payload, nof_bytes, body);
+
+  std::lock_guard<std::mutex> lock(metrics_mutex);
+  metrics.num_tx_pdus += read_bytes > 0 ? 1 : 0;
+  metrics.num_tx_pdu_bytes += read_bytes;
+  return read_bytes;
+}
+
+bool rlc_am::release_pdu_sg(const_byte_span body)
+{
+  return tx_base->release_pdu_sg(body);
+}
+
+bool rlc_am::has_lent_pdus()
+{
+  return tx_base->has_lent_pdus();
+}
+
 void rlc_am::write_pdu(uint8_t* payload, uint32_t nof_bytes)
 {
   rx_base->write_pdu(payload, nof_bytes);
@@ -201,10 +221,12 @@ rlc_bearer_metrics_t rlc_am::get_metrics()
   // update values that aren't calculated on the fly
   uint32_t latency        = rx_base->get_sdu_rx_latency_ms();
   uint32_t buffered_bytes = rx_base->get_rx_buffered_bytes();
+  uint32_t hol_delay      = tx_base->get_sdu_queue_hol_delay_us();
 
   std::lock_guard<std::mutex> lock(metrics_mutex);
   metrics.rx_latency_ms     = latency;
   metrics.rx_buffered_bytes = buffered_bytes;
+  metrics.tx_hol_delay_us   = hol_delay;
   return metrics;
 }
 
@@ -229,8 +251,7 @@ void rlc_am::set_bsr_callback(bsr_callback_t callback)
  *******************************************************/
 int rlc_am::rlc_am_base_tx::write_sdu(unique_byte_buffer_t sdu)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
+  // The SDU queue is written without the mutex, so that PDCP does not wait for the PDUs being built
   if (!tx_enabled) {
     return SRSRAN_ERROR;
   }
@@ -275,14 +296,8 @@ void rlc_am::rlc_am_base_tx::discard_sdu(uint32_t discard_sn)
   if (!tx_enabled) {
     return;
   }
-  bool discarded = tx_sdu_queue.apply_first([&discard_sn, this](unique_byte_buffer_t& sdu) {
-    if (sdu != nullptr && sdu->md.pdcp_sn == discard_sn) {
-      tx_sdu_queue.queue.pop_func(sdu);
-      sdu = nullptr;
-      return true;
-    }
-    return false;
-  });
+  bool discarded = tx_sdu_queue.discard_first(
+      [discard_sn](const unique_byte_buffer_t& sdu) { return sdu->md.pdcp_sn == discard_sn; });
 
   // Discard fails when the PDCP PDU is already in Tx window.
   RlcInfo("%s PDU with PDCP_SN=%d", discarded ? "Discarding" : "Couldn't discard", discard_sn);
@@ -293,6 +308,11 @@ bool rlc_am::rlc_am_base_tx::sdu_queue_is_full()
   return tx_sdu_queue.is_full();
 }
 
+uint32_t rlc_am::rlc_am_base_tx::get_sdu_queue_hol_delay_us()
+{
+  return tx_sdu_queue.get_hol_delay().count();
+}
+
 void rlc_am::rlc_am_base_tx::set_bsr_callback(bsr_callback_t callback)
 {
   bsr_callback = callback;
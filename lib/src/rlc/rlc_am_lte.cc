@@ -120,7 +120,7 @@ void rlc_am_lte_tx::stop_nolock()
   byte_without_poll = 0;
 
   // Drop all messages in TX window
-  tx_window.clear();
+  clear_tx_window();
 
   // Drop all messages in RETX queue
   retx_queue.clear();
@@ -280,7 +280,73 @@ void rlc_am_lte_tx::get_buffer_state_nolock(uint32_t& n_bytes_newtx, uint32_t& n
 uint32_t rlc_am_lte_tx::read_pdu(uint8_t* payload, uint32_t nof_bytes)
 {
   std::lock_guard<std::mutex> lock(mutex);
+  return read_pdu_nolock(payload, nof_bytes, nullptr);
+}
+
+/* Data PDUs are kept in the Tx window until acknowledged, so their payload can be handed to MAC by reference instead
+ * of being copied. Only the RLC header is written to payload. */
+uint32_t rlc_am_lte_tx::read_pdu_sg(uint8_t* payload, uint32_t nof_bytes, const_byte_span& body)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  body = {};
+  return read_pdu_nolock(payload, nof_bytes, &body);
+}
+
+bool rlc_am_lte_tx::release_pdu_sg(const_byte_span body)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  auto                        it = lent_pdus.find(body.data());
+  if (it == lent_pdus.end()) {
+    return false;
+  }
+  // The buffer is freed here if it already left the Tx window
+  if (--it->second.count == 0) {
+    lent_pdus.erase(it);
+  }
+  return true;
+}
+
+bool rlc_am_lte_tx::has_lent_pdus()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return not lent_pdus.empty();
+}
+
+// Hands the Tx window PDU to MAC by reference. It is pinned until MAC releases it after encoding the TB
+void rlc_am_lte_tx::lend_pdu(uint32_t sn, const_byte_span* body)
+{
+  *body           = make_span(*tx_window[sn].buf);
+  lent_pdu_t& pdu = lent_pdus[body->data()];
+  pdu.sn          = sn;
+  pdu.count++;
+}
+
+void rlc_am_lte_tx::remove_tx_window_pdu(uint32_t sn)
+{
+  unique_byte_buffer_t& buf = tx_window[sn].buf;
+  if (buf != nullptr and not lent_pdus.empty()) {
+    auto it = lent_pdus.find(buf->msg);
+    if (it != lent_pdus.end()) {
+      it->second.orphan = std::move(buf);
+    }
+  }
+  tx_window.remove_pdu(sn);
+}
+
+void rlc_am_lte_tx::clear_tx_window()
+{
+  for (auto& lent : lent_pdus) {
+    lent_pdu_t& pdu = lent.second;
+    if (pdu.orphan == nullptr and tx_window.has_sn(pdu.sn) and tx_window[pdu.sn].buf != nullptr and
+        tx_window[pdu.sn].buf->msg == lent.first) {
+      pdu.orphan = std::move(tx_window[pdu.sn].buf);
+    }
+  }
+  tx_window.clear();
+}
 
+uint32_t rlc_am_lte_tx::read_pdu_nolock(uint8_t* payload, uint32_t nof_bytes, const_byte_span* body)
+{
   if (not tx_enabled) {
     return 0;
   }
@@ -305,14 +371,14 @@ uint32_t rlc_am_lte_tx::read_pdu(uint8_t* payload, uint32_t nof_bytes)
 
   // RETX if required
   if (not retx_queue.empty()) {
-    int32_t pdu_size = build_retx_pdu(payload, nof_bytes);
+    int32_t pdu_size = build_retx_pdu(payload, nof_bytes, body);
     if (pdu_size > 0) {
       return pdu_size;
     }
   }
 
   // Build a PDU from SDUs
-  return build_data_pdu(payload, nof_bytes);
+  return build_data_pdu(payload, nof_bytes, body);
 }
 
 void rlc_am_lte_tx::timer_expired(uint32_t timeout_id)
@@ -357,11 +423,10 @@ void rlc_am_lte_tx::retransmit_pdu(uint32_t sn)
 
   RlcInfo("Schedule SN=%d for retx", pdu.rlc_sn);
 
-  rlc_amd_retx_lte_t& retx = retx_queue.push();
+  rlc_amd_retx_lte_t& retx = retx_queue.push(pdu.rlc_sn);
   retx.is_segment          = false;
   retx.so_start            = 0;
   retx.so_end              = pdu.buf->N_bytes;
-  retx.sn                  = pdu.rlc_sn;
 }
 
 /****************************************************************************
@@ -444,7 +509,7 @@ int rlc_am_lte_tx::build_status_pdu(uint8_t* payload, uint32_t nof_bytes)
   return pdu_len;
 }
 
-int rlc_am_lte_tx::build_retx_pdu(uint8_t* payload, uint32_t nof_bytes)
+int rlc_am_lte_tx::build_retx_pdu(uint8_t* payload, uint32_t nof_bytes, const_byte_span* body)
 {
   // Check there is at least 1 element before calling front()
   if (retx_queue.empty()) {
@@ -508,11 +573,15 @@ int rlc_am_lte_tx::build_retx_pdu(uint8_t* payload, uint32_t nof_bytes)
 
   uint8_t* ptr = payload;
   rlc_am_write_data_pdu_header(&new_header, &ptr);
-  memcpy(ptr, tx_window[retx.sn].buf->msg, tx_window[retx.sn].buf->N_bytes);
+  if (body != nullptr) {
+    lend_pdu(retx.sn, body);
+  } else {
+    memcpy(ptr, tx_window[retx.sn].buf->msg, tx_window[retx.sn].buf->N_bytes);
+  }
 
   retx_queue.pop();
 
-  RlcHexInfo(payload,
+  RlcHexInfo(body != nullptr ? tx_window[retx.sn].buf->msg : payload,
              tx_window[retx.sn].buf->N_bytes,
              "Tx PDU SN=%d (%d B) (attempt %d/%d)",
              retx.sn,
@@ -696,7 +765,7 @@ int rlc_am_lte_tx::build_segment(uint8_t* payload, uint32_t nof_bytes, rlc_amd_r
   return pdu_len;
 }
 
-int rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
+int rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes, const_byte_span* body)
 {
   if (tx_sdu == NULL && tx_sdu_queue.is_empty()) {
     RlcInfo("No data available to be sent");
@@ -896,9 +965,14 @@ int rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
 
   uint8_t* ptr = payload;
   rlc_am_write_data_pdu_header(&header, &ptr);
-  memcpy(ptr, buffer_ptr->msg, buffer_ptr->N_bytes);
   int total_len = (ptr - payload) + buffer_ptr->N_bytes;
-  RlcHexInfo(payload, total_len, "Tx PDU SN=%d (%d B)", header.sn, total_len);
+  if (body != nullptr) {
+    lend_pdu(header.sn, body);
+    RlcHexInfo(buffer_ptr->msg, buffer_ptr->N_bytes, "Tx PDU SN=%d (%d B)", header.sn, total_len);
+  } else {
+    memcpy(ptr, buffer_ptr->msg, buffer_ptr->N_bytes);
+    RlcHexInfo(payload, total_len, "Tx PDU SN=%d (%d B)", header.sn, total_len);
+  }
   log_rlc_amd_pdu_header_to_string(logger.debug, rb_name, "%s", header);
   debug_state();
 
@@ -948,62 +1022,69 @@ void rlc_am_lte_tx::handle_control_pdu(uint8_t* payload, uint32_t nof_bytes)
     vt_s_local = vt_s;
   }
 
+  // Index of the first NACK of each SN, so that the window is walked once whatever the number of NACKs. Later NACKs
+  // of the same SN are ignored, as the SN is already in the retx queue when they are processed
+  const uint16_t            no_nack = std::numeric_limits<uint16_t>::max();
+  std::array<uint16_t, MOD> first_nack;
+  first_nack.fill(no_nack);
+  for (uint32_t j = status.N_nack; j > 0; j--) {
+    first_nack[status.nacks[j - 1].nack_sn % MOD] = j - 1;
+  }
+
   bool update_vt_a = true;
   while (TX_MOD_BASE(i) < TX_MOD_BASE(status.ack_sn) && TX_MOD_BASE(i) < TX_MOD_BASE(vt_s_local)) {
     bool nack = false;
-    for (uint32_t j = 0; j < status.N_nack; j++) {
-      if (status.nacks[j].nack_sn == i) {
-        nack        = true;
-        update_vt_a = false;
-        std::lock_guard<std::mutex> lock(mutex);
-        if (tx_window.has_sn(i)) {
-          auto& pdu = tx_window[i];
-
-          // add to retx queue if it's not already there
-          if (not retx_queue.has_sn(i)) {
-            // increment Retx counter and inform upper layers if needed
-            pdu.retx_count++;
-            check_sn_reached_max_retx(i);
-
-            rlc_amd_retx_lte_t& retx = retx_queue.push();
-            srsran_expect(tx_window[i].rlc_sn == i, "Incorrect RLC SN=%d!=%d being accessed", tx_window[i].rlc_sn, i);
-            retx.sn         = i;
-            retx.is_segment = false;
-            retx.so_start   = 0;
-            retx.so_end     = pdu.buf->N_bytes;
-
-            if (status.nacks[j].has_so) {
-              // sanity check
-              if (status.nacks[j].so_start >= pdu.buf->N_bytes) {
-                // print error but try to send original PDU again
-                RlcInfo("SO_start is larger than original PDU (%d >= %d)", status.nacks[j].so_start, pdu.buf->N_bytes);
-                status.nacks[j].so_start = 0;
-              }
-
-              // check for special SO_end value
-              if (status.nacks[j].so_end == 0x7FFF) {
-                status.nacks[j].so_end = pdu.buf->N_bytes;
-              } else {
-                retx.so_end = status.nacks[j].so_end + 1;
-              }
-
-              if (status.nacks[j].so_start < pdu.buf->N_bytes && status.nacks[j].so_end <= pdu.buf->N_bytes) {
-                retx.is_segment = true;
-                retx.so_start   = status.nacks[j].so_start;
-              } else {
-                RlcWarning("invalid segment NACK received for SN %d. so_start: %d, so_end: %d, N_bytes: %d",
-                           i,
-                           status.nacks[j].so_start,
-                           status.nacks[j].so_end,
-                           pdu.buf->N_bytes);
-              }
+    if (first_nack[i] != no_nack) {
+      uint32_t j  = first_nack[i];
+      nack        = true;
+      update_vt_a = false;
+      std::lock_guard<std::mutex> lock(mutex);
+      if (tx_window.has_sn(i)) {
+        auto& pdu = tx_window[i];
+
+        // add to retx queue if it's not already there
+        if (not retx_queue.has_sn(i)) {
+          // increment Retx counter and inform upper layers if needed
+          pdu.retx_count++;
+          check_sn_reached_max_retx(i);
+
+          rlc_amd_retx_lte_t& retx = retx_queue.push(i);
+          srsran_expect(tx_window[i].rlc_sn == i, "Incorrect RLC SN=%d!=%d being accessed", tx_window[i].rlc_sn, i);
+          retx.is_segment = false;
+          retx.so_start   = 0;
+          retx.so_end     = pdu.buf->N_bytes;
+
+          if (status.nacks[j].has_so) {
+            // sanity check
+            if (status.nacks[j].so_start >= pdu.buf->N_bytes) {
+              // print error but try to send original PDU again
+              RlcInfo("SO_start is larger than original PDU (%d >= %d)", status.nacks[j].so_start, pdu.buf->N_bytes);
+              status.nacks[j].so_start = 0;
+            }
+
+            // check for special SO_end value
+            if (status.nacks[j].so_end == 0x7FFF) {
+              status.nacks[j].so_end = pdu.buf->N_bytes;
+            } else {
+              retx.so_end = status.nacks[j].so_end + 1;
+            }
+
+            if (status.nacks[j].so_start < pdu.buf->N_bytes && status.nacks[j].so_end <= pdu.buf->N_bytes) {
+              retx.is_segment = true;
+              retx.so_start   = status.nacks[j].so_start;
+            } else {
+              RlcWarning("invalid segment NACK received for SN %d. so_start: %d, so_end: %d, N_bytes: %d",
+                         i,
+                         status.nacks[j].so_start,
+                         status.nacks[j].so_end,
+                         pdu.buf->N_bytes);
             }
-          } else {
-            RlcInfo("NACKed SN=%d already considered for retransmission", i);
           }
         } else {
-          RlcError("NACKed SN=%d already removed from Tx window", i);
+          RlcInfo("NACKed SN=%d already considered for retransmission", i);
         }
+      } else {
+        RlcError("NACKed SN=%d already removed from Tx window", i);
       }
     }
 
@@ -1013,7 +1094,7 @@ void rlc_am_lte_tx::handle_control_pdu(uint8_t* payload, uint32_t nof_bytes)
       if (tx_window.has_sn(i)) {
         update_notification_ack_info(i);
         RlcDebug("Tx PDU SN=%zd being removed from tx window", i);
-        tx_window.remove_pdu(i);
+        remove_tx_window_pdu(i);
       }
       // Advance window if possible
       if (update_vt_a) {
@@ -1208,6 +1289,7 @@ void rlc_am_lte_rx::stop()
   }
 
   rx_sdu.reset();
+  status_pdu_len_valid = false;
 
   vr_r  = 0;
   vr_mr = RLC_AM_WINDOW_SIZE;
@@ -1233,6 +1315,7 @@ void rlc_am_lte_rx::stop()
 void rlc_am_lte_rx::handle_data_pdu(uint8_t* payload, uint32_t nof_bytes)
 {
   std::lock_guard<std::mutex> lock(mutex);
+  status_pdu_len_valid = false;
 
   rlc_amd_pdu_header_t header      = {};
   uint32_t             payload_len = nof_bytes;
@@ -1369,8 +1452,6 @@ void rlc_am_lte_rx::handle_data_pdu_full(uint8_t* payload, uint32_t nof_bytes, r
 
 void rlc_am_lte_rx::handle_data_pdu_segment(uint8_t* payload, uint32_t nof_bytes, rlc_amd_pdu_header_t& header)
 {
-  std::map<uint32_t, rlc_amd_rx_pdu_segments_t>::iterator it;
-
   RlcHexInfo(payload,
              nof_bytes,
              "Rx data PDU segment of SN=%d (%d B), SO=%d, N_li=%d",
@@ -1390,9 +1471,8 @@ void rlc_am_lte_rx::handle_data_pdu_segment(uint8_t* payload, uint32_t nof_bytes
     return;
   }
 
-  rlc_amd_rx_pdu segment;
-  segment.buf = srsran::make_byte_buffer();
-  if (segment.buf == NULL) {
+  unique_byte_buffer_t buf = srsran::make_byte_buffer();
+  if (buf == NULL) {
 #ifdef RLC_AM_BUFFER_DEBUG
     srsran::console("Fatal Error: Couldn't allocate PDU in handle_data_pdu_segment().\n");
     exit(-1);
@@ -1402,34 +1482,34 @@ void rlc_am_lte_rx::handle_data_pdu_segment(uint8_t* payload, uint32_t nof_bytes
 #endif
   }
 
-  if (segment.buf->get_tailroom() < nof_bytes) {
+  if (buf->get_tailroom() < nof_bytes) {
     RlcInfo("Dropping corrupted segment SN=%d, not enough space to fit %d B", header.sn, nof_bytes);
     return;
   }
 
-  memcpy(segment.buf->msg, payload, nof_bytes);
-  segment.buf->N_bytes = nof_bytes;
-  segment.header       = header;
+  memcpy(buf->msg, payload, nof_bytes);
+  buf->N_bytes = nof_bytes;
+
+  rlc_am_rx_segment_pool<rlc_amd_rx_pdu>::segment* segment = segment_pool.allocate();
+  segment->pdu.buf                                         = std::move(buf);
+  segment->pdu.header                                      = header;
+  segment->pdu.rlc_sn                                      = header.sn;
 
   // Check if we already have a segment from the same PDU
-  it = rx_segments.find(header.sn);
-  if (rx_segments.end() != it) {
+  if (rx_segments.has_sn(header.sn)) {
     if (header.p) {
       RlcInfo("Status packet requested through polling bit");
       do_status = true;
     }
 
     // Add segment to PDU list and check for complete
-    // NOTE: MAY MOVE. Preference would be to capture by value, and then move; but header is stack allocated
-    if (add_segment_and_check(&it->second, &segment)) {
-      rx_segments.erase(it);
+    if (add_segment_and_check(&rx_segments[header.sn], segment)) {
+      rx_segments.remove_pdu(header.sn);
     }
 
   } else {
-    // Create new PDU segment list and write to rx_segments
-    rlc_amd_rx_pdu_segments_t pdu;
-    pdu.segments.push_back(std::move(segment));
-    rx_segments[header.sn] = std::move(pdu);
+    // Create new PDU segment list in rx_segments
+    rx_segments.add_pdu(header.sn).segments.insert(segment);
 
     // Update vr_h
     if (RX_MOD_BASE(header.sn) >= RX_MOD_BASE(vr_h)) {
@@ -1585,19 +1665,17 @@ void rlc_am_lte_rx::reassemble_rx_sdus()
     // Move the rx_window
     RlcDebug("Erasing SN=%d.", vr_r);
     // also erase any segments of this SN
-    std::map<uint32_t, rlc_amd_rx_pdu_segments_t>::iterator it;
-    it = rx_segments.find(vr_r);
-    if (rx_segments.end() != it) {
+    if (rx_segments.has_sn(vr_r)) {
       RlcDebug("Erasing segments of SN=%d", vr_r);
-      std::list<rlc_amd_rx_pdu>::iterator segit;
-      for (segit = it->second.segments.begin(); segit != it->second.segments.end(); ++segit) {
+      rlc_amd_rx_pdu_segments_t& pdu = rx_segments[vr_r];
+      for (auto segit = pdu.segments.begin(); segit != pdu.segments.end(); ++segit) {
         RlcDebug(" Erasing segment of SN=%d SO=%d Len=%d N_li=%d",
                  segit->header.sn,
                  segit->header.so,
                  segit->buf->N_bytes,
                  segit->header.N_li);
       }
-      it->second.segments.clear();
+      rx_segments.remove_pdu(vr_r);
     }
     rx_window.remove_pdu(vr_r);
     vr_r  = (vr_r + 1) % MOD;
@@ -1638,6 +1716,7 @@ void rlc_am_lte_rx::timer_expired(uint32_t timeout_id)
   std::lock_guard<std::mutex> lock(mutex);
   if (reordering_timer.is_valid() and reordering_timer.id() == timeout_id) {
     RlcDebug("reordering timeout expiry - updating vr_ms (was %d)", vr_ms);
+    status_pdu_len_valid = false;
 
     // 36.322 v10 Section 5.1.3.2.4
     vr_ms = vr_x;
@@ -1670,20 +1749,24 @@ int rlc_am_lte_rx::get_status_pdu(rlc_status_pdu_t* status, const uint32_t max_p
   status->N_nack = 0;
   status->ack_sn = vr_r; // start with lower edge of the rx window
 
-  // We don't use segment NACKs - just NACK the full PDU
-  uint32_t i = vr_r;
+  // We don't use segment NACKs - just NACK the full PDU. The packed length is updated as the NACKs are added, instead
+  // of being recomputed from all of them for every SN
+  uint32_t len_bits = 15;
+  uint32_t i        = vr_r;
   while (RX_MOD_BASE(i) <= RX_MOD_BASE(vr_ms) && status->N_nack < RLC_AM_WINDOW_SIZE) {
     if (rx_window.has_sn(i) || i == vr_ms) {
       // only update ACK_SN if this SN has been received, or if we reached the maximum possible SN
       status->ack_sn = i;
     } else {
       status->nacks[status->N_nack].nack_sn = i;
+      status->nacks[status->N_nack].has_so  = false;
       status->N_nack++;
+      len_bits += 12;
     }
 
     // make sure we don't exceed grant size
-    if (rlc_am_packed_length(status) > max_pdu_size) {
-      RlcDebug("Status PDU too big (%d > %d)", rlc_am_packed_length(status), max_pdu_size);
+    if ((len_bits + 7) / 8 > max_pdu_size) {
+      RlcDebug("Status PDU too big (%d > %d)", (len_bits + 7) / 8, max_pdu_size);
       if (status->N_nack >= 1 && status->N_nack < RLC_AM_WINDOW_SIZE) {
         RlcDebug("Removing last NACK SN=%d", status->nacks[status->N_nack].nack_sn);
         status->N_nack--;
@@ -1719,82 +1802,48 @@ int rlc_am_lte_rx::get_status_pdu_length()
   if (not lock.owns_lock()) {
     return 0;
   }
-  rlc_status_pdu_t status = {};
-  status.ack_sn           = vr_ms;
-  uint32_t i              = vr_r;
-  while (RX_MOD_BASE(i) < RX_MOD_BASE(vr_ms) && status.N_nack < RLC_AM_WINDOW_SIZE) {
-    if (not rx_window.has_sn(i)) {
-      status.N_nack++;
+  // The length only changes with the RX window and the state variables, so the window is only walked again after them
+  if (not status_pdu_len_valid) {
+    uint32_t n_nack = 0;
+    for (uint32_t i = vr_r; RX_MOD_BASE(i) < RX_MOD_BASE(vr_ms) && n_nack < RLC_AM_WINDOW_SIZE; i = (i + 1) % MOD) {
+      if (not rx_window.has_sn(i)) {
+        n_nack++;
+      }
     }
-    i = (i + 1) % MOD;
+    status_pdu_len       = (15 + 12 * n_nack + 7) / 8; // Fixed part is 15 bits, 12 bits per NACK without SO
+    status_pdu_len_valid = true;
   }
-  return rlc_am_packed_length(&status);
+  return status_pdu_len;
 }
 
 void rlc_am_lte_rx::print_rx_segments()
 {
-  std::map<uint32_t, rlc_amd_rx_pdu_segments_t>::iterator it;
-  std::stringstream                                       ss;
+  std::stringstream ss;
   ss << "rx_segments:" << std::endl;
-  for (it = rx_segments.begin(); it != rx_segments.end(); it++) {
-    std::list<rlc_amd_rx_pdu>::iterator segit;
-    for (segit = it->second.segments.begin(); segit != it->second.segments.end(); segit++) {
-      ss << "    SN=" << segit->header.sn << " SO:" << segit->header.so << " N:" << segit->buf->N_bytes
-         << " N_li: " << segit->header.N_li << std::endl;
+  for (uint32_t i = vr_r; RX_MOD_BASE(i) < RX_MOD_BASE(vr_mr); i = (i + 1) % MOD) {
+    if (not rx_segments.has_sn(i)) {
+      continue;
+    }
+    for (const rlc_amd_rx_pdu& seg : rx_segments[i].segments) {
+      ss << "    SN=" << seg.header.sn << " SO:" << seg.header.so << " N:" << seg.buf->N_bytes
+         << " N_li: " << seg.header.N_li << std::endl;
     }
   }
   RlcDebug("%s", ss.str().c_str());
 }
 
-// NOTE: Preference would be to capture by value, and then move; but header is stack allocated
-bool rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_amd_rx_pdu* segment)
+bool rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t*                       pdu,
+                                          rlc_am_rx_segment_pool<rlc_amd_rx_pdu>::segment* segment)
 {
-  // Find segment insertion point in the list of segments
-  auto it1 = pdu->segments.begin();
-  while (it1 != pdu->segments.end() && (*it1).header.so < segment->header.so) {
-    // Increment iterator
-    it1++;
-  }
-
-  // Check if the insertion point was found
-  if (it1 != pdu->segments.end()) {
-    // Found insertion point
-    rlc_amd_rx_pdu& s = *it1;
-    if (s.header.so == segment->header.so) {
-      // Same Segment offset
-      if (segment->buf->N_bytes > s.buf->N_bytes) {
-        // replace if the new one is bigger
-        s = std::move(*segment);
-      } else {
-        // Ignore otherwise
-      }
-    } else if (s.header.so > segment->header.so) {
-      pdu->segments.insert(it1, std::move(*segment));
-    }
-  } else {
-    // Either the new segment is the latest or the only one, push back
-    pdu->segments.push_back(std::move(*segment));
-  }
+  // Insert the segment in SO order. If a segment with the same SO was received, only the longer one is kept
+  pdu->segments.insert(segment);
 
-  // Check for complete
-  uint32_t                            so = 0;
-  std::list<rlc_amd_rx_pdu>::iterator it, tmpit;
-  for (it = pdu->segments.begin(); it != pdu->segments.end(); /* Do not increment */) {
-    // Check that there is no gap between last segment and current; overlap allowed
-    if (so < it->header.so) {
-      // return
-      return false;
-    }
+  // Drop the segments completely overlapped by the previous ones
+  pdu->segments.remove_overlapped();
 
-    // Check if segment is overlapped
-    if (it->header.so + it->buf->N_bytes <= so) {
-      // completely overlapped with previous segments, erase
-      it = pdu->segments.erase(it); // Returns next iterator
-    } else {
-      // Update segment offset it shall not go backwards
-      so = SRSRAN_MAX(so, it->header.so + it->buf->N_bytes);
-      it++; // Increments iterator
-    }
+  // Check that there is no gap between the received segments, starting from SO 0; overlap allowed
+  if (pdu->segments.has_gap()) {
+    return false;
   }
 
   // Check for last segment flag available
@@ -1824,6 +1873,7 @@ bool rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_am
   uint16_t carryover      = 0;
   uint16_t consumed_bytes = 0; // rolling sum of all allocated LIs during segment reconstruction
 
+  rlc_am_rx_segment_list<rlc_amd_rx_pdu>::iterator it, tmpit;
   for (it = pdu->segments.begin(); it != pdu->segments.end(); ++it) {
     RlcDebug(" Handling %d PDU segments", it->header.N_li);
     for (uint32_t i = 0; i < it->header.N_li; i++) {
@@ -75,6 +75,7 @@ bool rlc_am_nr_tx::configure(const rlc_config_t& cfg_)
   }
 
   max_hdr_size = min_hdr_size + so_size;
+  retx_queue.set_window_size(tx_window_size());
 
   // make sure Tx queue is empty before attempting to resize
   empty_queue_no_lock();
@@ -452,20 +453,19 @@ uint32_t rlc_am_nr_tx::build_retx_pdu(uint8_t* payload, uint32_t nof_bytes)
     return 0;
   }
 
-  rlc_amd_retx_nr_t& retx = retx_queue.front();
-
   // Sanity check - drop any retx SNs not present in tx_window
-  while (not tx_window->has_sn(retx.sn)) {
-    RlcInfo("SN=%d not in tx window, probably already ACKed. Skip and remove from retx queue", retx.sn);
+  while (not tx_window->has_sn(retx_queue.front().sn)) {
+    RlcInfo("SN=%d not in tx window, probably already ACKed. Skip and remove from retx queue",
+            retx_queue.front().sn);
     retx_queue.pop();
-    if (!retx_queue.empty()) {
-      retx = retx_queue.front();
-    } else {
+    if (retx_queue.empty()) {
       RlcInfo("empty retx queue, cannot provide any retx PDU");
       return 0;
     }
   }
 
+  rlc_amd_retx_nr_t& retx = retx_queue.front();
+
   RlcDebug("RETX - SN=%d, is_segment=%s, current_so=%d, so_start=%d, segment_length=%d",
            retx.sn,
            retx.is_segment ? "true" : "false",
@@ -846,6 +846,11 @@ void rlc_am_nr_tx::handle_control_pdu(uint8_t* payload, uint32_t nof_bytes)
                          : status.nacks[0].nack_sn; // Stop processing ACKs at the first NACK, if it exists.
   for (uint32_t sn = st.tx_next_ack; tx_mod_base_nr(sn) < tx_mod_base_nr(stop_sn); sn = (sn + 1) % mod_nr) {
     if (tx_window->has_sn(sn)) {
+      // With 18 bit SNs, a status PDU may ACK more SDUs than can be notified at once
+      if (notify_info_vec.full()) {
+        parent->pdcp->notify_delivery(parent->lcid, notify_info_vec);
+        notify_info_vec.clear();
+      }
       notify_info_vec.push_back((*tx_window)[sn].pdcp_sn);
       retx_queue.remove_sn(sn); // remove any pending retx for that SN
       tx_window->remove_pdu(sn);
@@ -926,8 +931,7 @@ void rlc_am_nr_tx::handle_nack(const rlc_status_nack_t& nack, std::set<uint32_t>
         for (const rlc_amd_tx_pdu_nr::pdu_segment& segm : pdu.segment_list) {
           if (segm.so >= nack.so_start && segm.so <= nack.so_end) {
             if (not retx_queue.has_sn(nack.nack_sn, segm.so)) {
-              rlc_amd_retx_nr_t& retx = retx_queue.push();
-              retx.sn                 = nack.nack_sn;
+              rlc_amd_retx_nr_t& retx = retx_queue.push(nack.nack_sn);
               retx.is_segment         = true;
               retx.so_start           = segm.so;
               retx.current_so         = segm.so;
@@ -961,8 +965,7 @@ void rlc_am_nr_tx::handle_nack(const rlc_status_nack_t& nack, std::set<uint32_t>
         if (not retx_queue.has_sn(nack.nack_sn)) {
           // Have we segmented the SDU already?
           if ((*tx_window)[nack.nack_sn].segment_list.empty()) {
-            rlc_amd_retx_nr_t& retx = retx_queue.push();
-            retx.sn                 = nack.nack_sn;
+            rlc_amd_retx_nr_t& retx = retx_queue.push(nack.nack_sn);
             retx.is_segment         = false;
             retx.so_start           = 0;
             retx.current_so         = 0;
@@ -973,8 +976,7 @@ void rlc_am_nr_tx::handle_nack(const rlc_status_nack_t& nack, std::set<uint32_t>
             RlcInfo("Scheduled RETX of SDU SN=%d", nack.nack_sn);
             retx_sn_set.insert(nack.nack_sn);
             for (auto segm : (*tx_window)[nack.nack_sn].segment_list) {
-              rlc_amd_retx_nr_t& retx = retx_queue.push();
-              retx.sn                 = nack.nack_sn;
+              rlc_amd_retx_nr_t& retx = retx_queue.push(nack.nack_sn);
               retx.is_segment         = true;
               retx.so_start           = segm.so;
               retx.current_so         = segm.so;
@@ -1049,7 +1051,7 @@ void rlc_am_nr_tx::get_buffer_state(uint32_t& n_bytes_new, uint32_t& n_bytes_pri
   }
 
   // Bytes needed for retx
-  for (const rlc_amd_retx_nr_t& retx : retx_queue.get_inner_queue()) {
+  for (const rlc_amd_retx_nr_t& retx : retx_queue) {
     RlcDebug("buffer state - retx - SN=%d, Segment: %s, %d:%d",
              retx.sn,
              retx.is_segment ? "true" : "false",
@@ -1274,8 +1276,7 @@ void rlc_am_nr_tx::timer_expired(uint32_t timeout_id)
       // RETX first RLC SDU that has not been ACKed
       // or first SDU segment of the first RLC SDU
       // that has not been acked
-      rlc_amd_retx_nr_t& retx = retx_queue.push();
-      retx.sn                 = st.tx_next_ack;
+      rlc_amd_retx_nr_t& retx = retx_queue.push(st.tx_next_ack);
       if ((*tx_window)[st.tx_next_ack].segment_list.empty()) {
         // Full SDU
         retx.is_segment     = false;
@@ -1392,7 +1393,9 @@ bool rlc_am_nr_rx::configure(const rlc_config_t& cfg_)
     reassembly_timer.set(static_cast<uint32_t>(cfg.t_reassembly), [this](uint32_t timerid) { timer_expired(timerid); });
   }
 
-  mod_nr = cardinality(cfg.rx_sn_field_length);
+  mod_nr             = cardinality(cfg.rx_sn_field_length);
+  status_cache       = rlc_am_nr_status_pdu_t(cfg.rx_sn_field_length);
+  status_cache_valid = false;
   switch (cfg.rx_sn_field_length) {
     case rlc_am_nr_sn_size_t::size12bits:
       rx_window = std::unique_ptr<rlc_ringbuffer_base<rlc_amd_rx_sdu_nr_t> >(
@@ -1426,7 +1429,8 @@ void rlc_am_nr_rx::stop()
 
   st = {};
 
-  do_status = false;
+  do_status          = false;
+  status_cache_valid = false;
 
   // Drop all messages in RX window
   rx_window->clear();
@@ -1440,6 +1444,7 @@ void rlc_am_nr_rx::reestablish()
 void rlc_am_nr_rx::handle_data_pdu(uint8_t* payload, uint32_t nof_bytes)
 {
   std::lock_guard<std::mutex> lock(mutex);
+  status_cache_valid = false;
 
   // Get AMD PDU Header
   rlc_am_nr_pdu_header_t header  = {};
@@ -1683,18 +1688,21 @@ int rlc_am_nr_rx::handle_segment_data_sdu(const rlc_am_nr_pdu_header_t& header,
   rlc_amd_rx_sdu_nr_t& rx_sdu = rx_window->has_sn(header.sn) ? (*rx_window)[header.sn] : rx_window->add_pdu(header.sn);
 
   // Create PDU segment info, to be stored later
-  rlc_amd_rx_pdu_nr pdu_segment = {};
-  pdu_segment.header            = header;
-  pdu_segment.buf               = srsran::make_byte_buffer();
-  if (pdu_segment.buf == nullptr) {
+  unique_byte_buffer_t buf = srsran::make_byte_buffer();
+  if (buf == nullptr) {
     RlcError("fatal error. Couldn't allocate PDU in %s.", __FUNCTION__);
     return SRSRAN_ERROR;
   }
-  memcpy(pdu_segment.buf->msg, payload + hdr_len, nof_bytes - hdr_len); // Don't copy header
-  pdu_segment.buf->N_bytes = nof_bytes - hdr_len;
+  memcpy(buf->msg, payload + hdr_len, nof_bytes - hdr_len); // Don't copy header
+  buf->N_bytes = nof_bytes - hdr_len;
+
+  rlc_am_rx_segment_pool<rlc_amd_rx_pdu_nr>::segment* pdu_segment = segment_pool.allocate();
+  pdu_segment->pdu.header                                         = header;
+  pdu_segment->pdu.buf                                            = std::move(buf);
+  pdu_segment->pdu.rlc_sn                                         = header.sn;
 
   // Store SDU segment. Sort by SO and check for duplicate bytes.
-  insert_received_segment(std::move(pdu_segment), rx_sdu.segments);
+  insert_received_segment(pdu_segment, rx_sdu.segments);
 
   // Check weather all segments have been received
   update_segment_inventory(rx_sdu);
@@ -1725,6 +1733,44 @@ uint32_t rlc_am_nr_rx::get_status_pdu(rlc_am_nr_status_pdu_t* status, uint32_t m
     return SRSRAN_ERROR;
   }
 
+  update_status_cache();
+  *status = status_cache;
+
+  // trim PDU if necessary
+  if (status->packed_size > max_len) {
+    RlcInfo("Trimming status PDU with %d NACKs and packed_size=%d into max_len=%d",
+            status->nacks.size(),
+            status->packed_size,
+            max_len);
+    log_rlc_am_nr_status_pdu_to_string(logger.debug, "Untrimmed status PDU - %s", status, rb_name);
+    if (not status->trim(max_len)) {
+      RlcError("Failed to trim status PDU into provided space: max_len=%d", max_len);
+    }
+  }
+
+  if (max_len != UINT32_MAX) {
+    // UINT32_MAX is used just to query the status PDU length
+    if (status_prohibit_timer.is_valid() && cfg.t_status_prohibit != 0) {
+      status_prohibit_timer.run();
+    }
+    do_status = false;
+  }
+
+  return status->packed_size;
+}
+
+/*
+ * Builds the full status PDU from the RX window, unless it was already built after the last change of the window or
+ * the state variables. Caller must hold the mutex.
+ */
+void rlc_am_nr_rx::update_status_cache()
+{
+  if (status_cache_valid) {
+    return;
+  }
+  status_cache_valid = true;
+
+  rlc_am_nr_status_pdu_t* status = &status_cache;
   status->reset();
 
   /*
@@ -1810,35 +1856,16 @@ uint32_t rlc_am_nr_rx::get_status_pdu(rlc_am_nr_status_pdu_t* status, uint32_t m
    * indicated as missing in the resulting STATUS PDU.
    */
   status->ack_sn = st.rx_highest_status;
-
-  // trim PDU if necessary
-  if (status->packed_size > max_len) {
-    RlcInfo("Trimming status PDU with %d NACKs and packed_size=%d into max_len=%d",
-            status->nacks.size(),
-            status->packed_size,
-            max_len);
-    log_rlc_am_nr_status_pdu_to_string(logger.debug, "Untrimmed status PDU - %s", status, rb_name);
-    if (not status->trim(max_len)) {
-      RlcError("Failed to trim status PDU into provided space: max_len=%d", max_len);
-    }
-  }
-
-  if (max_len != UINT32_MAX) {
-    // UINT32_MAX is used just to query the status PDU length
-    if (status_prohibit_timer.is_valid() && cfg.t_status_prohibit != 0) {
-      status_prohibit_timer.run();
-    }
-    do_status = false;
-  }
-
-  return status->packed_size;
 }
 
 uint32_t rlc_am_nr_rx::get_status_pdu_length()
 {
-  rlc_am_nr_status_pdu_t tmp_status(cfg.rx_sn_field_length);
-  get_status_pdu(&tmp_status, UINT32_MAX);
-  return tmp_status.get_packed_size();
+  std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+  if (not lock.owns_lock()) {
+    return rlc_am_nr_status_pdu_sizeof_header_ack_sn;
+  }
+  update_status_cache();
+  return status_cache.packed_size;
 }
 
 bool rlc_am_nr_rx::get_do_status()
@@ -1863,6 +1890,7 @@ void rlc_am_nr_rx::timer_expired(uint32_t timeout_id)
   // Reassembly
   if (reassembly_timer.is_valid() && reassembly_timer.id() == timeout_id) {
     RlcDebug("Reassembly timer expired after %dms", reassembly_timer.duration());
+    status_cache_valid = false;
     /*
      * 5.2.3.2.4 Actions when t-Reassembly expires:
      * - update RX_Highest_Status to the SN of the first RLC SDU with SN >= RX_Next_Status_Trigger for which not
@@ -1925,10 +1953,10 @@ void rlc_am_nr_rx::write_to_upper_layers(uint32_t lcid, unique_byte_buffer_t sdu
 /*
  * Segment Helpers
  */
-void rlc_am_nr_rx::insert_received_segment(rlc_amd_rx_pdu_nr                                   segment,
-                                           std::set<rlc_amd_rx_pdu_nr, rlc_amd_rx_pdu_nr_cmp>& segment_list) const
+void rlc_am_nr_rx::insert_received_segment(rlc_am_rx_segment_pool<rlc_amd_rx_pdu_nr>::segment* segment,
+                                           rlc_amd_rx_sdu_nr_t::segment_list_t&                segment_list) const
 {
-  segment_list.insert(std::move(segment));
+  segment_list.insert(segment);
 }
 
 void rlc_am_nr_rx::update_segment_inventory(rlc_amd_rx_sdu_nr_t& rx_sdu) const
@@ -1939,26 +1967,10 @@ void rlc_am_nr_rx::update_segment_inventory(rlc_amd_rx_sdu_nr_t& rx_sdu) const
     return;
   }
 
-  // Check for gaps and if all segments have been received
-  uint32_t next_byte = 0;
-  for (const auto& it : rx_sdu.segments) {
-    if (it.header.so != next_byte) {
-      // Found gap: set flags and return
-      rx_sdu.has_gap        = true;
-      rx_sdu.fully_received = false;
-      return;
-    }
-    if (it.header.si == rlc_nr_si_field_t::last_segment) {
-      // Reached last segment without any gaps: set flags and return
-      rx_sdu.has_gap        = false;
-      rx_sdu.fully_received = true;
-      return;
-    }
-    next_byte += it.buf->N_bytes;
-  }
-  // No gaps, but last segment not yet received
-  rx_sdu.has_gap        = false;
-  rx_sdu.fully_received = false;
+  // Check for gaps and if all segments have been received. Segments do not overlap, so the last segment is the one
+  // with the highest SO
+  rx_sdu.has_gap        = rx_sdu.segments.has_gap();
+  rx_sdu.fully_received = not rx_sdu.has_gap and rx_sdu.segments.back().header.si == rlc_nr_si_field_t::last_segment;
 }
 
 /*
@@ -34,6 +34,30 @@ rlc_am_nr_status_pdu_t::rlc_am_nr_status_pdu_t(rlc_am_nr_sn_size_t sn_size) :
   nacks_.reserve(RLC_AM_NR_TYP_NACKS);
 }
 
+// The read-only references must be bound to the members of the copy, not to the ones of the original
+rlc_am_nr_status_pdu_t::rlc_am_nr_status_pdu_t(const rlc_am_nr_status_pdu_t& other) :
+  sn_size(other.sn_size),
+  mod_nr(other.mod_nr),
+  nacks_(other.nacks_),
+  packed_size_(other.packed_size_),
+  cpt(other.cpt),
+  ack_sn(other.ack_sn)
+{
+}
+
+rlc_am_nr_status_pdu_t& rlc_am_nr_status_pdu_t::operator=(const rlc_am_nr_status_pdu_t& other)
+{
+  if (this != &other) {
+    sn_size      = other.sn_size;
+    mod_nr       = other.mod_nr;
+    nacks_       = other.nacks_;
+    packed_size_ = other.packed_size_;
+    cpt          = other.cpt;
+    ack_sn       = other.ack_sn;
+  }
+  return *this;
+}
+
 void rlc_am_nr_status_pdu_t::reset()
 {
   cpt    = rlc_am_nr_control_pdu_type_t::status_pdu;
@@ -180,7 +180,10 @@ void rlc_um_base::write_pdu(uint8_t* payload, uint32_t nof_bytes)
 
 rlc_bearer_metrics_t rlc_um_base::get_metrics()
 {
+  uint32_t hol_delay = tx ? tx->get_sdu_queue_hol_delay_us() : 0;
+
   std::lock_guard<std::mutex> lock(metrics_mutex);
+  metrics.tx_hol_delay_us = hol_delay;
   return metrics;
 }
 
@@ -309,13 +312,8 @@ void rlc_um_base::rlc_um_base_tx::discard_sdu(uint32_t discard_sn)
 {
   std::lock_guard<std::mutex> lock(mutex);
 
-  bool discarded = tx_sdu_queue.apply_first([&discard_sn, this](unique_byte_buffer_t& sdu) {
-    if (sdu != nullptr && sdu->md.pdcp_sn == discard_sn) {
-      tx_sdu_queue.queue.pop_func(sdu);
-      sdu = nullptr;
-    }
-    return false;
-  });
+  bool discarded = tx_sdu_queue.discard_first(
+      [discard_sn](const unique_byte_buffer_t& sdu) { return sdu->md.pdcp_sn == discard_sn; });
 
   // Discard fails when the PDCP PDU is already in Tx window.
   RlcInfo("%s PDU with PDCP_SN=%d", discarded ? "Discarding" : "Couldn't discard", discard_sn);
@@ -326,6 +324,11 @@ bool rlc_um_base::rlc_um_base_tx::sdu_queue_is_full()
   return tx_sdu_queue.is_full();
 }
 
+uint32_t rlc_um_base::rlc_um_base_tx::get_sdu_queue_hol_delay_us()
+{
+  return tx_sdu_queue.get_hol_delay().count();
+}
+
 uint32_t rlc_um_base::rlc_um_base_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
 {
   unique_byte_buffer_t pdu;
@@ -0,0 +1,135 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/adt/mpsc_queue.h"
+#include "srsran/common/test_common.h"
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace srsran {
+
+struct C {
+  C() : val_ptr(new int(5)) { count++; }
+  explicit C(int v) : val_ptr(new int(v)) { count++; }
+  ~C() { count--; }
+  C(C&& other) : val_ptr(std::move(other.val_ptr)) { count++; }
+  C& operator=(C&&) = default;
+
+  std::unique_ptr<int> val_ptr;
+
+  static size_t count;
+};
+size_t C::count = 0;
+
+void test_mpsc_queue_single_thread()
+{
+  {
+    static_mpsc_queue<int, 8> q;
+    TESTASSERT(q.empty() and q.max_size() == 8);
+
+    int val = -1;
+    TESTASSERT(not q.try_pop(val));
+
+    // push until full
+    for (int i = 0; i < 8; ++i) {
+      TESTASSERT(q.try_push(i));
+      TESTASSERT(q.size() == (size_t)i + 1);
+    }
+    TESTASSERT(not q.try_push(8));
+
+    // elements are popped in FIFO order, also after the ring wraps around
+    for (int i = 0; i < 20; ++i) {
+      TESTASSERT(q.try_pop(val) and val == i);
+      TESTASSERT(q.try_push(i + 8));
+    }
+    for (int i = 20; i < 28; ++i) {
+      TESTASSERT(q.try_pop(val) and val == i);
+    }
+    TESTASSERT(q.empty() and not q.try_pop(val));
+  }
+
+  // TEST: move-only types and destruction of non-popped elements
+  {
+    static_mpsc_queue<C, 4> q;
+    TESTASSERT(q.try_emplace(1));
+    TESTASSERT(q.try_push(C{2}));
+    TESTASSERT(q.try_emplace(3));
+    TESTASSERT(C::count == 3);
+    C c;
+    TESTASSERT(q.try_pop(c) and *c.val_ptr == 1);
+    TESTASSERT(C::count == 3);
+  }
+  TESTASSERT(C::count == 0);
+}
+
+void test_mpsc_queue_multi_thread()
+{
+  const uint32_t nof_producers = 4, nof_items = 100000;
+
+  static_mpsc_queue<uint32_t, 64> q;
+  std::vector<std::thread>        producers;
+  for (uint32_t p = 0; p < nof_producers; ++p) {
+    producers.emplace_back([&q, p]() {
+      for (uint32_t i = 0; i < nof_items; ++i) {
+        while (not q.try_push(p * nof_items + i)) {
+          std::this_thread::yield();
+        }
+        TESTASSERT(q.size() <= q.max_size());
+      }
+    });
+  }
+
+  // items of each producer are received in order and none is lost
+  std::vector<uint32_t> next_item(nof_producers, 0);
+  uint32_t              count = 0, val = 0;
+  while (count < nof_producers * nof_items) {
+    if (not q.try_pop(val)) {
+      std::this_thread::yield();
+      continue;
+    }
+    uint32_t p = val / nof_items;
+    TESTASSERT(p < nof_producers);
+    TESTASSERT(val % nof_items == next_item[p]);
+    next_item[p]++;
+    count++;
+  }
+
+  for (auto& t : producers) {
+    t.join();
+  }
+  TESTASSERT(q.empty());
+}
+
+} // namespace srsran
+
+int main(int argc, char** argv)
+{
+  auto& test_log = srslog::fetch_basic_logger("TEST");
+  test_log.set_level(srslog::basic_levels::info);
+
+  srsran::test_init(argc, argv);
+
+  srsran::test_mpsc_queue_single_thread();
+  srsran::test_mpsc_queue_multi_thread();
+  srsran::console("Success\n");
+  return SRSRAN_SUCCESS;
+}
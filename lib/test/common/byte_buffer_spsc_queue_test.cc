@@ -0,0 +1,213 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Tests the accounting, discards and resizing of the SPSC SDU queue, and the order of the SDUs written and read
+ * concurrently. In benchmark mode, it also measures the enqueue and dequeue latency against byte_buffer_queue, with a
+ * third thread polling the buffer state as the MAC does.
+ *
+ * Usage: byte_buffer_spsc_queue_test [test|benchmark]
+ */
+
+#include "srsran/common/buffer_pool.h"
+#include "srsran/common/test_common.h"
+#include "srsran/upper/byte_buffer_queue.h"
+#include "srsran/upper/byte_buffer_spsc_queue.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace srsran;
+
+namespace {
+
+unique_byte_buffer_t make_sdu(uint32_t sn, uint32_t len)
+{
+  unique_byte_buffer_t sdu;
+  while ((sdu = make_byte_buffer()) == nullptr) {
+    // wait until the pool is not depleted
+    std::this_thread::yield();
+  }
+  memcpy(sdu->msg, &sn, sizeof(sn));
+  sdu->N_bytes    = len;
+  sdu->md.pdcp_sn = sn;
+  return sdu;
+}
+
+int test_accounting()
+{
+  byte_buffer_spsc_queue q(4);
+  TESTASSERT(q.is_empty());
+  TESTASSERT(q.get_hol_delay().count() == 0);
+
+  for (uint32_t i = 0; i < 4; ++i) {
+    TESTASSERT(q.try_write(make_sdu(i, 10 + i)));
+  }
+  TESTASSERT(q.is_full());
+  TESTASSERT_EQ(4, q.size());
+  TESTASSERT_EQ(46, q.size_bytes());
+  srsran::error_type<unique_byte_buffer_t> ret = q.try_write(make_sdu(4, 14));
+  TESTASSERT(ret.is_error() and ret.error()->md.pdcp_sn == 4);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  TESTASSERT(q.get_hol_delay() >= std::chrono::milliseconds(2));
+
+  // Discard from the middle and from the head
+  TESTASSERT(q.discard_first([](const unique_byte_buffer_t& sdu) { return sdu->md.pdcp_sn == 2; }));
+  TESTASSERT(not q.discard_first([](const unique_byte_buffer_t& sdu) { return sdu->md.pdcp_sn == 2; }));
+  TESTASSERT_EQ(3, q.size());
+  TESTASSERT_EQ(34, q.size_bytes());
+  TESTASSERT(q.discard_first([](const unique_byte_buffer_t& sdu) { return sdu->md.pdcp_sn == 0; }));
+  TESTASSERT_EQ(2, q.size());
+  TESTASSERT_EQ(24, q.size_bytes());
+  TESTASSERT(not q.is_full());
+
+  unique_byte_buffer_t sdu;
+  TESTASSERT(q.try_read(&sdu) and sdu->md.pdcp_sn == 1);
+  TESTASSERT(q.try_read(&sdu) and sdu->md.pdcp_sn == 3);
+  TESTASSERT(not q.try_read(&sdu));
+  TESTASSERT(q.is_empty());
+  TESTASSERT_EQ(0, q.size_bytes());
+  TESTASSERT(q.get_hol_delay().count() == 0);
+
+  // Growing keeps the queued SDUs, shrinking drops the ones that no longer fit
+  for (uint32_t i = 0; i < 4; ++i) {
+    TESTASSERT(q.try_write(make_sdu(i, 100)));
+  }
+  q.resize(8);
+  TESTASSERT_EQ(4, q.size());
+  TESTASSERT(q.try_write(make_sdu(4, 100)));
+  q.resize(2);
+  TESTASSERT_EQ(2, q.size());
+  TESTASSERT_EQ(200, q.size_bytes());
+  TESTASSERT(q.is_full());
+  TESTASSERT(q.read()->md.pdcp_sn == 0);
+  TESTASSERT(q.read()->md.pdcp_sn == 1);
+  TESTASSERT(q.is_empty());
+  return SRSRAN_SUCCESS;
+}
+
+// The producer blocks when the queue is full, the consumer when it is empty, and the state is polled concurrently
+int test_concurrent_writeread(uint32_t nof_sdus)
+{
+  byte_buffer_spsc_queue q(16);
+  std::atomic<bool>      running{true};
+
+  std::thread producer([&q, nof_sdus]() {
+    for (uint32_t i = 0; i < nof_sdus; i++) {
+      q.write(make_sdu(i, 1 + i % 1500));
+    }
+  });
+  std::thread poller([&q, &running]() {
+    while (running) {
+      // The bytes of the queued SDUs are never negative nor more than the ones of a full queue
+      TESTASSERT(q.size() <= 16);
+      TESTASSERT(q.size_bytes() <= 16 * 1500);
+    }
+  });
+
+  int result = SRSRAN_SUCCESS;
+  for (uint32_t i = 0; i < nof_sdus; i++) {
+    unique_byte_buffer_t sdu = q.read();
+    uint32_t             sn  = 0;
+    memcpy(&sn, sdu->msg, sizeof(sn));
+    if (sn != i or sdu->N_bytes != 1 + i % 1500) {
+      result = SRSRAN_ERROR;
+      break;
+    }
+  }
+  producer.join();
+  running = false;
+  poller.join();
+
+  TESTASSERT(result == SRSRAN_SUCCESS);
+  TESTASSERT(q.is_empty());
+  TESTASSERT_EQ(0, q.size_bytes());
+  return SRSRAN_SUCCESS;
+}
+
+// Average time of a write and a read, with a consumer that drains the queue as fast as possible
+template <typename Queue>
+void benchmark(const char* name, uint32_t nof_sdus)
+{
+  Queue             q(1024);
+  std::atomic<bool> running{true};
+  double            read_ns = 0;
+
+  std::thread consumer([&q, &read_ns, nof_sdus]() {
+    unique_byte_buffer_t sdu;
+    auto                 tp = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < nof_sdus; ++i) {
+      while (not q.try_read(&sdu)) {
+        std::this_thread::yield();
+      }
+    }
+    read_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - tp).count() / nof_sdus;
+  });
+  std::thread poller([&q, &running]() {
+    uint64_t sum = 0;
+    while (running) {
+      sum += q.size_bytes();
+      std::this_thread::yield();
+    }
+  });
+
+  auto tp = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_sdus; ++i) {
+    unique_byte_buffer_t sdu = make_sdu(i, 1500);
+    while (sdu != nullptr) {
+      srsran::error_type<unique_byte_buffer_t> ret = q.try_write(std::move(sdu));
+      if (ret.is_error()) {
+        sdu = std::move(ret.error());
+        std::this_thread::yield();
+      }
+    }
+  }
+  double write_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - tp).count() / nof_sdus;
+  consumer.join();
+  running = false;
+  poller.join();
+
+  printf("%s: %.1f ns/write, %.1f ns/read\n", name, write_ns, read_ns);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  bool run_benchmark = false;
+  if (argc > 1 and strcmp(argv[1], "benchmark") == 0) {
+    run_benchmark = true;
+  } else if (argc > 1 and strcmp(argv[1], "test") != 0) {
+    printf("Usage: %s [test|benchmark]\n", argv[0]);
+    return SRSRAN_ERROR;
+  }
+
+  TESTASSERT(test_accounting() == SRSRAN_SUCCESS);
+  TESTASSERT(test_concurrent_writeread(run_benchmark ? 1000000 : 100000) == SRSRAN_SUCCESS);
+
+  if (run_benchmark) {
+    benchmark<byte_buffer_queue>("byte_buffer_queue", 1000000);
+    benchmark<byte_buffer_spsc_queue>("byte_buffer_spsc_queue", 1000000);
+  }
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,247 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Sends datagrams through the loopback interface, between a kernel UDP socket and a datagram_socket of each backend,
+ * and checks their content and addresses. The AF_XDP backend is only tested if the socket can be created, which needs
+ * CAP_NET_ADMIN and CAP_BPF. The fallback to UDP is always checked. In benchmark mode, the rate of datagrams read and
+ * sent by each backend is measured, counting only the time spent in recv() and send().
+ *
+ * Usage: datagram_socket_test [test|benchmark] [interface of the AF_XDP socket, "lo" by default]
+ */
+
+#include "srsran/common/datagram_socket.h"
+#include "srsran/common/network_utils.h"
+#include "srsran/common/test_common.h"
+#include <array>
+#include <chrono>
+#include <poll.h>
+#include <unistd.h>
+
+using namespace srsran;
+
+namespace {
+
+const char*    socket_addr_str = "127.0.3.1";
+const char*    peer_addr_str   = "127.0.3.2";
+const int      socket_port     = 2152;
+const uint32_t pdu_len         = 100;
+
+int open_peer_socket(sockaddr_in* addr)
+{
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  TESTASSERT(fd >= 0);
+  TESTASSERT(net_utils::bind_addr(fd, peer_addr_str, 0, nullptr));
+  socklen_t addrlen = sizeof(*addr);
+  TESTASSERT(getsockname(fd, (sockaddr*)addr, &addrlen) == 0);
+  int bufsize = 4 * 1024 * 1024;
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufsize, sizeof(bufsize));
+  return fd;
+}
+
+void write_pdu(uint8_t* buf, uint32_t sn)
+{
+  memset(buf, sn, pdu_len);
+  memcpy(buf, &sn, sizeof(sn));
+}
+
+// Sends a batch of datagrams from the peer to the socket
+void send_from_peer(int peer_fd, const sockaddr_in& dest, uint32_t first_sn, uint32_t nof_pdus)
+{
+  std::array<uint8_t[pdu_len], MAX_SDU_BATCH_SIZE> bufs;
+  std::array<iovec, MAX_SDU_BATCH_SIZE>            iovs;
+  std::array<mmsghdr, MAX_SDU_BATCH_SIZE>          msgs = {};
+  for (uint32_t i = 0; i < nof_pdus; ++i) {
+    write_pdu(bufs[i], first_sn + i);
+    iovs[i]                     = {bufs[i], pdu_len};
+    msgs[i].msg_hdr.msg_name    = const_cast<sockaddr_in*>(&dest);
+    msgs[i].msg_hdr.msg_namelen = sizeof(dest);
+    msgs[i].msg_hdr.msg_iov     = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen  = 1;
+  }
+  TESTASSERT(sendmmsg(peer_fd, msgs.data(), nof_pdus, 0) == (int)nof_pdus);
+}
+
+// Reads the batch of datagrams sent by the peer, and returns the time spent in recv()
+std::chrono::nanoseconds
+recv_from_peer(datagram_socket& sock, const sockaddr_in& peer_addr, uint32_t first_sn, uint32_t nof_pdus)
+{
+  std::array<unique_byte_buffer_t, MAX_SDU_BATCH_SIZE> pdus;
+  std::array<sockaddr_in, MAX_SDU_BATCH_SIZE>          from;
+  std::chrono::nanoseconds                             elapsed{0};
+  uint32_t                                             nof_recv = 0;
+  while (nof_recv < nof_pdus) {
+    pollfd pfd = {sock.get_fd(), POLLIN, 0};
+    TESTASSERT(poll(&pfd, 1, 1000) == 1);
+    for (auto& pdu : pdus) {
+      pdu = make_byte_buffer();
+    }
+    auto tp = std::chrono::steady_clock::now();
+    int  n  = sock.recv(pdus, from);
+    elapsed += std::chrono::steady_clock::now() - tp;
+    TESTASSERT(n >= 0);
+    for (int i = 0; i < n; ++i) {
+      uint32_t sn;
+      memcpy(&sn, pdus[i]->msg, sizeof(sn));
+      TESTASSERT_EQ(pdu_len, pdus[i]->N_bytes);
+      TESTASSERT_EQ(first_sn + nof_recv, sn);
+      TESTASSERT(from[i].sin_addr.s_addr == peer_addr.sin_addr.s_addr);
+      TESTASSERT(from[i].sin_port == peer_addr.sin_port);
+      nof_recv++;
+    }
+  }
+  return elapsed;
+}
+
+// Sends a batch of datagrams from the socket to the peer, and returns the time spent in send()
+std::chrono::nanoseconds send_to_peer(datagram_socket& sock, const sockaddr_in& peer_addr, uint32_t first_sn)
+{
+  byte_buffer_t pdu;
+  pdu.N_bytes = pdu_len;
+  auto tp     = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < MAX_SDU_BATCH_SIZE; ++i) {
+    write_pdu(pdu.msg, first_sn + i);
+    TESTASSERT(sock.send(pdu, peer_addr));
+  }
+  return std::chrono::steady_clock::now() - tp;
+}
+
+// Reads the batch of datagrams sent by the socket
+void recv_at_peer(int peer_fd, const sockaddr_in& sock_addr, uint32_t first_sn)
+{
+  uint8_t buf[pdu_len + 1];
+  for (uint32_t i = 0; i < MAX_SDU_BATCH_SIZE; ++i) {
+    pollfd pfd = {peer_fd, POLLIN, 0};
+    TESTASSERT(poll(&pfd, 1, 1000) == 1);
+    sockaddr_in from    = {};
+    socklen_t   addrlen = sizeof(from);
+    TESTASSERT(recvfrom(peer_fd, buf, sizeof(buf), 0, (sockaddr*)&from, &addrlen) == pdu_len);
+    uint32_t sn;
+    memcpy(&sn, buf, sizeof(sn));
+    TESTASSERT_EQ(first_sn + i, sn);
+    TESTASSERT(from.sin_addr.s_addr == sock_addr.sin_addr.s_addr);
+    TESTASSERT(from.sin_port == sock_addr.sin_port);
+  }
+}
+
+int test_socket(datagram_socket& sock, uint32_t nof_batches, bool check_tx)
+{
+  sockaddr_in peer_addr;
+  int         peer_fd = open_peer_socket(&peer_addr);
+
+  std::chrono::nanoseconds rx_time{0}, tx_time{0};
+  for (uint32_t i = 0; i < nof_batches; ++i) {
+    // The datagrams received first let the AF_XDP socket learn the MAC address of the peer
+    send_from_peer(peer_fd, sock.get_addr_in(), i * MAX_SDU_BATCH_SIZE, MAX_SDU_BATCH_SIZE);
+    rx_time += recv_from_peer(sock, peer_addr, i * MAX_SDU_BATCH_SIZE, MAX_SDU_BATCH_SIZE);
+    tx_time += send_to_peer(sock, peer_addr, i * MAX_SDU_BATCH_SIZE);
+    if (check_tx) {
+      recv_at_peer(peer_fd, sock.get_addr_in(), i * MAX_SDU_BATCH_SIZE);
+    }
+  }
+  close(peer_fd);
+
+  uint32_t nof_pdus = nof_batches * MAX_SDU_BATCH_SIZE;
+  printf("%s: Rx %.2f Mpps, Tx %.2f Mpps\n",
+         to_string(sock.get_type()),
+         nof_pdus / std::chrono::duration<double, std::micro>(rx_time).count(),
+         nof_pdus / std::chrono::duration<double, std::micro>(tx_time).count());
+  return SRSRAN_SUCCESS;
+}
+
+std::unique_ptr<datagram_socket> open_socket(datagram_socket_type type, const char* if_name)
+{
+  datagram_socket_args_t args;
+  args.type        = type;
+  args.bind_addr   = socket_addr_str;
+  args.bind_port   = socket_port;
+  args.xdp_if_name = if_name;
+  return make_datagram_socket(args, srslog::fetch_basic_logger("TEST"));
+}
+
+int test_udp(uint32_t nof_batches)
+{
+  std::unique_ptr<datagram_socket> sock = open_socket(datagram_socket_type::udp, "");
+  TESTASSERT(sock != nullptr and sock->get_type() == datagram_socket_type::udp);
+  TESTASSERT(sock->get_addr_in().sin_port == htons(socket_port));
+  return test_socket(*sock, nof_batches, true);
+}
+
+// The frames that the AF_XDP socket sends through "lo" do not carry the route of the locally generated packets, so the
+// kernel drops them as martians unless the route of 127.0.0.0/8 packets received through "lo" is allowed
+bool is_route_localnet_enabled()
+{
+  FILE* f = fopen("/proc/sys/net/ipv4/conf/lo/route_localnet", "r");
+  int   v = 0;
+  if (f != nullptr) {
+    if (fscanf(f, "%d", &v) != 1) {
+      v = 0;
+    }
+    fclose(f);
+  }
+  return v != 0;
+}
+
+int test_af_xdp(uint32_t nof_batches, const char* if_name)
+{
+  // Falls back to UDP if the interface does not exist
+  std::unique_ptr<datagram_socket> sock = open_socket(datagram_socket_type::af_xdp, "srsran_no_if");
+  TESTASSERT(sock != nullptr and sock->get_type() == datagram_socket_type::udp);
+  sock.reset();
+
+  sock = open_socket(datagram_socket_type::af_xdp, if_name);
+  TESTASSERT(sock != nullptr);
+  if (sock->get_type() != datagram_socket_type::af_xdp) {
+    printf("AF_XDP socket not available on %s, skipping its test\n", if_name);
+    return SRSRAN_SUCCESS;
+  }
+  bool check_tx = strcmp(if_name, "lo") != 0 or is_route_localnet_enabled();
+  if (not check_tx) {
+    printf("Not checking the datagrams sent through lo, which needs net.ipv4.conf.lo.route_localnet=1\n");
+  }
+  return test_socket(*sock, nof_batches, check_tx);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  srslog::init();
+  srslog::fetch_basic_logger("TEST").set_level(srslog::basic_levels::info);
+
+  uint32_t nof_batches;
+  if (argc == 1 or strcmp(argv[1], "test") == 0) {
+    nof_batches = 10;
+  } else if (strcmp(argv[1], "benchmark") == 0) {
+    nof_batches = 100000;
+  } else {
+    printf("Usage: %s [test|benchmark] [interface]\n", argv[0]);
+    return SRSRAN_ERROR;
+  }
+  const char* if_name = argc > 2 ? argv[2] : "lo";
+
+  TESTASSERT(test_udp(nof_batches) == SRSRAN_SUCCESS);
+  TESTASSERT(test_af_xdp(nof_batches, if_name) == SRSRAN_SUCCESS);
+
+  srslog::flush();
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
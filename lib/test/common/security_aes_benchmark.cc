@@ -0,0 +1,198 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Tests the precomputed-key 128-EEA2/128-EIA2 against the reference liblte implementation, for the software and the
+ * hardware AES backends, and measures their throughput for PDCP PDU sizes.
+ *
+ * Usage: security_aes_benchmark [test|benchmark]
+ */
+
+#include "srsran/common/liblte_security.h"
+#include "srsran/common/security.h"
+#include "srsran/common/test_common.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace srsran;
+
+static std::mt19937 rgen(0);
+
+static void fill_random(uint8_t* buf, uint32_t len)
+{
+  std::uniform_int_distribution<int> dist(0, 255);
+  for (uint32_t i = 0; i < len; ++i) {
+    buf[i] = dist(rgen);
+  }
+}
+
+int test_against_reference(bool use_hw)
+{
+  security_aes128_key  key;
+  uint8_t              key_bytes[16];
+  std::vector<uint8_t> msg(1600), out(1600), ref(1600);
+
+  for (uint32_t len = 0; len < msg.size(); len += (len < 100 ? 1 : 37)) {
+    fill_random(key_bytes, sizeof(key_bytes));
+    fill_random(msg.data(), len);
+    key.set_key(key_bytes, use_hw);
+    uint32_t count     = rgen();
+    uint8_t  bearer    = rgen() % 32;
+    uint8_t  direction = rgen() % 2;
+
+    // 128-EEA2
+    if (len > 0) {
+      TESTASSERT(liblte_security_encryption_eea2(
+                     key_bytes, count, bearer, direction, msg.data(), len * 8, ref.data()) == LIBLTE_SUCCESS);
+      TESTASSERT(security_128_eea2(key, count, bearer, direction, msg.data(), len, out.data()) == SRSRAN_SUCCESS);
+      TESTASSERT(memcmp(ref.data(), out.data(), len) == 0);
+      // In-place decryption
+      TESTASSERT(security_128_eea2(key, count, bearer, direction, out.data(), len, out.data()) == SRSRAN_SUCCESS);
+      TESTASSERT(memcmp(msg.data(), out.data(), len) == 0);
+    }
+
+    // 128-EIA2
+    uint8_t mac_ref[4] = {}, mac[4] = {};
+    TESTASSERT(liblte_security_128_eia2(key_bytes, count, bearer, direction, msg.data(), len, mac_ref) ==
+               LIBLTE_SUCCESS);
+    TESTASSERT(security_128_eia2(key, count, bearer, direction, msg.data(), len, mac) == SRSRAN_SUCCESS);
+    TESTASSERT(memcmp(mac_ref, mac, sizeof(mac)) == 0);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+/// 33.401 Annex C.1, 128-EEA2 test set 3 (byte-aligned)
+int test_set_3()
+{
+  uint8_t  key_bytes[] = {0x0a, 0x8b, 0x6b, 0xd8, 0xd9, 0xb0, 0x8b, 0x08, 0xd6, 0x4e, 0x32, 0xd1, 0x81, 0x77, 0x77, 0xfb};
+  uint32_t count       = 0x544d49cd;
+  uint8_t  bearer      = 0x04;
+  uint8_t  direction   = 0;
+  uint8_t  msg[]       = {0xfd, 0x40, 0xa4, 0x1d, 0x37, 0x0a, 0x1f, 0x65, 0x74, 0x50, 0x95, 0x68, 0x7d, 0x47, 0xba, 0x1d,
+                   0x36, 0xd2, 0x34, 0x9e, 0x23, 0xf6, 0x44, 0x39, 0x2c, 0x8e, 0xa9, 0xc4, 0x9d, 0x40, 0xc1, 0x32,
+                   0x71, 0xaf, 0xf2, 0x64, 0xd0, 0xf2, 0x48, 0x00};
+  uint8_t  ct[]        = {0x75, 0x75, 0x0d, 0x37, 0xb4, 0xbb, 0xa2, 0xa4, 0xde, 0xdb, 0x34, 0x23, 0x5b, 0xd6, 0x8c, 0x66,
+                  0x45, 0xac, 0xda, 0xac, 0xa4, 0x81, 0x38, 0xa3, 0xb0, 0xc4, 0x71, 0xe2, 0xa7, 0x04, 0x1a, 0x57,
+                  0x64, 0x23, 0xd2, 0x92, 0x72, 0x87, 0xf0, 0x00};
+  uint32_t len_bits = 310, len_bytes = (len_bits + 7) / 8;
+  uint8_t  out[sizeof(msg)];
+
+  for (bool use_hw : {false, true}) {
+    security_aes128_key key;
+    key.set_key(key_bytes, use_hw);
+    TESTASSERT(security_128_eea2(key, count, bearer, direction, msg, len_bytes, out) == SRSRAN_SUCCESS);
+    // The last byte holds the 6 tailing bits of the message
+    TESTASSERT(memcmp(ct, out, len_bytes - 1) == 0);
+    TESTASSERT((out[len_bytes - 1] & 0xfc) == ct[len_bytes - 1]);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+struct bench_result {
+  double eea2_gbps;
+  double eia2_gbps;
+};
+
+template <typename EncFunc, typename MacFunc>
+bench_result run_benchmark(uint32_t pdu_len, uint32_t nof_pdus, const EncFunc& enc, const MacFunc& mac)
+{
+  std::vector<uint8_t> msg(pdu_len), out(pdu_len);
+  fill_random(msg.data(), pdu_len);
+  uint8_t      mac_out[4];
+  bench_result result;
+
+  auto tp = std::chrono::steady_clock::now();
+  for (uint32_t count = 0; count < nof_pdus; ++count) {
+    enc(count, msg.data(), pdu_len, out.data());
+  }
+  double t         = std::chrono::duration<double>(std::chrono::steady_clock::now() - tp).count();
+  result.eea2_gbps = nof_pdus * pdu_len * 8 / t * 1e-9;
+
+  tp = std::chrono::steady_clock::now();
+  for (uint32_t count = 0; count < nof_pdus; ++count) {
+    mac(count, msg.data(), pdu_len, mac_out);
+  }
+  t                = std::chrono::duration<double>(std::chrono::steady_clock::now() - tp).count();
+  result.eia2_gbps = nof_pdus * pdu_len * 8 / t * 1e-9;
+  return result;
+}
+
+int run_benchmark(uint32_t total_bytes)
+{
+  uint8_t key_bytes[16];
+  fill_random(key_bytes, sizeof(key_bytes));
+  security_aes128_key key_sw, key_hw;
+  key_sw.set_key(key_bytes, false);
+  key_hw.set_key(key_bytes, true);
+  const uint8_t bearer = 1, direction = 1;
+
+  printf("AES backend: %s\n", security_aes_backend());
+  printf("%8s %-24s %10s %10s\n", "PDU size", "implementation", "EEA2 Gbps", "EIA2 Gbps");
+  for (uint32_t pdu_len : {64, 256, 1500, 9000}) {
+    uint32_t     nof_pdus = std::max(total_bytes / pdu_len, 1u);
+    bench_result ref      = run_benchmark(
+        pdu_len,
+        nof_pdus,
+        [&](uint32_t count, uint8_t* msg, uint32_t len, uint8_t* out) {
+          liblte_security_encryption_eea2(key_bytes, count, bearer, direction, msg, len * 8, out);
+        },
+        [&](uint32_t count, uint8_t* msg, uint32_t len, uint8_t* mac) {
+          liblte_security_128_eia2(key_bytes, count, bearer, direction, msg, len, mac);
+        });
+    printf("%8d %-24s %10.2f %10.2f\n", pdu_len, "key schedule per PDU", ref.eea2_gbps, ref.eia2_gbps);
+
+    for (const security_aes128_key* key : {&key_sw, &key_hw}) {
+      bench_result res = run_benchmark(
+          pdu_len,
+          nof_pdus,
+          [&](uint32_t count, uint8_t* msg, uint32_t len, uint8_t* out) {
+            security_128_eea2(*key, count, bearer, direction, msg, len, out);
+          },
+          [&](uint32_t count, uint8_t* msg, uint32_t len, uint8_t* mac) {
+            security_128_eia2(*key, count, bearer, direction, msg, len, mac);
+          });
+      printf("%8d %-24s %10.2f %10.2f\n",
+             pdu_len,
+             key->is_hw_accelerated() ? "precomputed, hw AES" : "precomputed, sw AES",
+             res.eea2_gbps,
+             res.eia2_gbps);
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc == 1 or strcmp(argv[1], "test") == 0) {
+    TESTASSERT(test_set_3() == SRSRAN_SUCCESS);
+    TESTASSERT(test_against_reference(false) == SRSRAN_SUCCESS);
+    TESTASSERT(test_against_reference(true) == SRSRAN_SUCCESS);
+    TESTASSERT(run_benchmark(1000000) == SRSRAN_SUCCESS);
+  } else if (strcmp(argv[1], "benchmark") == 0) {
+    TESTASSERT(run_benchmark(1000000000) == SRSRAN_SUCCESS);
+  } else {
+    printf("Usage: %s [test|benchmark]\n", argv[0]);
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,271 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Tests the batch 128-EEA1/EEA3/EIA1/EIA3 against the liblte implementation, for batches of PDUs with different keys,
+ * bearers and lengths, and measures their throughput.
+ *
+ * Usage: security_batch_benchmark [test|benchmark]
+ */
+
+#include "srsran/common/liblte_security.h"
+#include "srsran/common/security.h"
+#include "srsran/common/test_common.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace srsran;
+
+static std::mt19937 rgen(0);
+
+static void fill_random(uint8_t* buf, uint32_t len)
+{
+  std::uniform_int_distribution<int> dist(0, 255);
+  for (uint32_t i = 0; i < len; ++i) {
+    buf[i] = dist(rgen);
+  }
+}
+
+struct test_pdu {
+  uint8_t              key[16];
+  uint32_t             count;
+  uint8_t              bearer;
+  uint8_t              direction;
+  std::vector<uint8_t> msg, out, ref;
+  uint8_t              mac[4], mac_ref[4];
+};
+
+static std::vector<test_pdu> make_pdus(uint32_t nof_pdus, uint32_t max_len)
+{
+  std::vector<test_pdu> pdus(nof_pdus);
+  for (test_pdu& pdu : pdus) {
+    uint32_t len = rgen() % (max_len + 1);
+    fill_random(pdu.key, sizeof(pdu.key));
+    pdu.count     = rgen();
+    pdu.bearer    = rgen() % 32;
+    pdu.direction = rgen() % 2;
+    // The liblte functions reject a null message, even if empty
+    pdu.msg.reserve(max_len + 1);
+    pdu.msg.resize(len);
+    pdu.out.resize(len);
+    pdu.ref.resize(len);
+    fill_random(pdu.msg.data(), len);
+  }
+  return pdus;
+}
+
+static std::vector<security_batch_pdu_t> make_batch(std::vector<test_pdu>& pdus, bool mac, bool in_place)
+{
+  std::vector<security_batch_pdu_t> batch;
+  for (test_pdu& pdu : pdus) {
+    uint8_t* out = mac ? pdu.mac : pdu.out.data();
+    batch.push_back({pdu.key,
+                     pdu.count,
+                     pdu.bearer,
+                     pdu.direction,
+                     in_place ? pdu.out.data() : pdu.msg.data(),
+                     (uint32_t)pdu.msg.size(),
+                     out});
+  }
+  return batch;
+}
+
+int test_cipher(bool eea3, bool in_place)
+{
+  for (uint32_t nof_pdus = 1; nof_pdus <= 9; ++nof_pdus) {
+    std::vector<test_pdu> pdus = make_pdus(nof_pdus, nof_pdus % 2 ? 100 : 1600);
+    for (test_pdu& pdu : pdus) {
+      if (pdu.msg.empty()) {
+        continue;
+      }
+      auto     enc      = eea3 ? liblte_security_encryption_eea3 : liblte_security_encryption_eea1;
+      uint32_t len_bits = pdu.msg.size() * 8;
+      TESTASSERT(enc(pdu.key, pdu.count, pdu.bearer, pdu.direction, pdu.msg.data(), len_bits, pdu.ref.data()) ==
+                 LIBLTE_SUCCESS);
+      pdu.out = pdu.msg;
+    }
+
+    std::vector<security_batch_pdu_t> batch = make_batch(pdus, false, in_place);
+
+    uint8_t ret = eea3 ? security_128_eea3_batch(batch.data(), batch.size())
+                       : security_128_eea1_batch(batch.data(), batch.size());
+    TESTASSERT(ret == SRSRAN_SUCCESS);
+    for (test_pdu& pdu : pdus) {
+      TESTASSERT(pdu.out == pdu.ref);
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int test_integrity(bool eia3)
+{
+  for (uint32_t nof_pdus = 1; nof_pdus <= 9; ++nof_pdus) {
+    std::vector<test_pdu> pdus = make_pdus(nof_pdus, nof_pdus % 2 ? 100 : 1600);
+    for (test_pdu& pdu : pdus) {
+      if (eia3) {
+        liblte_security_128_eia3(
+            pdu.key, pdu.count, pdu.bearer, pdu.direction, pdu.msg.data(), pdu.msg.size() * 8, pdu.mac_ref);
+      } else {
+        liblte_security_128_eia1(
+            pdu.key, pdu.count, pdu.bearer, pdu.direction, pdu.msg.data(), pdu.msg.size(), pdu.mac_ref);
+      }
+    }
+
+    std::vector<security_batch_pdu_t> batch = make_batch(pdus, true, false);
+
+    uint8_t ret = eia3 ? security_128_eia3_batch(batch.data(), batch.size())
+                       : security_128_eia1_batch(batch.data(), batch.size());
+    TESTASSERT(ret == SRSRAN_SUCCESS);
+    for (test_pdu& pdu : pdus) {
+      TESTASSERT(memcmp(pdu.mac, pdu.mac_ref, sizeof(pdu.mac)) == 0);
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+/// First 48 bytes of 33.401 Annex C.3 128-EEA3 test set 3, as the first and last PDUs of a batch
+int test_eea3_set_3()
+{
+  uint8_t  key[]     = {0xd4, 0x55, 0x2a, 0x8f, 0xd6, 0xe6, 0x1c, 0xc8, 0x1a, 0x20, 0x09, 0x14, 0x1a, 0x29, 0xc1, 0x0b};
+  uint32_t count     = 0x76452ec1;
+  uint8_t  bearer    = 0x2;
+  uint8_t  direction = 0x1;
+  uint8_t  msg[]     = {0x38, 0xf0, 0x7f, 0x4b, 0xe2, 0xd8, 0xff, 0x58, 0x05, 0xf5, 0x13, 0x22, 0x29, 0xbd, 0xe9, 0x3b,
+                       0xbb, 0xdc, 0xaf, 0x38, 0x2b, 0xf1, 0xee, 0x97, 0x2f, 0xbf, 0x99, 0x77, 0xba, 0xda, 0x89, 0x45,
+                       0x84, 0x7a, 0x2a, 0x6c, 0x9a, 0xd3, 0x4a, 0x66, 0x75, 0x54, 0xe0, 0x4d, 0x1f, 0x7f, 0xa2, 0xc3};
+  uint8_t  ct[]      = {0x83, 0x83, 0xb0, 0x22, 0x9f, 0xcc, 0x0b, 0x9d, 0x22, 0x95, 0xec, 0x41, 0xc9, 0x77, 0xe9, 0xc2,
+                       0xbb, 0x72, 0xe2, 0x20, 0x37, 0x81, 0x41, 0xf9, 0xc8, 0x31, 0x8f, 0x3a, 0x27, 0x0d, 0xfb, 0xcd,
+                       0xee, 0x64, 0x11, 0xc2, 0xb3, 0x04, 0x4f, 0x17, 0x6d, 0xc6, 0xe0, 0x0f, 0x89, 0x60, 0xf9, 0x7a};
+
+  uint8_t other_key[16] = {};
+  uint8_t out[3][sizeof(msg)];
+
+  security_batch_pdu_t batch[] = {{key, count, bearer, direction, msg, sizeof(msg), out[0]},
+                                  {other_key, 0, 0, 0, msg, sizeof(msg), out[1]},
+                                  {key, count, bearer, direction, msg, sizeof(msg), out[2]}};
+  TESTASSERT(security_128_eea3_batch(batch, 3) == SRSRAN_SUCCESS);
+  TESTASSERT(memcmp(out[0], ct, sizeof(ct)) == 0);
+  TESTASSERT(memcmp(out[2], ct, sizeof(ct)) == 0);
+  return SRSRAN_SUCCESS;
+}
+
+enum class algo { eea1, eea3, eia1, eia3 };
+
+double run_benchmark(algo a, uint32_t pdu_len, uint32_t nof_pdus, uint32_t batch_size)
+{
+  std::vector<test_pdu> pdus = make_pdus(batch_size, 0);
+  for (test_pdu& pdu : pdus) {
+    pdu.msg.resize(pdu_len);
+    pdu.out.resize(pdu_len);
+    fill_random(pdu.msg.data(), pdu_len);
+  }
+  std::vector<security_batch_pdu_t> batch = make_batch(pdus, a == algo::eia1 or a == algo::eia3, false);
+
+  auto tp = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < nof_pdus; n += batch_size) {
+    for (security_batch_pdu_t& pdu : batch) {
+      pdu.count = n;
+    }
+    switch (a) {
+      case algo::eea1:
+        security_128_eea1_batch(batch.data(), batch.size());
+        break;
+      case algo::eea3:
+        security_128_eea3_batch(batch.data(), batch.size());
+        break;
+      case algo::eia1:
+        security_128_eia1_batch(batch.data(), batch.size());
+        break;
+      case algo::eia3:
+        security_128_eia3_batch(batch.data(), batch.size());
+        break;
+    }
+  }
+  double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - tp).count();
+  return nof_pdus * (double)pdu_len * 8 / t * 1e-9;
+}
+
+double run_reference_benchmark(algo a, uint32_t pdu_len, uint32_t nof_pdus)
+{
+  std::vector<uint8_t> msg(pdu_len), out(pdu_len);
+  uint8_t              key[16], mac[4];
+  fill_random(key, sizeof(key));
+  fill_random(msg.data(), pdu_len);
+
+  auto tp = std::chrono::steady_clock::now();
+  for (uint32_t count = 0; count < nof_pdus; ++count) {
+    switch (a) {
+      case algo::eea1:
+        liblte_security_encryption_eea1(key, count, 1, 1, msg.data(), pdu_len * 8, out.data());
+        break;
+      case algo::eea3:
+        liblte_security_encryption_eea3(key, count, 1, 1, msg.data(), pdu_len * 8, out.data());
+        break;
+      case algo::eia1:
+        liblte_security_128_eia1(key, count, 1, 1, msg.data(), pdu_len, mac);
+        break;
+      case algo::eia3:
+        liblte_security_128_eia3(key, count, 1, 1, msg.data(), pdu_len * 8, mac);
+        break;
+    }
+  }
+  double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - tp).count();
+  return nof_pdus * (double)pdu_len * 8 / t * 1e-9;
+}
+
+int run_benchmark(uint32_t total_bytes)
+{
+  const char* names[] = {"EEA1", "EEA3", "EIA1", "EIA3"};
+  printf("%8s %-6s %12s %12s %12s\n", "PDU size", "algo", "liblte Gbps", "single Gbps", "batch Gbps");
+  for (uint32_t pdu_len : {64, 256, 1500}) {
+    uint32_t nof_pdus = std::max(total_bytes / pdu_len, 16u);
+    for (algo a : {algo::eea1, algo::eea3, algo::eia1, algo::eia3}) {
+      printf("%8d %-6s %12.3f %12.3f %12.3f\n",
+             pdu_len,
+             names[(int)a],
+             run_reference_benchmark(a, pdu_len, nof_pdus),
+             run_benchmark(a, pdu_len, nof_pdus, 1),
+             run_benchmark(a, pdu_len, nof_pdus, 16));
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc == 1 or strcmp(argv[1], "test") == 0) {
+    TESTASSERT(test_eea3_set_3() == SRSRAN_SUCCESS);
+    for (bool eea3 : {false, true}) {
+      TESTASSERT(test_cipher(eea3, false) == SRSRAN_SUCCESS);
+      TESTASSERT(test_cipher(eea3, true) == SRSRAN_SUCCESS);
+      TESTASSERT(test_integrity(eea3) == SRSRAN_SUCCESS);
+    }
+    TESTASSERT(run_benchmark(100000) == SRSRAN_SUCCESS);
+  } else if (strcmp(argv[1], "benchmark") == 0) {
+    TESTASSERT(run_benchmark(100000000) == SRSRAN_SUCCESS);
+  } else {
+    printf("Usage: %s [test|benchmark]\n", argv[0]);
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
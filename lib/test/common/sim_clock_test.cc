@@ -0,0 +1,74 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/sim_clock.h"
+#include "srsran/common/test_common.h"
+#include <thread>
+
+using srsran::sim_clock;
+
+int test_wall_time()
+{
+  TESTASSERT(not sim_clock::is_virtual_time());
+  sim_clock::time_point t1 = sim_clock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  TESTASSERT(sim_clock::now() - t1 >= std::chrono::milliseconds(2));
+
+  // the radio time is ignored until the virtual time is enabled
+  sim_clock::advance_to(std::chrono::hours(1000));
+  TESTASSERT(sim_clock::now() - t1 < std::chrono::hours(1));
+  return SRSRAN_SUCCESS;
+}
+
+int test_virtual_time()
+{
+  sim_clock::enable_virtual_time();
+  TESTASSERT(sim_clock::is_virtual_time());
+  TESTASSERT(sim_clock::now().time_since_epoch().count() == 0);
+
+  // the time only moves with the radio, and never goes back
+  sim_clock::advance_to(std::chrono::milliseconds(5));
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  TESTASSERT(sim_clock::now().time_since_epoch() == std::chrono::milliseconds(5));
+  sim_clock::advance_to(std::chrono::milliseconds(3));
+  TESTASSERT(sim_clock::now().time_since_epoch() == std::chrono::milliseconds(5));
+
+  // concurrent updates keep the latest time
+  std::thread t([]() {
+    for (int i = 0; i < 100000; ++i) {
+      sim_clock::advance_to(std::chrono::microseconds(2 * i));
+    }
+  });
+  for (int i = 0; i < 100000; ++i) {
+    sim_clock::advance_to(std::chrono::microseconds(2 * i + 1));
+  }
+  t.join();
+  TESTASSERT(sim_clock::now().time_since_epoch() == std::chrono::microseconds(199999));
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_wall_time() == SRSRAN_SUCCESS);
+  TESTASSERT(test_virtual_time() == SRSRAN_SUCCESS);
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,515 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Tests that the packets of synthetic VoIP (RTP), UDP, TCP and IPv6 traces are restored bit-exact by the ROHC
+ * decompressor (TCP and IPv6 with the uncompressed profile), with random losses, burst losses and more flows than
+ * contexts, and through a pair of LTE PDCP DRB entities. In benchmark mode, it also measures the compression and
+ * decompression rate and the compression ratio of each trace.
+ *
+ * Usage: pdcp_rohc_test [test|benchmark]
+ */
+
+#include "pdcp_base_test.h"
+#include "srsran/test/ue_test_interfaces.h"
+#include "srsran/upper/pdcp_entity_lte.h"
+#include "srsran/upper/pdcp_rohc.h"
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace srsran;
+
+namespace {
+
+std::mt19937 rgen(0);
+
+using packet_t = std::vector<uint8_t>;
+
+void put16(packet_t& p, uint32_t pos, uint16_t v)
+{
+  p[pos]     = v >> 8u;
+  p[pos + 1] = v & 0xffu;
+}
+
+void put32(packet_t& p, uint32_t pos, uint32_t v)
+{
+  put16(p, pos, v >> 16u);
+  put16(p, pos + 2, v & 0xffffu);
+}
+
+packet_t make_ipv4(uint8_t proto, uint32_t l4_len, uint16_t ip_id, bool df, uint32_t flow)
+{
+  packet_t p(20 + l4_len);
+  p[0] = 0x45;
+  put16(p, 2, p.size());
+  put16(p, 4, ip_id);
+  put16(p, 6, df ? 0x4000 : 0);
+  p[8] = 64;
+  p[9] = proto;
+  put32(p, 12, 0x0a2d0001 + flow);
+  put32(p, 16, 0xc0a80a01);
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < 20; i += 2) {
+    sum += (p[i] << 8u) | p[i + 1];
+  }
+  sum = (sum & 0xffffu) + (sum >> 16u);
+  sum = (sum & 0xffffu) + (sum >> 16u);
+  put16(p, 10, ~sum);
+  for (uint32_t i = 20; i < p.size(); ++i) {
+    p[i] = rgen();
+  }
+  return p;
+}
+
+packet_t make_udp(uint32_t payload_len, uint16_t ip_id, bool df, uint16_t port, uint32_t flow, bool checksum)
+{
+  packet_t p = make_ipv4(17, 8 + payload_len, ip_id, df, flow);
+  put16(p, 20, port);
+  put16(p, 22, port);
+  put16(p, 24, 8 + payload_len);
+  put16(p, 26, checksum ? rgen() | 1u : 0);
+  return p;
+}
+
+/// G.711 call with 20 ms frames and silence suppression: talkspurts start with the marker bit set, and the RTP TS
+/// jumps over the silence periods while the SN does not
+std::vector<packet_t> voip_trace(uint32_t nof_pkts, uint32_t flow = 0)
+{
+  std::vector<packet_t> trace;
+  uint16_t              sn    = rgen();
+  uint32_t              ts    = rgen();
+  uint16_t              ip_id = rgen();
+  uint32_t              ssrc  = rgen();
+  while (trace.size() < nof_pkts) {
+    uint32_t talkspurt = 20 + rgen() % 150;
+    for (uint32_t i = 0; i < talkspurt and trace.size() < nof_pkts; ++i) {
+      packet_t p = make_udp(12 + 160, ip_id++, false, 16384 + 2 * flow, flow, true);
+      p[28]      = 0x80;
+      p[29]      = (i == 0 ? 0x80 : 0) | 0; // PCMU
+      put16(p, 30, sn++);
+      put32(p, 32, ts);
+      put32(p, 36, ssrc);
+      ts += 160;
+      trace.push_back(std::move(p));
+    }
+    ts += 160 * (10 + rgen() % 40);
+  }
+  return trace;
+}
+
+/// Periodic sensor reports without UDP checksum, with DF set and a zero IP-ID, i.e. non-sequential
+std::vector<packet_t> udp_trace(uint32_t nof_pkts)
+{
+  std::vector<packet_t> trace;
+  for (uint32_t i = 0; i < nof_pkts; ++i) {
+    trace.push_back(make_udp(20 + rgen() % 60, 0, true, 5683, 0, false));
+  }
+  return trace;
+}
+
+/// ACKs of a bulk download, with the timestamp option, and a few data segments with PSH set in between. Sent with the
+/// uncompressed profile
+std::vector<packet_t> tcp_trace(uint32_t nof_pkts)
+{
+  std::vector<packet_t> trace;
+  uint32_t              seq    = rgen();
+  uint32_t              ack    = rgen();
+  uint32_t              tsval  = rgen();
+  uint16_t              ip_id  = rgen();
+  uint16_t              window = 501;
+  for (uint32_t i = 0; i < nof_pkts; ++i) {
+    bool     data = i % 50 == 49;
+    packet_t p    = make_ipv4(6, 32 + (data ? 100 : 0), ip_id++, true, 0);
+    put16(p, 20, 40000);
+    put16(p, 22, 443);
+    put32(p, 24, seq);
+    put32(p, 28, ack);
+    p[32] = 8u << 4u;
+    p[33] = data ? 0x18 : 0x10;
+    put16(p, 34, window);
+    put16(p, 36, rgen());
+    put16(p, 38, 0);
+    p[40] = 1;
+    p[41] = 1;
+    p[42] = 8;
+    p[43] = 10;
+    put32(p, 44, tsval);
+    put32(p, 48, 0x12345678);
+    seq += data ? 100 : 0;
+    ack += 2 * 1448;
+    tsval += i % 4 == 0 ? 1 : 0;
+    window += i % 100 == 0 ? 32 : 0;
+    trace.push_back(std::move(p));
+  }
+  return trace;
+}
+
+/// IPv6 packets, sent with the uncompressed profile
+std::vector<packet_t> ipv6_trace(uint32_t nof_pkts)
+{
+  std::vector<packet_t> trace;
+  for (uint32_t i = 0; i < nof_pkts; ++i) {
+    packet_t p(40 + rgen() % 200);
+    for (uint8_t& b : p) {
+      b = rgen();
+    }
+    p[0] = 0x60;
+    trace.push_back(std::move(p));
+  }
+  return trace;
+}
+
+pdcp_rohc_config_t make_rohc_cfg(uint16_t max_cid = 15)
+{
+  pdcp_rohc_config_t cfg;
+  cfg.enabled     = true;
+  cfg.max_cid     = max_cid;
+  cfg.profile_rtp = true;
+  cfg.profile_udp = true;
+  return cfg;
+}
+
+unique_byte_buffer_t to_buffer(const packet_t& p)
+{
+  unique_byte_buffer_t buf = make_byte_buffer();
+  memcpy(buf->msg, p.data(), p.size());
+  buf->N_bytes = p.size();
+  return buf;
+}
+
+bool is_equal(const unique_byte_buffer_t& buf, const packet_t& p)
+{
+  return buf->N_bytes == p.size() and memcmp(buf->msg, p.data(), p.size()) == 0;
+}
+
+struct trace_result_t {
+  uint32_t nof_lost      = 0;
+  uint32_t nof_delivered = 0;
+  uint32_t nof_mismatch  = 0;
+};
+
+/// Compresses and decompresses all the packets, except the ones for which lost(i) returns true
+template <typename F>
+trace_result_t run_trace(const std::vector<packet_t>& trace,
+                         rohc_compressor&             comp,
+                         rohc_decompressor&           decomp,
+                         const F&                     lost)
+{
+  trace_result_t r;
+  for (uint32_t i = 0; i < trace.size(); ++i) {
+    unique_byte_buffer_t buf = to_buffer(trace[i]);
+    TESTASSERT(comp.compress(buf.get()));
+    if (lost(i)) {
+      r.nof_lost++;
+      continue;
+    }
+    if (decomp.decompress(buf.get())) {
+      r.nof_delivered++;
+      r.nof_mismatch += is_equal(buf, trace[i]) ? 0 : 1;
+    }
+  }
+  return r;
+}
+
+int test_trace(const char* name, const std::vector<packet_t>& trace, double max_ratio)
+{
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("PDCP");
+  pdcp_rohc_config_t    cfg    = make_rohc_cfg();
+
+  // Without losses, all packets are delivered
+  {
+    rohc_compressor   comp(cfg, logger);
+    rohc_decompressor decomp(cfg, logger);
+    trace_result_t    r = run_trace(trace, comp, decomp, [](uint32_t i) { return false; });
+    TESTASSERT_EQ(trace.size(), r.nof_delivered);
+    TESTASSERT_EQ(0, r.nof_mismatch);
+
+    pdcp_rohc_metrics_t m     = comp.get_metrics();
+    double              ratio = m.orig_hdr_bytes > 0 ? (double)m.rohc_hdr_bytes / m.orig_hdr_bytes : 0;
+    printf("%s: %" PRIu64 " IR, %" PRIu64 " IR-DYN, header bytes %" PRIu64 " -> %" PRIu64 " (%.1f%%)\n",
+           name,
+           m.nof_ir,
+           m.nof_ir_dyn,
+           m.orig_hdr_bytes,
+           m.rohc_hdr_bytes,
+           100 * ratio);
+    TESTASSERT(ratio <= max_ratio);
+    TESTASSERT_EQ(m.nof_ir, decomp.get_metrics().nof_ir);
+    TESTASSERT_EQ(0, decomp.get_metrics().nof_dropped);
+  }
+
+  // With 10% of random losses, the packets that are delivered are restored bit-exact
+  {
+    rohc_compressor   comp(cfg, logger);
+    rohc_decompressor decomp(cfg, logger);
+    trace_result_t    r = run_trace(trace, comp, decomp, [](uint32_t i) { return rgen() % 10 == 0; });
+    TESTASSERT_EQ(0, r.nof_mismatch);
+    TESTASSERT(r.nof_delivered >= 0.95 * (trace.size() - r.nof_lost));
+  }
+  return SRSRAN_SUCCESS;
+}
+
+// The SN wraps around the 4-bit interpretation interval when 16 or more packets are lost in a row. The context is
+// repaired if fewer than 32 were lost, and a longer burst is recovered from the next IR at the latest
+int test_burst_loss()
+{
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("PDCP");
+  pdcp_rohc_config_t    cfg    = make_rohc_cfg();
+  std::vector<packet_t> trace  = voip_trace(3000);
+
+  for (uint32_t burst : {20, 100}) {
+    rohc_compressor   comp(cfg, logger);
+    rohc_decompressor decomp(cfg, logger);
+
+    // Lose a burst within a talkspurt, so that the packet after it is sent with UO-0
+    auto get_ts = [&trace](uint32_t i) {
+      return (uint32_t)(trace[i][32] << 24u | trace[i][33] << 16u | trace[i][34] << 8u | trace[i][35]);
+    };
+    uint32_t start = 1000;
+    while (get_ts(start + burst + 2) - get_ts(start - 3) != 160 * (burst + 5)) {
+      start++;
+    }
+    trace_result_t r = run_trace(
+        trace, comp, decomp, [start, burst](uint32_t i) { return i > start and i <= start + burst; });
+    TESTASSERT_EQ(0, r.nof_mismatch);
+    TESTASSERT_EQ(burst, r.nof_lost);
+    if (burst < 32) {
+      TESTASSERT_EQ(1, decomp.get_metrics().nof_repairs);
+      TESTASSERT_EQ(trace.size() - burst, r.nof_delivered);
+    } else {
+      TESTASSERT(r.nof_delivered >= trace.size() - burst - rohc_ir_refresh);
+      TESTASSERT(r.nof_delivered < trace.size() - burst);
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+// More flows than contexts: the least recently used context is replaced, and the packets are still restored
+int test_context_replacement()
+{
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("PDCP");
+  pdcp_rohc_config_t    cfg    = make_rohc_cfg(1);
+
+  std::vector<std::vector<packet_t> > flows;
+  for (uint32_t f = 0; f < 3; ++f) {
+    flows.push_back(voip_trace(200, f));
+  }
+  std::vector<packet_t> trace;
+  for (uint32_t i = 0; i < 200; ++i) {
+    // Flow 2 only appears once in a while, evicting one of the others
+    for (uint32_t f = 0; f < (i % 20 == 0 ? 3u : 2u); ++f) {
+      trace.push_back(flows[f][i]);
+    }
+  }
+
+  rohc_compressor   comp(cfg, logger);
+  rohc_decompressor decomp(cfg, logger);
+  trace_result_t    r = run_trace(trace, comp, decomp, [](uint32_t i) { return false; });
+  TESTASSERT_EQ(trace.size(), r.nof_delivered);
+  TESTASSERT_EQ(0, r.nof_mismatch);
+  TESTASSERT(comp.get_metrics().nof_ir > 3 * 3);
+
+  // Reset drops the contexts, so that the next packets are sent in IR packets again
+  comp.reset();
+  unique_byte_buffer_t buf = to_buffer(flows[0][0]);
+  TESTASSERT(comp.compress(buf.get()));
+  TESTASSERT(buf->msg[0] == 0xfd);
+  return SRSRAN_SUCCESS;
+}
+
+// Malformed or unexpected packets are dropped by the decompressor
+int test_invalid_packets()
+{
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("PDCP");
+  pdcp_rohc_config_t    cfg    = make_rohc_cfg(1);
+  rohc_compressor       comp(cfg, logger);
+  rohc_decompressor     decomp(cfg, logger);
+
+  // Compressed packet without context
+  unique_byte_buffer_t buf = to_buffer({0x10, 0x00, 0x00});
+  TESTASSERT(not decomp.decompress(buf.get()));
+
+  // CID above max_cid, feedback and segment
+  for (uint8_t b : {0xe5, 0xf1, 0xff}) {
+    buf = to_buffer({b, 0xfd, 0x01, 0x00});
+    TESTASSERT(not decomp.decompress(buf.get()));
+  }
+
+  // IR of the ROHC-TCP profile, which is not supported. TCP packets are sent with the uncompressed profile instead
+  buf = to_buffer({0xfd, 0x06, 0x00});
+  TESTASSERT(not decomp.decompress(buf.get()));
+  buf = to_buffer(tcp_trace(1)[0]);
+  TESTASSERT(comp.compress(buf.get()));
+  TESTASSERT((buf->msg[0] & 0xfeu) == 0xfc and buf->msg[1] == 0x00);
+
+  // IR with a corrupted CRC, or truncated
+  std::vector<packet_t> trace = voip_trace(1);
+  buf                         = to_buffer(trace[0]);
+  TESTASSERT(comp.compress(buf.get()));
+  unique_byte_buffer_t copy = make_byte_buffer();
+  *copy                     = *buf;
+  copy->msg[2] ^= 0x01;
+  TESTASSERT(not decomp.decompress(copy.get()));
+  *copy          = *buf;
+  copy->N_bytes  = 10;
+  TESTASSERT(not decomp.decompress(copy.get()));
+  TESTASSERT(decomp.decompress(buf.get()));
+  TESTASSERT(is_equal(buf, trace[0]));
+  TESTASSERT_EQ(5 + 2, decomp.get_metrics().nof_dropped);
+  return SRSRAN_SUCCESS;
+}
+
+// RLC UM that records the PDUs of the bearer
+class rlc_recorder : public srsue::rlc_interface_pdcp
+{
+public:
+  void write_sdu(uint32_t lcid, unique_byte_buffer_t sdu) override { pdus.push_back(std::move(sdu)); }
+  void discard_sdu(uint32_t lcid, uint32_t discard_sn) override {}
+  bool rb_is_um(uint32_t lcid) override { return true; }
+  bool sdu_queue_is_full(uint32_t lcid) override { return false; }
+  bool is_suspended(uint32_t lcid) override { return false; }
+
+  std::vector<unique_byte_buffer_t> pdus;
+};
+
+// UE and eNB DRB entities configured with ROHC: the PDUs are smaller than the SDUs, and the SDUs are restored
+int test_lte_entity()
+{
+  srslog::basic_logger&   logger = srslog::fetch_basic_logger("PDCP");
+  srsue::stack_test_dummy stack;
+  rlc_recorder            rlc;
+  rrc_dummy               rrc(logger);
+  gw_dummy                gw(logger);
+
+  pdcp_config_t ue_cfg = {1,
+                          PDCP_RB_IS_DRB,
+                          SECURITY_DIRECTION_UPLINK,
+                          SECURITY_DIRECTION_DOWNLINK,
+                          PDCP_SN_LEN_12,
+                          pdcp_t_reordering_t::ms500,
+                          pdcp_discard_timer_t::infinity,
+                          false,
+                          srsran_rat_t::lte};
+  ue_cfg.rohc          = make_rohc_cfg();
+  pdcp_config_t enb_cfg = ue_cfg;
+  enb_cfg.tx_direction  = SECURITY_DIRECTION_DOWNLINK;
+  enb_cfg.rx_direction  = SECURITY_DIRECTION_UPLINK;
+
+  pdcp_entity_lte ue(&rlc, &rrc, &gw, &stack.task_sched, logger, 3);
+  pdcp_entity_lte enb(&rlc, &rrc, &gw, &stack.task_sched, logger, 3);
+  TESTASSERT(ue.configure(ue_cfg));
+  TESTASSERT(enb.configure(enb_cfg));
+
+  std::vector<packet_t> trace     = voip_trace(100);
+  uint32_t              sdu_bytes = 0, pdu_bytes = 0;
+  for (uint32_t i = 0; i < trace.size(); ++i) {
+    ue.write_sdu(to_buffer(trace[i]));
+    TESTASSERT_EQ(i + 1, rlc.pdus.size());
+    sdu_bytes += trace[i].size();
+    pdu_bytes += rlc.pdus.back()->N_bytes;
+    enb.write_pdu(std::move(rlc.pdus.back()));
+    unique_byte_buffer_t sdu = make_byte_buffer();
+    gw.get_last_pdu(sdu);
+    TESTASSERT_EQ(i + 1, gw.rx_count);
+    TESTASSERT(is_equal(sdu, trace[i]));
+  }
+  // 40 B of IP/UDP/RTP headers replaced by a few bytes, plus the 2 B PDCP header
+  TESTASSERT(pdu_bytes < sdu_bytes - 30 * trace.size());
+  return SRSRAN_SUCCESS;
+}
+
+void benchmark(const char* name, const std::vector<packet_t>& trace)
+{
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("PDCP");
+  pdcp_rohc_config_t    cfg    = make_rohc_cfg();
+  rohc_compressor       comp(cfg, logger);
+  rohc_decompressor     decomp(cfg, logger);
+
+  // The packets are processed in chunks, so that they do not deplete the buffer pool
+  const uint32_t                    chunk_size = 256;
+  std::vector<unique_byte_buffer_t> bufs(chunk_size);
+  double                            comp_ns = 0, decomp_ns = 0;
+  for (uint32_t i = 0; i < trace.size(); i += chunk_size) {
+    uint32_t n = std::min(chunk_size, (uint32_t)trace.size() - i);
+    for (uint32_t j = 0; j < n; ++j) {
+      bufs[j] = to_buffer(trace[i + j]);
+    }
+    auto tp = std::chrono::steady_clock::now();
+    for (uint32_t j = 0; j < n; ++j) {
+      comp.compress(bufs[j].get());
+    }
+    auto tp2 = std::chrono::steady_clock::now();
+    for (uint32_t j = 0; j < n; ++j) {
+      decomp.decompress(bufs[j].get());
+    }
+    comp_ns += std::chrono::duration<double, std::nano>(tp2 - tp).count();
+    decomp_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - tp2).count();
+  }
+  comp_ns /= trace.size();
+  decomp_ns /= trace.size();
+
+  pdcp_rohc_metrics_t m = comp.get_metrics();
+  printf("%s: compression %.0f ns/pkt (%.2f Mpkt/s), decompression %.0f ns/pkt (%.2f Mpkt/s), avg header %.1f -> "
+         "%.1f B\n",
+         name,
+         comp_ns,
+         1e3 / comp_ns,
+         decomp_ns,
+         1e3 / decomp_ns,
+         (double)m.orig_hdr_bytes / trace.size(),
+         (double)m.rohc_hdr_bytes / trace.size());
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  bool run_benchmark = false;
+  if (argc > 1 and strcmp(argv[1], "benchmark") == 0) {
+    run_benchmark = true;
+  } else if (argc > 1 and strcmp(argv[1], "test") != 0) {
+    printf("Usage: %s [test|benchmark]\n", argv[0]);
+    return SRSRAN_ERROR;
+  }
+
+  srslog::init();
+  srslog::fetch_basic_logger("PDCP", false).set_level(srslog::basic_levels::error);
+
+  TESTASSERT(test_trace("VoIP", voip_trace(5000), 0.1) == SRSRAN_SUCCESS);
+  TESTASSERT(test_trace("UDP", udp_trace(2000), 0.2) == SRSRAN_SUCCESS);
+  TESTASSERT(test_trace("TCP", tcp_trace(2000), 0) == SRSRAN_SUCCESS);
+  TESTASSERT(test_trace("IPv6", ipv6_trace(200), 0) == SRSRAN_SUCCESS);
+  TESTASSERT(test_burst_loss() == SRSRAN_SUCCESS);
+  TESTASSERT(test_context_replacement() == SRSRAN_SUCCESS);
+  TESTASSERT(test_invalid_packets() == SRSRAN_SUCCESS);
+  TESTASSERT(test_lte_entity() == SRSRAN_SUCCESS);
+
+  if (run_benchmark) {
+    benchmark("VoIP", voip_trace(100000));
+    benchmark("UDP", udp_trace(100000));
+    benchmark("TCP", tcp_trace(100000));
+  }
+
+  srslog::flush();
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
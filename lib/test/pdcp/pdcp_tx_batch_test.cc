@@ -0,0 +1,264 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "pdcp_base_test.h"
+#include "srsran/test/ue_test_interfaces.h"
+#include "srsran/upper/pdcp_entity_lte.h"
+#include "srsran/upper/pdcp_entity_nr.h"
+#include "srsran/upper/pdcp_tx_batch.h"
+#include <memory>
+#include <random>
+
+/*
+ * Tests that the PDUs protected by the TX batch stage match the ones of entities without it, for all the algorithms,
+ * and that they are forwarded to RLC in order, when the batch is flushed or its limits are reached
+ */
+
+using namespace srsran;
+
+std::mt19937 rgen(0);
+
+// RLC that records the PDUs of all bearers, in order
+class rlc_recorder : public srsue::rlc_interface_pdcp
+{
+public:
+  void write_sdu(uint32_t lcid, unique_byte_buffer_t sdu) override { pdus.emplace_back(lcid, std::move(sdu)); }
+  void discard_sdu(uint32_t lcid, uint32_t discard_sn) override {}
+  bool rb_is_um(uint32_t lcid) override { return false; }
+  bool sdu_queue_is_full(uint32_t lcid) override { return false; }
+  bool is_suspended(uint32_t lcid) override { return false; }
+
+  std::vector<std::pair<uint32_t, unique_byte_buffer_t> > pdus;
+};
+
+struct bearer_params_t {
+  srsran_rat_t                rat;
+  pdcp_rb_type_t              rb_type;
+  INTEGRITY_ALGORITHM_ID_ENUM integ_algo;
+  CIPHERING_ALGORITHM_ID_ENUM cipher_algo;
+};
+
+class test_bearer
+{
+public:
+  test_bearer(uint32_t lcid, const bearer_params_t& params, srsue::stack_test_dummy& stack, rlc_recorder& rlc_) :
+    rlc(rlc_), rrc(srslog::fetch_basic_logger("PDCP")), gw(srslog::fetch_basic_logger("PDCP"))
+  {
+    bool          lte_srb = params.rat == srsran_rat_t::lte and params.rb_type == PDCP_RB_IS_SRB;
+    pdcp_config_t cfg     = {(uint8_t)(lcid % 8 + 1),
+                             params.rb_type,
+                             SECURITY_DIRECTION_DOWNLINK,
+                             SECURITY_DIRECTION_UPLINK,
+                             lte_srb ? PDCP_SN_LEN_5 : PDCP_SN_LEN_12,
+                             pdcp_t_reordering_t::ms500,
+                             pdcp_discard_timer_t::infinity,
+                             false,
+                             params.rat};
+
+    as_security_config_t sec = {};
+    for (std::array<uint8_t, 32>* k : {&sec.k_rrc_int, &sec.k_rrc_enc, &sec.k_up_int, &sec.k_up_enc}) {
+      for (uint8_t& b : *k) {
+        b = rgen();
+      }
+    }
+    sec.integ_algo  = params.integ_algo;
+    sec.cipher_algo = params.cipher_algo;
+
+    srslog::basic_logger& logger = srslog::fetch_basic_logger("PDCP");
+    for (auto* entity : {&batched, &reference}) {
+      rlc_recorder* entity_rlc = entity == &batched ? &rlc : &ref_rlc;
+      if (params.rat == srsran_rat_t::lte) {
+        entity->reset(new pdcp_entity_lte{entity_rlc, &rrc, &gw, &stack.task_sched, logger, lcid});
+      } else {
+        entity->reset(new pdcp_entity_nr{entity_rlc, &rrc, &gw, &stack.task_sched, logger, lcid});
+      }
+      TESTASSERT((*entity)->configure(cfg));
+      (*entity)->config_security(sec);
+      if (params.integ_algo != INTEGRITY_ALGORITHM_ID_EIA0) {
+        (*entity)->enable_integrity(DIRECTION_TXRX);
+      }
+      if (params.cipher_algo != CIPHERING_ALGORITHM_ID_EEA0) {
+        (*entity)->enable_encryption(DIRECTION_TXRX);
+      }
+    }
+  }
+
+  void write_sdu(uint32_t len)
+  {
+    unique_byte_buffer_t sdu = make_byte_buffer();
+    for (uint32_t i = 0; i < len; ++i) {
+      sdu->msg[i] = rgen();
+    }
+    sdu->N_bytes              = len;
+    unique_byte_buffer_t copy = make_byte_buffer();
+    *copy                     = *sdu;
+    batched->write_sdu(std::move(sdu));
+    reference->write_sdu(std::move(copy));
+  }
+
+  rlc_recorder&                     rlc;
+  rlc_recorder                      ref_rlc;
+  rrc_dummy                         rrc;
+  gw_dummy                          gw;
+  std::unique_ptr<pdcp_entity_base> batched, reference;
+};
+
+// Checks that the recorded PDUs match the reference ones, bearer by bearer, and returns the number of PDUs
+uint32_t check_pdus(std::vector<std::unique_ptr<test_bearer> >& bearers, rlc_recorder& rlc)
+{
+  std::vector<uint32_t> next(bearers.size(), 0);
+  for (auto& p : rlc.pdus) {
+    test_bearer& b = *bearers[p.first];
+    TESTASSERT(next[p.first] < b.ref_rlc.pdus.size());
+    TESTASSERT(compare_two_packets(p.second, b.ref_rlc.pdus[next[p.first]].second) == 0);
+    TESTASSERT(p.second->md.pdcp_sn == b.ref_rlc.pdus[next[p.first]].second->md.pdcp_sn);
+    next[p.first]++;
+  }
+  return rlc.pdus.size();
+}
+
+std::vector<bearer_params_t> all_bearer_params()
+{
+  std::vector<bearer_params_t> params;
+  for (srsran_rat_t rat : {srsran_rat_t::lte, srsran_rat_t::nr}) {
+    for (pdcp_rb_type_t rb_type : {PDCP_RB_IS_SRB, PDCP_RB_IS_DRB}) {
+      for (uint32_t integ = 0; integ < INTEGRITY_ALGORITHM_ID_N_ITEMS; ++integ) {
+        for (uint32_t cipher = 0; cipher < CIPHERING_ALGORITHM_ID_N_ITEMS; ++cipher) {
+          params.push_back({rat, rb_type, (INTEGRITY_ALGORITHM_ID_ENUM)integ, (CIPHERING_ALGORITHM_ID_ENUM)cipher});
+        }
+      }
+    }
+  }
+  return params;
+}
+
+int test_batch_vs_reference(uint32_t nof_workers)
+{
+  srsue::stack_test_dummy stack;
+  rlc_recorder            rlc;
+  pdcp_tx_batch_args_t    args;
+  args.enable         = true;
+  args.max_batch_size = 10000;
+  args.max_delay_us   = 1000000;
+  args.nof_workers    = nof_workers;
+  pdcp_tx_batch batch(args);
+
+  std::vector<bearer_params_t>               params = all_bearer_params();
+  std::vector<std::unique_ptr<test_bearer> > bearers;
+  for (uint32_t lcid = 0; lcid < params.size(); ++lcid) {
+    bearers.emplace_back(new test_bearer(lcid, params[lcid], stack, rlc));
+    bearers.back()->batched->set_tx_batch(&batch);
+  }
+
+  std::uniform_int_distribution<uint32_t> len_dist(1, 1500);
+  for (uint32_t tti = 0; tti < 10; ++tti) {
+    // SDUs of random bearers, interleaved
+    for (uint32_t i = 0; i < 3 * bearers.size(); ++i) {
+      bearers[rgen() % bearers.size()]->write_sdu(len_dist(rgen));
+    }
+    TESTASSERT(rlc.pdus.empty());
+    batch.flush();
+    TESTASSERT(batch.nof_pending_pdus() == 0);
+    TESTASSERT(check_pdus(bearers, rlc) == 3 * bearers.size());
+    for (auto& b : bearers) {
+      b->ref_rlc.pdus.clear();
+    }
+    rlc.pdus.clear();
+  }
+
+  pdcp_tx_batch_metrics_t m = batch.get_metrics();
+  TESTASSERT(m.nof_batches == 10);
+  TESTASSERT(m.nof_pdus == 30 * bearers.size());
+  TESTASSERT(m.max_batch_size == 3 * bearers.size());
+  TESTASSERT(m.nof_forced_flushes == 0);
+  return SRSRAN_SUCCESS;
+}
+
+int test_batch_limits()
+{
+  srsue::stack_test_dummy stack;
+  rlc_recorder            rlc;
+  bearer_params_t         params = {
+      srsran_rat_t::lte, PDCP_RB_IS_DRB, INTEGRITY_ALGORITHM_ID_EIA0, CIPHERING_ALGORITHM_ID_128_EEA3};
+  std::vector<std::unique_ptr<test_bearer> > bearers;
+  bearers.emplace_back(new test_bearer(0, params, stack, rlc));
+
+  // Size limit
+  {
+    pdcp_tx_batch_args_t args;
+    args.max_batch_size = 4;
+    args.max_delay_us   = 1000000;
+    pdcp_tx_batch batch(args);
+    bearers[0]->batched->set_tx_batch(&batch);
+    for (uint32_t i = 0; i < 3; ++i) {
+      bearers[0]->write_sdu(100);
+    }
+    TESTASSERT(rlc.pdus.empty());
+    bearers[0]->write_sdu(100);
+    TESTASSERT(rlc.pdus.size() == 4);
+    TESTASSERT(batch.get_metrics().nof_forced_flushes == 1);
+    bearers[0]->batched->set_tx_batch(nullptr);
+  }
+
+  // Delay limit
+  {
+    pdcp_tx_batch_args_t args;
+    args.max_delay_us = 0;
+    pdcp_tx_batch batch(args);
+    bearers[0]->batched->set_tx_batch(&batch);
+    bearers[0]->write_sdu(100);
+    TESTASSERT(rlc.pdus.size() == 5);
+    bearers[0]->batched->set_tx_batch(nullptr);
+  }
+
+  // Changes of the security configuration flush the pending PDUs first
+  {
+    pdcp_tx_batch_args_t args;
+    pdcp_tx_batch        batch(args);
+    bearers[0]->batched->set_tx_batch(&batch);
+    bearers[0]->write_sdu(100);
+    TESTASSERT(rlc.pdus.size() == 5);
+    bearers[0]->batched->enable_encryption(DIRECTION_TXRX);
+    TESTASSERT(rlc.pdus.size() == 6);
+    TESTASSERT(check_pdus(bearers, rlc) == 6);
+
+    // No PDUs of a removed bearer are left in the stage
+    bearers[0]->write_sdu(100);
+    TESTASSERT(batch.nof_pending_pdus() == 1);
+    bearers.clear();
+    TESTASSERT(batch.nof_pending_pdus() == 0);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  srslog::init();
+  srslog::fetch_basic_logger("PDCP", false).set_level(srslog::basic_levels::info);
+
+  TESTASSERT(test_batch_vs_reference(0) == SRSRAN_SUCCESS);
+  TESTASSERT(test_batch_vs_reference(3) == SRSRAN_SUCCESS);
+  TESTASSERT(test_batch_limits() == SRSRAN_SUCCESS);
+
+  srslog::flush();
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
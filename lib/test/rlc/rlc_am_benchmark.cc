@@ -0,0 +1,189 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Pushes 1500 B SDUs through a pair of RLC AM entities at the rate of a 1 Gbps link (84 SDUs per TTI), dropping a
+ * share of the data PDUs, and measures the processing time per SDU and per status PDU, which grows with the number of
+ * NACKs and retransmissions in flight. The test checks that all the SDUs are delivered once the losses stop.
+ *
+ * Usage: rlc_am_benchmark [test|benchmark]
+ */
+
+#include "srsran/common/buffer_pool.h"
+#include "srsran/common/test_common.h"
+#include "srsran/interfaces/ue_pdcp_interfaces.h"
+#include "srsran/interfaces/ue_rrc_interfaces.h"
+#include "srsran/rlc/rlc_am_base.h"
+#include <chrono>
+#include <random>
+
+using namespace srsran;
+
+namespace {
+
+const uint32_t sdu_len       = 1500;
+const uint32_t sdus_per_tti  = 84; // 1 Gbps
+const uint32_t grant_len     = 12000;
+const uint32_t nof_drain_tti = 2000;
+
+class rlc_am_sink : public srsue::pdcp_interface_rlc, public srsue::rrc_interface_rlc
+{
+public:
+  // PDCP interface
+  void write_pdu(uint32_t lcid, unique_byte_buffer_t sdu) final { nof_sdus++; }
+  void write_pdu_bcch_bch(unique_byte_buffer_t sdu) final {}
+  void write_pdu_bcch_dlsch(unique_byte_buffer_t sdu) final {}
+  void write_pdu_pcch(unique_byte_buffer_t sdu) final {}
+  void write_pdu_mch(uint32_t lcid, unique_byte_buffer_t sdu) final {}
+  void notify_delivery(uint32_t lcid, const pdcp_sn_vector_t& pdcp_sns) final {}
+  void notify_failure(uint32_t lcid, const pdcp_sn_vector_t& pdcp_sns) final {}
+
+  // RRC interface
+  void        max_retx_attempted() final { max_retx = true; }
+  void        protocol_failure() final {}
+  const char* get_rb_name(uint32_t lcid) final { return "DRB1"; }
+
+  uint64_t nof_sdus = 0;
+  bool     max_retx = false;
+};
+
+struct bench_result_t {
+  uint64_t nof_sdus        = 0;
+  uint64_t nof_status_pdus = 0;
+  double   tti_time_s      = 0; ///< Time spent in the TTIs with losses
+  double   status_time_s   = 0; ///< Time spent building and handling the status PDUs
+};
+
+// Moves the PDUs of one TTI from tx to rx, dropping some of them, and the status PDUs back
+void run_tti(rlc_am&         tx,
+             rlc_am&         rx,
+             uint32_t        nof_sdus,
+             double          drop_rate,
+             std::mt19937&   rgen,
+             bench_result_t& result)
+{
+  static uint8_t payload[grant_len];
+
+  for (uint32_t i = 0; i < nof_sdus and not tx.sdu_queue_is_full(); ++i) {
+    unique_byte_buffer_t sdu = make_byte_buffer();
+    TESTASSERT(sdu != nullptr);
+    sdu->N_bytes    = sdu_len;
+    sdu->md.pdcp_sn = result.nof_sdus++ % (1u << 18u);
+    tx.write_sdu(std::move(sdu));
+  }
+
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  while (tx.get_buffer_state() > 0) {
+    uint32_t len = tx.read_pdu(payload, grant_len);
+    if (len == 0) {
+      break;
+    }
+    if (dist(rgen) >= drop_rate) {
+      rx.write_pdu(payload, len);
+    }
+  }
+
+  auto tp = std::chrono::steady_clock::now();
+  if (rx.get_buffer_state() > 0) {
+    uint32_t len = rx.read_pdu(payload, grant_len);
+    if (len > 0) {
+      tx.write_pdu(payload, len);
+      result.nof_status_pdus++;
+    }
+  }
+  result.status_time_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - tp).count();
+}
+
+int run(const char* name, const rlc_config_t& base_cfg, uint32_t nof_ttis, double drop_rate)
+{
+  rlc_config_t cfg = base_cfg;
+  // Losses must not stop the test
+  cfg.am.max_retx_thresh    = 64;
+  cfg.am_nr.max_retx_thresh = 64;
+  cfg.tx_queue_length       = RLC_TX_QUEUE_LEN;
+
+  timer_handler timers(8);
+  rlc_am_sink   sink1, sink2;
+  rlc_am        rlc1(cfg.rat, srslog::fetch_basic_logger("RLC_AM_1", false), 1, &sink1, &sink1, &timers);
+  rlc_am        rlc2(cfg.rat, srslog::fetch_basic_logger("RLC_AM_2", false), 1, &sink2, &sink2, &timers);
+  TESTASSERT(rlc1.configure(cfg));
+  TESTASSERT(rlc2.configure(cfg));
+
+  std::mt19937   rgen(0);
+  bench_result_t result;
+  auto           tp = std::chrono::steady_clock::now();
+  for (uint32_t tti = 0; tti < nof_ttis; ++tti) {
+    run_tti(rlc1, rlc2, sdus_per_tti, drop_rate, rgen, result);
+    timers.step_all();
+  }
+  result.tti_time_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - tp).count();
+
+  // Without losses, all SDUs are eventually delivered
+  for (uint32_t tti = 0; tti < nof_drain_tti and sink2.nof_sdus < result.nof_sdus; ++tti) {
+    run_tti(rlc1, rlc2, 0, 0.0, rgen, result);
+    timers.step_all();
+  }
+
+  printf("%s, drop rate %.2f: %.0f SDUs/s (%.0f Mbps), %.2f us/TTI, %" PRIu64 " status PDUs, %.2f us/status PDU\n",
+         name,
+         drop_rate,
+         result.nof_sdus / result.tti_time_s,
+         result.nof_sdus * sdu_len * 8 / result.tti_time_s * 1e-6,
+         result.tti_time_s * 1e6 / nof_ttis,
+         result.nof_status_pdus,
+         result.status_time_s * 1e6 / std::max(result.nof_status_pdus, (uint64_t)1));
+
+  TESTASSERT_EQ(result.nof_sdus, sink2.nof_sdus);
+  TESTASSERT(not sink1.max_retx);
+  rlc1.stop();
+  rlc2.stop();
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  // The PDUs in flight hold buffers until they are acknowledged
+  byte_buffer_pool::get_instance(32768);
+  srslog::init();
+  srslog::fetch_basic_logger("RLC_AM_1", false).set_level(srslog::basic_levels::warning);
+  srslog::fetch_basic_logger("RLC_AM_2", false).set_level(srslog::basic_levels::warning);
+
+  uint32_t nof_ttis;
+  if (argc == 1 or strcmp(argv[1], "test") == 0) {
+    nof_ttis = 200;
+  } else if (strcmp(argv[1], "benchmark") == 0) {
+    nof_ttis = 5000;
+  } else {
+    printf("Usage: %s [test|benchmark]\n", argv[0]);
+    return SRSRAN_ERROR;
+  }
+
+  for (double drop_rate : {0.0, 0.05, 0.3}) {
+    TESTASSERT(run("LTE", rlc_config_t::default_rlc_am_config(), nof_ttis, drop_rate) == SRSRAN_SUCCESS);
+    TESTASSERT(run("NR 12 bit SN", rlc_config_t::default_rlc_am_nr_config(12), nof_ttis, drop_rate) == SRSRAN_SUCCESS);
+    TESTASSERT(run("NR 18 bit SN", rlc_config_t::default_rlc_am_nr_config(18), nof_ttis, drop_rate) == SRSRAN_SUCCESS);
+  }
+
+  srslog::flush();
+  return SRSRAN_SUCCESS;
+}
@@ -26,6 +26,7 @@
 #include "srsran/common/threads.h"
 #include "srsran/interfaces/ue_pdcp_interfaces.h"
 #include "srsran/interfaces/ue_rrc_interfaces.h"
+#include "srsran/rlc/rlc.h"
 #include "srsran/rlc/rlc_am_lte.h"
 
 #define NBUFS 5
@@ -162,6 +163,92 @@ int basic_test()
   return SRSRAN_SUCCESS;
 }
 
+// PDUs read by reference must stay valid after being acknowledged, until they are released
+int zero_copy_ack_test()
+{
+  rlc_am_tester tester(true, nullptr);
+  timer_handler timers(8);
+
+  rlc_am rlc1(srsran_rat_t::lte, srslog::fetch_basic_logger("RLC_AM_1"), 1, &tester, &tester, &timers);
+  rlc_am rlc2(srsran_rat_t::lte, srslog::fetch_basic_logger("RLC_AM_2"), 1, &tester, &tester, &timers);
+
+  TESTASSERT(rlc1.configure(rlc_config_t::default_rlc_am_config()));
+  TESTASSERT(rlc2.configure(rlc_config_t::default_rlc_am_config()));
+
+  // Push 5 SDUs into RLC1
+  for (int i = 0; i < NBUFS; i++) {
+    unique_byte_buffer_t sdu = srsran::make_byte_buffer();
+    sdu->msg[0]              = i;
+    sdu->N_bytes             = 1;
+    sdu->md.pdcp_sn          = i;
+    rlc1.write_sdu(std::move(sdu));
+  }
+
+  // Read the 5 PDUs by reference and deliver them to RLC2
+  const_byte_span bodies[NBUFS];
+  for (int i = 0; i < NBUFS; i++) {
+    byte_buffer_t pdu;
+    pdu.N_bytes = rlc1.read_pdu_sg(pdu.msg, 3, bodies[i]);
+    TESTASSERT(bodies[i].size() > 0);
+    memcpy(pdu.msg + pdu.N_bytes, bodies[i].data(), bodies[i].size());
+    pdu.N_bytes += bodies[i].size();
+    rlc2.write_pdu(pdu.msg, pdu.N_bytes);
+  }
+  TESTASSERT(rlc1.has_lent_pdus());
+
+  // ACK all PDUs, which removes them from the Tx window of RLC1
+  byte_buffer_t status_buf;
+  status_buf.N_bytes = rlc2.read_pdu(status_buf.msg, 2);
+  rlc1.write_pdu(status_buf.msg, status_buf.N_bytes);
+  TESTASSERT(tester.notified_counts.size() == NBUFS);
+
+  // The referenced PDUs are still alive until released
+  for (int i = 0; i < NBUFS; i++) {
+    TESTASSERT(bodies[i].back() == i);
+    TESTASSERT(rlc1.release_pdu_sg(bodies[i]));
+  }
+  TESTASSERT(not rlc1.has_lent_pdus());
+
+  return SRSRAN_SUCCESS;
+}
+
+// A bearer deleted while its PDUs are referenced keeps them alive, even if the LCID is added again, and the releases
+// reach it instead of the new bearer
+int zero_copy_del_bearer_test()
+{
+  const uint32_t lcid = 3;
+  rlc_am_tester  tester(true, nullptr);
+  timer_handler  timers(8);
+  srsran::rlc    rlc("RLC_1");
+  rlc.init(&tester, &tester, &timers, 0);
+  TESTASSERT(rlc.add_bearer(lcid, rlc_config_t::default_rlc_am_config()) == SRSRAN_SUCCESS);
+
+  const_byte_span bodies[2];
+  for (int i = 0; i < 2; i++) {
+    unique_byte_buffer_t sdu = srsran::make_byte_buffer();
+    sdu->msg[0]              = i;
+    sdu->N_bytes             = 1;
+    sdu->md.pdcp_sn          = i;
+    rlc.write_sdu(lcid, std::move(sdu));
+    byte_buffer_t pdu;
+    rlc.read_pdu_sg(lcid, pdu.msg, 3, bodies[i]);
+    TESTASSERT(bodies[i].size() > 0);
+  }
+
+  rlc.del_bearer(lcid);
+  TESTASSERT(rlc.has_lent_pdus());
+  TESTASSERT(rlc.add_bearer(lcid, rlc_config_t::default_rlc_am_config()) == SRSRAN_SUCCESS);
+
+  // The parked bearer is destroyed with the release of its last PDU
+  for (int i = 0; i < 2; i++) {
+    TESTASSERT(bodies[i].back() == i);
+    rlc.release_pdu_sg(lcid, bodies[i]);
+  }
+  TESTASSERT(not rlc.has_lent_pdus());
+
+  return SRSRAN_SUCCESS;
+}
+
 int concat_test()
 {
   rlc_am_tester         tester(true, nullptr);
@@ -4112,6 +4199,16 @@ int main(int argc, char** argv)
     exit(-1);
   };
 
+  if (zero_copy_ack_test()) {
+    printf("zero_copy_ack_test failed\n");
+    exit(-1);
+  };
+
+  if (zero_copy_del_bearer_test()) {
+    printf("zero_copy_del_bearer_test failed\n");
+    exit(-1);
+  };
+
   if (concat_test()) {
     printf("concat_test failed\n");
     exit(-1);
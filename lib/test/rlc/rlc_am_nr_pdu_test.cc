@@ -2572,8 +2572,9 @@ int rlc_am_nr_control_pdu_test_trimming(rlc_am_nr_sn_size_t sn_size)
 
     // create a copy, check content
     rlc_am_nr_status_pdu_t status_pdu_copy = status_pdu;
+    const uint32_t         copy_size       = expected_size;
     TESTASSERT_EQ(status_pdu_copy.ack_sn, 77);
-    TESTASSERT_EQ(status_pdu_copy.packed_size, expected_size);
+    TESTASSERT_EQ(status_pdu_copy.packed_size, copy_size);
     TESTASSERT_EQ(rlc_am_nr_write_status_pdu(status_pdu_copy, sn_size, &pdu), SRSRAN_SUCCESS);
     TESTASSERT_EQ(pdu.N_bytes, expected_size);
 
@@ -2644,9 +2645,10 @@ int rlc_am_nr_control_pdu_test_trimming(rlc_am_nr_sn_size_t sn_size)
 
     // check the copy again - should be unchanged if not a shallow copy
     TESTASSERT_EQ(status_pdu_copy.ack_sn, 77);
-    TESTASSERT_EQ(status_pdu_copy.packed_size, expected_size);
+    TESTASSERT_EQ(status_pdu_copy.packed_size, copy_size);
+    TESTASSERT_EQ(status_pdu_copy.nacks.size(), 8);
     TESTASSERT_EQ(rlc_am_nr_write_status_pdu(status_pdu_copy, sn_size, &pdu), SRSRAN_SUCCESS);
-    TESTASSERT_EQ(pdu.N_bytes, expected_size);
+    TESTASSERT_EQ(pdu.N_bytes, copy_size);
   }
 
   return SRSRAN_SUCCESS;
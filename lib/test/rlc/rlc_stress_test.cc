@@ -29,9 +29,11 @@
 #include "srsran/rlc/rlc.h"
 #include <boost/program_options.hpp>
 #include <boost/program_options/parsers.hpp>
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
 #include <iostream>
+#include <new>
 #include <pthread.h>
 #include <random>
 
@@ -39,6 +41,29 @@
 #include "srsran/mac/mac_sch_pdu_nr.h"
 
 static std::unique_ptr<srsran::mac_pcap> pcap_handle = nullptr;
+
+// Count the heap allocations of all threads, to report the allocation rate of RLC under loss
+static std::atomic<uint64_t> nof_allocations = {0};
+
+void* operator new(std::size_t size)
+{
+  nof_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t size) noexcept
+{
+  std::free(p);
+}
 /***********************
  * MAC tester class
  ***********************/
@@ -334,6 +359,7 @@ void stress_test(stress_test_args_t args)
   }
 
   printf("Starting test ... Seed: %u\n", seed);
+  uint64_t start_allocations = nof_allocations;
 
   tester1.start(7);
   if (!args.single_tx) {
@@ -343,6 +369,7 @@ void stress_test(stress_test_args_t args)
 
   // wait until test is over
   std::this_thread::sleep_for(std::chrono::seconds(args.test_duration_sec));
+  uint64_t test_allocations = nof_allocations - start_allocations;
 
   srslog::flush();
   fflush(stdout);
@@ -385,6 +412,12 @@ void stress_test(stress_test_args_t args)
          metrics.bearer[lcid].num_tx_pdu_bytes,
          metrics.bearer[lcid].num_rx_pdu_bytes);
   rlc_bearer_metrics_print(metrics.bearer[lcid]);
+
+  printf("Received %.2f SDUs/s with PDU drop rate %.2f, %" PRIu64 " heap allocations (%.2f/s)\n",
+         static_cast<double>(tester1.get_nof_rx_pdus() + tester2.get_nof_rx_pdus()) / args.test_duration_sec,
+         args.pdu_drop_rate,
+         test_allocations,
+         static_cast<double>(test_allocations) / args.test_duration_sec);
 }
 
 int main(int argc, char** argv)
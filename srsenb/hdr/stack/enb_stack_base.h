@@ -25,6 +25,7 @@
 #include "srsran/interfaces/enb_interfaces.h"
 #include "srsran/interfaces/enb_mac_interfaces.h"
 #include "srsran/interfaces/enb_s1ap_interfaces.h"
+#include "srsran/interfaces/pdcp_interface_types.h"
 #include "srsue/hdr/stack/upper/gw.h"
 #include <string>
 
@@ -69,15 +70,19 @@ typedef struct {
 } stack_log_args_t;
 
 typedef struct {
-  uint32_t         sync_queue_size; // Max allowed difference between PHY and Stack clocks (in TTI)
-  uint32_t         gtpu_indirect_tunnel_timeout_msec;
-  mac_args_t       mac;
-  s1ap_args_t      s1ap;
-  pcap_args_t      mac_pcap;
-  pcap_net_args_t  mac_pcap_net;
-  pcap_args_t      s1ap_pcap;
-  stack_log_args_t log;
-  embms_args_t     embms;
+  uint32_t                     sync_queue_size; // Max allowed difference between PHY and Stack clocks (in TTI)
+  uint32_t                     gtpu_indirect_tunnel_timeout_msec;
+  std::string                  gtpu_socket_type;
+  std::string                  gtpu_xdp_if_name;
+  uint32_t                     gtpu_xdp_queue_id;
+  mac_args_t                   mac;
+  s1ap_args_t                  s1ap;
+  srsran::pdcp_tx_batch_args_t pdcp_tx_batch;
+  pcap_args_t                  mac_pcap;
+  pcap_net_args_t              mac_pcap_net;
+  pcap_args_t                  s1ap_pcap;
+  stack_log_args_t             log;
+  embms_args_t                 embms;
 } stack_args_t;
 
 struct stack_metrics_t;
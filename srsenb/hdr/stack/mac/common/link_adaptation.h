@@ -0,0 +1,91 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_LINK_ADAPTATION_H
+#define SRSRAN_LINK_ADAPTATION_H
+
+#include "srsran/support/srsran_assert.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace srsenb {
+
+/**
+ * Outer loop link adaptation (OLLA) of one link direction of a UE, common to the LTE and NR schedulers.
+ * It tracks an offset that is added to the reported channel quality (e.g. SNR or CQI), so that the BLER converges to
+ * the target BLER. Each ACK increases the offset by step_up, and each NACK decreases it by
+ * step_up * (1 - target_bler) / target_bler.
+ */
+class olla_ctrl
+{
+public:
+  olla_ctrl() = default;
+  olla_ctrl(float target_bler, float step_up_, float max_offset_);
+
+  /// Update offset with the HARQ feedback of a transmission with the given MCS
+  void  update(bool ack, int mcs, int max_mcs);
+  void  reset() { offset_ = 0; }
+  float offset() const { return offset_; }
+
+private:
+  float step_up = 0, step_down = 0, max_offset = 0;
+  float offset_ = 0;
+};
+
+/**
+ * Table with the precomputed MCS and TBS to use for each channel quality level (e.g. the CQI derived from the
+ * SNR estimate) and number of PRBs. It avoids searching the MCS in the scheduler hot path.
+ */
+class mcs_lookup_table
+{
+public:
+  struct entry_t {
+    int mcs       = 0;
+    int tbs_bytes = -1;
+  };
+  using compute_func_t = std::function<entry_t(uint32_t level, uint32_t nof_prb)>;
+
+  /// Fill table by calling compute_func for each level in [0, nof_levels) and nof PRBs in [1, max_nof_prb]
+  void init(uint32_t nof_levels_, uint32_t max_nof_prb_, const compute_func_t& compute_func);
+
+  bool     empty() const { return table.empty(); }
+  uint32_t nof_levels() const { return nof_levels_; }
+  uint32_t max_nof_prb() const { return max_nof_prb_; }
+
+  /// Levels and nof PRBs outside of the table limits are clamped
+  const entry_t& get(uint32_t level, uint32_t nof_prb) const
+  {
+    srsran_assert(not empty(), "Accessing uninitialized MCS table");
+    level   = std::min(level, nof_levels_ - 1);
+    nof_prb = std::max(1U, std::min(nof_prb, max_nof_prb_));
+    return table[level * max_nof_prb_ + nof_prb - 1];
+  }
+
+private:
+  uint32_t             nof_levels_ = 0, max_nof_prb_ = 0;
+  std::vector<entry_t> table;
+};
+
+} // namespace srsenb
+
+#endif // SRSRAN_LINK_ADAPTATION_H
@@ -66,12 +66,26 @@ struct mac_cc_info_t {
   uint32_t cc_rach_counter;
 };
 
+/// Slack of the scheduling decisions computed ahead of the PHY.
+struct mac_lookahead_metrics_t {
+  /// Number of TTIs fetched by the PHY.
+  uint32_t nof_ttis;
+  /// Number of TTIs whose scheduling result was not ready when fetched by the PHY.
+  uint32_t nof_late_ttis;
+  /// Average time between a scheduling result being ready and the PHY fetching it, in microseconds.
+  float avg_slack_us;
+  /// Minimum slack. It is negative if the PHY had to wait for a result.
+  float min_slack_us;
+};
+
 /// Main MAC metrics.
 struct mac_metrics_t {
   /// Per CC info.
   std::vector<mac_cc_info_t> cc_info;
   /// Per UE MAC metrics.
   std::vector<mac_ue_metrics_t> ues;
+  /// Scheduling lookahead metrics. Only filled if the scheduling lookahead is enabled.
+  mac_lookahead_metrics_t lookahead = {};
 };
 
 } // namespace srsenb
@@ -25,6 +25,7 @@
 #include "srsran/AO_general.h"
 #include "sched.h"
 #include "sched_interface.h"
+#include "sched_lookahead.h"
 #include "srsenb/hdr/common/rnti_pool.h"
 #include "srsenb/hdr/stack/mac/schedulers/sched_time_rr.h"
 #include "srsran/adt/circular_map.h"
@@ -137,6 +138,10 @@ private:
    */
   bool is_pending_pdcch_order_prach(const uint32_t preamble_idx, uint16_t& rnti);
 
+  /// Run the scheduler for the given TTI and assemble the respective MAC PDUs
+  int run_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res);
+  int run_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res);
+
   srslog::basic_logger& logger;
 
   // We use a rwlock in MAC to allow multiple workers to access MAC simultaneously. No conflicts will happen since
@@ -161,6 +166,10 @@ private:
   sched                                    scheduler;
   std::vector<sched_interface::cell_cfg_t> cell_config;
 
+  /* Computes the scheduling decisions ahead of the PHY, if enabled */
+  static const int                 LOOKAHEAD_THREAD_PRIO = 4;
+  std::unique_ptr<sched_lookahead> lookahead;
+
   sched_interface::dl_pdu_mch_t mch = {};
 
   /* Map of active UEs */
@@ -50,6 +50,9 @@ public:
   const static int MAX_RLC_PDU_LIST    = 8;
   const static int MAX_PHICH_LIST      = 8;
 
+  /// Maximum number of TTIs the scheduling decisions can be computed ahead of the PHY
+  const static uint32_t MAX_LOOKAHEAD = 4;
+
   typedef struct {
     uint32_t len;
     uint32_t period_rf;
@@ -80,6 +83,7 @@ public:
     int         init_dl_cqi               = 5;
     float       max_sib_coderate          = 0.8;
     int         pdcch_cqi_offset          = 0;
+    uint32_t    lookahead                 = 0;
   };
 
   struct cell_cfg_t {
@@ -319,6 +323,12 @@ public:
   virtual int ul_phr(uint16_t rnti, int phr, uint32_t ul_nof_prb)                                           = 0;
   virtual int ul_snr_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, float snr, uint32_t ul_ch_code) = 0;
 
+  /**
+   * Informs that the PUSCH retx scheduled for tti_tx_ul was not sent, because the respective HARQ was acknowledged
+   * after the scheduling decision was made
+   */
+  virtual int ul_retx_dropped(uint32_t tti_tx_ul, uint16_t rnti, uint32_t enb_cc_idx) = 0;
+
   /* Run Scheduler for this tti */
   virtual int dl_sched(uint32_t tti, uint32_t enb_cc_idx, dl_sched_res_t& sched_result) = 0;
   virtual int ul_sched(uint32_t tti, uint32_t enb_cc_idx, ul_sched_res_t& sched_result) = 0;
@@ -0,0 +1,141 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSENB_SCHED_LOOKAHEAD_H
+#define SRSENB_SCHED_LOOKAHEAD_H
+
+#include "srsenb/hdr/stack/mac/common/mac_metrics.h"
+#include "srsenb/hdr/stack/mac/sched_interface.h"
+#include "srsran/adt/bounded_vector.h"
+#include "srsran/adt/circular_buffer.h"
+#include "srsran/common/threads.h"
+#include "srsran/common/tti_point.h"
+#include "srsran/interfaces/enb_mac_interfaces.h"
+#include "srsran/srslog/srslog.h"
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+namespace srsenb {
+
+/**
+ * Computes the DL and UL scheduling decisions of TTI+k in a dedicated thread, ahead of the PHY worker that is going to
+ * transmit them. The PHY worker only fetches the finished result, which keeps the scheduler and the MAC PDU assembly
+ * out of the PHY critical path.
+ *
+ * Each time a PHY worker fetches the result of tti_tx_dl, the computation of all TTIs up to tti_tx_dl + lookahead is
+ * requested. The results are stored in a ring of pre-built entries, indexed by tti_tx_dl. Each entry holds the DL
+ * result for tti_tx_dl and the UL result for the respective tti_tx_ul.
+ *
+ * When a result is computed, the UL CRCs of the PUSCHs it acknowledges may not be known yet. The CRCs reported by the
+ * PHY before the fetch are used to correct the PHICH and to drop the retransmission grants of the decoded PUSCHs. The
+ * scheduler is informed of each dropped retransmission, so that the respective HARQ process is released.
+ *
+ * The lookahead must not exceed sched_interface::MAX_LOOKAHEAD, which is enforced when parsing the configuration.
+ */
+class sched_lookahead final : public srsran::thread
+{
+public:
+  using dl_sched_list_t = mac_interface_phy_lte::dl_sched_list_t;
+  using ul_sched_list_t = mac_interface_phy_lte::ul_sched_list_t;
+
+  /// Computes the DL result for tti_tx_dl and the UL result for the respective tti_tx_ul
+  using sched_func_t = std::function<int(uint32_t tti_tx_dl, dl_sched_list_t&, ul_sched_list_t&)>;
+  /// Informs the scheduler that the PUSCH retx of a UE, scheduled for tti_tx_ul, was dropped
+  using retx_drop_func_t = std::function<void(uint32_t tti_tx_ul, uint16_t rnti, uint32_t enb_cc_idx)>;
+
+  /// The computation thread is started at construction with the given priority
+  sched_lookahead(uint32_t              lookahead_,
+                  uint32_t              nof_carriers_,
+                  sched_func_t          sched_func_,
+                  retx_drop_func_t      retx_drop_func_,
+                  srslog::basic_logger& logger_,
+                  int                   prio = -1);
+  ~sched_lookahead();
+
+  void stop();
+
+  /// Called by the PHY workers. They block until the result of the given TTI is ready
+  int get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res);
+  int get_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res);
+
+  /// Called by the PHY workers, before fetching the UL result that contains the respective PHICH
+  void crc_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, bool crc);
+
+  /// Reads and resets the slack metrics
+  void get_metrics(mac_lookahead_metrics_t& metrics);
+
+  uint32_t get_lookahead() const { return lookahead; }
+
+private:
+  static const uint32_t RING_SIZE = 16;
+
+  using clock_t = std::chrono::steady_clock;
+
+  struct crc_t {
+    uint16_t rnti;
+    uint32_t enb_cc_idx;
+    bool     crc;
+  };
+
+  enum class state_t { empty, pending, ready };
+
+  struct tti_result_t {
+    srsran::tti_point                                                tti_tx_dl;
+    state_t                                                          state = state_t::empty;
+    int                                                              ret   = SRSRAN_SUCCESS;
+    clock_t::time_point                                              ready_time;
+    dl_sched_list_t                                                  dl_res;
+    ul_sched_list_t                                                  ul_res;
+    srsran::bounded_vector<crc_t, mac_interface_phy_lte::MAX_GRANTS> crcs;
+  };
+
+  void run_thread() override;
+
+  tti_result_t* wait_result(srsran::tti_point tti_tx_dl, std::unique_lock<std::mutex>& lock);
+  void          request_until(srsran::tti_point tti_tx_dl);
+  void          apply_crcs(tti_result_t& result, ul_sched_list_t& ul_sched_res);
+
+  const uint32_t        lookahead;
+  const uint32_t        nof_carriers;
+  sched_func_t          sched_func;
+  retx_drop_func_t      retx_drop_func;
+  srslog::basic_logger& logger;
+
+  std::mutex                                                   mutex;
+  std::condition_variable                                      cvar;
+  bool                                                         running = true;
+  srsran::tti_point                                            last_requested;
+  std::array<tti_result_t, RING_SIZE>                          results;
+  srsran::static_circular_buffer<srsran::tti_point, RING_SIZE> pending_ttis;
+
+  // Slack metrics, protected by the mutex
+  uint32_t nof_ttis      = 0;
+  uint32_t nof_late_ttis = 0;
+  double   sum_slack_us  = 0;
+  double   min_slack_us  = 0;
+};
+
+} // namespace srsenb
+
+#endif // SRSENB_SCHED_LOOKAHEAD_H
@@ -23,6 +23,7 @@
 #define SRSRAN_SCHED_LTE_COMMON_H
 
 #include "sched_interface.h"
+#include "srsenb/hdr/stack/mac/common/link_adaptation.h"
 #include "srsran/adt/bounded_bitset.h"
 #include "srsran/common/tti_point.h"
 
@@ -67,6 +68,11 @@ public:
   uint32_t nof_prb() const { return cfg.cell.nof_prb; }
   uint32_t get_dl_lb_nof_re(tti_point tti_tx_dl, uint32_t nof_prbs_alloc) const;
   uint32_t get_dl_nof_res(srsran::tti_point tti_tx_dl, const srsran_dci_dl_t& dci, uint32_t cfi) const;
+  /// Nof REs of a PUSCH without SRS and UCI
+  uint32_t get_ul_nof_re(uint32_t nof_prbs_alloc) const
+  {
+    return 2 * (SRSRAN_CP_NSYMB(cfg.cell.cp) - 1) * nof_prbs_alloc * SRSRAN_NRE;
+  }
 
   uint32_t                                     enb_cc_idx       = 0;
   sched_interface::cell_cfg_t                  cfg              = {};
@@ -88,6 +94,8 @@ public:
   dl_nof_re_table nof_re_table;
   /// Cached computation of Lower bound of nof REs
   dl_lb_nof_re_table nof_re_lb_table;
+  /// Cached max UL {MCS, TBS} for each UL CQI and nof PRBs of a PUSCH without UCI. Indexed by UL 64QAM enabled
+  std::array<mcs_lookup_table, 2> ul_mcs_tables;
 };
 
 /// Type of Allocation stored in PDSCH/PUSCH
@@ -83,6 +83,17 @@ tbs_info compute_min_mcs_and_tbs_from_required_bytes(uint32_t nof_prb,
                                                      bool     ulqam64_enabled,
                                                      bool     use_tbs_index_alt);
 
+/// Same as above, but reusing the max MCS/TBS already derived for the given CQI and N_prb (e.g. from a lookup table)
+tbs_info compute_min_mcs_and_tbs_from_required_bytes(const tbs_info& tb_max,
+                                                     uint32_t        nof_prb,
+                                                     uint32_t        nof_re,
+                                                     uint32_t        cqi,
+                                                     uint32_t        max_mcs,
+                                                     uint32_t        req_bytes,
+                                                     bool            is_ul,
+                                                     bool            ulqam64_enabled,
+                                                     bool            use_tbs_index_alt);
+
 struct pending_rar_t {
   uint16_t                                                                                    ra_rnti = 0;
   tti_point                                                                                   prach_tti{};
@@ -72,6 +72,7 @@ public:
   void set_dl_sb_cqi(tti_point tti_rx, uint32_t enb_cc_idx, uint32_t sb_idx, uint32_t cqi);
   int  set_ack_info(tti_point tti_rx, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack);
   void set_ul_crc(tti_point tti_rx, uint32_t enb_cc_idx, bool crc_res);
+  void drop_ul_retx(tti_point tti_tx_ul, uint32_t enb_cc_idx);
 
   /*******************************************************
    * Custom functions
@@ -117,6 +117,7 @@ public:
   bool     pop_pending_phich();
   void     request_pdcch();
   void     retx_skipped();
+  void     retx_dropped();
 
 private:
   prb_interval allocation;
@@ -131,7 +132,11 @@ class harq_entity
 public:
   static const bool is_async = ASYNC_DL_SCHED;
 
-  harq_entity(size_t nof_dl_harqs, size_t nof_ul_harqs);
+  /**
+   * @param fb_delay number of TTIs the scheduling decisions are made ahead of the reception of the HARQ feedback. DL
+   *                 retxs are only considered once the ACK/NACK of the respective TTI had the chance to be received
+   */
+  harq_entity(size_t nof_dl_harqs, size_t nof_ul_harqs, uint32_t fb_delay = 0);
 
   void reset();
   void new_tti(tti_point tti_rx);
@@ -178,6 +183,7 @@ public:
 private:
   dl_harq_proc* get_oldest_dl_harq(tti_point tti_tx_dl);
 
+  uint32_t                                   fb_delay;
   std::array<tti_point, SRSRAN_FDD_NOF_HARQ> last_ttis;
 
   std::vector<dl_harq_proc> dl_harqs;
@@ -24,6 +24,7 @@
 
 #include "common/mac_metrics.h"
 #include "sched_interface.h"
+#include "srsran/adt/bounded_vector.h"
 #include "srsran/adt/circular_array.h"
 #include "srsran/adt/circular_map.h"
 #include "srsran/adt/pool/pool_interface.h"
@@ -98,6 +99,13 @@ private:
 class cc_buffer_handler
 {
 public:
+  // RLC PDU body referenced by a zero-copy TB, which must be released once the TB is no longer transmitted
+  struct lent_body_t {
+    uint32_t                lcid;
+    srsran::const_byte_span body;
+  };
+  using lent_body_list_t = srsran::bounded_vector<lent_body_t, SRSRAN_SCH_MAX_IOV>;
+
   explicit cc_buffer_handler();
   ~cc_buffer_handler();
 
@@ -115,6 +123,8 @@ public:
   {
     return tx_payload_buffer[harq_pid][tb].get();
   }
+  srsran_sch_tb_iov_t* get_tx_payload_iov(size_t harq_pid, size_t tb) { return &tx_payload_iov[harq_pid][tb]; }
+  lent_body_list_t&    get_tx_lent_bodies(size_t harq_pid, size_t tb) { return tx_lent_bodies[harq_pid][tb]; }
   cc_used_buffers_map& get_rx_used_buffers() { return rx_used_buffers; }
 
 private:
@@ -126,6 +136,12 @@ private:
 
   // One buffer per TB per DL HARQ process and per carrier is needed for each UE.
   std::array<std::array<srsran::unique_byte_buffer_t, SRSRAN_MAX_TB>, SRSRAN_FDD_NOF_HARQ> tx_payload_buffer;
+
+  // Fragment list describing each TB when the PDU references RLC buffers (zero-copy DL)
+  std::array<std::array<srsran_sch_tb_iov_t, SRSRAN_MAX_TB>, SRSRAN_FDD_NOF_HARQ> tx_payload_iov = {};
+
+  // RLC PDU bodies referenced by the fragment list of each TB
+  std::array<std::array<lent_body_list_t, SRSRAN_MAX_TB>, SRSRAN_FDD_NOF_HARQ> tx_lent_bodies;
 };
 
 class ue : public srsran::read_pdu_interface, public mac_ta_ue_interface
@@ -163,7 +179,13 @@ public:
                         const sched_interface::dl_sched_pdu_t pdu[sched_interface::MAX_RLC_PDU_LIST],
                         uint32_t                              nof_pdu_elems,
                         uint32_t                              grant_size);
-  uint8_t* generate_mch_pdu(uint32_t                             harq_pid,
+  const srsran_sch_tb_iov_t* generate_pdu_iov(uint32_t                              enb_cc_idx,
+                                              uint32_t                              harq_pid,
+                                              uint32_t                              tb_idx,
+                                              const sched_interface::dl_sched_pdu_t pdu[sched_interface::MAX_RLC_PDU_LIST],
+                                              uint32_t                              nof_pdu_elems,
+                                              uint32_t                              grant_size);
+  uint8_t*                   generate_mch_pdu(uint32_t                             harq_pid,
                             const sched_interface::dl_pdu_mch_t& sched,
                             uint32_t                             nof_pdu_elems,
                             uint32_t                             grant_size);
@@ -187,11 +209,18 @@ public:
   void       metrics_cnt();
 
   uint32_t read_pdu(uint32_t lcid, uint8_t* payload, uint32_t requested_bytes) final;
+  uint32_t read_pdu_sg(uint32_t lcid, uint8_t* payload, uint32_t requested_bytes, srsran::const_byte_span& body) final;
 
 private:
+  bool write_pdu(srsran::byte_buffer_t*                buffer,
+                 srsran_sch_tb_iov_t*                  tb_iov,
+                 const sched_interface::dl_sched_pdu_t pdu[sched_interface::MAX_RLC_PDU_LIST],
+                 uint32_t                              nof_pdu_elems,
+                 uint32_t                              grant_size);
   void allocate_sdu(srsran::sch_pdu* pdu, uint32_t lcid, uint32_t sdu_len);
   bool process_ce(srsran::sch_subh* subh, uint32_t grant_nof_prbs);
   void allocate_ce(srsran::sch_pdu* pdu, uint32_t lcid);
+  void release_lent_bodies(cc_buffer_handler::lent_body_list_t& lent_bodies);
 
   rlc_interface_mac*       rlc = nullptr;
   rrc_interface_mac*       rrc = nullptr;
@@ -225,6 +254,9 @@ private:
 
   srsran::bounded_vector<cc_buffer_handler, SRSRAN_MAX_CARRIERS> cc_buffers;
 
+  // Destination of the RLC PDU bodies read while a zero-copy TB is being generated
+  cc_buffer_handler::lent_body_list_t* pending_lent_bodies = nullptr;
+
   // Mutexes
   std::mutex mutex;
 };
@@ -33,16 +33,13 @@
 #include "srsran/interfaces/enb_gtpu_interfaces.h"
 #include "srsran/phy/common/phy_common.h"
 #include "srsran/srslog/srslog.h"
+#include "srsran/upper/gtpu.h"
 
 #include <netinet/in.h>
 
 #ifndef SRSENB_GTPU_H
 #define SRSENB_GTPU_H
 
-namespace srsran {
-struct gtpu_header_t;
-}
-
 namespace srsenb {
 
 class pdcp_interface_gtpu;
@@ -59,6 +56,7 @@ class gtpu_tunnel_manager
 public:
   // A UE should have <= 3 DRBs active, and each DRB should have two tunnels active at the same time at most
   const static size_t MAX_TUNNELS_PER_UE = 10;
+  const static int    GTPU_PORT          = 2152;
 
   enum class tunnel_state { pdcp_active, buffering, forward_to, forwarded_from, inactive };
 
@@ -69,6 +67,9 @@ public:
     uint32_t teid_out      = 0;
     uint32_t spgw_addr     = 0;
 
+    srsran::gtpu_tx_header_template tx_header;          ///< header of the G-PDUs sent through the tunnel
+    sockaddr_in                     spgw_sockaddr = {}; ///< destination of the G-PDUs sent through the tunnel
+
     tunnel_state                                    state = tunnel_state::pdcp_active;
     srsran::unique_timer                            rx_timer;
     srsran::byte_buffer_pool_ptr<buffered_sdu_list> buffer;
@@ -107,7 +108,9 @@ public:
   void init(const gtpu_args_t& gtpu_args, pdcp_interface_gtpu* pdcp_);
 
   bool                           has_teid(uint32_t teid) const { return tunnels.contains(teid); }
+  void                           prefetch_tunnel(uint32_t teid) const { tunnels.prefetch(teid); }
   const tunnel*                  find_tunnel(uint32_t teid);
+  const tunnel*                  find_tx_tunnel(uint16_t rnti, uint32_t eps_bearer_id);
   ue_bearer_tunnel_list*         find_rnti_tunnels(uint16_t rnti);
   srsran::span<bearer_teid_pair> find_rnti_bearer_tunnels(uint16_t rnti, uint32_t eps_bearer_id);
 
@@ -139,6 +142,18 @@ private:
 
   std::unordered_map<uint16_t, ue_bearer_tunnel_list> ue_teidin_db;
   tunnel_list_t                                       tunnels;
+
+  // Direct-mapped cache of the tunnel used to send the PDUs of each bearer. The entries are only valid for the version
+  // of the tunnels they were stored with, which changes when any tunnel is added, removed or gets a new rnti
+  struct tx_tunnel_cache_entry {
+    uint16_t rnti          = SRSRAN_INVALID_RNTI;
+    uint32_t eps_bearer_id = srsran::INVALID_EPS_BEARER_ID;
+    uint32_t teid          = 0;
+    uint32_t version       = 0;
+  };
+  static const size_t                                     TX_TUNNEL_CACHE_SIZE = 256;
+  std::array<tx_tunnel_cache_entry, TX_TUNNEL_CACHE_SIZE> tx_tunnel_cache;
+  uint32_t                                                tunnels_version = 1;
 };
 
 using gtpu_tunnel_state = gtpu_tunnel_manager::tunnel_state;
@@ -173,10 +188,12 @@ public:
 
   // stack interface
   void handle_gtpu_s1u_rx_packet(srsran::unique_byte_buffer_t pdu, const sockaddr_in& addr);
+  void handle_gtpu_s1u_rx_packets(srsran::span<srsran::unique_byte_buffer_t> pdus,
+                                  srsran::span<const sockaddr_in>           addrs);
   void handle_gtpu_m1u_rx_packet(srsran::unique_byte_buffer_t pdu, const sockaddr_in& addr);
 
 private:
-  static const int GTPU_PORT = 2152;
+  static const int GTPU_PORT = gtpu_tunnel_manager::GTPU_PORT;
 
   void rem_tunnel(uint32_t teidin);
 
@@ -225,10 +242,22 @@ private:
   // Tx sequence number for signaling messages
   uint32_t tx_seq = 0;
 
-  // Socket file descriptor
-  int fd = -1;
+  // S1-U socket, of the backend selected in the arguments
+  std::unique_ptr<srsran::datagram_socket> s1u_socket;
+
+  // Consecutive SDUs received through the same tunnel, which are written to PDCP at once
+  using rx_sdu_list = srsran::bounded_vector<srsran::unique_byte_buffer_t, srsran::MAX_SDU_BATCH_SIZE>;
+  struct rx_sdu_batch {
+    uint32_t    teid_in       = 0;
+    uint16_t    rnti          = SRSRAN_INVALID_RNTI;
+    uint32_t    eps_bearer_id = 0;
+    rx_sdu_list sdus;
+  } rx_batch;
 
   void send_pdu_to_tunnel(const gtpu_tunnel& tx_tun, srsran::unique_byte_buffer_t pdu, int pdcp_sn = -1);
+  void handle_s1u_rx_packet(srsran::unique_byte_buffer_t pdu, const sockaddr_in& addr);
+  void batch_rx_sdu(const gtpu_tunnel& rx_tunnel, srsran::unique_byte_buffer_t sdu);
+  void flush_rx_sdus();
 
   void echo_response(in_addr_t addr, in_port_t port, uint16_t seq);
   void error_indication(in_addr_t addr, in_port_t port, uint32_t err_teid);
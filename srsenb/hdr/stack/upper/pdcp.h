@@ -20,6 +20,7 @@
  */
 
 #include "srsenb/hdr/common/rnti_pool.h"
+#include "srsran/common/rcu.h"
 #include "srsran/common/timers.h"
 #include "srsran/interfaces/enb_metrics_interface.h"
 #include "srsran/interfaces/enb_pdcp_interfaces.h"
@@ -43,9 +44,15 @@ class pdcp : public pdcp_interface_rlc, public pdcp_interface_gtpu, public pdcp_
 public:
   pdcp(srsran::task_sched_handle task_sched_, srslog::basic_logger& logger);
   virtual ~pdcp() {}
-  void init(rlc_interface_pdcp* rlc_, rrc_interface_pdcp* rrc_, gtpu_interface_pdcp* gtpu_);
+  void init(rlc_interface_pdcp*                 rlc_,
+            rrc_interface_pdcp*                 rrc_,
+            gtpu_interface_pdcp*                gtpu_,
+            const srsran::pdcp_tx_batch_args_t& tx_batch_args = {});
   void stop();
 
+  // Flushes the TX batch stage, if enabled, so that the SDUs received in the last TTI reach RLC
+  void tti_clock();
+
   // pdcp_interface_rlc
   void write_pdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t sdu) override;
   void notify_delivery(uint16_t rnti, uint32_t lcid, const srsran::pdcp_sn_vector_t& pdcp_sn) override;
@@ -70,6 +77,7 @@ public:
   void reestablish(uint16_t rnti) override;
 
   // pdcp_interface_gtpu
+  void write_sdus(uint16_t rnti, uint32_t lcid, srsran::span<srsran::unique_byte_buffer_t> sdus) override;
   std::map<uint32_t, srsran::unique_byte_buffer_t> get_buffered_pdus(uint16_t rnti, uint32_t lcid) override;
 
   // Metrics
@@ -125,7 +133,13 @@ private:
 
   void clear_user(user_interface* ue);
 
+  // Declared before the users, whose PDCP entities may hold pending PDUs
+  std::unique_ptr<srsran::pdcp_tx_batch> tx_batch;
+
+  // The users are owned by the map and looked up in the RNTI-indexed table. All methods are called from the Stack
+  // thread, so the removed users can be destroyed without waiting for a grace period
   std::map<uint32_t, user_interface> users;
+  srsran::rcu_table<user_interface>  user_table{1u << 16u};
 
   rlc_interface_pdcp*       rlc  = nullptr;
   rrc_interface_pdcp*       rrc  = nullptr;
@@ -20,12 +20,15 @@
  */
 
 #include "srsenb/hdr/common/rnti_pool.h"
+#include "srsran/common/rcu.h"
 #include "srsran/interfaces/enb_metrics_interface.h"
 #include "srsran/interfaces/enb_rlc_interfaces.h"
 #include "srsran/interfaces/ue_interfaces.h"
 #include "srsran/rlc/rlc.h"
 #include "srsran/srslog/srslog.h"
+#include <list>
 #include <map>
+#include <mutex>
 
 #ifndef SRSENB_RLC_H
 #define SRSENB_RLC_H
@@ -72,8 +75,10 @@ public:
   const char* get_rb_name(uint32_t lcid);
   bool        sdu_queue_is_full(uint16_t rnti, uint32_t lcid);
 
-  // rlc_interface_mac
+  // rlc_interface_mac. The PDUs are read from the PHY workers, the rest of methods are called from the Stack thread
   int  read_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes);
+  int  read_pdu_sg(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes, srsran::const_byte_span& body);
+  void release_pdu_sg(uint16_t rnti, uint32_t lcid, srsran::const_byte_span body);
   void write_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes);
 
 private:
@@ -100,11 +105,23 @@ private:
 
   void update_bsr(uint32_t rnti, uint32_t lcid, uint32_t tx_queue, uint32_t retx_queue);
 
-  pthread_rwlock_t rwlock;
-
+  // The users are owned by the map, which is only accessed from the Stack thread, and looked up in the RNTI-indexed
+  // table, also from the PHY workers. Removed users are destroyed after a grace period
   std::map<uint32_t, user_interface> users;
+  srsran::rcu_table<user_interface>  user_table{1u << 16u};
   std::vector<mch_service_t>         mch_services;
 
+  // Removed users, whose PDUs may still be referenced by TBs held by MAC. They are parked before leaving the table, so
+  // that the releases of MAC always reach the RLC that lent the PDU. The owner is set after the grace period of the
+  // table, and the RLC is destroyed once MAC released its last lent PDU
+  struct removed_user_t {
+    uint16_t                     rnti;
+    srsran::rlc*                 rlc;
+    unique_rnti_ptr<srsran::rlc> owner;
+  };
+  std::mutex                removed_mutex;
+  std::list<removed_user_t> removed_users;
+
   mac_interface_rlc*     mac  = nullptr;
   pdcp_interface_rlc*    pdcp = nullptr;
   rrc_interface_rlc*     rrc  = nullptr;
@@ -2181,6 +2181,12 @@ int set_derived_args_nr(all_args_t* args_, rrc_nr_cfg_t* rrc_nr_cfg_, phy_cfg_t*
   args_->nr_stack.mac.pcap.enable = args_->stack.mac_pcap.enable;
   args_->nr_stack.log             = args_->stack.log;
 
+  // MAC-NR UL link adaptation follows the LTE scheduler options
+  args_->nr_stack.mac.sched_cfg.target_bler               = args_->stack.mac.sched.target_bler;
+  args_->nr_stack.mac.sched_cfg.max_delta_ul_snr          = args_->stack.mac.sched.max_delta_ul_snr;
+  args_->nr_stack.mac.sched_cfg.adaptive_ul_mcs_step_size = args_->stack.mac.sched.adaptive_ul_mcs_step_size;
+  args_->nr_stack.mac.sched_cfg.ul_snr_avg_alpha          = args_->stack.mac.sched.ul_snr_avg_alpha;
+
   // Sanity check for unsupported/untested configuration
   for (auto& cfg : rrc_nr_cfg_->cell_list) {
     if (cfg.phy_cell.carrier.nof_prb != 52) {
@@ -101,6 +101,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
 
     ("rf.dl_earfcn",      bpo::value<uint32_t>(&args->enb.dl_earfcn)->default_value(0),   "Force Downlink EARFCN for single cell")
     ("rf.srate",          bpo::value<double>(&args->rf.srate_hz)->default_value(0.0),     "Force Tx and Rx sampling rate in Hz")
+    ("rf.resampler",      bpo::value<string>(&args->rf.resampler)->default_value("fft"),  "Resampler from the forced sampling rate: fft (integer ratios) or poly (any ratio)")
     ("rf.rx_gain",        bpo::value<float>(&args->rf.rx_gain)->default_value(50),        "Front-end receiver gain")
     ("rf.tx_gain",        bpo::value<float>(&args->rf.tx_gain)->default_value(70),        "Front-end transmitter gain")
     ("rf.tx_gain[0]",     bpo::value<float>(&args->rf.tx_gain_ch[0])->default_value(-1),  "Front-end transmitter gain CH0")
@@ -114,6 +115,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("rf.device_name",       bpo::value<string>(&args->rf.device_name)->default_value("auto"),       "Front-end device name")
     ("rf.device_args",       bpo::value<string>(&args->rf.device_args)->default_value("auto"),       "Front-end device arguments")
     ("rf.time_adv_nsamples", bpo::value<string>(&args->rf.time_adv_nsamples)->default_value("auto"), "Transmission time advance")
+    ("rf.virtual_clock",     bpo::value<bool>(&args->rf.virtual_clock)->default_value(false),        "Run on the radio time instead of the wall clock (zmq and file devices)")
 
     ("gui.enable",        bpo::value<bool>(&args->gui.enable)->default_value(false),          "Enable GUI plots")
 
@@ -182,6 +184,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("scheduler.init_dl_cqi", bpo::value<int>(&args->stack.mac.sched.init_dl_cqi)->default_value(5), "DL CQI value used before any CQI report is available to the eNB")
     ("scheduler.max_sib_coderate", bpo::value<float>(&args->stack.mac.sched.max_sib_coderate)->default_value(0.8), "Upper bound on SIB and RAR grants coderate")
     ("scheduler.pdcch_cqi_offset", bpo::value<int>(&args->stack.mac.sched.pdcch_cqi_offset)->default_value(0), "CQI offset in derivation of PDCCH aggregation level")
+    ("scheduler.lookahead", bpo::value<uint32_t>(&args->stack.mac.sched.lookahead)->default_value(0), "Number of TTIs the DL/UL scheduling is computed ahead of the PHY, in a dedicated MAC thread (0 to disable)")
 
     /*Slicing conifguration*/
     ("slicing.enable_eMBB", bpo::value<bool>(&args->nr_stack.ngap.nssai[0].active)->default_value(true), "Enables enhanced mobile broadband (eMBB) slice in the gNodeB")
@@ -276,9 +279,17 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("expert.eia_pref_list", bpo::value<string>(&args->general.eia_pref_list)->default_value("EIA2, EIA1, EIA0"), "Ordered preference list for the selection of integrity algorithm (EIA) (default: EIA2, EIA1, EIA0).")
     ("expert.nof_prealloc_ues", bpo::value<uint32_t>(&args->stack.mac.nof_prealloc_ues)->default_value(8), "Number of UE resources to preallocate during eNB initialization.")
     ("expert.lcid_padding", bpo::value<int>(&args->stack.mac.lcid_padding)->default_value(3), "LCID on which to put MAC padding")
+    ("expert.pdcp_tx_batch", bpo::value<bool>(&args->stack.pdcp_tx_batch.enable)->default_value(false), "Integrity protect and cipher the PDCP PDUs of all bearers in batches, flushed every TTI")
+    ("expert.pdcp_tx_batch_max_size", bpo::value<uint32_t>(&args->stack.pdcp_tx_batch.max_batch_size)->default_value(256), "Number of pending PDCP PDUs that forces a flush of the TX batch")
+    ("expert.pdcp_tx_batch_max_delay_us", bpo::value<uint32_t>(&args->stack.pdcp_tx_batch.max_delay_us)->default_value(1000), "Maximum time a PDCP PDU waits in the TX batch before a flush is forced (in us)")
+    ("expert.pdcp_tx_batch_workers", bpo::value<uint32_t>(&args->stack.pdcp_tx_batch.nof_workers)->default_value(0), "Number of worker threads that process the PDCP TX batches (0 to use the stack thread)")
+    ("expert.mac_dl_zero_copy", bpo::value<bool>(&args->stack.mac.dl_zero_copy)->default_value(false), "Pass RLC AM PDUs by reference to the PHY encoder instead of copying them into the DL MAC PDU")
     ("expert.max_mac_dl_kos", bpo::value<uint32_t>(&args->general.max_mac_dl_kos)->default_value(100), "Maximum number of consecutive KOs in DL before triggering the UE's release (default 100).")
     ("expert.max_mac_ul_kos", bpo::value<uint32_t>(&args->general.max_mac_ul_kos)->default_value(100), "Maximum number of consecutive KOs in UL before triggering the UE's release (default 100).")
     ("expert.gtpu_tunnel_timeout", bpo::value<uint32_t>(&args->stack.gtpu_indirect_tunnel_timeout_msec)->default_value(0), "Maximum time that GTPU takes to release indirect forwarding tunnel since the last received GTPU PDU (0 for infinity).")
+    ("expert.gtpu_socket_type", bpo::value<string>(&args->stack.gtpu_socket_type)->default_value("udp"), "Backend of the S1-U socket: udp or af_xdp (falls back to udp if the AF_XDP socket cannot be created)")
+    ("expert.gtpu_xdp_if_name", bpo::value<string>(&args->stack.gtpu_xdp_if_name)->default_value(""), "Interface where the S1-U traffic is received, for the af_xdp socket")
+    ("expert.gtpu_xdp_queue", bpo::value<uint32_t>(&args->stack.gtpu_xdp_queue_id)->default_value(0), "Rx queue of the interface where the S1-U traffic is steered to, for the af_xdp socket")
     ("expert.rlf_release_timer_ms", bpo::value<uint32_t>(&args->general.rlf_release_timer_ms)->default_value(4000), "Time taken by eNB to release UE context after it detects an RLF.")
     ("expert.extended_cp", bpo::value<bool>(&args->phy.extended_cp)->default_value(false), "Use extended cyclic prefix")
     ("expert.ts1_reloc_prep_timeout", bpo::value<uint32_t>(&args->stack.s1ap.ts1_reloc_prep_timeout)->default_value(10000), "S1AP TS 36.413 TS1RelocPrep Expiry Timeout value in milliseconds.")
@@ -390,6 +401,21 @@ void parse_args(all_args_t* args, int argc, char* argv[])
               args->stack.mac.sched.max_nof_ctrl_symbols);
       exit(1);
     }
+    if (args->stack.mac.sched.lookahead > 0) {
+      fprintf(stderr,
+              "scheduler.lookahead = %d. Scheduling lookahead is not supported with MBMS\n",
+              args->stack.mac.sched.lookahead);
+      exit(1);
+    }
+  }
+
+  // Check scheduling lookahead. The clamped value is used both by the MAC and by the scheduler HARQ timing
+  if (args->stack.mac.sched.lookahead > srsenb::sched_interface::MAX_LOOKAHEAD) {
+    fprintf(stderr,
+            "scheduler.lookahead = %d. Value is not supported, using %d instead\n",
+            args->stack.mac.sched.lookahead,
+            srsenb::sched_interface::MAX_LOOKAHEAD);
+    args->stack.mac.sched.lookahead = srsenb::sched_interface::MAX_LOOKAHEAD;
   }
 
   // Check PRACH workers
@@ -498,6 +524,12 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     exit(1);
   }
 
+  // With a virtual clock, the samples of a subframe must be sent before the next one is received
+  if (args->rf.virtual_clock && args->phy.nof_phy_threads != 1) {
+    cout << "Using 1 PHY thread with the virtual clock" << endl;
+    args->phy.nof_phy_threads = 1;
+  }
+
   srsran_use_standard_symbol_size(use_standard_lte_rates);
 }
 
@@ -656,8 +656,11 @@ int cc_worker::encode_pdsch(stack_interface_phy_lte::dl_sched_grant_t* grants, u
         dl_cfg.pdsch.softbuffers.tx[j] = grants[i].softbuffer_tx[j];
       }
 
-      // Encode PDSCH
-      if (srsran_enb_dl_put_pdsch(&enb_dl, &dl_cfg.pdsch, grants[i].data)) {
+      // Encode PDSCH, gathering the TB fragments directly if the MAC provided them
+      int ret = (grants[i].data_iov[0] != nullptr || grants[i].data_iov[1] != nullptr)
+                    ? srsran_enb_dl_put_pdsch_iov(&enb_dl, &dl_cfg.pdsch, grants[i].data_iov)
+                    : srsran_enb_dl_put_pdsch(&enb_dl, &dl_cfg.pdsch, grants[i].data);
+      if (ret) {
         Error("Error putting PDSCH %d", i);
         return SRSRAN_ERROR;
       }
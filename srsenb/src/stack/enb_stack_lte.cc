@@ -134,7 +134,7 @@ int enb_stack_lte::init(const stack_args_t&      args_,
     return SRSRAN_ERROR;
   }
   rlc.init(&pdcp, &rrc, &mac, task_sched.get_timer_handler());
-  pdcp.init(&rlc, &rrc, gtpu_adapter.get());
+  pdcp.init(&rlc, &rrc, gtpu_adapter.get(), args.pdcp_tx_batch);
   if (rrc.init(rrc_cfg, phy, &mac, &rlc, &pdcp, &s1ap, &gtpu, x2_) != SRSRAN_SUCCESS) {
     stack_logger.error("Couldn't initialize RRC");
     return SRSRAN_ERROR;
@@ -151,6 +151,9 @@ int enb_stack_lte::init(const stack_args_t&      args_,
   gtpu_args.mme_addr                     = args.s1ap.mme_addr;
   gtpu_args.gtp_bind_addr                = args.s1ap.gtp_bind_addr;
   gtpu_args.indirect_tunnel_timeout_msec = args.gtpu_indirect_tunnel_timeout_msec;
+  gtpu_args.socket_type                  = args.gtpu_socket_type;
+  gtpu_args.xdp_if_name                  = args.gtpu_xdp_if_name;
+  gtpu_args.xdp_queue_id                 = args.gtpu_xdp_queue_id;
   if (gtpu.init(gtpu_args, gtpu_adapter.get()) != SRSRAN_SUCCESS) {
     stack_logger.error("Couldn't initialize GTPU");
     return SRSRAN_ERROR;
@@ -172,6 +175,7 @@ void enb_stack_lte::tti_clock()
 void enb_stack_lte::tti_clock_impl()
 {
   task_sched.tic();
+  pdcp.tti_clock();
   rrc.tti_clock();
 }
 
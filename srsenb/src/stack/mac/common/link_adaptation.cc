@@ -0,0 +1,54 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/mac/common/link_adaptation.h"
+
+namespace srsenb {
+
+olla_ctrl::olla_ctrl(float target_bler, float step_up_, float max_offset_) :
+  step_up(step_up_),
+  step_down(target_bler > 0 ? (1 - target_bler) * step_up_ / target_bler : 0),
+  max_offset(max_offset_)
+{}
+
+void olla_ctrl::update(bool ack, int mcs, int max_mcs)
+{
+  // Note: Avoid keeping increasing the offset, if MCS is already is at its limit
+  float step_down_eff = mcs <= 0 ? 0 : step_down;
+  float step_up_eff   = mcs >= max_mcs ? 0 : step_up;
+  offset_ += ack ? step_up_eff : -step_down_eff;
+  offset_ = std::min(std::max(-max_offset, offset_), max_offset);
+}
+
+void mcs_lookup_table::init(uint32_t nof_levels, uint32_t max_nof_prb, const compute_func_t& compute_func)
+{
+  srsran_assert(nof_levels > 0 and max_nof_prb > 0, "Invalid MCS table dimensions");
+  nof_levels_  = nof_levels;
+  max_nof_prb_ = max_nof_prb;
+  table.resize(nof_levels * max_nof_prb);
+  for (uint32_t level = 0; level < nof_levels; ++level) {
+    for (uint32_t nof_prb = 1; nof_prb <= max_nof_prb; ++nof_prb) {
+      table[level * max_nof_prb + nof_prb - 1] = compute_func(level, nof_prb);
+    }
+  }
+}
+
+} // namespace srsenb
@@ -90,6 +90,22 @@ bool mac::init(const mac_args_t&        args_,
       8, 8, args.nof_prealloc_ues, init_softbuffers, recycle_softbuffers));
 
   detected_rachs.resize(cells.size());
+
+  if (args.sched.lookahead > 0) {
+    auto sched_func = [this](uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res, ul_sched_list_t& ul_sched_res) {
+      if (run_dl_sched(tti_tx_dl, dl_sched_res) < SRSRAN_SUCCESS) {
+        return SRSRAN_ERROR;
+      }
+      return run_ul_sched(TTI_ADD(tti_tx_dl, FDD_HARQ_DELAY_DL_MS), ul_sched_res);
+    };
+    auto retx_drop_func = [this](uint32_t tti_tx_ul, uint16_t rnti, uint32_t enb_cc_idx) {
+      scheduler.ul_retx_dropped(tti_tx_ul, rnti, enb_cc_idx);
+    };
+    lookahead.reset(new sched_lookahead(
+        args.sched.lookahead, cells.size(), sched_func, retx_drop_func, logger, LOOKAHEAD_THREAD_PRIO));
+    logger.info("Scheduling DL/UL decisions %d TTIs ahead of the PHY", lookahead->get_lookahead());
+  }
+
   // AO
   AO_LogsHelper::open_lookup_file(wb_cqi_log_file, WB_CQI_FILE);
   AO_LogsHelper::open_lookup_file(sb_cqi_log_file, SB_CQI_FILE);
@@ -103,6 +119,11 @@ bool mac::init(const mac_args_t&        args_,
 
 void mac::stop()
 {
+  // Note: The lookahead thread must be stopped before taking the write lock, as it takes the read lock
+  if (lookahead != nullptr) {
+    lookahead->stop();
+  }
+
   srsran::rwlock_write_guard lock(rwlock);
   if (started) {
     AO_LogsHelper::close_lookup_file(wb_cqi_log_file);
@@ -228,8 +249,10 @@ int mac::ue_rem(uint16_t rnti)
   scheduler.ue_rem(rnti);
 
   // Remove UE from the perspective of L1
-  // Note: Let any pending retx ACK to arrive, so that PHY recognizes rnti
-  task_sched.defer_callback(FDD_HARQ_DELAY_DL_MS + FDD_HARQ_DELAY_UL_MS, [this, rnti]() {
+  // Note: Let any pending retx ACK to arrive, so that PHY recognizes rnti. Results computed ahead of time may still
+  // refer to the UE buffers
+  uint32_t rem_delay = FDD_HARQ_DELAY_DL_MS + FDD_HARQ_DELAY_UL_MS + args.sched.lookahead;
+  task_sched.defer_callback(rem_delay, [this, rnti]() {
     phy_h->rem_rnti(rnti);
     srsran::rwlock_write_guard lock(rwlock);
     ue_db.erase(rnti);
@@ -276,6 +299,9 @@ void mac::get_metrics(mac_metrics_t& metrics)
     metrics.cc_info[cc].cc_rach_counter = detected_rachs[cc];
     metrics.cc_info[cc].pci             = (cc < cell_config.size()) ? cell_config[cc].cell.id : 0;
   }
+  if (lookahead != nullptr) {
+    lookahead->get_metrics(metrics.lookahead);
+  }
 }
 
 void mac::toggle_padding()
@@ -332,7 +358,13 @@ int mac::crc_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, uint32_t
   rrc_h->set_radiolink_ul_state(rnti, crc);
 
   // Scheduler uses eNB's CC mapping
-  return scheduler.ul_crc_info(tti_rx, rnti, enb_cc_idx, crc);
+  int ret = scheduler.ul_crc_info(tti_rx, rnti, enb_cc_idx, crc);
+
+  // Note: The scheduler must know the CRC before the lookahead drops the retx of the same HARQ
+  if (lookahead != nullptr) {
+    lookahead->crc_info(tti_rx, rnti, enb_cc_idx, crc);
+  }
+  return ret;
 }
 
 int mac::push_pdu(uint32_t tti_rx,
@@ -671,6 +703,17 @@ void mac::rach_detected(uint32_t tti, uint32_t enb_cc_idx, uint32_t preamble_idx
 }
 
 int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
+{
+  if (!started) {
+    return 0;
+  }
+  if (lookahead != nullptr) {
+    return lookahead->get_dl_sched(tti_tx_dl, dl_sched_res_list);
+  }
+  return run_dl_sched(tti_tx_dl, dl_sched_res_list);
+}
+
+int mac::run_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
 {
   if (!started) {
     return 0;
@@ -712,17 +755,32 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
 
           // If the Rx soft-buffer is not given, abort transmission
           if (dl_sched_res->pdsch[n].softbuffer_tx[tb] == nullptr) {
+            dl_sched_res->pdsch[n].data_iov[tb] = nullptr;
             continue;
           }
 
-          if (sched_result.data[i].nof_pdu_elems[tb] > 0) {
+          if (sched_result.data[i].nof_pdu_elems[tb] > 0 and args.dl_zero_copy and not pcap and not pcap_net) {
+            /* Get PDU as a fragment list if it's a new transmission. MAC PCAP requires a contiguous PDU */
+            dl_sched_res->pdsch[n].data[tb]     = nullptr;
+            dl_sched_res->pdsch[n].data_iov[tb] = ue_db[rnti]->generate_pdu_iov(enb_cc_idx,
+                                                                                sched_result.data[i].dci.pid,
+                                                                                tb,
+                                                                                sched_result.data[i].pdu[tb],
+                                                                                sched_result.data[i].nof_pdu_elems[tb],
+                                                                                sched_result.data[i].tbs[tb]);
+
+            if (!dl_sched_res->pdsch[n].data_iov[tb]) {
+              logger.error("Error! PDU was not generated (rnti=0x%04x, tb=%d)", rnti, tb);
+            }
+          } else if (sched_result.data[i].nof_pdu_elems[tb] > 0) {
             /* Get PDU if it's a new transmission */
-            dl_sched_res->pdsch[n].data[tb] = ue_db[rnti]->generate_pdu(enb_cc_idx,
-                                                                        sched_result.data[i].dci.pid,
-                                                                        tb,
-                                                                        sched_result.data[i].pdu[tb],
-                                                                        sched_result.data[i].nof_pdu_elems[tb],
-                                                                        sched_result.data[i].tbs[tb]);
+            dl_sched_res->pdsch[n].data_iov[tb] = nullptr;
+            dl_sched_res->pdsch[n].data[tb]     = ue_db[rnti]->generate_pdu(enb_cc_idx,
+                                                                            sched_result.data[i].dci.pid,
+                                                                            tb,
+                                                                            sched_result.data[i].pdu[tb],
+                                                                            sched_result.data[i].nof_pdu_elems[tb],
+                                                                            sched_result.data[i].tbs[tb]);
 
             if (!dl_sched_res->pdsch[n].data[tb]) {
               logger.error("Error! PDU was not generated (rnti=0x%04x, tb=%d)", rnti, tb);
@@ -738,7 +796,8 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
             }
           } else {
             /* TB not enabled OR no data to send: set pointers to NULL  */
-            dl_sched_res->pdsch[n].data[tb] = nullptr;
+            dl_sched_res->pdsch[n].data[tb]     = nullptr;
+            dl_sched_res->pdsch[n].data_iov[tb] = nullptr;
           }
 
           tb_count++;
@@ -757,6 +816,7 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
     for (uint32_t i = 0; i < sched_result.rar.size(); i++) {
       // Copy dci info
       dl_sched_res->pdsch[n].dci = sched_result.rar[i].dci;
+      std::fill(std::begin(dl_sched_res->pdsch[n].data_iov), std::end(dl_sched_res->pdsch[n].data_iov), nullptr);
 
       // Set softbuffer (there are no retx in RAR but a softbuffer is required)
       dl_sched_res->pdsch[n].softbuffer_tx[0] = &common_buffers[enb_cc_idx].rar_softbuffer_tx;
@@ -792,6 +852,7 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
     for (uint32_t i = 0; i < sched_result.bc.size(); i++) {
       // Copy dci info
       dl_sched_res->pdsch[n].dci = sched_result.bc[i].dci;
+      std::fill(std::begin(dl_sched_res->pdsch[n].data_iov), std::end(dl_sched_res->pdsch[n].data_iov), nullptr);
 
       // Set softbuffer
       if (sched_result.bc[i].type == sched_interface::dl_sched_bc_t::BCCH) {
@@ -829,6 +890,7 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
       if (ue_db.contains(rnti)) {
         // Copy dci info
         dl_sched_res->pdsch[n].dci = sched_result.po[i].dci;
+        std::fill(std::begin(dl_sched_res->pdsch[n].data_iov), std::end(dl_sched_res->pdsch[n].data_iov), nullptr);
         if (pcap) {
           pcap->write_dl_pch(dl_sched_res->pdsch[n].data[0], sched_result.po[i].tbs, true, tti_tx_dl, enb_cc_idx);
         }
@@ -999,6 +1061,17 @@ uint8_t* mac::assemble_rar(sched_interface::dl_sched_rar_grant_t* grants,
 }
 
 int mac::get_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res_list)
+{
+  if (!started) {
+    return SRSRAN_SUCCESS;
+  }
+  if (lookahead != nullptr) {
+    return lookahead->get_ul_sched(tti_tx_ul, ul_sched_res_list);
+  }
+  return run_ul_sched(tti_tx_ul, ul_sched_res_list);
+}
+
+int mac::run_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res_list)
 {
   if (!started) {
     return SRSRAN_SUCCESS;
@@ -200,6 +200,12 @@ int sched::ul_crc_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, bool
       rnti, [tti_rx, enb_cc_idx, crc](sched_ue& ue) { ue.set_ul_crc(tti_point{tti_rx}, enb_cc_idx, crc); });
 }
 
+int sched::ul_retx_dropped(uint32_t tti_tx_ul, uint16_t rnti, uint32_t enb_cc_idx)
+{
+  return ue_db_access_locked(
+      rnti, [tti_tx_ul, enb_cc_idx](sched_ue& ue) { ue.drop_ul_retx(tti_point{tti_tx_ul}, enb_cc_idx); });
+}
+
 int sched::dl_ri_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t ri_value)
 {
   return ue_db_access_locked(
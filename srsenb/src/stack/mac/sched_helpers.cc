@@ -20,6 +20,7 @@
  */
 
 #include "srsenb/hdr/stack/mac/sched_helpers.h"
+#include "srsenb/hdr/stack/mac/sched_phy_ch/sched_dci.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/common/string_helpers.h"
 #include "srsran/mac/pdu.h"
@@ -313,6 +314,15 @@ bool sched_cell_params_t::set_cfg(uint32_t                             enb_cc_id
   nof_re_table    = generate_nof_re_table(cfg.cell);
   nof_re_lb_table = get_lb_nof_re_x_prb(nof_re_table);
 
+  // precompute max UL MCS for each UL CQI and nof PRBs
+  static const uint32_t nof_cqis = 16;
+  for (uint32_t ulqam64_enabled = 0; ulqam64_enabled < ul_mcs_tables.size(); ++ulqam64_enabled) {
+    ul_mcs_tables[ulqam64_enabled].init(nof_cqis, nof_prb(), [this, ulqam64_enabled](uint32_t cqi, uint32_t nof_prbs) {
+      tbs_info tb = compute_mcs_and_tbs(nof_prbs, get_ul_nof_re(nof_prbs), cqi, 28, true, ulqam64_enabled > 0, false);
+      return mcs_lookup_table::entry_t{tb.mcs, tb.tbs_bytes};
+    });
+  }
+
   return true;
 }
 
@@ -0,0 +1,234 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/mac/sched_lookahead.h"
+#include "srsran/common/common.h"
+#include "srsran/support/srsran_assert.h"
+#include <algorithm>
+
+namespace srsenb {
+
+sched_lookahead::sched_lookahead(uint32_t              lookahead_,
+                                 uint32_t              nof_carriers_,
+                                 sched_func_t          sched_func_,
+                                 retx_drop_func_t      retx_drop_func_,
+                                 srslog::basic_logger& logger_,
+                                 int                   prio) :
+  thread("MAC_LOOKAHEAD"),
+  lookahead(lookahead_),
+  nof_carriers(nof_carriers_),
+  sched_func(std::move(sched_func_)),
+  retx_drop_func(std::move(retx_drop_func_)),
+  logger(logger_)
+{
+  srsran_assert(lookahead <= sched_interface::MAX_LOOKAHEAD,
+                "Scheduling lookahead of %d TTIs not supported (max %d)",
+                lookahead,
+                sched_interface::MAX_LOOKAHEAD);
+  for (tti_result_t& result : results) {
+    result.dl_res.resize(nof_carriers);
+    result.ul_res.resize(nof_carriers);
+  }
+  start(prio);
+}
+
+sched_lookahead::~sched_lookahead()
+{
+  stop();
+}
+
+void sched_lookahead::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (not running) {
+      return;
+    }
+    running = false;
+  }
+  cvar.notify_all();
+  wait_thread_finish();
+}
+
+void sched_lookahead::run_thread()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (running) {
+    if (pending_ttis.empty()) {
+      cvar.wait(lock);
+      continue;
+    }
+    srsran::tti_point tti_tx_dl = pending_ttis.top();
+    pending_ttis.pop();
+    tti_result_t& result = results[tti_tx_dl.to_uint() % RING_SIZE];
+
+    // Note: The entry is not accessed by the PHY until it is set to ready. It would only be reused while being computed
+    // if the PHY fell more than RING_SIZE - lookahead TTIs behind
+    lock.unlock();
+    int ret = sched_func(tti_tx_dl.to_uint(), result.dl_res, result.ul_res);
+    lock.lock();
+
+    if (result.tti_tx_dl == tti_tx_dl) {
+      result.ret        = ret;
+      result.ready_time = clock_t::now();
+      result.state      = state_t::ready;
+      cvar.notify_all();
+    }
+  }
+}
+
+void sched_lookahead::request_until(srsran::tti_point tti_tx_dl)
+{
+  srsran::tti_point last  = tti_tx_dl + lookahead;
+  srsran::tti_point first = tti_tx_dl;
+  if (last_requested.is_valid() and tti_tx_dl <= last_requested + 1) {
+    first = last_requested + 1;
+  }
+  for (srsran::tti_point tti = first; tti <= last; ++tti) {
+    tti_result_t& result = results[tti.to_uint() % RING_SIZE];
+    result.tti_tx_dl     = tti;
+    result.state         = state_t::pending;
+    result.crcs.clear();
+    pending_ttis.push(tti);
+  }
+  last_requested = last;
+  cvar.notify_all();
+}
+
+sched_lookahead::tti_result_t* sched_lookahead::wait_result(srsran::tti_point             tti_tx_dl,
+                                                            std::unique_lock<std::mutex>& lock)
+{
+  if (not running) {
+    return nullptr;
+  }
+  if (not last_requested.is_valid() or last_requested < tti_tx_dl + lookahead) {
+    request_until(tti_tx_dl);
+  }
+
+  tti_result_t& result = results[tti_tx_dl.to_uint() % RING_SIZE];
+  if (result.tti_tx_dl != tti_tx_dl or result.state == state_t::empty) {
+    // TTI older than the first one requested (e.g. during the start)
+    return nullptr;
+  }
+  cvar.wait(lock, [this, &result]() { return result.state != state_t::pending or not running; });
+  if (result.state != state_t::ready or result.tti_tx_dl != tti_tx_dl) {
+    return nullptr;
+  }
+  return &result;
+}
+
+int sched_lookahead::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res)
+{
+  clock_t::time_point          fetch_time = clock_t::now();
+  std::unique_lock<std::mutex> lock(mutex);
+  tti_result_t*                result = wait_result(srsran::tti_point{tti_tx_dl}, lock);
+  if (result == nullptr) {
+    logger.info("SCHED: No scheduling result available for tti_tx_dl=%d", tti_tx_dl);
+    for (auto& cc_res : dl_sched_res) {
+      cc_res.nof_grants = 0;
+      cc_res.cfi        = 1;
+    }
+    return SRSRAN_SUCCESS;
+  }
+
+  // The slack is negative if the PHY had to wait for the result
+  double slack_us = std::chrono::duration<double, std::micro>(fetch_time - result->ready_time).count();
+  min_slack_us    = nof_ttis == 0 ? slack_us : std::min(min_slack_us, slack_us);
+  sum_slack_us += slack_us;
+  nof_ttis++;
+  nof_late_ttis += slack_us < 0 ? 1 : 0;
+  lock.unlock();
+
+  logger.debug("SCHED: tti_tx_dl=%d, lookahead slack=%.1f us", tti_tx_dl, slack_us);
+  dl_sched_res = result->dl_res;
+  return result->ret;
+}
+
+int sched_lookahead::get_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  tti_result_t* result = wait_result(srsran::tti_point{TTI_SUB(tti_tx_ul, FDD_HARQ_DELAY_DL_MS)}, lock);
+  if (result == nullptr) {
+    for (auto& cc_res : ul_sched_res) {
+      cc_res.nof_grants = 0;
+      cc_res.nof_phich  = 0;
+    }
+    return SRSRAN_SUCCESS;
+  }
+  ul_sched_res = result->ul_res;
+  apply_crcs(*result, ul_sched_res);
+  return result->ret;
+}
+
+void sched_lookahead::crc_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, bool crc)
+{
+  srsran::tti_point           tti_tx_dl{TTI_ADD(tti_rx, FDD_HARQ_DELAY_UL_MS)};
+  std::lock_guard<std::mutex> lock(mutex);
+  tti_result_t&               result = results[tti_tx_dl.to_uint() % RING_SIZE];
+  if (result.tti_tx_dl != tti_tx_dl or result.state == state_t::empty or result.crcs.full()) {
+    return;
+  }
+  result.crcs.push_back(crc_t{rnti, enb_cc_idx, crc});
+}
+
+void sched_lookahead::apply_crcs(tti_result_t& result, ul_sched_list_t& ul_sched_res)
+{
+  srsran::tti_point tti_tx_ul = result.tti_tx_dl + FDD_HARQ_DELAY_DL_MS;
+  for (const crc_t& c : result.crcs) {
+    if (not c.crc or c.enb_cc_idx >= ul_sched_res.size()) {
+      continue;
+    }
+    mac_interface_phy_lte::ul_sched_t& cc_res = ul_sched_res[c.enb_cc_idx];
+
+    // ACK the PUSCH, in case its CRC was not known yet when the result was computed
+    for (uint32_t i = 0; i < cc_res.nof_phich; ++i) {
+      if (cc_res.phich[i].rnti == c.rnti) {
+        cc_res.phich[i].ack = true;
+      }
+    }
+
+    // The retx of the same HARQ process is not needed anymore
+    auto* end = std::remove_if(
+        cc_res.pusch, cc_res.pusch + cc_res.nof_grants, [&c](const mac_interface_phy_lte::ul_sched_grant_t& grant) {
+          return grant.dci.rnti == c.rnti and grant.current_tx_nb > 0;
+        });
+    if (end != cc_res.pusch + cc_res.nof_grants) {
+      // The scheduler would otherwise keep waiting for the CRC of the dropped retx
+      retx_drop_func(tti_tx_ul.to_uint(), c.rnti, c.enb_cc_idx);
+    }
+    cc_res.nof_grants = end - cc_res.pusch;
+  }
+}
+
+void sched_lookahead::get_metrics(mac_lookahead_metrics_t& metrics)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  metrics.nof_ttis      = nof_ttis;
+  metrics.nof_late_ttis = nof_late_ttis;
+  metrics.avg_slack_us  = nof_ttis > 0 ? sum_slack_us / nof_ttis : 0;
+  metrics.min_slack_us  = min_slack_us;
+  nof_ttis              = 0;
+  nof_late_ttis         = 0;
+  sum_slack_us          = 0;
+  min_slack_us          = 0;
+}
+
+} // namespace srsenb
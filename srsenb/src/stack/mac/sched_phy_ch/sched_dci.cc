@@ -160,6 +160,20 @@ tbs_info compute_min_mcs_and_tbs_from_required_bytes(uint32_t nof_prb,
 {
   // get max MCS/TBS that meets max coderate requirements
   tbs_info tb_max = compute_mcs_and_tbs(nof_prb, nof_re, cqi, max_mcs, is_ul, ulqam64_enabled, use_tbs_index_alt);
+  return compute_min_mcs_and_tbs_from_required_bytes(
+      tb_max, nof_prb, nof_re, cqi, max_mcs, req_bytes, is_ul, ulqam64_enabled, use_tbs_index_alt);
+}
+
+tbs_info compute_min_mcs_and_tbs_from_required_bytes(const tbs_info& tb_max,
+                                                     uint32_t        nof_prb,
+                                                     uint32_t        nof_re,
+                                                     uint32_t        cqi,
+                                                     uint32_t        max_mcs,
+                                                     uint32_t        req_bytes,
+                                                     bool            is_ul,
+                                                     bool            ulqam64_enabled,
+                                                     bool            use_tbs_index_alt)
+{
   if (tb_max.tbs_bytes + 8 <= (int)req_bytes or tb_max.mcs == 0) {
     // if mcs cannot be lowered or a decrease in TBS index won't meet req_bytes requirement
     return tb_max;
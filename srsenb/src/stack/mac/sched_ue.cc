@@ -269,6 +269,11 @@ void sched_ue::set_ul_crc(tti_point tti_rx, uint32_t enb_cc_idx, bool crc_res)
   cells[enb_cc_idx].set_ul_crc(tti_rx, crc_res);
 }
 
+void sched_ue::drop_ul_retx(tti_point tti_tx_ul, uint32_t enb_cc_idx)
+{
+  cells[enb_cc_idx].drop_ul_retx(tti_tx_ul);
+}
+
 void sched_ue::set_dl_ri(tti_point tti_rx, uint32_t enb_cc_idx, uint32_t ri)
 {
   if (cells[enb_cc_idx].cc_state() != cc_st::idle) {
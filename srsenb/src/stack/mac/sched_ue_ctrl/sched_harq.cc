@@ -323,6 +323,13 @@ bool ul_harq_proc::pop_pending_phich()
   return ret;
 }
 
+void ul_harq_proc::retx_dropped()
+{
+  // The retx was removed after being scheduled, so neither its PUSCH nor the respective PHICH take place
+  pending_phich = false;
+  reset_pending_data();
+}
+
 void ul_harq_proc::reset_pending_data()
 {
   reset_pending_data_common();
@@ -340,7 +347,8 @@ uint32_t ul_harq_proc::get_pending_data() const
  *   Harq Entity
  *******************/
 
-harq_entity::harq_entity(size_t nof_dl_harqs, size_t nof_ul_harqs) : dl_harqs(nof_dl_harqs), ul_harqs(nof_ul_harqs)
+harq_entity::harq_entity(size_t nof_dl_harqs, size_t nof_ul_harqs, uint32_t fb_delay_) :
+  fb_delay(fb_delay_), dl_harqs(nof_dl_harqs), ul_harqs(nof_ul_harqs)
 {
   for (uint32_t i = 0; i < dl_harqs.size(); ++i) {
     dl_harqs[i].init(i);
@@ -369,10 +377,12 @@ void harq_entity::reset()
 
 void harq_entity::new_tti(tti_point tti_rx)
 {
-  last_ttis[tti_rx.to_uint() % last_ttis.size()] = tti_rx;
+  // Note: When scheduling ahead of time, the HARQ feedback is only known up to tti_rx - fb_delay
+  tti_point tti_fb                               = tti_rx - fb_delay;
+  last_ttis[tti_fb.to_uint() % last_ttis.size()] = tti_fb;
   get_ul_harq(to_tx_ul(tti_rx))->new_tti();
   for (auto& hdl : dl_harqs) {
-    hdl.new_tti(to_tx_dl(tti_rx));
+    hdl.new_tti(to_tx_dl(tti_fb));
   }
 }
 
@@ -390,8 +400,9 @@ dl_harq_proc* harq_entity::get_empty_dl_harq(tti_point tti_tx_dl)
 dl_harq_proc* harq_entity::get_pending_dl_harq(tti_point tti_tx_dl)
 {
   if (not is_async) {
-    dl_harq_proc* h = &dl_harqs[tti_tx_dl.to_uint() % nof_dl_harqs()];
-    return (h->has_pending_retx(0, tti_tx_dl) or h->has_pending_retx(1, tti_tx_dl)) ? h : nullptr;
+    dl_harq_proc* h      = &dl_harqs[tti_tx_dl.to_uint() % nof_dl_harqs()];
+    tti_point     tti_fb = tti_tx_dl - fb_delay;
+    return (h->has_pending_retx(0, tti_fb) or h->has_pending_retx(1, tti_fb)) ? h : nullptr;
   }
   return get_oldest_dl_harq(tti_tx_dl);
 }
@@ -449,7 +460,8 @@ dl_harq_proc* harq_entity::get_oldest_dl_harq(tti_point tti_tx_dl)
   uint32_t oldest_tti = 0;
   for (const dl_harq_proc& h : dl_harqs) {
     tti_point ack_tti_rx = h.get_tti() + FDD_HARQ_DELAY_DL_MS;
-    if (h.has_pending_retx(tti_tx_dl) and (last_ttis[ack_tti_rx.to_uint() % last_ttis.size()] == ack_tti_rx)) {
+    if (h.has_pending_retx(tti_tx_dl - fb_delay) and
+        (last_ttis[ack_tti_rx.to_uint() % last_ttis.size()] == ack_tti_rx)) {
       uint32_t x = tti_tx_dl - h.get_tti();
       if (x > oldest_tti) {
         oldest_idx = h.get_id();
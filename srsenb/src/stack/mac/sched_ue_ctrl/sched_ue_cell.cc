@@ -43,7 +43,7 @@ sched_ue_cell::sched_ue_cell(uint16_t rnti_, const sched_cell_params_t& cell_cfg
   rnti(rnti_),
   cell_cfg(&cell_cfg_),
   dci_locations(generate_cce_location_table(rnti_, cell_cfg_)),
-  harq_ent(SCHED_MAX_HARQ_PROC, SCHED_MAX_HARQ_PROC),
+  harq_ent(SCHED_MAX_HARQ_PROC, SCHED_MAX_HARQ_PROC, cell_cfg_.sched_cfg->lookahead),
   tpc_fsm(rnti_,
           cell_cfg->nof_prb(),
           cell_cfg->cfg.target_pucch_ul_sinr,
@@ -57,16 +57,14 @@ sched_ue_cell::sched_ue_cell(uint16_t rnti_, const sched_cell_params_t& cell_cfg
   fixed_mcs_ul(cell_cfg_.sched_cfg->pusch_mcs),
   current_tti(current_tti_),
   max_aggr_level(cell_cfg_.sched_cfg->max_aggr_level >= 0 ? cell_cfg_.sched_cfg->max_aggr_level : 3),
+  dl_olla(cell_cfg_.sched_cfg->target_bler,
+          cell_cfg_.sched_cfg->adaptive_dl_mcs_step_size,
+          cell_cfg_.sched_cfg->max_delta_dl_cqi),
+  ul_olla(cell_cfg_.sched_cfg->target_bler,
+          cell_cfg_.sched_cfg->adaptive_ul_mcs_step_size,
+          cell_cfg_.sched_cfg->max_delta_ul_snr),
   dl_cqi_ctxt(cell_cfg_.nof_prb(), 0, cell_cfg_.sched_cfg->init_dl_cqi)
-{
-  float target_bler = cell_cfg->sched_cfg->target_bler;
-  dl_delta_inc      = cell_cfg->sched_cfg->adaptive_dl_mcs_step_size; // delta_{down} of OLLA
-  dl_delta_dec      = (1 - target_bler) * dl_delta_inc / target_bler;
-  ul_delta_inc      = cell_cfg->sched_cfg->adaptive_ul_mcs_step_size; // delta_{down} of OLLA
-  ul_delta_dec      = (1 - target_bler) * ul_delta_inc / target_bler;
-  max_cqi_coeff     = cell_cfg->sched_cfg->max_delta_dl_cqi;
-  max_snr_coeff     = cell_cfg->sched_cfg->max_delta_ul_snr;
-}
+{}
 
 void sched_ue_cell::set_ue_cfg(const sched_interface::ue_cfg_t& ue_cfg_)
 {
@@ -217,16 +215,12 @@ int sched_ue_cell::set_ul_crc(tti_point tti_rx, bool crc_res)
     auto* ul_harq = harq_ent.get_ul_harq(tti_rx);
     if (ul_harq != nullptr) {
       int mcs = ul_harq->get_mcs(0);
-      // Note: Avoid keeping increasing the snr delta offset, if MCS is already is at its limit
-      float delta_dec_eff = mcs <= 0 ? 0 : ul_delta_dec;
-      float delta_inc_eff = mcs >= (int)max_mcs_ul ? 0 : ul_delta_inc;
-      ul_snr_coeff += crc_res ? delta_inc_eff : -delta_dec_eff;
-      ul_snr_coeff = std::min(std::max(-max_snr_coeff, ul_snr_coeff), max_snr_coeff);
+      ul_olla.update(crc_res, mcs, max_mcs_ul);
       logger.info("SCHED: UL adaptive link: rnti=0x%x, snr_estim=%.2f, last_mcs=%d, snr_offset=%f",
                   rnti,
                   tpc_fsm.get_ul_snr_estim(),
                   mcs,
-                  ul_snr_coeff);
+                  ul_olla.offset());
     }
   }
 
@@ -240,6 +234,18 @@ int sched_ue_cell::set_ul_crc(tti_point tti_rx, bool crc_res)
   return pid;
 }
 
+int sched_ue_cell::drop_ul_retx(tti_point tti_tx_ul)
+{
+  CHECK_VALID_CC("UL retx drop");
+
+  ul_harq_proc* h = harq_ent.get_ul_harq(tti_tx_ul);
+  if (h->get_tti() != tti_tx_ul) {
+    return SRSRAN_ERROR;
+  }
+  h->retx_dropped();
+  return h->get_id();
+}
+
 int sched_ue_cell::set_ack_info(tti_point tti_rx, uint32_t tb_idx, bool ack)
 {
   CHECK_VALID_CC("DL ACK Info");
@@ -254,16 +260,12 @@ int sched_ue_cell::set_ack_info(tti_point tti_rx, uint32_t tb_idx, bool ack)
   // Adapt DL MCS based on BLER
   if (cell_cfg->sched_cfg->target_bler > 0 and fixed_mcs_dl < 0) {
     int mcs = std::get<2>(p2);
-    // Note: Avoid keeping increasing the snr delta offset, if MCS is already is at its limit
-    float delta_dec_eff = mcs <= 0 ? 0 : dl_delta_dec;
-    float delta_inc_eff = mcs >= (int)max_mcs_dl ? 0 : dl_delta_inc;
-    dl_cqi_coeff += ack ? delta_inc_eff : -delta_dec_eff;
-    dl_cqi_coeff = std::min(std::max(-max_cqi_coeff, dl_cqi_coeff), max_cqi_coeff);
+    dl_olla.update(ack, mcs, max_mcs_dl);
     logger.info("SCHED: DL adaptive link: rnti=0x%x, cqi=%d, last_mcs=%d, cqi_offset=%f",
                 rnti,
                 dl_cqi_ctxt.get_avg_cqi(),
                 mcs,
-                dl_cqi_coeff);
+                dl_olla.offset());
   }
   return tbs_acked;
 }
@@ -288,19 +290,19 @@ int sched_ue_cell::get_ul_cqi() const
     return 1;
   }
   float snr = tpc_fsm.get_ul_snr_estim();
-  return srsran_cqi_from_snr(snr + ul_snr_coeff);
+  return srsran_cqi_from_snr(snr + ul_olla.offset());
 }
 
 int sched_ue_cell::get_dl_cqi(const rbgmask_t& rbgs) const
 {
   int min_cqi;
   find_min_cqi_rbgs(rbgs, dl_cqi_ctxt, min_cqi);
-  return std::max(0, (int)std::min(static_cast<float>(min_cqi) + dl_cqi_coeff, 15.0f));
+  return std::max(0, (int)std::min(static_cast<float>(min_cqi) + dl_olla.offset(), 15.0f));
 }
 
 int sched_ue_cell::get_dl_cqi() const
 {
-  return std::max(0, (int)std::min(dl_cqi_ctxt.get_avg_cqi() + dl_cqi_coeff, 15.0f));
+  return std::max(0, (int)std::min(dl_cqi_ctxt.get_avg_cqi() + dl_olla.offset(), 15.0f));
 }
 
 uint32_t sched_ue_cell::get_aggr_level(uint32_t nof_bits) const
@@ -437,8 +439,23 @@ tbs_info cqi_to_tbs_ul(const sched_ue_cell& cell, uint32_t nof_prb, uint32_t nof
   tbs_info ret;
   if (mcs < 0) {
     // Dynamic MCS
-    ret = compute_min_mcs_and_tbs_from_required_bytes(
-        nof_prb, nof_re, cell.get_ul_cqi(), cell.max_mcs_ul, req_bytes, true, ulqam64_enabled, false);
+    uint32_t                         ul_cqi = cell.get_ul_cqi();
+    const mcs_lookup_table::entry_t& entry  = cell.cell_cfg->ul_mcs_tables[ulqam64_enabled].get(ul_cqi, nof_prb);
+    if (nof_re == cell.cell_cfg->get_ul_nof_re(nof_prb) and entry.mcs <= (int)cell.max_mcs_ul) {
+      // Max MCS/TBS is precomputed for PUSCHs without UCI
+      ret = compute_min_mcs_and_tbs_from_required_bytes(tbs_info{entry.tbs_bytes, entry.mcs},
+                                                        nof_prb,
+                                                        nof_re,
+                                                        ul_cqi,
+                                                        cell.max_mcs_ul,
+                                                        req_bytes,
+                                                        true,
+                                                        ulqam64_enabled,
+                                                        false);
+    } else {
+      ret = compute_min_mcs_and_tbs_from_required_bytes(
+          nof_prb, nof_re, ul_cqi, cell.max_mcs_ul, req_bytes, true, ulqam64_enabled, false);
+    }
 
     // If coderate > SRSRAN_MIN(max_coderate, 0.932 * Qm) we should set TBS=0. We don't because it's not correctly
     // handled by the scheduler, but we might be scheduling undecodable codewords at very low SNR
@@ -210,7 +210,17 @@ ue::ue(uint16_t                                 rnti_,
   cc_buffers[enb_cc_idx].allocate_cc(softbuffer_pool->make());
 }
 
-ue::~ue() {}
+ue::~ue()
+{
+  // The UE is removed once its last TBs were transmitted, so the RLC PDUs they referenced can be released
+  for (auto& cc : cc_buffers) {
+    for (uint32_t harq_pid = 0; harq_pid < SRSRAN_FDD_NOF_HARQ; ++harq_pid) {
+      for (uint32_t tb = 0; tb < SRSRAN_MAX_TB; ++tb) {
+        release_lent_bodies(cc.get_tx_lent_bodies(harq_pid, tb));
+      }
+    }
+  }
+}
 
 void ue::reset()
 {
@@ -465,6 +475,29 @@ uint32_t ue::read_pdu(uint32_t lcid, uint8_t* payload, uint32_t requested_bytes)
   return rlc->read_pdu(rnti, lcid, payload, requested_bytes);
 }
 
+uint32_t ue::read_pdu_sg(uint32_t lcid, uint8_t* payload, uint32_t requested_bytes, srsran::const_byte_span& body)
+{
+  uint32_t ret = rlc->read_pdu_sg(rnti, lcid, payload, requested_bytes, body);
+  if (not body.empty()) {
+    if (pending_lent_bodies != nullptr and not pending_lent_bodies->full()) {
+      pending_lent_bodies->push_back({lcid, body});
+    } else {
+      // Nothing would ever release the body otherwise
+      rlc->release_pdu_sg(rnti, lcid, body);
+      logger.error("Zero-copy RLC PDU body read outside of a TB for rnti=0x%x, lcid=%d", rnti, lcid);
+    }
+  }
+  return ret;
+}
+
+void ue::release_lent_bodies(cc_buffer_handler::lent_body_list_t& lent_bodies)
+{
+  for (const cc_buffer_handler::lent_body_t& lent : lent_bodies) {
+    rlc->release_pdu_sg(rnti, lent.lcid, lent.body);
+  }
+  lent_bodies.clear();
+}
+
 void ue::allocate_sdu(srsran::sch_pdu* pdu, uint32_t lcid, uint32_t total_sdu_len)
 {
   const int min_sdu_len = lcid == 0 ? 1 : 2;
@@ -544,6 +577,34 @@ void ue::allocate_ce(srsran::sch_pdu* pdu, uint32_t lcid)
   }
 }
 
+bool ue::write_pdu(srsran::byte_buffer_t*                buffer,
+                   srsran_sch_tb_iov_t*                  tb_iov,
+                   const sched_interface::dl_sched_pdu_t pdu[sched_interface::MAX_RLC_PDU_LIST],
+                   uint32_t                              nof_pdu_elems,
+                   uint32_t                              grant_size)
+{
+  buffer->clear();
+  if (tb_iov != nullptr) {
+    mac_msg_dl.init_tx_iov(buffer, grant_size, tb_iov);
+  } else {
+    mac_msg_dl.init_tx(buffer, grant_size, false);
+  }
+  for (uint32_t i = 0; i < nof_pdu_elems; i++) {
+    if (pdu[i].lcid <= (uint32_t)srsran::ul_sch_lcid::PHR_REPORT) {
+      allocate_sdu(&mac_msg_dl, pdu[i].lcid, pdu[i].nbytes);
+    } else {
+      allocate_ce(&mac_msg_dl, pdu[i].lcid);
+    }
+  }
+  bool ret = mac_msg_dl.write_packet(logger) != nullptr;
+  if (logger.info.enabled()) {
+    fmt::memory_buffer str_buffer;
+    mac_msg_dl.to_string(str_buffer);
+    logger.info("0x%x %s", rnti, srsran::to_c_str(str_buffer));
+  }
+  return ret;
+}
+
 uint8_t* ue::generate_pdu(uint32_t                              enb_cc_idx,
                           uint32_t                              harq_pid,
                           uint32_t                              tb_idx,
@@ -555,21 +616,42 @@ uint8_t* ue::generate_pdu(uint32_t                              enb_cc_idx,
   uint8_t*                    ret = nullptr;
   if (enb_cc_idx < SRSRAN_MAX_CARRIERS && harq_pid < SRSRAN_FDD_NOF_HARQ && tb_idx < SRSRAN_MAX_TB) {
     srsran::byte_buffer_t* buffer = cc_buffers[enb_cc_idx].get_tx_payload_buffer(harq_pid, tb_idx);
-    buffer->clear();
-    mac_msg_dl.init_tx(buffer, grant_size, false);
-    for (uint32_t i = 0; i < nof_pdu_elems; i++) {
-      if (pdu[i].lcid <= (uint32_t)srsran::ul_sch_lcid::PHR_REPORT) {
-        allocate_sdu(&mac_msg_dl, pdu[i].lcid, pdu[i].nbytes);
-      } else {
-        allocate_ce(&mac_msg_dl, pdu[i].lcid);
-      }
+    // A new transmission in this HARQ process replaces the TB that referenced the previous RLC PDUs
+    release_lent_bodies(cc_buffers[enb_cc_idx].get_tx_lent_bodies(harq_pid, tb_idx));
+    if (write_pdu(buffer, nullptr, pdu, nof_pdu_elems, grant_size)) {
+      ret = buffer->msg;
     }
-    ret = mac_msg_dl.write_packet(logger);
-    if (logger.info.enabled()) {
-      fmt::memory_buffer str_buffer;
-      mac_msg_dl.to_string(str_buffer);
-      logger.info("0x%x %s", rnti, srsran::to_c_str(str_buffer));
+  } else {
+    logger.error(
+        "Invalid parameters calling generate_pdu: cc_idx=%d, harq_pid=%d, tb_idx=%d", enb_cc_idx, harq_pid, tb_idx);
+  }
+  return ret;
+}
+
+/* Builds the MAC PDU as a list of fragments. MAC headers, CEs and RLC headers are written to the HARQ payload buffer,
+ * while RLC PDU bodies are referenced from the RLC buffers, avoiding the copy into the MAC PDU. */
+const srsran_sch_tb_iov_t*
+ue::generate_pdu_iov(uint32_t                              enb_cc_idx,
+                     uint32_t                              harq_pid,
+                     uint32_t                              tb_idx,
+                     const sched_interface::dl_sched_pdu_t pdu[sched_interface::MAX_RLC_PDU_LIST],
+                     uint32_t                              nof_pdu_elems,
+                     uint32_t                              grant_size)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  srsran_sch_tb_iov_t*        ret = nullptr;
+  if (enb_cc_idx < SRSRAN_MAX_CARRIERS && harq_pid < SRSRAN_FDD_NOF_HARQ && tb_idx < SRSRAN_MAX_TB) {
+    srsran::byte_buffer_t*               buffer      = cc_buffers[enb_cc_idx].get_tx_payload_buffer(harq_pid, tb_idx);
+    srsran_sch_tb_iov_t*                 tb_iov      = cc_buffers[enb_cc_idx].get_tx_payload_iov(harq_pid, tb_idx);
+    cc_buffer_handler::lent_body_list_t& lent_bodies = cc_buffers[enb_cc_idx].get_tx_lent_bodies(harq_pid, tb_idx);
+    // A new transmission in this HARQ process replaces the TB that referenced the previous RLC PDUs. The bodies read
+    // for the new TB stay pinned by the RLC until the HARQ process is reused, including its retransmissions.
+    release_lent_bodies(lent_bodies);
+    pending_lent_bodies = &lent_bodies;
+    if (write_pdu(buffer, tb_iov, pdu, nof_pdu_elems, grant_size)) {
+      ret = tb_iov;
     }
+    pending_lent_bodies = nullptr;
   } else {
     logger.error(
         "Invalid parameters calling generate_pdu: cc_idx=%d, harq_pid=%d, tb_idx=%d", enb_cc_idx, harq_pid, tb_idx);
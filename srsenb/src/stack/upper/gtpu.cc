@@ -22,6 +22,7 @@
 #include "srsran/upper/gtpu.h"
 #include "srsenb/hdr/stack/upper/gtpu.h"
 #include "srsran/common/common_nr.h"
+#include "srsran/common/int_helpers.h"
 #include "srsran/common/network_utils.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/common/string_helpers.h"
@@ -67,6 +68,24 @@ gtpu_tunnel_manager::ue_bearer_tunnel_list* gtpu_tunnel_manager::find_rnti_tunne
   return it != ue_teidin_db.end() ? &ue_teidin_db[rnti] : nullptr;
 }
 
+const gtpu_tunnel_manager::tunnel* gtpu_tunnel_manager::find_tx_tunnel(uint16_t rnti, uint32_t eps_bearer_id)
+{
+  tx_tunnel_cache_entry& entry = tx_tunnel_cache[(rnti * 16U + eps_bearer_id) % TX_TUNNEL_CACHE_SIZE];
+  if (entry.version == tunnels_version and entry.rnti == rnti and entry.eps_bearer_id == eps_bearer_id) {
+    return &tunnels[entry.teid];
+  }
+  // PDUs are sent through the first tunnel of the bearer
+  srsran::span<bearer_teid_pair> teids = find_rnti_bearer_tunnels(rnti, eps_bearer_id);
+  if (teids.empty()) {
+    return nullptr;
+  }
+  entry.rnti          = rnti;
+  entry.eps_bearer_id = eps_bearer_id;
+  entry.teid          = teids[0].teid;
+  entry.version       = tunnels_version;
+  return &tunnels[entry.teid];
+}
+
 srsran::span<gtpu_tunnel_manager::bearer_teid_pair>
 gtpu_tunnel_manager::find_rnti_bearer_tunnels(uint16_t rnti, uint32_t eps_bearer_id)
 {
@@ -110,6 +129,10 @@ gtpu_tunnel_manager::add_tunnel(uint16_t rnti, uint32_t eps_bearer_id, uint32_t
   tun->eps_bearer_id = eps_bearer_id;
   tun->teid_out      = teidout;
   tun->spgw_addr     = spgw_addr;
+  tun->tx_header.init(teidout);
+  tun->spgw_sockaddr.sin_family      = AF_INET;
+  tun->spgw_sockaddr.sin_addr.s_addr = htonl(spgw_addr);
+  tun->spgw_sockaddr.sin_port        = htons(GTPU_PORT);
 
   if (ue_teidin_db.find(rnti) == ue_teidin_db.end()) {
     auto ret = ue_teidin_db.emplace(rnti, ue_bearer_tunnel_list());
@@ -127,6 +150,7 @@ gtpu_tunnel_manager::add_tunnel(uint16_t rnti, uint32_t eps_bearer_id, uint32_t
   }
   ue_tunnels.push_back(bearer_teid_pair{eps_bearer_id, tun->teid_in});
   std::sort(ue_tunnels.begin(), ue_tunnels.end());
+  tunnels_version++;
 
   fmt::memory_buffer str_buffer;
   srsran::gtpu_ntoa(str_buffer, htonl(spgw_addr));
@@ -157,6 +181,7 @@ bool gtpu_tunnel_manager::update_rnti(uint16_t old_rnti, uint16_t new_rnti)
     return false;
   }
   std::swap(ue_teidin_db[new_rnti], *old_rnti_ptr);
+  tunnels_version++;
   ue_bearer_tunnel_list&                               new_rnti_obj = ue_teidin_db[new_rnti];
   srsran::bounded_vector<uint32_t, MAX_TUNNELS_PER_UE> to_remove;
   for (bearer_teid_pair& bearer : new_rnti_obj) {
@@ -200,6 +225,7 @@ bool gtpu_tunnel_manager::remove_tunnel(uint32_t teidin)
 
   logger.info("Removed rnti=0x%x,eps-BearerID=%d tunnel with " TEID_IN_FMT, tun.rnti, tun.eps_bearer_id, teidin);
   tunnels.erase(teidin);
+  tunnels_version++;
   return true;
 }
 
@@ -399,38 +425,33 @@ int gtpu::init(const gtpu_args_t& gtpu_args, pdcp_interface_gtpu* pdcp_)
 
   tunnels.init(args, pdcp);
 
-  char errbuf[128] = {};
-
-  // Set up socket
-  fd = socket(AF_INET, SOCK_DGRAM, 0);
-  if (fd < 0) {
-    logger.error("Failed to create socket");
+  // Set up and bind socket
+  srsran::datagram_socket_args_t socket_args;
+  if (not srsran::string_to_datagram_socket_type(args.socket_type, &socket_args.type)) {
+    srsran::console("Invalid S1-U socket type \"%s\"\n", args.socket_type.c_str());
     return SRSRAN_ERROR;
   }
-  int enable = 1;
-#if defined(SO_REUSEADDR)
-  if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(int)) < 0)
-    logger.error("setsockopt(SO_REUSEADDR) failed");
-#endif
-#if defined(SO_REUSEPORT)
-  if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(int)) < 0)
-    logger.error("setsockopt(SO_REUSEPORT) failed");
-#endif
-
-  struct sockaddr_in bindaddr;
-  bzero(&bindaddr, sizeof(struct sockaddr_in));
-  // Bind socket
-  if (not net_utils::bind_addr(fd, gtp_bind_addr.c_str(), GTPU_PORT, &bindaddr)) {
-    snprintf(errbuf, sizeof(errbuf), "%s", strerror(errno));
-    srsran::console("Failed to bind on address %s, port %d: %s\n", gtp_bind_addr.c_str(), int(GTPU_PORT), errbuf);
+  socket_args.bind_addr    = gtp_bind_addr;
+  socket_args.bind_port    = GTPU_PORT;
+  socket_args.xdp_if_name  = args.xdp_if_name;
+  socket_args.xdp_queue_id = args.xdp_queue_id;
+  s1u_socket               = srsran::make_datagram_socket(socket_args, logger);
+  if (s1u_socket == nullptr) {
+    srsran::console("Failed to bind on address %s, port %d\n", gtp_bind_addr.c_str(), int(GTPU_PORT));
     return SRSRAN_ERROR;
   }
+  if (s1u_socket->get_type() != socket_args.type) {
+    srsran::console("Failed to open %s S1-U socket, using %s socket\n",
+                    srsran::to_string(socket_args.type),
+                    srsran::to_string(s1u_socket->get_type()));
+  }
 
   // Assign a handler to rx S1U packets
-  auto rx_callback = [this](srsran::unique_byte_buffer_t pdu, const sockaddr_in& from) {
-    handle_gtpu_s1u_rx_packet(std::move(pdu), from);
+  auto rx_callback = [this](srsran::span<srsran::unique_byte_buffer_t> pdus, srsran::span<const sockaddr_in> from) {
+    handle_gtpu_s1u_rx_packets(pdus, from);
   };
-  rx_socket_handler->add_socket_handler(fd, srsran::make_sdu_handler(logger, gtpu_queue, rx_callback));
+  rx_socket_handler->add_socket_handler(s1u_socket->get_fd(),
+                                       srsran::make_sdu_batch_handler(logger, gtpu_queue, *s1u_socket, rx_callback));
 
   // Start MCH socket if enabled
   if (args.embms_enable) {
@@ -443,23 +464,20 @@ int gtpu::init(const gtpu_args_t& gtpu_args, pdcp_interface_gtpu* pdcp_)
 
 void gtpu::stop()
 {
-  if (fd > 0) {
-    close(fd);
-    fd = -1;
-  }
+  // The socket manager, whose Rx handler refers to the socket, is stopped before
+  s1u_socket.reset();
 }
 
 // gtpu_interface_pdcp
 void gtpu::write_pdu(uint16_t rnti, uint32_t eps_bearer_id, srsran::unique_byte_buffer_t pdu)
 {
-  srsran::span<gtpu_tunnel_manager::bearer_teid_pair> teids = tunnels.find_rnti_bearer_tunnels(rnti, eps_bearer_id);
-  if (teids.empty()) {
+  const gtpu_tunnel* tx_tun = tunnels.find_tx_tunnel(rnti, eps_bearer_id);
+  if (tx_tun == nullptr) {
     logger.warning("The rnti=0x%x, eps-BearerID=%d does not have any pdcp_active tunnel", rnti, eps_bearer_id);
     return;
   }
-  const gtpu_tunnel& tx_tun = *tunnels.find_tunnel(teids[0].teid);
-  log_message(tx_tun, false, srsran::make_span(pdu));
-  send_pdu_to_tunnel(tx_tun, std::move(pdu));
+  log_message(*tx_tun, false, srsran::make_span(pdu));
+  send_pdu_to_tunnel(*tx_tun, std::move(pdu));
 }
 
 void gtpu::send_pdu_to_tunnel(const gtpu_tunnel& tx_tun, srsran::unique_byte_buffer_t pdu, int pdcp_sn)
@@ -471,34 +489,12 @@ void gtpu::send_pdu_to_tunnel(const gtpu_tunnel& tx_tun, srsran::unique_byte_buf
     return;
   }
 
-  gtpu_header_t header;
-  header.flags        = GTPU_FLAGS_VERSION_V1 | GTPU_FLAGS_GTP_PROTOCOL;
-  header.message_type = GTPU_MSG_DATA_PDU;
-  header.length       = pdu->N_bytes;
-  header.teid         = tx_tun.teid_out;
-
-  if (pdcp_sn >= 0) {
-    header.flags |= GTPU_FLAGS_EXTENDED_HDR;
-    header.next_ext_hdr_type = GTPU_EXT_HEADER_PDCP_PDU_NUMBER;
-    header.ext_buffer.resize(4u);
-    header.ext_buffer[0] = 0x01u;
-    header.ext_buffer[1] = (pdcp_sn >> 8u) & 0xffu;
-    header.ext_buffer[2] = pdcp_sn & 0xffu;
-    header.ext_buffer[3] = 0;
-  }
-
-  struct sockaddr_in servaddr;
-  servaddr.sin_family      = AF_INET;
-  servaddr.sin_addr.s_addr = htonl(tx_tun.spgw_addr);
-  servaddr.sin_port        = htons(GTPU_PORT);
-
-  if (!gtpu_write_header(&header, pdu.get(), logger)) {
-    logger.error("Error writing GTP-U Header. Flags 0x%x, Message Type 0x%x", header.flags, header.message_type);
+  // The header and the destination address were built when the tunnel was created
+  if (not tx_tun.tx_header.write(pdu.get(), pdcp_sn)) {
+    logger.error("Error writing GTP-U Header. No room in PDU for header");
     return;
   }
-  if (sendto(fd, pdu->msg, pdu->N_bytes, MSG_EOR, (struct sockaddr*)&servaddr, sizeof(struct sockaddr_in)) < 0) {
-    perror("sendto");
-  }
+  s1u_socket->send(*pdu, tx_tun.spgw_sockaddr);
 }
 
 srsran::expected<uint32_t> gtpu::add_bearer(uint16_t            rnti,
@@ -627,6 +623,27 @@ void gtpu::handle_end_marker(const gtpu_tunnel& rx_tunnel)
 }
 
 void gtpu::handle_gtpu_s1u_rx_packet(srsran::unique_byte_buffer_t pdu, const sockaddr_in& addr)
+{
+  handle_s1u_rx_packet(std::move(pdu), addr);
+  flush_rx_sdus();
+}
+
+void gtpu::handle_gtpu_s1u_rx_packets(srsran::span<srsran::unique_byte_buffer_t> pdus,
+                                      srsran::span<const sockaddr_in>           addrs)
+{
+  for (size_t i = 0; i < pdus.size(); ++i) {
+    // Load the tunnel of the next packet into the cache while this one is handled
+    if (i + 1 < pdus.size() and pdus[i + 1]->N_bytes >= GTPU_BASE_HEADER_LEN) {
+      uint32_t next_teid;
+      uint8_to_uint32(&pdus[i + 1]->msg[4], &next_teid);
+      tunnels.prefetch_tunnel(next_teid);
+    }
+    handle_s1u_rx_packet(std::move(pdus[i]), addrs[i]);
+  }
+  flush_rx_sdus();
+}
+
+void gtpu::handle_s1u_rx_packet(srsran::unique_byte_buffer_t pdu, const sockaddr_in& addr)
 {
   srsran_assert(pdu != nullptr, "Called with null PDU");
 
@@ -666,6 +683,8 @@ void gtpu::handle_gtpu_s1u_rx_packet(srsran::unique_byte_buffer_t pdu, const soc
       handle_msg_data_pdu(header, *tun_ptr, std::move(pdu));
     } break;
     case GTPU_MSG_END_MARKER:
+      // The SDUs received before the End Marker are delivered before the tunnels are switched
+      flush_rx_sdus();
       handle_end_marker(*tun_ptr);
       break;
     default:
@@ -708,7 +727,12 @@ void gtpu::handle_msg_data_pdu(const gtpu_header_t&         header,
       break;
     }
     case gtpu_tunnel_manager::tunnel_state::pdcp_active: {
-      pdcp->write_sdu(rnti, eps_bearer_id, std::move(pdu), pdcp_sn == undefined_pdcp_sn ? -1 : (int)pdcp_sn);
+      if (pdcp_sn == undefined_pdcp_sn) {
+        batch_rx_sdu(rx_tunnel, std::move(pdu));
+      } else {
+        flush_rx_sdus();
+        pdcp->write_sdu(rnti, eps_bearer_id, std::move(pdu), (int)pdcp_sn);
+      }
       break;
     }
     case gtpu_tunnel_manager::tunnel_state::forwarded_from:
@@ -718,6 +742,26 @@ void gtpu::handle_msg_data_pdu(const gtpu_header_t&         header,
   }
 }
 
+void gtpu::batch_rx_sdu(const gtpu_tunnel& rx_tunnel, srsran::unique_byte_buffer_t sdu)
+{
+  if (not rx_batch.sdus.empty() and (rx_batch.teid_in != rx_tunnel.teid_in or rx_batch.sdus.full())) {
+    flush_rx_sdus();
+  }
+  rx_batch.teid_in       = rx_tunnel.teid_in;
+  rx_batch.rnti          = rx_tunnel.rnti;
+  rx_batch.eps_bearer_id = rx_tunnel.eps_bearer_id;
+  rx_batch.sdus.push_back(std::move(sdu));
+}
+
+void gtpu::flush_rx_sdus()
+{
+  if (rx_batch.sdus.empty()) {
+    return;
+  }
+  pdcp->write_sdus(rx_batch.rnti, rx_batch.eps_bearer_id, rx_batch.sdus);
+  rx_batch.sdus.clear();
+}
+
 void gtpu::handle_gtpu_m1u_rx_packet(srsran::unique_byte_buffer_t pdu, const sockaddr_in& addr)
 {
   m1u.handle_rx_packet(std::move(pdu), addr);
@@ -776,7 +820,7 @@ void gtpu::error_indication(in_addr_t addr, in_port_t port, uint32_t err_teid)
   servaddr.sin_addr.s_addr = addr;
   servaddr.sin_port        = port;
 
-  sendto(fd, pdu->msg, 12, MSG_EOR, (struct sockaddr*)&servaddr, sizeof(struct sockaddr_in));
+  s1u_socket->send(*pdu, servaddr);
   tx_seq++;
 }
 
@@ -810,7 +854,7 @@ void gtpu::echo_response(in_addr_t addr, in_port_t port, uint16_t seq)
   servaddr.sin_addr.s_addr = addr;
   servaddr.sin_port        = port;
 
-  sendto(fd, pdu->msg, 12, MSG_EOR, (struct sockaddr*)&servaddr, sizeof(struct sockaddr_in));
+  s1u_socket->send(*pdu, servaddr);
 }
 
 /****************************************************************************
@@ -845,8 +889,7 @@ bool gtpu::send_end_marker(uint32_t teidin)
   servaddr.sin_addr.s_addr    = htonl(tx_tun->spgw_addr);
   servaddr.sin_port           = htons(GTPU_PORT);
 
-  bool success =
-      sendto(fd, pdu->msg, pdu->N_bytes, MSG_EOR, (struct sockaddr*)&servaddr, sizeof(struct sockaddr_in)) > 0;
+  bool success = s1u_socket->send(*pdu, servaddr);
   if (success) {
     tunnels.deactivate_tunnel(tx_tun->teid_in);
   }
@@ -24,6 +24,7 @@
 #include "srsran/interfaces/enb_gtpu_interfaces.h"
 #include "srsran/interfaces/enb_rlc_interfaces.h"
 #include "srsran/interfaces/enb_rrc_interface_pdcp.h"
+#include <inttypes.h>
 
 namespace srsenb {
 
@@ -31,26 +32,41 @@ pdcp::pdcp(srsran::task_sched_handle task_sched_, srslog::basic_logger& logger_)
   task_sched(task_sched_), logger(logger_)
 {}
 
-void pdcp::init(rlc_interface_pdcp* rlc_, rrc_interface_pdcp* rrc_, gtpu_interface_pdcp* gtpu_)
+void pdcp::init(rlc_interface_pdcp*                 rlc_,
+                rrc_interface_pdcp*                 rrc_,
+                gtpu_interface_pdcp*                gtpu_,
+                const srsran::pdcp_tx_batch_args_t& tx_batch_args)
 {
   rlc  = rlc_;
   rrc  = rrc_;
   gtpu = gtpu_;
+  if (tx_batch_args.enable) {
+    tx_batch.reset(new srsran::pdcp_tx_batch(tx_batch_args));
+  }
 }
 
 void pdcp::stop()
 {
   for (std::map<uint32_t, user_interface>::iterator iter = users.begin(); iter != users.end(); ++iter) {
+    user_table.set(iter->first, nullptr);
     clear_user(&iter->second);
   }
   users.clear();
 }
 
+void pdcp::tti_clock()
+{
+  if (tx_batch != nullptr) {
+    tx_batch->flush();
+  }
+}
+
 void pdcp::add_user(uint16_t rnti)
 {
   if (users.count(rnti) == 0) {
     unique_rnti_ptr<srsran::pdcp> obj = make_rnti_obj<srsran::pdcp>(rnti, task_sched, logger.id().c_str());
     obj->init(&users[rnti].rlc_itf, &users[rnti].rrc_itf, &users[rnti].gtpu_itf);
+    obj->set_tx_batch(tx_batch.get());
     users[rnti].rlc_itf.rnti  = rnti;
     users[rnti].gtpu_itf.rnti = rnti;
     users[rnti].rrc_itf.rnti  = rnti;
@@ -59,6 +75,7 @@ void pdcp::add_user(uint16_t rnti)
     users[rnti].rlc_itf.rlc   = rlc;
     users[rnti].gtpu_itf.gtpu = gtpu;
     users[rnti].pdcp          = std::move(obj);
+    user_table.set(rnti, &users[rnti]);
   }
 }
 
@@ -72,6 +89,7 @@ void pdcp::clear_user(user_interface* ue)
 void pdcp::rem_user(uint16_t rnti)
 {
   if (users.count(rnti)) {
+    user_table.set(rnti, nullptr);
     clear_user(&users[rnti]);
     users.erase(rnti);
   }
@@ -79,130 +97,165 @@ void pdcp::rem_user(uint16_t rnti)
 
 void pdcp::add_bearer(uint16_t rnti, uint32_t lcid, const srsran::pdcp_config_t& cfg)
 {
-  if (users.count(rnti)) {
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
     if (rnti != SRSRAN_MRNTI) {
-      users[rnti].pdcp->add_bearer(lcid, cfg);
+      user->pdcp->add_bearer(lcid, cfg);
     } else {
-      users[rnti].pdcp->add_bearer_mrb(lcid, cfg);
+      user->pdcp->add_bearer_mrb(lcid, cfg);
     }
   }
 }
 
 void pdcp::del_bearer(uint16_t rnti, uint32_t lcid)
 {
-  if (users.count(rnti)) {
-    users[rnti].pdcp->del_bearer(lcid);
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->pdcp->del_bearer(lcid);
   }
 }
 
 void pdcp::set_enabled(uint16_t rnti, uint32_t lcid, bool enabled)
 {
-  if (users.count(rnti)) {
-    users[rnti].pdcp->set_enabled(lcid, enabled);
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->pdcp->set_enabled(lcid, enabled);
   }
 }
 
 void pdcp::reset(uint16_t rnti)
 {
-  if (users.count(rnti)) {
-    users[rnti].pdcp->reset();
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->pdcp->reset();
   }
 }
 
 void pdcp::config_security(uint16_t rnti, uint32_t lcid, const srsran::as_security_config_t& sec_cfg)
 {
-  if (users.count(rnti)) {
-    users[rnti].pdcp->config_security(lcid, sec_cfg);
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->pdcp->config_security(lcid, sec_cfg);
   }
 }
 
 void pdcp::enable_integrity(uint16_t rnti, uint32_t lcid)
 {
-  users[rnti].pdcp->enable_integrity(lcid, srsran::DIRECTION_TXRX);
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->pdcp->enable_integrity(lcid, srsran::DIRECTION_TXRX);
+  }
 }
 
 void pdcp::enable_encryption(uint16_t rnti, uint32_t lcid)
 {
-  users[rnti].pdcp->enable_encryption(lcid, srsran::DIRECTION_TXRX);
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->pdcp->enable_encryption(lcid, srsran::DIRECTION_TXRX);
+  }
 }
 
 bool pdcp::get_bearer_state(uint16_t rnti, uint32_t lcid, srsran::pdcp_lte_state_t* state)
 {
-  if (users.count(rnti) == 0) {
+  user_interface* user = user_table.get(rnti);
+  if (user == nullptr) {
     return false;
   }
-  return users[rnti].pdcp->get_bearer_state(lcid, state);
+  return user->pdcp->get_bearer_state(lcid, state);
 }
 
 bool pdcp::set_bearer_state(uint16_t rnti, uint32_t lcid, const srsran::pdcp_lte_state_t& state)
 {
-  if (users.count(rnti) == 0) {
+  user_interface* user = user_table.get(rnti);
+  if (user == nullptr) {
     return false;
   }
-  return users[rnti].pdcp->set_bearer_state(lcid, state);
+  return user->pdcp->set_bearer_state(lcid, state);
 }
 
 void pdcp::reestablish(uint16_t rnti)
 {
-  if (users.count(rnti) == 0) {
+  user_interface* user = user_table.get(rnti);
+  if (user == nullptr) {
     return;
   }
-  users[rnti].pdcp->reestablish();
+  user->pdcp->reestablish();
 }
 
 void pdcp::send_status_report(uint16_t rnti)
 {
-  if (users.count(rnti) == 0) {
+  user_interface* user = user_table.get(rnti);
+  if (user == nullptr) {
     return;
   }
-  users[rnti].pdcp->send_status_report();
+  user->pdcp->send_status_report();
 }
 
 void pdcp::notify_delivery(uint16_t rnti, uint32_t lcid, const srsran::pdcp_sn_vector_t& pdcp_sns)
 {
-  if (users.count(rnti)) {
-    users[rnti].pdcp->notify_delivery(lcid, pdcp_sns);
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->pdcp->notify_delivery(lcid, pdcp_sns);
   }
 }
 
 void pdcp::notify_failure(uint16_t rnti, uint32_t lcid, const srsran::pdcp_sn_vector_t& pdcp_sns)
 {
-  if (users.count(rnti)) {
-    users[rnti].pdcp->notify_failure(lcid, pdcp_sns);
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->pdcp->notify_failure(lcid, pdcp_sns);
   }
 }
 
 void pdcp::write_sdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t sdu, int pdcp_sn)
 {
-  if (users.count(rnti)) {
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
     if (rnti != SRSRAN_MRNTI) {
       // TODO: Handle PDCP SN coming from GTPU
-      users[rnti].pdcp->write_sdu(lcid, std::move(sdu), pdcp_sn);
+      user->pdcp->write_sdu(lcid, std::move(sdu), pdcp_sn);
     } else {
-      users[rnti].pdcp->write_sdu_mch(lcid, std::move(sdu));
+      user->pdcp->write_sdu_mch(lcid, std::move(sdu));
+    }
+  }
+}
+
+void pdcp::write_sdus(uint16_t rnti, uint32_t lcid, srsran::span<srsran::unique_byte_buffer_t> sdus)
+{
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    for (srsran::unique_byte_buffer_t& sdu : sdus) {
+      if (rnti != SRSRAN_MRNTI) {
+        user->pdcp->write_sdu(lcid, std::move(sdu));
+      } else {
+        user->pdcp->write_sdu_mch(lcid, std::move(sdu));
+      }
     }
   }
 }
 
 void pdcp::send_status_report(uint16_t rnti, uint32_t lcid)
 {
-  if (users.count(rnti)) {
-    users[rnti].pdcp->send_status_report(lcid);
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->pdcp->send_status_report(lcid);
   }
 }
 
 std::map<uint32_t, srsran::unique_byte_buffer_t> pdcp::get_buffered_pdus(uint16_t rnti, uint32_t lcid)
 {
-  if (users.count(rnti)) {
-    return users[rnti].pdcp->get_buffered_pdus(lcid);
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    return user->pdcp->get_buffered_pdus(lcid);
   }
   return {};
 }
 
 void pdcp::write_pdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t sdu)
 {
-  if (users.count(rnti)) {
-    users[rnti].pdcp->write_pdu(lcid, std::move(sdu));
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->pdcp->write_pdu(lcid, std::move(sdu));
   }
 }
 
@@ -274,6 +327,17 @@ void pdcp::get_metrics(pdcp_metrics_t& m, const uint32_t nof_tti)
     user.second.pdcp->get_metrics(m.ues[count], nof_tti);
     count++;
   }
+  if (tx_batch != nullptr) {
+    m.tx_batch = tx_batch->get_metrics();
+    logger.info("TX batch metrics: %" PRIu64 " batches, %" PRIu64 " PDUs, max_batch=%d, forced_flushes=%d, "
+                "avg_delay=%.1fus, max_delay=%dus",
+                m.tx_batch.nof_batches,
+                m.tx_batch.nof_pdus,
+                m.tx_batch.max_batch_size,
+                m.tx_batch.nof_forced_flushes,
+                m.tx_batch.avg_delay_us,
+                m.tx_batch.max_delay_us);
+  }
 }
 
 } // namespace srsenb
@@ -36,19 +36,18 @@ void rlc::init(pdcp_interface_rlc*    pdcp_,
   rrc    = rrc_;
   mac    = mac_;
   timers = timers_;
-
-  pthread_rwlock_init(&rwlock, nullptr);
 }
 
 void rlc::stop()
 {
-  pthread_rwlock_wrlock(&rwlock);
+  for (auto& user : users) {
+    user_table.set(user.first, nullptr);
+  }
+  srsran::rcu_synchronize();
   for (auto& user : users) {
     user.second.rlc->stop();
   }
   users.clear();
-  pthread_rwlock_unlock(&rwlock);
-  pthread_rwlock_destroy(&rwlock);
 }
 
 void rlc::get_metrics(rlc_metrics_t& m, const uint32_t nof_tti)
@@ -63,7 +62,6 @@ void rlc::get_metrics(rlc_metrics_t& m, const uint32_t nof_tti)
 
 void rlc::add_user(uint16_t rnti)
 {
-  pthread_rwlock_wrlock(&rwlock);
   if (users.count(rnti) == 0) {
     auto obj = make_rnti_obj<srsran::rlc>(rnti, logger.id().c_str());
     obj->init(&users[rnti],
@@ -78,120 +76,118 @@ void rlc::add_user(uint16_t rnti)
     users[rnti].rrc    = rrc;
     users[rnti].rlc    = std::move(obj);
     users[rnti].parent = this;
+    user_table.set(rnti, &users[rnti]);
   }
-  pthread_rwlock_unlock(&rwlock);
 }
 
 void rlc::rem_user(uint16_t rnti)
 {
-  pthread_rwlock_rdlock(&rwlock);
   if (users.count(rnti)) {
+    {
+      std::lock_guard<std::mutex> lock(removed_mutex);
+      removed_users.push_back({rnti, users[rnti].rlc.get(), nullptr});
+    }
+    // Wait for the PHY workers that may still be reading PDUs of the user before destroying it
+    user_table.set(rnti, nullptr);
+    srsran::rcu_synchronize();
     users[rnti].rlc->stop();
+    {
+      // TBs held by MAC may still reference PDUs of the user. If so, the last release destroys it
+      unique_rnti_ptr<srsran::rlc> user_rlc = std::move(users[rnti].rlc);
+      std::lock_guard<std::mutex>  lock(removed_mutex);
+      for (auto it = removed_users.begin(); it != removed_users.end(); ++it) {
+        if (it->rlc == user_rlc.get()) {
+          if (user_rlc->has_lent_pdus()) {
+            it->owner = std::move(user_rlc);
+          } else {
+            removed_users.erase(it);
+          }
+          break;
+        }
+      }
+    }
+    users.erase(rnti);
   } else {
     logger.error("Removing rnti=0x%x. Already removed", rnti);
   }
-  pthread_rwlock_unlock(&rwlock);
-
-  pthread_rwlock_wrlock(&rwlock);
-  users.erase(rnti);
-  pthread_rwlock_unlock(&rwlock);
 }
 
 void rlc::clear_buffer(uint16_t rnti)
 {
-  pthread_rwlock_rdlock(&rwlock);
-  if (users.count(rnti)) {
-    users[rnti].rlc->empty_queue();
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->rlc->empty_queue();
     for (int i = 0; i < SRSRAN_N_RADIO_BEARERS; i++) {
-      if (users[rnti].rlc->has_bearer(i)) {
+      if (user->rlc->has_bearer(i)) {
         mac->rlc_buffer_state(rnti, i, 0, 0);
       }
     }
     logger.info("Cleared buffer rnti=0x%x", rnti);
   }
-  pthread_rwlock_unlock(&rwlock);
 }
 
 void rlc::add_bearer(uint16_t rnti, uint32_t lcid, const srsran::rlc_config_t& cnfg)
 {
-  pthread_rwlock_rdlock(&rwlock);
-  if (users.count(rnti)) {
-    users[rnti].rlc->add_bearer(lcid, cnfg);
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->rlc->add_bearer(lcid, cnfg);
   }
-  pthread_rwlock_unlock(&rwlock);
 }
 
 void rlc::add_bearer_mrb(uint16_t rnti, uint32_t lcid)
 {
-  pthread_rwlock_rdlock(&rwlock);
-  if (users.count(rnti)) {
-    users[rnti].rlc->add_bearer_mrb(lcid);
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->rlc->add_bearer_mrb(lcid);
   }
-  pthread_rwlock_unlock(&rwlock);
 }
 
 bool rlc::has_bearer(uint16_t rnti, uint32_t lcid)
 {
-  pthread_rwlock_rdlock(&rwlock);
-  bool result = false;
-  if (users.count(rnti)) {
-    result = users[rnti].rlc->has_bearer(lcid);
-  }
-  pthread_rwlock_unlock(&rwlock);
-  return result;
+  user_interface* user = user_table.get(rnti);
+  return user != nullptr and user->rlc->has_bearer(lcid);
 }
 
 void rlc::del_bearer(uint16_t rnti, uint32_t lcid)
 {
-  pthread_rwlock_rdlock(&rwlock);
-  if (users.count(rnti)) {
-    users[rnti].rlc->del_bearer(lcid);
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->rlc->del_bearer(lcid);
   }
-  pthread_rwlock_unlock(&rwlock);
 }
 
 bool rlc::suspend_bearer(uint16_t rnti, uint32_t lcid)
 {
-  pthread_rwlock_rdlock(&rwlock);
-  bool result = false;
-  if (users.count(rnti)) {
-    users[rnti].rlc->suspend_bearer(lcid);
-    result = true;
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->rlc->suspend_bearer(lcid);
+    return true;
   }
-  pthread_rwlock_unlock(&rwlock);
-  return result;
+  return false;
 }
 
 bool rlc::is_suspended(uint16_t rnti, uint32_t lcid)
 {
-  pthread_rwlock_rdlock(&rwlock);
-  bool result = false;
-  if (users.count(rnti)) {
-    result = users[rnti].rlc->is_suspended(lcid);
-  }
-  pthread_rwlock_unlock(&rwlock);
-  return result;
+  user_interface* user = user_table.get(rnti);
+  return user != nullptr and user->rlc->is_suspended(lcid);
 }
 
 bool rlc::resume_bearer(uint16_t rnti, uint32_t lcid)
 {
-  pthread_rwlock_rdlock(&rwlock);
-  bool result = false;
-  if (users.count(rnti)) {
-    users[rnti].rlc->resume_bearer(lcid);
-    result = true;
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->rlc->resume_bearer(lcid);
+    return true;
   }
-  pthread_rwlock_unlock(&rwlock);
-  return result;
+  return false;
 }
 
 void rlc::reestablish(uint16_t rnti)
 {
-  pthread_rwlock_rdlock(&rwlock);
-  if (users.count(rnti)) {
-    users[rnti].rlc->reestablish();
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->rlc->reestablish();
   }
-  pthread_rwlock_unlock(&rwlock);
 }
 
 // In the eNodeB, there is no polling for buffer state from the scheduler.
@@ -206,71 +202,102 @@ int rlc::read_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_b
 {
   int ret;
 
-  pthread_rwlock_rdlock(&rwlock);
-  if (users.count(rnti)) {
+  srsran::rcu_read_guard rcu;
+  user_interface*        user = user_table.get(rnti);
+  if (user != nullptr) {
     if (rnti != SRSRAN_MRNTI) {
-      ret = users[rnti].rlc->read_pdu(lcid, payload, nof_bytes);
+      ret = user->rlc->read_pdu(lcid, payload, nof_bytes);
     } else {
-      ret = users[rnti].rlc->read_pdu_mch(lcid, payload, nof_bytes);
+      ret = user->rlc->read_pdu_mch(lcid, payload, nof_bytes);
     }
   } else {
     ret = SRSRAN_ERROR;
   }
-  pthread_rwlock_unlock(&rwlock);
   return ret;
 }
 
+int rlc::read_pdu_sg(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes, srsran::const_byte_span& body)
+{
+  int ret;
+
+  body = {};
+  srsran::rcu_read_guard rcu;
+  user_interface*        user = user_table.get(rnti);
+  if (user != nullptr) {
+    if (rnti != SRSRAN_MRNTI) {
+      ret = user->rlc->read_pdu_sg(lcid, payload, nof_bytes, body);
+    } else {
+      ret = user->rlc->read_pdu_mch(lcid, payload, nof_bytes);
+    }
+  } else {
+    ret = SRSRAN_ERROR;
+  }
+  return ret;
+}
+
+void rlc::release_pdu_sg(uint16_t rnti, uint32_t lcid, srsran::const_byte_span body)
+{
+  {
+    srsran::rcu_read_guard rcu;
+    user_interface*        user = user_table.get(rnti);
+    if (user != nullptr and user->rlc->release_pdu_sg(lcid, body)) {
+      return;
+    }
+  }
+
+  // The PDU was lent by a removed user. It is destroyed after unlocking, if this was its last lent PDU
+  unique_rnti_ptr<srsran::rlc> released_rlc;
+  std::lock_guard<std::mutex>  lock(removed_mutex);
+  for (auto it = removed_users.begin(); it != removed_users.end(); ++it) {
+    if (it->rnti == rnti and it->rlc->release_pdu_sg(lcid, body)) {
+      if (it->owner != nullptr and not it->rlc->has_lent_pdus()) {
+        released_rlc = std::move(it->owner);
+        removed_users.erase(it);
+      }
+      return;
+    }
+  }
+  logger.warning("Releasing a PDU of rnti=0x%x, lcid=%d that was not lent", rnti, lcid);
+}
+
 void rlc::write_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes)
 {
-  pthread_rwlock_rdlock(&rwlock);
-  if (users.count(rnti)) {
-    users[rnti].rlc->write_pdu(lcid, payload, nof_bytes);
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->rlc->write_pdu(lcid, payload, nof_bytes);
   }
-  pthread_rwlock_unlock(&rwlock);
 }
 
 void rlc::write_sdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t sdu)
 {
-  pthread_rwlock_rdlock(&rwlock);
-  if (users.count(rnti)) {
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
     if (rnti != SRSRAN_MRNTI) {
-      users[rnti].rlc->write_sdu(lcid, std::move(sdu));
+      user->rlc->write_sdu(lcid, std::move(sdu));
     } else {
-      users[rnti].rlc->write_sdu_mch(lcid, std::move(sdu));
+      user->rlc->write_sdu_mch(lcid, std::move(sdu));
     }
   }
-  pthread_rwlock_unlock(&rwlock);
 }
 
 void rlc::discard_sdu(uint16_t rnti, uint32_t lcid, uint32_t discard_sn)
 {
-  pthread_rwlock_rdlock(&rwlock);
-  if (users.count(rnti)) {
-    users[rnti].rlc->discard_sdu(lcid, discard_sn);
+  user_interface* user = user_table.get(rnti);
+  if (user != nullptr) {
+    user->rlc->discard_sdu(lcid, discard_sn);
   }
-  pthread_rwlock_unlock(&rwlock);
 }
 
 bool rlc::rb_is_um(uint16_t rnti, uint32_t lcid)
 {
-  bool ret = false;
-  pthread_rwlock_rdlock(&rwlock);
-  if (users.count(rnti)) {
-    ret = users[rnti].rlc->rb_is_um(lcid);
-  }
-  pthread_rwlock_unlock(&rwlock);
-  return ret;
+  user_interface* user = user_table.get(rnti);
+  return user != nullptr and user->rlc->rb_is_um(lcid);
 }
 
 bool rlc::sdu_queue_is_full(uint16_t rnti, uint32_t lcid)
 {
-  bool ret = false;
-  pthread_rwlock_rdlock(&rwlock);
-  if (users.count(rnti)) {
-    ret = users[rnti].rlc->sdu_queue_is_full(lcid);
-  }
-  pthread_rwlock_unlock(&rwlock);
-  return ret;
+  user_interface* user = user_table.get(rnti);
+  return user != nullptr and user->rlc->sdu_queue_is_full(lcid);
 }
 
 void rlc::user_interface::max_retx_attempted()
@@ -29,6 +29,12 @@ namespace srsenb {
 class rlc_dummy : public rlc_interface_mac
 {
   int  read_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes) { return SRSRAN_SUCCESS; }
+  int read_pdu_sg(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes, srsran::const_byte_span& body)
+  {
+    body = {};
+    return SRSRAN_SUCCESS;
+  }
+  void release_pdu_sg(uint16_t rnti, uint32_t lcid, srsran::const_byte_span body) {}
   void write_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes) {}
 };
 
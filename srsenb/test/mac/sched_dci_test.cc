@@ -317,6 +317,33 @@ void test_ul_mcs_tbs_derivation()
   TESTASSERT_EQ(23, compute_tbs_mcs(100, 100 - 5).mcs);
 }
 
+/// Verify that the precomputed UL MCS table leads to the same result as the MCS search, for all max MCS values
+int test_ul_mcs_table()
+{
+  sched_interface::sched_args_t sched_args = {};
+
+  for (auto& nof_prb_cell : srsran::lte_cell_nof_prbs) {
+    sched_interface::cell_cfg_t cell_cfg    = generate_default_cell_cfg(nof_prb_cell);
+    sched_cell_params_t         cell_params = {};
+    cell_params.set_cfg(0, cell_cfg, sched_args);
+    for (bool ulqam64_enabled : {false, true}) {
+      const mcs_lookup_table& table = cell_params.ul_mcs_tables[ulqam64_enabled];
+      for (uint32_t prb_grant = 1; prb_grant <= nof_prb_cell; ++prb_grant) {
+        uint32_t nof_re = cell_params.get_ul_nof_re(prb_grant);
+        for (uint32_t cqi = 0; cqi < 16; ++cqi) {
+          const mcs_lookup_table::entry_t& entry = table.get(cqi, prb_grant);
+          for (uint32_t max_mcs = entry.mcs; max_mcs <= 28; ++max_mcs) {
+            tbs_info tb = compute_mcs_and_tbs(prb_grant, nof_re, cqi, max_mcs, true, ulqam64_enabled, false);
+            TESTASSERT_EQ(tb.mcs, entry.mcs);
+            TESTASSERT_EQ(tb.tbs_bytes, entry.tbs_bytes);
+          }
+        }
+      }
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
 } // namespace srsenb
 
 int main()
@@ -333,6 +360,7 @@ int main()
   TESTASSERT(srsenb::test_mcs_tbs_consistency_all() == SRSRAN_SUCCESS);
   TESTASSERT(srsenb::test_min_mcs_tbs_specific() == SRSRAN_SUCCESS);
   srsenb::test_ul_mcs_tbs_derivation();
+  TESTASSERT(srsenb::test_ul_mcs_table() == SRSRAN_SUCCESS);
 
   printf("Success\n");
   return 0;
@@ -0,0 +1,253 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * UL link adaptation simulator.
+ *
+ * Replays a trace of PUSCH SNRs (one value in dB per TTI, either read from a file or generated), and for each TTI:
+ * - selects the MCS from the SNR estimate + OLLA offset, as the LTE scheduler does,
+ * - derives the CRC of the PUSCH by comparing the channel SNR with the SNR that the selected MCS requires,
+ * - feeds the CRC back to the OLLA.
+ * It reports the achieved BLER and spectral efficiency, and the CPU cost of the MCS selection with and without the
+ * precomputed MCS tables.
+ *
+ * Usage: sched_link_adaptation_sim [test|benchmark] [trace_file]
+ */
+
+#include "sched_test_utils.h"
+#include "srsenb/hdr/stack/mac/common/link_adaptation.h"
+#include "srsenb/hdr/stack/mac/sched_phy_ch/sched_dci.h"
+#include "srsran/adt/accumulators.h"
+#include "srsran/common/test_common.h"
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <random>
+
+namespace srsenb {
+
+struct sim_params {
+  uint32_t nof_prb         = 50;
+  uint32_t nof_prb_alloc   = 48;
+  float    target_bler     = 0.1;
+  float    olla_step       = 0.05;
+  float    max_olla_offset = 10;
+  float    snr_avg_alpha   = 0.1;
+  /// Std deviation of the SNR estimation error, in dB
+  float snr_estim_error_db = 1;
+  /// Fraction of the Shannon capacity achieved by the PUSCH decoder
+  float decoder_efficiency = 0.75;
+  /// Delay between the SNR measurement and the scheduling decision that uses it, in TTIs
+  uint32_t snr_report_delay = 4;
+  bool     use_table        = true;
+  bool     enable_olla      = true;
+};
+
+struct sim_result {
+  uint32_t nof_tx       = 0;
+  uint32_t nof_nacks    = 0;
+  uint64_t acked_bits   = 0;
+  uint64_t sum_mcs      = 0;
+  double   mcs_time_ns  = 0;
+  float    final_offset = 0;
+
+  double bler() const { return nof_tx > 0 ? nof_nacks / (double)nof_tx : 0; }
+  /// Bits/s/Hz, over the allocated bandwidth
+  double spectral_efficiency(const sim_params& p) const
+  {
+    return nof_tx > 0 ? acked_bits / (nof_tx * p.nof_prb_alloc * 180e3 * 1e-3) : 0;
+  }
+};
+
+/// Generates a slow fading trace, as a Gauss-Markov process around the mean SNR
+std::vector<float> generate_snr_trace(uint32_t nof_ttis, float mean_snr_db, float std_snr_db, uint32_t seed)
+{
+  std::mt19937                    rgen(seed);
+  std::normal_distribution<float> dist(0, 1);
+  const float                     rho = 0.995;
+  std::vector<float>              trace(nof_ttis);
+  float                           state = 0;
+  for (float& snr : trace) {
+    state = rho * state + std::sqrt(1 - rho * rho) * dist(rgen);
+    snr   = mean_snr_db + std_snr_db * state;
+  }
+  return trace;
+}
+
+/// Reads a trace with one SNR value in dB per line
+std::vector<float> read_snr_trace(const char* filename)
+{
+  std::vector<float> trace;
+  std::ifstream      file(filename);
+  float              snr;
+  while (file >> snr) {
+    trace.push_back(snr);
+  }
+  return trace;
+}
+
+/// SNR required to decode a PUSCH with the given TBS and nof REs, based on an attenuated Shannon bound
+float required_snr_db(const sim_params& p, uint32_t tbs_bytes, uint32_t nof_re)
+{
+  float se = tbs_bytes * 8 / (float)nof_re;
+  return 10 * std::log10(std::pow(2.0f, se / p.decoder_efficiency) - 1);
+}
+
+sim_result run_sim(const sim_params& p, const sched_cell_params_t& cell_params, const std::vector<float>& trace)
+{
+  const uint32_t max_mcs = 28;
+  const uint32_t nof_re  = cell_params.get_ul_nof_re(p.nof_prb_alloc);
+
+  std::mt19937                          rgen(0);
+  std::normal_distribution<float>       estim_error(0, p.snr_estim_error_db);
+  olla_ctrl                             olla(p.target_bler, p.enable_olla ? p.olla_step : 0, p.max_olla_offset);
+  srsran::exp_average_fast_start<float> snr_avg(p.snr_avg_alpha);
+  sim_result                            result;
+  std::chrono::steady_clock::duration   mcs_time{0};
+
+  for (uint32_t tti = p.snr_report_delay; tti < trace.size(); ++tti) {
+    // The SNR estimated in an older PUSCH is available to the scheduler
+    snr_avg.push(trace[tti - p.snr_report_delay] + estim_error(rgen));
+    uint32_t cqi = srsran_cqi_from_snr(snr_avg.value() + olla.offset());
+
+    // MCS selection, for a full buffer
+    auto     tp = std::chrono::steady_clock::now();
+    tbs_info tb;
+    if (p.use_table) {
+      const mcs_lookup_table::entry_t& entry = cell_params.ul_mcs_tables[0].get(cqi, p.nof_prb_alloc);
+      tb                                     = compute_min_mcs_and_tbs_from_required_bytes(
+          tbs_info{entry.tbs_bytes, entry.mcs}, p.nof_prb_alloc, nof_re, cqi, max_mcs, UINT32_MAX, true, false, false);
+    } else {
+      tb = compute_min_mcs_and_tbs_from_required_bytes(
+          p.nof_prb_alloc, nof_re, cqi, max_mcs, UINT32_MAX, true, false, false);
+    }
+    mcs_time += std::chrono::steady_clock::now() - tp;
+    if (tb.tbs_bytes < 0) {
+      tb.mcs       = 0;
+      tb.tbs_bytes = get_tbs_bytes(0, p.nof_prb_alloc, false, true);
+    }
+
+    // CRC derived from the channel SNR
+    bool ack = trace[tti] >= required_snr_db(p, tb.tbs_bytes, nof_re);
+    olla.update(ack, tb.mcs, max_mcs);
+
+    result.nof_tx++;
+    result.nof_nacks += ack ? 0 : 1;
+    result.acked_bits += ack ? tb.tbs_bytes * 8 : 0;
+    result.sum_mcs += tb.mcs;
+  }
+  result.mcs_time_ns  = std::chrono::duration<double, std::nano>(mcs_time).count();
+  result.final_offset = olla.offset();
+  return result;
+}
+
+void print_result(const char* name, const sim_params& p, const sim_result& r)
+{
+  printf("%-14s: BLER=%.3f, spectral eff=%.2f bits/s/Hz, avg MCS=%.1f, OLLA offset=%.1f dB, MCS selection=%.1f "
+         "ns/TTI\n",
+         name,
+         r.bler(),
+         r.spectral_efficiency(p),
+         r.nof_tx > 0 ? r.sum_mcs / (double)r.nof_tx : 0,
+         r.final_offset,
+         r.nof_tx > 0 ? r.mcs_time_ns / r.nof_tx : 0);
+}
+
+int run_trace(sim_params p, const std::vector<float>& trace, bool check)
+{
+  sched_cell_params_t           cell_params;
+  sched_interface::cell_cfg_t   cell_cfg = generate_default_cell_cfg(p.nof_prb);
+  sched_interface::sched_args_t sched_args{};
+  TESTASSERT(cell_params.set_cfg(0, cell_cfg, sched_args));
+
+  p.use_table           = true;
+  p.enable_olla         = true;
+  sim_result table_olla = run_sim(p, cell_params, trace);
+  p.use_table           = false;
+  sim_result search     = run_sim(p, cell_params, trace);
+  p.enable_olla         = false;
+  sim_result no_olla    = run_sim(p, cell_params, trace);
+
+  print_result("table+OLLA", p, table_olla);
+  print_result("search+OLLA", p, search);
+  print_result("search,no OLLA", p, no_olla);
+
+  // The table lookup must not change the scheduling decisions
+  TESTASSERT(table_olla.nof_tx == search.nof_tx);
+  TESTASSERT(table_olla.nof_nacks == search.nof_nacks);
+  TESTASSERT(table_olla.acked_bits == search.acked_bits);
+  TESTASSERT(table_olla.sum_mcs == search.sum_mcs);
+
+  if (check) {
+    // The OLLA converges to the target BLER
+    TESTASSERT(std::abs(table_olla.bler() - p.target_bler) < 0.05);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int run_test()
+{
+  sim_params p;
+  for (float mean_snr : {5.0f, 15.0f}) {
+    printf("Mean SNR=%.0f dB:\n", mean_snr);
+    TESTASSERT(run_trace(p, generate_snr_trace(20000, mean_snr, 3, 0), true) == SRSRAN_SUCCESS);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int run_benchmark(const char* trace_file)
+{
+  sim_params p;
+  if (trace_file != nullptr) {
+    std::vector<float> trace = read_snr_trace(trace_file);
+    TESTASSERT(not trace.empty());
+    printf("Trace \"%s\" with %zd TTIs:\n", trace_file, trace.size());
+    return run_trace(p, trace, false);
+  }
+  for (float mean_snr : {0.0f, 5.0f, 10.0f, 15.0f, 20.0f}) {
+    printf("Mean SNR=%.0f dB:\n", mean_snr);
+    TESTASSERT(run_trace(p, generate_snr_trace(1000000, mean_snr, 3, 0), false) == SRSRAN_SUCCESS);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsenb
+
+int main(int argc, char* argv[])
+{
+  auto& mac_log = srslog::fetch_basic_logger("MAC");
+  mac_log.set_level(srslog::basic_levels::warning);
+
+  // Start the log backend.
+  srslog::init();
+
+  if (argc == 1 or strcmp(argv[1], "test") == 0) {
+    TESTASSERT(srsenb::run_test() == SRSRAN_SUCCESS);
+  } else if (strcmp(argv[1], "benchmark") == 0) {
+    TESTASSERT(srsenb::run_benchmark(argc > 2 ? argv[2] : nullptr) == SRSRAN_SUCCESS);
+  } else {
+    printf("Usage: %s [test|benchmark] [trace_file]\n", argv[0]);
+    return SRSRAN_ERROR;
+  }
+
+  srslog::flush();
+  return SRSRAN_SUCCESS;
+}
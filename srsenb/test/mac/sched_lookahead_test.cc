@@ -0,0 +1,253 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/mac/sched.h"
+#include "srsenb/hdr/stack/mac/sched_lookahead.h"
+#include "srsran/common/test_common.h"
+#include <atomic>
+#include <thread>
+
+using namespace srsenb;
+
+using dl_sched_list_t = sched_lookahead::dl_sched_list_t;
+using ul_sched_list_t = sched_lookahead::ul_sched_list_t;
+
+const uint16_t rnti1 = 0x46, rnti2 = 0x47;
+
+/// Scheduler stub that encodes the TTI in the result and allocates a PUSCH retx and PHICH NACK for two UEs
+struct sched_stub {
+  std::vector<uint32_t>                        computed_ttis;
+  std::vector<std::pair<uint32_t, uint16_t> > dropped_retxs;
+  std::mutex                                   mutex;
+
+  void retx_dropped(uint32_t tti_tx_ul, uint16_t rnti)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    dropped_retxs.emplace_back(tti_tx_ul, rnti);
+  }
+
+  int operator()(uint32_t tti_tx_dl, dl_sched_list_t& dl_res, ul_sched_list_t& ul_res)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      computed_ttis.push_back(tti_tx_dl);
+    }
+    for (uint32_t cc = 0; cc < dl_res.size(); ++cc) {
+      dl_res[cc].nof_grants = 0;
+      dl_res[cc].cfi        = tti_tx_dl;
+      ul_res[cc].nof_grants = 2;
+      ul_res[cc].nof_phich  = 2;
+      for (uint32_t i = 0; i < 2; ++i) {
+        ul_res[cc].pusch[i]               = {};
+        ul_res[cc].pusch[i].dci.rnti      = i == 0 ? rnti1 : rnti2;
+        ul_res[cc].pusch[i].current_tx_nb = 1;
+        ul_res[cc].phich[i].rnti          = i == 0 ? rnti1 : rnti2;
+        ul_res[cc].phich[i].ack           = false;
+      }
+    }
+    return SRSRAN_SUCCESS;
+  }
+};
+
+int test_lookahead_order()
+{
+  const uint32_t lookahead = 2, nof_carriers = 2, start_tti = 10230, nof_ttis = 40;
+
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("MAC");
+  sched_stub            stub;
+  sched_lookahead       lookahead_sched(
+      lookahead,
+      nof_carriers,
+      [&stub](uint32_t tti, dl_sched_list_t& dl_res, ul_sched_list_t& ul_res) { return stub(tti, dl_res, ul_res); },
+      [&stub](uint32_t tti_tx_ul, uint16_t rnti, uint32_t enb_cc_idx) { stub.retx_dropped(tti_tx_ul, rnti); },
+      logger);
+
+  dl_sched_list_t dl_res(nof_carriers);
+  ul_sched_list_t ul_res(nof_carriers);
+  for (uint32_t i = 0; i < nof_ttis; ++i) {
+    uint32_t tti_tx_dl = TTI_ADD(start_tti, i);
+    TESTASSERT(lookahead_sched.get_dl_sched(tti_tx_dl, dl_res) == SRSRAN_SUCCESS);
+    TESTASSERT(lookahead_sched.get_ul_sched(TTI_ADD(tti_tx_dl, FDD_HARQ_DELAY_DL_MS), ul_res) == SRSRAN_SUCCESS);
+    for (uint32_t cc = 0; cc < nof_carriers; ++cc) {
+      TESTASSERT(dl_res[cc].cfi == tti_tx_dl);
+      TESTASSERT(ul_res[cc].nof_grants == 2 and ul_res[cc].nof_phich == 2);
+    }
+  }
+  lookahead_sched.stop();
+
+  // All TTIs were computed once, in order, and up to lookahead TTIs ahead of the last fetched TTI. The TTIs requested
+  // ahead may still be pending when the lookahead is stopped
+  std::lock_guard<std::mutex> lock(stub.mutex);
+  TESTASSERT(stub.computed_ttis.size() >= nof_ttis and stub.computed_ttis.size() <= nof_ttis + lookahead);
+  for (uint32_t i = 0; i < stub.computed_ttis.size(); ++i) {
+    TESTASSERT(stub.computed_ttis[i] == TTI_ADD(start_tti, i));
+  }
+
+  mac_lookahead_metrics_t metrics = {};
+  lookahead_sched.get_metrics(metrics);
+  TESTASSERT(metrics.nof_ttis == nof_ttis);
+  TESTASSERT(metrics.nof_late_ttis <= nof_ttis);
+  return SRSRAN_SUCCESS;
+}
+
+int test_lookahead_crc_correction()
+{
+  const uint32_t lookahead = 3, nof_carriers = 1, tti_tx_dl = 100;
+
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("MAC");
+  sched_stub            stub;
+  sched_lookahead       lookahead_sched(
+      lookahead,
+      nof_carriers,
+      [&stub](uint32_t tti, dl_sched_list_t& dl_res, ul_sched_list_t& ul_res) { return stub(tti, dl_res, ul_res); },
+      [&stub](uint32_t tti_tx_ul, uint16_t rnti, uint32_t enb_cc_idx) { stub.retx_dropped(tti_tx_ul, rnti); },
+      logger);
+
+  dl_sched_list_t dl_res(nof_carriers);
+  ul_sched_list_t ul_res(nof_carriers);
+  TESTASSERT(lookahead_sched.get_dl_sched(tti_tx_dl, dl_res) == SRSRAN_SUCCESS);
+
+  // The results of the next TTI were computed before the PUSCH CRCs were reported
+  uint32_t tti_rx = TTI_SUB(tti_tx_dl + 1, FDD_HARQ_DELAY_UL_MS);
+  lookahead_sched.crc_info(tti_rx, rnti1, 0, true);
+  lookahead_sched.crc_info(tti_rx, rnti2, 0, false);
+  TESTASSERT(lookahead_sched.get_dl_sched(tti_tx_dl + 1, dl_res) == SRSRAN_SUCCESS);
+  TESTASSERT(lookahead_sched.get_ul_sched(TTI_ADD(tti_tx_dl + 1, FDD_HARQ_DELAY_DL_MS), ul_res) == SRSRAN_SUCCESS);
+
+  // The decoded PUSCH is ACKed and its retx is dropped
+  TESTASSERT(ul_res[0].nof_phich == 2);
+  TESTASSERT(ul_res[0].phich[0].rnti == rnti1 and ul_res[0].phich[0].ack);
+  TESTASSERT(ul_res[0].phich[1].rnti == rnti2 and not ul_res[0].phich[1].ack);
+  TESTASSERT(ul_res[0].nof_grants == 1);
+  TESTASSERT(ul_res[0].pusch[0].dci.rnti == rnti2);
+
+  // The scheduler is informed of the dropped retx
+  std::lock_guard<std::mutex> lock(stub.mutex);
+  TESTASSERT(stub.dropped_retxs.size() == 1);
+  TESTASSERT(stub.dropped_retxs[0].first == TTI_ADD(tti_tx_dl + 1, FDD_HARQ_DELAY_DL_MS));
+  TESTASSERT(stub.dropped_retxs[0].second == rnti1);
+  return SRSRAN_SUCCESS;
+}
+
+int test_lookahead_stop()
+{
+  const uint32_t nof_carriers = 1;
+
+  // Scheduler that only returns once the test allows it
+  std::atomic<bool>     release{false};
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("MAC");
+  sched_stub            stub;
+  sched_lookahead       lookahead_sched(
+      1,
+      nof_carriers,
+      [&](uint32_t tti, dl_sched_list_t& dl_res, ul_sched_list_t& ul_res) {
+        while (not release) {
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        return stub(tti, dl_res, ul_res);
+      },
+      [&stub](uint32_t tti_tx_ul, uint16_t rnti, uint32_t enb_cc_idx) { stub.retx_dropped(tti_tx_ul, rnti); },
+      logger);
+
+  // The PHY worker waits for the result, and is released once the lookahead is stopped
+  std::atomic<bool> fetched{false};
+  std::thread       phy_worker([&]() {
+    dl_sched_list_t dl_res(nof_carriers);
+    dl_res[0].nof_grants = 5;
+    TESTASSERT(lookahead_sched.get_dl_sched(0, dl_res) == SRSRAN_SUCCESS);
+    TESTASSERT(dl_res[0].nof_grants == 0);
+    fetched = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  TESTASSERT(not fetched);
+  release = true;
+  lookahead_sched.stop();
+  phy_worker.join();
+  TESTASSERT(fetched);
+  return SRSRAN_SUCCESS;
+}
+
+/// With a feedback delay, DL retxs are only considered once the HARQ ACK had the chance to be received
+int test_harq_feedback_delay()
+{
+  const uint32_t fb_delay = 2;
+  harq_entity    harq_ent(SRSRAN_FDD_NOF_HARQ, SRSRAN_FDD_NOF_HARQ, fb_delay);
+
+  rbgmask_t mask(25);
+  mask.fill(0, 25);
+  tti_point tti_tx{10};
+  harq_ent.new_tti(tti_tx - TX_ENB_DELAY);
+  dl_harq_proc* h = harq_ent.get_empty_dl_harq(tti_tx);
+  TESTASSERT(h != nullptr);
+  h->new_tx(mask, 0, tti_tx, 10, 100, 0, 4);
+
+  // Without feedback delay, the retx would be considered at tti_tx + 8
+  tti_point tti_retx = to_tx_dl_ack(tti_tx);
+  for (tti_point tti_tx_dl = tti_tx + 1; tti_tx_dl < tti_retx + fb_delay; ++tti_tx_dl) {
+    harq_ent.new_tti(tti_tx_dl - TX_ENB_DELAY);
+    TESTASSERT(harq_ent.get_pending_dl_harq(tti_tx_dl) == nullptr);
+  }
+  harq_ent.new_tti(tti_retx + fb_delay - TX_ENB_DELAY);
+  TESTASSERT(harq_ent.get_pending_dl_harq(tti_retx + fb_delay) == h);
+  return SRSRAN_SUCCESS;
+}
+
+/// A dropped PUSCH retx releases the UL HARQ, without a pending PHICH
+int test_harq_ul_retx_dropped()
+{
+  harq_entity harq_ent(SRSRAN_FDD_NOF_HARQ, SRSRAN_FDD_NOF_HARQ, 2);
+
+  tti_point     tti_tx_ul{10};
+  ul_harq_proc* h = harq_ent.get_ul_harq(tti_tx_ul);
+  h->new_tx(tti_tx_ul, 10, 100, prb_interval{0, 5}, 4, false);
+  TESTASSERT(h->pop_pending_phich() == false);
+
+  // The retx is scheduled before the CRC of the first tx is known, then the CRC is received and the retx dropped
+  int mcs = 0, tbs = 0;
+  h->new_retx(tti_tx_ul + SRSRAN_FDD_NOF_HARQ, &mcs, &tbs, prb_interval{0, 5});
+  TESTASSERT(harq_ent.set_ul_crc(tti_tx_ul, 0, true) == (int)h->get_id());
+  h->retx_dropped();
+  TESTASSERT(h->is_empty());
+  TESTASSERT(not h->has_pending_phich());
+  TESTASSERT(h->get_pending_data() == 0);
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  auto& mac_log = srslog::fetch_basic_logger("MAC");
+  mac_log.set_level(srslog::basic_levels::info);
+  auto& test_log = srslog::fetch_basic_logger("TEST");
+  test_log.set_level(srslog::basic_levels::info);
+
+  // Start the log backend.
+  srslog::init();
+
+  TESTASSERT(test_lookahead_order() == SRSRAN_SUCCESS);
+  TESTASSERT(test_lookahead_crc_correction() == SRSRAN_SUCCESS);
+  TESTASSERT(test_lookahead_stop() == SRSRAN_SUCCESS);
+  TESTASSERT(test_harq_feedback_delay() == SRSRAN_SUCCESS);
+  TESTASSERT(test_harq_ul_retx_dropped() == SRSRAN_SUCCESS);
+
+  srslog::flush();
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
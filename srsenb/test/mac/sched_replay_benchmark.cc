@@ -0,0 +1,361 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Scheduler-only benchmark of the LTE MAC scheduler.
+ *
+ * Replays a trace of UE events (see sched_replay_trace.h) through the scheduler API as fast as possible, without
+ * the UE simulation and consistency checks of the functional tests. The HARQ feedback of the allocated grants is
+ * emulated with the outcomes from the trace. It reports the per-TTI latency of the scheduler API calls, the
+ * scheduling decisions per second and the allocation KPIs.
+ *
+ * Usage: sched_replay_benchmark [test|benchmark|generate] [trace_file]
+ */
+
+#include "sched_replay_trace.h"
+#include "sched_test_common.h"
+#include "sched_test_utils.h"
+#include "srsenb/hdr/stack/mac/sched.h"
+#include "srsran/common/test_common.h"
+#include <chrono>
+
+namespace srsenb {
+
+class sched_lte_replayer
+{
+public:
+  sched_lte_replayer(const sched_replay_trace& trace_, uint32_t nof_prb) : trace(trace_)
+  {
+    std::vector<sched_interface::cell_cfg_t> cell_list(trace.nof_carriers, generate_default_cell_cfg(nof_prb));
+    for (uint32_t cc = 0; cc < cell_list.size(); ++cc) {
+      cell_list[cc].cell.id = cc + 1;
+    }
+    prach_config = cell_list[0].prach_config;
+
+    sched_interface::sched_args_t sched_args = {};
+    sched_obj.init(&rrc, sched_args);
+    TESTASSERT(sched_obj.cell_cfg(cell_list) == SRSRAN_SUCCESS);
+
+    dl_results.resize(trace.nof_carriers);
+    ul_results.resize(trace.nof_carriers);
+    ues.resize(trace.nof_ues);
+    for (uint32_t i = 0; i < ues.size(); ++i) {
+      ues[i].rnti = 0x46 + i;
+    }
+  }
+
+  int run(sched_replay_stats& stats)
+  {
+    stats = {};
+    stats.latency_ns.reserve(trace.nof_ttis);
+    size_t ev_idx = 0;
+    for (uint32_t count = 0; count < trace.nof_ttis; ++count) {
+      tti_point tti_rx{count % 10240};
+
+      auto tp = std::chrono::steady_clock::now();
+      for (; ev_idx < trace.events.size() and trace.events[ev_idx].tti == count; ++ev_idx) {
+        handle_event(tti_rx, trace.events[ev_idx]);
+      }
+      handle_pending_rachs(tti_rx);
+      handle_feedback(tti_rx, stats);
+      for (uint32_t cc = 0; cc < trace.nof_carriers; ++cc) {
+        TESTASSERT(sched_obj.dl_sched(to_tx_dl(tti_rx).to_uint(), cc, dl_results[cc]) == SRSRAN_SUCCESS);
+        TESTASSERT(sched_obj.ul_sched(to_tx_ul(tti_rx).to_uint(), cc, ul_results[cc]) == SRSRAN_SUCCESS);
+      }
+      auto tp2 = std::chrono::steady_clock::now();
+      stats.latency_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(tp2 - tp).count());
+
+      process_results(tti_rx, stats);
+    }
+
+    stats.nof_ues = ues.size();
+    for (const ue_ctxt& u : ues) {
+      stats.nof_connected_ues += u.state == ue_state::connected ? 1 : 0;
+    }
+    return SRSRAN_SUCCESS;
+  }
+
+private:
+  enum class ue_state { idle, rach, msg3, msg4, connected };
+
+  struct ue_ctxt {
+    uint16_t                  rnti  = SRSRAN_INVALID_RNTI;
+    ue_state                  state = ue_state::idle;
+    sched_interface::ue_cfg_t final_cfg;
+    uint32_t                  dl_buffer = 0, ul_buffer = 0;
+    /// HARQ feedback outcomes of the current TTI
+    bool dl_ack = true, ul_crc = true;
+  };
+
+  struct harq_fb_t {
+    uint32_t ue_idx;
+    uint32_t cc;
+    uint32_t tb_idx;
+    uint32_t nof_bytes;
+    bool     is_ra; ///< Msg3 or Msg4
+  };
+
+  static const uint32_t FB_RING_SIZE = 16;
+  static const uint32_t DRB_LCID     = 3;
+  static const uint32_t DRB_LCG      = 1;
+
+  void handle_event(tti_point tti_rx, const sched_trace_event& ev)
+  {
+    using type_t = sched_trace_event::type_t;
+    ue_ctxt& u   = ues[ev.ue_idx];
+    if (ev.type == type_t::rach) {
+      if (u.state == ue_state::idle) {
+        u.state                                   = ue_state::rach;
+        u.final_cfg                               = generate_default_ue_cfg();
+        u.final_cfg.supported_cc_list[0].enb_cc_idx = ev.cc;
+        pending_rachs.push_back(ev.ue_idx);
+      }
+      return;
+    }
+    if (u.state != ue_state::connected) {
+      // Events before the UE is connected are ignored
+      return;
+    }
+    switch (ev.type) {
+      case type_t::dl_buffer:
+        u.dl_buffer += ev.value;
+        sched_obj.dl_rlc_buffer_state(u.rnti, DRB_LCID, u.dl_buffer, 0);
+        break;
+      case type_t::ul_bsr:
+        u.ul_buffer += ev.value;
+        sched_obj.ul_bsr(u.rnti, DRB_LCG, u.ul_buffer);
+        break;
+      case type_t::dl_cqi:
+        sched_obj.dl_cqi_info(tti_rx.to_uint(), u.rnti, ev.cc, ev.value);
+        break;
+      case type_t::ul_snr:
+        sched_obj.ul_snr_info(tti_rx.to_uint(), u.rnti, ev.cc, ev.value, 0);
+        break;
+      case type_t::dl_ack:
+        u.dl_ack = ev.value > 0;
+        break;
+      case type_t::ul_crc:
+        u.ul_crc = ev.value > 0;
+        break;
+      default:
+        break;
+    }
+  }
+
+  void handle_pending_rachs(tti_point tti_rx)
+  {
+    if (pending_rachs.empty() or not srsran_prach_tti_opportunity_config_fdd(prach_config, tti_rx.to_uint(), -1)) {
+      return;
+    }
+    // The PRACHs that do not fit in the RAR are postponed to the next PRACH opportunity
+    std::vector<uint32_t> nof_rachs(trace.nof_carriers, 0);
+    auto                  rach_it = pending_rachs.begin();
+    while (rach_it != pending_rachs.end()) {
+      ue_ctxt& u     = ues[*rach_it];
+      uint32_t pcell = u.final_cfg.supported_cc_list[0].enb_cc_idx;
+      if (nof_rachs[pcell] >= sched_interface::MAX_RAR_LIST) {
+        ++rach_it;
+        continue;
+      }
+      TESTASSERT(sched_obj.ue_cfg(u.rnti, generate_rach_ue_cfg(u.final_cfg)) == SRSRAN_SUCCESS);
+
+      sched_interface::dl_sched_rar_info_t rar_info = {};
+      rar_info.prach_tti                            = tti_rx.to_uint();
+      rar_info.temp_crnti                           = u.rnti;
+      rar_info.msg3_size                            = 7;
+      rar_info.preamble_idx                         = nof_rachs[pcell]++;
+      TESTASSERT(sched_obj.dl_rach_info(pcell, rar_info) == SRSRAN_SUCCESS);
+      u.state = ue_state::msg3;
+      rach_it = pending_rachs.erase(rach_it);
+    }
+  }
+
+  void handle_feedback(tti_point tti_rx, sched_replay_stats& stats)
+  {
+    std::vector<harq_fb_t>& dl_fbs = dl_fb_ring[tti_rx.to_uint() % FB_RING_SIZE];
+    for (const harq_fb_t& fb : dl_fbs) {
+      ue_ctxt& u   = ues[fb.ue_idx];
+      bool     ack = fb.is_ra or u.dl_ack;
+      sched_obj.dl_ack_info(tti_rx.to_uint(), u.rnti, fb.cc, fb.tb_idx, ack);
+      stats.nof_dl_harq_fb++;
+      stats.nof_dl_nacks += ack ? 0 : 1;
+      stats.dl_bytes += ack ? fb.nof_bytes : 0;
+      if (fb.is_ra and u.state == ue_state::msg4) {
+        // Msg4 was received. Complete the UE configuration
+        TESTASSERT(sched_obj.ue_cfg(u.rnti, u.final_cfg) == SRSRAN_SUCCESS);
+        u.state = ue_state::connected;
+      }
+    }
+    dl_fbs.clear();
+
+    std::vector<harq_fb_t>& ul_fbs = ul_fb_ring[tti_rx.to_uint() % FB_RING_SIZE];
+    for (const harq_fb_t& fb : ul_fbs) {
+      ue_ctxt& u   = ues[fb.ue_idx];
+      bool     crc = fb.is_ra or u.ul_crc;
+      sched_obj.ul_crc_info(tti_rx.to_uint(), u.rnti, fb.cc, crc);
+      stats.nof_ul_harq_fb++;
+      stats.nof_ul_crc_kos += crc ? 0 : 1;
+      if (fb.is_ra and u.state == ue_state::msg3) {
+        // Msg3 was received. Schedule Msg4
+        TESTASSERT(sched_obj.ue_cfg(u.rnti, generate_setup_ue_cfg(u.final_cfg)) == SRSRAN_SUCCESS);
+        sched_obj.dl_rlc_buffer_state(u.rnti, srb_to_lcid(lte_srb::srb0), 50, 0);
+        sched_obj.dl_mac_buffer_state(u.rnti, (uint32_t)srsran::dl_sch_lcid::CON_RES_ID, 1);
+        u.state = ue_state::msg4;
+      } else if (crc and u.state == ue_state::connected) {
+        // The PUSCH carries a BSR with the remaining UL buffer
+        stats.ul_bytes += fb.nof_bytes;
+        u.ul_buffer -= std::min(u.ul_buffer, fb.nof_bytes);
+        sched_obj.ul_bsr(u.rnti, DRB_LCG, u.ul_buffer);
+      }
+    }
+    ul_fbs.clear();
+
+    for (ue_ctxt& u : ues) {
+      u.dl_ack = true;
+      u.ul_crc = true;
+    }
+  }
+
+  ue_ctxt* find_ue(uint16_t rnti)
+  {
+    uint32_t ue_idx = rnti - 0x46;
+    return rnti >= 0x46 and ue_idx < ues.size() ? &ues[ue_idx] : nullptr;
+  }
+
+  void process_results(tti_point tti_rx, sched_replay_stats& stats)
+  {
+    for (uint32_t cc = 0; cc < trace.nof_carriers; ++cc) {
+      const sched_interface::dl_sched_res_t& dl_res = dl_results[cc];
+      const sched_interface::ul_sched_res_t& ul_res = ul_results[cc];
+      stats.nof_decisions += dl_res.data.size() + dl_res.rar.size() + ul_res.pusch.size();
+
+      for (const auto& data : dl_res.data) {
+        ue_ctxt* u = find_ue(data.dci.rnti);
+        if (u == nullptr) {
+          continue;
+        }
+        for (uint32_t tb = 0; tb < SRSRAN_MAX_TB; ++tb) {
+          if (data.tbs[tb] == 0) {
+            continue;
+          }
+          for (uint32_t i = 0; i < data.nof_pdu_elems[tb]; ++i) {
+            if (data.pdu[tb][i].lcid == DRB_LCID) {
+              u->dl_buffer -= std::min(u->dl_buffer, data.pdu[tb][i].nbytes);
+            }
+          }
+          harq_fb_t fb{(uint32_t)(u - ues.data()), cc, tb, data.tbs[tb], u->state == ue_state::msg4};
+          dl_fb_ring[to_tx_dl_ack(tti_rx).to_uint() % FB_RING_SIZE].push_back(fb);
+        }
+      }
+
+      for (const auto& pusch : ul_res.pusch) {
+        ue_ctxt* u = find_ue(pusch.dci.rnti);
+        if (u == nullptr) {
+          continue;
+        }
+        harq_fb_t fb{(uint32_t)(u - ues.data()), cc, 0, pusch.tbs, u->state == ue_state::msg3};
+        ul_fb_ring[to_tx_ul(tti_rx).to_uint() % FB_RING_SIZE].push_back(fb);
+      }
+    }
+  }
+
+  const sched_replay_trace& trace;
+  rrc_dummy                 rrc;
+  sched                     sched_obj;
+  uint32_t                  prach_config = 0;
+
+  std::vector<ue_ctxt>                                  ues;
+  std::vector<uint32_t>                                 pending_rachs;
+  std::array<std::vector<harq_fb_t>, FB_RING_SIZE>      dl_fb_ring, ul_fb_ring;
+  std::vector<sched_interface::dl_sched_res_t>          dl_results;
+  std::vector<sched_interface::ul_sched_res_t>          ul_results;
+};
+
+int run_replay(const char* name, const sched_replay_trace& trace, uint32_t nof_prb, sched_replay_stats& stats)
+{
+  sched_lte_replayer replayer(trace, nof_prb);
+  TESTASSERT(replayer.run(stats) == SRSRAN_SUCCESS);
+  stats.print(name);
+  return SRSRAN_SUCCESS;
+}
+
+int run_test()
+{
+  sched_trace_gen_params params;
+  params.nof_ues      = 4;
+  params.nof_carriers = 2;
+  params.nof_ttis     = 2000;
+
+  sched_replay_stats stats;
+  TESTASSERT(run_replay("LTE replay test", generate_sched_trace(params), 25, stats) == SRSRAN_SUCCESS);
+  TESTASSERT(stats.nof_connected_ues == params.nof_ues);
+  TESTASSERT(stats.dl_bytes > 0 and stats.ul_bytes > 0);
+  TESTASSERT(stats.nof_dl_nacks > 0 and stats.nof_ul_crc_kos > 0);
+  return SRSRAN_SUCCESS;
+}
+
+int run_benchmark(const char* trace_file)
+{
+  sched_replay_stats stats;
+  if (trace_file != nullptr) {
+    sched_replay_trace trace;
+    TESTASSERT(load_sched_trace(trace_file, trace));
+    return run_replay(trace_file, trace, 100, stats);
+  }
+
+  sched_trace_gen_params params;
+  params.nof_ttis = 20000;
+  for (uint32_t nof_carriers : {1, 2}) {
+    for (uint32_t nof_ues : {8, 32}) {
+      params.nof_carriers = nof_carriers;
+      params.nof_ues      = nof_ues * nof_carriers;
+      std::string name    = fmt::format("LTE carriers={}, ues={}", params.nof_carriers, params.nof_ues);
+      TESTASSERT(run_replay(name.c_str(), generate_sched_trace(params), 100, stats) == SRSRAN_SUCCESS);
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsenb
+
+int main(int argc, char* argv[])
+{
+  auto& mac_log = srslog::fetch_basic_logger("MAC");
+  mac_log.set_level(srslog::basic_levels::warning);
+
+  // Start the log backend.
+  srslog::init();
+
+  if (argc == 1 or strcmp(argv[1], "test") == 0) {
+    TESTASSERT(srsenb::run_test() == SRSRAN_SUCCESS);
+  } else if (strcmp(argv[1], "benchmark") == 0) {
+    TESTASSERT(srsenb::run_benchmark(argc > 2 ? argv[2] : nullptr) == SRSRAN_SUCCESS);
+  } else if (strcmp(argv[1], "generate") == 0 and argc > 2) {
+    // Writes a synthetic trace, to be edited or replayed with both the LTE and NR schedulers
+    TESTASSERT(srsenb::save_sched_trace(argv[2], srsenb::generate_sched_trace(srsenb::sched_trace_gen_params{})));
+  } else {
+    printf("Usage: %s [test|benchmark|generate] [trace_file]\n", argv[0]);
+    return SRSRAN_ERROR;
+  }
+
+  srslog::flush();
+  return SRSRAN_SUCCESS;
+}
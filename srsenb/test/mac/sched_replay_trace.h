@@ -0,0 +1,242 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_SCHED_REPLAY_TRACE_H
+#define SRSRAN_SCHED_REPLAY_TRACE_H
+
+#include "srsran/srslog/srslog.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace srsenb {
+
+/*****************************
+ *   Scheduler Replay Traces
+ ****************************/
+
+/// UE event fed to the scheduler by the LTE and NR replay benchmarks
+struct sched_trace_event {
+  enum class type_t { rach, dl_buffer, ul_bsr, dl_cqi, ul_snr, dl_ack, ul_crc, nulltype };
+
+  uint32_t tti    = 0;
+  type_t   type   = type_t::nulltype;
+  uint32_t ue_idx = 0;
+  uint32_t cc     = 0;
+  float    value  = 0;
+};
+
+inline const char* to_string(sched_trace_event::type_t type)
+{
+  static const char* names[] = {"rach", "dl_buffer", "ul_bsr", "dl_cqi", "ul_snr", "dl_ack", "ul_crc"};
+  return type < sched_trace_event::type_t::nulltype ? names[(size_t)type] : "invalid";
+}
+
+/**
+ * Trace of UE events, sorted by TTI. In text form, each line holds one event "<tti> <type> <ue_idx> <cc> <value>":
+ * - rach: the UE sends a PRACH in carrier cc, which becomes its PCell. It precedes the other events of the UE
+ * - dl_buffer/ul_bsr: "value" bytes arrive to the UE DL RLC buffer/UL buffer
+ * - dl_cqi/ul_snr: DL CQI/UL SNR (dB) report
+ * - dl_ack/ul_crc: outcome (0 or 1) of the DL HARQ ACKs/PUSCH CRCs of the UE in carrier cc that are reported in this
+ *   TTI. The HARQ feedback without matching event is an ACK
+ * Lines starting with '#' are comments.
+ */
+struct sched_replay_trace {
+  std::vector<sched_trace_event> events;
+  uint32_t                       nof_ttis     = 0;
+  uint32_t                       nof_ues      = 0;
+  uint32_t                       nof_carriers = 0;
+
+  void push_back(const sched_trace_event& ev)
+  {
+    events.push_back(ev);
+    nof_ttis     = std::max(nof_ttis, ev.tti + 1);
+    nof_ues      = std::max(nof_ues, ev.ue_idx + 1);
+    nof_carriers = std::max(nof_carriers, ev.cc + 1);
+  }
+};
+
+inline bool load_sched_trace(const char* filename, sched_replay_trace& trace)
+{
+  std::ifstream file(filename);
+  if (not file.is_open()) {
+    fprintf(stderr, "Error opening trace file \"%s\"\n", filename);
+    return false;
+  }
+  trace = {};
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() or line[0] == '#') {
+      continue;
+    }
+    sched_trace_event ev;
+    char              type_str[16];
+    if (sscanf(line.c_str(), "%u %15s %u %u %f", &ev.tti, type_str, &ev.ue_idx, &ev.cc, &ev.value) != 5) {
+      fprintf(stderr, "Invalid trace line \"%s\"\n", line.c_str());
+      return false;
+    }
+    for (uint32_t t = 0; t < (uint32_t)sched_trace_event::type_t::nulltype; ++t) {
+      if (strcmp(type_str, to_string((sched_trace_event::type_t)t)) == 0) {
+        ev.type = (sched_trace_event::type_t)t;
+      }
+    }
+    bool unsorted = not trace.events.empty() and ev.tti < trace.events.back().tti;
+    if (ev.type == sched_trace_event::type_t::nulltype or unsorted) {
+      fprintf(stderr, "Invalid trace line \"%s\"\n", line.c_str());
+      return false;
+    }
+    trace.push_back(ev);
+  }
+  return true;
+}
+
+inline bool save_sched_trace(const char* filename, const sched_replay_trace& trace)
+{
+  std::ofstream file(filename);
+  if (not file.is_open()) {
+    fprintf(stderr, "Error opening trace file \"%s\"\n", filename);
+    return false;
+  }
+  file << "# tti type ue_idx cc value\n";
+  for (const sched_trace_event& ev : trace.events) {
+    file << ev.tti << " " << to_string(ev.type) << " " << ev.ue_idx << " " << ev.cc << " " << ev.value << "\n";
+  }
+  return true;
+}
+
+/// Parameters of a synthetic trace. UEs are evenly distributed across carriers
+struct sched_trace_gen_params {
+  uint32_t nof_ues          = 4;
+  uint32_t nof_carriers     = 1;
+  uint32_t nof_ttis         = 1000;
+  uint32_t start_tti        = 10;    ///< TTI of the first PRACH
+  uint32_t traffic_period   = 10;    ///< Period of the UE traffic arrivals, in TTIs
+  uint32_t dl_bytes_per_tti = 10000; ///< Mean DL bytes per UE per TTI
+  uint32_t ul_bytes_per_tti = 2000;  ///< Mean UL bytes per UE per TTI
+  uint32_t csi_period       = 5;     ///< Period of the CQI and SNR reports, in TTIs
+  float    dl_bler          = 0.1;
+  float    ul_bler          = 0.1;
+  uint32_t seed             = 0;
+};
+
+inline sched_replay_trace generate_sched_trace(const sched_trace_gen_params& params)
+{
+  using type_t = sched_trace_event::type_t;
+
+  std::mt19937                          rgen(params.seed);
+  std::uniform_real_distribution<float> unif(0, 1);
+  std::vector<int>                      cqi(params.nof_ues, 10);
+  std::vector<float>                    snr(params.nof_ues, 15);
+  sched_replay_trace                    trace;
+
+  for (uint32_t tti = 0; tti < params.nof_ttis; ++tti) {
+    for (uint32_t ue_idx = 0; ue_idx < params.nof_ues; ++ue_idx) {
+      uint32_t cc = ue_idx % params.nof_carriers;
+      // UEs attach one per TTI, once the cell is running
+      uint32_t rach_tti = params.start_tti + ue_idx;
+      if (tti == rach_tti) {
+        trace.push_back({tti, type_t::rach, ue_idx, cc, 0});
+      }
+      if (tti <= rach_tti) {
+        continue;
+      }
+      // UE channel quality follows a random walk
+      if ((tti + ue_idx) % params.csi_period == 0) {
+        cqi[ue_idx] = std::max(1, std::min(15, cqi[ue_idx] + (int)(unif(rgen) * 3) - 1));
+        snr[ue_idx] = std::max(0.0f, std::min(30.0f, snr[ue_idx] + unif(rgen) * 2 - 1));
+        trace.push_back({tti, type_t::dl_cqi, ue_idx, cc, (float)cqi[ue_idx]});
+        trace.push_back({tti, type_t::ul_snr, ue_idx, cc, snr[ue_idx]});
+      }
+      // Bursty traffic, with random size around the mean
+      if ((tti + ue_idx) % params.traffic_period == 0) {
+        float burst = params.traffic_period * 2 * unif(rgen);
+        trace.push_back({tti, type_t::dl_buffer, ue_idx, cc, std::round(burst * params.dl_bytes_per_tti)});
+        trace.push_back({tti, type_t::ul_bsr, ue_idx, cc, std::round(burst * params.ul_bytes_per_tti)});
+      }
+      if (unif(rgen) < params.dl_bler) {
+        trace.push_back({tti, type_t::dl_ack, ue_idx, cc, 0});
+      }
+      if (unif(rgen) < params.ul_bler) {
+        trace.push_back({tti, type_t::ul_crc, ue_idx, cc, 0});
+      }
+    }
+  }
+  trace.nof_ttis = params.nof_ttis;
+  return trace;
+}
+
+/*****************************
+ *   Scheduler Replay KPIs
+ ****************************/
+
+struct sched_replay_stats {
+  std::vector<uint32_t> latency_ns;        ///< Time spent in the scheduler in each TTI
+  uint64_t              nof_decisions = 0; ///< Number of DL and UL grants
+  uint64_t              dl_bytes      = 0; ///< ACKed DL bytes
+  uint64_t              ul_bytes      = 0; ///< Decoded UL bytes
+  uint32_t              nof_dl_harq_fb = 0, nof_dl_nacks = 0;
+  uint32_t              nof_ul_harq_fb = 0, nof_ul_crc_kos = 0;
+  uint32_t              nof_connected_ues = 0, nof_ues = 0;
+
+  uint32_t latency_percentile_ns(double q) const
+  {
+    if (latency_ns.empty()) {
+      return 0;
+    }
+    std::vector<uint32_t> sorted = latency_ns;
+    size_t                idx    = std::min((size_t)(q * sorted.size()), sorted.size() - 1);
+    std::nth_element(sorted.begin(), sorted.begin() + idx, sorted.end());
+    return sorted[idx];
+  }
+
+  void print(const char* name) const
+  {
+    uint32_t nof_ttis = latency_ns.size();
+    double   total_s  = 0;
+    for (uint32_t t : latency_ns) {
+      total_s += t * 1e-9;
+    }
+    fmt::print("{}: {} TTIs, {}/{} UEs connected\n", name, nof_ttis, nof_connected_ues, nof_ues);
+    fmt::print("  sched latency [usec]: p50={:.1f} p99={:.1f} p99.9={:.1f} max={:.1f}\n",
+               latency_percentile_ns(0.5) / 1000.0,
+               latency_percentile_ns(0.99) / 1000.0,
+               latency_percentile_ns(0.999) / 1000.0,
+               latency_percentile_ns(1.0) / 1000.0);
+    fmt::print("  rate: {:.0f} TTIs/s ({:.1f}x real-time), {:.0f} decisions/s\n",
+               total_s > 0 ? nof_ttis / total_s : 0,
+               total_s > 0 ? nof_ttis * 1e-3 / total_s : 0,
+               total_s > 0 ? nof_decisions / total_s : 0);
+    fmt::print("  DL/UL: {:.2f}/{:.2f} Mbps, BLER {:.3f}/{:.3f}, {:.2f} grants/TTI\n",
+               nof_ttis > 0 ? dl_bytes * 8e-3 / nof_ttis : 0,
+               nof_ttis > 0 ? ul_bytes * 8e-3 / nof_ttis : 0,
+               nof_dl_harq_fb > 0 ? nof_dl_nacks / (double)nof_dl_harq_fb : 0,
+               nof_ul_harq_fb > 0 ? nof_ul_crc_kos / (double)nof_ul_harq_fb : 0,
+               nof_ttis > 0 ? nof_decisions / (double)nof_ttis : 0);
+  }
+};
+
+} // namespace srsenb
+
+#endif // SRSRAN_SCHED_REPLAY_TRACE_H
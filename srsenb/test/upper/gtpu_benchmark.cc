@@ -0,0 +1,324 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Sends the G-PDUs of several UEs through the loopback interface to the eNB GTP-U, which writes them to a PDCP that
+ * checks their order, and sends the PDUs of PDCP to a local SGW socket. The rate of packets handled by GTP-U is
+ * measured in both directions, with the S1-U socket read in batches and one datagram at a time.
+ *
+ * Usage: gtpu_benchmark [test|benchmark]
+ */
+
+#include "srsenb/hdr/stack/upper/gtpu.h"
+#include "srsran/common/int_helpers.h"
+#include "srsran/common/network_utils.h"
+#include "srsran/common/test_common.h"
+#include "srsran/interfaces/enb_pdcp_interfaces.h"
+#include "srsran/upper/gtpu.h"
+#include <chrono>
+#include <linux/ip.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace srsenb;
+
+namespace {
+
+const uint16_t first_rnti    = 0x46;
+const uint32_t eps_bearer_id = 5;
+const uint32_t nof_ues       = 64;
+const uint32_t burst_len     = 8; ///< consecutive G-PDUs of the same UE
+const uint32_t ip_pkt_len    = 64;
+const char*    enb_addr_str  = "127.0.2.1";
+const char*    sgw_addr_str  = "127.0.2.2";
+const int      gtpu_port     = 2152;
+
+// The SDUs of each UE carry a sequence number after the IP header
+class pdcp_tester : public pdcp_interface_gtpu
+{
+public:
+  void write_sdu(uint16_t rnti, uint32_t eps_bearer_id, srsran::unique_byte_buffer_t sdu, int pdcp_sn) override
+  {
+    check_sdu(rnti, *sdu);
+  }
+  void write_sdus(uint16_t rnti, uint32_t eps_bearer_id, srsran::span<srsran::unique_byte_buffer_t> sdus) override
+  {
+    nof_batches++;
+    for (srsran::unique_byte_buffer_t& sdu : sdus) {
+      check_sdu(rnti, *sdu);
+    }
+  }
+  std::map<uint32_t, srsran::unique_byte_buffer_t> get_buffered_pdus(uint16_t rnti, uint32_t eps_bearer_id) override
+  {
+    return {};
+  }
+
+  std::vector<uint32_t> next_sn     = std::vector<uint32_t>(nof_ues, 0);
+  uint64_t              nof_sdus    = 0;
+  uint64_t              nof_batches = 0;
+  uint64_t              nof_errors  = 0;
+
+private:
+  void check_sdu(uint16_t rnti, const srsran::byte_buffer_t& sdu)
+  {
+    uint32_t sn;
+    srsran::uint8_to_uint32(sdu.msg + sizeof(iphdr), &sn);
+    if (sdu.N_bytes != ip_pkt_len or sn != next_sn[rnti - first_rnti]++) {
+      nof_errors++;
+    }
+    nof_sdus++;
+  }
+};
+
+struct socket_manager_tester : public srsran::socket_manager_itf {
+  socket_manager_tester() : srsran::socket_manager_itf(srslog::fetch_basic_logger("TEST")) {}
+
+  bool add_socket_handler(int fd_, recv_callback_t handler) final
+  {
+    fd       = fd_;
+    callback = std::move(handler);
+    return true;
+  }
+  bool remove_socket(int fd_) final { return true; }
+
+  int             fd = -1;
+  recv_callback_t callback;
+};
+
+int open_udp_socket(const char* addr_str, int port, sockaddr_in* addr)
+{
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  TESTASSERT(fd >= 0);
+  TESTASSERT(srsran::net_utils::bind_addr(fd, addr_str, port, addr));
+  int bufsize = 4 * 1024 * 1024;
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufsize, sizeof(bufsize));
+  return fd;
+}
+
+// IPv4 packet with the sequence number of the UE after the header
+void write_ip_packet(uint8_t* buf, uint32_t sn)
+{
+  iphdr ip_hdr   = {};
+  ip_hdr.version = 4;
+  ip_hdr.ihl     = 5;
+  ip_hdr.tot_len = htons(ip_pkt_len);
+  memcpy(buf, &ip_hdr, sizeof(ip_hdr));
+  memset(buf + sizeof(ip_hdr), 0, ip_pkt_len - sizeof(ip_hdr));
+  srsran::uint32_to_uint8(sn, buf + sizeof(ip_hdr));
+}
+
+// Receives the G-PDUs sent by the eNB, and returns how many of them are well-formed
+uint32_t drain_sgw_socket(int fd, const std::vector<uint32_t>& teids_out)
+{
+  std::array<uint8_t[256], srsran::MAX_SDU_BATCH_SIZE> bufs;
+  std::array<iovec, srsran::MAX_SDU_BATCH_SIZE>        iovs;
+  std::array<mmsghdr, srsran::MAX_SDU_BATCH_SIZE>      msgs = {};
+  for (uint32_t i = 0; i < srsran::MAX_SDU_BATCH_SIZE; ++i) {
+    iovs[i]                    = {bufs[i], sizeof(bufs[i])};
+    msgs[i].msg_hdr.msg_iov    = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  uint32_t nof_valid = 0;
+  int      n;
+  while ((n = recvmmsg(fd, msgs.data(), msgs.size(), MSG_DONTWAIT, nullptr)) > 0) {
+    for (int i = 0; i < n; ++i) {
+      srsran::byte_buffer_t pdu;
+      pdu.append_bytes(bufs[i], msgs[i].msg_len);
+      srsran::gtpu_header_t header;
+      if (srsran::gtpu_read_header(&pdu, &header, srslog::fetch_basic_logger("TEST")) and
+          header.message_type == GTPU_MSG_DATA_PDU and pdu.N_bytes == ip_pkt_len and
+          std::find(teids_out.begin(), teids_out.end(), header.teid) != teids_out.end()) {
+        nof_valid++;
+      }
+    }
+  }
+  return nof_valid;
+}
+
+// Returns the number of G-PDUs handled per second
+double run_rx(uint32_t nof_rounds, bool batch, bool check)
+{
+  srsran::task_scheduler task_sched;
+  socket_manager_tester  rx_sockets;
+  pdcp_tester            pdcp;
+  srslog::basic_logger&  logger = srslog::fetch_basic_logger("GTPU", false);
+  gtpu                   enb_gtpu(&task_sched, logger, srsran::srsran_rat_t::lte, &rx_sockets);
+  gtpu_args_t            args;
+  args.gtp_bind_addr = enb_addr_str;
+  args.mme_addr      = sgw_addr_str;
+  TESTASSERT(enb_gtpu.init(args, &pdcp) == SRSRAN_SUCCESS);
+
+  sockaddr_in sgw_addr, enb_addr;
+  int         sgw_fd = open_udp_socket(sgw_addr_str, 0, &sgw_addr);
+  srsran::net_utils::set_sockaddr(&enb_addr, enb_addr_str, gtpu_port);
+  std::vector<uint32_t> teids_in(nof_ues);
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    uint32_t addr_in;
+    teids_in[i] =
+        enb_gtpu.add_bearer(first_rnti + i, eps_bearer_id, ntohl(sgw_addr.sin_addr.s_addr), i, addr_in).value();
+  }
+
+  // Reads the datagrams one at a time, as before the batch reads were introduced
+  srsran::task_queue_handle                   queue = task_sched.make_task_queue();
+  srsran::socket_manager_itf::recv_callback_t single_handler =
+      srsran::make_sdu_handler(logger, queue, [&enb_gtpu](srsran::unique_byte_buffer_t pdu, const sockaddr_in& from) {
+        enb_gtpu.handle_gtpu_s1u_rx_packet(std::move(pdu), from);
+      });
+
+  std::array<uint8_t[GTPU_BASE_HEADER_LEN + ip_pkt_len], srsran::MAX_SDU_BATCH_SIZE> bufs;
+  std::array<iovec, srsran::MAX_SDU_BATCH_SIZE>                                     iovs;
+  std::array<mmsghdr, srsran::MAX_SDU_BATCH_SIZE>                                   msgs = {};
+  for (uint32_t i = 0; i < srsran::MAX_SDU_BATCH_SIZE; ++i) {
+    iovs[i]                     = {bufs[i], sizeof(bufs[i])};
+    msgs[i].msg_hdr.msg_name    = &enb_addr;
+    msgs[i].msg_hdr.msg_namelen = sizeof(enb_addr);
+    msgs[i].msg_hdr.msg_iov     = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen  = 1;
+  }
+
+  std::vector<uint32_t>    tx_sn(nof_ues, 0);
+  uint32_t                 ue       = 0;
+  uint64_t                 nof_sent = 0;
+  std::chrono::nanoseconds read_time{0}, handle_time{0};
+  for (uint32_t round = 0; round < nof_rounds; ++round) {
+    // Bursts of G-PDUs of consecutive UEs, as the SGW would send them
+    for (uint32_t i = 0; i < srsran::MAX_SDU_BATCH_SIZE; ++i) {
+      if (i > 0 and i % burst_len == 0) {
+        ue = (ue + 1) % nof_ues;
+      }
+      srsran::gtpu_tx_header_template hdr;
+      hdr.init(teids_in[ue]);
+      srsran::byte_buffer_t pdu;
+      write_ip_packet(pdu.msg, tx_sn[ue]++);
+      pdu.N_bytes = ip_pkt_len;
+      hdr.write(&pdu);
+      memcpy(bufs[i], pdu.msg, pdu.N_bytes);
+    }
+    ue = (ue + 1) % nof_ues;
+    TESTASSERT(sendmmsg(sgw_fd, msgs.data(), msgs.size(), 0) == (int)msgs.size());
+    nof_sent += msgs.size();
+
+    // The socket is read by the socket thread, and the G-PDUs are handled by the stack thread
+    auto tp = std::chrono::steady_clock::now();
+    if (batch) {
+      rx_sockets.callback(rx_sockets.fd);
+    } else {
+      for (uint32_t i = 0; i < srsran::MAX_SDU_BATCH_SIZE; ++i) {
+        single_handler(rx_sockets.fd);
+      }
+    }
+    auto tp2 = std::chrono::steady_clock::now();
+    task_sched.run_pending_tasks();
+    read_time += tp2 - tp;
+    handle_time += std::chrono::steady_clock::now() - tp2;
+  }
+  double pps = nof_sent / std::chrono::duration<double>(handle_time).count();
+  printf("Rx %s: %" PRIu64 " G-PDUs, %.2f Mpps handled by GTP-U, %.1f ns/G-PDU reading the socket, %.1f SDUs per PDCP "
+         "call\n",
+         batch ? "batch" : "single",
+         pdcp.nof_sdus,
+         pps * 1e-6,
+         std::chrono::duration<double, std::nano>(read_time).count() / nof_sent,
+         pdcp.nof_batches > 0 ? (double)pdcp.nof_sdus / pdcp.nof_batches : 1.0);
+
+  if (check) {
+    TESTASSERT(pdcp.nof_sdus == nof_sent);
+    TESTASSERT(pdcp.nof_errors == 0);
+    if (batch) {
+      TESTASSERT(pdcp.nof_batches == nof_sent / burst_len);
+    }
+  }
+  close(sgw_fd);
+  return pps;
+}
+
+// Returns the number of G-PDUs sent per second
+double run_tx(uint32_t nof_rounds, bool check)
+{
+  srsran::task_scheduler task_sched;
+  socket_manager_tester  rx_sockets;
+  pdcp_tester            pdcp;
+  srslog::basic_logger&  logger = srslog::fetch_basic_logger("GTPU", false);
+  gtpu                   enb_gtpu(&task_sched, logger, srsran::srsran_rat_t::lte, &rx_sockets);
+  gtpu_args_t            args;
+  args.gtp_bind_addr = enb_addr_str;
+  args.mme_addr      = sgw_addr_str;
+  TESTASSERT(enb_gtpu.init(args, &pdcp) == SRSRAN_SUCCESS);
+
+  sockaddr_in           sgw_addr;
+  int                   sgw_fd = open_udp_socket(sgw_addr_str, gtpu_port, &sgw_addr);
+  std::vector<uint32_t> teids_out(nof_ues);
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    uint32_t addr_in;
+    teids_out[i] = 0x100 + i;
+    enb_gtpu.add_bearer(first_rnti + i, eps_bearer_id, ntohl(sgw_addr.sin_addr.s_addr), teids_out[i], addr_in);
+  }
+
+  uint64_t                 nof_sent = 0, nof_valid = 0;
+  std::chrono::nanoseconds elapsed{0};
+  for (uint32_t round = 0; round < nof_rounds; ++round) {
+    std::array<srsran::unique_byte_buffer_t, srsran::MAX_SDU_BATCH_SIZE> pdus;
+    for (uint32_t i = 0; i < pdus.size(); ++i) {
+      pdus[i] = srsran::make_byte_buffer();
+      write_ip_packet(pdus[i]->msg, nof_sent + i);
+      pdus[i]->N_bytes = ip_pkt_len;
+    }
+    auto tp = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < pdus.size(); ++i) {
+      enb_gtpu.write_pdu(first_rnti + (nof_sent + i) / burst_len % nof_ues, eps_bearer_id, std::move(pdus[i]));
+    }
+    elapsed += std::chrono::steady_clock::now() - tp;
+    nof_sent += pdus.size();
+    nof_valid += drain_sgw_socket(sgw_fd, teids_out);
+  }
+  double pps = nof_sent / std::chrono::duration<double>(elapsed).count();
+  printf("Tx: %" PRIu64 " G-PDUs, %.2f Mpps sent by GTP-U\n", nof_sent, pps * 1e-6);
+
+  if (check) {
+    TESTASSERT(nof_valid == nof_sent);
+  }
+  close(sgw_fd);
+  return pps;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  srslog::init();
+  srslog::fetch_basic_logger("GTPU", false).set_level(srslog::basic_levels::warning);
+
+  uint32_t nof_rounds;
+  if (argc == 1 or strcmp(argv[1], "test") == 0) {
+    nof_rounds = 100;
+  } else if (strcmp(argv[1], "benchmark") == 0) {
+    nof_rounds = 100000;
+  } else {
+    printf("Usage: %s [test|benchmark]\n", argv[0]);
+    return SRSRAN_ERROR;
+  }
+  run_rx(nof_rounds, false, true);
+  run_rx(nof_rounds, true, true);
+  run_tx(nof_rounds, true);
+
+  srslog::flush();
+  return SRSRAN_SUCCESS;
+}
@@ -157,6 +157,49 @@ srsran::unique_byte_buffer_t read_socket(int fd)
   return pdu;
 }
 
+void test_gtpu_tx_header_template()
+{
+  srslog::basic_logger&           logger = srslog::fetch_basic_logger("GTPU");
+  const uint32_t                  teid   = 0x12345678;
+  srsran::gtpu_tx_header_template tx_header;
+  tx_header.init(teid);
+
+  // The header must be the same as the one written by gtpu_write_header, with and without PDCP SN
+  std::vector<uint8_t> data(20, 0xab);
+  for (int pdcp_sn : {-1, 0, 0x1234}) {
+    srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+    pdu->append_bytes(data.data(), data.size());
+    srsran::gtpu_header_t header = {};
+    header.flags                 = GTPU_FLAGS_VERSION_V1 | GTPU_FLAGS_GTP_PROTOCOL;
+    header.message_type          = GTPU_MSG_DATA_PDU;
+    header.length                = pdu->N_bytes;
+    header.teid                  = teid;
+    if (pdcp_sn >= 0) {
+      header.flags |= GTPU_FLAGS_EXTENDED_HDR;
+      header.next_ext_hdr_type = GTPU_EXT_HEADER_PDCP_PDU_NUMBER;
+      header.ext_buffer        = {0x01, (uint8_t)(pdcp_sn >> 8u), (uint8_t)pdcp_sn, 0x00};
+    }
+    TESTASSERT(gtpu_write_header(&header, pdu.get(), logger));
+
+    srsran::unique_byte_buffer_t pdu2 = srsran::make_byte_buffer();
+    pdu2->append_bytes(data.data(), data.size());
+    TESTASSERT(tx_header.write(pdu2.get(), pdcp_sn));
+    TESTASSERT(pdu2->N_bytes == pdu->N_bytes and memcmp(pdu2->msg, pdu->msg, pdu->N_bytes) == 0);
+
+    // The SN is read back from the extension header
+    srsran::gtpu_header_t header2;
+    TESTASSERT(gtpu_read_header(pdu2.get(), &header2, logger));
+    TESTASSERT(header2.teid == teid and pdu2->N_bytes == data.size());
+    TESTASSERT(pdcp_sn < 0 or (header2.ext_buffer[1] << 8u) + header2.ext_buffer[2] == pdcp_sn);
+  }
+
+  // No room for the header
+  srsran::byte_buffer_t pdu;
+  pdu.msg = pdu.buffer + GTPU_BASE_HEADER_LEN;
+  TESTASSERT(tx_header.write(&pdu));
+  TESTASSERT(not tx_header.write(&pdu, 5));
+}
+
 void test_gtpu_tunnel_manager()
 {
   const char*        sgw_addr_str = "127.0.0.1";
@@ -177,6 +220,7 @@ void test_gtpu_tunnel_manager()
   const gtpu_tunnel* tun = tunnels.add_tunnel(0x46, drb1_eps_bearer_id, 5, sgw_addr);
   TESTASSERT(tun != nullptr);
   TESTASSERT(tunnels.find_tunnel(tun->teid_in) == tun);
+  TESTASSERT(tunnels.find_tx_tunnel(0x46, drb1_eps_bearer_id) == tun);
   const gtpu_tunnel* tun2 = tunnels.add_tunnel(0x47, drb1_eps_bearer_id, 6, sgw_addr);
   TESTASSERT(tun2 != nullptr);
   TESTASSERT(tunnels.find_tunnel(tun2->teid_in) == tun2);
@@ -196,11 +240,13 @@ void test_gtpu_tunnel_manager()
   // Removing a tunnel also clears any associated forwarding tunnel
   TESTASSERT(tunnels.remove_tunnel(tun->teid_in));
   TESTASSERT(tunnels.find_rnti_bearer_tunnels(0x46, drb1_eps_bearer_id).empty());
+  TESTASSERT(tunnels.find_tx_tunnel(0x46, drb1_eps_bearer_id) == nullptr);
 
   // TEST: Prioritization of one TEID over another
   const gtpu_tunnel* before_tun = tunnels.add_tunnel(0x46, drb1_eps_bearer_id, 7, sgw_addr);
   const gtpu_tunnel* after_tun  = tunnels.add_tunnel(0x46, drb1_eps_bearer_id, 8, sgw_addr);
   TESTASSERT(before_tun != nullptr and after_tun != nullptr);
+  TESTASSERT(tunnels.find_tx_tunnel(0x46, drb1_eps_bearer_id) == before_tun);
   tunnels.set_tunnel_priority(before_tun->teid_in, after_tun->teid_in);
   for (uint32_t i = 0; i < 1000; ++i) {
     TESTASSERT(before_tun->state == gtpu_tunnel_manager::tunnel_state::pdcp_active);
@@ -213,6 +259,7 @@ void test_gtpu_tunnel_manager()
   tunnels.remove_tunnel(before_tun->teid_in);
   TESTASSERT(tunnels.find_rnti_bearer_tunnels(0x46, drb1_eps_bearer_id).size() == 1);
   TESTASSERT(after_tun->state == gtpu_tunnel_manager::tunnel_state::pdcp_active);
+  TESTASSERT(tunnels.find_tx_tunnel(0x46, drb1_eps_bearer_id) == after_tun);
 }
 
 enum class tunnel_test_event { success, wait_end_marker_timeout, ue_removal_no_marker, reest_senb };
@@ -394,6 +441,7 @@ int main(int argc, char** argv)
   // Start the log backend.
   srsran::test_init(argc, argv);
 
+  srsenb::test_gtpu_tx_header_template();
   srsenb::test_gtpu_tunnel_manager();
   TESTASSERT(srsenb::test_gtpu_direct_tunneling(srsenb::tunnel_test_event::success) == SRSRAN_SUCCESS);
   TESTASSERT(srsenb::test_gtpu_direct_tunneling(srsenb::tunnel_test_event::wait_end_marker_timeout) == SRSRAN_SUCCESS);
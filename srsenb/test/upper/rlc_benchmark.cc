@@ -0,0 +1,211 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Reads the RLC PDUs of 512 UEs x 4 bearers from several worker threads, as the PHY workers do, while the stack thread
+ * adds and removes other UEs, and measures the cost of read_pdu(). The test checks that all the SDUs are read and that
+ * the removed UEs are no longer found.
+ *
+ * Usage: rlc_benchmark [test|benchmark]
+ */
+
+#include "srsenb/hdr/stack/upper/rlc.h"
+#include "srsran/common/test_common.h"
+#include "srsran/interfaces/enb_mac_interfaces.h"
+#include "srsran/interfaces/enb_pdcp_interfaces.h"
+#include "srsran/interfaces/enb_rrc_interface_rlc.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace srsenb;
+
+namespace {
+
+const uint32_t nof_ues          = 512;
+const uint32_t nof_bearers      = 4;
+const uint16_t first_rnti       = 0x46;
+const uint16_t first_churn_rnti = first_rnti + nof_ues;
+const uint32_t nof_churn_ues    = 16;
+const uint32_t sdu_len          = 1000;
+const uint32_t grant_len        = 100;
+
+class pdcp_dummy : public pdcp_interface_rlc
+{
+public:
+  void write_pdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t pdu) override {}
+  void notify_delivery(uint16_t rnti, uint32_t lcid, const srsran::pdcp_sn_vector_t& pdcp_sns) override {}
+  void notify_failure(uint16_t rnti, uint32_t lcid, const srsran::pdcp_sn_vector_t& pdcp_sns) override {}
+};
+
+class rrc_dummy : public rrc_interface_rlc
+{
+public:
+  void max_retx_attempted(uint16_t rnti) override {}
+  void protocol_failure(uint16_t rnti) override {}
+  void write_pdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t sdu) override {}
+};
+
+class mac_dummy : public mac_interface_rlc
+{
+public:
+  int rlc_buffer_state(uint16_t rnti, uint32_t lc_id, uint32_t tx_queue, uint32_t retx_queue) override
+  {
+    return SRSRAN_SUCCESS;
+  }
+};
+
+// SRBs in AM and DRBs in UM
+void add_ue(rlc& rlc, uint16_t rnti)
+{
+  rlc.add_user(rnti);
+  for (uint32_t lcid = 1; lcid <= nof_bearers; ++lcid) {
+    rlc.add_bearer(rnti,
+                   lcid,
+                   lcid <= 2 ? srsran::rlc_config_t::srb_config(lcid) : srsran::rlc_config_t::default_rlc_um_config());
+  }
+}
+
+// Only the DRBs have data, as the AM PDUs would be kept in the buffer pool until acknowledged
+void write_sdus(rlc& rlc)
+{
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    for (uint32_t lcid = 3; lcid <= nof_bearers; ++lcid) {
+      srsran::unique_byte_buffer_t sdu = srsran::make_byte_buffer();
+      sdu->N_bytes                     = sdu_len;
+      rlc.write_sdu(first_rnti + i, lcid, std::move(sdu));
+    }
+  }
+}
+
+struct worker_result_t {
+  uint64_t nof_reads = 0;
+  uint64_t nof_bytes = 0;
+  double   time_s    = 0;
+};
+
+// Reads the PDUs of all bearers of all UEs, once per TTI, as a PHY worker does
+void read_worker(rlc& rlc, uint32_t nof_ttis, worker_result_t& result)
+{
+  uint8_t payload[grant_len];
+  auto    tp = std::chrono::steady_clock::now();
+  for (uint32_t tti = 0; tti < nof_ttis; ++tti) {
+    for (uint32_t i = 0; i < nof_ues; ++i) {
+      for (uint32_t lcid = 1; lcid <= nof_bearers; ++lcid) {
+        int ret = rlc.read_pdu(first_rnti + i, lcid, payload, grant_len);
+        if (ret > 0) {
+          result.nof_bytes += ret;
+        }
+        result.nof_reads++;
+      }
+    }
+  }
+  result.time_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - tp).count();
+}
+
+// Returns the average time of a read_pdu() call in ns
+double run(uint32_t nof_workers, uint32_t nof_ttis, bool check)
+{
+  srsran::timer_handler timers;
+  pdcp_dummy            pdcp;
+  rrc_dummy             rrc;
+  mac_dummy             mac;
+  rlc                   rlc(srslog::fetch_basic_logger("RLC", false));
+  rlc.init(&pdcp, &rrc, &mac, &timers);
+
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    add_ue(rlc, first_rnti + i);
+  }
+  write_sdus(rlc);
+
+  std::vector<worker_result_t> results(nof_workers);
+  std::vector<std::thread>     workers;
+  for (uint32_t w = 0; w < nof_workers; ++w) {
+    workers.emplace_back(read_worker, std::ref(rlc), nof_ttis, std::ref(results[w]));
+  }
+
+  // Users come and go while the workers read the PDUs
+  std::atomic<bool> done{false};
+  uint32_t          nof_churns = 0;
+  std::thread       stack([&rlc, &done, &nof_churns]() {
+    while (not done) {
+      uint16_t rnti = first_churn_rnti + nof_churns % nof_churn_ues;
+      add_ue(rlc, rnti);
+      rlc.rem_user(rnti);
+      nof_churns++;
+    }
+  });
+  for (std::thread& t : workers) {
+    t.join();
+  }
+  done = true;
+  stack.join();
+
+  worker_result_t total;
+  for (worker_result_t& r : results) {
+    total.nof_reads += r.nof_reads;
+    total.nof_bytes += r.nof_bytes;
+    total.time_s = std::max(total.time_s, r.time_s);
+  }
+  double ns_per_read = total.time_s * 1e9 * nof_workers / total.nof_reads;
+  printf("%d workers: %" PRIu64 " reads, %.1f ns/read, %.2f Mreads/s, %d UEs added and removed\n",
+         nof_workers,
+         total.nof_reads,
+         ns_per_read,
+         total.nof_reads / total.time_s * 1e-6,
+         nof_churns);
+
+  if (check) {
+    // RLC headers are added to the SDUs
+    TESTASSERT(total.nof_bytes >= (uint64_t)nof_ues * (nof_bearers - 2) * sdu_len);
+    uint8_t payload[grant_len];
+    TESTASSERT(rlc.read_pdu(first_churn_rnti, 1, payload, grant_len) == SRSRAN_ERROR);
+    TESTASSERT(not rlc.has_bearer(first_churn_rnti, 1));
+    TESTASSERT(rlc.has_bearer(first_rnti, nof_bearers));
+  }
+  rlc.stop();
+  return ns_per_read;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  srslog::init();
+  srslog::fetch_basic_logger("RLC", false).set_level(srslog::basic_levels::warning);
+
+  uint32_t nof_ttis;
+  if (argc == 1 or strcmp(argv[1], "test") == 0) {
+    nof_ttis = 20;
+  } else if (strcmp(argv[1], "benchmark") == 0) {
+    nof_ttis = 2000;
+  } else {
+    printf("Usage: %s [test|benchmark]\n", argv[0]);
+    return SRSRAN_ERROR;
+  }
+  for (uint32_t nof_workers : {1, 2, 4}) {
+    run(nof_workers, nof_ttis, true);
+  }
+
+  srslog::flush();
+  return SRSRAN_SUCCESS;
+}
@@ -25,6 +25,7 @@
 #include "srsepc/hdr/spgw/spgw.h"
 #include "srsran/asn1/gtpc.h"
 #include "srsran/common/buffer_pool.h"
+#include "srsran/common/datagram_socket.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/interfaces/epc_interfaces.h"
 #include "srsran/srslog/srslog.h"
@@ -47,6 +48,7 @@ public:
   int get_s1u();
 
   void handle_sgi_pdu(srsran::unique_byte_buffer_t msg);
+  void read_s1u_pdus();
   void handle_s1u_pdu(srsran::byte_buffer_t* msg);
   void send_s1u_pdu(srsran::gtp_fteid_t enb_fteid, srsran::byte_buffer_t* msg);
 
@@ -64,9 +66,9 @@ public:
   bool m_sgi_up;
   int  m_sgi;
 
-  bool        m_s1u_up;
-  int         m_s1u;
-  sockaddr_in m_s1u_addr;
+  bool                                     m_s1u_up;
+  std::unique_ptr<srsran::datagram_socket> m_s1u_socket;
+  sockaddr_in                              m_s1u_addr;
 
   std::map<in_addr_t, srsran::gtp_fteid_t> m_ip_to_usr_teid; // Map IP to User-plane TEID for downlink traffic
   std::map<in_addr_t, uint32_t>            m_ip_to_ctr_teid; // IP to control TEID map. Important to check if
@@ -83,7 +85,7 @@ inline int spgw::gtpu::get_sgi()
 
 inline int spgw::gtpu::get_s1u()
 {
-  return m_s1u;
+  return m_s1u_socket->get_fd();
 }
 
 inline in_addr_t spgw::gtpu::get_s1u_addr()
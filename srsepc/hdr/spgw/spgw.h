@@ -43,6 +43,9 @@ const uint16_t GTPU_RX_PORT = 2152;
 
 typedef struct {
   std::string gtpu_bind_addr;
+  std::string gtpu_socket_type;
+  std::string gtpu_xdp_if_name;
+  uint32_t    gtpu_xdp_queue_id;
   std::string sgi_if_addr;
   std::string sgi_if_name;
   uint32_t    max_paging_queue;
@@ -88,6 +88,9 @@ void parse_args(all_args_t* args, int argc, char* argv[])
   uint16_t paging_timer     = 0;
   uint32_t max_paging_queue = 0;
   string   spgw_bind_addr;
+  string   spgw_socket_type;
+  string   spgw_xdp_if_name;
+  uint32_t spgw_xdp_queue_id;
   string   sgi_if_addr;
   string   sgi_if_name;
   string   dns_addr;
@@ -128,6 +131,9 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("mme.lac",             bpo::value<string>(&lac)->default_value("0x01"),                 "Location Area Code")
     ("hss.db_file",         bpo::value<string>(&hss_db_file)->default_value("ue_db.csv"),    ".csv file that stores UE's keys")
     ("spgw.gtpu_bind_addr", bpo::value<string>(&spgw_bind_addr)->default_value("127.0.0.1"), "IP address of SP-GW for the S1-U connection")
+    ("spgw.gtpu_socket_type", bpo::value<string>(&spgw_socket_type)->default_value("udp"), "Backend of the S1-U socket: udp or af_xdp (falls back to udp if the AF_XDP socket cannot be created)")
+    ("spgw.gtpu_xdp_if_name", bpo::value<string>(&spgw_xdp_if_name)->default_value(""),    "Interface where the S1-U traffic is received, for the af_xdp socket")
+    ("spgw.gtpu_xdp_queue",   bpo::value<uint32_t>(&spgw_xdp_queue_id)->default_value(0),  "Rx queue of the interface where the S1-U traffic is steered to, for the af_xdp socket")
     ("spgw.sgi_if_addr",    bpo::value<string>(&sgi_if_addr)->default_value("176.16.0.1"),   "IP address of TUN interface for the SGi connection")
     ("spgw.sgi_if_name",    bpo::value<string>(&sgi_if_name)->default_value("srs_spgw_sgi"), "Name of TUN interface for the SGi connection")
     ("spgw.max_paging_queue", bpo::value<uint32_t>(&max_paging_queue)->default_value(100), "Max number of packets in paging queue")
@@ -284,6 +290,9 @@ void parse_args(all_args_t* args, int argc, char* argv[])
   args->mme_args.s1ap_args.paging_timer   = paging_timer;
   args->mme_args.s1ap_args.request_imeisv = request_imeisv;
   args->spgw_args.gtpu_bind_addr          = spgw_bind_addr;
+  args->spgw_args.gtpu_socket_type        = spgw_socket_type;
+  args->spgw_args.gtpu_xdp_if_name        = spgw_xdp_if_name;
+  args->spgw_args.gtpu_xdp_queue_id       = spgw_xdp_queue_id;
   args->spgw_args.sgi_if_addr             = sgi_if_addr;
   args->spgw_args.sgi_if_name             = sgi_if_name;
   args->spgw_args.max_paging_queue        = max_paging_queue;
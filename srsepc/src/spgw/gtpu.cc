@@ -89,7 +89,7 @@ void spgw::gtpu::stop()
   }
   // Clean up S1-U socket
   if (m_s1u_up) {
-    close(m_s1u);
+    m_s1u_socket.reset();
   }
 }
 
@@ -175,28 +175,32 @@ int spgw::gtpu::init_sgi(spgw_args_t* args)
 
 int spgw::gtpu::init_s1u(spgw_args_t* args)
 {
-  // Open S1-U socket
-  m_s1u = socket(AF_INET, SOCK_DGRAM, 0);
-  if (m_s1u == -1) {
-    m_logger.error("Failed to open socket: %s", strerror(errno));
-    return SRSRAN_ERROR_CANT_START;
-  }
-  m_s1u_up = true;
-
-  // Bind the socket
-  m_s1u_addr.sin_family      = AF_INET;
+  m_s1u_addr.sin_family = AF_INET;
   if (inet_pton(m_s1u_addr.sin_family, args->gtpu_bind_addr.c_str(), &m_s1u_addr.sin_addr.s_addr) != 1) {
     m_logger.error("Invalid gtpu_bind_addr: %s", args->gtpu_bind_addr.c_str());
     srsran::console("Invalid gtpu_bind_addr: %s\n", args->gtpu_bind_addr.c_str());
     return SRSRAN_ERROR_CANT_START;
   }
-  m_s1u_addr.sin_port        = htons(GTPU_RX_PORT);
+  m_s1u_addr.sin_port = htons(GTPU_RX_PORT);
 
-  if (bind(m_s1u, (struct sockaddr*)&m_s1u_addr, sizeof(struct sockaddr_in))) {
-    m_logger.error("Failed to bind socket: %s", strerror(errno));
+  // Open and bind the S1-U socket
+  srsran::datagram_socket_args_t socket_args;
+  if (not srsran::string_to_datagram_socket_type(args->gtpu_socket_type, &socket_args.type)) {
+    m_logger.error("Invalid gtpu_socket_type: %s", args->gtpu_socket_type.c_str());
+    srsran::console("Invalid gtpu_socket_type: %s\n", args->gtpu_socket_type.c_str());
     return SRSRAN_ERROR_CANT_START;
   }
-  m_logger.info("S1-U socket = %d", m_s1u);
+  socket_args.bind_addr    = args->gtpu_bind_addr;
+  socket_args.bind_port    = GTPU_RX_PORT;
+  socket_args.xdp_if_name  = args->gtpu_xdp_if_name;
+  socket_args.xdp_queue_id = args->gtpu_xdp_queue_id;
+  m_s1u_socket             = srsran::make_datagram_socket(socket_args, m_logger);
+  if (m_s1u_socket == nullptr) {
+    m_logger.error("Failed to open S1-U socket");
+    return SRSRAN_ERROR_CANT_START;
+  }
+  m_s1u_up = true;
+  m_logger.info("S1-U socket = %d, type = %s", m_s1u_socket->get_fd(), srsran::to_string(m_s1u_socket->get_type()));
   m_logger.info("S1-U IP = %s, Port = %d ", inet_ntoa(m_s1u_addr.sin_addr), ntohs(m_s1u_addr.sin_port));
 
   m_logger.info("Initialized S1-U interface");
@@ -261,6 +265,22 @@ void spgw::gtpu::handle_sgi_pdu(srsran::unique_byte_buffer_t msg)
   }
 }
 
+void spgw::gtpu::read_s1u_pdus()
+{
+  std::array<srsran::unique_byte_buffer_t, srsran::MAX_SDU_BATCH_SIZE> pdus;
+  std::array<sockaddr_in, srsran::MAX_SDU_BATCH_SIZE>                  from;
+  for (srsran::unique_byte_buffer_t& pdu : pdus) {
+    pdu = srsran::make_byte_buffer("spgw::gtpu::read_s1u_pdus");
+    if (pdu == nullptr) {
+      return;
+    }
+  }
+  int n = m_s1u_socket->recv(pdus, from);
+  for (int i = 0; i < n; ++i) {
+    handle_s1u_pdu(pdus[i].get());
+  }
+}
+
 void spgw::gtpu::handle_s1u_pdu(srsran::byte_buffer_t* msg)
 {
   srsran::gtpu_header_t header;
@@ -296,18 +316,14 @@ void spgw::gtpu::send_s1u_pdu(srsran::gtp_fteid_t enb_fteid, srsran::byte_buffer
   m_logger.debug("eNB F-TEID -- eNB IP %s, eNB TEID 0x%x.", inet_ntoa(enb_addr.sin_addr), enb_fteid.teid);
 
   // Write header into packet
-  int n;
   if (!srsran::gtpu_write_header(&header, msg, m_logger)) {
     m_logger.error("Error writing GTP-U header on PDU");
     goto out;
   }
 
   // Send packet to destination
-  n = sendto(m_s1u, msg->msg, msg->N_bytes, 0, (struct sockaddr*)&enb_addr, sizeof(enb_addr));
-  if (n < 0) {
+  if (not m_s1u_socket->send(*msg, enb_addr)) {
     m_logger.error("Error sending packet to eNB");
-  } else if ((unsigned int)n != msg->N_bytes) {
-    m_logger.error("Mis-match between packet bytes and sent bytes: Sent: %d/%d", n, msg->N_bytes);
   }
 
 out:
@@ -103,11 +103,9 @@ void spgw::run_thread()
 {
   // Mark the thread as running
   m_running = true;
-  srsran::unique_byte_buffer_t sgi_msg, s1u_msg, s11_msg;
-  s1u_msg = srsran::make_byte_buffer("spgw::run_thread::s1u");
+  srsran::unique_byte_buffer_t sgi_msg, s11_msg;
   s11_msg = srsran::make_byte_buffer("spgw::run_thread::s11");
 
-  struct sockaddr_in src_addr_in;
   struct sockaddr_un src_addr_un;
   struct iphdr*      ip_pkt;
 
@@ -121,7 +119,6 @@ void spgw::run_thread()
   int    max_fd = std::max(s1u, sgi);
   max_fd        = std::max(max_fd, s11);
   while (m_running) {
-    s1u_msg->clear();
     s11_msg->clear();
 
     FD_ZERO(&set);
@@ -149,9 +146,7 @@ void spgw::run_thread()
       }
       if (FD_ISSET(s1u, &set)) {
         m_logger.debug("Message received at SPGW: S1-U Message");
-        socklen_t addrlen = sizeof(src_addr_in);
-        s1u_msg->N_bytes  = recvfrom(s1u, s1u_msg->msg, buf_len, 0, (struct sockaddr*)&src_addr_in, &addrlen);
-        m_gtpu->handle_s1u_pdu(s1u_msg.get());
+        m_gtpu->read_s1u_pdus();
       }
       if (FD_ISSET(s11, &set)) {
         m_logger.debug("Message received at SPGW: S11 Message");
@@ -61,6 +61,7 @@ public:
   void dl_buffer_state(uint16_t rnti, uint32_t lcid, uint32_t newtx, uint32_t retx);
   void dl_mac_ce(uint16_t rnti, uint32_t ce_lcid) override;
   void dl_cqi_info(uint16_t rnti, uint32_t cc, uint32_t cqi_value);
+  void ul_sinr_info(uint16_t rnti, uint32_t cc, float sinr);
 
   /// Called once per slot in a non-concurrent fashion
   void      slot_indication(slot_point slot_tx) override;
@@ -25,6 +25,7 @@
 #include "sched_nr_interface_utils.h"
 #include "sched_nr_rb.h"
 #include "srsenb/hdr/common/common_enb.h"
+#include "srsenb/hdr/stack/mac/common/link_adaptation.h"
 #include "srsran/adt/optional_array.h"
 
 namespace srsenb {
@@ -102,6 +103,9 @@ struct bwp_params_t {
 
   srsran::optional_vector<bwp_cce_pos_list> common_cce_list;
 
+  /// PUSCH MCS for each UL CQI. The CQI to MCS mapping does not depend on the nof PRBs
+  mcs_lookup_table ul_mcs_table;
+
   bwp_params_t(const cell_config_manager& cell, uint32_t bwp_id, const sched_nr_bwp_cfg_t& bwp_cfg);
 
   prb_interval  coreset_prb_range(uint32_t cs_id) const { return coresets[cs_id].prb_limits; }
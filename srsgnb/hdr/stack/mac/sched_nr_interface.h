@@ -122,6 +122,10 @@ public:
     bool        auto_refill_buffer = false;
     int         fixed_dl_mcs       = 28;
     int         fixed_ul_mcs       = 28;
+    float       target_bler               = 0.05;
+    float       max_delta_ul_snr          = 5;
+    float       adaptive_ul_mcs_step_size = 0.001;
+    float       ul_snr_avg_alpha          = 0.05;
     std::string logger_name        = "MAC-NR";
   };
 
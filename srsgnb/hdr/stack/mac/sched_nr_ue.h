@@ -28,6 +28,7 @@
 #include "sched_ue/ue_cfg_manager.h"
 #include "srsenb/hdr/stack/mac/common/base_ue_buffer_manager.h"
 #include "srsenb/hdr/stack/mac/common/mac_metrics.h"
+#include "srsran/adt/accumulators.h"
 #include "srsran/adt/circular_map.h"
 #include "srsran/adt/move_callback.h"
 #include "srsran/adt/pool/cached_alloc.h"
@@ -99,8 +100,9 @@ public:
   void                       set_cfg(const ue_cfg_manager& ue_cfg);
   const ue_carrier_params_t& cfg() const { return bwp_cfg; }
 
-  int dl_ack_info(uint32_t pid, uint32_t tb_idx, bool ack);
-  int ul_crc_info(uint32_t pid, bool crc);
+  int  dl_ack_info(uint32_t pid, uint32_t tb_idx, bool ack);
+  int  ul_crc_info(uint32_t pid, bool crc);
+  void ul_sinr_info(float sinr);
 
   const uint16_t             rnti;
   const uint32_t             cc;
@@ -108,7 +110,7 @@ public:
 
   // Channel state
   uint32_t dl_cqi = 1;
-  uint32_t ul_cqi = 0;
+  uint32_t ul_cqi = 0; ///< Derived from the PUSCH SINR estimate, corrected by the OLLA offset
 
   harq_entity harq_ent;
 
@@ -123,8 +125,13 @@ public:
 private:
   friend class slot_ue;
 
+  void update_ul_cqi();
+
   srslog::basic_logger& logger;
   ue_carrier_params_t   bwp_cfg;
+
+  srsran::exp_average_fast_start<float> ul_snr_avg;
+  olla_ctrl                             ul_olla;
 };
 
 class ue
@@ -150,11 +157,17 @@ public:
 
   bool has_ca() const
   {
-    return ue_cfg.carriers.size() > 1 and std::count_if(ue_cfg.carriers.begin() + 1,
+    return ue_cfg.carriers.size() > 1 and std::count_if(ue_cfg.carriers.begin(),
                                                         ue_cfg.carriers.end(),
-                                                        [](const ue_cc_cfg_t& cc) { return cc.active; }) > 0;
+                                                        [](const ue_cc_cfg_t& cc) { return cc.active; }) > 1;
+  }
+  /// PCell is the first active carrier of the UE
+  uint32_t pcell_cc() const
+  {
+    auto it = std::find_if(
+        ue_cfg.carriers.begin(), ue_cfg.carriers.end(), [](const ue_cc_cfg_t& cc) { return cc.active; });
+    return it != ue_cfg.carriers.end() ? it->cc : ue_cfg.carriers[0].cc;
   }
-  uint32_t pcell_cc() const { return ue_cfg.carriers[0].cc; }
 
   std::array<std::unique_ptr<ue_carrier>, SCHED_NR_MAX_CARRIERS> carriers;
 
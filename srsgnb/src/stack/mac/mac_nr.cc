@@ -627,6 +627,7 @@ int mac_nr::pusch_info(const srsran_slot_cfg_t& slot_cfg, mac_interface_phy_nr::
     return SRSRAN_ERROR;
   }
 
+  sched->ul_sinr_info(rnti, 0, pusch_info.csi.snr_dB);
   sched->ul_crc_info(rnti, 0, pusch_info.pid, pusch_info.pusch_data.tb[0].crc);
 
   // process only PDUs with CRC=OK
@@ -24,9 +24,11 @@
 #include "srsgnb/hdr/stack/mac/harq_softbuffer.h"
 #include "srsgnb/hdr/stack/mac/sched_nr_bwp.h"
 #include "srsgnb/hdr/stack/mac/sched_nr_worker.h"
+#include "srsran/adt/mpsc_queue.h"
 #include "srsran/common/phy_cfg_nr_default.h"
 #include "srsran/common/string_helpers.h"
 #include "srsran/common/thread_pool.h"
+#include <thread>
 
 namespace srsenb {
 
@@ -101,6 +103,9 @@ public:
   }
 
   /// Enqueue feedback directed at a given UE in a given cell (e.g. ACKs, CQI)
+  /// Note: Called from the PHY worker threads. The handoff to the carrier scheduler is lock-free, unless the queue
+  ///       of the carrier is full, in which case the event is stored in a mutex-protected overflow list. The following
+  ///       events also go to the overflow list until the carrier applies it, so that the push order is kept
   void enqueue_ue_cc_feedback(const char*                                       event_name,
                               uint16_t                                          rnti,
                               uint32_t                                          cc,
@@ -108,12 +113,18 @@ public:
   {
     srsran_assert(rnti != SRSRAN_INVALID_RNTI, "Invalid rnti=0x%x passed to event manager", rnti);
     srsran_assert(cc < carriers.size(), "Invalid cc=%d passed to event manager", cc);
-    std::lock_guard<std::mutex> lock(carriers[cc].event_cc_mutex);
-    carriers[cc].next_slot_ue_events.emplace_back(rnti, cc, event_name, std::move(callback));
+    cc_events& cc_ev = carriers[cc];
+    if (not cc_ev.overflow.load(std::memory_order_acquire) and
+        cc_ev.feedback_queue.try_emplace(rnti, cc, event_name, std::move(callback))) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(cc_ev.overflow_mutex);
+    cc_ev.overflow_events.emplace_back(rnti, cc, event_name, std::move(callback));
+    cc_ev.overflow.store(true, std::memory_order_release);
   }
 
-  /// Process all events that are not specific to a carrier or that are directed at CA-enabled UEs
-  /// Note: non-CA UEs are updated later in get_dl_sched, to leverage parallelism
+  /// Process all events that are not specific to a carrier or that are directed at CA-enabled UEs.
+  /// Events directed at non-CA UEs are handed over to the UE PCell, to be processed later in get_dl_sched.
   void process_common(ue_map_t& ues)
   {
     // Extract pending feedback events
@@ -136,49 +147,69 @@ public:
       auto ue_it = ues.find(ev.rnti);
       if (ue_it == ues.end()) {
         sched_logger.warning("SCHED: \"%s\" called for unknown rnti=0x%x.", ev.event_name, ev.rnti);
-        ev.rnti = SRSRAN_INVALID_RNTI;
       } else if (ue_it->second->has_ca()) {
         // events specific to existing UEs with CA
         ev.callback(*ue_it->second, evlogger);
-        ev.rnti = SRSRAN_INVALID_RNTI;
+      } else {
+        // Note: Each carrier worker only accesses its own list, so no synchronization is required
+        carriers[ue_it->second->pcell_cc()].current_slot_ue_events.push_back(std::move(ev));
       }
     }
   }
 
-  /// Process events synchronized during slot_indication() that are directed at non CA-enabled UEs
+  /// Process events synchronized during slot_indication() that are directed at non CA-enabled UEs, and the pending
+  /// feedback of the carrier.
+  /// Note: Called concurrently for different carriers
   void process_cc_events(ue_map_t& ues, uint32_t cc)
   {
-    logger evlogger(cc, sched_logger);
-
-    {
-      carriers[cc].current_slot_ue_events.clear();
-      std::lock_guard<std::mutex> lock(carriers[cc].event_cc_mutex);
-      carriers[cc].current_slot_ue_events.swap(carriers[cc].next_slot_ue_events);
-    }
+    logger     evlogger(cc, sched_logger);
+    cc_events& cc_ev = carriers[cc];
 
-    for (ue_event_t& ev : current_slot_ue_events) {
-      if (ev.rnti == SRSRAN_INVALID_RNTI) {
-        // events already processed
-        continue;
-      }
+    for (ue_event_t& ev : cc_ev.current_slot_ue_events) {
       auto ue_it = ues.find(ev.rnti);
       if (ue_it == ues.end()) {
         sched_logger.warning("SCHED: \"%s\" called for unknown rnti=0x%x.", ev.event_name, ev.rnti);
-        ev.rnti = SRSRAN_INVALID_RNTI;
-      } else if (not ue_it->second->has_ca() and ue_it->second->carriers[cc] != nullptr) {
+      } else {
         ev.callback(*ue_it->second, evlogger);
-        ev.rnti = SRSRAN_INVALID_RNTI;
       }
     }
+    cc_ev.current_slot_ue_events.clear();
 
-    for (ue_cc_event_t& ev : carriers[cc].current_slot_ue_events) {
-      auto ue_it = ues.find(ev.rnti);
-      if (ue_it != ues.end() and ue_it->second->carriers[cc] != nullptr) {
-        ev.callback(*ue_it->second->carriers[cc], evlogger);
+    ue_cc_event_t ev;
+    if (not cc_ev.overflow.load(std::memory_order_acquire)) {
+      while (cc_ev.feedback_queue.try_pop(ev)) {
+        process_ue_cc_event(ues, ev, evlogger);
+      }
+      return;
+    }
+
+    // The events in the overflow list were pushed after the ones in the queue, or concurrently with them. So, the
+    // queue is fully drained first, waiting for the producers that are still writing their slot
+    cc_ev.current_slot_overflow_events.clear();
+    {
+      std::lock_guard<std::mutex> lock(cc_ev.overflow_mutex);
+      cc_ev.overflow_events.swap(cc_ev.current_slot_overflow_events);
+    }
+    while (not cc_ev.feedback_queue.empty()) {
+      if (cc_ev.feedback_queue.try_pop(ev)) {
+        process_ue_cc_event(ues, ev, evlogger);
       } else {
-        sched_logger.warning("SCHED: \"%s\" called for unknown rnti=0x%x,cc=%d.", ev.event_name, ev.rnti, ev.cc);
+        std::this_thread::yield();
       }
     }
+    sched_logger.warning("SCHED: %zd feedback events of cc=%d exceeded the capacity of the feedback queue (%zd)",
+                         cc_ev.current_slot_overflow_events.size(),
+                         cc,
+                         cc_ev.feedback_queue.max_size());
+    for (ue_cc_event_t& ovfl_ev : cc_ev.current_slot_overflow_events) {
+      process_ue_cc_event(ues, ovfl_ev, evlogger);
+    }
+
+    // The producers go back to the queue once there are no overflow events left to apply
+    std::lock_guard<std::mutex> lock(cc_ev.overflow_mutex);
+    if (cc_ev.overflow_events.empty()) {
+      cc_ev.overflow.store(false, std::memory_order_relaxed);
+    }
   }
 
 private:
@@ -200,10 +231,11 @@ private:
     }
   };
   struct ue_cc_event_t {
-    uint16_t                                          rnti;
-    uint32_t                                          cc;
-    const char*                                       event_name;
+    uint16_t                                          rnti       = SRSRAN_INVALID_RNTI;
+    uint32_t                                          cc         = 0;
+    const char*                                       event_name = nullptr;
     srsran::move_callback<void(ue_carrier&, logger&)> callback;
+    ue_cc_event_t() = default;
     ue_cc_event_t(uint16_t                                          rnti_,
                   uint32_t                                          cc_,
                   const char*                                       event_name_,
@@ -213,14 +245,30 @@ private:
     }
   };
 
+  void process_ue_cc_event(ue_map_t& ues, ue_cc_event_t& ev, logger& evlogger)
+  {
+    auto ue_it = ues.find(ev.rnti);
+    if (ue_it != ues.end() and ue_it->second->carriers[ev.cc] != nullptr) {
+      ev.callback(*ue_it->second->carriers[ev.cc], evlogger);
+    } else {
+      sched_logger.warning("SCHED: \"%s\" called for unknown rnti=0x%x,cc=%d.", ev.event_name, ev.rnti, ev.cc);
+    }
+  }
+
+  /// Maximum number of pending feedback events per carrier that can be handed over without locking
+  static const size_t MAX_CC_FEEDBACK_EVENTS = 512;
+
   srslog::basic_logger& sched_logger;
 
   std::mutex             event_mutex;
   std::deque<event_t>    next_slot_events, current_slot_events;
   std::deque<ue_event_t> next_slot_ue_events, current_slot_ue_events;
   struct cc_events {
-    std::mutex                   event_cc_mutex;
-    srsran::deque<ue_cc_event_t> next_slot_ue_events, current_slot_ue_events;
+    srsran::static_mpsc_queue<ue_cc_event_t, MAX_CC_FEEDBACK_EVENTS> feedback_queue;
+    std::atomic<bool>                                                overflow{false};
+    std::mutex                                                       overflow_mutex;
+    srsran::deque<ue_cc_event_t> overflow_events, current_slot_overflow_events;
+    srsran::deque<ue_event_t>    current_slot_ue_events;
   };
   std::vector<cc_events> carriers;
 };
@@ -393,6 +441,7 @@ void sched_nr::slot_indication(slot_point slot_tx)
 }
 
 /// Generate {pdcch_slot,cc} scheduling decision
+/// Note: Called concurrently for different carriers by the PHY workers, after slot_indication() of the same slot
 sched_nr::dl_res_t* sched_nr::get_dl_sched(slot_point pdsch_tti, uint32_t cc)
 {
   srsran_assert(pdsch_tti == current_slot_tx, "Unexpected pdsch_tti slot received");
@@ -401,8 +450,9 @@ sched_nr::dl_res_t* sched_nr::get_dl_sched(slot_point pdsch_tti, uint32_t cc)
   pending_events->process_cc_events(ue_db, cc);
 
   // prepare non-CA UEs internal state for new slot
+  // Note: Each non-CA UE is only updated by the worker of its PCell, so that UEs are never shared between workers
   for (auto& u : ue_db) {
-    if (not u.second->has_ca() and u.second->carriers[cc] != nullptr) {
+    if (not u.second->has_ca() and u.second->pcell_cc() == cc) {
       u.second->new_slot(current_slot_tx);
     }
   }
@@ -517,6 +567,15 @@ void sched_nr::dl_cqi_info(uint16_t rnti, uint32_t cc, uint32_t cqi_value)
   pending_events->enqueue_ue_cc_feedback("dl_cqi_info", rnti, cc, callback);
 }
 
+void sched_nr::ul_sinr_info(uint16_t rnti, uint32_t cc, float sinr)
+{
+  auto callback = [sinr](ue_carrier& ue_cc, event_manager::logger& ev_logger) {
+    ue_cc.ul_sinr_info(sinr);
+    ev_logger.push("0x{:x}: ul_sinr_info(sinr={:.1f}, ul_cqi={})", ue_cc.rnti, sinr, ue_cc.ul_cqi);
+  };
+  pending_events->enqueue_ue_cc_feedback("ul_sinr_info", rnti, cc, callback);
+}
+
 #define VERIFY_INPUT(cond, msg, ...)                                                                                   \
   do {                                                                                                                 \
     if (not(cond)) {                                                                                                   \
@@ -106,6 +106,17 @@ bwp_params_t::bwp_params_t(const cell_config_manager& cell, uint32_t bwp_id_, co
   }
   srsran_assert(not pusch_ra_list.empty(), "Time-Domain Resource Allocation not valid");
 
+  static const uint32_t nof_cqis = 16;
+  ul_mcs_table.init(nof_cqis, 1, [this](uint32_t cqi, uint32_t nof_prb) {
+    int mcs = srsran_ra_nr_cqi_to_mcs(cqi,
+                                      SRSRAN_CSI_CQI_TABLE_1,
+                                      cfg.pusch.mcs_table,
+                                      srsran_dci_format_nr_0_0,
+                                      srsran_search_space_type_ue,
+                                      srsran_rnti_type_c);
+    return mcs_lookup_table::entry_t{std::max(mcs, 0), -1};
+  });
+
   for (uint32_t sl = 0; sl < SRSRAN_NOF_SF_X_FRAME; ++sl) {
     for (uint32_t agg_idx = 0; agg_idx < MAX_NOF_AGGR_LEVELS; ++agg_idx) {
       rar_cce_list[sl][agg_idx].resize(SRSRAN_SEARCH_SPACE_MAX_NOF_CANDIDATES_NR);
@@ -175,10 +186,7 @@ cell_config_manager::cell_config_manager(uint32_t                   cc_,
   srsran_assert(not bwps.empty(), "No BWPs were configured");
 }
 
-sched_params_t::sched_params_t(const sched_args_t& sched_cfg_) : sched_cfg(sched_cfg_)
-{
-  srsran_assert(sched_cfg.fixed_ul_mcs >= 0, "Dynamic DL MCS not supported");
-}
+sched_params_t::sched_params_t(const sched_args_t& sched_cfg_) : sched_cfg(sched_cfg_) {}
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
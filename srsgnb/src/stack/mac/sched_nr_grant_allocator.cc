@@ -459,7 +459,10 @@ alloc_result bwp_slot_allocator::alloc_pusch(slot_ue& ue, const prb_grant& ul_gr
   pusch_t& pusch = bwp_pusch_slot.puschs.alloc_pusch_unchecked(ul_grant, pdcch.dci);
 
   if (ue.h_ul->empty()) {
-    int  mcs     = ue->fixed_pusch_mcs();
+    int mcs = ue->fixed_pusch_mcs();
+    if (mcs < 0) {
+      mcs = cfg.ul_mcs_table.get(ue.ul_cqi(), 1).mcs;
+    }
     bool success = ue.h_ul->new_tx(ue.pusch_slot, ul_grant, mcs, ue->ue_cfg().maxharq_tx, pdcch.dci);
     srsran_assert(success, "Failed to allocate UL HARQ");
   } else {
@@ -122,7 +122,11 @@ ue_carrier::ue_carrier(uint16_t                              rnti_,
   cell_params(cell_params_),
   pdu_builder(pdu_builder_),
   common_ctxt(ctxt),
-  harq_ent(rnti_, cell_params_.nof_prb(), SCHED_NR_MAX_HARQ, cell_params_.bwps[0].logger)
+  harq_ent(rnti_, cell_params_.nof_prb(), SCHED_NR_MAX_HARQ, cell_params_.bwps[0].logger),
+  ul_snr_avg(cell_params_.sched_args.ul_snr_avg_alpha),
+  ul_olla(cell_params_.sched_args.target_bler,
+          cell_params_.sched_args.adaptive_ul_mcs_step_size,
+          cell_params_.sched_args.max_delta_ul_snr)
 {}
 
 void ue_carrier::set_cfg(const ue_cfg_manager& ue_cfg)
@@ -148,13 +152,42 @@ int ue_carrier::dl_ack_info(uint32_t pid, uint32_t tb_idx, bool ack)
 
 int ue_carrier::ul_crc_info(uint32_t pid, bool crc)
 {
+  // Note: The HARQ MCS has to be read before the HARQ is released by the CRC
+  const ul_harq_proc& h     = harq_ent.ul_harq(pid);
+  bool                adapt = not h.empty() and bwp_cfg.fixed_pusch_mcs() < 0 and cell_params.sched_args.target_bler > 0;
+  int                 mcs   = h.mcs();
+
   int ret = harq_ent.ul_crc_info(pid, crc);
   if (ret < 0) {
     logger.warning("SCHED: rnti=0x%x,cc=%d received CRC for empty pid=%d", rnti, cc, pid);
+    return ret;
+  }
+
+  // Adapt UL MCS based on BLER
+  if (adapt) {
+    const mcs_lookup_table& mcs_table = cell_params.bwps[0].ul_mcs_table;
+    ul_olla.update(crc, mcs, mcs_table.get(mcs_table.nof_levels() - 1, 1).mcs);
+    update_ul_cqi();
+    logger.info("SCHED: UL adaptive link: rnti=0x%x, snr_estim=%.2f, last_mcs=%d, snr_offset=%f",
+                rnti,
+                ul_snr_avg.value(),
+                mcs,
+                ul_olla.offset());
   }
   return ret;
 }
 
+void ue_carrier::ul_sinr_info(float sinr)
+{
+  ul_snr_avg.push(sinr);
+  update_ul_cqi();
+}
+
+void ue_carrier::update_ul_cqi()
+{
+  ul_cqi = srsran_cqi_from_snr(ul_snr_avg.value() + ul_olla.offset());
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /// Generate basic UE config at the point of RACH
@@ -28,9 +28,9 @@ namespace sched_nr_impl {
 
 ue_cfg_manager::ue_cfg_manager(uint32_t enb_cc_idx) : carriers(1)
 {
-  carriers[enb_cc_idx].active = true;
-  carriers[enb_cc_idx].cc     = enb_cc_idx;
-  ue_bearers[0].direction     = mac_lc_ch_cfg_t::BOTH;
+  carriers[0].active      = true;
+  carriers[0].cc          = enb_cc_idx;
+  ue_bearers[0].direction = mac_lc_ch_cfg_t::BOTH;
 }
 
 ue_cfg_manager::ue_cfg_manager(const sched_nr_ue_cfg_t& cfg_req) : ue_cfg_manager()
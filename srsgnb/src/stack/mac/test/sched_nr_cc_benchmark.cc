@@ -0,0 +1,156 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "sched_nr_cfg_generators.h"
+#include "sched_nr_sim_ue.h"
+#include "srsran/adt/accumulators.h"
+#include "srsran/common/test_common.h"
+#include <chrono>
+
+namespace srsenb {
+
+struct run_params {
+  uint32_t nof_carriers;
+  uint32_t nof_workers;
+  uint32_t nof_ues;
+  uint32_t nof_slots;
+};
+
+struct run_result {
+  double avg_latency_usec = 0;
+  double max_latency_usec = 0;
+};
+
+/// Tester that measures the time taken until the last carrier of each slot is scheduled
+class sched_nr_cc_bench : public sched_nr_base_test_bench
+{
+public:
+  using sched_nr_base_test_bench::sched_nr_base_test_bench;
+
+  void process_slot_result(const sim_nr_enb_ctxt_t& slot_ctxt, srsran::const_span<cc_result_t> cc_list) override
+  {
+    auto slot_latency =
+        std::max_element(cc_list.begin(), cc_list.end(), [](const cc_result_t& lhs, const cc_result_t& rhs) {
+          return lhs.cc_latency_ns < rhs.cc_latency_ns;
+        })->cc_latency_ns;
+    // Skip warm-up period, during which UEs are created and pools are populated
+    if (nof_slots++ >= nof_warmup_slots) {
+      latency_usec.push(slot_latency.count() / 1000.0);
+      max_latency_usec = std::max(max_latency_usec, slot_latency.count() / 1000.0);
+    }
+    for (auto& cc_out : cc_list) {
+      pdsch_count += cc_out.res.dl->phy.pdcch_dl.size();
+    }
+  }
+
+  const static uint32_t nof_warmup_slots = 20;
+
+  uint32_t                        nof_slots = 0;
+  srsran::rolling_average<double> latency_usec;
+  double                          max_latency_usec = 0;
+  uint32_t                        pdsch_count      = 0;
+};
+
+run_result run_sched_nr_cc_bench(const run_params& params)
+{
+  sched_nr_interface::sched_args_t cfg;
+  cfg.auto_refill_buffer = true;
+
+  std::vector<sched_nr_cell_cfg_t> cells_cfg = get_default_cells_cfg(params.nof_carriers);
+
+  std::string test_name =
+      fmt::format("Bench carriers={}, workers={}, ues={}", params.nof_carriers, params.nof_workers, params.nof_ues);
+  sched_nr_cc_bench tester(cfg, cells_cfg, test_name, params.nof_workers);
+
+  // UEs are evenly distributed across carriers, without CA
+  for (uint32_t i = 0; i < params.nof_ues; ++i) {
+    sched_nr_interface::ue_cfg_t uecfg = get_default_ue_cfg(params.nof_carriers);
+    for (uint32_t cc = 0; cc < params.nof_carriers; ++cc) {
+      uecfg.carriers[cc].active = cc == i % params.nof_carriers;
+    }
+    uecfg.lc_ch_to_add.emplace_back();
+    uecfg.lc_ch_to_add.back().lcid          = 1;
+    uecfg.lc_ch_to_add.back().cfg.direction = mac_lc_ch_cfg_t::BOTH;
+    tester.user_cfg(0x4601 + i, uecfg);
+  }
+
+  for (uint32_t nof_slots = 0; nof_slots < params.nof_slots + sched_nr_cc_bench::nof_warmup_slots; ++nof_slots) {
+    slot_point slot_tx = slot_point{0, nof_slots % 10240} + TX_ENB_DELAY;
+    tester.run_slot(slot_tx);
+  }
+  tester.stop();
+  TESTASSERT(tester.pdsch_count > 0);
+
+  run_result result;
+  result.avg_latency_usec = tester.latency_usec.value();
+  result.max_latency_usec = tester.max_latency_usec;
+  return result;
+}
+
+int run_benchmark(uint32_t nof_slots)
+{
+  // Note: the load per carrier is kept constant, so that the slot latency only depends on the carriers per worker
+  std::vector<uint32_t> nof_ues_per_carrier_list = {1, 4};
+
+  fmt::print("{:>8} {:>8} {:>8} | {:>14} {:>14}\n", "carriers", "workers", "ues", "avg slot (us)", "max slot (us)");
+  for (uint32_t nof_ues_per_carrier : nof_ues_per_carrier_list) {
+    for (uint32_t nof_carriers = 1; nof_carriers <= SCHED_NR_MAX_CARRIERS; ++nof_carriers) {
+      uint32_t nof_ues = nof_ues_per_carrier * nof_carriers;
+      // Serialized scheduling of all carriers vs one worker per carrier
+      std::vector<uint32_t> nof_workers_list = {1};
+      if (nof_carriers > 1) {
+        nof_workers_list.push_back(nof_carriers);
+      }
+      for (uint32_t nof_workers : nof_workers_list) {
+        run_params params{nof_carriers, nof_workers, nof_ues, nof_slots};
+        run_result result = run_sched_nr_cc_bench(params);
+        fmt::print("{:>8} {:>8} {:>8} | {:>14.2f} {:>14.2f}\n",
+                   nof_carriers,
+                   nof_workers,
+                   nof_ues,
+                   result.avg_latency_usec,
+                   result.max_latency_usec);
+      }
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsenb
+
+int main(int argc, char* argv[])
+{
+  auto& test_logger = srslog::fetch_basic_logger("TEST");
+  test_logger.set_level(srslog::basic_levels::warning);
+  auto& mac_nr_logger = srslog::fetch_basic_logger("MAC-NR");
+  mac_nr_logger.set_level(srslog::basic_levels::warning);
+
+  // Start the log backend.
+  srslog::init();
+
+  if (argc == 1 or strcmp(argv[1], "test") == 0) {
+    TESTASSERT(srsenb::run_benchmark(100) == SRSRAN_SUCCESS);
+  } else if (strcmp(argv[1], "benchmark") == 0) {
+    TESTASSERT(srsenb::run_benchmark(5000) == SRSRAN_SUCCESS);
+  }
+
+  return 0;
+}
@@ -0,0 +1,380 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Scheduler-only benchmark of the NR MAC scheduler. NR counterpart of srsenb/test/mac/sched_replay_benchmark.cc,
+ * which replays the same traces through the LTE scheduler.
+ *
+ * Usage: sched_nr_replay_benchmark [test|benchmark] [trace_file]
+ */
+
+#include "sched_nr_cfg_generators.h"
+#include "srsenb/test/mac/sched_replay_trace.h"
+#include "srsgnb/hdr/stack/mac/sched_nr.h"
+#include "srsran/common/test_common.h"
+#include "srsran/phy/phch/prach.h"
+#include <chrono>
+
+namespace srsenb {
+
+class sched_nr_replayer
+{
+public:
+  explicit sched_nr_replayer(const sched_replay_trace& trace_) : trace(trace_)
+  {
+    // The UL MCS follows the SNR reports. The DL MCS stays fixed
+    sched_nr_interface::sched_args_t sched_args;
+    sched_args.fixed_ul_mcs = -1;
+    srsran::phy_cfg_nr_default_t     phy_cfg{srsran::phy_cfg_nr_default_t::reference_cfg_t{}};
+    std::vector<sched_nr_cell_cfg_t> cells_cfg = get_default_cells_cfg(trace.nof_carriers, phy_cfg);
+    TESTASSERT(sched_obj.config(sched_args, cells_cfg) == SRSRAN_SUCCESS);
+    prach_cfg = phy_cfg.prach;
+    tdd       = phy_cfg.duplex.mode == SRSRAN_DUPLEX_MODE_TDD;
+
+    ues.resize(trace.nof_ues);
+    for (uint32_t i = 0; i < ues.size(); ++i) {
+      ues[i].rnti = 0x4601 + i;
+      ues[i].dl_ndi.fill(-1);
+    }
+  }
+  ~sched_nr_replayer() { sched_obj.stop(); }
+
+  int run(sched_replay_stats& stats)
+  {
+    stats = {};
+    stats.latency_ns.reserve(trace.nof_ttis);
+    size_t ev_idx = 0;
+    for (uint32_t count = 0; count < trace.nof_ttis; ++count) {
+      slot_point slot_tx = slot_point{0, count % 10240} + TX_ENB_DELAY;
+
+      auto tp = std::chrono::steady_clock::now();
+      for (; ev_idx < trace.events.size() and trace.events[ev_idx].tti == count; ++ev_idx) {
+        handle_event(trace.events[ev_idx]);
+      }
+      handle_pending_rachs(slot_tx);
+      handle_feedback(count, stats);
+      sched_obj.slot_indication(slot_tx);
+      std::vector<const sched_nr_interface::dl_res_t*> dl_res(trace.nof_carriers);
+      std::vector<const sched_nr_interface::ul_res_t*> ul_res(trace.nof_carriers);
+      for (uint32_t cc = 0; cc < trace.nof_carriers; ++cc) {
+        dl_res[cc] = sched_obj.get_dl_sched(slot_tx, cc);
+        ul_res[cc] = sched_obj.get_ul_sched(slot_tx, cc);
+        TESTASSERT(dl_res[cc] != nullptr and ul_res[cc] != nullptr);
+      }
+      auto tp2 = std::chrono::steady_clock::now();
+      stats.latency_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(tp2 - tp).count());
+
+      for (uint32_t cc = 0; cc < trace.nof_carriers; ++cc) {
+        process_results(count, slot_tx, cc, *dl_res[cc], *ul_res[cc], stats);
+      }
+    }
+
+    stats.nof_ues = ues.size();
+    for (const ue_ctxt& u : ues) {
+      stats.nof_connected_ues += u.state == ue_state::connected ? 1 : 0;
+    }
+    return SRSRAN_SUCCESS;
+  }
+
+private:
+  enum class ue_state { idle, rach, msg3, msg4, connected };
+
+  struct ue_ctxt {
+    uint16_t                     rnti  = SRSRAN_INVALID_RNTI;
+    ue_state                     state = ue_state::idle;
+    sched_nr_interface::ue_cfg_t final_cfg;
+    uint32_t                     dl_buffer = 0, ul_buffer = 0;
+    /// DL buffer changed since the last report to the scheduler
+    bool dl_buffer_changed = false;
+    /// HARQ feedback outcomes of the current slot
+    bool dl_ack = true, ul_crc = true;
+    /// Last NDI of each DL HARQ process, to detect new transmissions
+    std::array<int, SCHED_NR_MAX_HARQ> dl_ndi;
+  };
+
+  struct harq_fb_t {
+    uint32_t ue_idx;
+    uint32_t cc;
+    uint32_t pid;
+    uint32_t nof_bytes;
+    bool     is_ra; ///< Msg3 or Msg4
+  };
+
+  static const uint32_t FB_RING_SIZE = 32;
+  static const uint32_t DRB_LCID     = 4;
+  static const uint32_t DRB_LCG      = 1;
+
+  void handle_event(const sched_trace_event& ev)
+  {
+    using type_t = sched_trace_event::type_t;
+    ue_ctxt& u   = ues[ev.ue_idx];
+    if (ev.type == type_t::rach) {
+      if (u.state == ue_state::idle) {
+        u.final_cfg                = get_default_ue_cfg(1);
+        u.final_cfg.carriers[0].cc = ev.cc;
+        u.final_cfg.lc_ch_to_add.emplace_back();
+        u.final_cfg.lc_ch_to_add.back().lcid          = DRB_LCID;
+        u.final_cfg.lc_ch_to_add.back().cfg.direction = mac_lc_ch_cfg_t::BOTH;
+        u.final_cfg.lc_ch_to_add.back().cfg.group     = DRB_LCG;
+        u.state                                       = ue_state::rach;
+        pending_rachs.push_back(ev.ue_idx);
+      }
+      return;
+    }
+    if (u.state != ue_state::connected) {
+      // Events before the UE is connected are ignored
+      return;
+    }
+    switch (ev.type) {
+      case type_t::dl_buffer:
+        u.dl_buffer += ev.value;
+        u.dl_buffer_changed = true;
+        break;
+      case type_t::ul_bsr:
+        u.ul_buffer += ev.value;
+        sched_obj.ul_bsr(u.rnti, DRB_LCG, u.ul_buffer);
+        break;
+      case type_t::dl_cqi:
+        sched_obj.dl_cqi_info(u.rnti, ev.cc, ev.value);
+        break;
+      case type_t::ul_snr:
+        sched_obj.ul_sinr_info(u.rnti, ev.cc, ev.value);
+        break;
+      case type_t::dl_ack:
+        u.dl_ack = ev.value > 0;
+        break;
+      case type_t::ul_crc:
+        u.ul_crc = ev.value > 0;
+        break;
+      default:
+        break;
+    }
+  }
+
+  void handle_pending_rachs(slot_point slot_tx)
+  {
+    slot_point slot_rx       = slot_tx - TX_ENB_DELAY;
+    bool       is_prach_slot = tdd ? srsran_prach_nr_tti_opportunity_fr1_unpaired(prach_cfg.config_idx, slot_rx.to_uint())
+                                   : srsran_prach_nr_tti_opportunity_fr1_paired(prach_cfg.config_idx, slot_rx.to_uint());
+    if (pending_rachs.empty() or not is_prach_slot) {
+      return;
+    }
+    // The PRACHs that do not fit in the RAR are postponed to the next PRACH opportunity
+    std::vector<uint32_t> nof_rachs(trace.nof_carriers, 0);
+    auto                  rach_it = pending_rachs.begin();
+    while (rach_it != pending_rachs.end()) {
+      ue_ctxt& u     = ues[*rach_it];
+      uint32_t pcell = u.final_cfg.carriers[0].cc;
+      if (nof_rachs[pcell] >= sched_nr_interface::MAX_GRANTS) {
+        ++rach_it;
+        continue;
+      }
+      sched_nr_interface::rar_info_t rach_info{};
+      rach_info.cc           = pcell;
+      rach_info.temp_crnti   = u.rnti;
+      rach_info.prach_slot   = slot_rx;
+      rach_info.preamble_idx = nof_rachs[pcell]++;
+      rach_info.msg3_size    = 7;
+      TESTASSERT(sched_obj.dl_rach_info(rach_info) == SRSRAN_SUCCESS);
+      u.state = ue_state::msg3;
+      rach_it = pending_rachs.erase(rach_it);
+    }
+  }
+
+  void handle_feedback(uint32_t count, sched_replay_stats& stats)
+  {
+    std::vector<harq_fb_t>& dl_fbs = dl_fb_ring[count % FB_RING_SIZE];
+    for (const harq_fb_t& fb : dl_fbs) {
+      ue_ctxt& u   = ues[fb.ue_idx];
+      bool     ack = fb.is_ra or u.dl_ack;
+      sched_obj.dl_ack_info(u.rnti, fb.cc, fb.pid, 0, ack);
+      stats.nof_dl_harq_fb++;
+      stats.nof_dl_nacks += ack ? 0 : 1;
+      stats.dl_bytes += ack ? fb.nof_bytes : 0;
+      if (fb.is_ra and u.state == ue_state::msg4) {
+        // Msg4 was received. Complete the UE configuration
+        sched_obj.ue_cfg(u.rnti, u.final_cfg);
+        u.state = ue_state::connected;
+      }
+    }
+    dl_fbs.clear();
+
+    std::vector<harq_fb_t>& ul_fbs = ul_fb_ring[count % FB_RING_SIZE];
+    for (const harq_fb_t& fb : ul_fbs) {
+      ue_ctxt& u   = ues[fb.ue_idx];
+      bool     crc = fb.is_ra or u.ul_crc;
+      sched_obj.ul_crc_info(u.rnti, fb.cc, fb.pid, crc);
+      stats.nof_ul_harq_fb++;
+      stats.nof_ul_crc_kos += crc ? 0 : 1;
+      if (fb.is_ra and u.state == ue_state::msg3) {
+        // Msg3 was received. Schedule the RRC Setup
+        sched_obj.dl_buffer_state(u.rnti, 0, 150, 0);
+        u.state = ue_state::msg4;
+      } else if (crc and u.state == ue_state::connected) {
+        // The PUSCH carries a BSR with the remaining UL buffer
+        stats.ul_bytes += fb.nof_bytes;
+        u.ul_buffer -= std::min(u.ul_buffer, fb.nof_bytes);
+        sched_obj.ul_bsr(u.rnti, DRB_LCG, u.ul_buffer);
+      }
+    }
+    ul_fbs.clear();
+
+    for (ue_ctxt& u : ues) {
+      // The RLC reports the DL buffer after new arrivals and after building PDUs
+      if (u.dl_buffer_changed) {
+        sched_obj.dl_buffer_state(u.rnti, DRB_LCID, u.dl_buffer, 0);
+        u.dl_buffer_changed = false;
+      }
+      u.dl_ack = true;
+      u.ul_crc = true;
+    }
+  }
+
+  ue_ctxt* find_ue(uint16_t rnti)
+  {
+    uint32_t ue_idx = rnti - 0x4601;
+    return rnti >= 0x4601 and ue_idx < ues.size() ? &ues[ue_idx] : nullptr;
+  }
+
+  void process_results(uint32_t                            count,
+                       slot_point                          slot_tx,
+                       uint32_t                            cc,
+                       const sched_nr_interface::dl_res_t& dl_res,
+                       const sched_nr_interface::ul_res_t& ul_res,
+                       sched_replay_stats&                 stats)
+  {
+    stats.nof_decisions += dl_res.phy.pdcch_dl.size() + dl_res.phy.pdcch_ul.size();
+
+    for (const auto& pdcch : dl_res.phy.pdcch_dl) {
+      ue_ctxt* u = find_ue(pdcch.dci.ctx.rnti);
+      if (u == nullptr) {
+        continue;
+      }
+      uint32_t nof_bytes = 0;
+      for (const auto& pdsch : dl_res.phy.pdsch) {
+        if (pdsch.sch.grant.rnti == pdcch.dci.ctx.rnti) {
+          nof_bytes = pdsch.sch.grant.tb[0].tbs / 8;
+        }
+      }
+      bool is_newtx = u->dl_ndi[pdcch.dci.pid] != (int)pdcch.dci.ndi;
+      if (is_newtx) {
+        u->dl_ndi[pdcch.dci.pid] = (int)pdcch.dci.ndi;
+        if (u->state == ue_state::connected) {
+          u->dl_buffer -= std::min(u->dl_buffer, nof_bytes);
+          u->dl_buffer_changed = true;
+        }
+      }
+      const srsran::phy_cfg_nr_t& phy_cfg = u->final_cfg.phy_cfg;
+      uint32_t k1 = phy_cfg.harq_ack.dl_data_to_ul_ack[slot_tx.slot_idx() % phy_cfg.harq_ack.nof_dl_data_to_ul_ack];
+      harq_fb_t fb{(uint32_t)(u - ues.data()), cc, pdcch.dci.pid, nof_bytes, u->state == ue_state::msg4};
+      dl_fb_ring[(count + k1) % FB_RING_SIZE].push_back(fb);
+    }
+
+    // The CRC of the PUSCH is reported in the next slot
+    for (const auto& pusch : ul_res.pusch) {
+      ue_ctxt* u = find_ue(pusch.sch.grant.rnti);
+      if (u == nullptr) {
+        continue;
+      }
+      harq_fb_t fb{
+          (uint32_t)(u - ues.data()), cc, pusch.pid, pusch.sch.grant.tb[0].tbs / 8, u->state == ue_state::msg3};
+      ul_fb_ring[(count + 1) % FB_RING_SIZE].push_back(fb);
+    }
+  }
+
+  const sched_replay_trace& trace;
+  sched_nr                  sched_obj;
+
+  srsran_prach_cfg_t        prach_cfg = {};
+  bool                      tdd       = false;
+
+  std::vector<ue_ctxt>                             ues;
+  std::vector<uint32_t>                            pending_rachs;
+  std::array<std::vector<harq_fb_t>, FB_RING_SIZE> dl_fb_ring, ul_fb_ring;
+};
+
+int run_replay(const char* name, const sched_replay_trace& trace, sched_replay_stats& stats)
+{
+  sched_nr_replayer replayer(trace);
+  TESTASSERT(replayer.run(stats) == SRSRAN_SUCCESS);
+  stats.print(name);
+  return SRSRAN_SUCCESS;
+}
+
+int run_test()
+{
+  sched_trace_gen_params params;
+  params.nof_ues      = 4;
+  params.nof_carriers = 2;
+  params.nof_ttis     = 2000;
+
+  sched_replay_stats stats;
+  TESTASSERT(run_replay("NR replay test", generate_sched_trace(params), stats) == SRSRAN_SUCCESS);
+  TESTASSERT(stats.nof_connected_ues == params.nof_ues);
+  TESTASSERT(stats.dl_bytes > 0 and stats.ul_bytes > 0);
+  TESTASSERT(stats.nof_dl_nacks > 0 and stats.nof_ul_crc_kos > 0);
+  return SRSRAN_SUCCESS;
+}
+
+int run_benchmark(const char* trace_file)
+{
+  sched_replay_stats stats;
+  if (trace_file != nullptr) {
+    sched_replay_trace trace;
+    TESTASSERT(load_sched_trace(trace_file, trace));
+    return run_replay(trace_file, trace, stats);
+  }
+
+  sched_trace_gen_params params;
+  params.nof_ttis = 20000;
+  for (uint32_t nof_carriers : {1, 2}) {
+    for (uint32_t nof_ues : {8, 32}) {
+      params.nof_carriers = nof_carriers;
+      params.nof_ues      = nof_ues * nof_carriers;
+      std::string name    = fmt::format("NR carriers={}, ues={}", params.nof_carriers, params.nof_ues);
+      TESTASSERT(run_replay(name.c_str(), generate_sched_trace(params), stats) == SRSRAN_SUCCESS);
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsenb
+
+int main(int argc, char* argv[])
+{
+  auto& mac_nr_logger = srslog::fetch_basic_logger("MAC-NR");
+  mac_nr_logger.set_level(srslog::basic_levels::warning);
+
+  // Start the log backend.
+  srslog::init();
+
+  if (argc == 1 or strcmp(argv[1], "test") == 0) {
+    TESTASSERT(srsenb::run_test() == SRSRAN_SUCCESS);
+  } else if (strcmp(argv[1], "benchmark") == 0) {
+    TESTASSERT(srsenb::run_benchmark(argc > 2 ? argv[2] : nullptr) == SRSRAN_SUCCESS);
+  } else {
+    printf("Usage: %s [test|benchmark] [trace_file]\n", argv[0]);
+    return SRSRAN_ERROR;
+  }
+
+  srslog::flush();
+  return SRSRAN_SUCCESS;
+}
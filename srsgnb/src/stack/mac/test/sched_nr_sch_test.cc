@@ -22,6 +22,7 @@
 #include "sched_nr_cfg_generators.h"
 #include "srsgnb/hdr/stack/mac/sched_nr_interface_utils.h"
 #include "srsgnb/hdr/stack/mac/sched_nr_sch.h"
+#include "srsgnb/hdr/stack/mac/sched_nr_ue.h"
 #include "srsran/common/test_common.h"
 extern "C" {
 #include "srsran/phy/common/sliv.h"
@@ -473,6 +474,56 @@ void test_multi_pusch()
   fmt::print("C-RNTI allocated in Common SearchSpace. Occupied PRBs:\n{:b} -> {:b}\n", last_prb_bitmap, used_prbs_ue2);
 }
 
+void test_ul_link_adaptation()
+{
+  srsran::test_delimit_logger delimiter{"Test UL Link Adaptation"};
+
+  // Create Cell and UE configs
+  sched_nr_interface::sched_args_t sched_args;
+  sched_args.fixed_ul_mcs              = -1;
+  sched_args.adaptive_ul_mcs_step_size = 0.1;
+  sched_nr_cell_cfg_t                cellcfg = get_cell_cfg();
+  sched_nr_impl::cell_config_manager cell_params{0, cellcfg, sched_args};
+  sched_nr_impl::ue_cfg_manager      uecfg{get_ue_cfg(cellcfg)};
+  const bwp_params_t&                bwp_params = cell_params.bwps[0];
+  const mcs_lookup_table&            mcs_table  = bwp_params.ul_mcs_table;
+  ue_context_common                  ue_ctxt;
+  ue_carrier                         ue_cc{0x4601, uecfg, cell_params, ue_ctxt, ue_buffer_manager::pdu_builder{}};
+
+  // The PUSCH MCS does not decrease with the UL CQI
+  for (uint32_t cqi = 1; cqi < mcs_table.nof_levels(); ++cqi) {
+    TESTASSERT(mcs_table.get(cqi, 1).mcs >= mcs_table.get(cqi - 1, 1).mcs);
+  }
+
+  // The UL CQI follows the reported SINR
+  const float sinr = 10;
+  ue_cc.ul_sinr_info(sinr);
+  TESTASSERT_EQ(srsran_cqi_from_snr(sinr), ue_cc.ul_cqi);
+
+  slot_point         slot_tx{0, 0};
+  slot_ue            sue{ue_cc, slot_tx};
+  srsran_dci_ul_nr_t dci{};
+  auto               tx_pusch = [&](bool crc) {
+    ul_harq_proc* h = sue.find_empty_ul_harq();
+    TESTASSERT(h != nullptr);
+    TESTASSERT(h->new_tx(slot_tx, prb_interval{0, 10}, mcs_table.get(ue_cc.ul_cqi, 1).mcs, 4, dci));
+    TESTASSERT(ue_cc.ul_crc_info(h->pid, crc) >= 0);
+    h->reset();
+  };
+
+  // NACKs lower the UL CQI until the maximum offset is reached
+  for (uint32_t i = 0; i < 10; ++i) {
+    tx_pusch(false);
+  }
+  TESTASSERT_EQ(srsran_cqi_from_snr(sinr - sched_args.max_delta_ul_snr), ue_cc.ul_cqi);
+
+  // ACKs increase the UL CQI until the maximum offset is reached
+  for (uint32_t i = 0; i < 200; ++i) {
+    tx_pusch(true);
+  }
+  TESTASSERT_EQ(srsran_cqi_from_snr(sinr + sched_args.max_delta_ul_snr), ue_cc.ul_cqi);
+}
+
 } // namespace srsenb
 
 int main()
@@ -493,4 +544,5 @@ int main()
   srsenb::test_pdsch_fail();
   srsenb::test_multi_pdsch();
   srsenb::test_multi_pusch();
+  srsenb::test_ul_link_adaptation();
 }
\ No newline at end of file
@@ -444,7 +444,12 @@ int sched_nr_base_test_bench::set_default_slot_events(const sim_nr_ue_ctxt_t& ue
   for (uint32_t enb_cc_idx = 0; enb_cc_idx < pending_events.cc_list.size(); ++enb_cc_idx) {
     auto& cc_feedback = pending_events.cc_list[enb_cc_idx];
 
-    cc_feedback.configured = true;
+    // Only carriers activated for the UE generate feedback
+    cc_feedback.configured =
+        enb_cc_idx < ue_ctxt.ue_cfg.carriers.size() and ue_ctxt.ue_cfg.carriers[enb_cc_idx].active;
+    if (not cc_feedback.configured) {
+      continue;
+    }
     for (uint32_t pid = 0; pid < SCHED_NR_MAX_HARQ; ++pid) {
       auto& dl_h = ue_ctxt.cc_list[enb_cc_idx].dl_harqs[pid];
       auto& ul_h = ue_ctxt.cc_list[enb_cc_idx].ul_harqs[pid];
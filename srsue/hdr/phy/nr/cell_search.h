@@ -58,6 +58,9 @@ public:
   bool  start(const cfg_t& cfg);
   ret_t run_slot(const cf_t* buffer, uint32_t slot_sz);
 
+  /// Searches the SSB in the whole buffer, e.g. a channel of a wideband capture
+  ret_t run(const cf_t* buffer, uint32_t nof_samples);
+
 private:
   srslog::basic_logger&        logger;
   srsran_ssb_t                 ssb    = {};
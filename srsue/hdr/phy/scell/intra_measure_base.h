@@ -21,7 +21,9 @@
 #ifndef SRSUE_INTRA_MEASURE_BASE_H
 #define SRSUE_INTRA_MEASURE_BASE_H
 
+#include "srsran/common/thread_pool.h"
 #include "srsran/interfaces/ue_phy_interfaces.h"
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <srsran/common/common.h>
@@ -35,17 +37,17 @@ namespace scell {
 /**
  * @brief Describes a generic base class to perform intra-frequency measurements
  */
-class intra_measure_base : public srsran::thread
+class intra_measure_base
 {
   /*
    * The intra-cell measurement has 5 different states:
    *  - idle: it has been initiated and it is waiting to get configured to start capturing samples. From any state
    *          except quit can transition to idle.
    *  - wait: waits for the TTI trigger to transition to receive
-   *  - receive: captures base-band samples for intra_freq_meas_len_ms and goes to measure.
-   *  - measure: enables the inner thread to start the measuring function. The asynchronous buffer will transition to
-   *             wait as soon as it has read the data from the buffer.
-   *  - quit: stops the inner thread and quits. Transition from any state measure state.
+   *  - receive: captures base-band samples for intra_freq_meas_len_ms in the snapshot buffer and goes to measure.
+   *  - measure: the measurement jobs run in the worker pool. The last job reports the measurements and transitions
+   *             to wait.
+   *  - quit: no new measurement is started and the jobs in flight skip the remaining cells. Transition from any state.
    *
    * FSM abstraction:
    *
@@ -53,11 +55,16 @@ class intra_measure_base : public srsran::thread
    *  | Idle | --------------------->| Wait |------------------------------>| Receive |
    *  +------+                       +------+                               +---------+
    *     ^                              ^                                        |          stop  +------+
-   *     |                  Read buffer |                                        |          ----->| Quit |
+   *     |                   Last job   |                                        |          ----->| Quit |
    *   init                        +---------+    intra_freq_meas_len_ms         |                +------+
    * meas_stop                     | Measure |<----------------------------------+
    *                               +---------+
    *
+   * A measurement consists of a search job, which finds the cells in the snapshot, followed by a job per cell to
+   * measure. The jobs of all the instances share the same pool, so the cells of different carriers and the cells of
+   * the same carrier are measured concurrently. All the jobs read the snapshot in place, and no new capture starts
+   * until the last job of the measurement has finished.
+   *
    * This class has been designed to be thread safe. Any method can be called from different threads as long as
    * init_generic is called when the FSM is in idle.
    */
@@ -76,16 +83,21 @@ public:
    * @brief Describes the default generic configuration arguments
    */
   struct args_t {
-    double   srate_hz          = 0.0;  ///< Sampling rate in Hz, optional for LTE, compulsory for NR
-    uint32_t len_ms            = 20;   ///< Amount of time to accumulate
-    uint32_t period_ms         = 200;  ///< Minimum time interval between measurements, set to 0 for free-run
-    uint32_t tti_period        = 0;    ///< Measurement TTI trigger period, set to 0 to trigger at any TTI
-    uint32_t tti_offset        = 0;    ///< Measurement TTI trigger offset
-    float    rx_gain_offset_db = 0.0f; ///< Gain offset, for calibrated measurements
+    double                    srate_hz          = 0.0;     ///< Sampling rate in Hz, optional for LTE, compulsory for NR
+    uint32_t                  len_ms            = 20;      ///< Amount of time to accumulate
+    uint32_t                  period_ms         = 200;     ///< Minimum time between measurements, 0 for free-run
+    uint32_t                  tti_period        = 0;       ///< Measurement TTI trigger period, 0 to trigger at any TTI
+    uint32_t                  tti_offset        = 0;       ///< Measurement TTI trigger offset
+    float                     rx_gain_offset_db = 0.0f;    ///< Gain offset, for calibrated measurements
+    srsran::task_thread_pool* workers           = nullptr; ///< Pool of the measurement jobs, kept if not set
   };
 
+  /// Priority of the measurement workers, low by default
+  const static int INTRA_FREQ_MEAS_PRIO = DEFAULT_PRIORITY + 5;
+
   /**
-   * @brief Stops the operation of this component and it cannot be started again
+   * @brief Stops the operation of this component and it cannot be started again. It blocks until the jobs in flight
+   * have finished
    * @note use meas_stop() method to stop measurements temporally
    */
   void stop();
@@ -123,27 +135,39 @@ public:
   virtual uint32_t get_earfcn() const = 0;
 
   /**
-   * @brief Synchronous wait mechanism, blocks the writer thread while it is in measure state. If the asynchronous
-   * thread is too slow, use this method for stalling the writing thread and wait the asynchronous thread to clear the
-   * buffer.
+   * @brief Synchronous wait mechanism, blocks the writer thread while it is in measure state. If the measurement jobs
+   * are too slow, use this method for stalling the writing thread and wait for the measurement to be reported.
    */
   void wait_meas()
   { // Only used by scell_search_test
     state.wait_change(internal_state::measure);
   }
 
+  /**
+   * @brief Computes the average latency of the measurements since the last initialization, from the end of the capture
+   * to the report of the measured cells
+   * @return The latency in microseconds
+   */
+  uint32_t get_meas_latency_us() const
+  {
+    if (latency_count == 0) {
+      return 0;
+    }
+    return (uint32_t)(latency_sum_us / latency_count);
+  }
+
 protected:
   struct measure_context_t {
-    uint32_t           cc_idx             = 0;   ///< Component carrier index
-    std::set<uint32_t> active_pci         = {};  ///< Set with the active PCIs
-    uint32_t           sf_len             = 0;   ///< Subframe length in samples
-    uint32_t           meas_len_ms        = 20;  ///< Measure length in milliseconds/sub-frames
-    uint32_t           meas_period_ms     = 200; ///< Minimum time between measurements
-    uint32_t           trigger_tti_period = 0;   ///< Measurement TTI trigger period
-    uint32_t           trigger_tti_offset = 0;   ///< Measurement TTI trigger offset
-    meas_itf&          new_cell_itf;
-
-    explicit measure_context_t(meas_itf& new_cell_itf_) : new_cell_itf(new_cell_itf_) {}
+    uint32_t           cc_idx             = 0;       ///< Component carrier index
+    std::set<uint32_t> active_pci         = {};      ///< Set with the active PCIs
+    uint32_t           sf_len             = 0;       ///< Subframe length in samples
+    uint32_t           meas_len_ms        = 20;      ///< Measure length in milliseconds/sub-frames
+    uint32_t           meas_period_ms     = 200;     ///< Minimum time between measurements
+    uint32_t           trigger_tti_period = 0;       ///< Measurement TTI trigger period
+    uint32_t           trigger_tti_offset = 0;       ///< Measurement TTI trigger offset
+    meas_itf*          new_cell_itf       = nullptr; ///< Measurement report interface, never null
+
+    explicit measure_context_t(meas_itf& new_cell_itf_) : new_cell_itf(&new_cell_itf_) {}
   };
 
   std::atomic<float> rx_gain_offset_db = {0.0f}; ///< Current gain offset
@@ -163,7 +187,7 @@ protected:
   /**
    * @brief Destructor is only accessible through inherited classes
    */
-  ~intra_measure_base() override;
+  virtual ~intra_measure_base();
 
   /**
    * @brief Subframe length setter, the inherited class shall set the subframe length
@@ -183,13 +207,13 @@ private:
   {
   public:
     typedef enum {
-      initial = 0, /// Initial state, it transitions to idle once the internal thread has started
-      idle,        ///< Internal thread runs, it does not capture data
+      initial = 0, /// Initial state, it transitions to idle once it has been initialised
+      idle,        ///< It does not capture data
       wait_first,  ///< Wait for the TTI trigger (if configured)
       wait,        ///< Wait for the period time to pass
-      receive,     ///< Accumulate samples in ring buffer
+      receive,     ///< Accumulate samples in the snapshot buffer
       measure,     ///< Module is busy measuring
-      quit         ///< Quit thread, no transitions are allowed
+      quit         ///< Stopped, no transitions are allowed
     } state_t;
 
   private:
@@ -220,12 +244,12 @@ private:
         state = new_state;
       }
 
-      // Notifies to the inner thread about the change of state
+      // Notifies to the waiting threads about the change of state
       cvar.notify_all();
     }
 
     /**
-     * @brief Waits for a state transition to a state different than the provided, used for blocking the inner thread
+     * @brief Waits for a state transition to a state different than the provided, used for blocking the writer thread
      */
     void wait_change(state_t s)
     {
@@ -259,7 +283,7 @@ private:
   }
 
   /**
-   * @brief Writes baseband data in the internal soft-buffer
+   * @brief Writes baseband data in the snapshot buffer and starts the measurement once it is complete
    * @param data Provides baseband data
    * @param nsamples Number of samples to write
    */
@@ -272,29 +296,61 @@ private:
   virtual srsran::srsran_rat_t get_rat() const = 0;
 
   /**
-   * @brief Pure virtual function to perform measurements
-   * @note The context is pass-by-value to protect it from concurrency. However, the buffer is pass-by-reference
-   * as it is protected by the state.
+   * @brief Pure virtual function to search the cells in the snapshot. It runs as the first job of the measurement
+   * @note The context and the buffer are owned by the measurement and they remain unchanged until its last job has
+   * finished. The buffer is shared with the cell jobs, so it shall not be modified.
    * @param context Provides current measurement context
-   * @param buffer Provides current measurement context
+   * @param buffer Provides the baseband snapshot of context.meas_len_ms subframes
    * @param rx_gain_offset Provides last received rx_gain_offset
+   * @param cells Returns the PCIs to measure individually with measure_cell, it is left empty if the RAT reports its
+   * measurements from the search
    * @return True if the measurement functions are executed without errors, otherwise false
    */
-  virtual bool measure_rat(const measure_context_t& context, std::vector<cf_t>& buffer, float rx_gain_offset) = 0;
+  virtual bool measure_rat(const measure_context_t& context,
+                           cf_t*                    buffer,
+                           float                    rx_gain_offset,
+                           std::vector<uint32_t>&   cells) = 0;
 
   /**
-   * @brief Measurement process helper method. Encapsulates the neighbour cell measurement functionality
+   * @brief Measures a single cell of the ones returned by measure_rat. The jobs of different cells run concurrently
+   * @param context Provides current measurement context
+   * @param buffer Provides the baseband snapshot, read only
+   * @param pci Physical cell identifier to measure
+   * @param rx_gain_offset Provides last received rx_gain_offset
+   * @param meas Returns the cell measurement
+   * @return True if the cell has been found, otherwise false
    */
-  void measure_proc();
+  virtual bool measure_cell(const measure_context_t& context,
+                            cf_t*                    buffer,
+                            uint32_t                 pci,
+                            float                    rx_gain_offset,
+                            phy_meas_t&              meas)
+  {
+    return false;
+  }
 
   /**
-   * @brief Internal asynchronous low priority thread, waits for measure internal state to execute the measurement
-   * process. It stops when the internal state transitions to quit.
+   * @brief Search job, runs measure_rat and dispatches a job for each of the cells to measure
    */
-  void run_thread() override;
+  void search_job();
 
-  ///< Internal Thread priority, low by default
-  const static int INTRA_FREQ_MEAS_PRIO = DEFAULT_PRIORITY + 5;
+  /**
+   * @brief Cell job, measures the cell in the given position of the list returned by the search
+   */
+  void cell_job(uint32_t idx);
+
+  /**
+   * @brief Finishes a job of the current measurement. The last one reports the measured cells, releases the snapshot
+   * and transitions to wait
+   */
+  void job_done();
+
+  /// Returns true from the end of the capture until the last job of the measurement has finished
+  bool is_measuring()
+  {
+    std::lock_guard<std::mutex> lock(jobs_mutex);
+    return measuring;
+  }
 
   /// Returns a copy of the current used context.
   measure_context_t get_context() const
@@ -303,14 +359,39 @@ private:
     return context;
   }
 
-  internal_state        state;
-  srslog::basic_logger& logger;
-  mutable std::mutex    mutex;
-  uint32_t              last_measure_tti = 0;
-  measure_context_t     context;
+  internal_state            state;
+  srslog::basic_logger&     logger;
+  mutable std::mutex        mutex;
+  uint32_t                  last_measure_tti = 0;
+  measure_context_t         context;
+  srsran::task_thread_pool* workers = nullptr;
+
+  /// Result of a cell job, each job writes its own
+  struct cell_result_t {
+    bool       found = false;
+    phy_meas_t meas  = {};
+  };
 
-  std::vector<cf_t>   search_buffer;
-  srsran_ringbuffer_t ring_buffer = {};
+  /// Measurement in flight. The writer thread only writes it while no measurement is in flight, and the jobs of the
+  /// measurement read it in place
+  measure_context_t                     meas_context;
+  float                                 meas_rx_gain_offset_db = 0.0f;
+  std::vector<cf_t>                     search_buffer;
+  uint32_t                              search_buffer_len = 0;
+  std::vector<uint32_t>                 meas_cells;
+  std::vector<cell_result_t>            meas_results;
+  std::vector<phy_meas_t>               meas_report;
+  std::atomic<uint32_t>                 nof_pending_jobs = {0};
+  std::chrono::steady_clock::time_point capture_end;
+
+  /// Protects the measuring flag, which is set from the end of the capture until the last job has finished
+  std::mutex              jobs_mutex;
+  std::condition_variable jobs_cvar;
+  bool                    measuring = false;
+
+  /// Latency
+  std::atomic<uint64_t> latency_sum_us = {0}; ///< Accumulated latency in microseconds
+  std::atomic<uint64_t> latency_count  = {0}; ///< Number of measurements
 };
 
 } // namespace scell
@@ -73,22 +73,53 @@ private:
   srsran::srsran_rat_t get_rat() const override { return srsran::srsran_rat_t::lte; }
 
   /**
-   * @brief LTE specific measurement process
+   * @brief LTE specific search, detects new cells using PSS/SSS and returns the active ones, except the serving cell
    * @param context Measurement context
    * @param buffer Provides the baseband buffer to perform the measurements
    * @param rx_gain_offset Provides last received rx_gain_offset
+   * @param cells Returns the cells to measure
    * @return True if no error happens, otherwise false
    */
-  bool measure_rat(const measure_context_t& context, std::vector<cf_t>& buffer, float rx_gain_offset) override;
+  bool measure_rat(const measure_context_t& context,
+                   cf_t*                    buffer,
+                   float                    rx_gain_offset,
+                   std::vector<uint32_t>&   cells) override;
+
+  /**
+   * @brief Measures a cell with its reference signals in the time domain
+   * @param context Measurement context
+   * @param buffer Provides the baseband buffer to perform the measurements
+   * @param pci Cell to measure
+   * @param rx_gain_offset Provides last received rx_gain_offset
+   * @param meas Returns the measurement
+   * @return True if the cell is found, otherwise false
+   */
+  bool measure_cell(const measure_context_t& context,
+                    cf_t*                    buffer,
+                    uint32_t                 pci,
+                    float                    rx_gain_offset,
+                    phy_meas_t&              meas) override;
+
+  /// Reference signal based measurement object, each concurrent cell job takes its own
+  struct refsignal_dl_sync_t {
+    srsran_refsignal_dl_sync_t q = {};
+    refsignal_dl_sync_t() { srsran_refsignal_dl_sync_init(&q, SRSRAN_CP_NORM); }
+    ~refsignal_dl_sync_t() { srsran_refsignal_dl_sync_free(&q); }
+    refsignal_dl_sync_t(const refsignal_dl_sync_t&) = delete;
+    refsignal_dl_sync_t& operator=(const refsignal_dl_sync_t&) = delete;
+  };
 
   srslog::basic_logger& logger;
   srsran_cell_t         serving_cell   = {};  ///< Current serving cell in the EARFCN, to avoid reporting it
+  srsran_cell_t         meas_cell      = {};  ///< Serving cell of the measurement in flight
   std::atomic<uint32_t> current_earfcn = {0}; ///< Current EARFCN
   std::mutex            mutex;
 
   /// LTE-based measuring objects
-  scell_recv                 scell_rx;               ///< Secondary cell searcher
-  srsran_refsignal_dl_sync_t refsignal_dl_sync = {}; ///< Reference signal based measurement
+  scell_recv                                        scell_rx; ///< Secondary cell searcher
+  std::vector<std::unique_ptr<refsignal_dl_sync_t>> refsignal_dl_sync_pool; ///< Free objects, grows up to the number
+                                                                            ///< of concurrent cell jobs
+  std::mutex                                        refsignal_dl_sync_mutex;
 };
 
 } // namespace scell
@@ -112,13 +112,17 @@ private:
 
   /**
    * @brief NR specific measurement process
-   * @attention It searches and measures the SSB with best SNR
+   * @attention It searches and measures the SSB with best SNR, and reports it without further cell jobs
    * @param context Measurement context
    * @param buffer Provides the baseband buffer to perform the measurements
    * @param rx_gain_offset Provides last received rx_gain_offset
+   * @param cells Unused, the SSB search measures the best cell
    * @return True if no error happen, otherwise false
    */
-  bool measure_rat(const measure_context_t& context, std::vector<cf_t>& buffer, float rx_gain_offset) override;
+  bool measure_rat(const measure_context_t& context,
+                   cf_t*                    buffer,
+                   float                    rx_gain_offset,
+                   std::vector<uint32_t>&   cells) override;
 
   srslog::basic_logger& logger;
   uint32_t              cc_idx           = 0;
@@ -54,9 +54,14 @@ public:
 private:
   cf_t*                 sf_buffer[SRSRAN_MAX_PORTS] = {};
   srslog::basic_logger& logger;
-  srsran_sync_t         sync_find = {};
+  srsran_pss_corr_t     pss_corr  = {};
+  srsran_sss_t          sss       = {};
 
   uint32_t current_fft_sz;
+
+  // Minimum peak to average ratio of the accumulated PSS correlation for searching its SSS. Noise alone stays below 6
+  // with 10 ms or more
+  const float pss_par_threshold = 8.0f;
 };
 
 } // namespace scell
@@ -42,6 +42,7 @@
 #include "srsue/hdr/phy/lte/worker_pool.h"
 #include "srsue/hdr/phy/nr/worker_pool.h"
 #include "sync_state.h"
+#include "wideband_search.h"
 
 namespace srsue {
 
@@ -57,6 +58,7 @@ public:
   sync(srslog::basic_logger& phy_logger, srslog::basic_logger& phy_lib_logger) :
     thread("SYNC"),
     search_p(phy_logger),
+    wb_search(phy_logger),
     sfn_p(phy_logger),
     phy_logger(phy_logger),
     phy_lib_logger(phy_lib_logger),
@@ -146,6 +148,12 @@ private:
    */
   void run_cell_search_state();
 
+  /**
+   * Captures a bandwidth of cell_search_wideband_srate starting at the current EARFCN and searches all the EARFCNs of
+   * the list that fall within it. The result of each one is stored in wideband_cells
+   */
+  void run_wideband_search();
+
   /**
    * SFN synchronization using MIB. run_subframe() receives and processes 1 subframe
    * and returns
@@ -213,7 +221,9 @@ private:
 
   // Objects for internal use
   search                                                  search_p;
+  wideband_search                                         wb_search;
   sfn_sync                                                sfn_p;
+  std::unique_ptr<srsran::task_thread_pool>               intra_freq_workers; ///< Shared by the carriers measurements
   std::vector<std::unique_ptr<scell::intra_measure_lte> > intra_freq_meas;
   std::mutex                                              intra_freq_cfg_mutex;
 
@@ -268,6 +278,13 @@ private:
 
   search::ret_code cell_search_ret = search::CELL_NOT_FOUND;
 
+  // Wideband cell search. The EARFCNs without a cell in the last capture are skipped by the cell search
+  const static uint32_t    wideband_capture_ms = 40;
+  bool                     wideband_enabled    = false;
+  bool                     wideband_capture    = false;
+  std::map<uint32_t, bool> wideband_cells;
+  std::vector<cf_t>        wideband_buffer;
+
   // Sampling rate mode (find is 1.92 MHz, camp is the full cell BW)
   class srate_safe
   {
@@ -0,0 +1,145 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSUE_WIDEBAND_SEARCH_H
+#define SRSUE_WIDEBAND_SEARCH_H
+
+#include "srsran/common/thread_pool.h"
+#include "srsran/srslog/srslog.h"
+#include "srsran/srsran.h"
+#include "srsue/hdr/phy/nr/cell_search.h"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace srsue {
+
+/**
+ * Searches LTE cells in several EARFCNs, and NR cells in several SSB ARFCNs, at once, from a single capture of a
+ * bandwidth that contains all of them.
+ *
+ * Each EARFCN is shifted to baseband and decimated to the cell search rate (1.92 MHz) with a polyphase resampler. The
+ * PSS/SSS search of each EARFCN then runs on its own searcher, in a pool of threads. The three PSS are correlated at
+ * once over the whole channel, accumulating every 5 ms, and the SSS of the PSS that stand out are detected at the peak
+ * of the correlation. A cell is found if most of the 5 ms of the capture detect the same SSS.
+ *
+ * Each SSB ARFCN goes through the same shift and decimation, to 256 subcarriers of the SSB SCS of its band, and its SSB
+ * is searched and its PBCH decoded by an NR cell searcher. The capture must contain an SSB period (20 ms).
+ */
+class wideband_search
+{
+public:
+  struct result_t {
+    uint32_t                      earfcn  = 0;
+    double                        freq_hz = 0.0;
+    bool                          found   = false;
+    srsran_ue_cellsearch_result_t cell    = {};
+  };
+
+  struct nr_result_t {
+    uint32_t                    ssb_arfcn = 0;
+    double                      freq_hz   = 0.0;
+    srsran_subcarrier_spacing_t scs       = srsran_subcarrier_spacing_15kHz;
+    bool                        found     = false;
+    srsran_ssb_search_res_t     ssb_res   = {};
+  };
+
+  explicit wideband_search(srslog::basic_logger& logger_) : logger(logger_) {}
+  ~wideband_search();
+
+  /// Allocates up to max_channels searchers, which run concurrently on nof_threads threads. NR needs nr_enable
+  bool init(uint32_t max_channels, uint32_t nof_threads, bool nr_enable = false);
+
+  /// Maximum distance of an EARFCN to the center of a capture of srate_hz, so that its PSS/SSS fit in the capture
+  static double max_offset_hz(double srate_hz);
+
+  /// Maximum distance of an SSB to the center of a capture of srate_hz, so that it fits in the capture
+  static double max_offset_nr_hz(double srate_hz, srsran_subcarrier_spacing_t scs);
+
+  /// Searches the EARFCNs of the list that fall within the capture. Returns one result per searched EARFCN
+  std::vector<result_t> run(const cf_t*                  samples,
+                            uint32_t                     nof_samples,
+                            double                       srate_hz,
+                            double                       center_freq_hz,
+                            const std::vector<uint32_t>& earfcns);
+
+  /// Searches the SSB ARFCNs of the list that fall within the capture. Returns one result per searched ARFCN
+  std::vector<nr_result_t> run_nr(const cf_t*                  samples,
+                                  uint32_t                     nof_samples,
+                                  double                       srate_hz,
+                                  double                       center_freq_hz,
+                                  const std::vector<uint32_t>& ssb_arfcns);
+
+private:
+  struct searcher_t {
+    srsran_resample_poly_t resampler = {};
+    srsran_pss_corr_t      pss_corr  = {};
+    srsran_sss_t           sss       = {};
+    std::vector<cf_t>      mix;     ///< Block of the capture shifted to baseband
+    std::vector<cf_t>      samples; ///< Channel at the cell search rate
+    result_t               result    = {};
+    nr_result_t            nr_result = {};
+
+    std::unique_ptr<nr::cell_search> nr_searcher; ///< Only if NR is enabled
+  };
+
+  /// Capture being searched, shared by all the searchers
+  struct capture_t {
+    const cf_t* samples        = nullptr;
+    uint32_t    nof_samples    = 0;
+    double      srate_hz       = 0.0;
+    double      center_freq_hz = 0.0;
+  };
+
+  /// Sampling rate of an SSB channel, which is searched with the same symbol size for any SCS
+  static double nr_srate_hz(srsran_subcarrier_spacing_t scs);
+
+  void channelize(searcher_t& s, double freq_hz);
+  void search(searcher_t& s);
+  void search_nr(searcher_t& s);
+
+  /// Prepares and searches nof_channels channels, as many at a time as searchers, and collects their results
+  void run_batches(uint32_t                                         nof_channels,
+                   const std::function<bool(searcher_t&, uint32_t)>& prepare,
+                   const std::function<void(searcher_t&)>&           search_channel,
+                   const std::function<void(searcher_t&)>&           collect);
+
+  srslog::basic_logger&                     logger;
+  std::vector<std::unique_ptr<searcher_t> > searchers;
+  std::unique_ptr<srsran::task_thread_pool> pool;
+  capture_t                                 capture;
+
+  // Minimum peak to average ratio of the PSS correlation, accumulated every 5 ms, for detecting its SSS
+  const float pss_par_threshold = 8.0f;
+
+  // Symbol size of the SSB channels, the smallest power of two over the 240 subcarriers of the SSB
+  const static uint32_t nr_symbol_sz = 256;
+
+  std::mutex              mutex;
+  std::condition_variable cvar;
+  uint32_t                nof_pending = 0;
+};
+
+} // namespace srsue
+
+#endif // SRSUE_WIDEBAND_SEARCH_H
@@ -85,6 +85,7 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
     ("ue.phy", bpo::value<string>(&args->phy.type)->default_value("lte"), "Type of the PHY [lte]")
 
     ("rf.srate",        bpo::value<double>(&args->rf.srate_hz)->default_value(0.0),          "Force Tx and Rx sampling rate in Hz")
+    ("rf.resampler",    bpo::value<string>(&args->rf.resampler)->default_value("fft"),       "Resampler from the forced sampling rate: fft (integer ratios) or poly (any ratio)")
     ("rf.freq_offset",  bpo::value<float>(&args->rf.freq_offset)->default_value(0),          "(optional) Frequency offset")
     ("rf.rx_gain",      bpo::value<float>(&args->rf.rx_gain)->default_value(-1),             "Front-end receiver gain")
     ("rf.tx_gain",      bpo::value<float>(&args->rf.tx_gain)->default_value(-1),             "Front-end transmitter gain (all channels)")
@@ -104,6 +105,7 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
     ("rf.device_args", bpo::value<string>(&args->rf.device_args)->default_value("auto"), "Front-end device arguments")
     ("rf.time_adv_nsamples", bpo::value<string>(&args->rf.time_adv_nsamples)->default_value("auto"), "Transmission time advance")
     ("rf.continuous_tx", bpo::value<string>(&args->rf.continuous_tx)->default_value("auto"), "Transmit samples continuously to the radio or on bursts (auto/yes/no). Default is auto (yes for UHD, no for rest)")
+    ("rf.virtual_clock", bpo::value<bool>(&args->rf.virtual_clock)->default_value(false), "Run on the radio time instead of the wall clock (zmq and file devices)")
 
     ("rf.bands.rx[0].min", bpo::value<float>(&args->rf.ch_rx_bands[0].min)->default_value(0), "Lower frequency boundary for CH0-RX")
     ("rf.bands.rx[0].max", bpo::value<float>(&args->rf.ch_rx_bands[0].max)->default_value(0), "Higher frequency boundary for CH0-RX")
@@ -326,6 +328,10 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
        bpo::value<uint32_t>(&args->phy.intra_freq_meas_period_ms)->default_value(200),
        "Period of intra-frequency neighbour cell measurement in ms. Maximum as per 3GPP is 200 ms.")
 
+    ("phy.intra_freq_meas_nof_threads",
+       bpo::value<uint32_t>(&args->phy.intra_freq_meas_nof_threads)->default_value(2),
+       "Number of threads measuring the neighbour cells of all the carriers.")
+
     ("phy.correct_sync_error",
        bpo::value<bool>(&args->phy.correct_sync_error)->default_value(false),
        "Channel estimator measures and pre-compensates time synchronization error. Increases CPU usage, improves PDSCH "
@@ -441,6 +447,14 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
      bpo::value<int>(&args->phy.force_N_id_1)->default_value(-1),
      "Force using a specific SSS (set to -1 to allow all SSSs).")
 
+    ("phy.cell_search_wideband_srate",
+     bpo::value<float>(&args->phy.cell_search_wideband_srate)->default_value(0.0f),
+     "Sampling rate of a capture to search all the EARFCNs it contains at once (set to 0 to search one at a time).")
+
+    ("phy.cell_search_nof_threads",
+     bpo::value<uint32_t>(&args->phy.cell_search_nof_threads)->default_value(4),
+     "Number of threads searching the EARFCNs of a wideband capture.")
+
     // PHY NR args
     ("phy.nr.store_pdsch_ko",
       bpo::value<bool>(&args->phy.nr_store_pdsch_ko)->default_value(false),
@@ -653,6 +667,12 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
     args->stack.sync_queue_size = MULTIQUEUE_DEFAULT_CAPACITY;
   }
 
+  // With a virtual clock, the samples of a subframe must be sent before the next one is received
+  if (args->rf.virtual_clock && args->phy.nof_phy_threads != 1) {
+    cout << "Using 1 PHY thread with the virtual clock" << endl;
+    args->phy.nof_phy_threads = 1;
+  }
+
   srsran_use_standard_symbol_size(use_standard_lte_rates);
 
   args->stack.rrc_nr.scs     = srsran_subcarrier_spacing_from_str(scs_khz.c_str());
@@ -79,11 +79,16 @@ bool cell_search::start(const cfg_t& cfg)
 }
 
 cell_search::ret_t cell_search::run_slot(const cf_t* buffer, uint32_t slot_sz)
+{
+  return run(buffer, slot_sz + ssb.ssb_sz);
+}
+
+cell_search::ret_t cell_search::run(const cf_t* buffer, uint32_t nof_samples)
 {
   cell_search::ret_t ret = {};
 
   // Search for SSB
-  if (srsran_ssb_search(&ssb, buffer, slot_sz + ssb.ssb_sz, &ret.ssb_res) < SRSRAN_SUCCESS) {
+  if (srsran_ssb_search(&ssb, buffer, nof_samples, &ret.ssb_res) < SRSRAN_SUCCESS) {
     logger.error("Error occurred searching SSB");
     ret.result = ret_t::ERROR;
   } else if (ret.ssb_res.measurements.snr_dB >= -10.0f and ret.ssb_res.pbch_msg.crc) {
@@ -29,12 +29,12 @@ namespace srsue {
 namespace scell {
 
 intra_measure_base::intra_measure_base(srslog::basic_logger& logger, meas_itf& new_cell_itf_) :
-  logger(logger), context(new_cell_itf_), thread("SYNC_INTRA_MEASURE")
+  logger(logger), context(new_cell_itf_), meas_context(new_cell_itf_), workers(&srsran::get_background_workers())
 {}
 
 intra_measure_base::~intra_measure_base()
 {
-  srsran_ringbuffer_free(&ring_buffer);
+  stop();
 }
 
 void intra_measure_base::init_generic(uint32_t cc_idx_, const args_t& args)
@@ -46,6 +46,9 @@ void intra_measure_base::init_generic(uint32_t cc_idx_, const args_t& args)
   context.trigger_tti_period = args.tti_period;
   context.trigger_tti_offset = args.tti_offset;
   rx_gain_offset_db          = args.rx_gain_offset_db;
+  if (args.workers != nullptr) {
+    workers = args.workers;
+  }
 
   // Compute subframe length from the sampling rate if available
   if (std::isnormal(args.srate_hz)) {
@@ -59,38 +62,31 @@ void intra_measure_base::init_generic(uint32_t cc_idx_, const args_t& args)
     return;
   }
 
-  // Calculate the new required bytes
-  int max_required_bytes = (int)(sizeof(cf_t) * context.meas_len_ms * context.sf_len);
-
-  // Reallocate only if the required capacity exceds the new requirement
-  if (ring_buffer.capacity < max_required_bytes) {
-    search_buffer.resize((size_t)context.meas_len_ms * (size_t)context.sf_len);
-
-    srsran_ringbuffer_free(&ring_buffer);
-
-    // Initialise buffer for the maximum number of PRB
-    if (srsran_ringbuffer_init(&ring_buffer, max_required_bytes) < SRSRAN_SUCCESS) {
-      ERROR("Error initiating ringbuffer");
-      return;
-    }
+  // Reallocate only if the required capacity exceeds the current one
+  size_t max_required_samples = (size_t)context.meas_len_ms * (size_t)context.sf_len;
+  if (search_buffer.size() < max_required_samples) {
+    search_buffer.resize(max_required_samples);
   }
 
+  // Reset latency measurement
+  latency_sum_us = 0;
+  latency_count  = 0;
+
   if (state.get_state() == internal_state::initial) {
     state.set_state(internal_state::idle);
-    start(INTRA_FREQ_MEAS_PRIO);
   }
 }
 
 void intra_measure_base::stop()
 {
-  // Notify quit to asynchronous thread. If it is measuring, it will first finish the measure, report to stack and
-  // then it will finish
+  // Notify quit, the jobs in flight skip the remaining cells
   state.set_state(internal_state::quit);
 
-  // Wait for the asynchronous thread to finish
-  wait_thread_finish();
-
-  srsran_ringbuffer_stop(&ring_buffer);
+  // Wait for the last job to finish, as the jobs reference this object
+  std::unique_lock<std::mutex> lock(jobs_mutex);
+  while (measuring) {
+    jobs_cvar.wait(lock);
+  }
 }
 
 void intra_measure_base::set_rx_gain_offset(float rx_gain_offset_db_)
@@ -101,7 +97,7 @@ void intra_measure_base::set_rx_gain_offset(float rx_gain_offset_db_)
 void intra_measure_base::meas_stop()
 {
   // Transition state to idle
-  // Ring-buffer shall not be reset, it will automatically be reset as soon as the FSM transitions to receive
+  // A measurement in flight finishes and reports, the snapshot is not captured again until it has finished
   state.set_state(internal_state::idle);
   Log(info, "Disabled neighbour cell search");
 }
@@ -117,28 +113,27 @@ void intra_measure_base::set_cells_to_meas(const std::set<uint32_t>& pci)
 
 void intra_measure_base::write(cf_t* data, uint32_t nsamples)
 {
-  int nbytes = (int)(nsamples * sizeof(cf_t));
-
-  mutex.lock();
-  int required_nbytes = ((int)context.meas_len_ms * (int)context.sf_len * (int)sizeof(cf_t));
-  mutex.unlock();
-
-  // As nbytes might not match the sub-frame size, make sure that buffer does not overflow
-  nbytes = SRSRAN_MIN(srsran_ringbuffer_space(&ring_buffer), nbytes);
+  uint32_t required_nsamples = meas_context.meas_len_ms * meas_context.sf_len;
 
-  // Try writing in the buffer
-  if (srsran_ringbuffer_write(&ring_buffer, data, nbytes) < nbytes) {
-    Log(warning, "Error writing to ringbuffer");
+  // As nsamples might not match the sub-frame size, make sure that buffer does not overflow
+  nsamples = SRSRAN_MIN(nsamples, required_nsamples - search_buffer_len);
+  srsran_vec_cf_copy(&search_buffer[search_buffer_len], data, nsamples);
+  search_buffer_len += nsamples;
 
-    // Transition to wait, so it can keep receiving without stopping the component operation
-    state.set_state(internal_state::wait);
-  } else {
-    // As soon as there are enough samples in the buffer, transition to measure
-    if (srsran_ringbuffer_status(&ring_buffer) >= required_nbytes) {
-      Log(debug, "Starting search and measurements");
-      state.set_state(internal_state::measure);
-    }
+  // As soon as the snapshot is complete, hand it over to the measurement jobs
+  if (search_buffer_len < required_nsamples) {
+    return;
   }
+  Log(debug, "Starting search and measurements");
+  capture_end            = std::chrono::steady_clock::now();
+  meas_rx_gain_offset_db = rx_gain_offset_db;
+  nof_pending_jobs       = 1;
+  {
+    std::lock_guard<std::mutex> lock(jobs_mutex);
+    measuring = true;
+  }
+  state.set_state(internal_state::measure);
+  workers->push_task([this]() { search_job(); });
 }
 
 void intra_measure_base::run_tti(uint32_t tti, cf_t* data, uint32_t nsamples)
@@ -154,13 +149,19 @@ void intra_measure_base::run_tti(uint32_t tti, cf_t* data, uint32_t nsamples)
       break;
     case internal_state::wait:
     case internal_state::wait_first:
-      // Check measurement trigger condition
-      if (receive_tti_trigger(tti)) {
+      // Check measurement trigger condition, the snapshot is busy until the last job of the previous measurement
+      if (not is_measuring() and receive_tti_trigger(tti)) {
         state.set_state(internal_state::receive);
         last_measure_tti = tti;
-        srsran_ringbuffer_reset(&ring_buffer);
 
-        // Write baseband to ensure measurement starts in the right TTI
+        // Take the context of the measurement and start capturing in this TTI
+        meas_context      = get_context();
+        search_buffer_len = 0;
+        if ((size_t)meas_context.meas_len_ms * meas_context.sf_len > search_buffer.size()) {
+          Log(error, "The measurement length exceeds the snapshot buffer");
+          state.set_state(internal_state::idle);
+          break;
+        }
         Log(debug, "Start writing");
         write(data, nsamples);
       }
@@ -172,61 +173,69 @@ void intra_measure_base::run_tti(uint32_t tti, cf_t* data, uint32_t nsamples)
   }
 }
 
-void intra_measure_base::measure_proc()
+void intra_measure_base::search_job()
 {
-  // Grab a copy of the context and pass it to the measure_rat method.
-  measure_context_t context_copy = get_context();
-
-  // Read data from buffer and find cells in it
-  int ret = srsran_ringbuffer_read_timed(&ring_buffer,
-                                         search_buffer.data(),
-                                         ((int)context_copy.meas_len_ms * (int)context_copy.sf_len * (int)sizeof(cf_t)),
-                                         1000);
-
-  // As this function is called once the ring-buffer has enough data to process, it is not expected to fail
-  if (ret < SRSRAN_SUCCESS) {
-    Log(error, "Ringbuffer read returned %d", ret);
-    return;
+  // Search the cells to measure in the snapshot
+  meas_cells.clear();
+  if (not measure_rat(meas_context, search_buffer.data(), meas_rx_gain_offset_db, meas_cells)) {
+    Log(error, "Error measuring RAT");
+    meas_cells.clear();
   }
 
-  // Go to receive before finishing, so new samples can be enqueued before the thread finishes
-  if (state.get_state() == internal_state::measure) {
-    // Prevents transition to wait if state has changed while reading the ring-buffer
-    state.set_state(internal_state::wait);
+  // Dispatch a job per cell, they all reference the same snapshot
+  meas_results.assign(meas_cells.size(), {});
+  nof_pending_jobs += (uint32_t)meas_cells.size();
+  for (uint32_t i = 0; i < (uint32_t)meas_cells.size(); i++) {
+    workers->push_task([this, i]() { cell_job(i); });
   }
 
-  // Perform measurements for the actual RAT
-  if (not measure_rat(std::move(context_copy), search_buffer, rx_gain_offset_db)) {
-    Log(error, "Error measuring RAT");
+  job_done();
+}
+
+void intra_measure_base::cell_job(uint32_t idx)
+{
+  // Skip the remaining cells if the component is stopping
+  if (state.get_state() != internal_state::quit) {
+    cell_result_t& result = meas_results[idx];
+    result.found =
+        measure_cell(meas_context, search_buffer.data(), meas_cells[idx], meas_rx_gain_offset_db, result.meas);
   }
+
+  job_done();
 }
 
-void intra_measure_base::run_thread()
+void intra_measure_base::job_done()
 {
-  bool quit = false;
-
-  do {
-    // Get state
-    internal_state::state_t s = state.get_state();
-    switch (s) {
-      case internal_state::initial:
-      case internal_state::idle:
-      case internal_state::wait:
-      case internal_state::wait_first:
-      case internal_state::receive:
-        // Wait for a different state
-        state.wait_change(s);
-        break;
-      case internal_state::measure:
-        // Run the measurement process
-        measure_proc();
-        break;
-      case internal_state::quit:
-        // Quit loop
-        quit = true;
-        break;
+  if (nof_pending_jobs.fetch_sub(1) != 1) {
+    return;
+  }
+
+  // Last job of the measurement, report the cells that have been found
+  meas_report.clear();
+  for (const cell_result_t& r : meas_results) {
+    if (r.found) {
+      meas_report.push_back(r.meas);
     }
-  } while (not quit);
+  }
+  if (not meas_report.empty()) {
+    meas_context.new_cell_itf->new_cell_meas(meas_context.cc_idx, meas_report);
+  }
+
+  uint32_t latency_us = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - capture_end)
+                            .count();
+  latency_sum_us += latency_us;
+  latency_count++;
+  Log(debug, "Measured %zd cells in %d us", meas_cells.size(), latency_us);
+
+  // Release the snapshot. The object can be destroyed as soon as the lock is released
+  std::lock_guard<std::mutex> lock(jobs_mutex);
+  measuring = false;
+  if (state.get_state() == internal_state::measure) {
+    // Prevents transition to wait if state has changed while measuring
+    state.set_state(internal_state::wait);
+  }
+  jobs_cvar.notify_all();
 }
 
 } // namespace scell
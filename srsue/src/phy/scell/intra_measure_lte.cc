@@ -34,19 +34,23 @@ intra_measure_lte::intra_measure_lte(srslog::basic_logger& logger_, meas_itf& ne
 
 intra_measure_lte::~intra_measure_lte()
 {
+  // Wait for the jobs in flight before releasing the objects they use
+  stop();
   scell_rx.deinit();
-  srsran_refsignal_dl_sync_free(&refsignal_dl_sync);
 }
 
 void intra_measure_lte::init(uint32_t cc_idx, const args_t& args)
 {
   init_generic(cc_idx, args);
 
-  // Initialise Reference signal measurement
-  srsran_refsignal_dl_sync_init(&refsignal_dl_sync, SRSRAN_CP_NORM);
-
   // Start scell
   scell_rx.init(args.len_ms);
+
+  // Allocate the reference signal measurement object of the first cell job
+  std::lock_guard<std::mutex> lock(refsignal_dl_sync_mutex);
+  if (refsignal_dl_sync_pool.empty()) {
+    refsignal_dl_sync_pool.emplace_back(new refsignal_dl_sync_t);
+  }
 }
 
 void intra_measure_lte::set_primary_cell(uint32_t earfcn, srsran_cell_t cell)
@@ -59,71 +63,87 @@ void intra_measure_lte::set_primary_cell(uint32_t earfcn, srsran_cell_t cell)
   set_current_sf_len((uint32_t)SRSRAN_SF_LEN_PRB(cell.nof_prb));
 }
 
-bool intra_measure_lte::measure_rat(const measure_context_t& context, std::vector<cf_t>& buffer, float rx_gain_offset)
+bool intra_measure_lte::measure_rat(const measure_context_t& context,
+                                    cf_t*                    buffer,
+                                    float                    rx_gain_offset,
+                                    std::vector<uint32_t>&   cells)
 {
   std::set<uint32_t> cells_to_measure = context.active_pci;
 
-  srsran_cell_t serving_cell_copy{};
   {
     std::lock_guard<std::mutex> lock(mutex);
-    serving_cell_copy = serving_cell;
+    meas_cell = serving_cell;
   }
 
   // Detect new cells using PSS/SSS
-  scell_rx.find_cells(buffer.data(), serving_cell_copy, context.meas_len_ms, cells_to_measure);
-
-  // Initialise empty neighbour cell list
-  std::vector<phy_meas_t> neighbour_cells = {};
+  scell_rx.find_cells(buffer, meas_cell, context.meas_len_ms, cells_to_measure);
 
-  context.new_cell_itf.cell_meas_reset(context.cc_idx);
+  context.new_cell_itf->cell_meas_reset(context.cc_idx);
 
-  // Use Cell Reference signal to measure cells in the time domain for all known active PCI
+  // Measure all known active PCI in their own job, except the serving cell since it's measured by workers
   for (const uint32_t& id : cells_to_measure) {
-    // Do not measure serving cell here since it's measured by workers
-    if (id == serving_cell_copy.id) {
-      continue;
-    }
-    srsran_cell_t cell = serving_cell_copy;
-    cell.id            = id;
-
-    if (srsran_refsignal_dl_sync_set_cell(&refsignal_dl_sync, cell) < SRSRAN_SUCCESS) {
-      Log(error, "Error setting refsignal DL cell");
-      return false;
+    if (id != meas_cell.id) {
+      cells.push_back(id);
     }
+  }
 
-    if (srsran_refsignal_dl_sync_run(&refsignal_dl_sync, buffer.data(), context.meas_len_ms * context.sf_len) <
-        SRSRAN_SUCCESS) {
-      Log(error, "Error running refsignal DL measurements");
-      return false;
-    }
+  return true;
+}
 
-    if (refsignal_dl_sync.found) {
-      phy_meas_t m = {};
-      m.rat        = srsran::srsran_rat_t::lte;
-      m.pci        = cell.id;
-      m.earfcn     = current_earfcn;
-      m.rsrp       = refsignal_dl_sync.rsrp_dBfs - rx_gain_offset_db;
-      m.rsrq       = refsignal_dl_sync.rsrq_dB;
-      m.cfo_hz     = refsignal_dl_sync.cfo_Hz;
-      neighbour_cells.push_back(m);
-
-      Log(info,
-          "Found neighbour cell: PCI=%03d, RSRP=%5.1f dBm, RSRQ=%5.1f, peak_idx=%5d, "
-          "CFO=%+.1fHz",
-          m.pci,
-          m.rsrp,
-          m.rsrq,
-          refsignal_dl_sync.peak_index,
-          refsignal_dl_sync.cfo_Hz);
+bool intra_measure_lte::measure_cell(const measure_context_t& context,
+                                     cf_t*                    buffer,
+                                     uint32_t                 pci,
+                                     float                    rx_gain_offset,
+                                     phy_meas_t&              meas)
+{
+  // Take a free reference signal object, or allocate a new one if all are in use by other jobs
+  std::unique_ptr<refsignal_dl_sync_t> refsignal_dl_sync;
+  {
+    std::lock_guard<std::mutex> lock(refsignal_dl_sync_mutex);
+    if (not refsignal_dl_sync_pool.empty()) {
+      refsignal_dl_sync = std::move(refsignal_dl_sync_pool.back());
+      refsignal_dl_sync_pool.pop_back();
     }
   }
+  if (refsignal_dl_sync == nullptr) {
+    refsignal_dl_sync.reset(new refsignal_dl_sync_t);
+  }
 
-  // Send measurements to RRC if any cell found
-  if (not neighbour_cells.empty()) {
-    context.new_cell_itf.new_cell_meas(context.cc_idx, neighbour_cells);
+  // Use Cell Reference signal to measure the cell in the time domain
+  srsran_cell_t cell = meas_cell;
+  cell.id            = pci;
+
+  bool found = false;
+  if (srsran_refsignal_dl_sync_set_cell(&refsignal_dl_sync->q, cell) < SRSRAN_SUCCESS) {
+    Log(error, "Error setting refsignal DL cell");
+  } else if (srsran_refsignal_dl_sync_run(&refsignal_dl_sync->q, buffer, context.meas_len_ms * context.sf_len) <
+             SRSRAN_SUCCESS) {
+    Log(error, "Error running refsignal DL measurements");
+  } else if (refsignal_dl_sync->q.found) {
+    meas        = {};
+    meas.rat    = srsran::srsran_rat_t::lte;
+    meas.pci    = cell.id;
+    meas.earfcn = current_earfcn;
+    meas.rsrp   = refsignal_dl_sync->q.rsrp_dBfs - rx_gain_offset;
+    meas.rsrq   = refsignal_dl_sync->q.rsrq_dB;
+    meas.cfo_hz = refsignal_dl_sync->q.cfo_Hz;
+    found       = true;
+
+    Log(info,
+        "Found neighbour cell: PCI=%03d, RSRP=%5.1f dBm, RSRQ=%5.1f, peak_idx=%5d, "
+        "CFO=%+.1fHz",
+        meas.pci,
+        meas.rsrp,
+        meas.rsrq,
+        refsignal_dl_sync->q.peak_index,
+        refsignal_dl_sync->q.cfo_Hz);
   }
 
-  return true;
+  // Give the object back for the next jobs
+  std::lock_guard<std::mutex> lock(refsignal_dl_sync_mutex);
+  refsignal_dl_sync_pool.push_back(std::move(refsignal_dl_sync));
+
+  return found;
 }
 
 } // namespace scell
@@ -34,6 +34,8 @@ intra_measure_nr::intra_measure_nr(srslog::basic_logger& logger_, meas_itf& new_
 
 intra_measure_nr::~intra_measure_nr()
 {
+  // Wait for the jobs in flight before releasing the objects they use
+  stop();
   srsran_ssb_free(&ssb);
 }
 
@@ -90,14 +92,17 @@ bool intra_measure_nr::set_config(const config_t& cfg)
   return true;
 }
 
-bool intra_measure_nr::measure_rat(const measure_context_t& context, std::vector<cf_t>& buffer, float rx_gain_offset)
+bool intra_measure_nr::measure_rat(const measure_context_t& context,
+                                   cf_t*                    buffer,
+                                   float                    rx_gain_offset,
+                                   std::vector<uint32_t>&   cells)
 {
   std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
 
   // Search and measure the best cell
   srsran_csi_trs_measurements_t meas = {};
   uint32_t                      N_id = 0;
-  if (srsran_ssb_csi_search(&ssb, buffer.data(), context.sf_len * context.meas_len_ms, &N_id, &meas) < SRSRAN_SUCCESS) {
+  if (srsran_ssb_csi_search(&ssb, buffer, context.sf_len * context.meas_len_ms, &N_id, &meas) < SRSRAN_SUCCESS) {
     Log(error, "Error searching for SSB");
     return false;
   }
@@ -132,7 +137,7 @@ bool intra_measure_nr::measure_rat(const measure_context_t& context, std::vector
     meas_list[0].pci    = N_id;
 
     // Push measurements to higher layers
-    context.new_cell_itf.new_cell_meas(cc_idx, meas_list);
+    context.new_cell_itf->new_cell_meas(cc_idx, meas_list);
   }
 
   return true;
@@ -41,34 +41,24 @@ void scell_recv::init(uint32_t max_sf_window)
     return;
   }
 
-  // do this different we don't need all this search window.
-  if (srsran_sync_init(&sync_find, max_sf_window * max_sf_size, 5 * max_sf_size, max_fft_sz)) {
-    logger.error("Error initiating sync_find");
+  // Correlates the three PSS at once over the whole window, accumulating every 5 ms
+  if (srsran_pss_corr_init_lte(&pss_corr, max_fft_sz, 5 * max_sf_size)) {
+    logger.error("Error initiating PSS correlator");
     return;
   }
-  srsran_sync_set_sss_algorithm(&sync_find, SSS_FULL);
-  srsran_sync_set_cfo_cp_enable(&sync_find, false, 0);
-  srsran_sync_cp_en(&sync_find, false);
-  srsran_sync_set_cfo_pss_enable(&sync_find, false);
-  srsran_sync_set_threshold(&sync_find, 2.0f); // The highest the best for avoiding ghost cells
-  srsran_sync_set_em_alpha(&sync_find, 0.3f);
-  srsran_sss_set_threshold(&sync_find.sss, 300.0); // A higher value will avoid false alarms but reduce detection
-
-  // Configure FIND object behaviour (this configuration is always the same)
-  srsran_sync_set_cfo_ema_alpha(&sync_find, 1.0);
-  srsran_sync_set_cfo_i_enable(&sync_find, false);
-  srsran_sync_set_pss_filt_enable(&sync_find, true);
-  srsran_sync_set_sss_eq_enable(&sync_find, true);
-
-  sync_find.pss.chest_on_filter  = true;
-  sync_find.sss_channel_equalize = false;
+  if (srsran_sss_init(&sss, max_fft_sz)) {
+    logger.error("Error initiating SSS");
+    return;
+  }
+  srsran_sss_set_threshold(&sss, 300.0); // A higher value will avoid false alarms but reduce detection
 
   reset();
 }
 
 void scell_recv::deinit()
 {
-  srsran_sync_free(&sync_find);
+  srsran_pss_corr_free(&pss_corr);
+  srsran_sss_free(&sss);
   free(sf_buffer[0]);
 }
 
@@ -86,70 +76,59 @@ void scell_recv::find_cells(const cf_t*          input_buffer,
   uint32_t sf_len = SRSRAN_SF_LEN(fft_sz);
 
   if (fft_sz != current_fft_sz) {
-    if (srsran_sync_resize(&sync_find, nof_sf * sf_len, 5 * sf_len, fft_sz)) {
-      logger.error("Error resizing sync nof_sf=%d, sf_len=%d, fft_sz=%d", nof_sf, sf_len, fft_sz);
+    if (srsran_pss_corr_set_lte(&pss_corr, fft_sz) || srsran_pss_corr_set_period(&pss_corr, 5 * sf_len) ||
+        srsran_sss_resize(&sss, fft_sz)) {
+      logger.error("Error resizing PSS/SSS nof_sf=%d, sf_len=%d, fft_sz=%d", nof_sf, sf_len, fft_sz);
       return;
     }
     current_fft_sz = fft_sz;
   }
 
-  uint32_t peak_idx = 0;
-  int      cell_id  = 0;
-
-  for (uint32_t n_id_2 = 0; n_id_2 < 3; n_id_2++) {
-    if (n_id_2 != (serving_cell.id % 3)) {
-      srsran_sync_set_N_id_2(&sync_find, n_id_2);
-
-      srsran_sync_find_ret_t sync_res;
-
-      srsran_sync_reset(&sync_find);
-      srsran_sync_cfo_reset(&sync_find, 0.0f);
-
-      sync_res          = SRSRAN_SYNC_NOFOUND;
-      bool sss_detected = false;
-      cell_id           = 0;
-      float max_peak    = -1;
-
-      float sss_correlation_peak_max = 0.0f;
-
-      for (uint32_t sf5_cnt = 0; sf5_cnt < nof_sf / 5; sf5_cnt++) {
-        sync_res = srsran_sync_find(&sync_find, input_buffer, sf5_cnt * 5 * sf_len, &peak_idx);
-        if (sync_res == SRSRAN_SYNC_ERROR) {
-          logger.error("INTRA: Error calling sync_find()");
-          return;
-        }
-
-        if (sync_find.peak_value > max_peak && sync_res == SRSRAN_SYNC_FOUND && srsran_sync_sss_detected(&sync_find)) {
-          // Uses the cell ID from the highest SSS correlation peak
-          if (sss_correlation_peak_max < srsran_sync_sss_correlation_peak(&sync_find)) {
-            // Set the cell ID
-            cell_id = srsran_sync_get_cell_id(&sync_find);
-
-            // Update the maximum value
-            sss_correlation_peak_max = srsran_sync_sss_correlation_peak(&sync_find);
-          }
-          sss_detected = true;
-        }
-
-        logger.debug("INTRA: n_id_2=%d, cnt=%d/%d, sync_res=%d, cell_id=%d, sf_idx=%d, peak_idx=%d, peak_value=%f, "
-                     "sss_detected=%d",
-                     n_id_2,
-                     sf5_cnt,
-                     nof_sf / 5,
-                     sync_res,
-                     cell_id,
-                     srsran_sync_get_sf_idx(&sync_find),
-                     peak_idx,
-                     sync_find.peak_value,
-                     srsran_sync_sss_detected(&sync_find));
-      }
-
-      // If the SSS was not detected, the serving_cell id is not reliable. So, consider no sync found
-      if (sync_res == SRSRAN_SYNC_FOUND && sss_detected && cell_id >= 0) {
-        // We have found a new cell, add to the list
-        found_cell_ids.insert((uint32_t)cell_id);
-        logger.debug("INTRA: Detected new cell_id=%d using PSS/SSS", cell_id);
-      }
+  // A single pass of the correlator gives the position of each PSS within the 5 ms, accumulated over the window
+  srsran_pss_corr_peak_t pss_peaks[SRSRAN_PSS_CORR_MAX_SEQ] = {};
+  if (srsran_pss_corr_run(&pss_corr, input_buffer, nof_sf * sf_len, pss_peaks) != SRSRAN_NOF_NID_2) {
+    logger.error("INTRA: Error correlating PSS");
+    return;
+  }
+
+  for (uint32_t n_id_2 = 0; n_id_2 < SRSRAN_NOF_NID_2; n_id_2++) {
+    if (n_id_2 == (serving_cell.id % 3)) {
+      continue;
+    }
+    if (pss_peaks[n_id_2].par < pss_par_threshold) {
+      logger.debug("INTRA: n_id_2=%d skipped, peak to average ratio %.1f", n_id_2, pss_peaks[n_id_2].par);
+      continue;
+    }
+
+    // Uses the cell ID from the highest SSS correlation peak, over the PSS repetitions of the window
+    uint32_t sf_idx   = 0;
+    float    sss_corr = 0.0f;
+    srsran_sss_set_N_id_2(&sss, n_id_2);
+    int n_id_1 = srsran_sss_find_periodic(&sss,
+                                          input_buffer,
+                                          nof_sf * sf_len,
+                                          pss_peaks[n_id_2].idx,
+                                          5 * sf_len,
+                                          SRSRAN_CP_NORM,
+                                          &sf_idx,
+                                          &sss_corr,
+                                          nullptr);
+
+    logger.debug("INTRA: n_id_2=%d, peak_idx=%d, peak_value=%f, par=%.1f, n_id_1=%d, sf_idx=%d, sss_corr=%.1f",
+                 n_id_2,
+                 pss_peaks[n_id_2].idx,
+                 pss_peaks[n_id_2].value,
+                 pss_peaks[n_id_2].par,
+                 n_id_1,
+                 sf_idx,
+                 sss_corr);
+
+    // If the SSS was not detected, the cell id is not reliable. So, consider no cell found
+    if (n_id_1 >= 0) {
+      // We have found a new cell, add to the list
+      uint32_t cell_id = SRSRAN_NOF_NID_2 * (uint32_t)n_id_1 + n_id_2;
+      found_cell_ids.insert(cell_id);
+      logger.debug("INTRA: Detected new cell_id=%d using PSS/SSS", cell_id);
     }
   }
   return;
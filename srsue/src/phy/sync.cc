@@ -93,18 +93,29 @@ void sync::init(srsran::radio_interface_phy* _radio,
   // Initialize cell searcher
   search_p.init(sf_buffer, nof_rf_channels, this, worker_com->args->force_N_id_2, worker_com->args->force_N_id_1);
   search_p.set_cp_en(worker_com->args->detect_cp);
+
+  // Initialize wideband cell searcher, if the capture can contain more than one EARFCN of the list
+  // Only LTE is searched here, as the NR SA cell search is requested one SSB ARFCN at a time
+  if (worker_com->args->cell_search_wideband_srate > 0 and worker_com->args->dl_earfcn_list.size() > 1) {
+    uint32_t nof_channels = std::min((uint32_t)worker_com->args->dl_earfcn_list.size(), 16U);
+    wideband_enabled      = wb_search.init(nof_channels, worker_com->args->cell_search_nof_threads);
+  }
   // Initialize SFN synchronizer, it uses only pcell buffer
   sfn_p.init(&ue_sync, worker_com->args, sf_buffer, sf_buffer.size());
 
   // Start intra-frequency measurement
   {
     std::lock_guard<std::mutex> lock(intra_freq_cfg_mutex);
+    intra_freq_workers.reset(new srsran::task_thread_pool(std::max(worker_com->args->intra_freq_meas_nof_threads, 1U),
+                                                          false,
+                                                          scell::intra_measure_base::INTRA_FREQ_MEAS_PRIO));
     for (uint32_t i = 0; i < worker_com->args->nof_lte_carriers; i++) {
       scell::intra_measure_lte*         q    = new scell::intra_measure_lte(phy_logger, *this);
       scell::intra_measure_base::args_t args = {};
       args.len_ms                            = worker_com->args->intra_freq_meas_len_ms;
       args.period_ms                         = worker_com->args->intra_freq_meas_period_ms;
       args.rx_gain_offset_db                 = worker_com->args->rx_gain_offset;
+      args.workers                           = intra_freq_workers.get();
       q->init(i, args);
       intra_freq_meas.push_back(std::unique_ptr<scell::intra_measure_lte>(q));
     }
@@ -143,6 +154,9 @@ void sync::stop()
   for (auto& q : intra_freq_meas) {
     q->stop();
   }
+  if (intra_freq_workers != nullptr) {
+    intra_freq_workers->stop();
+  }
 
   // Reset (stop Rx stream) as soon as possible to avoid base-band Rx buffer overflow
   radio_h->reset();
@@ -257,12 +271,29 @@ rrc_interface_phy_lte::cell_search_ret_t sync::cell_search_start(phy_cell_t* fou
   } else {
     current_earfcn = earfcn;
   }
-  Info("Cell Search: changing frequency to EARFCN=%d", current_earfcn);
-  set_frequency();
 
-  // Move to CELL SEARCH and wait to finish
-  Info("Cell Search: Setting Cell search state");
-  phy_state.run_cell_search();
+  // When going through the EARFCN list, a wideband capture tells which of the next EARFCNs have a cell
+  bool skip_search = false;
+  if (wideband_enabled and earfcn < 0) {
+    if (cellsearch_earfcn_index == 0) {
+      wideband_cells.clear();
+    }
+    auto it          = wideband_cells.find((uint32_t)current_earfcn);
+    wideband_capture = it == wideband_cells.end();
+    skip_search      = not wideband_capture and not it->second;
+  }
+
+  if (skip_search) {
+    Info("Cell Search: No cell found in EARFCN=%d by the wideband search", current_earfcn);
+    cell_search_ret = search::CELL_NOT_FOUND;
+  } else {
+    Info("Cell Search: changing frequency to EARFCN=%d", current_earfcn);
+    set_frequency();
+
+    // Move to CELL SEARCH and wait to finish
+    Info("Cell Search: Setting Cell search state");
+    phy_state.run_cell_search();
+  }
 
   // Check return state
   switch (cell_search_ret) {
@@ -422,6 +453,16 @@ bool sync::wait_idle()
 
 void sync::run_cell_search_state()
 {
+  if (wideband_capture) {
+    wideband_capture = false;
+    run_wideband_search();
+    if (not wideband_cells[(uint32_t)current_earfcn]) {
+      cell_search_ret = search::CELL_NOT_FOUND;
+      phy_state.state_exit();
+      return;
+    }
+  }
+
   srsran_cell_t tmp_cell = cell.get();
   cell_search_ret        = search_p.run(&tmp_cell, mib);
   if (cell_search_ret == search::CELL_FOUND) {
@@ -431,6 +472,59 @@ void sync::run_cell_search_state()
   phy_state.state_exit();
 }
 
+void sync::run_wideband_search()
+{
+  double srate_hz  = worker_com->args->cell_search_wideband_srate;
+  double offset_hz = wideband_search::max_offset_hz(srate_hz);
+  double freq_hz   = 1e6 * srsran_band_fd((uint32_t)current_earfcn);
+  auto   sf_len    = (uint32_t)(srate_hz / 1000);
+  if (offset_hz <= 0 or sf_len > sf_buffer.size()) {
+    phy_logger.error("Wideband search: Invalid sampling rate %.2f MHz", srate_hz / 1e6);
+    wideband_cells[(uint32_t)current_earfcn] = true;
+    return;
+  }
+
+  // The current EARFCN is placed at the lower edge of the capture, since the list is usually in increasing order
+  radio_h->set_rx_srate(srate_hz);
+  radio_h->set_rx_freq(0, freq_hz + offset_hz);
+
+  // Drop the samples received while the RF settles, then capture an integer number of frames
+  uint32_t nof_sf = 10 + wideband_capture_ms;
+  wideband_buffer.resize((size_t)sf_len * wideband_capture_ms);
+  sf_buffer.set_nof_samples(sf_len);
+  for (uint32_t i = 0; i < nof_sf; i++) {
+    srsran_timestamp_t rx_time = {};
+    if (radio_recv_fnc(sf_buffer, &rx_time) != SRSRAN_SUCCESS) {
+      phy_logger.error("Wideband search: Error receiving samples");
+      break;
+    }
+    if (i >= 10) {
+      srsran_vec_cf_copy(&wideband_buffer[(size_t)(i - 10) * sf_len], sf_buffer.get(0), sf_len);
+    }
+  }
+
+  std::vector<wideband_search::result_t> results = wb_search.run(wideband_buffer.data(),
+                                                                 (uint32_t)wideband_buffer.size(),
+                                                                 srate_hz,
+                                                                 freq_hz + offset_hz,
+                                                                 worker_com->args->dl_earfcn_list);
+  for (const wideband_search::result_t& r : results) {
+    wideband_cells[r.earfcn] = r.found;
+    if (r.found) {
+      Info("Wideband search: Found PCI=%d in EARFCN=%d, peak=%.1f", r.cell.cell_id, r.earfcn, r.cell.peak);
+    }
+  }
+  // The current EARFCN is never skipped without searching it, even if it could not be searched in the capture
+  if (wideband_cells.count((uint32_t)current_earfcn) == 0) {
+    wideband_cells[(uint32_t)current_earfcn] = true;
+  }
+  Info("Wideband search: Searched %zd EARFCNs in a capture of %.2f MHz", results.size(), srate_hz / 1e6);
+
+  // Back to the cell search sampling rate and frequency
+  radio_h->set_rx_srate(1.92e6);
+  set_frequency();
+}
+
 void sync::run_sfn_sync_state()
 {
   srsran_cell_t old_cell = cell.get();
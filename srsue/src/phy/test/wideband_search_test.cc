@@ -0,0 +1,370 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/band_helper.h"
+#include "srsran/common/string_helpers.h"
+#include "srsran/common/test_common.h"
+#include "srsran/srsran.h"
+#include "srsue/hdr/phy/wideband_search.h"
+#include <boost/program_options.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <chrono>
+#include <iostream>
+#include <map>
+
+// shorten boost program options namespace
+namespace bpo = boost::program_options;
+
+// Band 7 EARFCNs at -3, -0.5, +1, +3.5 and +7 MHz from the center of the capture. No NR cell by default
+struct args_t {
+  double                       srate_hz       = 11.52e6;
+  double                       center_freq_hz = 2658e6;
+  std::string                  earfcn_list    = "3100,3125,3140,3165,3200";
+  std::string                  cell_list      = "3100:1,3140:5,3165:12";
+  std::string                  ssb_arfcn_list = "";
+  std::string                  nr_cell_list   = "";
+  uint32_t                     nof_threads    = 4;
+  uint32_t                     duration_ms    = 40;
+  float                        snr_db         = 10.0f;
+  std::string                  filename;
+  std::vector<uint32_t>        earfcns;
+  std::vector<uint32_t>        ssb_arfcns;
+  std::map<uint32_t, uint32_t> cells;    ///< EARFCN and PCI of the simulated cells
+  std::map<uint32_t, uint32_t> nr_cells; ///< SSB ARFCN and PCI of the simulated NR cells
+};
+
+// Parses a comma separated list of ARFCN:PCI
+static int parse_cell_list(const std::string& list, std::map<uint32_t, uint32_t>& cells)
+{
+  std::vector<std::string> items;
+  srsran::string_parse_list(list, ',', items);
+  for (const std::string& c : items) {
+    size_t pos = c.find(':');
+    if (pos == std::string::npos) {
+      std::cerr << "Invalid cell " << c << std::endl;
+      return SRSRAN_ERROR;
+    }
+    cells[(uint32_t)std::stoul(c.substr(0, pos))] = (uint32_t)std::stoul(c.substr(pos + 1));
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int parse_args(int argc, char** argv, args_t& args)
+{
+  int ret = SRSRAN_SUCCESS;
+
+  bpo::options_description options("General options");
+  bpo::options_description simulation("Mode 1: Simulation options (Default)");
+  bpo::options_description file("Mode 2: File (enabled if filename is provided)");
+
+  // clang-format off
+  simulation.add_options()
+      ("cell_list",    bpo::value<std::string>(&args.cell_list)->default_value(args.cell_list),       "Comma separated EARFCN:PCI list of the simulated cells")
+      ("nr_cell_list", bpo::value<std::string>(&args.nr_cell_list)->default_value(args.nr_cell_list), "Comma separated SSB ARFCN:PCI list of the simulated NR cells")
+      ("snr",          bpo::value<float>(&args.snr_db)->default_value(args.snr_db),                   "SNR of the cells in dB")
+      ;
+
+  file.add_options()
+      ("file.name", bpo::value<std::string>(&args.filename)->default_value(args.filename), "File name providing wideband baseband")
+      ;
+
+  options.add(simulation).add(file).add_options()
+      ("help,h",      "Show this message")
+      ("srate",          bpo::value<double>(&args.srate_hz)->default_value(args.srate_hz),                  "Sampling rate of the capture in Hz")
+      ("center_freq",    bpo::value<double>(&args.center_freq_hz)->default_value(args.center_freq_hz),      "Center frequency of the capture in Hz")
+      ("earfcn_list",    bpo::value<std::string>(&args.earfcn_list)->default_value(args.earfcn_list),       "Comma separated list of EARFCNs to search")
+      ("ssb_arfcn_list", bpo::value<std::string>(&args.ssb_arfcn_list)->default_value(args.ssb_arfcn_list), "Comma separated list of NR SSB ARFCNs to search")
+      ("nof_threads",    bpo::value<uint32_t>(&args.nof_threads)->default_value(args.nof_threads),          "Number of search threads")
+      ("duration",       bpo::value<uint32_t>(&args.duration_ms)->default_value(args.duration_ms),          "Length of the capture in ms")
+      ;
+  // clang-format on
+
+  bpo::variables_map vm;
+  try {
+    bpo::store(bpo::command_line_parser(argc, argv).options(options).run(), vm);
+    bpo::notify(vm);
+  } catch (bpo::error& e) {
+    std::cerr << e.what() << std::endl;
+    ret = SRSRAN_ERROR;
+  }
+
+  // help option was given or error - print usage and exit
+  if (vm.count("help") || ret) {
+    std::cout << "Usage: " << argv[0] << " [OPTIONS]" << std::endl << std::endl;
+    std::cout << options << std::endl << std::endl;
+    return SRSRAN_ERROR;
+  }
+
+  srsran::string_parse_list(args.earfcn_list, ',', args.earfcns);
+  srsran::string_parse_list(args.ssb_arfcn_list, ',', args.ssb_arfcns);
+  if (parse_cell_list(args.cell_list, args.cells) != SRSRAN_SUCCESS or
+      parse_cell_list(args.nr_cell_list, args.nr_cells) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  return ret;
+}
+
+// Adds the SSB of an NR cell every 20 ms, with the SNR of the LTE cells in the bandwidth of its channel
+static int add_ssb(const args_t& args, uint32_t ssb_arfcn, uint32_t pci, float noise_pwr, std::vector<cf_t>& capture)
+{
+  srsran::srsran_band_helper  bands;
+  uint16_t                    band = bands.get_band_from_dl_arfcn(ssb_arfcn);
+  srsran_subcarrier_spacing_t scs  = bands.get_ssb_scs(band);
+  TESTASSERT(band != UINT16_MAX and scs != srsran_subcarrier_spacing_invalid);
+
+  srsran_ssb_args_t ssb_args = {};
+  ssb_args.max_srate_hz      = args.srate_hz;
+  ssb_args.min_scs           = scs;
+  ssb_args.enable_encode     = true;
+
+  srsran_ssb_cfg_t ssb_cfg = {};
+  ssb_cfg.srate_hz         = args.srate_hz;
+  ssb_cfg.center_freq_hz   = args.center_freq_hz;
+  ssb_cfg.ssb_freq_hz      = bands.nr_arfcn_to_freq(ssb_arfcn);
+  ssb_cfg.scs              = scs;
+  ssb_cfg.pattern          = srsran::srsran_band_helper::get_ssb_pattern(band, scs);
+  ssb_cfg.duplex_mode      = bands.get_duplex_mode(band);
+
+  srsran_ssb_t ssb = {};
+  TESTASSERT(srsran_ssb_init(&ssb, &ssb_args) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_ssb_set_cfg(&ssb, &ssb_cfg) == SRSRAN_SUCCESS);
+
+  // The first SSB of the half frame
+  srsran_pbch_msg_nr_t pbch_msg = {};
+  pbch_msg.crc                  = true;
+  auto              hf_len      = (uint32_t)round(args.srate_hz * 5e-3);
+  std::vector<cf_t> hf(hf_len);
+  TESTASSERT(srsran_ssb_add(&ssb, pci, &pbch_msg, hf.data(), hf.data()) == SRSRAN_SUCCESS);
+
+  // Scale the SSB symbols to the power of the noise in the 256 subcarriers of the SSB channel
+  double ssb_pwr   = srsran_vec_avg_power_cf(hf.data(), hf_len) * hf_len / ssb.ssb_sz;
+  double noise_ssb = noise_pwr * 256 * SRSRAN_SUBC_SPACING_NR(scs) / args.srate_hz;
+  srsran_vec_sc_prod_cfc(
+      hf.data(), sqrtf((float)(srsran_convert_dB_to_power(args.snr_db) * noise_ssb / ssb_pwr)), hf.data(), hf_len);
+
+  auto period = (uint32_t)round(args.srate_hz * 20e-3);
+  for (uint32_t t = 0; t + hf_len <= capture.size(); t += period) {
+    srsran_vec_sum_ccc(hf.data(), &capture[t], &capture[t], hf_len);
+  }
+
+  srsran_ssb_free(&ssb);
+  return SRSRAN_SUCCESS;
+}
+
+// Generates the 6 PRB cells of the list at their EARFCN offset within the capture, plus noise
+static int generate_capture(const args_t& args, std::vector<cf_t>& capture)
+{
+  const uint32_t nof_prb  = 6;
+  const uint32_t sf_len   = SRSRAN_SF_LEN_PRB(nof_prb);
+  const double   cell_fs  = srsran_sampling_freq_hz(nof_prb);
+  const uint32_t interp   = (uint32_t)round(args.srate_hz / cell_fs);
+  uint32_t       nof_samp = args.duration_ms * sf_len * interp;
+  if (interp * cell_fs != args.srate_hz) {
+    ERROR("The sampling rate must be a multiple of %.2f MHz", cell_fs / 1e6);
+    return SRSRAN_ERROR;
+  }
+
+  capture.assign(nof_samp, 0.0f);
+  std::vector<cf_t> signal(sf_len);
+  std::vector<cf_t> upsampled(sf_len * interp);
+  std::vector<cf_t> mix(sf_len * interp);
+  cf_t*             buffers[SRSRAN_MAX_PORTS] = {signal.data()};
+
+  for (const std::pair<const uint32_t, uint32_t>& c : args.cells) {
+    srsran_cell_t cell = {};
+    cell.nof_prb       = nof_prb;
+    cell.nof_ports     = 1;
+    cell.id            = c.second;
+    cell.cp            = SRSRAN_CP_NORM;
+
+    srsran_enb_dl_t        enb_dl    = {};
+    srsran_resample_poly_t resampler = {};
+    TESTASSERT(srsran_enb_dl_init(&enb_dl, buffers, nof_prb) == SRSRAN_SUCCESS);
+    TESTASSERT(srsran_enb_dl_set_cell(&enb_dl, cell) == SRSRAN_SUCCESS);
+    TESTASSERT(srsran_resample_poly_init(&resampler, interp, 1, SRSRAN_RESAMPLE_POLY_NOF_TAPS) == SRSRAN_SUCCESS);
+
+    float freq  = (float)((1e6 * srsran_band_fd(c.first) - args.center_freq_hz) / args.srate_hz);
+    cf_t  phase = 1.0f;
+    for (uint32_t tti = 0; tti < args.duration_ms; tti++) {
+      srsran_dl_sf_cfg_t dl_sf = {};
+      dl_sf.tti                = tti;
+      srsran_enb_dl_put_base(&enb_dl, &dl_sf);
+      srsran_enb_dl_gen_signal(&enb_dl);
+      float scale = 1.0f / sqrtf(srsran_vec_avg_power_cf(signal.data(), sf_len));
+      srsran_vec_sc_prod_cfc(signal.data(), scale, signal.data(), sf_len);
+
+      uint32_t n = srsran_resample_poly_run(&resampler, signal.data(), upsampled.data(), sf_len);
+      phase      = srsran_vec_gen_sine(phase, freq, mix.data(), n);
+      srsran_vec_prod_ccc(upsampled.data(), mix.data(), upsampled.data(), n);
+      srsran_vec_sum_ccc(upsampled.data(), &capture[tti * sf_len * interp], &capture[tti * sf_len * interp], n);
+    }
+
+    srsran_resample_poly_free(&resampler);
+    srsran_enb_dl_free(&enb_dl);
+  }
+
+  // The SNR is in the bandwidth of the cells, and the noise spreads over the whole capture
+  float n0_dB = -args.snr_db + srsran_convert_power_to_dB((float)interp);
+  for (const std::pair<const uint32_t, uint32_t>& c : args.nr_cells) {
+    TESTASSERT(add_ssb(args, c.first, c.second, srsran_convert_dB_to_power(n0_dB), capture) == SRSRAN_SUCCESS);
+  }
+
+  srsran_channel_awgn_t awgn = {};
+  TESTASSERT(srsran_channel_awgn_init(&awgn, 1234) == SRSRAN_SUCCESS);
+  srsran_channel_awgn_set_n0(&awgn, n0_dB);
+  srsran_channel_awgn_run_c(&awgn, capture.data(), capture.data(), nof_samp);
+  srsran_channel_awgn_free(&awgn);
+
+  return SRSRAN_SUCCESS;
+}
+
+static int read_capture(const args_t& args, std::vector<cf_t>& capture)
+{
+  srsran_filesource_t filesource = {};
+  if (srsran_filesource_init(&filesource, args.filename.c_str(), SRSRAN_COMPLEX_FLOAT) < SRSRAN_SUCCESS) {
+    ERROR("Error opening file %s", args.filename.c_str());
+    return SRSRAN_ERROR;
+  }
+  capture.resize((size_t)(args.srate_hz * args.duration_ms / 1000));
+  int n = srsran_filesource_read(&filesource, capture.data(), (int)capture.size());
+  srsran_filesource_free(&filesource);
+  if (n < (int)capture.size()) {
+    ERROR("The file %s has less than %d ms", args.filename.c_str(), args.duration_ms);
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
+
+// Searches the capture for LTE and NR cells, and returns the time it took in milliseconds
+static double run_search(const args_t&                                     args,
+                         const std::vector<cf_t>&                          capture,
+                         uint32_t                                          nof_threads,
+                         std::vector<srsue::wideband_search::result_t>&    results,
+                         std::vector<srsue::wideband_search::nr_result_t>& nr_results)
+{
+  srsue::wideband_search search(srslog::fetch_basic_logger("PHY"));
+  TESTASSERT(search.init(
+      (uint32_t)std::max(args.earfcns.size(), args.ssb_arfcns.size()), nof_threads, not args.ssb_arfcns.empty()));
+
+  auto t0 = std::chrono::steady_clock::now();
+  results = search.run(capture.data(), (uint32_t)capture.size(), args.srate_hz, args.center_freq_hz, args.earfcns);
+  if (not args.ssb_arfcns.empty()) {
+    nr_results =
+        search.run_nr(capture.data(), (uint32_t)capture.size(), args.srate_hz, args.center_freq_hz, args.ssb_arfcns);
+  }
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv)
+{
+  srslog::init();
+
+  args_t args = {};
+  if (parse_args(argc, argv, args) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  std::vector<cf_t> capture;
+  if (args.filename.empty()) {
+    TESTASSERT(generate_capture(args, capture) == SRSRAN_SUCCESS);
+  } else {
+    TESTASSERT(read_capture(args, capture) == SRSRAN_SUCCESS);
+  }
+
+  // Scan time with a single thread and with the thread pool
+  std::vector<srsue::wideband_search::result_t>    results_serial;
+  std::vector<srsue::wideband_search::result_t>    results;
+  std::vector<srsue::wideband_search::nr_result_t> nr_results_serial;
+  std::vector<srsue::wideband_search::nr_result_t> nr_results;
+  double serial_ms = run_search(args, capture, 1, results_serial, nr_results_serial);
+  double pool_ms   = run_search(args, capture, args.nof_threads, results, nr_results);
+
+  printf("Searched %zd EARFCNs and %zd SSB ARFCNs in %.2f MHz, %d ms\n",
+         results.size(),
+         nr_results.size(),
+         args.srate_hz / 1e6,
+         args.duration_ms);
+  printf("Scan time: %.1f ms with 1 thread, %.1f ms with %d threads\n", serial_ms, pool_ms, args.nof_threads);
+  for (const srsue::wideband_search::result_t& r : results) {
+    if (r.found) {
+      printf("  EARFCN=%d: PCI=%d, peak=%.1f, PSR=%.1f\n", r.earfcn, r.cell.cell_id, r.cell.peak, r.cell.psr);
+    } else {
+      printf("  EARFCN=%d: no cell\n", r.earfcn);
+    }
+  }
+  for (const srsue::wideband_search::nr_result_t& r : nr_results) {
+    if (r.found) {
+      printf("  SSB ARFCN=%d: PCI=%d, SNR=%.1f dB, CFO=%+.1f Hz\n",
+             r.ssb_arfcn,
+             r.ssb_res.N_id,
+             r.ssb_res.measurements.snr_dB,
+             r.ssb_res.measurements.cfo_hz);
+    } else {
+      printf("  SSB ARFCN=%d: no cell\n", r.ssb_arfcn);
+    }
+  }
+
+  // The simulated cells must be found in their EARFCN, with the same result regardless of the number of threads
+  TESTASSERT(results.size() == results_serial.size());
+  for (uint32_t i = 0; i < results.size(); i++) {
+    TESTASSERT(results[i].earfcn == results_serial[i].earfcn);
+    TESTASSERT(results[i].found == results_serial[i].found);
+    if (args.filename.empty()) {
+      auto it = args.cells.find(results[i].earfcn);
+      TESTASSERT(results[i].found == (it != args.cells.end()));
+      TESTASSERT(not results[i].found or results[i].cell.cell_id == it->second);
+    }
+  }
+
+  TESTASSERT(nr_results.size() == nr_results_serial.size());
+  for (uint32_t i = 0; i < nr_results.size(); i++) {
+    TESTASSERT(nr_results[i].ssb_arfcn == nr_results_serial[i].ssb_arfcn);
+    TESTASSERT(nr_results[i].found == nr_results_serial[i].found);
+    if (args.filename.empty()) {
+      auto it = args.nr_cells.find(nr_results[i].ssb_arfcn);
+      TESTASSERT(nr_results[i].found == (it != args.nr_cells.end()));
+      TESTASSERT(not nr_results[i].found or nr_results[i].ssb_res.N_id == it->second);
+    }
+  }
+
+  // EARFCNs and SSB ARFCNs outside the capture are not searched
+  for (uint32_t earfcn : args.earfcns) {
+    double offset_hz = std::abs(1e6 * srsran_band_fd(earfcn) - args.center_freq_hz);
+    bool   searched  = false;
+    for (const srsue::wideband_search::result_t& r : results) {
+      searched |= r.earfcn == earfcn;
+    }
+    TESTASSERT(searched == (offset_hz <= srsue::wideband_search::max_offset_hz(args.srate_hz)));
+  }
+  srsran::srsran_band_helper bands;
+  for (uint32_t ssb_arfcn : args.ssb_arfcns) {
+    srsran_subcarrier_spacing_t scs       = bands.get_ssb_scs(bands.get_band_from_dl_arfcn(ssb_arfcn));
+    double                      offset_hz = std::abs(bands.nr_arfcn_to_freq(ssb_arfcn) - args.center_freq_hz);
+    bool                        searched  = false;
+    for (const srsue::wideband_search::nr_result_t& r : nr_results) {
+      searched |= r.ssb_arfcn == ssb_arfcn;
+    }
+    TESTASSERT(searched == (offset_hz <= srsue::wideband_search::max_offset_nr_hz(args.srate_hz, scs)));
+  }
+
+  return SRSRAN_SUCCESS;
+}
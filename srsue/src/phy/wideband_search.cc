@@ -0,0 +1,324 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsue/hdr/phy/wideband_search.h"
+#include "srsran/common/band_helper.h"
+
+namespace srsue {
+
+wideband_search::~wideband_search()
+{
+  if (pool != nullptr) {
+    pool->stop();
+  }
+  for (std::unique_ptr<searcher_t>& s : searchers) {
+    srsran_pss_corr_free(&s->pss_corr);
+    srsran_sss_free(&s->sss);
+    srsran_resample_poly_free(&s->resampler);
+  }
+}
+
+bool wideband_search::init(uint32_t max_channels, uint32_t nof_threads, bool nr_enable)
+{
+  // The DFT plans of the searchers are created here, as creating plans is not thread-safe
+  for (uint32_t i = 0; i < max_channels; i++) {
+    std::unique_ptr<searcher_t> s(new searcher_t);
+    auto                        pss_period = (uint32_t)(SRSRAN_CS_SAMP_FREQ / 200);
+    if (srsran_pss_corr_init_lte(&s->pss_corr, srsran_symbol_sz(SRSRAN_CS_NOF_PRB), pss_period) ||
+        srsran_pss_corr_set_period(&s->pss_corr, pss_period)) {
+      logger.error("Wideband search: Error initiating PSS correlator");
+      return false;
+    }
+    if (srsran_sss_init(&s->sss, srsran_symbol_sz(SRSRAN_CS_NOF_PRB))) {
+      logger.error("Wideband search: Error initiating SSS");
+      return false;
+    }
+
+    // The SSB is always searched with the same symbol size, so its plans are not created again for another SCS
+    if (nr_enable) {
+      nr::cell_search::args_t nr_args = {};
+      nr_args.max_srate_hz            = nr_srate_hz(srsran_subcarrier_spacing_30kHz);
+      nr_args.ssb_min_scs             = srsran_subcarrier_spacing_15kHz;
+
+      nr::cell_search::cfg_t nr_cfg = {};
+      nr_cfg.srate_hz               = nr_srate_hz(srsran_subcarrier_spacing_15kHz);
+      nr_cfg.ssb_scs                = srsran_subcarrier_spacing_15kHz;
+      nr_cfg.ssb_pattern            = SRSRAN_SSB_PATTERN_A;
+      nr_cfg.duplex_mode            = SRSRAN_DUPLEX_MODE_FDD;
+
+      s->nr_searcher.reset(new nr::cell_search(logger));
+      if (not s->nr_searcher->init(nr_args) or not s->nr_searcher->start(nr_cfg)) {
+        logger.error("Wideband search: Error initiating NR cell search");
+        return false;
+      }
+    }
+
+    s->mix.resize(SRSRAN_RESAMPLE_POLY_BLOCK);
+    searchers.push_back(std::move(s));
+  }
+
+  pool.reset(new srsran::task_thread_pool(std::max(nof_threads, 1U)));
+  return true;
+}
+
+double wideband_search::max_offset_hz(double srate_hz)
+{
+  // Leave room for half of the 6 central PRB and for the roll-off of the anti-aliasing filter of the RF front-end
+  return 0.4 * srate_hz - SRSRAN_CS_NOF_PRB * SRSRAN_NRE * 15e3 / 2;
+}
+
+double wideband_search::max_offset_nr_hz(double srate_hz, srsran_subcarrier_spacing_t scs)
+{
+  // Same as LTE, with the 20 PRB of the SSB
+  return 0.4 * srate_hz - SRSRAN_SSB_BW_SUBC * SRSRAN_SUBC_SPACING_NR(scs) / 2;
+}
+
+double wideband_search::nr_srate_hz(srsran_subcarrier_spacing_t scs)
+{
+  return nr_symbol_sz * SRSRAN_SUBC_SPACING_NR(scs);
+}
+
+void wideband_search::channelize(searcher_t& s, double freq_hz)
+{
+  const cf_t* samples     = capture.samples;
+  uint32_t    nof_samples = capture.nof_samples;
+
+  // Shift the channel to baseband and decimate it, block by block to keep the samples in cache
+  double   freq      = (capture.center_freq_hz - freq_hz) / capture.srate_hz;
+  double   phase     = 0.0;
+  uint32_t nof_total = 0;
+  s.samples.resize((size_t)ceil(nof_samples * s.resampler.rate) + 2);
+  for (uint32_t i = 0; i < nof_samples; i += SRSRAN_RESAMPLE_POLY_BLOCK) {
+    uint32_t n = std::min(nof_samples - i, (uint32_t)SRSRAN_RESAMPLE_POLY_BLOCK);
+    cf_t     a;
+    __real__ a = (float)cos(phase);
+    __imag__ a = (float)sin(phase);
+    srsran_vec_gen_sine(a, (float)freq, s.mix.data(), n);
+    phase = fmod(phase + 2.0 * M_PI * freq * n, 2.0 * M_PI);
+    srsran_vec_prod_ccc(&samples[i], s.mix.data(), s.mix.data(), n);
+    nof_total += srsran_resample_poly_run(&s.resampler, s.mix.data(), &s.samples[nof_total], n);
+  }
+  s.samples.resize(nof_total);
+}
+
+void wideband_search::search(searcher_t& s)
+{
+  channelize(s, s.result.freq_hz);
+  auto nof_total = (uint32_t)s.samples.size();
+
+  s.result.found = false;
+  s.result.cell  = {};
+
+  // A single pass of the correlator gives the position of each PSS within the 5 ms
+  srsran_pss_corr_peak_t pss_peaks[SRSRAN_PSS_CORR_MAX_SEQ] = {};
+  if (srsran_pss_corr_run(&s.pss_corr, s.samples.data(), nof_total, pss_peaks) != SRSRAN_NOF_NID_2) {
+    logger.error("Wideband search: Error correlating PSS in EARFCN=%d", s.result.earfcn);
+    return;
+  }
+
+  // Detect the SSS at the peak of the PSS that stand out of the noise, with both CP, and keep the strongest cell
+  uint32_t period = s.pss_corr.period;
+  uint32_t nof_5m = nof_total / period;
+  for (uint32_t N_id_2 = 0; N_id_2 < SRSRAN_NOF_NID_2; N_id_2++) {
+    if (pss_peaks[N_id_2].par < pss_par_threshold) {
+      continue;
+    }
+    srsran_sss_set_N_id_2(&s.sss, N_id_2);
+    for (srsran_cp_t cp : {SRSRAN_CP_NORM, SRSRAN_CP_EXT}) {
+      uint32_t nof_detected = 0;
+      int      N_id_1       = srsran_sss_find_periodic(
+          &s.sss, s.samples.data(), nof_total, pss_peaks[N_id_2].idx, period, cp, nullptr, nullptr, &nof_detected);
+
+      // Noise, or the SSS of the wrong CP, gives a different N_id_1 in every 5 ms
+      float mode = nof_5m > 0 ? (float)nof_detected / nof_5m : 0.0f;
+      if (N_id_1 < 0 or mode <= 0.5f) {
+        continue;
+      }
+      bool same_pss = s.result.found and s.result.cell.cell_id % SRSRAN_NOF_NID_2 == N_id_2;
+      if (not s.result.found or (same_pss ? mode > s.result.cell.mode : pss_peaks[N_id_2].value > s.result.cell.peak)) {
+        s.result.found           = true;
+        s.result.cell.cell_id    = SRSRAN_NOF_NID_2 * (uint32_t)N_id_1 + N_id_2;
+        s.result.cell.cp         = cp;
+        s.result.cell.frame_type = SRSRAN_FDD;
+        s.result.cell.peak       = pss_peaks[N_id_2].value;
+        s.result.cell.mode       = mode;
+        s.result.cell.psr        = pss_peaks[N_id_2].par;
+      }
+    }
+  }
+}
+
+void wideband_search::search_nr(searcher_t& s)
+{
+  channelize(s, s.nr_result.freq_hz);
+
+  // The SSB is found if its PBCH is decoded
+  nr::cell_search::ret_t ret = s.nr_searcher->run(s.samples.data(), (uint32_t)s.samples.size());
+  if (ret.result == nr::cell_search::ret_t::ERROR) {
+    logger.error("Wideband search: Error searching SSB in ARFCN=%d", s.nr_result.ssb_arfcn);
+  }
+  s.nr_result.found   = ret.result == nr::cell_search::ret_t::CELL_FOUND;
+  s.nr_result.ssb_res = ret.ssb_res;
+}
+
+void wideband_search::run_batches(uint32_t                                         nof_channels,
+                                  const std::function<bool(searcher_t&, uint32_t)>& prepare,
+                                  const std::function<void(searcher_t&)>&           search_channel,
+                                  const std::function<void(searcher_t&)>&           collect)
+{
+  // Search as many channels at a time as searchers
+  for (uint32_t i = 0; i < nof_channels; i += searchers.size()) {
+    uint32_t nof_batch = std::min(nof_channels - i, (uint32_t)searchers.size());
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      nof_pending = nof_batch;
+    }
+    for (uint32_t j = 0; j < nof_batch; j++) {
+      searcher_t* s     = searchers[j].get();
+      bool        valid = prepare(*s, i + j);
+      pool->push_task([this, s, valid, &search_channel]() {
+        if (valid) {
+          search_channel(*s);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--nof_pending == 0) {
+          cvar.notify_one();
+        }
+      });
+    }
+
+    // Wait for the whole batch, since the next one reuses the searchers
+    std::unique_lock<std::mutex> lock(mutex);
+    while (nof_pending > 0) {
+      cvar.wait(lock);
+    }
+    for (uint32_t j = 0; j < nof_batch; j++) {
+      collect(*searchers[j]);
+    }
+  }
+}
+
+std::vector<wideband_search::result_t> wideband_search::run(const cf_t*                  samples,
+                                                            uint32_t                     nof_samples,
+                                                            double                       srate_hz,
+                                                            double                       center_freq_hz,
+                                                            const std::vector<uint32_t>& earfcns)
+{
+  std::vector<result_t> results;
+
+  // Select the EARFCNs within the capture
+  std::vector<result_t> channels;
+  for (uint32_t earfcn : earfcns) {
+    double freq_hz = 1e6 * srsran_band_fd(earfcn);
+    if (freq_hz > 0 && std::abs(freq_hz - center_freq_hz) <= max_offset_hz(srate_hz)) {
+      result_t r = {};
+      r.earfcn   = earfcn;
+      r.freq_hz  = freq_hz;
+      channels.push_back(r);
+    }
+  }
+
+  capture.samples        = samples;
+  capture.nof_samples    = nof_samples;
+  capture.srate_hz       = srate_hz;
+  capture.center_freq_hz = center_freq_hz;
+
+  run_batches(
+      (uint32_t)channels.size(),
+      [this, &channels, srate_hz](searcher_t& s, uint32_t idx) {
+        s.result    = channels[idx];
+        double rate = SRSRAN_CS_SAMP_FREQ / srate_hz;
+        if (srsran_resample_poly_init_arb(&s.resampler, rate, SRSRAN_RESAMPLE_POLY_NOF_TAPS)) {
+          logger.error("Wideband search: Error initialising resampler for %.2f MHz", srate_hz / 1e6);
+          return false;
+        }
+        return true;
+      },
+      [this](searcher_t& s) { search(s); },
+      [&results](searcher_t& s) { results.push_back(s.result); });
+
+  return results;
+}
+
+std::vector<wideband_search::nr_result_t> wideband_search::run_nr(const cf_t*                  samples,
+                                                                  uint32_t                     nof_samples,
+                                                                  double                       srate_hz,
+                                                                  double                       center_freq_hz,
+                                                                  const std::vector<uint32_t>& ssb_arfcns)
+{
+  std::vector<nr_result_t> results;
+  if (searchers.empty() or searchers[0]->nr_searcher == nullptr) {
+    logger.error("Wideband search: NR is not enabled");
+    return results;
+  }
+
+  // Select the SSB ARFCNs within the capture, with the SSB configuration of their band
+  srsran::srsran_band_helper          bands;
+  std::vector<nr_result_t>            channels;
+  std::vector<nr::cell_search::cfg_t> cfgs;
+  for (uint32_t ssb_arfcn : ssb_arfcns) {
+    uint16_t                    band    = bands.get_band_from_dl_arfcn(ssb_arfcn);
+    srsran_subcarrier_spacing_t scs     = bands.get_ssb_scs(band);
+    double                      freq_hz = bands.nr_arfcn_to_freq(ssb_arfcn);
+    if (band == UINT16_MAX or scs == srsran_subcarrier_spacing_invalid or nr_srate_hz(scs) > srate_hz or
+        std::abs(freq_hz - center_freq_hz) > max_offset_nr_hz(srate_hz, scs)) {
+      continue;
+    }
+    nr_result_t r = {};
+    r.ssb_arfcn   = ssb_arfcn;
+    r.freq_hz     = freq_hz;
+    r.scs         = scs;
+    channels.push_back(r);
+
+    // The SSB is shifted to the center of the channel
+    nr::cell_search::cfg_t cfg = {};
+    cfg.srate_hz               = nr_srate_hz(scs);
+    cfg.center_freq_hz         = freq_hz;
+    cfg.ssb_freq_hz            = freq_hz;
+    cfg.ssb_scs                = scs;
+    cfg.ssb_pattern            = srsran::srsran_band_helper::get_ssb_pattern(band, scs);
+    cfg.duplex_mode            = bands.get_duplex_mode(band);
+    cfgs.push_back(cfg);
+  }
+
+  capture.samples        = samples;
+  capture.nof_samples    = nof_samples;
+  capture.srate_hz       = srate_hz;
+  capture.center_freq_hz = center_freq_hz;
+
+  run_batches(
+      (uint32_t)channels.size(),
+      [this, &channels, &cfgs, srate_hz](searcher_t& s, uint32_t idx) {
+        s.nr_result = channels[idx];
+        double rate = cfgs[idx].srate_hz / srate_hz;
+        if (srsran_resample_poly_init_arb(&s.resampler, rate, SRSRAN_RESAMPLE_POLY_NOF_TAPS)) {
+          logger.error("Wideband search: Error initialising resampler for %.2f MHz", srate_hz / 1e6);
+          return false;
+        }
+        return s.nr_searcher->start(cfgs[idx]);
+      },
+      [this](searcher_t& s) { search_nr(s); },
+      [&results](searcher_t& s) { results.push_back(s.nr_result); });
+
+  return results;
+}
+
+} // namespace srsue
@@ -25,8 +25,8 @@ enb_pid=0
 ue_pid=0
 
 print_use(){
-  echo "Please call script with srsRAN build path as first argument and number of PRBs as second (number of component carrier is optional)"
-  echo "E.g. ./run_lte.sh [build_path] [nof_prb] [num_cc]"
+  echo "Please call script with srsRAN build path as first argument and number of PRBs as second (number of component carrier and clock are optional)"
+  echo "E.g. ./run_lte.sh [build_path] [nof_prb] [num_cc] [wall|virtual]"
   exit -1
 }
 
@@ -253,6 +253,17 @@ then
 fi
 echo "Using $num_cc component carrier(s) in srsENB"
 
+# check clock
+clock="wall"
+if ([ $4 ])
+then
+  clock="$4"
+fi
+if [ "$clock" != "wall" ] && [ "$clock" != "virtual" ]; then
+  print_use
+fi
+echo "Using the $clock clock"
+
 base_srate="23.04e6"
 if ([ "$nof_prb" == "75" ])
 then
@@ -327,6 +338,14 @@ else
   ue_args="$ue_args --rf.device_args=\"tx_port0=tcp://*:2001,rx_port0=tcp://localhost:2000,id=ue,base_srate=${base_srate}\""
 fi
 
+# With the virtual clock the scenario runs faster than real time, so the pauses between the experiments last longer in
+# radio time than the RRC inactivity timer
+if ([ "$clock" == "virtual" ])
+then
+  enb_args="$enb_args --rf.virtual_clock=true --expert.rrc_inactivity_timer=3600000"
+  ue_args="$ue_args --rf.virtual_clock=true"
+fi
+
 # Remove existing log files
 log_files=$(ls -l | grep ${nof_prb}prb_)
 if [ ! -z "$log_files" ]; then
@@ -362,6 +381,7 @@ echo "srsENB's PID is $enb_pid"
 
 # Run srsUE
 echo "Starting srsUE"
+ue_start_time=$(date +%s.%N)
 screen -S srsue -dm -L -Logfile ${nof_prb}prb_screenlog_srsue.log $build_path/srsue/src/srsue $ue_args
 sleep 2
 ue_pid=$(pgrep srsue)
@@ -390,7 +410,7 @@ do
 done
 
 if [ ! -z $ip ]; then
-  echo "$tun_dev is up with IP $ip!"
+  echo "$tun_dev is up with IP $ip after $(awk "BEGIN {print $(date +%s.%N) - $ue_start_time}")s!"
   sleep 1
 else
   echo "$tun_dev didn't get up after ${timeout}s"
@@ -434,6 +454,18 @@ check_ue
 check_enb
 check_epc
 
+# report the speedup of the virtual clock
+if ([ "$clock" == "virtual" ])
+then
+  speedup=$(grep "Virtual clock:" ./${nof_prb}prb_screenlog_srsue.log)
+  if [ -z "$speedup" ]; then
+    echo "Error. srsUE didn't report the virtual clock speedup."
+    exit 1
+  fi
+  echo "srsUE: $speedup"
+  echo "srsENB: $(grep "Virtual clock:" ./${nof_prb}prb_screenlog_srsenb.log)"
+fi
+
 echo "All tests passed!"
 
 exit 0